@@ -55,7 +55,8 @@ void host_random_init_integer_indices(void* indices,
 void MultiProcessMeasurePerformance(std::function<void()> run_fn,
                                     wholememory_comm_t& wm_comm,
                                     const PerformanceMeter& meter,
-                                    const std::function<void()>& barrier_fn)
+                                    const std::function<void()>& barrier_fn,
+                                    const std::function<void()>& prepare_fn)
 {
   barrier_fn();
   // warm up
@@ -67,29 +68,42 @@ void MultiProcessMeasurePerformance(std::function<void()> run_fn,
     gettimeofday(&tv_warmup_c, nullptr);
     int64_t time_warmup = TIME_DIFF_US(tv_warmup_s, tv_warmup_c);
     if (time_warmup >= target_warmup_time) break;
+    if (prepare_fn) {
+      prepare_fn();
+      barrier_fn();
+    }
     run_fn();
     WHOLEMEMORY_CHECK_NOTHROW(cudaDeviceSynchronize() == cudaSuccess);
   }
   WHOLEMEMORY_CHECK_NOTHROW(cudaDeviceSynchronize() == cudaSuccess);
   barrier_fn();
 
-  // run
+  // run, time of prepare_fn is not counted.
   struct timeval tv_run_s, tv_run_e;
-  int64_t max_run_us = 1000LL * 1000LL * meter.max_run_seconds;
+  int64_t max_run_us        = 1000LL * 1000LL * meter.max_run_seconds;
+  int64_t real_time_used_us = 0;
   gettimeofday(&tv_run_s, nullptr);
   int real_run_count = 0;
   for (int i = 0; i < meter.run_count; i++) {
+    if (prepare_fn) {
+      WHOLEMEMORY_CHECK_NOTHROW(cudaDeviceSynchronize() == cudaSuccess);
+      gettimeofday(&tv_run_e, nullptr);
+      real_time_used_us += TIME_DIFF_US(tv_run_s, tv_run_e);
+      prepare_fn();
+      barrier_fn();
+      gettimeofday(&tv_run_s, nullptr);
+    }
     run_fn();
     real_run_count++;
     struct timeval tv_run_c;
     gettimeofday(&tv_run_c, nullptr);
-    int64_t time_run_used = TIME_DIFF_US(tv_run_s, tv_run_c);
+    int64_t time_run_used = real_time_used_us + TIME_DIFF_US(tv_run_s, tv_run_c);
     if (time_run_used >= max_run_us || real_run_count >= meter.run_count) break;
     if (meter.sync) { WHOLEMEMORY_CHECK_NOTHROW(cudaDeviceSynchronize() == cudaSuccess); }
   }
   WHOLEMEMORY_CHECK_NOTHROW(cudaDeviceSynchronize() == cudaSuccess);
   gettimeofday(&tv_run_e, nullptr);
-  int64_t real_time_used_us = TIME_DIFF_US(tv_run_s, tv_run_e);
+  real_time_used_us += TIME_DIFF_US(tv_run_s, tv_run_e);
   double single_run_time_us = real_time_used_us;
   single_run_time_us /= real_run_count;
   barrier_fn();
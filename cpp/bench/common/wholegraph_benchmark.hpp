@@ -100,9 +100,14 @@ struct PerformanceMeter {
   std::string name;
 };
 
+/**
+ * Measure run_fn on all ranks. If prepare_fn is given, it is called before each run of run_fn and
+ * followed by barrier_fn, both are excluded from measured time.
+ */
 void MultiProcessMeasurePerformance(std::function<void()> run_fn,
                                     wholememory_comm_t& wm_comm,
                                     const PerformanceMeter& meter,
-                                    const std::function<void()>& barrier_fn);
+                                    const std::function<void()>& barrier_fn,
+                                    const std::function<void()>& prepare_fn = nullptr);
 
 }  // namespace wholegraph::bench
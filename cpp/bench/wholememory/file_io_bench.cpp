@@ -0,0 +1,573 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <wholememory/wholememory.h>
+
+#include "../common/wholegraph_benchmark.hpp"
+#include "parallel_utils.hpp"
+#include "wholememory/communicator.hpp"
+#include "wholememory/initialize.hpp"
+
+#include "../../tests/wholememory/wholememory_test_utils.hpp"
+namespace wholegraph::bench::file_io {
+
+/**
+ * Every list parameter is swept, the benchmark runs all combinations of them. File counts and thread
+ * counts only apply to load, so store runs once for each combination of the other parameters.
+ */
+typedef struct FileIOBenchParam {
+  const std::vector<wholememory_memory_type_t>& get_memory_types() const { return memory_types; }
+  const std::vector<wholememory_memory_location_t>& get_memory_locations() const
+  {
+    return memory_locations;
+  }
+  const std::vector<int64_t>& get_entry_sizes() const { return entry_sizes; }
+  const std::vector<int64_t>& get_stride_paddings() const { return stride_paddings; }
+  const std::vector<int>& get_file_counts() const { return file_counts; }
+  const std::vector<int>& get_thread_counts() const { return thread_counts; }
+  int64_t get_table_size() const { return table_size; }
+  int get_loop_count() const { return loop_count; }
+  std::string get_test_type() const { return test_type; }
+  std::string get_file_dir() const { return file_dir; }
+  bool get_drop_cache() const { return drop_cache; }
+
+  std::string get_server_addr() const { return server_addr; }
+  int get_server_port() const { return server_port; }
+  int get_node_rank() const { return node_rank; }
+  int get_node_size() const { return node_size; }
+  int get_num_gpu() const { return num_gpu; }
+
+  FileIOBenchParam& set_memory_types(const std::vector<wholememory_memory_type_t>& new_types)
+  {
+    memory_types = new_types;
+    return *this;
+  }
+  FileIOBenchParam& set_memory_locations(
+    const std::vector<wholememory_memory_location_t>& new_locations)
+  {
+    memory_locations = new_locations;
+    return *this;
+  }
+  FileIOBenchParam& set_entry_sizes(const std::vector<int64_t>& new_entry_sizes)
+  {
+    entry_sizes = new_entry_sizes;
+    return *this;
+  }
+  FileIOBenchParam& set_stride_paddings(const std::vector<int64_t>& new_stride_paddings)
+  {
+    stride_paddings = new_stride_paddings;
+    return *this;
+  }
+  FileIOBenchParam& set_file_counts(const std::vector<int>& new_file_counts)
+  {
+    file_counts = new_file_counts;
+    return *this;
+  }
+  FileIOBenchParam& set_thread_counts(const std::vector<int>& new_thread_counts)
+  {
+    thread_counts = new_thread_counts;
+    return *this;
+  }
+  FileIOBenchParam& set_table_size(int64_t new_table_size)
+  {
+    table_size = new_table_size;
+    return *this;
+  }
+  FileIOBenchParam& set_loop_count(int new_loop_count)
+  {
+    loop_count = new_loop_count;
+    return *this;
+  }
+  FileIOBenchParam& set_test_type(std::string new_test_type)
+  {
+    test_type = new_test_type;
+    return *this;
+  }
+  FileIOBenchParam& set_file_dir(std::string new_file_dir)
+  {
+    file_dir = new_file_dir;
+    return *this;
+  }
+  FileIOBenchParam& set_drop_cache(bool new_drop_cache)
+  {
+    drop_cache = new_drop_cache;
+    return *this;
+  }
+  FileIOBenchParam& set_server_addr(std::string new_server_addr)
+  {
+    server_addr = new_server_addr;
+    return *this;
+  }
+  FileIOBenchParam& set_server_port(int new_server_port)
+  {
+    server_port = new_server_port;
+    return *this;
+  }
+  FileIOBenchParam& set_node_rank(int new_node_rank)
+  {
+    node_rank = new_node_rank;
+    return *this;
+  }
+  FileIOBenchParam& set_node_size(int new_node_size)
+  {
+    node_size = new_node_size;
+    return *this;
+  }
+  FileIOBenchParam& set_num_gpu(int new_num_gpu)
+  {
+    num_gpu = new_num_gpu;
+    return *this;
+  }
+
+ private:
+  std::vector<wholememory_memory_type_t> memory_types         = {WHOLEMEMORY_MT_CHUNKED};
+  std::vector<wholememory_memory_location_t> memory_locations = {WHOLEMEMORY_ML_DEVICE,
+                                                                 WHOLEMEMORY_ML_HOST};
+  std::vector<int64_t> entry_sizes     = {128, 512};
+  std::vector<int64_t> stride_paddings = {0, 64};
+  std::vector<int> file_counts         = {1, 8};
+  std::vector<int> thread_counts       = {1, 8};
+  int64_t table_size                   = 4LL * 1024LL * 1024LL * 1024LL;
+  int loop_count                       = 3;
+  std::string test_type                = "load";  // load, store or all
+  std::string file_dir                 = ".";
+  bool drop_cache                      = false;
+
+  std::string server_addr = "localhost";
+  int server_port         = 24987;
+  int node_rank           = 0;
+  int node_size           = 1;
+  int num_gpu             = 0;
+} FileIOBenchParam;
+
+std::string get_memory_type_string(wholememory_memory_type_t memory_type)
+{
+  std::string str;
+  switch (memory_type) {
+    case WHOLEMEMORY_MT_NONE: str = "WHOLEMEMORY_MT_NONE"; break;
+    case WHOLEMEMORY_MT_CONTINUOUS: str = "WHOLEMEMORY_MT_CONTINUOUS"; break;
+    case WHOLEMEMORY_MT_CHUNKED: str = "WHOLEMEMORY_MT_CHUNKED"; break;
+    case WHOLEMEMORY_MT_DISTRIBUTED: str = "WHOLEMEMORY_MT_DISTRIBUTED"; break;
+    default: break;
+  }
+  return str;
+}
+
+std::string get_memory_location_string(wholememory_memory_location_t memory_location)
+{
+  std::string str;
+  switch (memory_location) {
+    case WHOLEMEMORY_ML_NONE: str = "WHOLEMEMORY_ML_NONE"; break;
+    case WHOLEMEMORY_ML_DEVICE: str = "WHOLEMEMORY_ML_DEVICE"; break;
+    case WHOLEMEMORY_ML_HOST: str = "WHOLEMEMORY_ML_HOST"; break;
+    case WHOLEMEMORY_ML_FILE: str = "WHOLEMEMORY_ML_FILE"; break;
+    default: break;
+  }
+  return str;
+}
+
+std::string get_file_name(const std::string& file_dir,
+                          const char* kind,
+                          int part_id,
+                          int part_count)
+{
+  return file_dir + "/wholememory_file_io_bench_" + kind + "_part_" + std::to_string(part_id) +
+         "_of_" + std::to_string(part_count);
+}
+
+/**
+ * Each rank writes its share of input files, file i is written by rank i % world_size.
+ */
+void generate_input_files(const std::vector<std::string>& file_names,
+                          int64_t total_entry_count,
+                          int64_t entry_size,
+                          int world_rank,
+                          int world_size)
+{
+  int file_count              = file_names.size();
+  int64_t entry_per_file      = total_entry_count / file_count;
+  constexpr size_t kChunkSize = 16 * 1024 * 1024;
+  std::vector<char> chunk(kChunkSize);
+  for (size_t i = 0; i < chunk.size(); i++) {
+    chunk[i] = static_cast<char>(i * 131 + 7);
+  }
+  for (int i = world_rank; i < file_count; i += world_size) {
+    int64_t file_entry_count =
+      i == file_count - 1 ? total_entry_count - entry_per_file * (file_count - 1) : entry_per_file;
+    size_t file_size = file_entry_count * entry_size;
+    FILE* fp         = fopen(file_names[i].c_str(), "wb");
+    WHOLEMEMORY_CHECK_NOTHROW(fp != nullptr);
+    for (size_t written = 0; written < file_size; written += kChunkSize) {
+      size_t write_size = std::min(kChunkSize, file_size - written);
+      WHOLEMEMORY_CHECK_NOTHROW(fwrite(chunk.data(), 1, write_size, fp) == write_size);
+    }
+    fclose(fp);
+  }
+}
+
+/**
+ * Evict files from page cache so that load reads from storage, works without root permission.
+ */
+void drop_file_cache(const std::vector<std::string>& file_names)
+{
+  for (auto& file_name : file_names) {
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) continue;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+}
+
+void file_io_benchmark_one_config(wholememory_comm_t wm_comm,
+                                  const FileIOBenchParam& params,
+                                  wholememory_memory_type_t memory_type,
+                                  wholememory_memory_location_t memory_location,
+                                  int64_t entry_size,
+                                  int64_t stride,
+                                  int file_count,
+                                  int thread_count,
+                                  bool run_store)
+{
+  int world_rank = wm_comm->world_rank;
+  int world_size = wm_comm->world_size;
+
+  int64_t total_entry_count = params.get_table_size() / entry_size;
+  std::string test_type     = params.get_test_type();
+  bool run_load = (test_type == "load" || test_type == "all") && total_entry_count >= file_count;
+  run_store     = run_store && (test_type == "store" || test_type == "all");
+  if (!run_load && !run_store) return;
+  wholememory_handle_t wm_handle;
+  WHOLEMEMORY_CHECK_NOTHROW(wholememory_malloc(&wm_handle,
+                                               total_entry_count * stride,
+                                               wm_comm,
+                                               memory_type,
+                                               memory_location,
+                                               stride) == WHOLEMEMORY_SUCCESS);
+  void* local_ptr;
+  size_t local_size, local_offset;
+  WHOLEMEMORY_CHECK_NOTHROW(
+    wholememory_get_local_memory(&local_ptr, &local_size, &local_offset, wm_handle) ==
+    WHOLEMEMORY_SUCCESS);
+  double local_bytes = static_cast<double>(local_size / stride * entry_size);
+  double total_bytes = static_cast<double>(total_entry_count * entry_size);
+
+  std::string thread_count_str = std::to_string(thread_count);
+  setenv("WHOLEMEMORY_LOAD_THREAD_COUNT", thread_count_str.c_str(), 1);
+
+  const auto barrier_fn = [&wm_comm]() -> void {
+    WHOLEMEMORY_CHECK_NOTHROW(wholememory_communicator_barrier(wm_comm) == WHOLEMEMORY_SUCCESS);
+  };
+
+  if (world_rank == 0) {
+    printf(
+      "world_size=%d, memoryType=%s, memoryLocation=%s, entrySize=%ld, stride=%ld, fileCount=%d, "
+      "threadCount=%d, tableSize=%.2lf MB\n",
+      world_size,
+      get_memory_type_string(memory_type).c_str(),
+      get_memory_location_string(memory_location).c_str(),
+      entry_size,
+      stride,
+      file_count,
+      thread_count,
+      total_bytes / 1024.0 / 1024.0);
+  }
+
+  PerformanceMeter meter;
+  meter.AddMetrics("RankBandwidth", "GB/s", local_bytes / 1000.0 / 1000.0 / 1000.0, false)
+    .AddMetrics("AggregateBandwidth", "GB/s", total_bytes / 1000.0 / 1000.0 / 1000.0, false)
+    .SetWarmupTime(0.0f)
+    .SetMaxRunSeconds(1000)
+    .SetRunCount(params.get_loop_count());
+
+  if (run_load) {
+    std::vector<std::string> file_names;
+    std::vector<const char*> file_name_ptrs;
+    for (int i = 0; i < file_count; i++) {
+      file_names.push_back(get_file_name(params.get_file_dir(), "load", i, file_count));
+    }
+    for (auto& file_name : file_names) {
+      file_name_ptrs.push_back(file_name.c_str());
+    }
+    generate_input_files(file_names, total_entry_count, entry_size, world_rank, world_size);
+    barrier_fn();
+    if (world_rank == 0) printf("== Load:\n");
+    std::function<void()> drop_cache_fn = nullptr;
+    if (params.get_drop_cache()) {
+      drop_cache_fn = [&file_names]() { drop_file_cache(file_names); };
+    }
+    MultiProcessMeasurePerformance(
+      [&] {
+        WHOLEMEMORY_CHECK_NOTHROW(wholememory_load_from_file(wm_handle,
+                                                             0,
+                                                             stride,
+                                                             entry_size,
+                                                             file_name_ptrs.data(),
+                                                             file_count) == WHOLEMEMORY_SUCCESS);
+      },
+      wm_comm,
+      meter,
+      barrier_fn,
+      drop_cache_fn);
+    for (int i = world_rank; i < file_count; i += world_size) {
+      unlink(file_names[i].c_str());
+    }
+  }
+  if (run_store) {
+    std::string file_name = get_file_name(params.get_file_dir(), "store", world_rank, world_size);
+    if (world_rank == 0) printf("== Store:\n");
+    MultiProcessMeasurePerformance(
+      [&] {
+        WHOLEMEMORY_CHECK_NOTHROW(
+          wholememory_store_to_file(wm_handle, 0, stride, entry_size, file_name.c_str()) ==
+          WHOLEMEMORY_SUCCESS);
+      },
+      wm_comm,
+      meter,
+      barrier_fn);
+    unlink(file_name.c_str());
+  }
+  barrier_fn();
+  WHOLEMEMORY_CHECK_NOTHROW(wholememory_free(wm_handle) == WHOLEMEMORY_SUCCESS);
+}
+
+void file_io_benchmark(FileIOBenchParam& params)
+{
+  int g_dev_count = ForkGetDeviceCount();
+  WHOLEMEMORY_CHECK_NOTHROW(g_dev_count >= 1);
+  if (params.get_num_gpu() == 0) { params.set_num_gpu(g_dev_count); }
+  MultiProcessRun(
+    g_dev_count,
+    [&params](int local_rank, int local_size) {
+      WHOLEMEMORY_CHECK_NOTHROW(wholememory_init(0) == WHOLEMEMORY_SUCCESS);
+      WM_CUDA_CHECK_NO_THROW(cudaSetDevice(local_rank));
+      int world_size = local_size * params.get_node_size();
+      int world_rank = params.get_node_rank() * params.get_num_gpu() + local_rank;
+
+      SideBandCommunicator* side_band_communicator = StartSidebandCommunicator(
+        world_rank, world_size, params.get_server_addr().c_str(), params.get_server_port());
+
+      wholememory_comm_t wm_comm =
+        create_communicator_by_socket(side_band_communicator, world_rank, world_size);
+
+      ShutDownSidebandCommunicator(side_band_communicator);
+
+      for (auto memory_type : params.get_memory_types()) {
+        for (auto memory_location : params.get_memory_locations()) {
+          for (auto entry_size : params.get_entry_sizes()) {
+            for (auto stride_padding : params.get_stride_paddings()) {
+              for (size_t i = 0; i < params.get_file_counts().size(); i++) {
+                for (size_t j = 0; j < params.get_thread_counts().size(); j++) {
+                  file_io_benchmark_one_config(wm_comm,
+                                               params,
+                                               memory_type,
+                                               memory_location,
+                                               entry_size,
+                                               entry_size + stride_padding,
+                                               params.get_file_counts()[i],
+                                               params.get_thread_counts()[j],
+                                               i == 0 && j == 0);
+                }
+              }
+            }
+          }
+        }
+      }
+
+      WHOLEMEMORY_CHECK_NOTHROW(wholememory::destroy_all_communicators() == WHOLEMEMORY_SUCCESS);
+
+      WHOLEMEMORY_CHECK_NOTHROW(wholememory_finalize() == WHOLEMEMORY_SUCCESS);
+    },
+    true);
+}
+
+/**
+ * Parse comma separated integer list, return false if any value is not in [min_value, max_value].
+ */
+template <typename T>
+bool parse_int_list(const char* arg, int64_t min_value, int64_t max_value, std::vector<T>* values)
+{
+  values->clear();
+  std::stringstream ss(arg);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    char* endptr;
+    long long val = strtoll(item.c_str(), &endptr, 10);
+    if (item.empty() || *endptr != '\0' || val < min_value || val > max_value) return false;
+    values->push_back(static_cast<T>(val));
+  }
+  return !values->empty();
+}
+
+}  // namespace wholegraph::bench::file_io
+
+int main(int argc, char** argv)
+{
+  using wholegraph::bench::file_io::parse_int_list;
+  wholegraph::bench::file_io::FileIOBenchParam params;
+  const char* optstr   = "ht:l:e:d:x:k:j:c:f:o:ua:p:r:s:n:";
+  struct option opts[] = {
+    {"help", no_argument, NULL, 'h'},
+    {"memory_type", required_argument, NULL, 't'},      // 1: Continuous, 2: Chunked, 3 Distributed
+    {"memory_location", required_argument, NULL, 'l'},  // 1: Device, 2: Host
+    {"table_size", required_argument, NULL, 'e'},
+    {"entry_size", required_argument, NULL, 'd'},
+    {"stride_padding", required_argument, NULL, 'x'},
+    {"file_count", required_argument, NULL, 'k'},
+    {"thread_count", required_argument, NULL, 'j'},
+    {"loop_count", required_argument, NULL, 'c'},
+    {"test_type", required_argument, NULL, 'f'},  // test_type: load, store or all
+    {"file_dir", required_argument, NULL, 'o'},
+    {"drop_cache", no_argument, NULL, 'u'},
+    {"node_rank", required_argument, NULL, 'r'},    // node_rank
+    {"node_size", required_argument, NULL, 's'},    // node_size
+    {"num_gpu", required_argument, NULL, 'n'},      // num gpu per node
+    {"server_addr", required_argument, NULL, 'a'},  // server_addr
+    {"server_port", required_argument, NULL, 'p'}   // server_port
+  };
+
+  const char* usage =
+    "Usage: %s [options]\n"
+    "Options, LIST means comma separated values which are all swept:\n"
+    "  -h, --help      display this help and exit\n"
+    "  -t, --memory_type LIST   wholememory type, 1: Continuous, 2: Chunked, 3: Distributed\n"
+    "  -l, --memory_location LIST   wholememory location, 1: Device, 2: Host\n"
+    "  -e, --table_size    total file size in bytes\n"
+    "  -d, --entry_size LIST   entry size in bytes of files\n"
+    "  -x, --stride_padding LIST   memory stride minus entry size in bytes, non zero uses "
+    "cudaMemcpy2D\n"
+    "  -k, --file_count LIST   number of input files for load\n"
+    "  -j, --thread_count LIST   WHOLEMEMORY_LOAD_THREAD_COUNT for load\n"
+    "  -c, --loop_count    specify loop count\n"
+    "  -f, --test_type    specify test type: load, store or all\n"
+    "  -o, --file_dir    directory for generated files, should be shared by all nodes\n"
+    "  -u, --drop_cache    evict input files from page cache before each load\n"
+    "  -r, --node_rank    node_rank of current process\n"
+    "  -s, --node_size    node_size or process count\n"
+    "  -n, --num_gpu   num_gpu per process\n"
+    "  -a, --server_addr    specify sideband server address\n"
+    "  -p, --server_port    specify sideband server port\n";
+
+  int c;
+  bool has_option = false;
+  std::vector<int> int_values;
+  std::vector<int64_t> int64_values;
+  while ((c = getopt_long(argc, argv, optstr, opts, NULL)) != -1) {
+    has_option = true;
+    bool valid = true;
+    switch (c) {
+      long val;
+      case 'h': printf(usage, argv[0]); exit(EXIT_SUCCESS);
+      case 't':
+        valid = parse_int_list(optarg, 1, 3, &int_values);
+        if (valid) {
+          std::vector<wholememory_memory_type_t> memory_types;
+          for (int value : int_values) {
+            memory_types.push_back(static_cast<wholememory_memory_type_t>(value));
+          }
+          params.set_memory_types(memory_types);
+        }
+        break;
+      case 'l':
+        valid = parse_int_list(optarg, 1, 2, &int_values);
+        if (valid) {
+          std::vector<wholememory_memory_location_t> memory_locations;
+          for (int value : int_values) {
+            memory_locations.push_back(static_cast<wholememory_memory_location_t>(value));
+          }
+          params.set_memory_locations(memory_locations);
+        }
+        break;
+      case 'e':
+        val   = std::stoll(optarg);
+        valid = val > 0;
+        if (valid) params.set_table_size(val);
+        break;
+      case 'd':
+        valid = parse_int_list(optarg, 1, INT32_MAX, &int64_values);
+        if (valid) params.set_entry_sizes(int64_values);
+        break;
+      case 'x':
+        valid = parse_int_list(optarg, 0, INT32_MAX, &int64_values);
+        if (valid) params.set_stride_paddings(int64_values);
+        break;
+      case 'k':
+        valid = parse_int_list(optarg, 1, 65535, &int_values);
+        if (valid) params.set_file_counts(int_values);
+        break;
+      case 'j':
+        valid = parse_int_list(optarg, 1, 1024, &int_values);
+        if (valid) params.set_thread_counts(int_values);
+        break;
+      case 'c':
+        val   = std::stoi(optarg);
+        valid = val > 0;
+        if (valid) params.set_loop_count(val);
+        break;
+      case 'f':
+        valid = strcmp(optarg, "load") == 0 || strcmp(optarg, "store") == 0 ||
+                strcmp(optarg, "all") == 0;
+        if (valid) params.set_test_type(optarg);
+        break;
+      case 'o': params.set_file_dir(optarg); break;
+      case 'u': params.set_drop_cache(true); break;
+      case 'a': params.set_server_addr(optarg); break;
+      case 'p':
+        val   = std::atoi(optarg);
+        valid = val >= 0;
+        if (valid) params.set_server_port(val);
+        break;
+      case 'r':
+        val   = std::atoi(optarg);
+        valid = val >= 0;
+        if (valid) params.set_node_rank(val);
+        break;
+      case 's':
+        val   = std::atoi(optarg);
+        valid = val >= 0;
+        if (valid) params.set_node_size(val);
+        break;
+      case 'n':
+        val   = std::atoi(optarg);
+        valid = val >= 0;
+        if (valid) params.set_num_gpu(val);
+        break;
+      default:
+        printf("Invalid or unrecognized option\n");
+        printf(usage, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if (!valid) {
+      printf("Invalid argument for option -%c\n", c);
+      printf(usage, argv[0]);
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (!has_option) { printf("No option or argument is passed, use the default param\n"); }
+  wholegraph::bench::file_io::file_io_benchmark(params);
+  return 0;
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <getopt.h>
+#include <sys/time.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <wholememory/wholememory.h>
+
+#include "parallel_utils.hpp"
+#include "wholememory/communicator.hpp"
+#include "wholememory/memory_handle.hpp"
+
+#include "../../tests/wholememory/wholememory_test_utils.hpp"
+
+namespace wholegraph::bench::handle_lookup {
+
+#define TIME_DIFF_US(TVS, TVE) \
+  ((TVE.tv_sec - TVS.tv_sec) * 1000ULL * 1000ULL + (TVE.tv_usec - TVS.tv_usec))
+
+struct HandleLookupBenchParam {
+  std::vector<int64_t> thread_counts = {1, 2, 4, 8, 16};
+  int64_t handle_count               = 16;
+  int64_t handle_size                = 4 * 1024 * 1024;
+  int64_t lookup_count               = 4 * 1024 * 1024;
+};
+
+/**
+ * Mutex protected map lookup, as wholememory_get_handle did before it became lock free.
+ */
+class MutexMapLookup {
+ public:
+  void Register(const void* ptr, size_t size, wholememory_handle_t handle)
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    uint64_t int_ptr     = reinterpret_cast<uint64_t>(ptr);
+    map_[int_ptr + size] = {int_ptr, handle};
+  }
+  wholememory_handle_t Lookup(const void* ptr)
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    uint64_t int_ptr = reinterpret_cast<uint64_t>(ptr);
+    auto it          = map_.upper_bound(int_ptr);
+    if (it == map_.end() || int_ptr < it->second.first) return nullptr;
+    return it->second.second;
+  }
+
+ private:
+  std::mutex mu_;
+  std::map<uint64_t, std::pair<uint64_t, wholememory_handle_t>> map_;
+};
+
+// runs lookup_fn(ptr) on all pointers in each of thread_count threads, returns elapsed time.
+template <typename LookupFn>
+double run_lookup_threads(int thread_count,
+                          const std::vector<const void*>& ptrs,
+                          const std::vector<wholememory_handle_t>& expected,
+                          int64_t lookup_count,
+                          LookupFn lookup_fn)
+{
+  std::atomic<int> ready_count{0};
+  std::atomic<bool> start{false};
+  std::atomic<int64_t> mismatch_count{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_count; t++) {
+    threads.emplace_back([&, t] {
+      // warm up, also takes reader slot of thread.
+      lookup_fn(ptrs[t % ptrs.size()]);
+      ready_count.fetch_add(1);
+      while (!start.load()) {}
+      int64_t mismatch = 0;
+      size_t idx       = static_cast<size_t>(t) * 7919 % ptrs.size();
+      for (int64_t i = 0; i < lookup_count; i++) {
+        if (lookup_fn(ptrs[idx]) != expected[idx]) mismatch++;
+        if (++idx == ptrs.size()) idx = 0;
+      }
+      mismatch_count.fetch_add(mismatch);
+    });
+  }
+  while (ready_count.load() != thread_count) {}
+  struct timeval tv_s, tv_e;
+  gettimeofday(&tv_s, nullptr);
+  start.store(true);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  gettimeofday(&tv_e, nullptr);
+  WHOLEMEMORY_CHECK_NOTHROW(mismatch_count.load() == 0);
+  return static_cast<double>(TIME_DIFF_US(tv_s, tv_e));
+}
+
+void handle_lookup_benchmark(const HandleLookupBenchParam& params)
+{
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, 1);
+  WHOLEMEMORY_CHECK_NOTHROW(wholememory_init(0) == WHOLEMEMORY_SUCCESS);
+  wholememory_comm_t wm_comm = create_communicator_by_pipes(pipes, 0, 1, WHOLEMEMORY_CB_HOST);
+
+  MutexMapLookup mutex_map;
+  std::vector<wholememory_handle_t> handles(params.handle_count);
+  std::vector<char*> handle_ptrs(params.handle_count);
+  for (int64_t i = 0; i < params.handle_count; i++) {
+    WHOLEMEMORY_CHECK_NOTHROW(wholememory_malloc(&handles[i],
+                                                 params.handle_size,
+                                                 wm_comm,
+                                                 WHOLEMEMORY_MT_CONTINUOUS,
+                                                 WHOLEMEMORY_ML_HOST,
+                                                 1) == WHOLEMEMORY_SUCCESS);
+    void* global_ptr;
+    WHOLEMEMORY_CHECK_NOTHROW(wholememory_get_global_pointer(&global_ptr, handles[i]) ==
+                              WHOLEMEMORY_SUCCESS);
+    handle_ptrs[i] = static_cast<char*>(global_ptr);
+    mutex_map.Register(global_ptr, params.handle_size, handles[i]);
+  }
+
+  // one of eight pointers is not in any WholeMemory.
+  std::vector<char> outside_buffer(4096);
+  std::vector<const void*> ptrs(64 * 1024);
+  std::vector<wholememory_handle_t> expected(ptrs.size());
+  uint64_t seed = 0x9E3779B97F4A7C15ULL;
+  for (size_t i = 0; i < ptrs.size(); i++) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    if (i % 8 == 7) {
+      ptrs[i]     = outside_buffer.data() + seed % outside_buffer.size();
+      expected[i] = nullptr;
+    } else {
+      int64_t handle_idx = static_cast<int64_t>(seed % params.handle_count);
+      ptrs[i]            = handle_ptrs[handle_idx] + (seed >> 20) % params.handle_size;
+      expected[i]        = handles[handle_idx];
+    }
+  }
+
+  for (int64_t thread_count : params.thread_counts) {
+    double lock_free_us = run_lookup_threads(
+      thread_count, ptrs, expected, params.lookup_count, [](const void* ptr) {
+        return wholememory::wholememory_get_handle(ptr);
+      });
+    double mutex_us = run_lookup_threads(
+      thread_count, ptrs, expected, params.lookup_count, [&mutex_map](const void* ptr) {
+        return mutex_map.Lookup(ptr);
+      });
+    double total_lookups = static_cast<double>(params.lookup_count) * thread_count;
+    printf("threads=%-4ld handles=%-4ld lock_free=%10.2f Mlookups/s mutex_map=%10.2f Mlookups/s\n",
+           thread_count,
+           params.handle_count,
+           total_lookups / lock_free_us,
+           total_lookups / mutex_us);
+  }
+
+  for (auto handle : handles) {
+    WHOLEMEMORY_CHECK_NOTHROW(wholememory_free(handle) == WHOLEMEMORY_SUCCESS);
+  }
+  WHOLEMEMORY_CHECK_NOTHROW(wholememory::destroy_all_communicators() == WHOLEMEMORY_SUCCESS);
+  WHOLEMEMORY_CHECK_NOTHROW(wholememory_finalize() == WHOLEMEMORY_SUCCESS);
+  ClosePipes(&pipes);
+}
+
+/**
+ * Parse comma separated integer list, return false if any value is not in [min_value, max_value].
+ */
+bool parse_int_list(const char* arg,
+                    int64_t min_value,
+                    int64_t max_value,
+                    std::vector<int64_t>* values)
+{
+  values->clear();
+  std::stringstream ss(arg);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    char* endptr;
+    long long val = strtoll(item.c_str(), &endptr, 10);
+    if (item.empty() || *endptr != '\0' || val < min_value || val > max_value) return false;
+    values->push_back(val);
+  }
+  return !values->empty();
+}
+
+}  // namespace wholegraph::bench::handle_lookup
+
+int main(int argc, char** argv)
+{
+  using wholegraph::bench::handle_lookup::parse_int_list;
+  wholegraph::bench::handle_lookup::HandleLookupBenchParam params;
+  const char* optstr   = "ht:m:s:c:";
+  struct option opts[] = {{"help", no_argument, NULL, 'h'},
+                          {"thread_count", required_argument, NULL, 't'},
+                          {"handle_count", required_argument, NULL, 'm'},
+                          {"handle_size", required_argument, NULL, 's'},
+                          {"lookup_count", required_argument, NULL, 'c'}};
+
+  const char* usage =
+    "Usage: %s [options]\n"
+    "Measures throughput of concurrent wholememory_get_handle lookups, compared with mutex\n"
+    "protected map. LIST means comma separated values which are all swept:\n"
+    "  -h, --help      display this help and exit\n"
+    "  -t, --thread_count LIST   number of lookup threads\n"
+    "  -m, --handle_count    number of host WholeMemory handles\n"
+    "  -s, --handle_size    size of each handle in bytes\n"
+    "  -c, --lookup_count    lookup count per thread\n";
+
+  int c;
+  while ((c = getopt_long(argc, argv, optstr, opts, NULL)) != -1) {
+    switch (c) {
+      case 'h': printf(usage, argv[0]); exit(EXIT_SUCCESS);
+      case 't':
+        if (!parse_int_list(optarg, 1, 4096, &params.thread_counts)) {
+          printf("Invalid argument for option -%c\n", c);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'm':
+        params.handle_count = atoll(optarg);
+        if (params.handle_count <= 0) {
+          printf("Invalid argument for option -%c\n", c);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 's':
+        params.handle_size = atoll(optarg);
+        if (params.handle_size <= 0) {
+          printf("Invalid argument for option -%c\n", c);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'c':
+        params.lookup_count = atoll(optarg);
+        if (params.lookup_count <= 0) {
+          printf("Invalid argument for option -%c\n", c);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      default:
+        printf("Invalid or unrecognized option\n");
+        printf(usage, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+  }
+  wholegraph::bench::handle_lookup::handle_lookup_benchmark(params);
+  return 0;
+}
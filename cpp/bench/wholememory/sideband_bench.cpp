@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <getopt.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "logger.hpp"
+#include "net_utils.h"
+#include "parallel_utils.hpp"
+
+namespace wholegraph::bench::sideband {
+
+#define TIME_DIFF_US(TVS, TVE) \
+  ((TVE.tv_sec - TVS.tv_sec) * 1000ULL * 1000ULL + (TVE.tv_usec - TVS.tv_usec))
+
+/**
+ * Baseline which relays every collective through rank 0, each rank only connects to rank 0.
+ */
+class StarSideBand {
+ public:
+  StarSideBand(int world_rank, int world_size, const char* server_addr, int port)
+    : world_rank_(world_rank), world_size_(world_size)
+  {
+    if (world_rank_ == 0) {
+      int listen_fd = CreateServerListenFd(port);
+      ServerListen(listen_fd, world_size_);
+      fds_.resize(world_size_, -1);
+      for (int i = 1; i < world_size_; i++) {
+        sockaddr_in client_addr;
+        socklen_t client_addr_len = sizeof(client_addr);
+        int client_sock           = ServerAccept(listen_fd, &client_addr, &client_addr_len);
+        WHOLEMEMORY_CHECK_NOTHROW(client_sock >= 0);
+        int rank_id = -1;
+        SingleRecv(client_sock, &rank_id, sizeof(int));
+        WHOLEMEMORY_CHECK_NOTHROW(rank_id > 0 && rank_id < world_size_ && fds_[rank_id] == -1);
+        fds_[rank_id] = client_sock;
+      }
+      WHOLEMEMORY_CHECK_NOTHROW(close(listen_fd) == 0);
+    } else {
+      fds_.push_back(CreateClientFd(server_addr, port));
+      SingleSend(fds_[0], &world_rank_, sizeof(int));
+    }
+    Barrier();
+  }
+  ~StarSideBand()
+  {
+    for (int fd : fds_) {
+      if (fd >= 0) WHOLEMEMORY_CHECK_NOTHROW(close(fd) == 0);
+    }
+  }
+  void AllGather(const void* input, void* output, size_t element_size)
+  {
+    if (world_rank_ != 0) {
+      SingleSend(fds_[0], input, element_size);
+      SingleRecv(fds_[0], output, element_size * world_size_);
+      return;
+    }
+    char* output_ptr = static_cast<char*>(output);
+    memmove(output_ptr, input, element_size);
+    for (int r = 1; r < world_size_; r++) {
+      SingleRecv(fds_[r], output_ptr + r * element_size, element_size);
+    }
+    for (int r = 1; r < world_size_; r++) {
+      SingleSend(fds_[r], output_ptr, element_size * world_size_);
+    }
+  }
+  void AllToAll(const void* input, void* output, size_t element_size)
+  {
+    size_t rank_bytes = element_size * world_size_;
+    if (world_rank_ != 0) {
+      SingleSend(fds_[0], input, rank_bytes);
+      SingleRecv(fds_[0], output, rank_bytes);
+      return;
+    }
+    std::vector<char> all_input(rank_bytes * world_size_);
+    std::vector<char> send_buffer(rank_bytes);
+    memcpy(all_input.data(), input, rank_bytes);
+    for (int r = 1; r < world_size_; r++) {
+      SingleRecv(fds_[r], all_input.data() + r * rank_bytes, rank_bytes);
+    }
+    for (int dst = 0; dst < world_size_; dst++) {
+      char* dst_ptr = dst == 0 ? static_cast<char*>(output) : send_buffer.data();
+      for (int src = 0; src < world_size_; src++) {
+        memcpy(dst_ptr + src * element_size,
+               all_input.data() + src * rank_bytes + dst * element_size,
+               element_size);
+      }
+      if (dst != 0) SingleSend(fds_[dst], send_buffer.data(), rank_bytes);
+    }
+  }
+  void Broadcast(void* data, size_t element_size)
+  {
+    if (world_rank_ != 0) {
+      SingleRecv(fds_[0], data, element_size);
+      return;
+    }
+    for (int r = 1; r < world_size_; r++) {
+      SingleSend(fds_[r], data, element_size);
+    }
+  }
+  void Barrier()
+  {
+    int data = 0;
+    std::vector<int> recv_data(world_size_);
+    AllGather(&data, recv_data.data(), sizeof(int));
+  }
+
+ private:
+  int world_rank_;
+  int world_size_;
+  std::vector<int> fds_;
+};
+
+typedef struct SideBandBenchParam {
+  std::vector<int> rank_counts    = {2, 4, 8};
+  std::vector<int64_t> sizes      = {64, 64 * 1024, 16 * 1024 * 1024};
+  int loop_count                  = 20;
+  std::string server_addr         = "127.0.0.1";
+  int server_port                 = 24987;
+} SideBandBenchParam;
+
+/**
+ * Runs f loop_count times between barriers, returns average time of rank 0 in microseconds.
+ */
+template <typename BarrierFunc, typename F>
+double measure_us(int loop_count, BarrierFunc barrier_fn, F f)
+{
+  f();
+  barrier_fn();
+  timeval tv_s, tv_e;
+  gettimeofday(&tv_s, nullptr);
+  for (int i = 0; i < loop_count; i++) {
+    f();
+  }
+  barrier_fn();
+  gettimeofday(&tv_e, nullptr);
+  return static_cast<double>(TIME_DIFF_US(tv_s, tv_e)) / loop_count;
+}
+
+template <typename Comm>
+void run_collectives(Comm* comm,
+                     const char* name,
+                     int world_rank,
+                     int world_size,
+                     const SideBandBenchParam& params,
+                     double bootstrap_us)
+{
+  auto barrier_fn = [comm] { comm->Barrier(); };
+  for (int64_t size : params.sizes) {
+    // size is the total payload per rank, allgather and alltoall split it in world_size blocks.
+    size_t element_size = std::max<size_t>(size / world_size, 1);
+    std::vector<char> input(element_size * world_size, static_cast<char>(world_rank));
+    std::vector<char> output(element_size * world_size);
+    double allgather_us = measure_us(params.loop_count, barrier_fn, [&] {
+      comm->AllGather(input.data(), output.data(), element_size);
+    });
+    for (int r = 0; r < world_size; r++) {
+      WHOLEMEMORY_CHECK_NOTHROW(output[r * element_size] == static_cast<char>(r));
+    }
+    double alltoall_us = measure_us(params.loop_count, barrier_fn, [&] {
+      comm->AllToAll(input.data(), output.data(), element_size);
+    });
+    for (int r = 0; r < world_size; r++) {
+      WHOLEMEMORY_CHECK_NOTHROW(output[(r + 1) * element_size - 1] == static_cast<char>(r));
+    }
+    std::vector<char> bcast_data(size, static_cast<char>(world_rank));
+    double broadcast_us = measure_us(
+      params.loop_count, barrier_fn, [&] { comm->Broadcast(bcast_data.data(), size); });
+    WHOLEMEMORY_CHECK_NOTHROW(bcast_data[size - 1] == 0);
+    if (world_rank == 0) {
+      printf("%-5s ranks=%-3d size=%-10ld bootstrap=%10.1fus allgather=%10.1fus "
+             "alltoall=%10.1fus broadcast=%10.1fus\n",
+             name,
+             world_size,
+             size,
+             bootstrap_us,
+             allgather_us,
+             alltoall_us,
+             broadcast_us);
+    }
+  }
+}
+
+/**
+ * Adapts SideBandCommunicator to the interface used by run_collectives.
+ */
+class PeerSideBand {
+ public:
+  PeerSideBand(int world_rank, int world_size, const char* server_addr, int port)
+    : comm_(StartSidebandCommunicator(world_rank, world_size, server_addr, port)),
+      world_size_(world_size)
+  {
+  }
+  ~PeerSideBand() { ShutDownSidebandCommunicator(comm_); }
+  void AllGather(const void* input, void* output, size_t element_size)
+  {
+    SideBandAllGather(comm_, input, output, element_size);
+  }
+  void AllToAll(const void* input, void* output, size_t element_size)
+  {
+    SideBandAllToAll(comm_, input, output, element_size);
+  }
+  void Broadcast(void* data, size_t element_size)
+  {
+    SideBandBroadcast(comm_, data, element_size, 0);
+  }
+  void Barrier()
+  {
+    int data = 0;
+    std::vector<int> recv_data(world_size_);
+    SideBandAllGather(comm_, &data, recv_data.data(), sizeof(int));
+  }
+
+ private:
+  SideBandCommunicator* comm_;
+  int world_size_;
+};
+
+template <typename Comm>
+void sideband_benchmark_one_config(const char* name,
+                                   int world_rank,
+                                   int world_size,
+                                   const SideBandBenchParam& params,
+                                   int port)
+{
+  timeval tv_s, tv_e;
+  gettimeofday(&tv_s, nullptr);
+  Comm comm(world_rank, world_size, params.server_addr.c_str(), port);
+  gettimeofday(&tv_e, nullptr);
+  double bootstrap_us = static_cast<double>(TIME_DIFF_US(tv_s, tv_e));
+  run_collectives(&comm, name, world_rank, world_size, params, bootstrap_us);
+}
+
+void sideband_benchmark(const SideBandBenchParam& params)
+{
+  int port = params.server_port;
+  for (int rank_count : params.rank_counts) {
+    // new port for each run, the listen port of previous run may be in TIME_WAIT.
+    MultiProcessRun(rank_count, [&params, port](int world_rank, int world_size) {
+      sideband_benchmark_one_config<StarSideBand>("star", world_rank, world_size, params, port);
+    });
+    MultiProcessRun(rank_count, [&params, port](int world_rank, int world_size) {
+      sideband_benchmark_one_config<PeerSideBand>(
+        "peer", world_rank, world_size, params, port + 1);
+    });
+    port += 2;
+  }
+}
+
+/**
+ * Parse comma separated integer list, return false if any value is not in [min_value, max_value].
+ */
+template <typename T>
+bool parse_int_list(const char* arg, int64_t min_value, int64_t max_value, std::vector<T>* values)
+{
+  values->clear();
+  std::stringstream ss(arg);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    char* endptr;
+    long long val = strtoll(item.c_str(), &endptr, 10);
+    if (item.empty() || *endptr != '\0' || val < min_value || val > max_value) return false;
+    values->push_back(static_cast<T>(val));
+  }
+  return !values->empty();
+}
+
+}  // namespace wholegraph::bench::sideband
+
+int main(int argc, char** argv)
+{
+  using wholegraph::bench::sideband::parse_int_list;
+  wholegraph::bench::sideband::SideBandBenchParam params;
+  const char* optstr   = "hn:b:c:a:p:";
+  struct option opts[] = {{"help", no_argument, NULL, 'h'},
+                          {"rank_count", required_argument, NULL, 'n'},
+                          {"size", required_argument, NULL, 'b'},
+                          {"loop_count", required_argument, NULL, 'c'},
+                          {"server_addr", required_argument, NULL, 'a'},
+                          {"server_port", required_argument, NULL, 'p'}};
+
+  const char* usage =
+    "Usage: %s [options]\n"
+    "Compares star sideband communicator relaying through rank 0 with peer connected one,\n"
+    "all ranks are local processes. LIST means comma separated values which are all swept:\n"
+    "  -h, --help      display this help and exit\n"
+    "  -n, --rank_count LIST   number of local ranks\n"
+    "  -b, --size LIST   payload size in bytes per rank\n"
+    "  -c, --loop_count    specify loop count\n"
+    "  -a, --server_addr    specify sideband server address\n"
+    "  -p, --server_port    specify first sideband server port, two ports are used per run\n";
+
+  int c;
+  while ((c = getopt_long(argc, argv, optstr, opts, NULL)) != -1) {
+    switch (c) {
+      case 'h': printf(usage, argv[0]); exit(EXIT_SUCCESS);
+      case 'n':
+        if (!parse_int_list(optarg, 1, 1024, &params.rank_counts)) {
+          printf("Invalid argument for option -%c\n", c);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'b':
+        if (!parse_int_list(optarg, 1, 1LL << 32, &params.sizes)) {
+          printf("Invalid argument for option -%c\n", c);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'c':
+        params.loop_count = atoi(optarg);
+        if (params.loop_count <= 0) {
+          printf("Invalid argument for option -%c\n", c);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'a': params.server_addr = optarg; break;
+      case 'p':
+        params.server_port = atoi(optarg);
+        if (params.server_port <= 0 || params.server_port > 65533) {
+          printf("Invalid argument for option -%c\n", c);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      default:
+        printf("Invalid or unrecognized option\n");
+        printf(usage, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+  }
+  wholegraph::bench::sideband::sideband_benchmark(params);
+  return 0;
+}
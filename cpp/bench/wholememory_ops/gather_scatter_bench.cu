@@ -68,6 +68,7 @@ typedef struct GatherScatterBenchParam {
   wholememory_memory_location_t get_memory_location() const { return memory_location; }
   int get_loop_count() const { return loop_count; }
   std::string get_test_type() const { return test_type; }
+  unsigned int get_init_flags() const { return init_flags; }
 
   std::string get_server_addr() const { return server_addr; }
   int get_server_port() const { return server_port; }
@@ -123,6 +124,12 @@ typedef struct GatherScatterBenchParam {
     return *this;
   }
 
+  GatherScatterBenchParam& set_init_flags(unsigned int new_init_flags)
+  {
+    init_flags = new_init_flags;
+    return *this;
+  }
+
   GatherScatterBenchParam& set_server_addr(std::string new_server_addr)
   {
     server_addr = new_server_addr;
@@ -196,6 +203,7 @@ typedef struct GatherScatterBenchParam {
   int64_t embedding_dim                         = 32;
   int loop_count                                = 20;
   std::string test_type                         = "gather";  // gather or scatter
+  unsigned int init_flags                       = 0;
 
   std::string server_addr = "localhost";
   int server_port         = 24987;
@@ -233,6 +241,7 @@ std::string get_memory_location_string(wholememory_memory_location_t memory_loca
     case WHOLEMEMORY_ML_NONE: str = "WHOLEMEMORY_ML_NONE"; break;
     case WHOLEMEMORY_ML_DEVICE: str = "WHOLEMEMORY_ML_DEVICE"; break;
     case WHOLEMEMORY_ML_HOST: str = "WHOLEMEMORY_ML_HOST"; break;
+    case WHOLEMEMORY_ML_FILE: str = "WHOLEMEMORY_ML_FILE"; break;
     default: break;
   }
   return str;
@@ -246,7 +255,7 @@ void gather_scatter_benchmark(GatherScatterBenchParam& params)
   MultiProcessRun(
     g_dev_count,
     [&params](int local_rank, int local_size) {
-      WHOLEMEMORY_CHECK_NOTHROW(wholememory_init(0) == WHOLEMEMORY_SUCCESS);
+      WHOLEMEMORY_CHECK_NOTHROW(wholememory_init(params.get_init_flags()) == WHOLEMEMORY_SUCCESS);
       WM_CUDA_CHECK_NO_THROW(cudaSetDevice(local_rank));
       int world_size = local_size * params.get_node_size();
       int world_rank = params.get_node_rank() * params.get_num_gpu() + local_rank;
@@ -318,12 +327,13 @@ void gather_scatter_benchmark(GatherScatterBenchParam& params)
       double gather_size_mb = (double)params.get_gather_size() / 1024.0 / 1024.0;
       if (local_rank == 0) {
         printf(
-          "%s, world_size=%d, memoryType=%s, memoryLocation=%s, elt_size=%ld, embeddingDim=%ld, "
-          "embeddingTableSize=%.2lf MB, gatherSize=%.2lf MB\n",
+          "%s, world_size=%d, memoryType=%s, memoryLocation=%s, initFlags=0x%x, elt_size=%ld, "
+          "embeddingDim=%ld, embeddingTableSize=%.2lf MB, gatherSize=%.2lf MB\n",
           test_type.c_str(),
           world_size,
           get_memory_type_string(params.get_memory_type()).c_str(),
           get_memory_location_string(params.get_memory_location()).c_str(),
+          params.get_init_flags(),
           wholememory_dtype_get_element_size(params.get_embedding_type()),
           params.get_embedding_dim(),
           emb_size_mb,
@@ -388,7 +398,7 @@ void gather_scatter_benchmark(GatherScatterBenchParam& params)
 int main(int argc, char** argv)
 {
   wholegraph::bench::gather_scatter::GatherScatterBenchParam params;
-  const char* optstr   = "ht:l:e:g:d:c:f:a:p:r:s:n:";
+  const char* optstr   = "ht:l:e:g:d:c:f:u:a:p:r:s:n:";
   struct option opts[] = {
     {"help", no_argument, NULL, 'h'},
     {"memory_type",
@@ -401,6 +411,7 @@ int main(int argc, char** argv)
     {"embedding_dim", required_argument, NULL, 'd'},
     {"loop_count", required_argument, NULL, 'c'},
     {"test_type", required_argument, NULL, 'f'},    // test_type: gather or scatter
+    {"huge_page", required_argument, NULL, 'u'},    // 0: None, 1: 2MB, 2: 1GB
     {"node_rank", required_argument, NULL, 'r'},    // node_rank
     {"node_size", required_argument, NULL, 's'},    // node_size
     {"num_gpu", required_argument, NULL, 'n'},      // num gpu per node
@@ -420,6 +431,7 @@ int main(int argc, char** argv)
     "  -d, --embedding_dim    specify embedding dimension\n"
     "  -c, --loop_count    specify loop count\n"
     "  -f, --test_type    specify test type: gather or scatter\n"
+    "  -u, --huge_page    huge pages for host memory, 0: None, 1: 2MB, 2: 1GB\n"
     "  -r, --node_rank    node_rank of current process\n"
     "  -s, --node_size    node_size or process count\n"
     "  -n, --num_gpu   num_gpu per process\n"
@@ -499,6 +511,19 @@ int main(int argc, char** argv)
           exit(EXIT_FAILURE);
         }
         break;
+      case 'u':
+        val = strtol(optarg, &endptr, 10);
+        if (*endptr != '\0' || val < 0 || val > 2) {
+          printf("Invalid argument for option -u\n");
+          printf(usage, argv[0]);
+          exit(EXIT_FAILURE);
+        }
+        {
+          const unsigned int huge_page_flags[] = {
+            0, WHOLEMEMORY_INIT_HUGE_PAGE_2MB, WHOLEMEMORY_INIT_HUGE_PAGE_1GB};
+          params.set_init_flags(huge_page_flags[val]);
+        }
+        break;
       case 'a': params.set_server_addr(optarg); break;
       case 'p':
         val = std::atoi(optarg);
@@ -43,6 +43,13 @@ typedef struct wholememory_embedding_optimizer_* wholememory_embedding_optimizer
  */
 typedef struct wholememory_embedding_* wholememory_embedding_t;
 
+/**
+ * @brief Opaque handle to asynchronous snapshot of WholeMemory Embedding
+ *
+ * An Opaque handle to asynchronous snapshot of WholeMemory Embedding
+ */
+typedef struct wholememory_embedding_snapshot_* wholememory_embedding_snapshot_t;
+
 /**
  * @enum wholememory_access_type_t
  * @brief defines access type of WholeMemory Embedding
@@ -229,6 +236,74 @@ wholememory_error_code_t wholememory_embedding_writeback_cache(
 wholememory_error_code_t wholememory_embedding_drop_all_cache(
   wholememory_embedding_t wholememory_embedding, int64_t stream_int);
 
+/**
+ * Save rows of WholeMemory Embedding and optimizer states updated since last save_delta or
+ * reset_dirty_rows, all ranks should call this together. Each rank writes
+ * "<file_prefix>_delta_part_<rank>_of_<world_size>". Only embedding with optimizer tracks rows.
+ * Rows updated while saving stay dirty for next delta. If saving fails on any rank, all ranks
+ * return error and keep their rows dirty.
+ * @param wholememory_embedding : WholeMemory Embedding
+ * @param file_prefix : prefix of delta files
+ * @param stream_int : CUDA stream to use.
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_embedding_save_delta(
+  wholememory_embedding_t wholememory_embedding, const char* file_prefix, int64_t stream_int);
+
+/**
+ * Mark all rows of WholeMemory Embedding as clean, e.g. after full save.
+ * @param wholememory_embedding : WholeMemory Embedding
+ * @param stream_int : CUDA stream to use.
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_embedding_reset_dirty_rows(
+  wholememory_embedding_t wholememory_embedding, int64_t stream_int);
+
+/**
+ * Start asynchronous snapshot of WholeMemory Embedding and optimizer states.
+ * Local partition is copied into host staging buffers on stream, so work enqueued on stream later
+ * won't change the snapshot. Files are written by a background thread in the same layout as full
+ * save, "<file_prefix>_<embedding_tensor or state name>_part_<rank>_of_<world_size>".
+ * Each rank writes its own files, snapshot is complete after all ranks have waited successfully.
+ * Snapshot doesn't mark rows clean, rows updated before it are still saved by next save_delta.
+ * @param snapshot : returned snapshot handle, should be destroyed by
+ * wholememory_destroy_embedding_snapshot
+ * @param wholememory_embedding : WholeMemory Embedding
+ * @param file_prefix : file name prefix
+ * @param stream_int : CUDA stream to use.
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_embedding_start_snapshot(
+  wholememory_embedding_snapshot_t* snapshot,
+  wholememory_embedding_t wholememory_embedding,
+  const char* file_prefix,
+  int64_t stream_int);
+
+/**
+ * Query if snapshot files are written, never blocks.
+ * @param is_done : returns 1 if all files are written or failed, else 0
+ * @param snapshot : snapshot handle
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_embedding_snapshot_is_done(
+  int* is_done, wholememory_embedding_snapshot_t snapshot);
+
+/**
+ * Wait until snapshot files are written.
+ * @param snapshot : snapshot handle
+ * @return : wholememory_error_code_t of background writing
+ */
+wholememory_error_code_t wholememory_embedding_snapshot_wait(
+  wholememory_embedding_snapshot_t snapshot);
+
+/**
+ * Destroy snapshot handle, waits for background writing if not finished.
+ * @param snapshot : snapshot handle
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_destroy_embedding_snapshot(
+  wholememory_embedding_snapshot_t snapshot);
+
 #ifdef __cplusplus
 }
 #endif
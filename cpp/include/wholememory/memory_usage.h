@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <wholememory/env_func_ptrs.h>
+#include <wholememory/wholememory.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Purpose of memory, used to break down memory usage.
+ *
+ * WholeMemory allocated by users is of general purpose, memory allocated inside WholeMemory
+ * Embedding and ops is accounted to the purpose it is allocated for.
+ */
+enum wholememory_memory_purpose_t {
+  WHOLEMEMORY_MP_NONE = 0,        /*!< Not defined, matches all purposes in memory usage queries */
+  WHOLEMEMORY_MP_GENERAL,         /*!< WholeMemory allocated by users */
+  WHOLEMEMORY_MP_EMBEDDING,       /*!< Storage of WholeMemory Embedding */
+  WHOLEMEMORY_MP_EMBEDDING_CACHE, /*!< Cache of WholeMemory Embedding */
+  WHOLEMEMORY_MP_OPTIMIZER_STATE, /*!< Optimizer states of WholeMemory Embedding */
+  WHOLEMEMORY_MP_TEMPORARY,       /*!< Temporary memory of ops held by cached allocator */
+};
+
+/**
+ * @brief Memory usage of current rank
+ *
+ * Memory of WholeMemory is accounted to the rank that allocated it, so shared host memory is
+ * accounted to the first rank. Temporary memory includes blocks cached by cached allocator.
+ */
+struct wholememory_memory_usage_t {
+  size_t live_bytes;   /*!< size of memory currently allocated */
+  size_t peak_bytes;   /*!< high-water mark of live_bytes */
+  int64_t live_count;  /*!< number of allocations currently alive */
+  int64_t alloc_count; /*!< number of allocations, growing WholeMemory counts as an allocation */
+};
+
+/**
+ * Get memory usage of current rank in a category. WHOLEMEMORY_MA_NONE, WHOLEMEMORY_MT_NONE or
+ * WHOLEMEMORY_MP_NONE matches all values of that field, so all NONE gets total usage.
+ * Host WholeMemory registered to CUDA is WHOLEMEMORY_MA_PINNED, temporary memory is
+ * WHOLEMEMORY_MT_NONE.
+ * @param usage : returned memory usage
+ * @param allocation_type : allocation type of memory
+ * @param memory_type : WholeMemory Memory Type
+ * @param purpose : purpose of memory
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_get_memory_usage(
+  wholememory_memory_usage_t* usage,
+  wholememory_memory_allocation_type_t allocation_type,
+  wholememory_memory_type_t memory_type,
+  wholememory_memory_purpose_t purpose);
+
+/**
+ * Get memory usage of all ranks in a category by host allgather, all ranks should call together.
+ * @param rank_usages : returned memory usage of each rank, should have world_size elements
+ * @param comm : WholeMemory Communicator
+ * @param allocation_type : allocation type of memory
+ * @param memory_type : WholeMemory Memory Type
+ * @param purpose : purpose of memory
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_get_rank_memory_usage(
+  wholememory_memory_usage_t* rank_usages,
+  wholememory_comm_t comm,
+  wholememory_memory_allocation_type_t allocation_type,
+  wholememory_memory_type_t memory_type,
+  wholememory_memory_purpose_t purpose);
+
+/**
+ * Get memory current rank allocated for WholeMemory Handle, live_count is 1.
+ * @param usage : returned memory usage
+ * @param wholememory_handle : WholeMemory Handle
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_get_handle_memory_usage(
+  wholememory_memory_usage_t* usage, wholememory_handle_t wholememory_handle);
+
+/**
+ * Get purpose of WholeMemory Handle
+ * @param wholememory_handle : WholeMemory Handle
+ * @return : purpose of memory
+ */
+wholememory_memory_purpose_t wholememory_get_memory_purpose(
+  wholememory_handle_t wholememory_handle);
+
+/**
+ * Reset peak_bytes of all memory usage categories of current rank to live_bytes.
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_reset_memory_usage_peak();
+
+#ifdef __cplusplus
+}
+#endif
@@ -23,8 +23,18 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Sample mode of temporal sampling
+ */
+enum wholegraph_temporal_sample_mode_t {
+  WHOLEGRAPH_TSM_UNIFORM = 0, /*!< uniformly sample without replacement from valid neighbors */
+  WHOLEGRAPH_TSM_LATEST,      /*!< take the latest valid neighbors */
+};
+
 /**
  * Unweighted sample without replacement kernel op
+ * If graph is continuous host memory, and center nodes and output sample offset are host memory,
+ * sampling runs on CPU with the same result and outputs are allocated as host memory.
  * @param wm_csr_row_ptr_tensor : Wholememory Tensor of graph csr_row_ptr
  * @param wm_csr_col_ptr_tensor : Wholememory Tensor of graph csr_col_ptr
  * @param center_nodes_tensor : None Wholememory Tensor of center node to sample
@@ -52,8 +62,48 @@ wholememory_error_code_t wholegraph_csr_unweighted_sample_without_replacement(
   wholememory_env_func_t* p_env_fns,
   void* stream);
 
+/**
+ * Multilayer unweighted sample without replacement op, samples all hops in one call.
+ * Hop 0 samples neighbors of center nodes, each later hop samples neighbors of target nodes of the
+ * previous hop. Target nodes of a hop are its center nodes followed by its unique sampled nodes.
+ * Hop i samples with random seed random_seed + i, so its result is the same as
+ * wholegraph_csr_unweighted_sample_without_replacement with that seed.
+ * If graph is continuous host memory and center nodes are host memory, sampling runs on host and
+ * outputs are host memory, otherwise sampling runs on CUDA stream and outputs are device memory.
+ * @param wm_csr_row_ptr_tensor : Wholememory Tensor of graph csr_row_ptr
+ * @param wm_csr_col_ptr_tensor : Wholememory Tensor of graph csr_col_ptr
+ * @param center_nodes_tensor : None Wholememory Tensor of center node to sample, should have same
+ * dtype as csr_col_ptr
+ * @param max_sample_counts : maximum sample count of each hop, hop_count elements
+ * @param hop_count : hop count
+ * @param output_target_nodes_memory_contexts : memory contexts to output target nodes of each hop
+ * @param output_csr_row_ptr_memory_contexts : memory contexts to output sample offset of each hop,
+ * int array of center node count of the hop + 1 elements
+ * @param output_edge_indice_memory_contexts : memory contexts to output edge indice of each hop,
+ * int tensor of 2 x sample count. Row 0 is index of sampled node in target nodes of the hop, which
+ * is csr_col_ind of the hop, row 1 is index of center node in center nodes of the hop.
+ * @param random_seed: random number generator seed
+ * @param p_env_fns : pointers to environment functions.
+ * @param stream : CUDA stream to use
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholegraph_csr_unweighted_multilayer_sample_without_replacement(
+  wholememory_tensor_t wm_csr_row_ptr_tensor,
+  wholememory_tensor_t wm_csr_col_ptr_tensor,
+  wholememory_tensor_t center_nodes_tensor,
+  const int* max_sample_counts,
+  int hop_count,
+  void** output_target_nodes_memory_contexts,
+  void** output_csr_row_ptr_memory_contexts,
+  void** output_edge_indice_memory_contexts,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  void* stream);
+
 /**
  * Unweighted sample without replacement kernel op
+ * If graph is continuous host memory, and center nodes and output sample offset are host memory,
+ * sampling runs on CPU with the same result and outputs are allocated as host memory.
  * @param wm_csr_row_ptr_tensor : Wholememory Tensor of graph csr_row_ptr
  * @param wm_csr_col_ptr_tensor : Wholememory Tensor of graph csr_col_ptr
  * @param wm_csr_weight_ptr_tensor : Wholememory Tensor of graph edge weight
@@ -83,6 +133,167 @@ wholememory_error_code_t wholegraph_csr_weighted_sample_without_replacement(
   wholememory_env_func_t* p_env_fns,
   void* stream);
 
+/**
+ * Unweighted sample with replacement kernel op
+ * Each center node samples fanout neighbors uniformly, a neighbor may be sampled more than once.
+ * Fanout of center node i is center_fanout_tensor[i] if center_fanout_tensor is given, or else
+ * max_sample_count, fanout <= 0 means sample all neighbors once. Per center node fanout is only
+ * supported by the with replacement samplers.
+ * If graph is continuous host memory, and center nodes, center fanout and output sample offset are
+ * host memory, sampling runs on CPU with the same result and outputs are allocated as host memory.
+ * @param wm_csr_row_ptr_tensor : Wholememory Tensor of graph csr_row_ptr
+ * @param wm_csr_col_ptr_tensor : Wholememory Tensor of graph csr_col_ptr
+ * @param center_nodes_tensor : None Wholememory Tensor of center node to sample
+ * @param max_sample_count : sample count of center nodes if center_fanout_tensor is None
+ * @param center_fanout_tensor : None Wholememory int Tensor of sample count of each center node,
+ * same memory and size as center_nodes_tensor, nullptr or 0D tensor for None
+ * @param output_sample_offset_tensor : pointer to output sample offset
+ * @param output_dest_memory_context : memory context to output dest nodes
+ * @param output_center_localid_memory_context : memory context to output center local id
+ * @param output_edge_gid_memory_context : memory context to output edge global id
+ * @param random_seed: random number generator seed
+ * @param p_env_fns : pointers to environment functions.
+ * @param stream : CUDA stream to use
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholegraph_csr_unweighted_sample_with_replacement(
+  wholememory_tensor_t wm_csr_row_ptr_tensor,
+  wholememory_tensor_t wm_csr_col_ptr_tensor,
+  wholememory_tensor_t center_nodes_tensor,
+  int max_sample_count,
+  wholememory_tensor_t center_fanout_tensor,
+  wholememory_tensor_t output_sample_offset_tensor,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  void* stream);
+
+/**
+ * Weighted sample with replacement kernel op
+ * Same as wholegraph_csr_unweighted_sample_with_replacement, except that neighbors are sampled
+ * with probability proportional to edge weight. Zero weight edges are not sampled, unless all
+ * edges of the center node have zero weight, then neighbors are sampled uniformly. Negative and
+ * NaN weights are treated as zero. Each center node builds an alias table in double precision,
+ * so probabilities follow the weights exactly up to double rounding, including tiny weights.
+ * @param wm_csr_row_ptr_tensor : Wholememory Tensor of graph csr_row_ptr
+ * @param wm_csr_col_ptr_tensor : Wholememory Tensor of graph csr_col_ptr
+ * @param wm_csr_weight_ptr_tensor : Wholememory Tensor of graph edge weight
+ * @param center_nodes_tensor : None Wholememory Tensor of center node to sample
+ * @param max_sample_count : sample count of center nodes if center_fanout_tensor is None
+ * @param center_fanout_tensor : None Wholememory int Tensor of sample count of each center node,
+ * same memory and size as center_nodes_tensor, nullptr or 0D tensor for None
+ * @param output_sample_offset_tensor : pointer to output sample offset
+ * @param output_dest_memory_context : memory context to output dest nodes
+ * @param output_center_localid_memory_context : memory context to output center local id
+ * @param output_edge_gid_memory_context : memory context to output edge global id
+ * @param random_seed: random number generator seed
+ * @param p_env_fns : pointers to environment functions.
+ * @param stream : CUDA stream to use
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholegraph_csr_weighted_sample_with_replacement(
+  wholememory_tensor_t wm_csr_row_ptr_tensor,
+  wholememory_tensor_t wm_csr_col_ptr_tensor,
+  wholememory_tensor_t wm_csr_weight_ptr_tensor,
+  wholememory_tensor_t center_nodes_tensor,
+  int max_sample_count,
+  wholememory_tensor_t center_fanout_tensor,
+  wholememory_tensor_t output_sample_offset_tensor,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  void* stream);
+
+/**
+ * Temporal sample kernel op
+ * Only neighbors whose edge timestamp is not later than query time of center node are valid,
+ * neighbors of each node should be sorted by edge timestamp in ascending order, so that valid ones
+ * are found by binary search. If valid neighbors are more than max_sample_count, they are sampled
+ * uniformly without replacement in WHOLEGRAPH_TSM_UNIFORM mode, or the latest max_sample_count ones
+ * are taken in time order in WHOLEGRAPH_TSM_LATEST mode.
+ * If graph is continuous host memory, and center nodes, center timestamps and output sample offset
+ * are host memory, sampling runs on CPU with the same result and outputs are allocated as host
+ * memory.
+ * @param wm_csr_row_ptr_tensor : Wholememory Tensor of graph csr_row_ptr
+ * @param wm_csr_col_ptr_tensor : Wholememory Tensor of graph csr_col_ptr
+ * @param wm_edge_timestamp_tensor : Wholememory Tensor of graph edge timestamp, int or int64
+ * @param center_nodes_tensor : None Wholememory Tensor of center node to sample
+ * @param center_timestamps_tensor : None Wholememory Tensor of query time of each center node,
+ * same memory and size as center_nodes_tensor, same dtype as wm_edge_timestamp_tensor
+ * @param max_sample_count : maximum sample count, <= 0 means sample all valid neighbors
+ * @param sample_mode : sample mode
+ * @param output_sample_offset_tensor : pointer to output sample offset
+ * @param output_dest_memory_context : memory context to output dest nodes
+ * @param output_center_localid_memory_context : memory context to output center local id
+ * @param output_edge_gid_memory_context : memory context to output edge global id
+ * @param random_seed: random number generator seed
+ * @param p_env_fns : pointers to environment functions.
+ * @param stream : CUDA stream to use
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholegraph_csr_temporal_sample(
+  wholememory_tensor_t wm_csr_row_ptr_tensor,
+  wholememory_tensor_t wm_csr_col_ptr_tensor,
+  wholememory_tensor_t wm_edge_timestamp_tensor,
+  wholememory_tensor_t center_nodes_tensor,
+  wholememory_tensor_t center_timestamps_tensor,
+  int max_sample_count,
+  wholegraph_temporal_sample_mode_t sample_mode,
+  wholememory_tensor_t output_sample_offset_tensor,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  void* stream);
+
+/**
+ * Random walk kernel op
+ * Generate walk_length steps of random walk from each start node. Each step moves to a neighbor
+ * picked uniformly, or proportional to edge weight if wm_csr_weight_ptr_tensor is given, and
+ * node2vec bias 1/p for going back, 1 for neighbors of previous node and 1/q for others is applied
+ * by rejection sampling. Each step after the first one restarts from start node with probability
+ * restart_probability. A walk reaching a node without neighbors ends there, and its remaining
+ * nodes are -1. Neighbor lists need not be sorted, so each rejection trial of a biased walk scans
+ * the neighbors of the previous node, costing O(degree of previous node).
+ * If graph is continuous host memory, and start nodes and outputs are host memory, walks run on CPU
+ * with the same result.
+ * @param wm_csr_row_ptr_tensor : Wholememory Tensor of graph csr_row_ptr
+ * @param wm_csr_col_ptr_tensor : Wholememory Tensor of graph csr_col_ptr
+ * @param wm_csr_weight_ptr_tensor : Wholememory Tensor of graph edge weight, nullptr for unweighted
+ * @param start_nodes_tensor : None Wholememory Tensor of start node of each walk
+ * @param walk_length : number of steps of each walk
+ * @param p : node2vec return parameter, should be positive, 1 for no bias
+ * @param q : node2vec in-out parameter, should be positive, 1 for no bias
+ * @param restart_probability : restart probability of each step, in [0, 1)
+ * @param output_walks_tensor : None Wholememory Tensor of output walks, matrix of start node count
+ * rows and walk_length + 1 columns, same dtype as wm_csr_col_ptr_tensor
+ * @param output_restart_count_tensor : None Wholememory Tensor of output restart count of each
+ * walk, int tensor, nullptr or 0D tensor if not needed
+ * @param random_seed: random number generator seed
+ * @param p_env_fns : pointers to environment functions.
+ * @param stream : CUDA stream to use
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholegraph_csr_random_walk(
+  wholememory_tensor_t wm_csr_row_ptr_tensor,
+  wholememory_tensor_t wm_csr_col_ptr_tensor,
+  wholememory_tensor_t wm_csr_weight_ptr_tensor,
+  wholememory_tensor_t start_nodes_tensor,
+  int walk_length,
+  float p,
+  float q,
+  float restart_probability,
+  wholememory_tensor_t output_walks_tensor,
+  wholememory_tensor_t output_restart_count_tensor,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  void* stream);
+
 /**
  * raft_pcg_generator_random_int cpu op
  * @param random_seed : random seed
@@ -19,6 +19,7 @@
 #include <unistd.h>
 
 #include <wholememory/global_reference.h>
+#include <wholememory/tensor_description.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -67,12 +68,13 @@ enum wholememory_memory_type_t {
 /**
  * @brief Memory Location of WholeMemory
  *
- * Memory Location of WholeMemory can be host or device.
+ * Memory Location of WholeMemory can be host, device or file.
  */
 enum wholememory_memory_location_t {
   WHOLEMEMORY_ML_NONE = 0, /*!< Not defined */
   WHOLEMEMORY_ML_DEVICE,   /*!< Device Memory */
   WHOLEMEMORY_ML_HOST,     /*!< Host Memory */
+  WHOLEMEMORY_ML_FILE,     /*!< Host Memory mapped from files, pages are loaded on access */
 };
 
 enum wholememory_distributed_backend_t {
@@ -80,9 +82,21 @@ enum wholememory_distributed_backend_t {
   WHOLEMEMORY_DB_NCCL,
   WHOLEMEMORY_DB_NVSHMEM,
 };
+/**
+ * @brief Flags of wholememory_init, can be combined by bitwise or.
+ *
+ * Huge page flags back shared host memory of CONTINUOUS and CHUNKED type with huge pages, which
+ * reduces TLB misses of random access and speeds up host memory registration. Allocation falls
+ * back to smaller pages if huge page pool is not enough, larger huge page is tried first.
+ */
+enum wholememory_init_flags_t {
+  WHOLEMEMORY_INIT_HUGE_PAGE_2MB = 0x1, /*!< Use 2MB huge pages for host memory if available */
+  WHOLEMEMORY_INIT_HUGE_PAGE_1GB = 0x2, /*!< Use 1GB huge pages for host memory if available */
+};
+
 /**
  * Initialize WholeMemory library
- * @param flags : reserved should be 0
+ * @param flags : bitwise or of wholememory_init_flags_t, 0 for default
  * @return : wholememory_error_code_t
  */
 wholememory_error_code_t wholememory_init(unsigned int flags);
@@ -111,6 +125,18 @@ struct wholememory_unique_id_t {
   char internal[WHOLEMEMORY_UNIQUE_ID_BYTES];
 };
 
+/**
+ * @brief Backend of WholeMemory Communicator
+ *
+ * NCCL backend supports both host and device collectives, HOST backend only supports host
+ * collectives over TCP sockets, and can be used in processes without GPU.
+ */
+enum wholememory_comm_backend_t {
+  WHOLEMEMORY_CB_NONE = 0, /*!< Not defined */
+  WHOLEMEMORY_CB_NCCL,     /*!< NCCL backend */
+  WHOLEMEMORY_CB_HOST,     /*!< Host only backend, no CUDA device needed */
+};
+
 /**
  * Create UniqueID for WholeMemory Communicator
  * @param unique_id : returned UniqueID
@@ -118,6 +144,18 @@ struct wholememory_unique_id_t {
  */
 wholememory_error_code_t wholememory_create_unique_id(wholememory_unique_id_t* unique_id);
 
+/**
+ * Create UniqueID for WholeMemory Communicator with specified backend.
+ * wholememory_create_communicator creates communicator of the backend of unique_id.
+ * For WHOLEMEMORY_CB_HOST, the process creating unique_id should have a rank in the communicator,
+ * it collects and publishes listen addresses of all ranks.
+ * @param unique_id : returned UniqueID
+ * @param comm_backend : backend of the communicator
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_create_unique_id_with_backend(
+  wholememory_unique_id_t* unique_id, wholememory_comm_backend_t comm_backend);
+
 /**
  * Create WholeMemory Communicator
  * @param comm : returned WholeMemory Communicator
@@ -173,6 +211,13 @@ wholememory_error_code_t wholememory_communicator_set_distributed_backend(
 
 wholememory_distributed_backend_t wholememory_communicator_get_distributed_backend(
   wholememory_comm_t comm);
+
+/**
+ * Get the backend of WholeMemory Communicator
+ * @param comm : WholeMemory Communicator
+ * @return : backend of the communicator
+ */
+wholememory_comm_backend_t wholememory_communicator_get_backend(wholememory_comm_t comm);
 /**
  * Barrier on WholeMemory Communicator
  * @param comm : WholeMemory Communicator
@@ -204,6 +249,108 @@ wholememory_error_code_t wholememory_malloc(wholememory_handle_t* wholememory_ha
                                             wholememory_memory_location_t memory_location,
                                             size_t data_granularity);
 
+/**
+ * @brief Flags of WholeMemory allocation
+ *
+ * Host memory is zero filled on allocation by the rank owning each partition, which also decides
+ * NUMA placement of the pages by first touch. Large allocations that are fully overwritten, e.g.
+ * loaded from files or filled by wholememory_fill_local_memory, may skip it.
+ */
+enum wholememory_malloc_flags_t {
+  WHOLEMEMORY_MF_NO_ZERO_INIT    = 0x1, /*!< Skip zero fill on allocation, content is undefined */
+  WHOLEMEMORY_MF_FILE_WRITE_BACK = 0x2, /*!< Map files writable, only for WHOLEMEMORY_ML_FILE */
+};
+
+/**
+ * Malloc WholeMemory with allocation flags, all ranks should use the same flags.
+ * @param wholememory_handle_ptr : returned WholeMemory Handle
+ * @param total_size : total allocated size in bytes.
+ * @param comm : WholeMemory Communicator
+ * @param memory_type : WholeMemory type
+ * @param memory_location : memory location, host or device
+ * @param data_granularity : granularity size of data, which is guaranteed not to be partitioned.
+ * @param flags : bitwise or of wholememory_malloc_flags_t, 0 is the same as wholememory_malloc
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_malloc_with_flags(
+  wholememory_handle_t* wholememory_handle_ptr,
+  size_t total_size,
+  wholememory_comm_t comm,
+  wholememory_memory_type_t memory_type,
+  wholememory_memory_location_t memory_location,
+  size_t data_granularity,
+  unsigned int flags);
+
+/**
+ * Malloc WholeMemory that can grow to max_total_size later by wholememory_grow, all ranks should
+ * be called together with the same arguments. Address space of max_total_size is reserved on
+ * creation, and memory is only allocated for total_size. Partition plan is determined by
+ * max_total_size, so partition plan, global pointer and global reference stay valid after growing,
+ * and data of each offset stays in the same rank. Before the WholeMemory grows near
+ * max_total_size, later ranks may have empty local partitions. As pages of WHOLEMEMORY_ML_DEVICE
+ * are allocated on the rank of the partition, max_total_size of device memory should not be
+ * larger than 2 times of total_size, so that no GPU holds more than twice the balanced size.
+ * Only WHOLEMEMORY_MT_CONTINUOUS type with WHOLEMEMORY_ML_HOST or WHOLEMEMORY_ML_DEVICE location
+ * within one node is supported now.
+ * @param wholememory_handle_ptr : returned WholeMemory Handle
+ * @param total_size : initial allocated size in bytes.
+ * @param max_total_size : max size in bytes the WholeMemory can grow to.
+ * @param comm : WholeMemory Communicator
+ * @param memory_type : WholeMemory type
+ * @param memory_location : memory location, host or device
+ * @param data_granularity : granularity size of data, which is guaranteed not to be partitioned.
+ * @param flags : bitwise or of wholememory_malloc_flags_t, also applies to grown memory.
+ * @return : wholememory_error_code_t, WHOLEMEMORY_NOT_SUPPORTED if type, location or communicator
+ * can't grow, or device memory grows more than 2 times.
+ */
+wholememory_error_code_t wholememory_malloc_growable(wholememory_handle_t* wholememory_handle_ptr,
+                                                     size_t total_size,
+                                                     size_t max_total_size,
+                                                     wholememory_comm_t comm,
+                                                     wholememory_memory_type_t memory_type,
+                                                     wholememory_memory_location_t memory_location,
+                                                     size_t data_granularity,
+                                                     unsigned int flags);
+
+/**
+ * Grow WholeMemory created by wholememory_malloc_growable, all ranks should be called together.
+ * Existing data is kept in place, new memory is initialized the same way as on creation. No other
+ * operation should access the WholeMemory during growing.
+ * @param wholememory_handle : WholeMemory Handle
+ * @param new_total_size : new total size in bytes, should be multiple of data_granularity and not
+ * larger than max_total_size, nothing is done if not larger than current total size.
+ * @return : wholememory_error_code_t, WHOLEMEMORY_OUT_OF_MEMORY if memory can't be allocated on any
+ * rank, and then WholeMemory is unchanged on all ranks.
+ */
+wholememory_error_code_t wholememory_grow(wholememory_handle_t wholememory_handle,
+                                          size_t new_total_size);
+
+/**
+ * Create WholeMemory of WHOLEMEMORY_ML_FILE location by mapping files, all rank should be called
+ * together. The files are logically concatenated as the content of the WholeMemory, nothing is
+ * read or initialized on creation, pages are loaded from files on first access.
+ * Files are mapped read only by default, and writing to the WholeMemory is not allowed. With
+ * WHOLEMEMORY_MF_FILE_WRITE_BACK, files are opened for writing and modifications are written back
+ * to the files.
+ * Only WHOLEMEMORY_MT_CONTINUOUS is supported now, and sizes of all files except the last one
+ * should be multiple of system page size.
+ * @param wholememory_handle_ptr : returned WholeMemory Handle
+ * @param comm : WholeMemory Communicator
+ * @param memory_type : WholeMemory type
+ * @param data_granularity : granularity size of data, which is guaranteed not to be partitioned.
+ * @param file_names : file names, all files will be logically concatenated and mapped.
+ * @param file_count : number of files.
+ * @param flags : 0 or WHOLEMEMORY_MF_FILE_WRITE_BACK, all ranks should use the same flags.
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_malloc_from_file(wholememory_handle_t* wholememory_handle_ptr,
+                                                      wholememory_comm_t comm,
+                                                      wholememory_memory_type_t memory_type,
+                                                      size_t data_granularity,
+                                                      const char** file_names,
+                                                      int file_count,
+                                                      unsigned int flags);
+
 /**
  * Free allocated WholeMemory Handle
  * @param wholememory_handle : WholeMemory Handle to free
@@ -245,6 +392,13 @@ wholememory_distributed_backend_t wholememory_get_distributed_backend(
  */
 size_t wholememory_get_total_size(wholememory_handle_t wholememory_handle);
 
+/**
+ * Get max size WholeMemory can grow to, the same as total size if it is not growable.
+ * @param wholememory_handle : WholeMemory Handle
+ * @return : max total size
+ */
+size_t wholememory_get_max_total_size(wholememory_handle_t wholememory_handle);
+
 /**
  * Get data granularity of WholeMemory Handle
  * @param wholememory_handle : WholeMemory Handle
@@ -301,6 +455,39 @@ wholememory_error_code_t wholememory_get_global_pointer(void** global_ptr,
 wholememory_error_code_t wholememory_get_global_reference(wholememory_gref_t* wholememory_gref,
                                                           wholememory_handle_t wholememory_handle);
 
+/**
+ * Get NUMA node of host memory pages of WholeMemory, can be used to verify NUMA placement set by
+ * WHOLEMEMORY_HOST_NUMA_POLICY environment variable (none, local or interleave).
+ * Memory without global pointer can only be queried in local memory of current rank.
+ * @param numa_nodes : returned NUMA node of page containing offset + i * stride for i in
+ * [0, count), negative errno if NUMA node of the page is not available
+ * @param offset : byte offset in WholeMemory of first queried page
+ * @param stride : byte stride between queried pages, e.g. page size to get page to node map
+ * @param count : number of queried pages
+ * @param wholememory_handle : WholeMemory Handle, should be host or file memory
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_get_host_numa_nodes(int* numa_nodes,
+                                                         size_t offset,
+                                                         size_t stride,
+                                                         size_t count,
+                                                         wholememory_handle_t wholememory_handle);
+
+/**
+ * Fill local memory of current rank with a repeated value. Host memory is filled by multiple
+ * threads, each thread fills whole pages so pages are first touched by one thread only. Device
+ * memory is filled by memset of value size. Call is synchronous, a barrier is needed before other
+ * ranks read the filled memory.
+ * @param value : pointer to the value, e.g. a float for float tensors
+ * @param value_size : size of value in bytes, should be 1, 2 or 4, local memory size and offset
+ * should be multiple of it
+ * @param wholememory_handle : WholeMemory Handle
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_fill_local_memory(const void* value,
+                                                       size_t value_size,
+                                                       wholememory_handle_t wholememory_handle);
+
 /**
  * Get the partition plan WholeMemory will use
  * @param size_per_rank : returned size per rank
@@ -343,6 +530,11 @@ int fork_get_device_count();
 
 /**
  * Load WholeMemory from binary files, all rank should be called together
+ * Files are read by WHOLEMEMORY_LOAD_THREAD_COUNT threads with pread if that environment variable
+ * is set to a value greater than 1, otherwise by a single thread. The count is capped at the number
+ * of processors, and applies to every file load of the process, including checkpoint loads.
+ * Host memory with memory_entry_size equal to file_entry_size is read into without bounce buffer,
+ * with O_DIRECT if WHOLEMEMORY_USE_DIRECT_IO is set to 1.
  * @param wholememory_handle : WholeMemory Handle
  * @param memory_offset : load to memory offset
  * @param memory_entry_size : entry size of WholeMemory
@@ -358,9 +550,42 @@ wholememory_error_code_t wholememory_load_from_file(wholememory_handle_t wholeme
                                                     const char** file_names,
                                                     int file_count);
 
+/**
+ * Load WholeMemory from binary files with dtype conversion and column projection, all rank should
+ * be called together. Each file entry has file_entry_size bytes of file_dtype elements, columns
+ * [file_column_start, file_column_start + column_count) are converted to memory_dtype on CPU while
+ * reading and stored at memory_offset of each memory entry. Conversion is supported between
+ * floating point types, or between integer types. Files are read by WHOLEMEMORY_LOAD_THREAD_COUNT
+ * threads, same as wholememory_load_from_file.
+ * @param wholememory_handle : WholeMemory Handle
+ * @param memory_offset : load to memory offset
+ * @param memory_entry_size : entry size of WholeMemory
+ * @param memory_dtype : data type of WholeMemory
+ * @param file_entry_size : entry size in file
+ * @param file_dtype : data type of files
+ * @param file_column_start : first column in file entry to load
+ * @param column_count : number of columns to load
+ * @param file_names : file names, all binary files will be logically concatenated and loaded.
+ * @param file_count : number of files.
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_load_from_file_with_conversion(
+  wholememory_handle_t wholememory_handle,
+  size_t memory_offset,
+  size_t memory_entry_size,
+  wholememory_dtype_t memory_dtype,
+  size_t file_entry_size,
+  wholememory_dtype_t file_dtype,
+  size_t file_column_start,
+  size_t column_count,
+  const char** file_names,
+  int file_count);
+
 /**
  * Store local WholeMemory to file, this should be called by all ranks, with different
  * local_file_name.
+ * Host memory with memory_entry_stride equal to file_entry_size is written without bounce buffer,
+ * with O_DIRECT if WHOLEMEMORY_USE_DIRECT_IO is set to 1.
  * @param wholememory_handle : WholeMemory Handle
  * @param memory_offset : memory offset to store
  * @param memory_entry_stride : entry size of WholeMemory
@@ -25,6 +25,10 @@ extern "C" {
 
 /**
  * Gather Op
+ * Runs on CPU if wholememory_tensor is in host memory and indices and output are host memory.
+ * For distributed memory, all ranks should pass indices and output of same location, and null
+ * pointers of empty batches count as host memory. Set WHOLEMEMORY_CHECK_HOST_GATHER_SCATTER to 1
+ * to check that with one host allreduce per call.
  * @param wholememory_tensor : WholeMemory Tensor of embedding table.
  * @param indices_tensor : indices to gather from, should NOT be WholeMemory Tensor
  * @param output_tensor : output tensor to gather to, should NOT be WholeMemoryTensor
@@ -40,6 +44,10 @@ wholememory_error_code_t wholememory_gather(wholememory_tensor_t wholememory_ten
 
 /**
  * Scatter Op
+ * Runs on CPU if wholememory_tensor is in host memory and input and indices are host memory.
+ * For distributed memory, all ranks should pass input and indices of same location, and null
+ * pointers of empty batches count as host memory. Set WHOLEMEMORY_CHECK_HOST_GATHER_SCATTER to 1
+ * to check that with one host allreduce per call.
  * @param input_tensor : input tensor tor scatter from, should NOT be WholeMemory Tensor
  * @param indices_tensor : indices to scatter to, should NOT be WholeMemory Tensor
  * @param wholememory_tensor : WholeMemory Tensor of embedding table.
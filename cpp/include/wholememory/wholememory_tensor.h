@@ -46,6 +46,26 @@ wholememory_error_code_t wholememory_create_tensor(
   wholememory_memory_type_t memory_type,
   wholememory_memory_location_t memory_location);
 
+/**
+ * Create WholeMemory Tensor with allocation flags, all ranks should use the same flags.
+ * @param wholememory_tensor : returned WholeMemory Tensor handle
+ * @param tensor_description : description of the WholeMemory Tensor, should be 1-D or 2-D
+ * continuous tensor without offset.
+ * @param comm : WholeMemory Communicator
+ * @param memory_type : Memory Type of the underlying WholeMemory
+ * @param memory_location : Memory Location of the underlying WholeMemory
+ * @param flags : bitwise or of wholememory_malloc_flags_t, 0 is the same as
+ * wholememory_create_tensor
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_create_tensor_with_flags(
+  wholememory_tensor_t* wholememory_tensor,
+  wholememory_tensor_description_t* tensor_description,
+  wholememory_comm_t comm,
+  wholememory_memory_type_t memory_type,
+  wholememory_memory_location_t memory_location,
+  unsigned int flags);
+
 /**
  * Destroy WholeMemory Tensor
  * @param wholememory_tensor : WholeMemory Tensor to destroy
@@ -159,6 +179,46 @@ wholememory_error_code_t wholememory_tensor_get_subtensor(
  */
 wholememory_tensor_t wholememory_tensor_get_root(wholememory_tensor_t wholememory_tensor);
 
+/**
+ * Store WholeMemory Tensor to checkpoint, all ranks should be called together.
+ * Each rank stores its local rows to file "%s_part_%d_of_%d" % (file_prefix, rank, world_size),
+ * and rank 0 writes meta file "%s_meta" % file_prefix, which contains version, dtype, sizes,
+ * entry size, and row range and CRC32 checksum of each part.
+ * Only support 1D and 2D tensor with WholeMemory Handle.
+ * @param wholememory_tensor : WholeMemory Tensor to store
+ * @param file_prefix : file prefix of checkpoint
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_tensor_store_to_checkpoint(
+  wholememory_tensor_t wholememory_tensor, const char* file_prefix);
+
+/**
+ * Load WholeMemory Tensor from checkpoint stored by wholememory_tensor_store_to_checkpoint, all
+ * ranks should be called together. The checkpoint can be stored with any world size, dtype and
+ * sizes should match wholememory_tensor. Each rank only reads the rows it owns.
+ * @param wholememory_tensor : WholeMemory Tensor to load to
+ * @param file_prefix : file prefix of checkpoint
+ * @param verify_checksum : if not 0, verify checksum of all parts before loading.
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_tensor_load_from_checkpoint(
+  wholememory_tensor_t wholememory_tensor, const char* file_prefix, int verify_checksum);
+
+/**
+ * Load CSR graph from compressed CSR file, all ranks should be called together.
+ * In compressed CSR file, rows are grouped into blocks, degrees and delta encoded neighbors of
+ * each block are stored as varints, and a block index allows each rank to read and decode only
+ * the blocks covering its own part of csr_row_ptr and csr_col_ind, using multiple threads.
+ * @param csr_row_ptr_tensor : 1D contiguous int64 WholeMemory Tensor with node_count + 1 entries
+ * @param csr_col_ind_tensor : 1D contiguous int or int64 WholeMemory Tensor with edge_count entries
+ * @param file_name : compressed CSR file name
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t wholememory_load_compressed_csr_from_file(
+  wholememory_tensor_t csr_row_ptr_tensor,
+  wholememory_tensor_t csr_col_ind_tensor,
+  const char* file_name);
+
 #define WM_TENSOR_COUNT_DEBUG
 int64_t get_wholememory_tensor_count();
 
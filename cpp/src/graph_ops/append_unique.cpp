@@ -18,6 +18,8 @@
 #include <graph_ops/append_unique_impl.h>
 #include <wholememory/graph_op.h>
 
+#include "wholememory/env_func_ptrs.hpp"
+
 wholememory_error_code_t graph_append_unique(
   wholememory_tensor_t target_nodes_tensor,
   wholememory_tensor_t neighbor_nodes_tensor,
@@ -26,6 +28,7 @@ wholememory_error_code_t graph_append_unique(
   wholememory_env_func_t* p_env_fns,
   void* stream)
 {
+  wholememory::temp_memory_stream_guard stream_guard(static_cast<cudaStream_t>(stream));
   auto target_nodes_tensor_description =
     *wholememory_tensor_get_tensor_description(target_nodes_tensor);
   if (target_nodes_tensor_description.dim != 1) {
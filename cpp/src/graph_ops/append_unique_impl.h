@@ -28,4 +28,18 @@ wholememory_error_code_t graph_append_unique_impl(
   int* output_neighbor_raw_to_unique_mapping_ptr,
   wholememory_env_func_t* p_env_fns,
   cudaStream_t stream);
+
+/**
+ * Host version of graph_append_unique_impl, all pointers are host memory and output unique nodes
+ * are allocated as host memory. Unique nodes are target nodes followed by new neighbor nodes in
+ * order of first appearance.
+ */
+wholememory_error_code_t graph_append_unique_host_impl(
+  void* target_nodes_ptr,
+  wholememory_array_description_t target_nodes_desc,
+  void* neighbor_nodes_ptr,
+  wholememory_array_description_t neighbor_nodes_desc,
+  void* output_unique_node_memory_context,
+  int* output_neighbor_raw_to_unique_mapping_ptr,
+  wholememory_env_func_t* p_env_fns);
 }
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <wholememory/env_func_ptrs.h>
+#include <wholememory/wholememory.h>
+
+#include "append_unique_impl.h"
+#include "error.hpp"
+#include "logger.hpp"
+#include "wholememory_ops/output_memory_handle.hpp"
+#include "wholememory_ops/register.hpp"
+
+namespace graph_ops {
+
+template <typename KeyT>
+void host_graph_append_unique_func(void* target_nodes_ptr,
+                                   wholememory_array_description_t target_nodes_desc,
+                                   void* neighbor_nodes_ptr,
+                                   wholememory_array_description_t neighbor_nodes_desc,
+                                   void* output_unique_node_memory_context,
+                                   int* output_neighbor_raw_to_unique_mapping_ptr,
+                                   wholememory_env_func_t* p_env_fns)
+{
+  auto* target_nodes   = static_cast<const KeyT*>(target_nodes_ptr);
+  auto* neighbor_nodes = static_cast<const KeyT*>(neighbor_nodes_ptr);
+  int target_count     = target_nodes_desc.size;
+  int neighbor_count   = neighbor_nodes_desc.size;
+
+  std::unordered_map<KeyT, int> unique_node_map;
+  unique_node_map.reserve(target_count + neighbor_count);
+  std::vector<KeyT> new_neighbor_nodes;
+  for (int i = 0; i < target_count; i++) {
+    unique_node_map.emplace(target_nodes[i], i);
+  }
+  for (int i = 0; i < neighbor_count; i++) {
+    int unique_id = target_count + static_cast<int>(new_neighbor_nodes.size());
+    auto it       = unique_node_map.emplace(neighbor_nodes[i], unique_id);
+    if (it.second) new_neighbor_nodes.push_back(neighbor_nodes[i]);
+    if (output_neighbor_raw_to_unique_mapping_ptr) {
+      output_neighbor_raw_to_unique_mapping_ptr[i] = it.first->second;
+    }
+  }
+
+  wholememory_ops::output_memory_handle gen_output_unique_node_buffer_mh(
+    p_env_fns, output_unique_node_memory_context);
+  auto* output_unique_node_ptr = (KeyT*)gen_output_unique_node_buffer_mh.host_malloc(
+    target_count + new_neighbor_nodes.size(), target_nodes_desc.dtype);
+  std::copy(target_nodes, target_nodes + target_count, output_unique_node_ptr);
+  std::copy(
+    new_neighbor_nodes.begin(), new_neighbor_nodes.end(), output_unique_node_ptr + target_count);
+}
+
+REGISTER_DISPATCH_ONE_TYPE(HostGraphAppendUnique, host_graph_append_unique_func, SINT3264)
+
+wholememory_error_code_t graph_append_unique_host_impl(
+  void* target_nodes_ptr,
+  wholememory_array_description_t target_nodes_desc,
+  void* neighbor_nodes_ptr,
+  wholememory_array_description_t neighbor_nodes_desc,
+  void* output_unique_node_memory_context,
+  int* output_neighbor_raw_to_unique_mapping_ptr,
+  wholememory_env_func_t* p_env_fns)
+{
+  try {
+    DISPATCH_ONE_TYPE(target_nodes_desc.dtype,
+                      HostGraphAppendUnique,
+                      target_nodes_ptr,
+                      target_nodes_desc,
+                      neighbor_nodes_ptr,
+                      neighbor_nodes_desc,
+                      output_unique_node_memory_context,
+                      output_neighbor_raw_to_unique_mapping_ptr,
+                      p_env_fns);
+  } catch (const wholememory::logic_error& le) {
+    WHOLEMEMORY_ERROR("LOGIC Error %s\n", le.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+}  // namespace graph_ops
@@ -19,11 +19,13 @@
 #include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <string>
 
 #include "cuda_macros.hpp"
@@ -62,6 +64,14 @@ int CreateServerListenFd(int port)
   return server_sock;
 }
 
+int GetSocketPort(int sock_fd)
+{
+  sockaddr_in addr;
+  socklen_t addr_len = sizeof(addr);
+  WHOLEMEMORY_CHECK_NOTHROW(getsockname(sock_fd, (sockaddr*)&addr, &addr_len) == 0);
+  return ntohs(addr.sin_port);
+}
+
 void ServerListen(int listen_fd, int backlog)
 {
   WHOLEMEMORY_CHECK_NOTHROW(listen(listen_fd, backlog) == 0);
@@ -87,6 +97,8 @@ int CreateClientFd(const std::string& server_name, int server_port)
   inet_pton(AF_INET, server_name.c_str(), &server_addr.sin_addr);
 #endif
 
+  // retry quickly first as server may be starting at the same time, then back off.
+  int retry_ms = 10;
   while (connect(client_sock, (sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
     switch (errno) {
       case ECONNREFUSED:
@@ -96,7 +108,8 @@ int CreateClientFd(const std::string& server_name, int server_port)
       case ENETUNREACH: printf("Network unreachable, retrying...\n"); break;
       default: printf("unknow error %d, retrying...\n", errno); break;
     }
-    usleep(500 * 1000);
+    usleep(retry_ms * 1000);
+    retry_ms = std::min(retry_ms * 2, 500);
   }
 
   return client_sock;
@@ -104,18 +117,83 @@ int CreateClientFd(const std::string& server_name, int server_port)
 
 void SingleSend(int sock_fd, const void* send_data, size_t send_size)
 {
-  ssize_t bytes_send = send(sock_fd, send_data, send_size, 0);
-  if (bytes_send < 0) {
-    printf("recv returned %ld, errno=%d %s\n", bytes_send, errno, strerror(errno));
+  const char* send_ptr = static_cast<const char*>(send_data);
+  size_t sent_size     = 0;
+  while (sent_size < send_size) {
+    ssize_t bytes_send = send(sock_fd, send_ptr + sent_size, send_size - sent_size, MSG_NOSIGNAL);
+    if (bytes_send < 0 && errno == EINTR) continue;
+    if (bytes_send <= 0) {
+      printf("send returned %ld, errno=%d %s\n", bytes_send, errno, strerror(errno));
+    }
+    WHOLEMEMORY_CHECK_NOTHROW(bytes_send > 0);
+    sent_size += bytes_send;
   }
-  WHOLEMEMORY_CHECK_NOTHROW(bytes_send == send_size);
 }
 
 void SingleRecv(int sock_fd, void* recv_data, size_t recv_size)
 {
-  ssize_t bytes_received = recv(sock_fd, recv_data, recv_size, 0);
-  if (bytes_received < 0) {
-    printf("recv returned %ld, errno=%d %s\n", bytes_received, errno, strerror(errno));
+  char* recv_ptr       = static_cast<char*>(recv_data);
+  size_t received_size = 0;
+  while (received_size < recv_size) {
+    ssize_t bytes_received = recv(sock_fd, recv_ptr + received_size, recv_size - received_size, 0);
+    if (bytes_received < 0 && errno == EINTR) continue;
+    if (bytes_received <= 0) {
+      printf("recv returned %ld, errno=%d %s\n", bytes_received, errno, strerror(errno));
+    }
+    WHOLEMEMORY_CHECK_NOTHROW(bytes_received > 0);
+    received_size += bytes_received;
+  }
+}
+
+void SingleSendRecv(int send_fd,
+                    const void* send_data,
+                    size_t send_size,
+                    int recv_fd,
+                    void* recv_data,
+                    size_t recv_size)
+{
+  const char* send_ptr = static_cast<const char*>(send_data);
+  char* recv_ptr       = static_cast<char*>(recv_data);
+  size_t sent_size     = 0;
+  size_t received_size = 0;
+  while (sent_size < send_size || received_size < recv_size) {
+    pollfd poll_fds[2];
+    int poll_count = 0;
+    int send_idx   = -1;
+    int recv_idx   = -1;
+    if (sent_size < send_size) {
+      send_idx           = poll_count++;
+      poll_fds[send_idx] = {send_fd, POLLOUT, 0};
+    }
+    if (received_size < recv_size) {
+      if (send_idx >= 0 && send_fd == recv_fd) {
+        recv_idx = send_idx;
+        poll_fds[recv_idx].events |= POLLIN;
+      } else {
+        recv_idx           = poll_count++;
+        poll_fds[recv_idx] = {recv_fd, POLLIN, 0};
+      }
+    }
+    int ret = poll(poll_fds, poll_count, -1);
+    if (ret < 0 && errno == EINTR) continue;
+    WHOLEMEMORY_CHECK_NOTHROW(ret > 0);
+    if (recv_idx >= 0 && (poll_fds[recv_idx].revents & (POLLIN | POLLERR | POLLHUP)) != 0) {
+      ssize_t bytes_received =
+        recv(recv_fd, recv_ptr + received_size, recv_size - received_size, MSG_DONTWAIT);
+      if (bytes_received == 0 || (bytes_received < 0 && errno != EAGAIN && errno != EINTR)) {
+        printf("recv returned %ld, errno=%d %s\n", bytes_received, errno, strerror(errno));
+        WHOLEMEMORY_CHECK_NOTHROW(bytes_received > 0);
+      }
+      if (bytes_received > 0) received_size += bytes_received;
+    }
+    if (send_idx >= 0 && (poll_fds[send_idx].revents & (POLLOUT | POLLERR | POLLHUP)) != 0) {
+      ssize_t bytes_send =
+        send(send_fd, send_ptr + sent_size, send_size - sent_size, MSG_DONTWAIT | MSG_NOSIGNAL);
+      if (bytes_send < 0 && errno != EAGAIN && errno != EINTR) {
+        printf("send returned %ld, errno=%d %s\n", bytes_send, errno, strerror(errno));
+        WHOLEMEMORY_CHECK_NOTHROW(bytes_send >= 0);
+      }
+      if (bytes_send > 0) sent_size += bytes_send;
+    }
   }
-  WHOLEMEMORY_CHECK_NOTHROW(bytes_received == recv_size);
 }
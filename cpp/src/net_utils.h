@@ -20,14 +20,28 @@
 
 #include <string>
 
+// port 0 binds to an ephemeral port, use GetSocketPort to get it.
 int CreateServerListenFd(int port);
 
+int GetSocketPort(int sock_fd);
+
 void ServerListen(int listen_fd, int backlog = 10);
 
 int ServerAccept(int listen_fd, sockaddr_in* client_addr, socklen_t* client_addr_len);
 
 int CreateClientFd(const std::string& server_name, int server_port);
 
+// sends all send_size bytes, retries on partial send.
 void SingleSend(int sock_fd, const void* send_data, size_t send_size);
 
+// receives all recv_size bytes, retries on partial receive.
 void SingleRecv(int sock_fd, void* recv_data, size_t recv_size);
+
+// sends to send_fd and receives from recv_fd concurrently, so two peers exchanging large data with
+// each other never block on full socket buffers. send_fd and recv_fd may be the same socket.
+void SingleSendRecv(int send_fd,
+                    const void* send_data,
+                    size_t send_size,
+                    int recv_fd,
+                    void* recv_data,
+                    size_t recv_size);
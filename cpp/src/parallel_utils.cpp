@@ -15,14 +15,21 @@
  */
 #include "parallel_utils.hpp"
 
+#include <arpa/inet.h>
 #include <cuda_runtime_api.h>
+#include <netinet/tcp.h>
 #include <string.h>
 #include <unistd.h>
 #include <wait.h>
 
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <thread>
 #include <vector>
@@ -43,6 +50,138 @@ void MultiThreadRun(int size, std::function<void(int, int)> f)
 
 int GetProcessorCount() { return static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN)); }
 
+namespace {
+
+class HostThreadPool {
+ public:
+  explicit HostThreadPool(int thread_count)
+  {
+    for (int i = 0; i < thread_count - 1; i++) {
+      workers_.emplace_back([this] { WorkerLoop(); });
+    }
+  }
+  ~HostThreadPool()
+  {
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+  void Run(int task_count, const std::function<void(int, int)>& f)
+  {
+    std::unique_lock<std::mutex> run_lock(run_mu_);
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      job_        = &f;
+      task_count_ = task_count;
+      next_task_.store(0);
+      generation_++;
+    }
+    if (task_count > 1) work_cv_.notify_all();
+    RunTasks(f, task_count);
+    std::unique_lock<std::mutex> lock(mu_);
+    done_cv_.wait(lock, [this] { return active_workers_ == 0; });
+    job_ = nullptr;
+    if (first_exception_) {
+      auto exception   = first_exception_;
+      first_exception_ = nullptr;
+      std::rethrow_exception(exception);
+    }
+  }
+
+ private:
+  void RunTasks(const std::function<void(int, int)>& f, int task_count)
+  {
+    for (int task_id = next_task_.fetch_add(1); task_id < task_count;
+         task_id     = next_task_.fetch_add(1)) {
+      try {
+        f(task_id, task_count);
+      } catch (...) {
+        std::unique_lock<std::mutex> lock(mu_);
+        if (!first_exception_) first_exception_ = std::current_exception();
+      }
+    }
+  }
+  void WorkerLoop()
+  {
+    uint64_t seen_generation = 0;
+    while (true) {
+      const std::function<void(int, int)>* job = nullptr;
+      int task_count                           = 0;
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        work_cv_.wait(lock, [&] { return stop_ || generation_ != seen_generation; });
+        if (stop_) return;
+        seen_generation = generation_;
+        // job_ is reset after the job finished, late wakeups have nothing to do.
+        if (job_ == nullptr) continue;
+        job        = job_;
+        task_count = task_count_;
+        active_workers_++;
+      }
+      RunTasks(*job, task_count);
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        if (--active_workers_ == 0) done_cv_.notify_all();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex run_mu_;
+  std::mutex mu_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  const std::function<void(int, int)>* job_ = nullptr;
+  int task_count_                           = 0;
+  std::atomic<int> next_task_{0};
+  uint64_t generation_ = 0;
+  int active_workers_  = 0;
+  bool stop_           = false;
+  std::exception_ptr first_exception_;
+};
+
+std::mutex thread_pool_mu;
+HostThreadPool* thread_pool = nullptr;
+pid_t thread_pool_pid       = -1;
+
+HostThreadPool* GetThreadPool()
+{
+  std::unique_lock<std::mutex> lock(thread_pool_mu);
+  // worker threads are not inherited by forked child, leave the parent's pool behind.
+  if (thread_pool == nullptr || thread_pool_pid != getpid()) {
+    thread_pool     = new HostThreadPool(GetThreadPoolSize());
+    thread_pool_pid = getpid();
+  }
+  return thread_pool;
+}
+
+}  // namespace
+
+int GetThreadPoolSize()
+{
+  static int thread_pool_size = [] {
+    const char* env_str = std::getenv("WHOLEMEMORY_HOST_THREAD_COUNT");
+    int count           = env_str != nullptr ? std::atoi(env_str) : 0;
+    return count > 0 ? count : std::max(GetProcessorCount(), 1);
+  }();
+  return thread_pool_size;
+}
+
+void ThreadPoolRun(int task_count, std::function<void(int, int)> f)
+{
+  if (task_count <= 0) return;
+  if (task_count == 1) {
+    f(0, 1);
+    return;
+  }
+  GetThreadPool()->Run(task_count, f);
+}
+
 void MultiProcessRun(int world_size, std::function<void(int, int)> f, bool inline_single_process)
 {
   if (world_size == 1 && inline_single_process) {
@@ -99,6 +238,13 @@ void MultiProcessRun(int world_size, std::function<void(int, int)> f, bool inlin
   running_count.fetch_sub(1);
 }
 
+/*
+ * SideBandCommunicator connects every pair of ranks directly. Rank 0 listens on the server port
+ * for bootstrap only, other ranks connect to it, report their peer listen port and get back the
+ * address table of all ranks. The bootstrap connection is kept as the connection between rank 0
+ * and that rank, then each rank connects to lower ranks and accepts from higher ranks.
+ * All ranks should use the same server address, rank 0 sees other ranks by that route.
+ */
 class SideBandCommunicator {
  public:
   SideBandCommunicator(int world_rank, int world_size, const char* server_addr, int port);
@@ -112,14 +258,19 @@ class SideBandCommunicator {
 
  private:
   static constexpr int kSideBandMagic = 0x51debacd;
-  void ServerAcceptFunc();
+  // broadcast is pipelined through the tree in chunks of this size.
+  static constexpr size_t kBroadcastChunkSize = 1024 * 1024;
+  struct RankAddress {
+    uint32_t ip_addr;  // network byte order
+    int32_t port;
+  };
+  void ServerAcceptFunc(std::vector<RankAddress>* rank_addresses);
+  void ConnectPeers(const std::vector<RankAddress>& rank_addresses, int peer_listen_fd);
   int world_rank_ = -1;
   int world_size_ = 0;
   std::string server_address_;
   int server_port_ = -1;
-  int client_fd_   = -1;
-  std::vector<int> server_fds_;
-  std::thread server_thread_;
+  std::vector<int> peer_fds_;
 };
 
 SideBandCommunicator::SideBandCommunicator(int world_rank,
@@ -137,69 +288,107 @@ SideBandCommunicator::~SideBandCommunicator() {}
 
 void SideBandCommunicator::Start()
 {
-  server_fds_.resize(world_size_, -1);
-  std::thread server_accept_thread;
+  peer_fds_.assign(world_size_, -1);
+  std::vector<RankAddress> rank_addresses(world_size_);
+  int peer_listen_fd = -1;
   if (world_rank_ == 0) {
-    server_accept_thread = std::thread([this]() { this->ServerAcceptFunc(); });
+    ServerAcceptFunc(&rank_addresses);
+    for (int r = 1; r < world_size_; r++) {
+      SingleSend(peer_fds_[r], rank_addresses.data(), sizeof(RankAddress) * world_size_);
+    }
+  } else {
+    // listen before reporting the port, peers may connect as soon as they get the address table.
+    peer_listen_fd = CreateServerListenFd(0);
+    ServerListen(peer_listen_fd, world_size_);
+    peer_fds_[0] = CreateClientFd(server_address_, server_port_);
+    int send_data[3];
+    send_data[0] = kSideBandMagic;
+    send_data[1] = world_rank_;
+    send_data[2] = GetSocketPort(peer_listen_fd);
+    SingleSend(peer_fds_[0], &send_data[0], sizeof(int) * 3);
+    SingleRecv(peer_fds_[0], rank_addresses.data(), sizeof(RankAddress) * world_size_);
+    ConnectPeers(rank_addresses, peer_listen_fd);
+    WHOLEMEMORY_CHECK_NOTHROW(close(peer_listen_fd) == 0);
   }
-  client_fd_ = CreateClientFd(server_address_, server_port_);
-  int send_data[2];
-  send_data[0] = kSideBandMagic;
-  send_data[1] = world_rank_;
-  SingleSend(client_fd_, &send_data[0], sizeof(int) * 2);
-  int magic_number = 0;
-  SingleRecv(client_fd_, &magic_number, sizeof(int));
-  WHOLEMEMORY_CHECK_NOTHROW(magic_number == kSideBandMagic);
-  if (world_rank_ == 0) { server_accept_thread.join(); }
-  WHOLEMEMORY_INFO("[Client] Rank=%d connected to server.", world_rank_);
+  for (int r = 0; r < world_size_; r++) {
+    if (r == world_rank_) continue;
+    int enable = 1;
+    WHOLEMEMORY_CHECK_NOTHROW(
+      setsockopt(peer_fds_[r], IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(int)) == 0);
+  }
+  Barrier();
+  WHOLEMEMORY_INFO("[Client] Rank=%d connected to all peers.", world_rank_);
 }
 
 void SideBandCommunicator::Stop()
 {
-  WHOLEMEMORY_CHECK_NOTHROW(close(client_fd_) == 0);
-  client_fd_ = -1;
-  if (world_rank_ == 0) {
-    for (int i = 0; i < world_size_; i++) {
-      WHOLEMEMORY_CHECK_NOTHROW(close(server_fds_[i]) == 0);
-      server_fds_[i] = -1;
-    }
-    server_fds_.clear();
+  for (int r = 0; r < static_cast<int>(peer_fds_.size()); r++) {
+    if (peer_fds_[r] < 0) continue;
+    WHOLEMEMORY_CHECK_NOTHROW(close(peer_fds_[r]) == 0);
+    peer_fds_[r] = -1;
   }
+  peer_fds_.clear();
 }
 
-void SideBandCommunicator::ServerAcceptFunc()
+void SideBandCommunicator::ServerAcceptFunc(std::vector<RankAddress>* rank_addresses)
 {
   int server_listen_fd = CreateServerListenFd(server_port_);
   // Listening
   ServerListen(server_listen_fd, world_size_);
 
   std::set<int> unconnected_rank_set;
-  for (int i = 0; i < world_size_; i++) {
+  for (int i = 1; i < world_size_; i++) {
     unconnected_rank_set.insert(i);
   }
   while (!unconnected_rank_set.empty()) {
     sockaddr_in client_addr;
     socklen_t client_addr_len = sizeof(client_addr);
-    int client_sock           = accept(server_listen_fd, (sockaddr*)&client_addr, &client_addr_len);
+    int client_sock           = ServerAccept(server_listen_fd, &client_addr, &client_addr_len);
     if (client_sock >= 0) {
-      int recv_data[2];
-      SingleRecv(client_sock, &recv_data[0], sizeof(int) * 2);
+      int recv_data[3];
+      SingleRecv(client_sock, &recv_data[0], sizeof(int) * 3);
       WHOLEMEMORY_CHECK_NOTHROW(recv_data[0] == kSideBandMagic);
       int rank_id = recv_data[1];
       WHOLEMEMORY_CHECK_NOTHROW(rank_id >= 0 && rank_id < world_size_);
       WHOLEMEMORY_CHECK_NOTHROW(unconnected_rank_set.count(rank_id) > 0);
-      server_fds_[rank_id] = client_sock;
+      peer_fds_[rank_id]                = client_sock;
+      rank_addresses->at(rank_id).ip_addr = client_addr.sin_addr.s_addr;
+      rank_addresses->at(rank_id).port    = recv_data[2];
       unconnected_rank_set.erase(rank_id);
       WHOLEMEMORY_INFO("[Server] Rank %d connected to SideBandCommunicator", rank_id);
     }
   }
   WHOLEMEMORY_CHECK_NOTHROW(close(server_listen_fd) == 0);
   WHOLEMEMORY_INFO("[Server] All ranks connected to SideBandCommunicator");
-  for (int i = 0; i < world_size_; i++) {
+}
+
+void SideBandCommunicator::ConnectPeers(const std::vector<RankAddress>& rank_addresses,
+                                        int peer_listen_fd)
+{
+  // rank 0 is already connected by bootstrap connection.
+  for (int r = 1; r < world_rank_; r++) {
+    char ip_str[INET_ADDRSTRLEN];
+    in_addr ip_addr;
+    ip_addr.s_addr = rank_addresses[r].ip_addr;
+    WHOLEMEMORY_CHECK_NOTHROW(inet_ntop(AF_INET, &ip_addr, ip_str, sizeof(ip_str)) != nullptr);
+    peer_fds_[r] = CreateClientFd(ip_str, rank_addresses[r].port);
     int send_data[2];
     send_data[0] = kSideBandMagic;
-    send_data[1] = i;
-    SingleSend(server_fds_[i], &send_data[0], sizeof(int));
+    send_data[1] = world_rank_;
+    SingleSend(peer_fds_[r], &send_data[0], sizeof(int) * 2);
+  }
+  for (int i = world_rank_ + 1; i < world_size_; i++) {
+    sockaddr_in client_addr;
+    socklen_t client_addr_len = sizeof(client_addr);
+    int peer_sock             = ServerAccept(peer_listen_fd, &client_addr, &client_addr_len);
+    WHOLEMEMORY_CHECK_NOTHROW(peer_sock >= 0);
+    int recv_data[2];
+    SingleRecv(peer_sock, &recv_data[0], sizeof(int) * 2);
+    WHOLEMEMORY_CHECK_NOTHROW(recv_data[0] == kSideBandMagic);
+    int rank_id = recv_data[1];
+    WHOLEMEMORY_CHECK_NOTHROW(rank_id > world_rank_ && rank_id < world_size_);
+    WHOLEMEMORY_CHECK_NOTHROW(peer_fds_[rank_id] == -1);
+    peer_fds_[rank_id] = peer_sock;
   }
 }
 
@@ -209,32 +398,23 @@ void SideBandCommunicator::GroupAllToAll(const void* input,
                                          int group_count)
 {
   WHOLEMEMORY_CHECK_NOTHROW(world_size_ % group_count == 0);
-  int group_size = world_size_ / group_count;
-  SingleSend(client_fd_, input, element_size * group_size);
-  if (world_rank_ == 0) {
-    std::vector<char> recv_buffer(element_size * group_size);
-    std::vector<std::vector<char>> send_buffer(group_size);
-    for (int i = 0; i < group_size; i++) {
-      send_buffer[i].resize(element_size * group_size);
-    }
-    for (int group_id = 0; group_id < group_count; group_id++) {
-      for (int src_rank = group_id * group_size; src_rank < (group_id + 1) * group_size;
-           src_rank++) {
-        SingleRecv(server_fds_[src_rank], recv_buffer.data(), recv_buffer.size());
-        for (int gr = 0; gr < group_size; gr++) {
-          int src_gr = src_rank - group_id * group_size;
-          memcpy(send_buffer[gr].data() + src_gr * element_size,
-                 recv_buffer.data() + gr * element_size,
-                 element_size);
-        }
-        for (int dst_gr = 0; dst_gr < group_size; dst_gr++) {
-          int r = dst_gr + group_id * group_size;
-          SingleSend(server_fds_[r], send_buffer[dst_gr].data(), send_buffer[dst_gr].size());
-        }
-      }
-    }
+  int group_size      = world_size_ / group_count;
+  int group_rank      = world_rank_ % group_size;
+  int group_start     = world_rank_ - group_rank;
+  const char* send_ptr = static_cast<const char*>(input);
+  char* recv_ptr       = static_cast<char*>(output);
+  memmove(recv_ptr + group_rank * element_size, send_ptr + group_rank * element_size, element_size);
+  // pairwise exchange, in step s send to group_rank + s and receive from group_rank - s.
+  for (int step = 1; step < group_size; step++) {
+    int dst_gr = (group_rank + step) % group_size;
+    int src_gr = (group_rank - step + group_size) % group_size;
+    SingleSendRecv(peer_fds_[group_start + dst_gr],
+                   send_ptr + dst_gr * element_size,
+                   element_size,
+                   peer_fds_[group_start + src_gr],
+                   recv_ptr + src_gr * element_size,
+                   element_size);
   }
-  SingleRecv(client_fd_, output, element_size * group_size);
 }
 
 void SideBandCommunicator::GroupAllGather(const void* input,
@@ -243,30 +423,24 @@ void SideBandCommunicator::GroupAllGather(const void* input,
                                           int group_count)
 {
   WHOLEMEMORY_CHECK_NOTHROW(world_size_ % group_count == 0);
-  int group_size = world_size_ / group_count;
-  SingleSend(client_fd_, input, element_size);
-  if (world_rank_ == 0) {
-    std::vector<char> recv_buffer(element_size);
-    std::vector<std::vector<char>> send_buffer(group_size);
-    for (int i = 0; i < group_size; i++) {
-      send_buffer[i].resize(element_size * group_size);
-    }
-    for (int group_id = 0; group_id < group_count; group_id++) {
-      for (int src_rank = group_id * group_size; src_rank < (group_id + 1) * group_size;
-           src_rank++) {
-        SingleRecv(server_fds_[src_rank], recv_buffer.data(), recv_buffer.size());
-        for (int gr = 0; gr < group_size; gr++) {
-          int src_gr = src_rank - group_id * group_size;
-          memcpy(send_buffer[gr].data() + src_gr * element_size, recv_buffer.data(), element_size);
-        }
-        for (int dst_gr = 0; dst_gr < group_size; dst_gr++) {
-          int r = dst_gr + group_id * group_size;
-          SingleSend(server_fds_[r], send_buffer[dst_gr].data(), send_buffer[dst_gr].size());
-        }
-      }
-    }
+  int group_size  = world_size_ / group_count;
+  int group_rank  = world_rank_ % group_size;
+  int group_start = world_rank_ - group_rank;
+  char* recv_ptr  = static_cast<char*>(output);
+  memmove(recv_ptr + group_rank * element_size, input, element_size);
+  // ring, in step s forward block group_rank - s to the right and receive block from the left.
+  int right_rank = group_start + (group_rank + 1) % group_size;
+  int left_rank  = group_start + (group_rank - 1 + group_size) % group_size;
+  for (int step = 0; step < group_size - 1; step++) {
+    int send_gr = (group_rank - step + group_size) % group_size;
+    int recv_gr = (group_rank - step - 1 + group_size) % group_size;
+    SingleSendRecv(peer_fds_[right_rank],
+                   recv_ptr + send_gr * element_size,
+                   element_size,
+                   peer_fds_[left_rank],
+                   recv_ptr + recv_gr * element_size,
+                   element_size);
   }
-  SingleRecv(client_fd_, output, element_size * group_size);
 }
 
 void SideBandCommunicator::GroupBroadcast(void* data,
@@ -275,27 +449,44 @@ void SideBandCommunicator::GroupBroadcast(void* data,
                                           int group_count)
 {
   WHOLEMEMORY_CHECK_NOTHROW(world_size_ % group_count == 0);
-  int group_size = world_size_ / group_count;
-  int group_rank = world_rank_ % group_size;
-  if (group_rank == root_group_rank) { SingleSend(client_fd_, data, element_size); }
-  if (world_rank_ == 0) {
-    std::vector<char> recv_buffer(element_size);
-    for (int group_id = 0; group_id < group_count; group_id++) {
-      int src_rank = group_id * group_size + root_group_rank;
-      SingleRecv(server_fds_[src_rank], recv_buffer.data(), recv_buffer.size());
-      for (int r = group_id * group_size; r < (group_id + 1) * group_size; r++) {
-        SingleSend(server_fds_[r], recv_buffer.data(), recv_buffer.size());
-      }
+  int group_size  = world_size_ / group_count;
+  int group_rank  = world_rank_ % group_size;
+  int group_start = world_rank_ - group_rank;
+  // binomial tree on rank relative to root, parent of a rank clears its lowest set bit.
+  int relative_rank = (group_rank - root_group_rank + group_size) % group_size;
+  int parent_rank   = -1;
+  int mask          = 1;
+  for (; mask < group_size; mask <<= 1) {
+    if ((relative_rank & mask) != 0) {
+      parent_rank = group_start + (relative_rank - mask + root_group_rank) % group_size;
+      break;
+    }
+  }
+  std::vector<int> child_ranks;
+  for (mask >>= 1; mask > 0; mask >>= 1) {
+    if (relative_rank + mask >= group_size) continue;
+    child_ranks.push_back(group_start + (relative_rank + mask + root_group_rank) % group_size);
+  }
+  char* data_ptr = static_cast<char*>(data);
+  for (size_t offset = 0; offset < element_size; offset += kBroadcastChunkSize) {
+    size_t chunk_size = std::min(element_size - offset, kBroadcastChunkSize);
+    if (parent_rank >= 0) { SingleRecv(peer_fds_[parent_rank], data_ptr + offset, chunk_size); }
+    for (int child_rank : child_ranks) {
+      SingleSend(peer_fds_[child_rank], data_ptr + offset, chunk_size);
     }
   }
-  SingleRecv(client_fd_, data, element_size);
 }
 
 void SideBandCommunicator::Barrier()
 {
-  int data = 0;
-  std::vector<int> recv_data(world_size_);
-  GroupAllGather(&data, recv_data.data(), sizeof(int), 1);
+  // dissemination barrier, finishes in log2(world_size) rounds.
+  char send_token = 0;
+  char recv_token = 0;
+  for (int distance = 1; distance < world_size_; distance <<= 1) {
+    int dst_rank = (world_rank_ + distance) % world_size_;
+    int src_rank = (world_rank_ - distance + world_size_) % world_size_;
+    SingleSendRecv(peer_fds_[dst_rank], &send_token, 1, peer_fds_[src_rank], &recv_token, 1);
+  }
 }
 
 SideBandCommunicator* StartSidebandCommunicator(int world_rank,
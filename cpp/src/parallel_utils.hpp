@@ -35,6 +35,22 @@ void MultiThreadRun(int size, std::function<void(int, int)> f);
  */
 int GetProcessorCount();
 
+/**
+ * Run f(task_id, task_count) for task_count tasks on a process wide persistent thread pool.
+ * The calling thread also runs tasks, returns after all tasks are done.
+ * Calls from different threads are serialized, f should not call ThreadPoolRun recursively.
+ * @param task_count : task count
+ * @param f : task function
+ */
+void ThreadPoolRun(int task_count, std::function<void(int, int)> f);
+
+/**
+ * Get thread count of the thread pool used by ThreadPoolRun, including calling thread.
+ * Defaults to processor count, may be set by WHOLEMEMORY_HOST_THREAD_COUNT environment variable.
+ * @return : thread count
+ */
+int GetThreadPoolSize();
+
 /**
  * Run f with size processes
  * @note when using gtest with MultiProcessRun, testing::Test::HasFailure()
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <wholememory/wholegraph_op.h>
+
+#include <wholegraph_ops/random_walk_impl.h>
+#include <wholegraph_ops/sample_comm_host.h>
+#include <wholememory_ops/functions/host_gather_scatter_func.h>
+
+#include "error.hpp"
+#include "logger.hpp"
+#include "wholememory/env_func_ptrs.hpp"
+
+namespace {
+
+// output_restart_count_tensor is optional, nullptr or 0D tensor means None. When present, it should
+// be 1D int tensor with one count for each start node, in the same memory as start_nodes_tensor.
+wholememory_error_code_t get_output_restart_count(wholememory_tensor_t output_restart_count_tensor,
+                                                  wholememory_array_description_t start_nodes_desc,
+                                                  int** output_restart_count)
+{
+  *output_restart_count = nullptr;
+  if (output_restart_count_tensor == nullptr) return WHOLEMEMORY_SUCCESS;
+  wholememory_tensor_description_t restart_count_tensor_desc =
+    *wholememory_tensor_get_tensor_description(output_restart_count_tensor);
+  if (restart_count_tensor_desc.dim == 0) return WHOLEMEMORY_SUCCESS;
+  if (restart_count_tensor_desc.dim != 1) {
+    WHOLEMEMORY_ERROR("Output output_restart_count_tensor should be 1D tensor or None.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t restart_count_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&restart_count_desc, &restart_count_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Output output_restart_count_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  if (restart_count_desc.dtype != WHOLEMEMORY_DT_INT) {
+    WHOLEMEMORY_ERROR("Output output_restart_count_tensor should be int tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (restart_count_desc.size != start_nodes_desc.size) {
+    WHOLEMEMORY_ERROR(
+      "Output output_restart_count_tensor should have same size as start_nodes_tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  *output_restart_count =
+    static_cast<int*>(wholememory_tensor_get_data_pointer(output_restart_count_tensor));
+  return WHOLEMEMORY_SUCCESS;
+}
+
+}  // namespace
+
+wholememory_error_code_t wholegraph_csr_random_walk(
+  wholememory_tensor_t wm_csr_row_ptr_tensor,
+  wholememory_tensor_t wm_csr_col_ptr_tensor,
+  wholememory_tensor_t wm_csr_weight_ptr_tensor,
+  wholememory_tensor_t start_nodes_tensor,
+  int walk_length,
+  float p,
+  float q,
+  float restart_probability,
+  wholememory_tensor_t output_walks_tensor,
+  wholememory_tensor_t output_restart_count_tensor,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  void* stream)
+{
+  wholememory::temp_memory_stream_guard stream_guard(static_cast<cudaStream_t>(stream));
+  bool const weighted = wm_csr_weight_ptr_tensor != nullptr;
+
+  bool const csr_row_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_row_ptr_tensor);
+  wholememory_memory_type_t csr_row_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_row_ptr_has_handle) {
+    csr_row_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_row_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_row_ptr_has_handle ||
+                                csr_row_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_row_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+  bool const csr_col_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_col_ptr_tensor);
+  wholememory_memory_type_t csr_col_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_col_ptr_has_handle) {
+    csr_col_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_col_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_col_ptr_has_handle ||
+                                csr_col_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_col_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+  bool const csr_weight_ptr_has_handle =
+    weighted && wholememory_tensor_has_handle(wm_csr_weight_ptr_tensor);
+  wholememory_memory_type_t csr_weight_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_weight_ptr_has_handle) {
+    csr_weight_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_weight_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_weight_ptr_has_handle ||
+                                csr_weight_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_weight_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+
+  auto csr_row_ptr_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_csr_row_ptr_tensor);
+  auto csr_col_ptr_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_csr_col_ptr_tensor);
+  if (csr_row_ptr_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_csr_row_ptr_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (csr_col_ptr_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_csr_col_ptr_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t wm_csr_row_ptr_desc, wm_csr_col_ptr_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&wm_csr_row_ptr_desc,
+                                                &csr_row_ptr_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_csr_row_ptr_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  if (!wholememory_convert_tensor_desc_to_array(&wm_csr_col_ptr_desc,
+                                                &csr_col_ptr_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_csr_col_ptr_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  wholememory_array_description_t wm_csr_weight_ptr_desc =
+    wholememory_create_array_desc(0, 0, WHOLEMEMORY_DT_FLOAT);
+  if (weighted) {
+    auto csr_weight_ptr_tensor_description =
+      *wholememory_tensor_get_tensor_description(wm_csr_weight_ptr_tensor);
+    if (csr_weight_ptr_tensor_description.dim != 1) {
+      WHOLEMEMORY_ERROR("wm_csr_weight_ptr_tensor should be 1D tensor.");
+      return WHOLEMEMORY_INVALID_INPUT;
+    }
+    if (!wholememory_convert_tensor_desc_to_array(&wm_csr_weight_ptr_desc,
+                                                  &csr_weight_ptr_tensor_description)) {
+      WHOLEMEMORY_ERROR("Input wm_csr_weight_ptr_tensor convert to array failed.");
+      return WHOLEMEMORY_LOGIC_ERROR;
+    }
+    if (wm_csr_weight_ptr_desc.dtype != WHOLEMEMORY_DT_FLOAT &&
+        wm_csr_weight_ptr_desc.dtype != WHOLEMEMORY_DT_DOUBLE) {
+      WHOLEMEMORY_ERROR("wm_csr_weight_ptr_tensor should be float or double tensor.");
+      return WHOLEMEMORY_INVALID_INPUT;
+    }
+  }
+
+  wholememory_tensor_description_t start_nodes_tensor_desc =
+    *wholememory_tensor_get_tensor_description(start_nodes_tensor);
+  if (start_nodes_tensor_desc.dim != 1) {
+    WHOLEMEMORY_ERROR("Input start_nodes_tensor should be 1D tensor");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t start_nodes_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&start_nodes_desc, &start_nodes_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Input start_nodes_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+
+  if (walk_length < 0) {
+    WHOLEMEMORY_ERROR("walk_length should not be negative, but got %d.", walk_length);
+    return WHOLEMEMORY_INVALID_VALUE;
+  }
+  if (!(p > 0) || !(q > 0)) {
+    WHOLEMEMORY_ERROR("p and q should be positive, but got p=%f, q=%f.", p, q);
+    return WHOLEMEMORY_INVALID_VALUE;
+  }
+  if (!(restart_probability >= 0 && restart_probability < 1)) {
+    WHOLEMEMORY_ERROR("restart_probability should be in [0, 1), but got %f.", restart_probability);
+    return WHOLEMEMORY_INVALID_VALUE;
+  }
+
+  wholememory_tensor_description_t output_walks_tensor_desc =
+    *wholememory_tensor_get_tensor_description(output_walks_tensor);
+  if (output_walks_tensor_desc.dim != 2) {
+    WHOLEMEMORY_ERROR("Output output_walks_tensor should be 2D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_matrix_description_t output_walks_desc;
+  if (!wholememory_convert_tensor_desc_to_matrix(&output_walks_desc, &output_walks_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Output output_walks_tensor convert to matrix failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  if (output_walks_desc.sizes[0] != start_nodes_desc.size ||
+      output_walks_desc.sizes[1] != walk_length + 1) {
+    WHOLEMEMORY_ERROR("Output output_walks_tensor should be %ld x %d matrix, but got %ld x %ld.",
+                      start_nodes_desc.size,
+                      walk_length + 1,
+                      output_walks_desc.sizes[0],
+                      output_walks_desc.sizes[1]);
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (output_walks_desc.dtype != wm_csr_col_ptr_desc.dtype) {
+    WHOLEMEMORY_ERROR("output_walks_tensor should have same dtype as wm_csr_col_ptr_tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+
+  int* output_restart_count = nullptr;
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    get_output_restart_count(output_restart_count_tensor, start_nodes_desc, &output_restart_count));
+
+  void* start_nodes  = wholememory_tensor_get_data_pointer(start_nodes_tensor);
+  void* output_walks = wholememory_tensor_get_data_pointer(output_walks_tensor);
+  wholememory_gref_t wm_csr_row_ptr_gref, wm_csr_col_ptr_gref;
+  wholememory_gref_t wm_csr_weight_ptr_gref{nullptr, 0};
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_csr_row_ptr_tensor, &wm_csr_row_ptr_gref));
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_csr_col_ptr_tensor, &wm_csr_col_ptr_gref));
+  if (weighted) {
+    WHOLEMEMORY_RETURN_ON_FAIL(
+      wholememory_tensor_get_global_reference(wm_csr_weight_ptr_tensor, &wm_csr_weight_ptr_gref));
+  }
+
+  if (wholegraph_ops::should_use_host_sample(wm_csr_row_ptr_tensor,
+                                             wm_csr_col_ptr_tensor,
+                                             wm_csr_weight_ptr_tensor,
+                                             start_nodes,
+                                             output_walks) &&
+      (output_restart_count == nullptr ||
+       wholememory_ops::is_host_memory_pointer(output_restart_count))) {
+    return wholegraph_ops::wholegraph_csr_random_walk_host(wm_csr_row_ptr_gref,
+                                                           wm_csr_row_ptr_desc,
+                                                           wm_csr_col_ptr_gref,
+                                                           wm_csr_col_ptr_desc,
+                                                           weighted,
+                                                           wm_csr_weight_ptr_gref,
+                                                           wm_csr_weight_ptr_desc,
+                                                           start_nodes,
+                                                           start_nodes_desc,
+                                                           walk_length,
+                                                           p,
+                                                           q,
+                                                           restart_probability,
+                                                           output_walks,
+                                                           output_walks_desc,
+                                                           output_restart_count,
+                                                           random_seed);
+  }
+  return wholegraph_ops::wholegraph_csr_random_walk_mapped(wm_csr_row_ptr_gref,
+                                                           wm_csr_row_ptr_desc,
+                                                           wm_csr_col_ptr_gref,
+                                                           wm_csr_col_ptr_desc,
+                                                           weighted,
+                                                           wm_csr_weight_ptr_gref,
+                                                           wm_csr_weight_ptr_desc,
+                                                           start_nodes,
+                                                           start_nodes_desc,
+                                                           walk_length,
+                                                           p,
+                                                           q,
+                                                           restart_probability,
+                                                           output_walks,
+                                                           output_walks_desc,
+                                                           output_restart_count,
+                                                           random_seed,
+                                                           p_env_fns,
+                                                           static_cast<cudaStream_t>(stream));
+}
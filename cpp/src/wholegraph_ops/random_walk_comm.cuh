@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include <raft/random/rng_device.cuh>
+
+#include "sample_with_replacement_comm.cuh"
+
+namespace wholegraph_ops {
+
+// Each walk is done by one thread, walk i draws random numbers from subsequence i.
+// Device kernels and host walks share functions below, so they give the same result.
+constexpr int kRandomWalkBlockDim = 128;
+
+/**
+ * Check if node is a neighbor of center node by scanning its neighbors, O(degree of center node).
+ * CSR neighbor lists are not required to be sorted, so binary search can't be used.
+ * @param csr_row_ptr : CSR row ptr, indexed by node id
+ * @param csr_col_ptr : CSR col ptr, indexed by edge id
+ * @param center_node : center node id
+ * @param node : node id to check
+ * @return : true if node is a neighbor of center_node
+ */
+template <typename RowAccessor, typename ColAccessor>
+__host__ __device__ bool random_walk_is_neighbor(RowAccessor& csr_row_ptr,
+                                                 ColAccessor& csr_col_ptr,
+                                                 int64_t center_node,
+                                                 int64_t node)
+{
+  int64_t end = csr_row_ptr[center_node + 1];
+  for (int64_t edge_id = csr_row_ptr[center_node]; edge_id < end; edge_id++) {
+    if (static_cast<int64_t>(csr_col_ptr[edge_id]) == node) return true;
+  }
+  return false;
+}
+
+/**
+ * Pick one neighbor with probability proportional to its weight, negative weights are taken as 0.
+ * @param rng : random generator of the walk
+ * @param csr_weight_ptr : CSR weight, indexed by edge id
+ * @param edge_start : first edge id of center node
+ * @param neighbor_count : neighbor count of center node, should be positive
+ * @param weight_sum : sum of positive weights of center node
+ * @return : index of the picked neighbor
+ */
+template <typename ProbType, typename WeightAccessor>
+__host__ __device__ int random_walk_pick_weighted(raft::random::detail::PCGenerator& rng,
+                                                  WeightAccessor& csr_weight_ptr,
+                                                  int64_t edge_start,
+                                                  int neighbor_count,
+                                                  ProbType weight_sum)
+{
+  // all zero weights, pick uniformly.
+  if (!(weight_sum > 0)) return with_replacement_next_int(rng) % neighbor_count;
+  ProbType target = with_replacement_next_uniform<ProbType>(rng) * weight_sum;
+  ProbType acc    = 0;
+  int picked      = 0;
+  for (int i = 0; i < neighbor_count; i++) {
+    ProbType weight = static_cast<ProbType>(csr_weight_ptr[edge_start + i]);
+    if (!(weight > 0)) continue;
+    acc += weight;
+    picked = i;
+    if (target < acc) break;
+  }
+  return picked;
+}
+
+/**
+ * Generate one walk. Each step first restarts from start node with probability restart_prob,
+ * unless the walk has just started or restarted. Otherwise it moves to a neighbor picked uniformly
+ * or by edge weight, and node2vec p/q bias on the picked neighbor is applied by rejection sampling.
+ * A walk reaching a node without neighbors ends there, its remaining nodes are set to -1.
+ * @param csr_row_ptr : CSR row ptr, indexed by node id
+ * @param csr_col_ptr : CSR col ptr, indexed by edge id
+ * @param csr_weight_ptr : CSR weight, indexed by edge id, not used if weighted is false
+ * @param weighted : if neighbors are picked by edge weight
+ * @param start_node : start node of the walk
+ * @param walk_length : number of steps of the walk
+ * @param p : node2vec return parameter
+ * @param q : node2vec in-out parameter
+ * @param restart_prob : restart probability of each step
+ * @param rng : random generator of the walk
+ * @param walk : output, walk_length + 1 nodes of the walk, starting with start_node
+ * @return : restart count of the walk
+ */
+template <typename WMIdType,
+          typename ProbType,
+          typename RowAccessor,
+          typename ColAccessor,
+          typename WeightAccessor>
+__host__ __device__ int random_walk_one(RowAccessor& csr_row_ptr,
+                                        ColAccessor& csr_col_ptr,
+                                        WeightAccessor& csr_weight_ptr,
+                                        bool weighted,
+                                        int64_t start_node,
+                                        int walk_length,
+                                        ProbType p,
+                                        ProbType q,
+                                        ProbType restart_prob,
+                                        raft::random::detail::PCGenerator& rng,
+                                        WMIdType* walk)
+{
+  bool const biased     = p != static_cast<ProbType>(1) || q != static_cast<ProbType>(1);
+  ProbType const inv_p  = static_cast<ProbType>(1) / p;
+  ProbType const inv_q  = static_cast<ProbType>(1) / q;
+  ProbType max_bias     = inv_p > inv_q ? inv_p : inv_q;
+  max_bias              = max_bias > static_cast<ProbType>(1) ? max_bias : static_cast<ProbType>(1);
+  int restart_count     = 0;
+  int64_t previous_node = -1;
+  int64_t current_node  = start_node;
+  walk[0]               = static_cast<WMIdType>(start_node);
+  for (int step = 1; step <= walk_length; step++) {
+    if (restart_prob > 0 && previous_node >= 0 &&
+        with_replacement_next_uniform<ProbType>(rng) < restart_prob) {
+      restart_count++;
+      previous_node = -1;
+      current_node  = start_node;
+      walk[step]    = static_cast<WMIdType>(start_node);
+      continue;
+    }
+    int64_t edge_start = csr_row_ptr[current_node];
+    int neighbor_count = static_cast<int>(csr_row_ptr[current_node + 1] - edge_start);
+    if (neighbor_count == 0) {
+      for (; step <= walk_length; step++) {
+        walk[step] = static_cast<WMIdType>(-1);
+      }
+      break;
+    }
+    ProbType weight_sum = 0;
+    if (weighted) {
+      for (int i = 0; i < neighbor_count; i++) {
+        ProbType weight = static_cast<ProbType>(csr_weight_ptr[edge_start + i]);
+        if (weight > 0) weight_sum += weight;
+      }
+    }
+    int64_t next_node;
+    while (true) {
+      int neighbor_idx =
+        weighted
+          ? random_walk_pick_weighted(rng, csr_weight_ptr, edge_start, neighbor_count, weight_sum)
+          : with_replacement_next_int(rng) % neighbor_count;
+      next_node = static_cast<int64_t>(csr_col_ptr[edge_start + neighbor_idx]);
+      // no bias on the first step from start node.
+      if (!biased || previous_node < 0) break;
+      ProbType bias = static_cast<ProbType>(1);
+      if (next_node == previous_node) {
+        bias = inv_p;
+      } else if (!random_walk_is_neighbor(csr_row_ptr, csr_col_ptr, previous_node, next_node)) {
+        bias = inv_q;
+      }
+      if (with_replacement_next_uniform<ProbType>(rng) * max_bias < bias) break;
+    }
+    previous_node = current_node;
+    current_node  = next_node;
+    walk[step]    = static_cast<WMIdType>(next_node);
+  }
+  return restart_count;
+}
+
+}  // namespace wholegraph_ops
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <raft/random/rng_device.cuh>
+#include <raft/random/rng_state.hpp>
+#include <raft/util/integer_utils.hpp>
+#include <wholememory/device_reference.cuh>
+#include <wholememory/env_func_ptrs.h>
+#include <wholememory/global_reference.h>
+#include <wholememory/tensor_description.h>
+
+#include "cuda_macros.hpp"
+#include "error.hpp"
+#include "random_walk_comm.cuh"
+
+namespace wholegraph_ops {
+
+template <typename IdType, typename WMIdType, typename WMWeightType>
+__launch_bounds__(kRandomWalkBlockDim) __global__ void random_walk_kernel(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_gref_t wm_csr_col_ptr,
+  bool weighted,
+  wholememory_gref_t wm_csr_weight_ptr,
+  const IdType* start_nodes,
+  const int start_node_count,
+  const int walk_length,
+  WMWeightType p,
+  WMWeightType q,
+  WMWeightType restart_probability,
+  raft::random::detail::DeviceState<raft::random::detail::PCGenerator> rngstate,
+  WMIdType* output_walks,
+  int64_t output_walks_stride,
+  int* output_restart_count)
+{
+  int walk_idx = threadIdx.x + blockIdx.x * blockDim.x;
+  if (walk_idx >= start_node_count) return;
+  wholememory::device_reference<int64_t> csr_row_ptr_gen(wm_csr_row_ptr);
+  wholememory::device_reference<WMIdType> csr_col_ptr_gen(wm_csr_col_ptr);
+  wholememory::device_reference<WMWeightType> csr_weight_ptr_gen(wm_csr_weight_ptr);
+  raft::random::detail::PCGenerator rng(rngstate, (uint64_t)walk_idx);
+  int restart_count = random_walk_one(csr_row_ptr_gen,
+                                      csr_col_ptr_gen,
+                                      csr_weight_ptr_gen,
+                                      weighted,
+                                      static_cast<int64_t>(start_nodes[walk_idx]),
+                                      walk_length,
+                                      p,
+                                      q,
+                                      restart_probability,
+                                      rng,
+                                      output_walks + walk_idx * output_walks_stride);
+  if (output_restart_count != nullptr) output_restart_count[walk_idx] = restart_count;
+}
+
+template <typename IdType, typename WMIdType, typename WMWeightType>
+void wholegraph_csr_random_walk_func(wholememory_gref_t wm_csr_row_ptr,
+                                     wholememory_array_description_t wm_csr_row_ptr_desc,
+                                     wholememory_gref_t wm_csr_col_ptr,
+                                     wholememory_array_description_t wm_csr_col_ptr_desc,
+                                     bool weighted,
+                                     wholememory_gref_t wm_csr_weight_ptr,
+                                     wholememory_array_description_t wm_csr_weight_ptr_desc,
+                                     void* start_nodes,
+                                     wholememory_array_description_t start_nodes_desc,
+                                     int walk_length,
+                                     float p,
+                                     float q,
+                                     float restart_probability,
+                                     void* output_walks,
+                                     wholememory_matrix_description_t output_walks_desc,
+                                     int* output_restart_count,
+                                     unsigned long long random_seed,
+                                     wholememory_env_func_t* p_env_fns,
+                                     cudaStream_t stream)
+{
+  int start_node_count = start_nodes_desc.size;
+
+  WHOLEMEMORY_EXPECTS(wm_csr_row_ptr_desc.dtype == WHOLEMEMORY_DT_INT64,
+                      "wholegraph_csr_random_walk_func(). "
+                      "wm_csr_row_ptr_desc.dtype != WHOLEMEMORY_DT_INT64, "
+                      "wm_csr_row_ptr_desc.dtype = %d",
+                      wm_csr_row_ptr_desc.dtype);
+  WHOLEMEMORY_EXPECTS(output_walks_desc.dtype == wm_csr_col_ptr_desc.dtype,
+                      "wholegraph_csr_random_walk_func(). "
+                      "output_walks_desc.dtype != wm_csr_col_ptr_desc.dtype, "
+                      "output_walks_desc.dtype = %d",
+                      output_walks_desc.dtype);
+  if (start_node_count == 0) return;
+
+  raft::random::RngState _rngstate(random_seed, 0, raft::random::GeneratorType::GenPC);
+  raft::random::detail::DeviceState<raft::random::detail::PCGenerator> rngstate(_rngstate);
+  int block_count = raft::div_rounding_up_safe<int>(start_node_count, kRandomWalkBlockDim);
+  random_walk_kernel<IdType, WMIdType, WMWeightType>
+    <<<block_count, kRandomWalkBlockDim, 0, stream>>>(
+      wm_csr_row_ptr,
+      wm_csr_col_ptr,
+      weighted,
+      wm_csr_weight_ptr,
+      (const IdType*)start_nodes,
+      start_node_count,
+      walk_length,
+      static_cast<WMWeightType>(p),
+      static_cast<WMWeightType>(q),
+      static_cast<WMWeightType>(restart_probability),
+      rngstate,
+      static_cast<WMIdType*>(output_walks),
+      output_walks_desc.stride,
+      output_restart_count);
+  WM_CUDA_CHECK(cudaGetLastError());
+}
+
+}  // namespace wholegraph_ops
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <wholememory/env_func_ptrs.h>
+#include <wholememory/global_reference.h>
+#include <wholememory/tensor_description.h>
+#include <wholememory/wholememory.h>
+
+namespace wholegraph_ops {
+
+/**
+ * Generate walk_length steps of random walk from each start node, wm_csr_weight_ptr is not used
+ * for unweighted walk. output_walks is a matrix of start node count rows and walk_length + 1
+ * columns, output_restart_count can be nullptr.
+ */
+wholememory_error_code_t wholegraph_csr_random_walk_mapped(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  bool weighted,
+  wholememory_gref_t wm_csr_weight_ptr,
+  wholememory_array_description_t wm_csr_weight_ptr_desc,
+  void* start_nodes,
+  wholememory_array_description_t start_nodes_desc,
+  int walk_length,
+  float p,
+  float q,
+  float restart_probability,
+  void* output_walks,
+  wholememory_matrix_description_t output_walks_desc,
+  int* output_restart_count,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  cudaStream_t stream);
+
+/**
+ * Host version of wholegraph_csr_random_walk_mapped, gives same result as the device version.
+ * Graph should be continuous host memory, start nodes and outputs should be host memory.
+ */
+wholememory_error_code_t wholegraph_csr_random_walk_host(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  bool weighted,
+  wholememory_gref_t wm_csr_weight_ptr,
+  wholememory_array_description_t wm_csr_weight_ptr_desc,
+  void* start_nodes,
+  wholememory_array_description_t start_nodes_desc,
+  int walk_length,
+  float p,
+  float q,
+  float restart_probability,
+  void* output_walks,
+  wholememory_matrix_description_t output_walks_desc,
+  int* output_restart_count,
+  unsigned long long random_seed);
+
+}  // namespace wholegraph_ops
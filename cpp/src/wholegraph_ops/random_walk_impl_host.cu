@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+
+#include <raft/random/rng_device.cuh>
+#include <raft/random/rng_state.hpp>
+
+#include <wholememory/wholememory.h>
+
+#include "error.hpp"
+#include "logger.hpp"
+#include "parallel_utils.hpp"
+#include "random_walk_comm.cuh"
+#include "random_walk_impl.h"
+#include "wholememory_ops/register.hpp"
+
+namespace wholegraph_ops {
+
+namespace {
+
+constexpr int kMinWalksPerTask = 64;
+
+}  // namespace
+
+template <typename IdType, typename WMIdType, typename WeightType>
+void host_csr_random_walk_func(wholememory_gref_t wm_csr_row_ptr,
+                               wholememory_array_description_t wm_csr_row_ptr_desc,
+                               wholememory_gref_t wm_csr_col_ptr,
+                               wholememory_array_description_t wm_csr_col_ptr_desc,
+                               bool weighted,
+                               wholememory_gref_t wm_csr_weight_ptr,
+                               wholememory_array_description_t wm_csr_weight_ptr_desc,
+                               void* start_nodes,
+                               wholememory_array_description_t start_nodes_desc,
+                               int walk_length,
+                               float p,
+                               float q,
+                               float restart_probability,
+                               void* output_walks,
+                               wholememory_matrix_description_t output_walks_desc,
+                               int* output_restart_count,
+                               unsigned long long random_seed)
+{
+  int start_node_count = start_nodes_desc.size;
+
+  WHOLEMEMORY_EXPECTS(wm_csr_row_ptr_desc.dtype == WHOLEMEMORY_DT_INT64,
+                      "host_csr_random_walk_func(). "
+                      "wm_csr_row_ptr_desc.dtype != WHOLEMEMORY_DT_INT64, "
+                      "wm_csr_row_ptr_desc.dtype = %d",
+                      wm_csr_row_ptr_desc.dtype);
+  WHOLEMEMORY_EXPECTS(output_walks_desc.dtype == wm_csr_col_ptr_desc.dtype,
+                      "host_csr_random_walk_func(). "
+                      "output_walks_desc.dtype != wm_csr_col_ptr_desc.dtype, "
+                      "output_walks_desc.dtype = %d",
+                      output_walks_desc.dtype);
+  // host graph should be continuous, its global reference is the global pointer.
+  WHOLEMEMORY_CHECK(wm_csr_row_ptr.stride == 0 && wm_csr_col_ptr.stride == 0 &&
+                    wm_csr_weight_ptr.stride == 0);
+
+  auto* csr_row_ptr    = static_cast<const int64_t*>(wm_csr_row_ptr.pointer);
+  auto* csr_col_ptr    = static_cast<const WMIdType*>(wm_csr_col_ptr.pointer);
+  auto* csr_weight_ptr = static_cast<const WeightType*>(wm_csr_weight_ptr.pointer);
+  auto* input_nodes    = static_cast<const IdType*>(start_nodes);
+  auto* walks          = static_cast<WMIdType*>(output_walks);
+
+  raft::random::RngState _rngstate(random_seed, 0, raft::random::GeneratorType::GenPC);
+  raft::random::detail::DeviceState<raft::random::detail::PCGenerator> rngstate(_rngstate);
+  int task_count = std::min(GetThreadPoolSize(), start_node_count / kMinWalksPerTask);
+  task_count     = std::max(task_count, 1);
+  ThreadPoolRun(task_count, [&](int task_id, int task_num) {
+    int start = (int)((int64_t)start_node_count * task_id / task_num);
+    int end   = (int)((int64_t)start_node_count * (task_id + 1) / task_num);
+    for (int walk_idx = start; walk_idx < end; walk_idx++) {
+      raft::random::detail::PCGenerator rng(rngstate, (uint64_t)walk_idx);
+      int restart_count = random_walk_one(csr_row_ptr,
+                                          csr_col_ptr,
+                                          csr_weight_ptr,
+                                          weighted,
+                                          static_cast<int64_t>(input_nodes[walk_idx]),
+                                          walk_length,
+                                          static_cast<WeightType>(p),
+                                          static_cast<WeightType>(q),
+                                          static_cast<WeightType>(restart_probability),
+                                          rng,
+                                          walks + walk_idx * output_walks_desc.stride);
+      if (output_restart_count != nullptr) output_restart_count[walk_idx] = restart_count;
+    }
+  });
+}
+
+REGISTER_DISPATCH_THREE_TYPES(HostRandomWalkCSR,
+                              host_csr_random_walk_func,
+                              SINT3264,
+                              SINT3264,
+                              FLOAT_DOUBLE)
+
+wholememory_error_code_t wholegraph_csr_random_walk_host(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  bool weighted,
+  wholememory_gref_t wm_csr_weight_ptr,
+  wholememory_array_description_t wm_csr_weight_ptr_desc,
+  void* start_nodes,
+  wholememory_array_description_t start_nodes_desc,
+  int walk_length,
+  float p,
+  float q,
+  float restart_probability,
+  void* output_walks,
+  wholememory_matrix_description_t output_walks_desc,
+  int* output_restart_count,
+  unsigned long long random_seed)
+{
+  try {
+    DISPATCH_THREE_TYPES(start_nodes_desc.dtype,
+                         wm_csr_col_ptr_desc.dtype,
+                         weighted ? wm_csr_weight_ptr_desc.dtype : WHOLEMEMORY_DT_FLOAT,
+                         HostRandomWalkCSR,
+                         wm_csr_row_ptr,
+                         wm_csr_row_ptr_desc,
+                         wm_csr_col_ptr,
+                         wm_csr_col_ptr_desc,
+                         weighted,
+                         wm_csr_weight_ptr,
+                         wm_csr_weight_ptr_desc,
+                         start_nodes,
+                         start_nodes_desc,
+                         walk_length,
+                         p,
+                         q,
+                         restart_probability,
+                         output_walks,
+                         output_walks_desc,
+                         output_restart_count,
+                         random_seed);
+  } catch (const wholememory::logic_error& le) {
+    WHOLEMEMORY_ERROR("LOGIC Error %s\n", le.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+}  // namespace wholegraph_ops
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cuda_runtime_api.h>
+
+#include <wholememory/env_func_ptrs.h>
+#include <wholememory/wholememory.h>
+
+#include "random_walk_func.cuh"
+#include "random_walk_impl.h"
+#include "wholememory_ops/register.hpp"
+
+namespace wholegraph_ops {
+
+REGISTER_DISPATCH_THREE_TYPES(RandomWalkCSR,
+                              wholegraph_csr_random_walk_func,
+                              SINT3264,
+                              SINT3264,
+                              FLOAT_DOUBLE)
+
+wholememory_error_code_t wholegraph_csr_random_walk_mapped(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  bool weighted,
+  wholememory_gref_t wm_csr_weight_ptr,
+  wholememory_array_description_t wm_csr_weight_ptr_desc,
+  void* start_nodes,
+  wholememory_array_description_t start_nodes_desc,
+  int walk_length,
+  float p,
+  float q,
+  float restart_probability,
+  void* output_walks,
+  wholememory_matrix_description_t output_walks_desc,
+  int* output_restart_count,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  cudaStream_t stream)
+{
+  try {
+    DISPATCH_THREE_TYPES(start_nodes_desc.dtype,
+                         wm_csr_col_ptr_desc.dtype,
+                         weighted ? wm_csr_weight_ptr_desc.dtype : WHOLEMEMORY_DT_FLOAT,
+                         RandomWalkCSR,
+                         wm_csr_row_ptr,
+                         wm_csr_row_ptr_desc,
+                         wm_csr_col_ptr,
+                         wm_csr_col_ptr_desc,
+                         weighted,
+                         wm_csr_weight_ptr,
+                         wm_csr_weight_ptr_desc,
+                         start_nodes,
+                         start_nodes_desc,
+                         walk_length,
+                         p,
+                         q,
+                         restart_probability,
+                         output_walks,
+                         output_walks_desc,
+                         output_restart_count,
+                         random_seed,
+                         p_env_fns,
+                         stream);
+  } catch (const wholememory::cuda_error& rle) {
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (const wholememory::logic_error& le) {
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+}  // namespace wholegraph_ops
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sample_comm_host.h"
+
+#include <wholememory_ops/functions/host_gather_scatter_func.h>
+
+namespace wholegraph_ops {
+
+bool is_host_graph_tensor(wholememory_tensor_t graph_tensor)
+{
+  if (!wholememory_tensor_has_handle(graph_tensor)) {
+    return wholememory_ops::is_host_memory_pointer(
+      wholememory_tensor_get_data_pointer(graph_tensor));
+  }
+  auto graph_handle    = wholememory_tensor_get_memory_handle(graph_tensor);
+  auto memory_location = wholememory_get_memory_location(graph_handle);
+  return wholememory_get_memory_type(graph_handle) == WHOLEMEMORY_MT_CONTINUOUS &&
+         (memory_location == WHOLEMEMORY_ML_HOST || memory_location == WHOLEMEMORY_ML_FILE);
+}
+
+bool should_use_host_sample(wholememory_tensor_t wm_csr_row_ptr_tensor,
+                            wholememory_tensor_t wm_csr_col_ptr_tensor,
+                            wholememory_tensor_t wm_csr_weight_ptr_tensor,
+                            const void* center_nodes,
+                            const void* output_sample_offset)
+{
+  if (!is_host_graph_tensor(wm_csr_row_ptr_tensor) ||
+      !is_host_graph_tensor(wm_csr_col_ptr_tensor)) {
+    return false;
+  }
+  if (wm_csr_weight_ptr_tensor != nullptr && !is_host_graph_tensor(wm_csr_weight_ptr_tensor)) {
+    return false;
+  }
+  return wholememory_ops::is_host_memory_pointer(center_nodes) &&
+         wholememory_ops::is_host_memory_pointer(output_sample_offset);
+}
+
+}  // namespace wholegraph_ops
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <wholememory/tensor_description.h>
+#include <wholememory/wholememory.h>
+#include <wholememory/wholememory_tensor.h>
+
+namespace wholegraph_ops {
+
+/**
+ * Check if graph tensor can be sampled on CPU, host sampling reads graph by its global pointer, so
+ * graph should be continuous host or file memory, or a host pointer tensor.
+ * @param graph_tensor : CSR row ptr, col ptr or weight tensor
+ * @return : true if graph_tensor can be sampled on CPU
+ */
+bool is_host_graph_tensor(wholememory_tensor_t graph_tensor);
+
+/**
+ * Check if CSR sampling should run on CPU.
+ * That is when all graph tensors can be sampled on CPU, and center nodes and output sample offset
+ * are host memory.
+ * @param wm_csr_row_ptr_tensor : CSR row ptr tensor
+ * @param wm_csr_col_ptr_tensor : CSR col ptr tensor
+ * @param wm_csr_weight_ptr_tensor : CSR weight tensor, nullptr for unweighted sampling
+ * @param center_nodes : pointer to center nodes
+ * @param output_sample_offset : pointer to output sample offset
+ * @return : true if should run on CPU
+ */
+bool should_use_host_sample(wholememory_tensor_t wm_csr_row_ptr_tensor,
+                            wholememory_tensor_t wm_csr_col_ptr_tensor,
+                            wholememory_tensor_t wm_csr_weight_ptr_tensor,
+                            const void* center_nodes,
+                            const void* output_sample_offset);
+
+}  // namespace wholegraph_ops
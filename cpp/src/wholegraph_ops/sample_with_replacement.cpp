@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <wholememory/wholegraph_op.h>
+
+#include <wholegraph_ops/sample_comm_host.h>
+#include <wholegraph_ops/sample_with_replacement_impl.h>
+#include <wholememory_ops/functions/host_gather_scatter_func.h>
+
+#include "error.hpp"
+#include "logger.hpp"
+#include "wholememory/env_func_ptrs.hpp"
+
+namespace {
+
+// center_fanout_tensor is optional, nullptr or 0D tensor means None. When present, it should be 1D
+// int tensor with one fanout for each center node, in the same memory as center_nodes_tensor.
+wholememory_error_code_t get_center_fanout(wholememory_tensor_t center_fanout_tensor,
+                                           wholememory_array_description_t center_nodes_desc,
+                                           const int** center_fanout)
+{
+  *center_fanout = nullptr;
+  if (center_fanout_tensor == nullptr) return WHOLEMEMORY_SUCCESS;
+  wholememory_tensor_description_t center_fanout_tensor_desc =
+    *wholememory_tensor_get_tensor_description(center_fanout_tensor);
+  if (center_fanout_tensor_desc.dim == 0) return WHOLEMEMORY_SUCCESS;
+  if (center_fanout_tensor_desc.dim != 1) {
+    WHOLEMEMORY_ERROR("Input center_fanout_tensor should be 1D tensor or None.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t center_fanout_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&center_fanout_desc, &center_fanout_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Input center_fanout_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  if (center_fanout_desc.dtype != WHOLEMEMORY_DT_INT) {
+    WHOLEMEMORY_ERROR("Input center_fanout_tensor should be int tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (center_fanout_desc.size != center_nodes_desc.size) {
+    WHOLEMEMORY_ERROR("Input center_fanout_tensor should have same size as center_nodes_tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  *center_fanout =
+    static_cast<const int*>(wholememory_tensor_get_data_pointer(center_fanout_tensor));
+  return WHOLEMEMORY_SUCCESS;
+}
+
+}  // namespace
+
+wholememory_error_code_t wholegraph_csr_unweighted_sample_with_replacement(
+  wholememory_tensor_t wm_csr_row_ptr_tensor,
+  wholememory_tensor_t wm_csr_col_ptr_tensor,
+  wholememory_tensor_t center_nodes_tensor,
+  int max_sample_count,
+  wholememory_tensor_t center_fanout_tensor,
+  wholememory_tensor_t output_sample_offset_tensor,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  void* stream)
+{
+  wholememory::temp_memory_stream_guard stream_guard(static_cast<cudaStream_t>(stream));
+  bool const csr_row_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_row_ptr_tensor);
+  wholememory_memory_type_t csr_row_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_row_ptr_has_handle) {
+    csr_row_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_row_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_row_ptr_has_handle ||
+                                csr_row_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_row_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+  bool const csr_col_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_col_ptr_tensor);
+  wholememory_memory_type_t csr_col_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_col_ptr_has_handle) {
+    csr_col_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_col_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_col_ptr_has_handle ||
+                                csr_col_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_col_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+
+  auto csr_row_ptr_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_csr_row_ptr_tensor);
+  auto csr_col_ptr_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_csr_col_ptr_tensor);
+
+  if (csr_row_ptr_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_csr_row_ptr_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (csr_col_ptr_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_csr_col_ptr_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+
+  wholememory_array_description_t wm_csr_row_ptr_desc, wm_csr_col_ptr_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&wm_csr_row_ptr_desc,
+                                                &csr_row_ptr_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_csr_row_ptr_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  if (!wholememory_convert_tensor_desc_to_array(&wm_csr_col_ptr_desc,
+                                                &csr_col_ptr_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_csr_col_ptr_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+
+  wholememory_tensor_description_t center_nodes_tensor_desc =
+    *wholememory_tensor_get_tensor_description(center_nodes_tensor);
+  if (center_nodes_tensor_desc.dim != 1) {
+    WHOLEMEMORY_ERROR("Input center_nodes_tensor should be 1D tensor");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t center_nodes_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&center_nodes_desc, &center_nodes_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Input center_nodes_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+
+  wholememory_tensor_description_t output_sample_offset_tensor_desc =
+    *wholememory_tensor_get_tensor_description(output_sample_offset_tensor);
+  if (output_sample_offset_tensor_desc.dim != 1) {
+    WHOLEMEMORY_ERROR("Output output_sample_offset_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t output_sample_offset_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&output_sample_offset_desc,
+                                                &output_sample_offset_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Output output_sample_offset_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+
+  const int* center_fanout = nullptr;
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    get_center_fanout(center_fanout_tensor, center_nodes_desc, &center_fanout));
+
+  void* center_nodes         = wholememory_tensor_get_data_pointer(center_nodes_tensor);
+  void* output_sample_offset = wholememory_tensor_get_data_pointer(output_sample_offset_tensor);
+
+  wholememory_gref_t wm_csr_row_ptr_gref, wm_csr_col_ptr_gref;
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_csr_row_ptr_tensor, &wm_csr_row_ptr_gref));
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_csr_col_ptr_tensor, &wm_csr_col_ptr_gref));
+
+  if (wholegraph_ops::should_use_host_sample(wm_csr_row_ptr_tensor,
+                                             wm_csr_col_ptr_tensor,
+                                             nullptr,
+                                             center_nodes,
+                                             output_sample_offset) &&
+      (center_fanout == nullptr || wholememory_ops::is_host_memory_pointer(center_fanout))) {
+    return wholegraph_ops::wholegraph_csr_unweighted_sample_with_replacement_host(
+      wm_csr_row_ptr_gref,
+      wm_csr_row_ptr_desc,
+      wm_csr_col_ptr_gref,
+      wm_csr_col_ptr_desc,
+      center_nodes,
+      center_nodes_desc,
+      max_sample_count,
+      center_fanout,
+      output_sample_offset,
+      output_sample_offset_desc,
+      output_dest_memory_context,
+      output_center_localid_memory_context,
+      output_edge_gid_memory_context,
+      random_seed,
+      p_env_fns);
+  }
+  return wholegraph_ops::wholegraph_csr_unweighted_sample_with_replacement_mapped(
+    wm_csr_row_ptr_gref,
+    wm_csr_row_ptr_desc,
+    wm_csr_col_ptr_gref,
+    wm_csr_col_ptr_desc,
+    center_nodes,
+    center_nodes_desc,
+    max_sample_count,
+    center_fanout,
+    output_sample_offset,
+    output_sample_offset_desc,
+    output_dest_memory_context,
+    output_center_localid_memory_context,
+    output_edge_gid_memory_context,
+    random_seed,
+    p_env_fns,
+    static_cast<cudaStream_t>(stream));
+}
+
+wholememory_error_code_t wholegraph_csr_weighted_sample_with_replacement(
+  wholememory_tensor_t wm_csr_row_ptr_tensor,
+  wholememory_tensor_t wm_csr_col_ptr_tensor,
+  wholememory_tensor_t wm_csr_weight_ptr_tensor,
+  wholememory_tensor_t center_nodes_tensor,
+  int max_sample_count,
+  wholememory_tensor_t center_fanout_tensor,
+  wholememory_tensor_t output_sample_offset_tensor,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  void* stream)
+{
+  wholememory::temp_memory_stream_guard stream_guard(static_cast<cudaStream_t>(stream));
+  bool const csr_row_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_row_ptr_tensor);
+  wholememory_memory_type_t csr_row_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_row_ptr_has_handle) {
+    csr_row_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_row_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_row_ptr_has_handle ||
+                                csr_row_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_row_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+  bool const csr_col_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_col_ptr_tensor);
+  wholememory_memory_type_t csr_col_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_col_ptr_has_handle) {
+    csr_col_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_col_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_col_ptr_has_handle ||
+                                csr_col_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_col_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+  bool const csr_weight_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_weight_ptr_tensor);
+  wholememory_memory_type_t csr_weight_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_weight_ptr_has_handle) {
+    csr_weight_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_weight_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_weight_ptr_has_handle ||
+                                csr_weight_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_weight_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+
+  auto csr_row_ptr_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_csr_row_ptr_tensor);
+  auto csr_col_ptr_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_csr_col_ptr_tensor);
+  auto csr_weight_ptr_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_csr_weight_ptr_tensor);
+  if (csr_row_ptr_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_csr_row_ptr_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (csr_col_ptr_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_csr_col_ptr_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (csr_weight_ptr_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_csr_weight_ptr_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t wm_csr_row_ptr_desc, wm_csr_col_ptr_desc, wm_csr_weight_ptr_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&wm_csr_row_ptr_desc,
+                                                &csr_row_ptr_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_csr_row_ptr_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  if (!wholememory_convert_tensor_desc_to_array(&wm_csr_col_ptr_desc,
+                                                &csr_col_ptr_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_csr_col_ptr_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  if (!wholememory_convert_tensor_desc_to_array(&wm_csr_weight_ptr_desc,
+                                                &csr_weight_ptr_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_csr_weight_ptr_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+
+  wholememory_tensor_description_t center_nodes_tensor_desc =
+    *wholememory_tensor_get_tensor_description(center_nodes_tensor);
+  if (center_nodes_tensor_desc.dim != 1) {
+    WHOLEMEMORY_ERROR("Input center_nodes_tensor should be 1D tensor");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t center_nodes_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&center_nodes_desc, &center_nodes_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Input center_nodes_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+
+  wholememory_tensor_description_t output_sample_offset_tensor_desc =
+    *wholememory_tensor_get_tensor_description(output_sample_offset_tensor);
+  if (output_sample_offset_tensor_desc.dim != 1) {
+    WHOLEMEMORY_ERROR("Output output_sample_offset_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t output_sample_offset_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&output_sample_offset_desc,
+                                                &output_sample_offset_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Output output_sample_offset_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+
+  const int* center_fanout = nullptr;
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    get_center_fanout(center_fanout_tensor, center_nodes_desc, &center_fanout));
+
+  void* center_nodes         = wholememory_tensor_get_data_pointer(center_nodes_tensor);
+  void* output_sample_offset = wholememory_tensor_get_data_pointer(output_sample_offset_tensor);
+  wholememory_gref_t wm_csr_row_ptr_gref, wm_csr_col_ptr_gref, wm_csr_weight_ptr_gref;
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_csr_row_ptr_tensor, &wm_csr_row_ptr_gref));
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_csr_col_ptr_tensor, &wm_csr_col_ptr_gref));
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_csr_weight_ptr_tensor, &wm_csr_weight_ptr_gref));
+
+  if (wholegraph_ops::should_use_host_sample(wm_csr_row_ptr_tensor,
+                                             wm_csr_col_ptr_tensor,
+                                             wm_csr_weight_ptr_tensor,
+                                             center_nodes,
+                                             output_sample_offset) &&
+      (center_fanout == nullptr || wholememory_ops::is_host_memory_pointer(center_fanout))) {
+    return wholegraph_ops::wholegraph_csr_weighted_sample_with_replacement_host(
+      wm_csr_row_ptr_gref,
+      wm_csr_row_ptr_desc,
+      wm_csr_col_ptr_gref,
+      wm_csr_col_ptr_desc,
+      wm_csr_weight_ptr_gref,
+      wm_csr_weight_ptr_desc,
+      center_nodes,
+      center_nodes_desc,
+      max_sample_count,
+      center_fanout,
+      output_sample_offset,
+      output_sample_offset_desc,
+      output_dest_memory_context,
+      output_center_localid_memory_context,
+      output_edge_gid_memory_context,
+      random_seed,
+      p_env_fns);
+  }
+  return wholegraph_ops::wholegraph_csr_weighted_sample_with_replacement_mapped(
+    wm_csr_row_ptr_gref,
+    wm_csr_row_ptr_desc,
+    wm_csr_col_ptr_gref,
+    wm_csr_col_ptr_desc,
+    wm_csr_weight_ptr_gref,
+    wm_csr_weight_ptr_desc,
+    center_nodes,
+    center_nodes_desc,
+    max_sample_count,
+    center_fanout,
+    output_sample_offset,
+    output_sample_offset_desc,
+    output_dest_memory_context,
+    output_center_localid_memory_context,
+    output_edge_gid_memory_context,
+    random_seed,
+    p_env_fns,
+    static_cast<cudaStream_t>(stream));
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include <raft/random/rng_device.cuh>
+
+namespace wholegraph_ops {
+
+// Sampling with replacement is done by kWithReplacementBlockDim threads for each center node,
+// thread t of center node i draws random numbers from subsequence t + i * kWithReplacementBlockDim.
+// Device kernels and host sampling share functions below, so they give the same result.
+constexpr int kWithReplacementBlockDim = 64;
+
+__host__ __device__ __forceinline__ int32_t
+with_replacement_next_int(raft::random::detail::PCGenerator& rng)
+{
+  raft::random::detail::UniformDistParams<int32_t> params;
+  params.start = 0;
+  params.end   = 1;
+  int32_t random_num;
+  raft::random::detail::custom_next(rng, &random_num, params, 0, 0);
+  return random_num;
+}
+
+// uniform random number in [0, 1) from 24 random bits, exact in float.
+template <typename ProbType>
+__host__ __device__ __forceinline__ ProbType
+with_replacement_next_uniform(raft::random::detail::PCGenerator& rng)
+{
+  int32_t random_num = with_replacement_next_int(rng);
+  return static_cast<ProbType>((random_num >> 7) & 0xFFFFFF) *
+         static_cast<ProbType>(1.0 / 16777216);
+}
+
+// uniform random number in [0, 1) from 53 random bits, exact in double.
+__host__ __device__ __forceinline__ double
+with_replacement_next_uniform_53(raft::random::detail::PCGenerator& rng)
+{
+  uint64_t random_high = static_cast<uint32_t>(with_replacement_next_int(rng)) & 0x7FFFFFFU;
+  uint64_t random_low  = static_cast<uint32_t>(with_replacement_next_int(rng)) & 0x3FFFFFFU;
+  return static_cast<double>((random_high << 26) | random_low) * (1.0 / 9007199254740992.0);
+}
+
+template <typename WeightType>
+__host__ __device__ __forceinline__ double positive_weight(WeightType weight)
+{
+  // negative and NaN weights are taken as zero.
+  return weight > 0 ? static_cast<double>(weight) : 0.0;
+}
+
+/**
+ * Partial weight sum of one building thread, weight sum of center node is the sum of partial sums
+ * of threads 0 to kWithReplacementBlockDim - 1 in order, so device and host sums are the same.
+ * @param weights : weights of neighbors, indexed by neighbor index
+ * @param neighbor_count : neighbor count of center node
+ * @param thread_idx : index of building thread
+ * @return : sum of positive weights of neighbors thread_idx, thread_idx + kWithReplacementBlockDim...
+ */
+template <typename WeightAccessor>
+__host__ __device__ __forceinline__ double alias_table_partial_weight_sum(WeightAccessor& weights,
+                                                                          int64_t neighbor_count,
+                                                                          int thread_idx)
+{
+  double sum = 0;
+  for (int64_t i = thread_idx; i < neighbor_count; i += kWithReplacementBlockDim) {
+    sum += positive_weight(weights[i]);
+  }
+  return sum;
+}
+
+/**
+ * Weight of one neighbor scaled so that average of all neighbors is 1.
+ * @param weight : weight of the neighbor
+ * @param neighbor_count : neighbor count of center node
+ * @param weight_sum : sum of positive weights of center node
+ * @return : scaled weight, 1 for all neighbors if no weight is positive so that they are sampled
+ * uniformly.
+ */
+template <typename WeightType>
+__host__ __device__ __forceinline__ double alias_table_scaled_weight(WeightType weight,
+                                                                    int64_t neighbor_count,
+                                                                    double weight_sum)
+{
+  if (!(weight_sum > 0)) return 1.0;
+  return positive_weight(weight) * static_cast<double>(neighbor_count) / weight_sum;
+}
+
+/**
+ * Pair slots of alias table of one center node by Vose's method, sequentially so that device and
+ * host tables are the same.
+ * @param neighbor_count : neighbor count of center node
+ * @param prob : scaled weights as input, output probability to keep neighbor i in slot i
+ * @param alias : output, neighbor to use in slot i if not kept
+ * @param worklist : buffer of neighbor_count elements
+ */
+__host__ __device__ inline void pair_alias_table(int64_t neighbor_count,
+                                                 double* prob,
+                                                 int* alias,
+                                                 int* worklist)
+{
+  // small stack grows from the front of worklist, large stack from the back.
+  int64_t small_count = 0;
+  int64_t large_begin = neighbor_count;
+  int max_prob_idx    = 0;
+  for (int64_t i = 0; i < neighbor_count; i++) {
+    alias[i] = static_cast<int>(i);
+    if (prob[i] > prob[max_prob_idx]) max_prob_idx = static_cast<int>(i);
+    if (prob[i] < 1) {
+      worklist[small_count++] = static_cast<int>(i);
+    } else {
+      worklist[--large_begin] = static_cast<int>(i);
+    }
+  }
+  int last_large = max_prob_idx;
+  while (small_count > 0 && large_begin < neighbor_count) {
+    int small_idx    = worklist[--small_count];
+    int large_idx    = worklist[large_begin++];
+    alias[small_idx] = large_idx;
+    last_large       = large_idx;
+    prob[large_idx]  = (prob[large_idx] + prob[small_idx]) - 1.0;
+    if (prob[large_idx] < 1) {
+      worklist[small_count++] = large_idx;
+    } else {
+      worklist[--large_begin] = large_idx;
+    }
+  }
+  // left ones are 1 up to rounding error, except zero weights which still go to a positive one.
+  for (int64_t i = 0; i < small_count; i++) {
+    int idx = worklist[i];
+    if (prob[idx] > 0) {
+      prob[idx] = 1;
+    } else {
+      alias[idx] = last_large;
+    }
+  }
+  for (int64_t i = large_begin; i < neighbor_count; i++) {
+    prob[worklist[i]] = 1;
+  }
+}
+
+/**
+ * Build alias table of one center node on host, same as the device build.
+ * @param weights : weights of neighbors, indexed by neighbor index
+ * @param neighbor_count : neighbor count of center node
+ * @param prob : output, probability to keep neighbor i in slot i
+ * @param alias : output, neighbor to use in slot i if not kept
+ * @param worklist : buffer of neighbor_count elements
+ */
+template <typename WeightAccessor>
+__host__ void build_alias_table(
+  WeightAccessor& weights, int64_t neighbor_count, double* prob, int* alias, int* worklist)
+{
+  double weight_sum = 0;
+  for (int t = 0; t < kWithReplacementBlockDim; t++) {
+    weight_sum += alias_table_partial_weight_sum(weights, neighbor_count, t);
+  }
+  for (int64_t i = 0; i < neighbor_count; i++) {
+    prob[i] = alias_table_scaled_weight(weights[i], neighbor_count, weight_sum);
+  }
+  pair_alias_table(neighbor_count, prob, alias, worklist);
+}
+
+/**
+ * Sample neighbor index of one sample of center node.
+ * @param rng : random generator of the sampling thread
+ * @param neighbor_count : neighbor count of center node, should be positive
+ * @param prob : probability of alias table, nullptr for unweighted sampling
+ * @param alias : alias of alias table, nullptr for unweighted sampling
+ * @return : sampled neighbor index
+ */
+__host__ __device__ __forceinline__ int with_replacement_sample_neighbor(
+  raft::random::detail::PCGenerator& rng, int neighbor_count, const double* prob, const int* alias)
+{
+  int neighbor_idx = with_replacement_next_int(rng) % neighbor_count;
+  if (prob == nullptr) return neighbor_idx;
+  return with_replacement_next_uniform_53(rng) < prob[neighbor_idx] ? neighbor_idx
+                                                                     : alias[neighbor_idx];
+}
+
+/**
+ * Sample count of center node with replacement.
+ * @param neighbor_count : neighbor count of center node
+ * @param fanout : fanout of center node, fanout <= 0 means sample all neighbors
+ * @return : sample count
+ */
+__host__ __device__ __forceinline__ int with_replacement_sample_count(int neighbor_count,
+                                                                     int fanout)
+{
+  if (neighbor_count <= 0) return 0;
+  return fanout > 0 ? fanout : neighbor_count;
+}
+
+}  // namespace wholegraph_ops
@@ -0,0 +1,418 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <thrust/scan.h>
+
+#include <raft/random/rng_device.cuh>
+#include <raft/random/rng_state.hpp>
+#include <raft/util/integer_utils.hpp>
+#include <wholememory/device_reference.cuh>
+#include <wholememory/env_func_ptrs.h>
+#include <wholememory/global_reference.h>
+#include <wholememory/tensor_description.h>
+
+#include "wholememory_ops/output_memory_handle.hpp"
+#include "wholememory_ops/temp_memory_handle.hpp"
+#include "wholememory_ops/thrust_allocator.hpp"
+
+#include "cuda_macros.hpp"
+#include "error.hpp"
+#include "sample_with_replacement_comm.cuh"
+
+namespace wholegraph_ops {
+
+template <typename IdType, typename WMOffsetType>
+__global__ void get_sample_count_with_replacement_kernel(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  const IdType* input_nodes,
+  const int input_node_count,
+  const int max_sample_count,
+  const int* center_fanout,
+  int* tmp_sample_count_mem_pointer,
+  int64_t* tmp_weight_count_mem_pointer)
+{
+  int gidx      = threadIdx.x + blockIdx.x * blockDim.x;
+  int input_idx = gidx;
+  if (input_idx >= input_node_count) return;
+  IdType nid = input_nodes[input_idx];
+  wholememory::device_reference<WMOffsetType> wm_csr_row_ptr_dev_ref(wm_csr_row_ptr);
+  int64_t start      = wm_csr_row_ptr_dev_ref[nid];
+  int64_t end        = wm_csr_row_ptr_dev_ref[nid + 1];
+  int neighbor_count = (int)(end - start);
+  int fanout         = center_fanout != nullptr ? center_fanout[input_idx] : max_sample_count;
+  tmp_sample_count_mem_pointer[input_idx] = with_replacement_sample_count(neighbor_count, fanout);
+  // alias table is only needed for random sampling.
+  if (tmp_weight_count_mem_pointer != nullptr) {
+    tmp_weight_count_mem_pointer[input_idx] = fanout > 0 ? end - start : 0;
+  }
+}
+
+template <typename WMWeightType>
+struct device_weight_accessor {
+  __device__ __forceinline__ WMWeightType operator[](int64_t neighbor_idx)
+  {
+    return weights[start + neighbor_idx];
+  }
+  wholememory::device_reference<WMWeightType> weights;
+  int64_t start;
+};
+
+// one block for each center node, weights are summed and scaled by all threads of the block, and
+// slots are paired by the first thread.
+template <typename IdType, typename WMOffsetType, typename WMWeightType>
+__launch_bounds__(kWithReplacementBlockDim) __global__
+  void build_alias_table_kernel(wholememory_gref_t wm_csr_row_ptr,
+                                wholememory_array_description_t wm_csr_row_ptr_desc,
+                                wholememory_gref_t wm_csr_weight_ptr,
+                                wholememory_array_description_t wm_csr_weight_ptr_desc,
+                                const IdType* input_nodes,
+                                const int input_node_count,
+                                const int64_t* alias_table_offset,
+                                double* alias_prob,
+                                int* alias_index,
+                                int* alias_worklist)
+{
+  __shared__ double partial_weight_sums[kWithReplacementBlockDim];
+  __shared__ double block_weight_sum;
+  int input_idx = blockIdx.x;
+  if (input_idx >= input_node_count) return;
+  int64_t offset         = alias_table_offset[input_idx];
+  int64_t neighbor_count = alias_table_offset[input_idx + 1] - offset;
+  if (neighbor_count == 0) return;
+  IdType nid = input_nodes[input_idx];
+  wholememory::device_reference<WMOffsetType> csr_row_ptr_gen(wm_csr_row_ptr);
+  device_weight_accessor<WMWeightType> weights{
+    wholememory::device_reference<WMWeightType>(wm_csr_weight_ptr), csr_row_ptr_gen[nid]};
+
+  partial_weight_sums[threadIdx.x] =
+    alias_table_partial_weight_sum(weights, neighbor_count, threadIdx.x);
+  __syncthreads();
+  if (threadIdx.x == 0) {
+    // summed in thread order, same as host.
+    double weight_sum = 0;
+    for (int t = 0; t < kWithReplacementBlockDim; t++) {
+      weight_sum += partial_weight_sums[t];
+    }
+    block_weight_sum = weight_sum;
+  }
+  __syncthreads();
+  double weight_sum = block_weight_sum;
+  for (int64_t i = threadIdx.x; i < neighbor_count; i += blockDim.x) {
+    alias_prob[offset + i] = alias_table_scaled_weight(weights[i], neighbor_count, weight_sum);
+  }
+  __syncthreads();
+  if (threadIdx.x == 0) {
+    pair_alias_table(
+      neighbor_count, alias_prob + offset, alias_index + offset, alias_worklist + offset);
+  }
+}
+
+template <typename IdType, typename WMIdType, typename WMOffsetType>
+__launch_bounds__(kWithReplacementBlockDim) __global__ void sample_with_replacement_kernel(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  const IdType* input_nodes,
+  const int input_node_count,
+  const int max_sample_count,
+  const int* center_fanout,
+  raft::random::detail::DeviceState<raft::random::detail::PCGenerator> rngstate,
+  const int* sample_offset,
+  wholememory_array_description_t sample_offset_desc,
+  const int64_t* alias_table_offset,
+  const double* alias_prob,
+  const int* alias_index,
+  WMIdType* output,
+  int* src_lid,
+  int64_t* output_edge_gid_ptr)
+{
+  int input_idx = blockIdx.x;
+  if (input_idx >= input_node_count) return;
+  int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  raft::random::detail::PCGenerator rng(rngstate, (uint64_t)gidx);
+  wholememory::device_reference<WMOffsetType> csr_row_ptr_gen(wm_csr_row_ptr);
+  wholememory::device_reference<WMIdType> csr_col_ptr_gen(wm_csr_col_ptr);
+
+  IdType nid         = input_nodes[input_idx];
+  int64_t start      = csr_row_ptr_gen[nid];
+  int64_t end        = csr_row_ptr_gen[nid + 1];
+  int neighbor_count = (int)(end - start);
+  int offset         = sample_offset[input_idx];
+  int sample_count   = sample_offset[input_idx + 1] - offset;
+  int fanout         = center_fanout != nullptr ? center_fanout[input_idx] : max_sample_count;
+  const double* node_alias_prob = nullptr;
+  const int* node_alias_index   = nullptr;
+  if (alias_table_offset != nullptr) {
+    node_alias_prob  = alias_prob + alias_table_offset[input_idx];
+    node_alias_index = alias_index + alias_table_offset[input_idx];
+  }
+  for (int sample_id = threadIdx.x; sample_id < sample_count; sample_id += blockDim.x) {
+    // fanout <= 0 means sample all.
+    int neighbor_idx =
+      fanout > 0
+        ? with_replacement_sample_neighbor(rng, neighbor_count, node_alias_prob, node_alias_index)
+        : sample_id;
+    output[offset + sample_id] = csr_col_ptr_gen[start + neighbor_idx];
+    if (src_lid) src_lid[offset + sample_id] = input_idx;
+    if (output_edge_gid_ptr) {
+      output_edge_gid_ptr[offset + sample_id] = (int64_t)(start + neighbor_idx);
+    }
+  }
+}
+
+template <typename IdType, typename WMIdType, typename WeightType>
+void wholegraph_csr_sample_with_replacement_func(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  bool weighted,
+  wholememory_gref_t wm_csr_weight_ptr,
+  wholememory_array_description_t wm_csr_weight_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  const int* center_fanout,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  cudaStream_t stream)
+{
+  int center_node_count = center_nodes_desc.size;
+
+  WHOLEMEMORY_EXPECTS(wm_csr_row_ptr_desc.dtype == WHOLEMEMORY_DT_INT64,
+                      "wholegraph_csr_sample_with_replacement_func(). "
+                      "wm_csr_row_ptr_desc.dtype != WHOLEMEMORY_DT_INT64, "
+                      "wm_csr_row_ptr_desc.dtype = %d",
+                      wm_csr_row_ptr_desc.dtype);
+  WHOLEMEMORY_EXPECTS(output_sample_offset_desc.dtype == WHOLEMEMORY_DT_INT,
+                      "wholegraph_csr_sample_with_replacement_func(). "
+                      "output_sample_offset_desc.dtype != WHOLEMEMORY_DT_INT, "
+                      "output_sample_offset_desc.dtype = %d",
+                      output_sample_offset_desc.dtype);
+
+  wholememory_ops::temp_memory_handle gen_buffer_tmh(p_env_fns);
+  int* tmp_sample_count_mem_pointer =
+    (int*)gen_buffer_tmh.device_malloc(center_node_count + 1, WHOLEMEMORY_DT_INT);
+  // neighbor count of all center nodes may exceed int range, so weight offsets are int64.
+  wholememory_ops::temp_memory_handle gen_weight_offset_tmh(p_env_fns);
+  int64_t* tmp_weight_offset_mem_pointer = nullptr;
+  if (weighted) {
+    tmp_weight_offset_mem_pointer =
+      (int64_t*)gen_weight_offset_tmh.device_malloc(center_node_count + 1, WHOLEMEMORY_DT_INT64);
+  }
+
+  int thread_x    = 32;
+  int block_count = raft::div_rounding_up_safe<int>(center_node_count, thread_x);
+  get_sample_count_with_replacement_kernel<IdType, int64_t>
+    <<<block_count, thread_x, 0, stream>>>(wm_csr_row_ptr,
+                                           wm_csr_row_ptr_desc,
+                                           (const IdType*)center_nodes,
+                                           center_node_count,
+                                           max_sample_count,
+                                           center_fanout,
+                                           tmp_sample_count_mem_pointer,
+                                           tmp_weight_offset_mem_pointer);
+  WM_CUDA_CHECK(cudaGetLastError());
+
+  // prefix sum
+  wholememory_ops::wm_thrust_allocator thrust_allocator(p_env_fns);
+  thrust::exclusive_scan(thrust::cuda::par(thrust_allocator).on(stream),
+                         tmp_sample_count_mem_pointer,
+                         tmp_sample_count_mem_pointer + center_node_count + 1,
+                         (int*)output_sample_offset);
+
+  int count;
+  WM_CUDA_CHECK(cudaMemcpyAsync(&count,
+                                ((int*)output_sample_offset) + center_node_count,
+                                sizeof(int),
+                                cudaMemcpyDeviceToHost,
+                                stream));
+  int64_t weight_count = 0;
+  if (weighted) {
+    thrust::exclusive_scan(thrust::cuda::par(thrust_allocator).on(stream),
+                           tmp_weight_offset_mem_pointer,
+                           tmp_weight_offset_mem_pointer + center_node_count + 1,
+                           tmp_weight_offset_mem_pointer);
+    WM_CUDA_CHECK(cudaMemcpyAsync(&weight_count,
+                                  tmp_weight_offset_mem_pointer + center_node_count,
+                                  sizeof(int64_t),
+                                  cudaMemcpyDeviceToHost,
+                                  stream));
+  }
+  WM_CUDA_CHECK(cudaStreamSynchronize(stream));
+
+  wholememory_ops::output_memory_handle gen_output_dest_buffer_mh(p_env_fns,
+                                                                  output_dest_memory_context);
+  WMIdType* output_dest_node_ptr =
+    (WMIdType*)gen_output_dest_buffer_mh.device_malloc(count, wm_csr_col_ptr_desc.dtype);
+
+  int* output_center_localid_ptr = nullptr;
+  if (output_center_localid_memory_context) {
+    wholememory_ops::output_memory_handle gen_output_center_localid_buffer_mh(
+      p_env_fns, output_center_localid_memory_context);
+    output_center_localid_ptr =
+      (int*)gen_output_center_localid_buffer_mh.device_malloc(count, WHOLEMEMORY_DT_INT);
+  }
+
+  int64_t* output_edge_gid_ptr = nullptr;
+  if (output_edge_gid_memory_context) {
+    wholememory_ops::output_memory_handle gen_output_edge_gid_buffer_mh(
+      p_env_fns, output_edge_gid_memory_context);
+    output_edge_gid_ptr =
+      (int64_t*)gen_output_edge_gid_buffer_mh.device_malloc(count, WHOLEMEMORY_DT_INT64);
+  }
+
+  // alias tables of all center nodes, one slot for each neighbor.
+  wholememory_ops::temp_memory_handle alias_prob_tmh(p_env_fns), alias_index_tmh(p_env_fns),
+    alias_worklist_tmh(p_env_fns);
+  double* alias_prob = nullptr;
+  int* alias_index   = nullptr;
+  if (weighted && weight_count > 0) {
+    alias_prob  = (double*)alias_prob_tmh.device_malloc(weight_count, WHOLEMEMORY_DT_DOUBLE);
+    alias_index = (int*)alias_index_tmh.device_malloc(weight_count, WHOLEMEMORY_DT_INT);
+    int* alias_worklist =
+      (int*)alias_worklist_tmh.device_malloc(weight_count, WHOLEMEMORY_DT_INT);
+    build_alias_table_kernel<IdType, int64_t, WeightType>
+      <<<center_node_count, kWithReplacementBlockDim, 0, stream>>>(wm_csr_row_ptr,
+                                                                  wm_csr_row_ptr_desc,
+                                                                  wm_csr_weight_ptr,
+                                                                  wm_csr_weight_ptr_desc,
+                                                                  (const IdType*)center_nodes,
+                                                                  center_node_count,
+                                                                  tmp_weight_offset_mem_pointer,
+                                                                  alias_prob,
+                                                                  alias_index,
+                                                                  alias_worklist);
+    WM_CUDA_CHECK(cudaGetLastError());
+  }
+
+  raft::random::RngState _rngstate(random_seed, 0, raft::random::GeneratorType::GenPC);
+  raft::random::detail::DeviceState<raft::random::detail::PCGenerator> rngstate(_rngstate);
+  sample_with_replacement_kernel<IdType, WMIdType, int64_t>
+    <<<center_node_count, kWithReplacementBlockDim, 0, stream>>>(
+      wm_csr_row_ptr,
+      wm_csr_row_ptr_desc,
+      wm_csr_col_ptr,
+      wm_csr_col_ptr_desc,
+      (const IdType*)center_nodes,
+      center_node_count,
+      max_sample_count,
+      center_fanout,
+      rngstate,
+      (const int*)output_sample_offset,
+      output_sample_offset_desc,
+      alias_prob != nullptr ? tmp_weight_offset_mem_pointer : nullptr,
+      alias_prob,
+      alias_index,
+      output_dest_node_ptr,
+      output_center_localid_ptr,
+      output_edge_gid_ptr);
+  WM_CUDA_CHECK(cudaGetLastError());
+  WM_CUDA_CHECK(cudaStreamSynchronize(stream));
+}
+
+template <typename IdType, typename WMIdType>
+void wholegraph_csr_unweighted_sample_with_replacement_func(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  const int* center_fanout,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  cudaStream_t stream)
+{
+  wholegraph_csr_sample_with_replacement_func<IdType, WMIdType, float>(
+    wm_csr_row_ptr,
+    wm_csr_row_ptr_desc,
+    wm_csr_col_ptr,
+    wm_csr_col_ptr_desc,
+    false,
+    wholememory_gref_t{nullptr, 0},
+    wholememory_array_description_t{},
+    center_nodes,
+    center_nodes_desc,
+    max_sample_count,
+    center_fanout,
+    output_sample_offset,
+    output_sample_offset_desc,
+    output_dest_memory_context,
+    output_center_localid_memory_context,
+    output_edge_gid_memory_context,
+    random_seed,
+    p_env_fns,
+    stream);
+}
+
+template <typename IdType, typename WMIdType, typename WeightType>
+void wholegraph_csr_weighted_sample_with_replacement_func(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  wholememory_gref_t wm_csr_weight_ptr,
+  wholememory_array_description_t wm_csr_weight_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  const int* center_fanout,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  cudaStream_t stream)
+{
+  wholegraph_csr_sample_with_replacement_func<IdType, WMIdType, WeightType>(
+    wm_csr_row_ptr,
+    wm_csr_row_ptr_desc,
+    wm_csr_col_ptr,
+    wm_csr_col_ptr_desc,
+    true,
+    wm_csr_weight_ptr,
+    wm_csr_weight_ptr_desc,
+    center_nodes,
+    center_nodes_desc,
+    max_sample_count,
+    center_fanout,
+    output_sample_offset,
+    output_sample_offset_desc,
+    output_dest_memory_context,
+    output_center_localid_memory_context,
+    output_edge_gid_memory_context,
+    random_seed,
+    p_env_fns,
+    stream);
+}
+
+}  // namespace wholegraph_ops
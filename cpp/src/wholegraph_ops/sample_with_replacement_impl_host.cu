@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <vector>
+
+#include <raft/random/rng_device.cuh>
+#include <raft/random/rng_state.hpp>
+
+#include <wholememory/env_func_ptrs.h>
+#include <wholememory/wholememory.h>
+
+#include "error.hpp"
+#include "logger.hpp"
+#include "parallel_utils.hpp"
+#include "sample_with_replacement_comm.cuh"
+#include "sample_with_replacement_impl.h"
+#include "wholememory_ops/output_memory_handle.hpp"
+#include "wholememory_ops/register.hpp"
+
+namespace wholegraph_ops {
+
+namespace {
+
+constexpr int kMinCenterNodesPerTask = 64;
+
+template <typename WeightType>
+struct host_weight_accessor {
+  WeightType operator[](int64_t neighbor_idx) { return weights[neighbor_idx]; }
+  const WeightType* weights;
+};
+
+template <typename IdType, typename WMIdType, typename WeightType>
+void host_csr_sample_with_replacement_func(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  bool weighted,
+  wholememory_gref_t wm_csr_weight_ptr,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  const int* center_fanout,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns)
+{
+  int center_node_count = center_nodes_desc.size;
+
+  WHOLEMEMORY_EXPECTS(wm_csr_row_ptr_desc.dtype == WHOLEMEMORY_DT_INT64,
+                      "host_csr_sample_with_replacement_func(). "
+                      "wm_csr_row_ptr_desc.dtype != WHOLEMEMORY_DT_INT64, "
+                      "wm_csr_row_ptr_desc.dtype = %d",
+                      wm_csr_row_ptr_desc.dtype);
+  WHOLEMEMORY_EXPECTS(output_sample_offset_desc.dtype == WHOLEMEMORY_DT_INT,
+                      "host_csr_sample_with_replacement_func(). "
+                      "output_sample_offset_desc.dtype != WHOLEMEMORY_DT_INT, "
+                      "output_sample_offset_desc.dtype = %d",
+                      output_sample_offset_desc.dtype);
+  // host graph should be continuous, its global reference is the global pointer.
+  WHOLEMEMORY_CHECK(wm_csr_row_ptr.stride == 0 && wm_csr_col_ptr.stride == 0 &&
+                    wm_csr_weight_ptr.stride == 0);
+
+  auto* csr_row_ptr    = static_cast<const int64_t*>(wm_csr_row_ptr.pointer);
+  auto* csr_col_ptr    = static_cast<const WMIdType*>(wm_csr_col_ptr.pointer);
+  auto* csr_weight_ptr = static_cast<const WeightType*>(wm_csr_weight_ptr.pointer);
+  auto* input_nodes    = static_cast<const IdType*>(center_nodes);
+  auto* sample_offset  = static_cast<int*>(output_sample_offset);
+
+  sample_offset[0] = 0;
+  for (int i = 0; i < center_node_count; i++) {
+    IdType nid           = input_nodes[i];
+    int neighbor_count   = (int)(csr_row_ptr[nid + 1] - csr_row_ptr[nid]);
+    int fanout           = center_fanout != nullptr ? center_fanout[i] : max_sample_count;
+    sample_offset[i + 1] = sample_offset[i] + with_replacement_sample_count(neighbor_count, fanout);
+  }
+  int count = sample_offset[center_node_count];
+
+  wholememory_ops::output_memory_handle gen_output_dest_buffer_mh(p_env_fns,
+                                                                  output_dest_memory_context);
+  auto* output_dest_node_ptr =
+    (WMIdType*)gen_output_dest_buffer_mh.host_malloc(count, wm_csr_col_ptr_desc.dtype);
+
+  int* output_center_localid_ptr = nullptr;
+  if (output_center_localid_memory_context) {
+    wholememory_ops::output_memory_handle gen_output_center_localid_buffer_mh(
+      p_env_fns, output_center_localid_memory_context);
+    output_center_localid_ptr =
+      (int*)gen_output_center_localid_buffer_mh.host_malloc(count, WHOLEMEMORY_DT_INT);
+  }
+
+  int64_t* output_edge_gid_ptr = nullptr;
+  if (output_edge_gid_memory_context) {
+    wholememory_ops::output_memory_handle gen_output_edge_gid_buffer_mh(
+      p_env_fns, output_edge_gid_memory_context);
+    output_edge_gid_ptr =
+      (int64_t*)gen_output_edge_gid_buffer_mh.host_malloc(count, WHOLEMEMORY_DT_INT64);
+  }
+
+  raft::random::RngState _rngstate(random_seed, 0, raft::random::GeneratorType::GenPC);
+  raft::random::detail::DeviceState<raft::random::detail::PCGenerator> rngstate(_rngstate);
+  int task_count = std::min(GetThreadPoolSize(), center_node_count / kMinCenterNodesPerTask);
+  task_count     = std::max(task_count, 1);
+  ThreadPoolRun(task_count, [&](int task_id, int task_num) {
+    int start = (int)((int64_t)center_node_count * task_id / task_num);
+    int end   = (int)((int64_t)center_node_count * (task_id + 1) / task_num);
+    std::vector<double> alias_prob;
+    std::vector<int> alias_index, alias_worklist;
+    for (int input_idx = start; input_idx < end; input_idx++) {
+      IdType nid             = input_nodes[input_idx];
+      int64_t neighbor_start = csr_row_ptr[nid];
+      int neighbor_count     = (int)(csr_row_ptr[nid + 1] - neighbor_start);
+      int offset             = sample_offset[input_idx];
+      int sample_count       = sample_offset[input_idx + 1] - offset;
+      int fanout = center_fanout != nullptr ? center_fanout[input_idx] : max_sample_count;
+      if (sample_count == 0) continue;
+      const double* node_alias_prob = nullptr;
+      const int* node_alias_index   = nullptr;
+      if (weighted && fanout > 0) {
+        alias_prob.resize(neighbor_count);
+        alias_index.resize(neighbor_count);
+        alias_worklist.resize(neighbor_count);
+        host_weight_accessor<WeightType> weights{csr_weight_ptr + neighbor_start};
+        build_alias_table(
+          weights, neighbor_count, alias_prob.data(), alias_index.data(), alias_worklist.data());
+        node_alias_prob  = alias_prob.data();
+        node_alias_index = alias_index.data();
+      }
+      // emulates the threads of device kernel, each with its own random subsequence.
+      for (int tid = 0; tid < kWithReplacementBlockDim && tid < sample_count; tid++) {
+        int gidx = tid + input_idx * kWithReplacementBlockDim;
+        raft::random::detail::PCGenerator rng(rngstate, (uint64_t)gidx);
+        for (int sample_id = tid; sample_id < sample_count;
+             sample_id += kWithReplacementBlockDim) {
+          // fanout <= 0 means sample all.
+          int neighbor_idx =
+            fanout > 0 ? with_replacement_sample_neighbor(
+                           rng, neighbor_count, node_alias_prob, node_alias_index)
+                       : sample_id;
+          int64_t edge_id                          = neighbor_start + neighbor_idx;
+          output_dest_node_ptr[offset + sample_id] = csr_col_ptr[edge_id];
+          if (output_center_localid_ptr) output_center_localid_ptr[offset + sample_id] = input_idx;
+          if (output_edge_gid_ptr) output_edge_gid_ptr[offset + sample_id] = edge_id;
+        }
+      }
+    }
+  });
+}
+
+}  // namespace
+
+template <typename IdType, typename WMIdType>
+void host_csr_unweighted_sample_with_replacement_func(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  const int* center_fanout,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns)
+{
+  host_csr_sample_with_replacement_func<IdType, WMIdType, float>(
+    wm_csr_row_ptr,
+    wm_csr_row_ptr_desc,
+    wm_csr_col_ptr,
+    wm_csr_col_ptr_desc,
+    false,
+    wholememory_gref_t{nullptr, 0},
+    center_nodes,
+    center_nodes_desc,
+    max_sample_count,
+    center_fanout,
+    output_sample_offset,
+    output_sample_offset_desc,
+    output_dest_memory_context,
+    output_center_localid_memory_context,
+    output_edge_gid_memory_context,
+    random_seed,
+    p_env_fns);
+}
+
+template <typename IdType, typename WMIdType, typename WeightType>
+void host_csr_weighted_sample_with_replacement_func(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  wholememory_gref_t wm_csr_weight_ptr,
+  wholememory_array_description_t wm_csr_weight_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  const int* center_fanout,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns)
+{
+  host_csr_sample_with_replacement_func<IdType, WMIdType, WeightType>(
+    wm_csr_row_ptr,
+    wm_csr_row_ptr_desc,
+    wm_csr_col_ptr,
+    wm_csr_col_ptr_desc,
+    true,
+    wm_csr_weight_ptr,
+    center_nodes,
+    center_nodes_desc,
+    max_sample_count,
+    center_fanout,
+    output_sample_offset,
+    output_sample_offset_desc,
+    output_dest_memory_context,
+    output_center_localid_memory_context,
+    output_edge_gid_memory_context,
+    random_seed,
+    p_env_fns);
+}
+
+REGISTER_DISPATCH_TWO_TYPES(HostUnweightedSampleWithReplacementCSR,
+                            host_csr_unweighted_sample_with_replacement_func,
+                            SINT3264,
+                            SINT3264)
+
+wholememory_error_code_t wholegraph_csr_unweighted_sample_with_replacement_host(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  const int* center_fanout,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns)
+{
+  try {
+    DISPATCH_TWO_TYPES(center_nodes_desc.dtype,
+                       wm_csr_col_ptr_desc.dtype,
+                       HostUnweightedSampleWithReplacementCSR,
+                       wm_csr_row_ptr,
+                       wm_csr_row_ptr_desc,
+                       wm_csr_col_ptr,
+                       wm_csr_col_ptr_desc,
+                       center_nodes,
+                       center_nodes_desc,
+                       max_sample_count,
+                       center_fanout,
+                       output_sample_offset,
+                       output_sample_offset_desc,
+                       output_dest_memory_context,
+                       output_center_localid_memory_context,
+                       output_edge_gid_memory_context,
+                       random_seed,
+                       p_env_fns);
+  } catch (const wholememory::logic_error& le) {
+    WHOLEMEMORY_ERROR("LOGIC Error %s\n", le.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+REGISTER_DISPATCH_THREE_TYPES(HostWeightedSampleWithReplacementCSR,
+                              host_csr_weighted_sample_with_replacement_func,
+                              SINT3264,
+                              SINT3264,
+                              FLOAT_DOUBLE)
+
+wholememory_error_code_t wholegraph_csr_weighted_sample_with_replacement_host(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  wholememory_gref_t wm_csr_weight_ptr,
+  wholememory_array_description_t wm_csr_weight_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  const int* center_fanout,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns)
+{
+  try {
+    DISPATCH_THREE_TYPES(center_nodes_desc.dtype,
+                         wm_csr_col_ptr_desc.dtype,
+                         wm_csr_weight_ptr_desc.dtype,
+                         HostWeightedSampleWithReplacementCSR,
+                         wm_csr_row_ptr,
+                         wm_csr_row_ptr_desc,
+                         wm_csr_col_ptr,
+                         wm_csr_col_ptr_desc,
+                         wm_csr_weight_ptr,
+                         wm_csr_weight_ptr_desc,
+                         center_nodes,
+                         center_nodes_desc,
+                         max_sample_count,
+                         center_fanout,
+                         output_sample_offset,
+                         output_sample_offset_desc,
+                         output_dest_memory_context,
+                         output_center_localid_memory_context,
+                         output_edge_gid_memory_context,
+                         random_seed,
+                         p_env_fns);
+  } catch (const wholememory::logic_error& le) {
+    WHOLEMEMORY_ERROR("LOGIC Error %s\n", le.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+}  // namespace wholegraph_ops
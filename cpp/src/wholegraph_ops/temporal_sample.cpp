@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <wholememory/wholegraph_op.h>
+
+#include <wholegraph_ops/sample_comm_host.h>
+#include <wholegraph_ops/temporal_sample_impl.h>
+#include <wholememory_ops/functions/host_gather_scatter_func.h>
+
+#include "error.hpp"
+#include "logger.hpp"
+#include "wholememory/env_func_ptrs.hpp"
+
+wholememory_error_code_t wholegraph_csr_temporal_sample(
+  wholememory_tensor_t wm_csr_row_ptr_tensor,
+  wholememory_tensor_t wm_csr_col_ptr_tensor,
+  wholememory_tensor_t wm_edge_timestamp_tensor,
+  wholememory_tensor_t center_nodes_tensor,
+  wholememory_tensor_t center_timestamps_tensor,
+  int max_sample_count,
+  wholegraph_temporal_sample_mode_t sample_mode,
+  wholememory_tensor_t output_sample_offset_tensor,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  void* stream)
+{
+  wholememory::temp_memory_stream_guard stream_guard(static_cast<cudaStream_t>(stream));
+  bool const csr_row_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_row_ptr_tensor);
+  wholememory_memory_type_t csr_row_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_row_ptr_has_handle) {
+    csr_row_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_row_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_row_ptr_has_handle ||
+                                csr_row_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_row_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+  bool const csr_col_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_col_ptr_tensor);
+  wholememory_memory_type_t csr_col_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_col_ptr_has_handle) {
+    csr_col_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_col_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_col_ptr_has_handle ||
+                                csr_col_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_col_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+  bool const edge_timestamp_has_handle = wholememory_tensor_has_handle(wm_edge_timestamp_tensor);
+  wholememory_memory_type_t edge_timestamp_memory_type = WHOLEMEMORY_MT_NONE;
+  if (edge_timestamp_has_handle) {
+    edge_timestamp_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_edge_timestamp_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!edge_timestamp_has_handle ||
+                                edge_timestamp_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                edge_timestamp_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+
+  auto csr_row_ptr_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_csr_row_ptr_tensor);
+  auto csr_col_ptr_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_csr_col_ptr_tensor);
+  auto edge_timestamp_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_edge_timestamp_tensor);
+  if (csr_row_ptr_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_csr_row_ptr_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (csr_col_ptr_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_csr_col_ptr_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (edge_timestamp_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_edge_timestamp_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t wm_csr_row_ptr_desc, wm_csr_col_ptr_desc, wm_edge_timestamp_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&wm_csr_row_ptr_desc,
+                                                &csr_row_ptr_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_csr_row_ptr_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  if (!wholememory_convert_tensor_desc_to_array(&wm_csr_col_ptr_desc,
+                                                &csr_col_ptr_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_csr_col_ptr_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  if (!wholememory_convert_tensor_desc_to_array(&wm_edge_timestamp_desc,
+                                                &edge_timestamp_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_edge_timestamp_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+
+  wholememory_tensor_description_t center_nodes_tensor_desc =
+    *wholememory_tensor_get_tensor_description(center_nodes_tensor);
+  if (center_nodes_tensor_desc.dim != 1) {
+    WHOLEMEMORY_ERROR("Input center_nodes_tensor should be 1D tensor");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t center_nodes_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&center_nodes_desc, &center_nodes_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Input center_nodes_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+
+  wholememory_tensor_description_t output_sample_offset_tensor_desc =
+    *wholememory_tensor_get_tensor_description(output_sample_offset_tensor);
+  if (output_sample_offset_tensor_desc.dim != 1) {
+    WHOLEMEMORY_ERROR("Output output_sample_offset_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t output_sample_offset_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&output_sample_offset_desc,
+                                                &output_sample_offset_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Output output_sample_offset_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+
+  wholememory_tensor_description_t center_timestamps_tensor_desc =
+    *wholememory_tensor_get_tensor_description(center_timestamps_tensor);
+  if (center_timestamps_tensor_desc.dim != 1) {
+    WHOLEMEMORY_ERROR("Input center_timestamps_tensor should be 1D tensor");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t center_timestamps_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&center_timestamps_desc,
+                                                &center_timestamps_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Input center_timestamps_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  if (center_timestamps_desc.size != center_nodes_desc.size) {
+    WHOLEMEMORY_ERROR(
+      "Input center_timestamps_tensor should have same size as center_nodes_tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (wm_edge_timestamp_desc.dtype != WHOLEMEMORY_DT_INT &&
+      wm_edge_timestamp_desc.dtype != WHOLEMEMORY_DT_INT64) {
+    WHOLEMEMORY_ERROR("wm_edge_timestamp_tensor should be int or int64 tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (center_timestamps_desc.dtype != wm_edge_timestamp_desc.dtype) {
+    WHOLEMEMORY_ERROR(
+      "center_timestamps_tensor should have same dtype as wm_edge_timestamp_tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (sample_mode != WHOLEGRAPH_TSM_UNIFORM && sample_mode != WHOLEGRAPH_TSM_LATEST) {
+    WHOLEMEMORY_ERROR("sample_mode %d not supported.", static_cast<int>(sample_mode));
+    return WHOLEMEMORY_INVALID_VALUE;
+  }
+
+  void* center_nodes         = wholememory_tensor_get_data_pointer(center_nodes_tensor);
+  void* center_timestamps    = wholememory_tensor_get_data_pointer(center_timestamps_tensor);
+  void* output_sample_offset = wholememory_tensor_get_data_pointer(output_sample_offset_tensor);
+  wholememory_gref_t wm_csr_row_ptr_gref, wm_csr_col_ptr_gref, wm_edge_timestamp_gref;
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_csr_row_ptr_tensor, &wm_csr_row_ptr_gref));
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_csr_col_ptr_tensor, &wm_csr_col_ptr_gref));
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_edge_timestamp_tensor, &wm_edge_timestamp_gref));
+
+  if (wholegraph_ops::should_use_host_sample(wm_csr_row_ptr_tensor,
+                                             wm_csr_col_ptr_tensor,
+                                             wm_edge_timestamp_tensor,
+                                             center_nodes,
+                                             output_sample_offset) &&
+      wholememory_ops::is_host_memory_pointer(center_timestamps)) {
+    return wholegraph_ops::wholegraph_csr_temporal_sample_host(
+      wm_csr_row_ptr_gref,
+      wm_csr_row_ptr_desc,
+      wm_csr_col_ptr_gref,
+      wm_csr_col_ptr_desc,
+      wm_edge_timestamp_gref,
+      wm_edge_timestamp_desc,
+      center_nodes,
+      center_nodes_desc,
+      center_timestamps,
+      max_sample_count,
+      sample_mode,
+      output_sample_offset,
+      output_sample_offset_desc,
+      output_dest_memory_context,
+      output_center_localid_memory_context,
+      output_edge_gid_memory_context,
+      random_seed,
+      p_env_fns);
+  }
+  return wholegraph_ops::wholegraph_csr_temporal_sample_mapped(
+    wm_csr_row_ptr_gref,
+    wm_csr_row_ptr_desc,
+    wm_csr_col_ptr_gref,
+    wm_csr_col_ptr_desc,
+    wm_edge_timestamp_gref,
+    wm_edge_timestamp_desc,
+    center_nodes,
+    center_nodes_desc,
+    center_timestamps,
+    max_sample_count,
+    sample_mode,
+    output_sample_offset,
+    output_sample_offset_desc,
+    output_dest_memory_context,
+    output_center_localid_memory_context,
+    output_edge_gid_memory_context,
+    random_seed,
+    p_env_fns,
+    static_cast<cudaStream_t>(stream));
+}
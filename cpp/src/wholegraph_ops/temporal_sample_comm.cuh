@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include <raft/random/rng_device.cuh>
+
+namespace wholegraph_ops {
+
+// Temporal sampling is done by kTemporalSampleBlockDim threads for each center node, thread t of
+// center node i draws random numbers from subsequence t + i * kTemporalSampleBlockDim.
+// Device kernels and host sampling share functions below, so they give the same result.
+constexpr int kTemporalSampleBlockDim = 64;
+
+/**
+ * Count neighbors of center node not later than query time, neighbors should be sorted by time.
+ * @param timestamps : timestamps of neighbors, indexed by neighbor index
+ * @param neighbor_count : neighbor count of center node
+ * @param query_time : query time of center node
+ * @return : count of valid neighbors, which are the first ones
+ */
+template <typename TimeType, typename TimeAccessor>
+__host__ __device__ int temporal_valid_neighbor_count(TimeAccessor& timestamps,
+                                                      int neighbor_count,
+                                                      TimeType query_time)
+{
+  int low  = 0;
+  int high = neighbor_count;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (static_cast<TimeType>(timestamps[mid]) <= query_time) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/**
+ * Sample count of center node.
+ * @param valid_neighbor_count : valid neighbor count of center node
+ * @param max_sample_count : max sample count, max_sample_count <= 0 means sample all valid ones
+ * @return : sample count
+ */
+__host__ __device__ __forceinline__ int temporal_sample_count(int valid_neighbor_count,
+                                                             int max_sample_count)
+{
+  if (max_sample_count > 0 && valid_neighbor_count > max_sample_count) return max_sample_count;
+  return valid_neighbor_count;
+}
+
+/**
+ * Reservoir sampling step of neighbor neighbor_idx, neighbor_idx >= sample count.
+ * Slot s of reservoir keeps the largest neighbor_idx whose step returns s, the result is the same
+ * as sequential reservoir sampling, no matter in which order the steps run.
+ * @param rng : random generator of the sampling thread
+ * @param neighbor_idx : index of valid neighbor
+ * @return : reservoir slot to replace if less than sample count
+ */
+__host__ __device__ __forceinline__ int temporal_reservoir_slot(
+  raft::random::detail::PCGenerator& rng, int neighbor_idx)
+{
+  raft::random::detail::UniformDistParams<int32_t> params;
+  params.start = 0;
+  params.end   = 1;
+  int32_t random_num;
+  raft::random::detail::custom_next(rng, &random_num, params, 0, 0);
+  return random_num % (neighbor_idx + 1);
+}
+
+}  // namespace wholegraph_ops
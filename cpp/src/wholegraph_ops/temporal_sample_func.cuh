@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <thrust/scan.h>
+
+#include <raft/random/rng_device.cuh>
+#include <raft/random/rng_state.hpp>
+#include <raft/util/integer_utils.hpp>
+#include <wholememory/device_reference.cuh>
+#include <wholememory/env_func_ptrs.h>
+#include <wholememory/global_reference.h>
+#include <wholememory/tensor_description.h>
+#include <wholememory/wholegraph_op.h>
+
+#include "wholememory_ops/output_memory_handle.hpp"
+#include "wholememory_ops/temp_memory_handle.hpp"
+#include "wholememory_ops/thrust_allocator.hpp"
+
+#include "cuda_macros.hpp"
+#include "error.hpp"
+#include "temporal_sample_comm.cuh"
+
+namespace wholegraph_ops {
+
+template <typename TimeType>
+struct device_timestamp_accessor {
+  __device__ __forceinline__ TimeType operator[](int neighbor_idx)
+  {
+    return timestamp_ref[start + neighbor_idx];
+  }
+  wholememory::device_reference<TimeType> timestamp_ref;
+  int64_t start;
+};
+
+template <typename IdType, typename TimeType, typename WMOffsetType>
+__global__ void get_temporal_sample_count_kernel(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_edge_timestamp_ptr,
+  const IdType* input_nodes,
+  const TimeType* input_timestamps,
+  const int input_node_count,
+  const int max_sample_count,
+  int* tmp_sample_count_mem_pointer,
+  int* tmp_valid_count_mem_pointer)
+{
+  int gidx      = threadIdx.x + blockIdx.x * blockDim.x;
+  int input_idx = gidx;
+  if (input_idx >= input_node_count) return;
+  IdType nid = input_nodes[input_idx];
+  wholememory::device_reference<WMOffsetType> wm_csr_row_ptr_dev_ref(wm_csr_row_ptr);
+  int64_t start      = wm_csr_row_ptr_dev_ref[nid];
+  int64_t end        = wm_csr_row_ptr_dev_ref[nid + 1];
+  int neighbor_count = (int)(end - start);
+  device_timestamp_accessor<TimeType> timestamps{
+    wholememory::device_reference<TimeType>(wm_edge_timestamp_ptr), start};
+  int valid_count =
+    temporal_valid_neighbor_count(timestamps, neighbor_count, input_timestamps[input_idx]);
+  tmp_valid_count_mem_pointer[input_idx]  = valid_count;
+  tmp_sample_count_mem_pointer[input_idx] = temporal_sample_count(valid_count, max_sample_count);
+}
+
+template <typename IdType, typename WMIdType, typename WMOffsetType>
+__launch_bounds__(kTemporalSampleBlockDim) __global__ void temporal_sample_kernel(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  const IdType* input_nodes,
+  const int input_node_count,
+  const int* valid_count,
+  wholegraph_temporal_sample_mode_t sample_mode,
+  raft::random::detail::DeviceState<raft::random::detail::PCGenerator> rngstate,
+  const int* sample_offset,
+  wholememory_array_description_t sample_offset_desc,
+  int* reservoir,
+  WMIdType* output,
+  int* src_lid,
+  int64_t* output_edge_gid_ptr)
+{
+  int input_idx = blockIdx.x;
+  if (input_idx >= input_node_count) return;
+  int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  wholememory::device_reference<WMOffsetType> csr_row_ptr_gen(wm_csr_row_ptr);
+  wholememory::device_reference<WMIdType> csr_col_ptr_gen(wm_csr_col_ptr);
+
+  IdType nid       = input_nodes[input_idx];
+  int64_t start    = csr_row_ptr_gen[nid];
+  int N            = valid_count[input_idx];
+  int offset       = sample_offset[input_idx];
+  int sample_count = sample_offset[input_idx + 1] - offset;
+  // valid neighbors are the first N ones, the latest ones are the last sample_count of them.
+  int first_idx          = sample_mode == WHOLEGRAPH_TSM_LATEST ? N - sample_count : 0;
+  bool const need_random = sample_mode == WHOLEGRAPH_TSM_UNIFORM && sample_count < N;
+  if (need_random) {
+    raft::random::detail::PCGenerator rng(rngstate, (uint64_t)gidx);
+    for (int sample_id = threadIdx.x; sample_id < sample_count; sample_id += blockDim.x) {
+      reservoir[offset + sample_id] = sample_id;
+    }
+    __syncthreads();
+    for (int idx = sample_count + threadIdx.x; idx < N; idx += blockDim.x) {
+      int slot = temporal_reservoir_slot(rng, idx);
+      if (slot < sample_count) atomicMax(reservoir + offset + slot, idx);
+    }
+    __syncthreads();
+  }
+  for (int sample_id = threadIdx.x; sample_id < sample_count; sample_id += blockDim.x) {
+    int neighbor_idx = need_random ? reservoir[offset + sample_id] : first_idx + sample_id;
+    if (src_lid) src_lid[offset + sample_id] = input_idx;
+    output[offset + sample_id] = csr_col_ptr_gen[start + neighbor_idx];
+    if (output_edge_gid_ptr) {
+      output_edge_gid_ptr[offset + sample_id] = (int64_t)(start + neighbor_idx);
+    }
+  }
+}
+
+template <typename IdType, typename WMIdType, typename TimeType>
+void wholegraph_csr_temporal_sample_func(wholememory_gref_t wm_csr_row_ptr,
+                                         wholememory_array_description_t wm_csr_row_ptr_desc,
+                                         wholememory_gref_t wm_csr_col_ptr,
+                                         wholememory_array_description_t wm_csr_col_ptr_desc,
+                                         wholememory_gref_t wm_edge_timestamp_ptr,
+                                         wholememory_array_description_t wm_edge_timestamp_ptr_desc,
+                                         void* center_nodes,
+                                         wholememory_array_description_t center_nodes_desc,
+                                         void* center_timestamps,
+                                         int max_sample_count,
+                                         wholegraph_temporal_sample_mode_t sample_mode,
+                                         void* output_sample_offset,
+                                         wholememory_array_description_t output_sample_offset_desc,
+                                         void* output_dest_memory_context,
+                                         void* output_center_localid_memory_context,
+                                         void* output_edge_gid_memory_context,
+                                         unsigned long long random_seed,
+                                         wholememory_env_func_t* p_env_fns,
+                                         cudaStream_t stream)
+{
+  int center_node_count = center_nodes_desc.size;
+
+  WHOLEMEMORY_EXPECTS(wm_csr_row_ptr_desc.dtype == WHOLEMEMORY_DT_INT64,
+                      "wholegraph_csr_temporal_sample_func(). "
+                      "wm_csr_row_ptr_desc.dtype != WHOLEMEMORY_DT_INT64, "
+                      "wm_csr_row_ptr_desc.dtype = %d",
+                      wm_csr_row_ptr_desc.dtype);
+  WHOLEMEMORY_EXPECTS(output_sample_offset_desc.dtype == WHOLEMEMORY_DT_INT,
+                      "wholegraph_csr_temporal_sample_func(). "
+                      "output_sample_offset_desc.dtype != WHOLEMEMORY_DT_INT, "
+                      "output_sample_offset_desc.dtype = %d",
+                      output_sample_offset_desc.dtype);
+
+  wholememory_ops::temp_memory_handle gen_buffer_tmh(p_env_fns);
+  int* tmp_sample_count_mem_pointer =
+    (int*)gen_buffer_tmh.device_malloc(center_node_count + 1, WHOLEMEMORY_DT_INT);
+  wholememory_ops::temp_memory_handle valid_count_tmh(p_env_fns);
+  int* tmp_valid_count_mem_pointer =
+    (int*)valid_count_tmh.device_malloc(center_node_count, WHOLEMEMORY_DT_INT);
+
+  int thread_x    = 32;
+  int block_count = raft::div_rounding_up_safe<int>(center_node_count, thread_x);
+  get_temporal_sample_count_kernel<IdType, TimeType, int64_t>
+    <<<block_count, thread_x, 0, stream>>>(wm_csr_row_ptr,
+                                           wm_csr_row_ptr_desc,
+                                           wm_edge_timestamp_ptr,
+                                           (const IdType*)center_nodes,
+                                           (const TimeType*)center_timestamps,
+                                           center_node_count,
+                                           max_sample_count,
+                                           tmp_sample_count_mem_pointer,
+                                           tmp_valid_count_mem_pointer);
+  WM_CUDA_CHECK(cudaGetLastError());
+
+  // prefix sum
+  wholememory_ops::wm_thrust_allocator thrust_allocator(p_env_fns);
+  thrust::exclusive_scan(thrust::cuda::par(thrust_allocator).on(stream),
+                         tmp_sample_count_mem_pointer,
+                         tmp_sample_count_mem_pointer + center_node_count + 1,
+                         (int*)output_sample_offset);
+
+  int count;
+  WM_CUDA_CHECK(cudaMemcpyAsync(&count,
+                                ((int*)output_sample_offset) + center_node_count,
+                                sizeof(int),
+                                cudaMemcpyDeviceToHost,
+                                stream));
+  WM_CUDA_CHECK(cudaStreamSynchronize(stream));
+
+  wholememory_ops::output_memory_handle gen_output_dest_buffer_mh(p_env_fns,
+                                                                  output_dest_memory_context);
+  WMIdType* output_dest_node_ptr =
+    (WMIdType*)gen_output_dest_buffer_mh.device_malloc(count, wm_csr_col_ptr_desc.dtype);
+
+  int* output_center_localid_ptr = nullptr;
+  if (output_center_localid_memory_context) {
+    wholememory_ops::output_memory_handle gen_output_center_localid_buffer_mh(
+      p_env_fns, output_center_localid_memory_context);
+    output_center_localid_ptr =
+      (int*)gen_output_center_localid_buffer_mh.device_malloc(count, WHOLEMEMORY_DT_INT);
+  }
+
+  int64_t* output_edge_gid_ptr = nullptr;
+  if (output_edge_gid_memory_context) {
+    wholememory_ops::output_memory_handle gen_output_edge_gid_buffer_mh(
+      p_env_fns, output_edge_gid_memory_context);
+    output_edge_gid_ptr =
+      (int64_t*)gen_output_edge_gid_buffer_mh.device_malloc(count, WHOLEMEMORY_DT_INT64);
+  }
+
+  // reservoir of sampled neighbor indices, only used in uniform mode.
+  wholememory_ops::temp_memory_handle reservoir_tmh(p_env_fns);
+  int* reservoir = nullptr;
+  if (sample_mode == WHOLEGRAPH_TSM_UNIFORM) {
+    reservoir = (int*)reservoir_tmh.device_malloc(count, WHOLEMEMORY_DT_INT);
+  }
+
+  raft::random::RngState _rngstate(random_seed, 0, raft::random::GeneratorType::GenPC);
+  raft::random::detail::DeviceState<raft::random::detail::PCGenerator> rngstate(_rngstate);
+  temporal_sample_kernel<IdType, WMIdType, int64_t>
+    <<<center_node_count, kTemporalSampleBlockDim, 0, stream>>>(wm_csr_row_ptr,
+                                                                wm_csr_row_ptr_desc,
+                                                                wm_csr_col_ptr,
+                                                                wm_csr_col_ptr_desc,
+                                                                (const IdType*)center_nodes,
+                                                                center_node_count,
+                                                                tmp_valid_count_mem_pointer,
+                                                                sample_mode,
+                                                                rngstate,
+                                                                (const int*)output_sample_offset,
+                                                                output_sample_offset_desc,
+                                                                reservoir,
+                                                                output_dest_node_ptr,
+                                                                output_center_localid_ptr,
+                                                                output_edge_gid_ptr);
+  WM_CUDA_CHECK(cudaGetLastError());
+  WM_CUDA_CHECK(cudaStreamSynchronize(stream));
+}
+
+}  // namespace wholegraph_ops
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <wholememory/wholegraph_op.h>
+
+#include <graph_ops/append_unique_impl.h>
+#include <wholegraph_ops/sample_comm_host.h>
+#include <wholegraph_ops/unweighted_sample_without_replacement_impl.h>
+#include <wholememory_ops/functions/host_gather_scatter_func.h>
+
+#include "error.hpp"
+#include "logger.hpp"
+#include "wholememory/env_func_ptrs.hpp"
+#include "wholememory_ops/output_memory_handle.hpp"
+
+namespace {
+
+// Outputs of sampling and append unique of each hop are allocated by these allocators through
+// hop_output_malloc, so intermediate results go to scratch memory or straight to final outputs.
+class hop_output_allocator {
+ public:
+  virtual ~hop_output_allocator() = default;
+  virtual void* malloc(wholememory_tensor_description_t* tensor_desc,
+                       wholememory_memory_allocation_type_t memory_allocation_type) = 0;
+};
+
+void* hop_output_malloc(wholememory_tensor_description_t* tensor_desc,
+                        wholememory_memory_allocation_type_t memory_allocation_type,
+                        void* memory_context,
+                        void* /*global_context*/)
+{
+  return static_cast<hop_output_allocator*>(memory_context)
+    ->malloc(tensor_desc, memory_allocation_type);
+}
+
+// memory is owned by allocators.
+void hop_output_free(void* /*memory_context*/, void* /*global_context*/) {}
+
+// Allocates from output memory functions of caller.
+class caller_output_allocator : public hop_output_allocator {
+ public:
+  caller_output_allocator(wholememory_env_func_t* p_env_fns, void* memory_context)
+    : output_mem_fns_(&p_env_fns->output_fns), memory_context_(memory_context)
+  {
+  }
+  void* malloc(wholememory_tensor_description_t* tensor_desc,
+               wholememory_memory_allocation_type_t memory_allocation_type) override
+  {
+    tensor_desc_ = *tensor_desc;
+    ptr_         = output_mem_fns_->malloc_fn(
+      tensor_desc, memory_allocation_type, memory_context_, output_mem_fns_->global_context);
+    return ptr_;
+  }
+  [[nodiscard]] void* pointer() const { return ptr_; }
+  [[nodiscard]] int64_t element_count() const { return tensor_desc_.sizes[0]; }
+
+ private:
+  wholememory_output_memory_func_t* output_mem_fns_ = nullptr;
+  void* memory_context_                             = nullptr;
+  wholememory_tensor_description_t tensor_desc_{};
+  void* ptr_ = nullptr;
+};
+
+// Center local ids of sampled nodes go to row 1 of edge_indice output, which is allocated as int
+// tensor of 2 x sample count. Row 0 is filled by append unique.
+class edge_indice_allocator : public caller_output_allocator {
+ public:
+  using caller_output_allocator::caller_output_allocator;
+  void* malloc(wholememory_tensor_description_t* tensor_desc,
+               wholememory_memory_allocation_type_t memory_allocation_type) override
+  {
+    WHOLEMEMORY_CHECK(tensor_desc->dim == 1 && tensor_desc->dtype == WHOLEMEMORY_DT_INT);
+    sample_count_ = tensor_desc->sizes[0];
+    wholememory_tensor_description_t edge_indice_desc;
+    wholememory_initialize_tensor_desc(&edge_indice_desc);
+    edge_indice_desc.dim        = 2;
+    edge_indice_desc.dtype      = WHOLEMEMORY_DT_INT;
+    edge_indice_desc.sizes[0]   = 2;
+    edge_indice_desc.sizes[1]   = sample_count_;
+    edge_indice_desc.strides[0] = sample_count_;
+    edge_indice_desc.strides[1] = 1;
+    auto* edge_indice =
+      static_cast<int*>(caller_output_allocator::malloc(&edge_indice_desc, memory_allocation_type));
+    return edge_indice + sample_count_;
+  }
+  [[nodiscard]] int64_t sample_count() const { return sample_count_; }
+  [[nodiscard]] int* raw_to_unique_mapping() const { return static_cast<int*>(pointer()); }
+
+ private:
+  int64_t sample_count_ = 0;
+};
+
+// Temporary memory reused by all hops, only reallocated when a hop needs more.
+class scratch_allocator : public hop_output_allocator {
+ public:
+  explicit scratch_allocator(wholememory_env_func_t* p_env_fns)
+    : temp_mem_fns_(&p_env_fns->temporary_fns)
+  {
+  }
+  ~scratch_allocator() override { free_memory(); }
+  scratch_allocator(const scratch_allocator&)            = delete;
+  scratch_allocator& operator=(const scratch_allocator&) = delete;
+  void* malloc(wholememory_tensor_description_t* tensor_desc,
+               wholememory_memory_allocation_type_t memory_allocation_type) override
+  {
+    size_t size = wholememory_get_memory_size_from_tensor(tensor_desc);
+    if (ptr_ != nullptr && size <= capacity_ && memory_allocation_type == allocation_type_) {
+      return ptr_;
+    }
+    free_memory();
+    wholememory_tensor_description_t scratch_desc;
+    wholememory_initialize_tensor_desc(&scratch_desc);
+    scratch_desc.dim        = 1;
+    scratch_desc.dtype      = WHOLEMEMORY_DT_INT8;
+    scratch_desc.sizes[0]   = static_cast<int64_t>(size);
+    scratch_desc.strides[0] = 1;
+    temp_mem_fns_->create_memory_context_fn(&memory_context_, temp_mem_fns_->global_context);
+    ptr_ = temp_mem_fns_->malloc_fn(
+      &scratch_desc, memory_allocation_type, memory_context_, temp_mem_fns_->global_context);
+
+    capacity_        = size;
+    allocation_type_ = memory_allocation_type;
+    return ptr_;
+  }
+  [[nodiscard]] void* pointer() const { return ptr_; }
+
+ private:
+  void free_memory()
+  {
+    if (memory_context_ == nullptr) return;
+    temp_mem_fns_->free_fn(memory_context_, temp_mem_fns_->global_context);
+    temp_mem_fns_->destroy_memory_context_fn(memory_context_, temp_mem_fns_->global_context);
+    memory_context_ = nullptr;
+    ptr_            = nullptr;
+    capacity_       = 0;
+  }
+
+  wholememory_temp_memory_func_t* temp_mem_fns_         = nullptr;
+  void* memory_context_                                 = nullptr;
+  void* ptr_                                            = nullptr;
+  size_t capacity_                                      = 0;
+  wholememory_memory_allocation_type_t allocation_type_ = WHOLEMEMORY_MA_NONE;
+};
+
+}  // namespace
+
+wholememory_error_code_t wholegraph_csr_unweighted_multilayer_sample_without_replacement(
+  wholememory_tensor_t wm_csr_row_ptr_tensor,
+  wholememory_tensor_t wm_csr_col_ptr_tensor,
+  wholememory_tensor_t center_nodes_tensor,
+  const int* max_sample_counts,
+  int hop_count,
+  void** output_target_nodes_memory_contexts,
+  void** output_csr_row_ptr_memory_contexts,
+  void** output_edge_indice_memory_contexts,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns,
+  void* stream)
+{
+  wholememory::temp_memory_stream_guard stream_guard(static_cast<cudaStream_t>(stream));
+  if (max_sample_counts == nullptr || hop_count <= 0) {
+    WHOLEMEMORY_ERROR("max_sample_counts should have at least one hop.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (output_target_nodes_memory_contexts == nullptr ||
+      output_csr_row_ptr_memory_contexts == nullptr ||
+      output_edge_indice_memory_contexts == nullptr) {
+    WHOLEMEMORY_ERROR("output memory contexts of all hops should be provided.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  bool const csr_row_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_row_ptr_tensor);
+  wholememory_memory_type_t csr_row_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_row_ptr_has_handle) {
+    csr_row_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_row_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_row_ptr_has_handle ||
+                                csr_row_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_row_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+  bool const csr_col_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_col_ptr_tensor);
+  wholememory_memory_type_t csr_col_ptr_memory_type = WHOLEMEMORY_MT_NONE;
+  if (csr_col_ptr_has_handle) {
+    csr_col_ptr_memory_type =
+      wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wm_csr_col_ptr_tensor));
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(!csr_col_ptr_has_handle ||
+                                csr_col_ptr_memory_type == WHOLEMEMORY_MT_CHUNKED ||
+                                csr_col_ptr_memory_type == WHOLEMEMORY_MT_CONTINUOUS,
+                              "Memory type not supported.");
+
+  auto csr_row_ptr_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_csr_row_ptr_tensor);
+  auto csr_col_ptr_tensor_description =
+    *wholememory_tensor_get_tensor_description(wm_csr_col_ptr_tensor);
+  if (csr_row_ptr_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_csr_row_ptr_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (csr_col_ptr_tensor_description.dim != 1) {
+    WHOLEMEMORY_ERROR("wm_csr_col_ptr_tensor should be 1D tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t wm_csr_row_ptr_desc, wm_csr_col_ptr_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&wm_csr_row_ptr_desc,
+                                                &csr_row_ptr_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_csr_row_ptr_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  if (!wholememory_convert_tensor_desc_to_array(&wm_csr_col_ptr_desc,
+                                                &csr_col_ptr_tensor_description)) {
+    WHOLEMEMORY_ERROR("Input wm_csr_col_ptr_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+
+  wholememory_tensor_description_t center_nodes_tensor_desc =
+    *wholememory_tensor_get_tensor_description(center_nodes_tensor);
+  if (center_nodes_tensor_desc.dim != 1) {
+    WHOLEMEMORY_ERROR("Input center_nodes_tensor should be 1D tensor");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_array_description_t center_nodes_desc;
+  if (!wholememory_convert_tensor_desc_to_array(&center_nodes_desc, &center_nodes_tensor_desc)) {
+    WHOLEMEMORY_ERROR("Input center_nodes_tensor convert to array failed.");
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  // target nodes of each hop are center nodes of next hop, and include sampled nodes.
+  if (center_nodes_desc.dtype != wm_csr_col_ptr_desc.dtype) {
+    WHOLEMEMORY_ERROR("center_nodes_tensor should have same dtype as wm_csr_col_ptr_tensor.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+
+  void* center_nodes = wholememory_tensor_get_data_pointer(center_nodes_tensor);
+
+  wholememory_gref_t wm_csr_row_ptr_gref, wm_csr_col_ptr_gref;
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_csr_row_ptr_tensor, &wm_csr_row_ptr_gref));
+  WHOLEMEMORY_RETURN_ON_FAIL(
+    wholememory_tensor_get_global_reference(wm_csr_col_ptr_tensor, &wm_csr_col_ptr_gref));
+
+  bool const use_host = wholegraph_ops::is_host_graph_tensor(wm_csr_row_ptr_tensor) &&
+                        wholegraph_ops::is_host_graph_tensor(wm_csr_col_ptr_tensor) &&
+                        wholememory_ops::is_host_memory_pointer(center_nodes);
+
+  try {
+    // outputs of hops are redirected to hop_output_allocator, temporary memory is unchanged.
+    wholememory_env_func_t hop_env_fns    = *p_env_fns;
+    hop_env_fns.output_fns.malloc_fn      = hop_output_malloc;
+    hop_env_fns.output_fns.free_fn        = hop_output_free;
+    hop_env_fns.output_fns.global_context = nullptr;
+    scratch_allocator sampled_nodes_allocator(p_env_fns);
+
+    void* hop_center_nodes                                = center_nodes;
+    wholememory_array_description_t hop_center_nodes_desc = center_nodes_desc;
+    for (int hop = 0; hop < hop_count; hop++) {
+      int64_t sample_offset_count = hop_center_nodes_desc.size + 1;
+      auto output_sample_offset_desc =
+        wholememory_create_array_desc(sample_offset_count, 0, WHOLEMEMORY_DT_INT);
+      wholememory_ops::output_memory_handle output_sample_offset_mh(
+        p_env_fns, output_csr_row_ptr_memory_contexts[hop]);
+      void* output_sample_offset =
+        use_host ? output_sample_offset_mh.host_malloc(sample_offset_count, WHOLEMEMORY_DT_INT)
+                 : output_sample_offset_mh.device_malloc(sample_offset_count, WHOLEMEMORY_DT_INT);
+      edge_indice_allocator edge_indice(p_env_fns, output_edge_indice_memory_contexts[hop]);
+      caller_output_allocator target_nodes(p_env_fns, output_target_nodes_memory_contexts[hop]);
+      unsigned long long hop_random_seed = random_seed + hop;
+
+      if (use_host) {
+        WHOLEMEMORY_RETURN_ON_FAIL(
+          wholegraph_ops::wholegraph_csr_unweighted_sample_without_replacement_host(
+            wm_csr_row_ptr_gref,
+            wm_csr_row_ptr_desc,
+            wm_csr_col_ptr_gref,
+            wm_csr_col_ptr_desc,
+            hop_center_nodes,
+            hop_center_nodes_desc,
+            max_sample_counts[hop],
+            output_sample_offset,
+            output_sample_offset_desc,
+            &sampled_nodes_allocator,
+            &edge_indice,
+            nullptr,
+            hop_random_seed,
+            &hop_env_fns));
+      } else {
+        WHOLEMEMORY_RETURN_ON_FAIL(
+          wholegraph_ops::wholegraph_csr_unweighted_sample_without_replacement_mapped(
+            wm_csr_row_ptr_gref,
+            wm_csr_row_ptr_desc,
+            wm_csr_col_ptr_gref,
+            wm_csr_col_ptr_desc,
+            hop_center_nodes,
+            hop_center_nodes_desc,
+            max_sample_counts[hop],
+            output_sample_offset,
+            output_sample_offset_desc,
+            &sampled_nodes_allocator,
+            &edge_indice,
+            nullptr,
+            hop_random_seed,
+            &hop_env_fns,
+            static_cast<cudaStream_t>(stream)));
+      }
+
+      auto sampled_nodes_desc =
+        wholememory_create_array_desc(edge_indice.sample_count(), 0, wm_csr_col_ptr_desc.dtype);
+      if (use_host) {
+        WHOLEMEMORY_RETURN_ON_FAIL(
+          graph_ops::graph_append_unique_host_impl(hop_center_nodes,
+                                                   hop_center_nodes_desc,
+                                                   sampled_nodes_allocator.pointer(),
+                                                   sampled_nodes_desc,
+                                                   &target_nodes,
+                                                   edge_indice.raw_to_unique_mapping(),
+                                                   &hop_env_fns));
+      } else {
+        WHOLEMEMORY_RETURN_ON_FAIL(
+          graph_ops::graph_append_unique_impl(hop_center_nodes,
+                                              hop_center_nodes_desc,
+                                              sampled_nodes_allocator.pointer(),
+                                              sampled_nodes_desc,
+                                              &target_nodes,
+                                              edge_indice.raw_to_unique_mapping(),
+                                              &hop_env_fns,
+                                              static_cast<cudaStream_t>(stream)));
+      }
+
+      hop_center_nodes = target_nodes.pointer();
+      hop_center_nodes_desc =
+        wholememory_create_array_desc(target_nodes.element_count(), 0, center_nodes_desc.dtype);
+    }
+  } catch (const wholememory::logic_error& le) {
+    WHOLEMEMORY_ERROR("LOGIC Error %s\n", le.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_UNKNOW_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
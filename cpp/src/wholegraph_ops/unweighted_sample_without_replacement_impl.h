@@ -37,4 +37,25 @@ wholememory_error_code_t wholegraph_csr_unweighted_sample_without_replacement_ma
   unsigned long long random_seed,
   wholememory_env_func_t* p_env_fns,
   cudaStream_t stream);
+
+/**
+ * Host version of wholegraph_csr_unweighted_sample_without_replacement_mapped, runs on host thread
+ * pool and gives same result as the device version. Graph should be continuous host memory, center
+ * nodes and output sample offset should be host memory, outputs are allocated as host memory.
+ */
+wholememory_error_code_t wholegraph_csr_unweighted_sample_without_replacement_host(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns);
 }  // namespace wholegraph_ops
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <raft/random/rng_device.cuh>
+#include <raft/random/rng_state.hpp>
+
+#include <wholememory/env_func_ptrs.h>
+#include <wholememory/wholememory.h>
+
+#include "error.hpp"
+#include "logger.hpp"
+#include "parallel_utils.hpp"
+#include "unweighted_sample_without_replacement_impl.h"
+#include "wholememory_ops/output_memory_handle.hpp"
+#include "wholememory_ops/register.hpp"
+
+namespace wholegraph_ops {
+
+namespace {
+
+// Launch config of unweighted_sample_without_replacement_kernel for each 32 of max_sample_count,
+// random numbers are drawn the same way, so host and device sampling give same result.
+constexpr int kWarpCountArray[32]      = {1, 1, 1, 2, 2, 2, 4, 4, 4, 4, 4, 4, 8, 8, 8, 8,
+                                          8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8};
+constexpr int kItemsPerThreadArray[32] = {1, 2, 3, 2, 3, 3, 2, 2, 3, 3, 3, 3, 2, 2, 2, 2,
+                                          3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+constexpr int kMaxSmallSampleCount     = 1024;
+constexpr int kLargeSampleBlockDim     = 32;
+constexpr int kMinCenterNodesPerTask   = 64;
+
+using rng_state_t = raft::random::detail::DeviceState<raft::random::detail::PCGenerator>;
+
+// Buffers of each task, reused by all center nodes of the task.
+struct host_sample_buffers {
+  std::vector<int32_t> random_index;
+  // identity permutation of neighbor index, restored after each center node.
+  std::vector<int> permutation;
+  std::vector<int> sample_index;
+};
+
+int32_t next_random_int(raft::random::detail::PCGenerator& rng)
+{
+  raft::random::detail::UniformDistParams<int32_t> params;
+  params.start = 0;
+  params.end   = 1;
+  int32_t random_num;
+  raft::random::detail::custom_next(rng, &random_num, params, 0, 0);
+  return random_num;
+}
+
+// Selects max_sample_count of neighbor_count neighbor indices to buffers->sample_index.
+void host_sample_neighbor_index(int input_idx,
+                                int neighbor_count,
+                                int max_sample_count,
+                                const rng_state_t& rngstate,
+                                host_sample_buffers* buffers)
+{
+  int const M        = max_sample_count;
+  int const N        = neighbor_count;
+  auto& sample_index = buffers->sample_index;
+  sample_index.resize(M);
+  if (M > kMaxSmallSampleCount) {
+    // large_sample_kernel, each slot keeps the largest index chosen for it.
+    std::iota(sample_index.begin(), sample_index.end(), 0);
+    for (int tid = 0; tid < kLargeSampleBlockDim; tid++) {
+      int gidx = tid + input_idx * kLargeSampleBlockDim;
+      raft::random::detail::PCGenerator rng(rngstate, (uint64_t)gidx);
+      for (int idx = M + tid; idx < N; idx += kLargeSampleBlockDim) {
+        int32_t rand_num = next_random_int(rng) % (idx + 1);
+        if (rand_num < M) { sample_index[rand_num] = std::max(sample_index[rand_num], idx); }
+      }
+    }
+    return;
+  }
+  int const func_idx         = (M - 1) / 32;
+  int const block_dim        = kWarpCountArray[func_idx] * 32;
+  int const items_per_thread = kItemsPerThreadArray[func_idx];
+  auto& random_index         = buffers->random_index;
+  random_index.resize(M);
+  for (int tid = 0; tid < block_dim; tid++) {
+    int gidx = tid + input_idx * block_dim;
+    raft::random::detail::PCGenerator rng(rngstate, (uint64_t)gidx);
+    for (int i = 0; i < items_per_thread; i++) {
+      int idx          = i * block_dim + tid;
+      int32_t rand_num = next_random_int(rng);
+      if (idx < M) random_index[idx] = rand_num % (N - idx);
+    }
+  }
+  auto& permutation = buffers->permutation;
+  if (static_cast<int>(permutation.size()) < N) {
+    size_t old_size = permutation.size();
+    permutation.resize(N);
+    std::iota(permutation.begin() + old_size, permutation.end(), static_cast<int>(old_size));
+  }
+  for (int i = 0; i < M; i++) {
+    sample_index[i]              = permutation[random_index[i]];
+    permutation[random_index[i]] = permutation[N - i - 1];
+  }
+  for (int i = 0; i < M; i++) {
+    permutation[random_index[i]] = random_index[i];
+  }
+}
+
+}  // namespace
+
+template <typename IdType, typename WMIdType>
+void host_csr_unweighted_sample_without_replacement_func(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns)
+{
+  int center_node_count = center_nodes_desc.size;
+
+  WHOLEMEMORY_EXPECTS(wm_csr_row_ptr_desc.dtype == WHOLEMEMORY_DT_INT64,
+                      "host_csr_unweighted_sample_without_replacement_func(). "
+                      "wm_csr_row_ptr_desc.dtype != WHOLEMEMORY_DT_INT64, "
+                      "wm_csr_row_ptr_desc.dtype = %d",
+                      wm_csr_row_ptr_desc.dtype);
+  WHOLEMEMORY_EXPECTS(output_sample_offset_desc.dtype == WHOLEMEMORY_DT_INT,
+                      "host_csr_unweighted_sample_without_replacement_func(). "
+                      "output_sample_offset_desc.dtype != WHOLEMEMORY_DT_INT, "
+                      "output_sample_offset_desc.dtype = %d",
+                      output_sample_offset_desc.dtype);
+  // host graph should be continuous, its global reference is the global pointer.
+  WHOLEMEMORY_CHECK(wm_csr_row_ptr.stride == 0 && wm_csr_col_ptr.stride == 0);
+
+  auto* csr_row_ptr   = static_cast<const int64_t*>(wm_csr_row_ptr.pointer);
+  auto* csr_col_ptr   = static_cast<const WMIdType*>(wm_csr_col_ptr.pointer);
+  auto* input_nodes   = static_cast<const IdType*>(center_nodes);
+  auto* sample_offset = static_cast<int*>(output_sample_offset);
+
+  sample_offset[0] = 0;
+  for (int i = 0; i < center_node_count; i++) {
+    IdType nid         = input_nodes[i];
+    int neighbor_count = (int)(csr_row_ptr[nid + 1] - csr_row_ptr[nid]);
+    // sample_count <= 0 means sample all.
+    if (max_sample_count > 0) { neighbor_count = std::min(neighbor_count, max_sample_count); }
+    sample_offset[i + 1] = sample_offset[i] + neighbor_count;
+  }
+  int count = sample_offset[center_node_count];
+
+  wholememory_ops::output_memory_handle gen_output_dest_buffer_mh(p_env_fns,
+                                                                  output_dest_memory_context);
+  auto* output_dest_node_ptr =
+    (WMIdType*)gen_output_dest_buffer_mh.host_malloc(count, wm_csr_col_ptr_desc.dtype);
+
+  int* output_center_localid_ptr = nullptr;
+  if (output_center_localid_memory_context) {
+    wholememory_ops::output_memory_handle gen_output_center_localid_buffer_mh(
+      p_env_fns, output_center_localid_memory_context);
+    output_center_localid_ptr =
+      (int*)gen_output_center_localid_buffer_mh.host_malloc(count, WHOLEMEMORY_DT_INT);
+  }
+
+  int64_t* output_edge_gid_ptr = nullptr;
+  if (output_edge_gid_memory_context) {
+    wholememory_ops::output_memory_handle gen_output_edge_gid_buffer_mh(
+      p_env_fns, output_edge_gid_memory_context);
+    output_edge_gid_ptr =
+      (int64_t*)gen_output_edge_gid_buffer_mh.host_malloc(count, WHOLEMEMORY_DT_INT64);
+  }
+
+  raft::random::RngState _rngstate(random_seed, 0, raft::random::GeneratorType::GenPC);
+  rng_state_t rngstate(_rngstate);
+  int task_count = std::min(GetThreadPoolSize(), center_node_count / kMinCenterNodesPerTask);
+  task_count     = std::max(task_count, 1);
+  ThreadPoolRun(task_count, [&](int task_id, int task_num) {
+    int start = (int)((int64_t)center_node_count * task_id / task_num);
+    int end   = (int)((int64_t)center_node_count * (task_id + 1) / task_num);
+    host_sample_buffers buffers;
+    for (int input_idx = start; input_idx < end; input_idx++) {
+      IdType nid              = input_nodes[input_idx];
+      int64_t neighbor_start  = csr_row_ptr[nid];
+      int offset              = sample_offset[input_idx];
+      int sample_count        = sample_offset[input_idx + 1] - offset;
+      int neighbor_count      = (int)(csr_row_ptr[nid + 1] - neighbor_start);
+      const int* sample_index = nullptr;
+      if (sample_count < neighbor_count) {
+        host_sample_neighbor_index(input_idx, neighbor_count, max_sample_count, rngstate, &buffers);
+        sample_index = buffers.sample_index.data();
+      }
+      for (int sample_id = 0; sample_id < sample_count; sample_id++) {
+        int64_t edge_id = neighbor_start + (sample_index ? sample_index[sample_id] : sample_id);
+        output_dest_node_ptr[offset + sample_id] = csr_col_ptr[edge_id];
+        if (output_center_localid_ptr) output_center_localid_ptr[offset + sample_id] = input_idx;
+        if (output_edge_gid_ptr) output_edge_gid_ptr[offset + sample_id] = edge_id;
+      }
+    }
+  });
+}
+
+REGISTER_DISPATCH_TWO_TYPES(HostUnweightedSampleWithoutReplacementCSR,
+                            host_csr_unweighted_sample_without_replacement_func,
+                            SINT3264,
+                            SINT3264)
+
+wholememory_error_code_t wholegraph_csr_unweighted_sample_without_replacement_host(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns)
+{
+  try {
+    DISPATCH_TWO_TYPES(center_nodes_desc.dtype,
+                       wm_csr_col_ptr_desc.dtype,
+                       HostUnweightedSampleWithoutReplacementCSR,
+                       wm_csr_row_ptr,
+                       wm_csr_row_ptr_desc,
+                       wm_csr_col_ptr,
+                       wm_csr_col_ptr_desc,
+                       center_nodes,
+                       center_nodes_desc,
+                       max_sample_count,
+                       output_sample_offset,
+                       output_sample_offset_desc,
+                       output_dest_memory_context,
+                       output_center_localid_memory_context,
+                       output_edge_gid_memory_context,
+                       random_seed,
+                       p_env_fns);
+  } catch (const wholememory::logic_error& le) {
+    WHOLEMEMORY_ERROR("LOGIC Error %s\n", le.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+}  // namespace wholegraph_ops
@@ -15,10 +15,12 @@
  */
 #include <wholememory/wholegraph_op.h>
 
+#include <wholegraph_ops/sample_comm_host.h>
 #include <wholegraph_ops/weighted_sample_without_replacement_impl.h>
 
 #include "error.hpp"
 #include "logger.hpp"
+#include "wholememory/env_func_ptrs.hpp"
 
 wholememory_error_code_t wholegraph_csr_weighted_sample_without_replacement(
   wholememory_tensor_t wm_csr_row_ptr_tensor,
@@ -34,6 +36,7 @@ wholememory_error_code_t wholegraph_csr_weighted_sample_without_replacement(
   wholememory_env_func_t* p_env_fns,
   void* stream)
 {
+  wholememory::temp_memory_stream_guard stream_guard(static_cast<cudaStream_t>(stream));
   bool const csr_row_ptr_has_handle = wholememory_tensor_has_handle(wm_csr_row_ptr_tensor);
   wholememory_memory_type_t csr_row_ptr_memory_type = WHOLEMEMORY_MT_NONE;
   if (csr_row_ptr_has_handle) {
@@ -135,6 +138,29 @@ wholememory_error_code_t wholegraph_csr_weighted_sample_without_replacement(
   WHOLEMEMORY_RETURN_ON_FAIL(
     wholememory_tensor_get_global_reference(wm_csr_weight_ptr_tensor, &wm_csr_weight_ptr_gref));
 
+  if (wholegraph_ops::should_use_host_sample(wm_csr_row_ptr_tensor,
+                                             wm_csr_col_ptr_tensor,
+                                             wm_csr_weight_ptr_tensor,
+                                             center_nodes,
+                                             output_sample_offset)) {
+    return wholegraph_ops::wholegraph_csr_weighted_sample_without_replacement_host(
+      wm_csr_row_ptr_gref,
+      wm_csr_row_ptr_desc,
+      wm_csr_col_ptr_gref,
+      wm_csr_col_ptr_desc,
+      wm_csr_weight_ptr_gref,
+      wm_csr_weight_ptr_desc,
+      center_nodes,
+      center_nodes_desc,
+      max_sample_count,
+      output_sample_offset,
+      output_sample_offset_desc,
+      output_dest_memory_context,
+      output_center_localid_memory_context,
+      output_edge_gid_memory_context,
+      random_seed,
+      p_env_fns);
+  }
   return wholegraph_ops::wholegraph_csr_weighted_sample_without_replacement_mapped(
     wm_csr_row_ptr_gref,
     wm_csr_row_ptr_desc,
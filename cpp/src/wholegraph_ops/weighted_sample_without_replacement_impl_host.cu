@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <raft/random/rng_device.cuh>
+#include <raft/random/rng_state.hpp>
+
+#include <wholememory/env_func_ptrs.h>
+#include <wholememory/wholememory.h>
+
+#include "error.hpp"
+#include "logger.hpp"
+#include "parallel_utils.hpp"
+#include "weighted_sample_without_replacement_impl.h"
+#include "wholememory_ops/output_memory_handle.hpp"
+#include "wholememory_ops/register.hpp"
+
+namespace wholegraph_ops {
+
+namespace {
+
+// max_sample_count up to raft warpsort kMaxCapacity is sampled by 128 threads for each center
+// node, larger ones by 256 threads, keys are drawn the same way as the device kernels.
+constexpr int kWarpSortMaxCapacity   = 256;
+constexpr int kSmallSampleBlockDim   = 128;
+constexpr int kLargeSampleBlockDim   = 256;
+constexpr int kMinCenterNodesPerTask = 64;
+
+using rng_state_t = raft::random::detail::DeviceState<raft::random::detail::PCGenerator>;
+
+// same as gen_key_from_weight in weighted_sample_without_replacement_func.cuh
+template <typename WeightType>
+float host_gen_key_from_weight(const WeightType weight, raft::random::detail::PCGenerator& rng)
+{
+  float u = 0.0;
+  rng.next(u);
+  u                    = -(0.5 + 0.5 * u);
+  uint64_t random_num2 = 0;
+  int seed_count       = -1;
+  do {
+    rng.next(random_num2);
+    seed_count++;
+  } while (!random_num2);
+  int one_bit = __builtin_clzll(random_num2) + seed_count * 64;
+  u *= std::exp2(static_cast<float>(-one_bit));
+  float logk = (std::log1p(u) / std::log(2.0f)) * (1.0f / (float)weight);
+  return logk;
+}
+
+// A-Res, selects max_sample_count neighbor indices with largest keys to weighted_keys, in
+// descending order of key.
+template <typename WeightType>
+void host_weighted_sample_neighbor_index(int input_idx,
+                                         const WeightType* neighbor_weights,
+                                         int neighbor_count,
+                                         int max_sample_count,
+                                         const rng_state_t& rngstate,
+                                         std::vector<std::pair<WeightType, int>>* weighted_keys)
+{
+  int const block_dim =
+    max_sample_count > kWarpSortMaxCapacity ? kLargeSampleBlockDim : kSmallSampleBlockDim;
+  weighted_keys->resize(neighbor_count);
+  for (int tid = 0; tid < block_dim && tid < neighbor_count; tid++) {
+    int gidx = tid + input_idx * block_dim;
+    raft::random::detail::PCGenerator rng(rngstate, (uint64_t)gidx);
+    for (int idx = tid; idx < neighbor_count; idx += block_dim) {
+      WeightType weight_key = host_gen_key_from_weight(neighbor_weights[idx], rng);
+      (*weighted_keys)[idx] = std::make_pair(weight_key, idx);
+    }
+  }
+  std::partial_sort(weighted_keys->begin(),
+                    weighted_keys->begin() + max_sample_count,
+                    weighted_keys->end(),
+                    [](const std::pair<WeightType, int>& a, const std::pair<WeightType, int>& b) {
+                      return a.first > b.first || (a.first == b.first && a.second < b.second);
+                    });
+}
+
+}  // namespace
+
+template <typename IdType, typename WMIdType, typename WeightType>
+void host_csr_weighted_sample_without_replacement_func(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  wholememory_gref_t wm_csr_weight_ptr,
+  wholememory_array_description_t wm_csr_weight_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns)
+{
+  int center_node_count = center_nodes_desc.size;
+
+  WHOLEMEMORY_EXPECTS(wm_csr_row_ptr_desc.dtype == WHOLEMEMORY_DT_INT64,
+                      "host_csr_weighted_sample_without_replacement_func(). "
+                      "wm_csr_row_ptr_desc.dtype != WHOLEMEMORY_DT_INT64, "
+                      "wm_csr_row_ptr_desc.dtype = %d",
+                      wm_csr_row_ptr_desc.dtype);
+  WHOLEMEMORY_EXPECTS(output_sample_offset_desc.dtype == WHOLEMEMORY_DT_INT,
+                      "host_csr_weighted_sample_without_replacement_func(). "
+                      "output_sample_offset_desc.dtype != WHOLEMEMORY_DT_INT, "
+                      "output_sample_offset_desc.dtype = %d",
+                      output_sample_offset_desc.dtype);
+  // host graph should be continuous, its global reference is the global pointer.
+  WHOLEMEMORY_CHECK(wm_csr_row_ptr.stride == 0 && wm_csr_col_ptr.stride == 0 &&
+                    wm_csr_weight_ptr.stride == 0);
+
+  auto* csr_row_ptr    = static_cast<const int64_t*>(wm_csr_row_ptr.pointer);
+  auto* csr_col_ptr    = static_cast<const WMIdType*>(wm_csr_col_ptr.pointer);
+  auto* csr_weight_ptr = static_cast<const WeightType*>(wm_csr_weight_ptr.pointer);
+  auto* input_nodes    = static_cast<const IdType*>(center_nodes);
+  auto* sample_offset  = static_cast<int*>(output_sample_offset);
+
+  sample_offset[0] = 0;
+  for (int i = 0; i < center_node_count; i++) {
+    IdType nid         = input_nodes[i];
+    int neighbor_count = (int)(csr_row_ptr[nid + 1] - csr_row_ptr[nid]);
+    // sample_count <= 0 means sample all.
+    if (max_sample_count > 0) { neighbor_count = std::min(neighbor_count, max_sample_count); }
+    sample_offset[i + 1] = sample_offset[i] + neighbor_count;
+  }
+  int count = sample_offset[center_node_count];
+
+  wholememory_ops::output_memory_handle gen_output_dest_buffer_mh(p_env_fns,
+                                                                  output_dest_memory_context);
+  auto* output_dest_node_ptr =
+    (WMIdType*)gen_output_dest_buffer_mh.host_malloc(count, wm_csr_col_ptr_desc.dtype);
+
+  int* output_center_localid_ptr = nullptr;
+  if (output_center_localid_memory_context) {
+    wholememory_ops::output_memory_handle gen_output_center_localid_buffer_mh(
+      p_env_fns, output_center_localid_memory_context);
+    output_center_localid_ptr =
+      (int*)gen_output_center_localid_buffer_mh.host_malloc(count, WHOLEMEMORY_DT_INT);
+  }
+
+  int64_t* output_edge_gid_ptr = nullptr;
+  if (output_edge_gid_memory_context) {
+    wholememory_ops::output_memory_handle gen_output_edge_gid_buffer_mh(
+      p_env_fns, output_edge_gid_memory_context);
+    output_edge_gid_ptr =
+      (int64_t*)gen_output_edge_gid_buffer_mh.host_malloc(count, WHOLEMEMORY_DT_INT64);
+  }
+
+  raft::random::RngState _rngstate(random_seed, 0, raft::random::GeneratorType::GenPC);
+  rng_state_t rngstate(_rngstate);
+  int task_count = std::min(GetThreadPoolSize(), center_node_count / kMinCenterNodesPerTask);
+  task_count     = std::max(task_count, 1);
+  ThreadPoolRun(task_count, [&](int task_id, int task_num) {
+    int start = (int)((int64_t)center_node_count * task_id / task_num);
+    int end   = (int)((int64_t)center_node_count * (task_id + 1) / task_num);
+    std::vector<std::pair<WeightType, int>> weighted_keys;
+    for (int input_idx = start; input_idx < end; input_idx++) {
+      IdType nid             = input_nodes[input_idx];
+      int64_t neighbor_start = csr_row_ptr[nid];
+      int offset             = sample_offset[input_idx];
+      int sample_count       = sample_offset[input_idx + 1] - offset;
+      int neighbor_count     = (int)(csr_row_ptr[nid + 1] - neighbor_start);
+      bool const need_random = sample_count < neighbor_count;
+      if (need_random) {
+        host_weighted_sample_neighbor_index(input_idx,
+                                            csr_weight_ptr + neighbor_start,
+                                            neighbor_count,
+                                            max_sample_count,
+                                            rngstate,
+                                            &weighted_keys);
+      }
+      for (int sample_id = 0; sample_id < sample_count; sample_id++) {
+        int64_t edge_id =
+          neighbor_start + (need_random ? weighted_keys[sample_id].second : sample_id);
+        output_dest_node_ptr[offset + sample_id] = csr_col_ptr[edge_id];
+        if (output_center_localid_ptr) output_center_localid_ptr[offset + sample_id] = input_idx;
+        if (output_edge_gid_ptr) output_edge_gid_ptr[offset + sample_id] = edge_id;
+      }
+    }
+  });
+}
+
+REGISTER_DISPATCH_THREE_TYPES(HostWeightedSampleWithoutReplacementCSR,
+                              host_csr_weighted_sample_without_replacement_func,
+                              SINT3264,
+                              SINT3264,
+                              FLOAT_DOUBLE)
+
+wholememory_error_code_t wholegraph_csr_weighted_sample_without_replacement_host(
+  wholememory_gref_t wm_csr_row_ptr,
+  wholememory_array_description_t wm_csr_row_ptr_desc,
+  wholememory_gref_t wm_csr_col_ptr,
+  wholememory_array_description_t wm_csr_col_ptr_desc,
+  wholememory_gref_t wm_csr_weight_ptr,
+  wholememory_array_description_t wm_csr_weight_ptr_desc,
+  void* center_nodes,
+  wholememory_array_description_t center_nodes_desc,
+  int max_sample_count,
+  void* output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void* output_dest_memory_context,
+  void* output_center_localid_memory_context,
+  void* output_edge_gid_memory_context,
+  unsigned long long random_seed,
+  wholememory_env_func_t* p_env_fns)
+{
+  try {
+    DISPATCH_THREE_TYPES(center_nodes_desc.dtype,
+                         wm_csr_col_ptr_desc.dtype,
+                         wm_csr_weight_ptr_desc.dtype,
+                         HostWeightedSampleWithoutReplacementCSR,
+                         wm_csr_row_ptr,
+                         wm_csr_row_ptr_desc,
+                         wm_csr_col_ptr,
+                         wm_csr_col_ptr_desc,
+                         wm_csr_weight_ptr,
+                         wm_csr_weight_ptr_desc,
+                         center_nodes,
+                         center_nodes_desc,
+                         max_sample_count,
+                         output_sample_offset,
+                         output_sample_offset_desc,
+                         output_dest_memory_context,
+                         output_center_localid_memory_context,
+                         output_edge_gid_memory_context,
+                         random_seed,
+                         p_env_fns);
+  } catch (const wholememory::logic_error& le) {
+    WHOLEMEMORY_ERROR("LOGIC Error %s\n", le.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+}  // namespace wholegraph_ops
@@ -16,6 +16,9 @@
 #include "communicator.hpp"
 
 #include <cstdlib>
+#include <cstring>
+#include <sys/ipc.h>
+#include <sys/shm.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -30,7 +33,9 @@
 #include "logger.hpp"
 #include "memory_handle.hpp"
 #include "system_info.hpp"
+#include "wholememory/host_comms.hpp"
 #include "wholememory/nccl_comms.hpp"
+#include "wholememory/shm_comms.hpp"
 
 #ifdef WITH_NVSHMEM_SUPPORT
 
@@ -55,9 +60,20 @@ wholememory_comm_::wholememory_comm_(ncclComm_t nccl_comm,
   raft_nccl_comm = new wholememory::nccl_comms(nccl_comm, num_ranks, rank, stream);
 }
 
+wholememory_comm_::wholememory_comm_(wholememory::host_comms* host_only_comm,
+                                     int num_ranks,
+                                     int rank)
+{
+  world_rank = rank;
+  world_size = num_ranks;
+  host_comm  = host_only_comm;
+}
+
 wholememory_comm_::~wholememory_comm_()
 {
+  delete shm_comm;
   delete raft_nccl_comm;
+  delete host_comm;
   if (cuda_event != nullptr) {
     cudaEventDestroy(cuda_event);
     cuda_event = nullptr;
@@ -95,9 +111,24 @@ static ncclDataType_t get_nccl_dtype_same_size(const wholememory_dtype_t dtype)
   }
 }
 
-void wholememory_comm_::barrier() const { raft_nccl_comm->barrier(); }
+void wholememory_comm_::barrier() const
+{
+  if (shm_comm != nullptr) {
+    shm_comm->barrier();
+    return;
+  }
+  if (host_comm != nullptr) {
+    host_comm->barrier();
+    return;
+  }
+  raft_nccl_comm->barrier();
+}
 
-void wholememory_comm_::abort() const { raft_nccl_comm->abort(); }
+void wholememory_comm_::abort() const
+{
+  // host only communicator has no asynchronous work to abort.
+  if (raft_nccl_comm != nullptr) raft_nccl_comm->abort();
+}
 
 void wholememory_comm_::allreduce(const void* sendbuff,
                                   void* recvbuff,
@@ -106,6 +137,7 @@ void wholememory_comm_::allreduce(const void* sendbuff,
                                   ncclRedOp_t op,
                                   cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->allreduce(sendbuff, recvbuff, count, get_nccl_dtype(datatype), op, stream);
 }
 
@@ -115,12 +147,21 @@ void wholememory_comm_::host_allreduce(const void* sendbuff,
                                        wholememory_dtype_t datatype,
                                        ncclRedOp_t op) const
 {
+  if (shm_comm != nullptr) {
+    shm_comm->host_allreduce(sendbuff, recvbuff, count, get_nccl_dtype(datatype), op);
+    return;
+  }
+  if (host_comm != nullptr) {
+    host_comm->host_allreduce(sendbuff, recvbuff, count, get_nccl_dtype(datatype), op);
+    return;
+  }
   raft_nccl_comm->host_allreduce(sendbuff, recvbuff, count, get_nccl_dtype(datatype), op);
 }
 
 void wholememory_comm_::bcast(
   void* buff, size_t count, wholememory_dtype_t datatype, int root, cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->bcast(buff, count, get_nccl_dtype_same_size(datatype), root, stream);
 }
 
@@ -131,6 +172,7 @@ void wholememory_comm_::bcast(const void* sendbuff,
                               int root,
                               cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->bcast(
     sendbuff, recvbuff, count, get_nccl_dtype_same_size(datatype), root, stream);
 }
@@ -138,6 +180,14 @@ void wholememory_comm_::bcast(const void* sendbuff,
 void wholememory_comm_::host_bcast(
   const void* sendbuff, void* recvbuff, size_t count, wholememory_dtype_t datatype, int root) const
 {
+  if (shm_comm != nullptr) {
+    shm_comm->host_bcast(sendbuff, recvbuff, count, get_nccl_dtype_same_size(datatype), root);
+    return;
+  }
+  if (host_comm != nullptr) {
+    host_comm->host_bcast(sendbuff, recvbuff, count, get_nccl_dtype_same_size(datatype), root);
+    return;
+  }
   raft_nccl_comm->host_bcast(sendbuff, recvbuff, count, get_nccl_dtype_same_size(datatype), root);
 }
 
@@ -146,6 +196,14 @@ void wholememory_comm_::host_bcast(void* buff,
                                    wholememory_dtype_t datatype,
                                    int root) const
 {
+  if (shm_comm != nullptr) {
+    shm_comm->host_bcast(buff, count, get_nccl_dtype_same_size(datatype), root);
+    return;
+  }
+  if (host_comm != nullptr) {
+    host_comm->host_bcast(buff, count, get_nccl_dtype_same_size(datatype), root);
+    return;
+  }
   raft_nccl_comm->host_bcast(buff, count, get_nccl_dtype_same_size(datatype), root);
 }
 
@@ -157,6 +215,7 @@ void wholememory_comm_::reduce(const void* sendbuff,
                                int root,
                                cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->reduce(sendbuff, recvbuff, count, get_nccl_dtype(datatype), op, root, stream);
 }
 
@@ -167,6 +226,14 @@ void wholememory_comm_::host_reduce(const void* sendbuff,
                                     ncclRedOp_t op,
                                     int root) const
 {
+  if (shm_comm != nullptr) {
+    shm_comm->host_reduce(sendbuff, recvbuff, count, get_nccl_dtype(datatype), op, root);
+    return;
+  }
+  if (host_comm != nullptr) {
+    host_comm->host_reduce(sendbuff, recvbuff, count, get_nccl_dtype(datatype), op, root);
+    return;
+  }
   raft_nccl_comm->host_reduce(sendbuff, recvbuff, count, get_nccl_dtype(datatype), op, root);
 }
 
@@ -176,6 +243,7 @@ void wholememory_comm_::allgather(const void* sendbuff,
                                   wholememory_dtype_t datatype,
                                   cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->allgather(
     sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype), stream);
 }
@@ -185,6 +253,14 @@ void wholememory_comm_::host_allgather(const void* sendbuff,
                                        size_t sendcount,
                                        wholememory_dtype_t datatype) const
 {
+  if (shm_comm != nullptr) {
+    shm_comm->host_allgather(sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype));
+    return;
+  }
+  if (host_comm != nullptr) {
+    host_comm->host_allgather(sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype));
+    return;
+  }
   raft_nccl_comm->host_allgather(sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype));
 }
 
@@ -195,6 +271,7 @@ void wholememory_comm_::allgatherv(const void* sendbuf,
                                    wholememory_dtype_t datatype,
                                    cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->allgatherv(
     sendbuf, recvbuf, recvcounts, displs, get_nccl_dtype_same_size(datatype), stream);
 }
@@ -205,6 +282,16 @@ void wholememory_comm_::host_allgatherv(const void* sendbuf,
                                         const size_t* displs,
                                         wholememory_dtype_t datatype) const
 {
+  if (shm_comm != nullptr) {
+    shm_comm->host_allgatherv(
+      sendbuf, recvbuf, recvcounts, displs, get_nccl_dtype_same_size(datatype));
+    return;
+  }
+  if (host_comm != nullptr) {
+    host_comm->host_allgatherv(
+      sendbuf, recvbuf, recvcounts, displs, get_nccl_dtype_same_size(datatype));
+    return;
+  }
   raft_nccl_comm->host_allgatherv(
     sendbuf, recvbuf, recvcounts, displs, get_nccl_dtype_same_size(datatype));
 }
@@ -216,6 +303,7 @@ void wholememory_comm_::gather(const void* sendbuff,
                                int root,
                                cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->gather(
     sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype), root, stream);
 }
@@ -226,6 +314,14 @@ void wholememory_comm_::host_gather(const void* sendbuff,
                                     wholememory_dtype_t datatype,
                                     int root) const
 {
+  if (shm_comm != nullptr) {
+    shm_comm->host_gather(sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype), root);
+    return;
+  }
+  if (host_comm != nullptr) {
+    host_comm->host_gather(sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype), root);
+    return;
+  }
   raft_nccl_comm->host_gather(
     sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype), root);
 }
@@ -239,6 +335,7 @@ void wholememory_comm_::gatherv(const void* sendbuff,
                                 int root,
                                 cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->gatherv(sendbuff,
                           recvbuff,
                           sendcount,
@@ -256,6 +353,7 @@ void wholememory_comm_::reducescatter(const void* sendbuff,
                                       ncclRedOp_t op,
                                       cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->reducescatter(
     sendbuff, recvbuff, recvcount, get_nccl_dtype(datatype), op, stream);
 }
@@ -266,6 +364,7 @@ void wholememory_comm_::alltoall(const void* sendbuff,
                                  wholememory_dtype_t datatype,
                                  cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->alltoall(
     sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype), stream);
 }
@@ -275,9 +374,54 @@ void wholememory_comm_::host_alltoall(const void* sendbuff,
                                       size_t sendcount,
                                       wholememory_dtype_t datatype) const
 {
+  if (shm_comm != nullptr) {
+    shm_comm->host_alltoall(sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype));
+    return;
+  }
+  if (host_comm != nullptr) {
+    host_comm->host_alltoall(sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype));
+    return;
+  }
   raft_nccl_comm->host_alltoall(sendbuff, recvbuff, sendcount, get_nccl_dtype_same_size(datatype));
 }
 
+void wholememory_comm_::host_alltoallv(const void* sendbuff,
+                                       void* recvbuff,
+                                       const size_t* sendcounts,
+                                       const size_t* senddispls,
+                                       const size_t* recvcounts,
+                                       const size_t* recvdispls,
+                                       wholememory_dtype_t datatype) const
+{
+  if (shm_comm != nullptr) {
+    shm_comm->host_alltoallv(sendbuff,
+                             recvbuff,
+                             sendcounts,
+                             senddispls,
+                             recvcounts,
+                             recvdispls,
+                             get_nccl_dtype_same_size(datatype));
+    return;
+  }
+  if (host_comm != nullptr) {
+    host_comm->host_alltoallv(sendbuff,
+                              recvbuff,
+                              sendcounts,
+                              senddispls,
+                              recvcounts,
+                              recvdispls,
+                              get_nccl_dtype_same_size(datatype));
+    return;
+  }
+  raft_nccl_comm->host_alltoallv(sendbuff,
+                                 recvbuff,
+                                 sendcounts,
+                                 senddispls,
+                                 recvcounts,
+                                 recvdispls,
+                                 get_nccl_dtype_same_size(datatype));
+}
+
 void wholememory_comm_::alltoallv(const void* sendbuff,
                                   void* recvbuff,
                                   const size_t* sendcounts,
@@ -287,6 +431,7 @@ void wholememory_comm_::alltoallv(const void* sendbuff,
                                   wholememory_dtype_t datatype,
                                   cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->alltoallv(sendbuff,
                             recvbuff,
                             sendcounts,
@@ -299,11 +444,13 @@ void wholememory_comm_::alltoallv(const void* sendbuff,
 
 wholememory_error_code_t wholememory_comm_::sync_stream(cudaStream_t stream) const
 {
+  expect_nccl_comm();
   return raft_nccl_comm->sync_stream(stream);
 }
 
 wholememory_error_code_t wholememory_comm_::sync_stream() const
 {
+  expect_nccl_comm();
   return raft_nccl_comm->sync_stream();
 }
 
@@ -313,6 +460,7 @@ void wholememory_comm_::device_send(const void* send_buf,
                                     int dest,
                                     cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->device_send(send_buf, send_size, dest, stream);
 }
 
@@ -322,6 +470,7 @@ void wholememory_comm_::device_recv(void* recv_buf,
                                     int source,
                                     cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->device_recv(recv_buf, recv_size, source, stream);
 }
 
@@ -333,6 +482,7 @@ void wholememory_comm_::device_sendrecv(const void* sendbuf,
                                         int source,
                                         cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->device_sendrecv(sendbuf, sendsize, dest, recvbuf, recvsize, source, stream);
 }
 
@@ -346,33 +496,54 @@ void wholememory_comm_::device_multicast_sendrecv(const void* sendbuf,
                                                   std::vector<int> const& sources,
                                                   cudaStream_t stream) const
 {
+  expect_nccl_comm();
   raft_nccl_comm->device_multicast_sendrecv(
     sendbuf, sendsizes, sendoffsets, dests, recvbuf, recvsizes, recvoffsets, sources, stream);
 }
 
 bool wholememory_comm_::is_intranode() const { return intra_node_rank_num == world_size; }
 
+bool wholememory_comm_::is_host_only() const { return host_comm != nullptr; }
+
+void wholememory_comm_::expect_nccl_comm() const
+{
+  WHOLEMEMORY_EXPECTS(raft_nccl_comm != nullptr,
+                      "Only host collectives are supported by host only communicator.");
+}
+
 bool wholememory_comm_::support_type_location(wholememory_memory_type_t memory_type,
                                               wholememory_memory_location_t memory_location) const
 {
   if (memory_location == WHOLEMEMORY_ML_HOST) {
     if (is_intranode() || memory_type == WHOLEMEMORY_MT_DISTRIBUTED) return true;
-    return SupportMNNVLForEGM();
+    return !is_host_only() && SupportMNNVLForEGM();
   } else if (memory_location == WHOLEMEMORY_ML_DEVICE) {
+    if (is_host_only()) return false;
     if (memory_type == WHOLEMEMORY_MT_DISTRIBUTED) return true;
     if (is_intranode()) {
       return DevicesCanAccessP2P(&local_gpu_ids[0], intra_node_rank_num);
     } else {
       return DevicesCanAccessP2P(&local_gpu_ids[0], intra_node_rank_num) && SupportMNNVL();
     }
+  } else if (memory_location == WHOLEMEMORY_ML_FILE) {
+    // each rank maps all files, so no inter rank memory sharing is needed.
+    return memory_type == WHOLEMEMORY_MT_CONTINUOUS;
   } else {
     return false;
   }
 }
 
-void wholememory_comm_::group_start() const { raft_nccl_comm->group_start(); }
+void wholememory_comm_::group_start() const
+{
+  expect_nccl_comm();
+  raft_nccl_comm->group_start();
+}
 
-void wholememory_comm_::group_end() const { raft_nccl_comm->group_end(); }
+void wholememory_comm_::group_end() const
+{
+  expect_nccl_comm();
+  raft_nccl_comm->group_end();
+}
 
 namespace wholememory {
 
@@ -391,8 +562,22 @@ enum wm_comm_op : int32_t {
   WM_COMM_OP_DESTROY_COMM,
 };
 
-wholememory_error_code_t create_unique_id(wholememory_unique_id_t* unique_id) noexcept
+wholememory_error_code_t create_unique_id(wholememory_unique_id_t* unique_id,
+                                          wholememory_comm_backend_t comm_backend) noexcept
 {
+  if (comm_backend == WHOLEMEMORY_CB_HOST) {
+    try {
+      host_comms::create_unique_id(unique_id);
+      return WHOLEMEMORY_SUCCESS;
+    } catch (const wholememory::logic_error& wle) {
+      WHOLEMEMORY_FAIL_NOTHROW("%s", wle.what());
+    } catch (...) {
+      WHOLEMEMORY_FAIL_NOTHROW("Unknown exception.");
+    }
+  }
+  WHOLEMEMORY_EXPECTS_NOTHROW(comm_backend == WHOLEMEMORY_CB_NCCL,
+                              "Unsupported comm_backend %d",
+                              (int)comm_backend);
   ncclUniqueId id;
   WHOLEMEMORY_CHECK_NOTHROW(sizeof(ncclUniqueId) <= sizeof(wholememory_unique_id_t));
   WHOLEMEMORY_CHECK_NOTHROW(ncclGetUniqueId(&id) == ncclSuccess);
@@ -580,6 +765,70 @@ void maybe_remove_temp_dir(wholememory_comm_t wm_comm)
   }
 }
 
+#define SYSTEMV_SHM_HOST_COLL_PROJ_ID (0xE602EEEE)
+
+/*
+ * Create shared memory host collectives if all ranks are in the same node.
+ * Shared memory host collectives can be disabled by setting WHOLEMEMORY_DISABLE_SHM_HOST_COLL=1,
+ * then host collectives go through NCCL or sockets. If shared memory can't be created or mapped by
+ * any rank, all ranks fall back together.
+ */
+void maybe_create_shm_comm(wholememory_comm_t wm_comm)
+{
+  if (!is_intranode_communicator(wm_comm)) return;
+  const char* disable_env = getenv("WHOLEMEMORY_DISABLE_SHM_HOST_COLL");
+  int use_shm             = (disable_env == nullptr || std::strcmp(disable_env, "0") == 0) ? 1 : 0;
+  wm_comm->host_allreduce(&use_shm, &use_shm, 1, WHOLEMEMORY_DT_INT, ncclMin);
+  if (use_shm == 0) return;
+
+  size_t shm_size           = shm_comms::get_segment_size(wm_comm->world_size);
+  std::string shm_full_path = "/tmp/";
+  shm_full_path.append(get_shm_prefix(wm_comm)).append("_host_coll");
+  key_t shm_key = -1;
+  int shm_id    = -1;
+  int created   = 1;
+  if (wm_comm->world_rank == 0) {
+    FILE* shm_fp = fopen(shm_full_path.c_str(), "w");
+    if (shm_fp != nullptr) {
+      WHOLEMEMORY_CHECK(fclose(shm_fp) == 0);
+      shm_key = ftok(shm_full_path.c_str(), SYSTEMV_SHM_HOST_COLL_PROJ_ID);
+    }
+    if (shm_key != (key_t)-1) { shm_id = shmget(shm_key, shm_size, 0644 | IPC_CREAT | IPC_EXCL); }
+    if (shm_id == -1) {
+      WHOLEMEMORY_WARN("Create shared memory for host collectives failed, Reason=%s",
+                       strerror(errno));
+      created = 0;
+      if (shm_fp != nullptr) unlink(shm_full_path.c_str());
+    }
+  }
+  wm_comm->host_bcast(&created, 1, WHOLEMEMORY_DT_INT, 0);
+  if (created == 0) return;
+
+  if (wm_comm->world_rank != 0) {
+    shm_key = ftok(shm_full_path.c_str(), SYSTEMV_SHM_HOST_COLL_PROJ_ID);
+    if (shm_key != (key_t)-1) { shm_id = shmget(shm_key, shm_size, 0644); }
+  }
+  void* shm_ptr = (void*)-1;
+  if (shm_id != -1) { shm_ptr = shmat(shm_id, nullptr, 0); }
+  int attached = shm_ptr != (void*)-1 ? 1 : 0;
+  if (attached == 0) {
+    WHOLEMEMORY_WARN("Rank=%d map shared memory for host collectives failed, Reason=%s",
+                     wm_comm->world_rank,
+                     strerror(errno));
+  }
+  wm_comm->host_allreduce(&attached, &attached, 1, WHOLEMEMORY_DT_INT, ncclMin);
+  // all ranks have tried to attach, remove now so the segment is freed after the last detach.
+  if (wm_comm->world_rank == 0) {
+    WHOLEMEMORY_CHECK(shmctl(shm_id, IPC_RMID, nullptr) == 0);
+    WHOLEMEMORY_CHECK(unlink(shm_full_path.c_str()) == 0);
+  }
+  if (attached == 0) {
+    if (shm_ptr != (void*)-1) { WHOLEMEMORY_CHECK(shmdt(shm_ptr) == 0); }
+    return;
+  }
+  wm_comm->shm_comm = new shm_comms(shm_ptr, wm_comm->world_size, wm_comm->world_rank);
+}
+
 static size_t get_alloc_granularity(int dev_id)
 {
   size_t granularity = 0;
@@ -614,14 +863,20 @@ wholememory_error_code_t create_communicator(wholememory_comm_t* comm,
 {
   try {
     std::unique_lock<std::mutex> mlock(comm_mu);
-    ncclComm_t nccl_comm;
-    WHOLEMEMORY_CHECK(
-      ncclCommInitRank(&nccl_comm, world_size, (ncclUniqueId&)unique_id, world_rank) ==
-      ncclSuccess);
-    cudaStream_t cuda_stream;
-    WM_CUDA_CHECK(cudaStreamCreateWithFlags(&cuda_stream, cudaStreamNonBlocking));
-    auto* wm_comm = new wholememory_comm_(nccl_comm, world_size, world_rank, cuda_stream);
-    *comm         = wm_comm;
+    wholememory_comm_t wm_comm = nullptr;
+    if (host_comms::is_host_unique_id(unique_id)) {
+      auto* host_comm = new host_comms(unique_id, world_size, world_rank);
+      wm_comm         = new wholememory_comm_(host_comm, world_size, world_rank);
+    } else {
+      ncclComm_t nccl_comm;
+      WHOLEMEMORY_CHECK(
+        ncclCommInitRank(&nccl_comm, world_size, (ncclUniqueId&)unique_id, world_rank) ==
+        ncclSuccess);
+      cudaStream_t cuda_stream;
+      WM_CUDA_CHECK(cudaStreamCreateWithFlags(&cuda_stream, cudaStreamNonBlocking));
+      wm_comm = new wholememory_comm_(nccl_comm, world_size, world_rank, cuda_stream);
+    }
+    *comm = wm_comm;
     WM_COMM_CHECK_ALL_SAME(wm_comm, WM_COMM_OP_STARTING);
 
     exchange_rank_info(wm_comm);
@@ -630,7 +885,10 @@ wholememory_error_code_t create_communicator(wholememory_comm_t* comm,
 
     maybe_create_temp_dir(wm_comm);
 
-    determine_alloc_granularity(wm_comm);
+    maybe_create_shm_comm(wm_comm);
+
+    // host only communicator keeps default granularity as there may be no CUDA device.
+    if (!wm_comm->is_host_only()) determine_alloc_granularity(wm_comm);
 
     return WHOLEMEMORY_SUCCESS;
   } catch (const wholememory::cu_error& wce) {
@@ -688,8 +946,10 @@ wholememory_error_code_t destroy_communicator_locked(wholememory_comm_t comm) no
     maybe_remove_temp_dir(comm);
 
     delete comm;
-    WHOLEMEMORY_CHECK(ncclCommDestroy(raw_nccl_comm) == ncclSuccess);
-    WM_CUDA_CHECK(cudaStreamDestroy(cuda_stream));
+    if (raw_nccl_comm != nullptr) {
+      WHOLEMEMORY_CHECK(ncclCommDestroy(raw_nccl_comm) == ncclSuccess);
+      WM_CUDA_CHECK(cudaStreamDestroy(cuda_stream));
+    }
 
     return WHOLEMEMORY_SUCCESS;
   } catch (const wholememory::cuda_error& wce) {
@@ -772,6 +1032,13 @@ void communicator_barrier(wholememory_comm_t comm)
 
 bool is_intranode_communicator(wholememory_comm_t comm) noexcept { return comm->is_intranode(); }
 
+bool is_host_only_communicator(wholememory_comm_t comm) noexcept { return comm->is_host_only(); }
+
+wholememory_comm_backend_t communicator_get_backend(wholememory_comm_t comm) noexcept
+{
+  return comm->is_host_only() ? WHOLEMEMORY_CB_HOST : WHOLEMEMORY_CB_NCCL;
+}
+
 #ifdef WITH_NVSHMEM_SUPPORT
 wholememory_error_code_t init_nvshmem_with_comm(wholememory_comm_t comm) noexcept
 {
@@ -861,6 +1128,9 @@ wholememory_error_code_t communicator_set_distributed_backend(
 
     WHOLEMEMORY_CHECK(comm != nullptr);
     WM_COMM_CHECK_ALL_SAME(comm, distributed_backend);
+    WHOLEMEMORY_EXPECTS(!comm->is_host_only() || distributed_backend == WHOLEMEMORY_DB_NCCL,
+                        "host only communicator doesn't support distributed_backend %d",
+                        (int)distributed_backend);
 
     for (auto&& [id, handle] : comm->wholememory_map) {
       WHOLEMEMORY_EXPECTS(wholememory_get_memory_type(handle) != WHOLEMEMORY_MT_DISTRIBUTED,
@@ -32,11 +32,14 @@
 namespace wholememory {
 
 class nccl_comms;
+class host_comms;
+class shm_comms;
 
 }
 
 struct wholememory_comm_ {
   wholememory_comm_(ncclComm_t nccl_comm, int num_ranks, int rank, cudaStream_t stream);
+  wholememory_comm_(wholememory::host_comms* host_only_comm, int num_ranks, int rank);
   ~wholememory_comm_();
 
   void barrier() const;
@@ -153,6 +156,14 @@ struct wholememory_comm_ {
                      size_t sendcount,
                      wholememory_dtype_t datatype) const;
 
+  void host_alltoallv(const void* sendbuff,
+                      void* recvbuff,
+                      const size_t* sendcounts,
+                      const size_t* senddispls,
+                      const size_t* recvcounts,
+                      const size_t* recvdispls,
+                      wholememory_dtype_t datatype) const;
+
   void alltoallv(const void* sendbuff,
                  void* recvbuff,
                  const size_t* sendcounts,
@@ -192,6 +203,9 @@ struct wholememory_comm_ {
 
   bool is_intranode() const;
 
+  // host only communicator has no NCCL communicator, only host collectives are supported.
+  bool is_host_only() const;
+
   bool support_type_location(wholememory_memory_type_t memory_type,
                              wholememory_memory_location_t memory_location) const;
 
@@ -199,10 +213,16 @@ struct wholememory_comm_ {
 
   void group_end() const;
 
-  wholememory::nccl_comms* raft_nccl_comm;
-  cudaStream_t comm_stream = nullptr;
-  cudaEvent_t cuda_event   = nullptr;
-  ncclComm_t raw_nccl_comm = nullptr;
+  // throws if device collectives are called on host only communicator.
+  void expect_nccl_comm() const;
+
+  wholememory::nccl_comms* raft_nccl_comm = nullptr;
+  wholememory::host_comms* host_comm       = nullptr;
+  // shared memory host collectives, only created if all ranks are in the same node.
+  wholememory::shm_comms* shm_comm = nullptr;
+  cudaStream_t comm_stream         = nullptr;
+  cudaEvent_t cuda_event           = nullptr;
+  ncclComm_t raw_nccl_comm         = nullptr;
 
   int world_rank = 0;
   int world_size = 1;
@@ -260,7 +280,9 @@ inline bool wm_comm_check_all_same(wholememory_comm_t comm, const std::string& s
 
 namespace wholememory {
 
-wholememory_error_code_t create_unique_id(wholememory_unique_id_t* unique_id) noexcept;
+wholememory_error_code_t create_unique_id(
+  wholememory_unique_id_t* unique_id,
+  wholememory_comm_backend_t comm_backend = WHOLEMEMORY_CB_NCCL) noexcept;
 
 wholememory_error_code_t create_communicator(wholememory_comm_t* comm,
                                              wholememory_unique_id_t unique_id,
@@ -286,6 +308,10 @@ void communicator_barrier(wholememory_comm_t comm);
 
 bool is_intranode_communicator(wholememory_comm_t comm) noexcept;
 
+bool is_host_only_communicator(wholememory_comm_t comm) noexcept;
+
+wholememory_comm_backend_t communicator_get_backend(wholememory_comm_t comm) noexcept;
+
 std::string get_temporary_directory_path(wholememory_comm_t comm);
 
 std::string get_shm_prefix(wholememory_comm_t comm);
@@ -20,16 +20,25 @@
 #include <wholememory/env_func_ptrs.h>
 #include <wholememory/wholememory_op.h>
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "communicator.hpp"
 #include "cuda_macros.hpp"
 #include "embedding.hpp"
 #include "embedding_optimizer.hpp"
+#include "embedding_snapshot.hpp"
+#include "env_func_ptrs.hpp"
 #include "error.hpp"
 #include "integer_utils.hpp"
 #include "logger.hpp"
+#include "memory_handle.hpp"
+#include "memory_usage.hpp"
 #include "wholememory/wholememory.h"
 #include "wholememory_ops/functions/embedding_cache_func.h"
+#include "wholememory_ops/functions/embedding_optimizer_func.h"
 #include "wholememory_ops/functions/exchange_embeddings_nccl_func.h"
 #include "wholememory_ops/functions/exchange_ids_nccl_func.h"
 #include "wholememory_ops/functions/gather_cached_func.h"
@@ -54,12 +63,17 @@ wholememory_error_code_t embedding_base::allocate(
   wholememory_memory_type_t memory_type,
   wholememory_memory_location_t memory_location,
   wholememory_embedding_cache_policy_t policy,
-  wholememory_embedding_optimizer_t opt) noexcept
+  wholememory_embedding_optimizer_t opt,
+  unsigned int malloc_flags) noexcept
 {
   cache_policy        = policy;
   optimizer           = opt;
   raw_embedding_comm_ = comm;
   wholememory_tensor_description_t padded_embedding_tensor_description;
+  // cachable optimizer states are also embeddings, they keep the purpose of optimizer states.
+  wholememory_memory_purpose_t const purpose = get_current_memory_purpose();
+  memory_purpose_guard purpose_guard(
+    purpose == WHOLEMEMORY_MP_GENERAL ? WHOLEMEMORY_MP_EMBEDDING : purpose);
   try {
     if (optimizer != nullptr && embedding_description->dtype != WHOLEMEMORY_DT_FLOAT) {
       WHOLEMEMORY_ERROR("Only float embedding supports training.");
@@ -88,11 +102,13 @@ wholememory_error_code_t embedding_base::allocate(
       padded_embedding_tensor_description.strides[0]     = embedding_stride;
       padded_embedding_tensor_description.strides[1]     = 1;
     }
-    WHOLEMEMORY_RETURN_ON_FAIL(wholememory_create_tensor(&allocated_embedding,
-                                                         &padded_embedding_tensor_description,
-                                                         comm,
-                                                         memory_type,
-                                                         memory_location));
+    WHOLEMEMORY_RETURN_ON_FAIL(
+      wholememory_create_tensor_with_flags(&allocated_embedding,
+                                           &padded_embedding_tensor_description,
+                                           comm,
+                                           memory_type,
+                                           memory_location,
+                                           malloc_flags));
     int64_t starts[2] = {0, 0};
     int64_t ends[2]   = {embedding_description->sizes[0], embedding_description->sizes[1]};
     WHOLEMEMORY_RETURN_ON_FAIL(
@@ -105,6 +121,16 @@ wholememory_error_code_t embedding_base::allocate(
       optimizer_impl_base_ = static_cast<embedding_optimizer_impl_base*>(optimizer);
       WHOLEMEMORY_RETURN_ON_FAIL(create_optimizer_states());
       WHOLEMEMORY_RETURN_ON_FAIL(init_optimizer_states());
+      wholememory_tensor_t local_user_embedding;
+      WHOLEMEMORY_RETURN_ON_FAIL(
+        wholememory_tensor_map_local_tensor(user_embedding, &local_user_embedding));
+      local_row_count_ = wholememory_tensor_get_tensor_description(local_user_embedding)->sizes[0];
+      WHOLEMEMORY_RETURN_ON_FAIL(wholememory_destroy_tensor(local_user_embedding));
+      size_t const bitmap_size =
+        std::max<int64_t>(div_rounding_up_safe<int64_t>(local_row_count_, 32), 1) *
+        sizeof(uint32_t);
+      WM_CUDA_CHECK(cudaMalloc(&dirty_row_bitmap_, bitmap_size));
+      WM_CUDA_CHECK(cudaMemset(dirty_row_bitmap_, 0, bitmap_size));
     }
   } catch (std::bad_alloc& sba) {
     WHOLEMEMORY_ERROR("bad_alloc");
@@ -128,6 +154,10 @@ wholememory_error_code_t embedding_base::gather_gradient_apply(wholememory_tenso
   auto* grads_desc     = wholememory_tensor_get_tensor_description(grads);
   auto* embedding_desc = wholememory_tensor_get_tensor_description(allocated_embedding);
   WHOLEMEMORY_CHECK_NOTHROW(indice_desc->dim == 1);
+  if (!is_writable(wholememory_tensor_get_memory_handle(allocated_embedding))) {
+    WHOLEMEMORY_ERROR("embedding is read only, map files with write back to apply gradients.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
   wholememory_ops::temp_memory_handle host_recv_rank_id_count_handle(p_env_fns),
     host_rank_id_count_handle(p_env_fns);
   wholememory_ops::temp_memory_handle dev_recv_indices_buffer_handle(p_env_fns);
@@ -277,6 +307,10 @@ wholememory_error_code_t embedding_base::gather_gradient_apply(wholememory_tenso
 
   WHOLEMEMORY_RETURN_ON_FAIL(optimizer_impl_base_->step(
     dedup_indice_tensor, dedup_grad_tensor, local_embedding, optimizer_state_.get(), lr, stream));
+  if (dirty_row_bitmap_ != nullptr) {
+    WHOLEMEMORY_RETURN_ON_FAIL(wholememory_ops::mark_dirty_rows(
+      dedup_indice_tensor, optimizer_state_->local_start_index, dirty_row_bitmap_, stream));
+  }
   wholememory_destroy_tensor(dedup_indice_tensor);
   wholememory_destroy_tensor(dedup_grad_tensor);
 
@@ -285,6 +319,7 @@ wholememory_error_code_t embedding_base::gather_gradient_apply(wholememory_tenso
 
 wholememory_error_code_t embedding_base::create_optimizer_states() noexcept
 {
+  memory_purpose_guard purpose_guard(WHOLEMEMORY_MP_OPTIMIZER_STATE);
   wholememory_comm_t wm_raw_comm;
   WHOLEMEMORY_RETURN_ON_FAIL(wholememory_get_communicator(
     &wm_raw_comm, wholememory_tensor_get_memory_handle(allocated_embedding)));
@@ -334,14 +369,15 @@ wholememory_error_code_t embedding_base::create_optimizer_states() noexcept
     auto memory_type               = wholememory_get_memory_type(allocated_handle);
     auto memory_location           = wholememory_get_memory_location(allocated_handle);
 
-    WHOLEMEMORY_RETURN_ON_FAIL(
-      wholememory_create_embedding(&optimizer_state_->cachable_state_embedding,
-                                   &cachable_state_desc,
-                                   raw_embedding_comm_,
-                                   memory_type,
-                                   memory_location,
-                                   nullptr,
-                                   cache_policy));
+    // states are filled by init_optimizer_states, so zero fill on allocation is skipped.
+    WHOLEMEMORY_RETURN_ON_FAIL(create_embedding(&optimizer_state_->cachable_state_embedding,
+                                                &cachable_state_desc,
+                                                raw_embedding_comm_,
+                                                memory_type,
+                                                memory_location,
+                                                nullptr,
+                                                cache_policy,
+                                                WHOLEMEMORY_MF_NO_ZERO_INIT));
 
     optimizer_state_->global_cachable_raw_user_tensor =
       wholememory_embedding_get_embedding_tensor(optimizer_state_->cachable_state_embedding);
@@ -365,11 +401,13 @@ wholememory_error_code_t embedding_base::create_optimizer_states() noexcept
     auto uc_desc     = *allocated_tensor_desc;
     uc_desc.dtype    = uc_state.dtype;
     uc_desc.sizes[1] = uc_desc.strides[0] = uc_state.dim;
-    WHOLEMEMORY_RETURN_ON_FAIL(wholememory_create_tensor(&uc_state.global_raw_padded_tensor,
-                                                         &uc_desc,
-                                                         wm_raw_comm,
-                                                         WHOLEMEMORY_MT_DISTRIBUTED,
-                                                         WHOLEMEMORY_ML_DEVICE));
+    WHOLEMEMORY_RETURN_ON_FAIL(
+      wholememory_create_tensor_with_flags(&uc_state.global_raw_padded_tensor,
+                                           &uc_desc,
+                                           wm_raw_comm,
+                                           WHOLEMEMORY_MT_DISTRIBUTED,
+                                           WHOLEMEMORY_ML_DEVICE,
+                                           WHOLEMEMORY_MF_NO_ZERO_INIT));
     start[0] = 0;
     start[1] = 0;
     end[0]   = user_tensor_desc->sizes[0];
@@ -412,6 +450,10 @@ void embedding_base::deallocate() noexcept
     delete cache_ptr_;
     cache_ptr_ = nullptr;
   }
+  if (dirty_row_bitmap_ != nullptr) {
+    WM_CUDA_CHECK_NO_THROW(cudaFree(dirty_row_bitmap_));
+    dirty_row_bitmap_ = nullptr;
+  }
   WHOLEMEMORY_CHECK_NOTHROW(wholememory_destroy_tensor(user_embedding) == WHOLEMEMORY_SUCCESS);
   WHOLEMEMORY_CHECK_NOTHROW(wholememory_destroy_tensor(allocated_embedding) == WHOLEMEMORY_SUCCESS);
 }
@@ -459,6 +501,198 @@ wholememory_error_code_t embedding_base::drop_all_caches(cudaStream_t stream) co
   return WHOLEMEMORY_SUCCESS;
 }
 
+static constexpr char kDeltaFileMagic[8] = {'W', 'M', 'D', 'E', 'L', 'T', 'A', '1'};
+
+static void write_delta_data(FILE* fp, const void* data, size_t size, const std::string& file_name)
+{
+  if (size == 0) return;
+  if (fwrite(data, 1, size, fp) != size) {
+    WHOLEMEMORY_FAIL("write delta file %s failed.", file_name.c_str());
+  }
+}
+
+/*
+ * Delta file layout, all integers in native byte order:
+ *   magic "WMDELTA1", int64 total_row_count, int64 dirty_row_count, int32 tensor_count,
+ *   tensor_count x (int32 name_length, name, int64 row_bytes),
+ *   int64 global row ids [dirty_row_count] in ascending order,
+ *   tensor_count x row data [dirty_row_count x row_bytes].
+ */
+wholememory_error_code_t embedding_base::save_delta(const char* file_prefix,
+                                                    cudaStream_t stream) noexcept
+{
+  if (dirty_row_bitmap_ == nullptr) {
+    WHOLEMEMORY_ERROR("save_delta needs embedding created with optimizer.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  int world_rank = -1, world_size = -1;
+  WHOLEMEMORY_RETURN_ON_FAIL(wholememory_communicator_get_rank(&world_rank, raw_embedding_comm_));
+  WHOLEMEMORY_RETURN_ON_FAIL(wholememory_communicator_get_size(&world_size, raw_embedding_comm_));
+  std::string const file_name = std::string(file_prefix) + "_delta_part_" +
+                                std::to_string(world_rank) + "_of_" + std::to_string(world_size);
+  size_t const word_count = div_rounding_up_safe<int64_t>(local_row_count_, 32);
+  FILE* fp                = nullptr;
+  uint32_t* host_bitmap   = nullptr;
+  int64_t* host_indices   = nullptr;
+  char* host_rows         = nullptr;
+  bool rows_taken         = false;
+  // writeback may fail on any rank, its result goes to the failure agreement below.
+  auto const writeback_error_code = writeback_all_caches(stream);
+  auto error_code                 = writeback_error_code;
+  try {
+    if (writeback_error_code != WHOLEMEMORY_SUCCESS) {
+      WHOLEMEMORY_FAIL("writeback caches before save_delta failed.");
+    }
+    WM_CUDA_CHECK(
+      cudaMallocHost((void**)&host_bitmap, std::max<size_t>(word_count, 1) * sizeof(uint32_t)));
+    // dirty bits are cleared before rows are gathered, so rows updated meanwhile stay dirty.
+    WHOLEMEMORY_CHECK(wholememory_ops::take_dirty_rows(
+                        dirty_row_bitmap_, host_bitmap, word_count, stream) == WHOLEMEMORY_SUCCESS);
+    rows_taken = true;
+    WM_CUDA_CHECK(cudaStreamSynchronize(stream));
+    std::vector<int64_t> dirty_rows;
+    for (size_t word_id = 0; word_id < word_count; word_id++) {
+      uint32_t bits = host_bitmap[word_id];
+      while (bits != 0) {
+        dirty_rows.push_back(word_id * 32 + __builtin_ctz(bits));
+        bits &= bits - 1;
+      }
+    }
+    int64_t const dirty_row_count = dirty_rows.size();
+
+    std::vector<std::string> tensor_names     = {"embedding_tensor"};
+    std::vector<wholememory_tensor_t> tensors = {user_embedding};
+    auto* state_names                         = get_optimizer_state_names();
+    for (int i = 0; state_names != nullptr && state_names[i] != nullptr; i++) {
+      tensor_names.push_back(state_names[i]);
+      tensors.push_back(get_optimizer_state(state_names[i]));
+    }
+    int32_t const tensor_count = tensors.size();
+    std::vector<int64_t> row_bytes(tensor_count);
+    int64_t max_row_bytes = 1;
+    for (int i = 0; i < tensor_count; i++) {
+      auto* tensor_desc = wholememory_tensor_get_tensor_description(tensors[i]);
+      WHOLEMEMORY_CHECK(tensor_desc->dim == 2);
+      size_t const element_size = wholememory_dtype_get_element_size(tensor_desc->dtype);
+      row_bytes[i]              = tensor_desc->sizes[1] * element_size;
+      max_row_bytes             = std::max(max_row_bytes, row_bytes[i]);
+    }
+
+    fp = fopen(file_name.c_str(), "wb");
+    if (fp == nullptr) { WHOLEMEMORY_FAIL("open delta file %s failed.", file_name.c_str()); }
+    int64_t const total_row_count =
+      wholememory_tensor_get_tensor_description(user_embedding)->sizes[0];
+    write_delta_data(fp, kDeltaFileMagic, sizeof(kDeltaFileMagic), file_name);
+    write_delta_data(fp, &total_row_count, sizeof(int64_t), file_name);
+    write_delta_data(fp, &dirty_row_count, sizeof(int64_t), file_name);
+    write_delta_data(fp, &tensor_count, sizeof(int32_t), file_name);
+    for (int i = 0; i < tensor_count; i++) {
+      int32_t const name_length = tensor_names[i].size();
+      write_delta_data(fp, &name_length, sizeof(int32_t), file_name);
+      write_delta_data(fp, tensor_names[i].data(), name_length, file_name);
+      write_delta_data(fp, &row_bytes[i], sizeof(int64_t), file_name);
+    }
+    std::vector<int64_t> global_rows(dirty_rows);
+    for (auto& row : global_rows) {
+      row += optimizer_state_->local_start_index;
+    }
+    write_delta_data(fp, global_rows.data(), dirty_row_count * sizeof(int64_t), file_name);
+
+    // dirty rows are gathered on device into pinned buffers chunk by chunk
+    int64_t const chunk_row_count =
+      std::max<int64_t>(1, std::min<int64_t>(64 * 1024 * 1024 / max_row_bytes, dirty_row_count));
+    WM_CUDA_CHECK(cudaMallocHost((void**)&host_indices, chunk_row_count * sizeof(int64_t)));
+    WM_CUDA_CHECK(cudaMallocHost((void**)&host_rows, chunk_row_count * max_row_bytes));
+    for (int i = 0; i < tensor_count; i++) {
+      wholememory_tensor_t local_tensor;
+      WHOLEMEMORY_CHECK(wholememory_tensor_map_local_tensor(tensors[i], &local_tensor) ==
+                        WHOLEMEMORY_SUCCESS);
+      wholememory_matrix_description_t local_matrix_desc;
+      WHOLEMEMORY_CHECK(wholememory_convert_tensor_desc_to_matrix(
+        &local_matrix_desc, wholememory_tensor_get_tensor_description(local_tensor)));
+      auto local_gref = wholememory_create_continuous_global_reference(
+        wholememory_tensor_get_data_pointer(local_tensor));
+      for (int64_t start = 0; start < dirty_row_count; start += chunk_row_count) {
+        int64_t const count = std::min(chunk_row_count, dirty_row_count - start);
+        std::copy(dirty_rows.begin() + start, dirty_rows.begin() + start + count, host_indices);
+        wholememory_array_description_t indices_desc;
+        indices_desc.size           = count;
+        indices_desc.storage_offset = 0;
+        indices_desc.dtype          = WHOLEMEMORY_DT_INT64;
+        wholememory_matrix_description_t output_desc = local_matrix_desc;
+        output_desc.sizes[0]                         = count;
+        output_desc.stride                           = local_matrix_desc.sizes[1];
+        output_desc.storage_offset                   = 0;
+        WHOLEMEMORY_CHECK(wholememory_ops::gather_func(local_gref,
+                                                       local_matrix_desc,
+                                                       host_indices,
+                                                       indices_desc,
+                                                       host_rows,
+                                                       output_desc,
+                                                       stream) == WHOLEMEMORY_SUCCESS);
+        WM_CUDA_CHECK(cudaStreamSynchronize(stream));
+        write_delta_data(fp, host_rows, count * row_bytes[i], file_name);
+      }
+      WHOLEMEMORY_CHECK(wholememory_destroy_tensor(local_tensor) == WHOLEMEMORY_SUCCESS);
+    }
+    if (fclose(fp) != 0) {
+      fp = nullptr;
+      WHOLEMEMORY_FAIL("close delta file %s failed.", file_name.c_str());
+    }
+    fp = nullptr;
+  } catch (wholememory::logic_error& wle) {
+    WHOLEMEMORY_ERROR("%s", wle.what());
+    error_code = WHOLEMEMORY_LOGIC_ERROR;
+  } catch (wholememory::cuda_error& wce) {
+    WHOLEMEMORY_ERROR("%s", wce.what());
+    error_code = WHOLEMEMORY_CUDA_ERROR;
+  } catch (...) {
+    WHOLEMEMORY_ERROR("File %s, line %d, Unknown error", __FILE__, __LINE__);
+    error_code = WHOLEMEMORY_UNKNOW_ERROR;
+  }
+  if (writeback_error_code != WHOLEMEMORY_SUCCESS) error_code = writeback_error_code;
+  if (fp != nullptr) fclose(fp);
+  if (host_indices != nullptr) WM_CUDA_CHECK_NO_THROW(cudaFreeHost(host_indices));
+  if (host_rows != nullptr) WM_CUDA_CHECK_NO_THROW(cudaFreeHost(host_rows));
+  // all ranks agree on the result, delta of healthy ranks is useless when any rank failed.
+  int failed_count       = error_code != WHOLEMEMORY_SUCCESS ? 1 : 0;
+  int total_failed_count = 0;
+  try {
+    raw_embedding_comm_->host_allreduce(
+      &failed_count, &total_failed_count, 1, WHOLEMEMORY_DT_INT, ncclSum);
+  } catch (...) {
+    WHOLEMEMORY_ERROR("save_delta reduce failed status failed.");
+    total_failed_count = 1;
+    if (error_code == WHOLEMEMORY_SUCCESS) error_code = WHOLEMEMORY_COMMUNICATION_ERROR;
+  }
+  if (total_failed_count != 0 && rows_taken) {
+    // taken rows are marked dirty again, so a failed save loses nothing
+    auto restore_code =
+      wholememory_ops::restore_dirty_rows(dirty_row_bitmap_, host_bitmap, word_count, stream);
+    if (restore_code == WHOLEMEMORY_SUCCESS) {
+      WM_CUDA_CHECK_NO_THROW(cudaStreamSynchronize(stream));
+    } else {
+      WHOLEMEMORY_ERROR("restore dirty rows failed, rows of failed save_delta are lost.");
+    }
+  }
+  if (host_bitmap != nullptr) WM_CUDA_CHECK_NO_THROW(cudaFreeHost(host_bitmap));
+  if (total_failed_count != 0) {
+    WHOLEMEMORY_ERROR("save_delta failed on %d ranks.", total_failed_count);
+    return error_code != WHOLEMEMORY_SUCCESS ? error_code : WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t embedding_base::reset_dirty_rows(cudaStream_t stream) noexcept
+{
+  if (dirty_row_bitmap_ == nullptr) { return WHOLEMEMORY_SUCCESS; }
+  size_t const word_count = div_rounding_up_safe<int64_t>(local_row_count_, 32);
+  WM_CUDA_CHECK_NO_THROW(
+    cudaMemsetAsync(dirty_row_bitmap_, 0, word_count * sizeof(uint32_t), stream));
+  WM_CUDA_CHECK_NO_THROW(cudaStreamSynchronize(stream));
+  return WHOLEMEMORY_SUCCESS;
+}
+
 class noncached_embedding : public embedding_base {
  public:
   noncached_embedding()          = default;
@@ -786,66 +1020,15 @@ wholememory_error_code_t local_cached_global_readonly_embedding::gather(
   return WHOLEMEMORY_SUCCESS;
 }
 
-}  // namespace wholememory
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-wholememory_error_code_t wholememory_create_embedding_optimizer(
-  wholememory_embedding_optimizer_t* optimizer, wholememory_optimizer_type_t optimizer_type)
-{
-  return wholememory::create_embedding_optimizer(optimizer, optimizer_type);
-}
-
-wholememory_error_code_t wholememory_optimizer_set_parameter(
-  wholememory_embedding_optimizer_t optimizer, const char* parameter_name, void* value)
-{
-  return wholememory::optimizer_set_parameter(optimizer, parameter_name, value);
-}
-
-void wholememory_destroy_embedding_optimizer(wholememory_embedding_optimizer_t optimizer)
-{
-  wholememory::destroy_embedding_optimizer(optimizer);
-}
-
-wholememory_error_code_t wholememory_create_embedding_cache_policy(
-  wholememory_embedding_cache_policy_t* cache_policy,
-  wholememory_comm_t cache_level_comm,
-  wholememory_memory_type_t memory_type,
-  wholememory_memory_location_t memory_location,
-  wholememory_access_type_t access_type,
-  float cache_ratio)
-{
-  if (cache_ratio > 1.0F || cache_ratio < 1.0F / 512) {
-    WHOLEMEMORY_ERROR("cache_ratio should in range [1/512, 1.0]");
-    return WHOLEMEMORY_INVALID_VALUE;
-  }
-  auto* embedding_cache_policy                  = new wholememory_embedding_cache_policy_;
-  embedding_cache_policy->cache_comm            = cache_level_comm;
-  embedding_cache_policy->cache_memory_type     = memory_type;
-  embedding_cache_policy->cache_memory_location = memory_location;
-  embedding_cache_policy->access_type           = access_type;
-  embedding_cache_policy->cache_ratio           = cache_ratio;
-  *cache_policy                                 = embedding_cache_policy;
-  return WHOLEMEMORY_SUCCESS;
-}
-
-wholememory_error_code_t wholememory_destroy_embedding_cache_policy(
-  wholememory_embedding_cache_policy_t cache_policy)
-{
-  delete cache_policy;
-  return WHOLEMEMORY_SUCCESS;
-}
-
-wholememory_error_code_t wholememory_create_embedding(
+wholememory_error_code_t create_embedding(
   wholememory_embedding_t* wholememory_embedding,
   wholememory_tensor_description_t* embedding_description,
   wholememory_comm_t comm,
   wholememory_memory_type_t memory_type,
   wholememory_memory_location_t memory_location,
   wholememory_embedding_optimizer_t optimizer,
-  wholememory_embedding_cache_policy_t cache_policy)
+  wholememory_embedding_cache_policy_t cache_policy,
+  unsigned int malloc_flags)
 {
   wholememory_matrix_description_t embedding_matrix_description;
   if (!wholememory_convert_tensor_desc_to_matrix(&embedding_matrix_description,
@@ -853,7 +1036,7 @@ wholememory_error_code_t wholememory_create_embedding(
     WHOLEMEMORY_ERROR("wholememory_create_embedding input description must be 2D matrix");
     return WHOLEMEMORY_INVALID_INPUT;
   }
-  wholememory::embedding_base* embedding_impl_ptr = nullptr;
+  embedding_base* embedding_impl_ptr = nullptr;
   int embedding_world_size                        = 1;
   WHOLEMEMORY_RETURN_ON_FAIL(wholememory_communicator_get_size(&embedding_world_size, comm));
   if (cache_policy != nullptr) {
@@ -876,7 +1059,7 @@ wholememory_error_code_t wholememory_create_embedding(
           "type is distributed.");
         return WHOLEMEMORY_INVALID_INPUT;
       }
-      embedding_impl_ptr = new wholememory::device_cached_host_embedding();
+      embedding_impl_ptr = new device_cached_host_embedding();
     } else {
       int const cache_world_size = 1;
       WHOLEMEMORY_RETURN_ON_FAIL(
@@ -904,19 +1087,95 @@ wholememory_error_code_t wholememory_create_embedding(
         WHOLEMEMORY_ERROR("optimizer not supported for local cached global readonly embedding.");
         return WHOLEMEMORY_INVALID_INPUT;
       }
-      embedding_impl_ptr = new wholememory::local_cached_global_readonly_embedding();
+      embedding_impl_ptr = new local_cached_global_readonly_embedding();
     }
   } else {
-    embedding_impl_ptr = new wholememory::noncached_embedding();
+    embedding_impl_ptr = new noncached_embedding();
   }
 
-  WHOLEMEMORY_RETURN_ON_FAIL(embedding_impl_ptr->allocate(
-    &embedding_matrix_description, comm, memory_type, memory_location, cache_policy, optimizer));
+  WHOLEMEMORY_RETURN_ON_FAIL(embedding_impl_ptr->allocate(&embedding_matrix_description,
+                                                          comm,
+                                                          memory_type,
+                                                          memory_location,
+                                                          cache_policy,
+                                                          optimizer,
+                                                          malloc_flags));
 
   *wholememory_embedding = static_cast<wholememory_embedding_t>(embedding_impl_ptr);
   return WHOLEMEMORY_SUCCESS;
 }
 
+}  // namespace wholememory
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+wholememory_error_code_t wholememory_create_embedding_optimizer(
+  wholememory_embedding_optimizer_t* optimizer, wholememory_optimizer_type_t optimizer_type)
+{
+  return wholememory::create_embedding_optimizer(optimizer, optimizer_type);
+}
+
+wholememory_error_code_t wholememory_optimizer_set_parameter(
+  wholememory_embedding_optimizer_t optimizer, const char* parameter_name, void* value)
+{
+  return wholememory::optimizer_set_parameter(optimizer, parameter_name, value);
+}
+
+void wholememory_destroy_embedding_optimizer(wholememory_embedding_optimizer_t optimizer)
+{
+  wholememory::destroy_embedding_optimizer(optimizer);
+}
+
+wholememory_error_code_t wholememory_create_embedding_cache_policy(
+  wholememory_embedding_cache_policy_t* cache_policy,
+  wholememory_comm_t cache_level_comm,
+  wholememory_memory_type_t memory_type,
+  wholememory_memory_location_t memory_location,
+  wholememory_access_type_t access_type,
+  float cache_ratio)
+{
+  if (cache_ratio > 1.0F || cache_ratio < 1.0F / 512) {
+    WHOLEMEMORY_ERROR("cache_ratio should in range [1/512, 1.0]");
+    return WHOLEMEMORY_INVALID_VALUE;
+  }
+  auto* embedding_cache_policy                  = new wholememory_embedding_cache_policy_;
+  embedding_cache_policy->cache_comm            = cache_level_comm;
+  embedding_cache_policy->cache_memory_type     = memory_type;
+  embedding_cache_policy->cache_memory_location = memory_location;
+  embedding_cache_policy->access_type           = access_type;
+  embedding_cache_policy->cache_ratio           = cache_ratio;
+  *cache_policy                                 = embedding_cache_policy;
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t wholememory_destroy_embedding_cache_policy(
+  wholememory_embedding_cache_policy_t cache_policy)
+{
+  delete cache_policy;
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t wholememory_create_embedding(
+  wholememory_embedding_t* wholememory_embedding,
+  wholememory_tensor_description_t* embedding_description,
+  wholememory_comm_t comm,
+  wholememory_memory_type_t memory_type,
+  wholememory_memory_location_t memory_location,
+  wholememory_embedding_optimizer_t optimizer,
+  wholememory_embedding_cache_policy_t cache_policy)
+{
+  return wholememory::create_embedding(wholememory_embedding,
+                                       embedding_description,
+                                       comm,
+                                       memory_type,
+                                       memory_location,
+                                       optimizer,
+                                       cache_policy,
+                                       0);
+}
+
 wholememory_error_code_t wholememory_destroy_embedding(
   wholememory_embedding_t wholememory_embedding)
 {
@@ -934,6 +1193,7 @@ wholememory_error_code_t wholememory_embedding_gather(wholememory_embedding_t wh
                                                       int64_t stream_int)
 {
   auto* embedding_impl_ptr = static_cast<wholememory::embedding_base*>(wholememory_embedding);
+  wholememory::temp_memory_stream_guard stream_guard((cudaStream_t)stream_int);
   return embedding_impl_ptr->gather(
     indices, output, adjust_cache, p_env_fns, (cudaStream_t)stream_int);
 }
@@ -948,6 +1208,7 @@ wholememory_error_code_t wholememory_embedding_gather_gradient_apply(
   int64_t stream_int)
 {
   auto* embedding_impl_ptr = static_cast<wholememory::embedding_base*>(wholememory_embedding);
+  wholememory::temp_memory_stream_guard stream_guard((cudaStream_t)stream_int);
   return embedding_impl_ptr->gather_gradient_apply(
     indices, grads, adjust_cache, lr, p_env_fns, (cudaStream_t)stream_int);
 }
@@ -980,6 +1241,7 @@ wholememory_error_code_t wholememory_embedding_writeback_cache(
   wholememory_embedding_t wholememory_embedding, int64_t stream_int)
 {
   cudaStream_t stream = reinterpret_cast<cudaStream_t>(stream_int);
+  wholememory::temp_memory_stream_guard stream_guard(stream);
   return static_cast<wholememory::embedding_base*>(wholememory_embedding)
     ->writeback_all_caches(stream);
 }
@@ -988,9 +1250,77 @@ wholememory_error_code_t wholememory_embedding_drop_all_cache(
   wholememory_embedding_t wholememory_embedding, int64_t stream_int)
 {
   cudaStream_t stream = reinterpret_cast<cudaStream_t>(stream_int);
+  wholememory::temp_memory_stream_guard stream_guard(stream);
   return static_cast<wholememory::embedding_base*>(wholememory_embedding)->drop_all_caches(stream);
 }
 
+wholememory_error_code_t wholememory_embedding_save_delta(
+  wholememory_embedding_t wholememory_embedding, const char* file_prefix, int64_t stream_int)
+{
+  if (wholememory_embedding == nullptr || file_prefix == nullptr) {
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  cudaStream_t stream = reinterpret_cast<cudaStream_t>(stream_int);
+  wholememory::temp_memory_stream_guard stream_guard(stream);
+  return static_cast<wholememory::embedding_base*>(wholememory_embedding)
+    ->save_delta(file_prefix, stream);
+}
+
+wholememory_error_code_t wholememory_embedding_reset_dirty_rows(
+  wholememory_embedding_t wholememory_embedding, int64_t stream_int)
+{
+  if (wholememory_embedding == nullptr) { return WHOLEMEMORY_INVALID_INPUT; }
+  cudaStream_t stream = reinterpret_cast<cudaStream_t>(stream_int);
+  wholememory::temp_memory_stream_guard stream_guard(stream);
+  return static_cast<wholememory::embedding_base*>(wholememory_embedding)
+    ->reset_dirty_rows(stream);
+}
+
+wholememory_error_code_t wholememory_embedding_start_snapshot(
+  wholememory_embedding_snapshot_t* snapshot,
+  wholememory_embedding_t wholememory_embedding,
+  const char* file_prefix,
+  int64_t stream_int)
+{
+  if (snapshot == nullptr || wholememory_embedding == nullptr || file_prefix == nullptr) {
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  cudaStream_t stream = reinterpret_cast<cudaStream_t>(stream_int);
+  wholememory::temp_memory_stream_guard stream_guard(stream);
+  auto* snapshot_impl = new wholememory::embedding_snapshot();
+  auto error_code     = snapshot_impl->start(
+    static_cast<wholememory::embedding_base*>(wholememory_embedding), file_prefix, stream);
+  if (error_code != WHOLEMEMORY_SUCCESS) {
+    delete snapshot_impl;
+    return error_code;
+  }
+  *snapshot = snapshot_impl;
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t wholememory_embedding_snapshot_is_done(
+  int* is_done, wholememory_embedding_snapshot_t snapshot)
+{
+  if (is_done == nullptr || snapshot == nullptr) { return WHOLEMEMORY_INVALID_INPUT; }
+  *is_done = static_cast<wholememory::embedding_snapshot*>(snapshot)->is_done() ? 1 : 0;
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t wholememory_embedding_snapshot_wait(
+  wholememory_embedding_snapshot_t snapshot)
+{
+  if (snapshot == nullptr) { return WHOLEMEMORY_INVALID_INPUT; }
+  return static_cast<wholememory::embedding_snapshot*>(snapshot)->wait();
+}
+
+wholememory_error_code_t wholememory_destroy_embedding_snapshot(
+  wholememory_embedding_snapshot_t snapshot)
+{
+  if (snapshot == nullptr) { return WHOLEMEMORY_INVALID_INPUT; }
+  delete static_cast<wholememory::embedding_snapshot*>(snapshot);
+  return WHOLEMEMORY_SUCCESS;
+}
+
 #ifdef __cplusplus
 }
 #endif
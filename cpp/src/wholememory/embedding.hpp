@@ -46,7 +46,8 @@ class embedding_base : public wholememory_embedding_ {
                                     wholememory_memory_type_t memory_type,
                                     wholememory_memory_location_t memory_location,
                                     wholememory_embedding_cache_policy_t policy,
-                                    wholememory_embedding_optimizer_t opt) noexcept;
+                                    wholememory_embedding_optimizer_t opt,
+                                    unsigned int malloc_flags = 0) noexcept;
   void deallocate() noexcept;
   virtual wholememory_error_code_t gather(wholememory_tensor_t indices,
                                           wholememory_tensor_t output,
@@ -79,6 +80,8 @@ class embedding_base : public wholememory_embedding_ {
   virtual wholememory_error_code_t writeback_all_caches(cudaStream_t stream) const noexcept;
   virtual wholememory_error_code_t drop_embedding_cache(cudaStream_t stream) const noexcept;
   virtual wholememory_error_code_t drop_all_caches(cudaStream_t stream) const noexcept;
+  wholememory_error_code_t save_delta(const char* file_prefix, cudaStream_t stream) noexcept;
+  wholememory_error_code_t reset_dirty_rows(cudaStream_t stream) noexcept;
 
   wholememory::embedding_cache_base* get_cache_ptr() const { return cache_ptr_; }
 
@@ -100,6 +103,23 @@ class embedding_base : public wholememory_embedding_ {
   wholememory::embedding_cache_base* cache_ptr_                    = nullptr;
   wholememory::embedding_optimizer_impl_base* optimizer_impl_base_ = nullptr;
   std::unique_ptr<wholememory::optimizer_state_t> optimizer_state_ = nullptr;
+
+  // one bit per local row, set by optimizer step and cleared by save_delta
+  uint32_t* dirty_row_bitmap_ = nullptr;
+  int64_t local_row_count_    = 0;
 };
 
+/**
+ * Same as wholememory_create_embedding, malloc_flags of wholememory_malloc_flags_t apply to the
+ * allocation of embedding, not to its cache.
+ */
+wholememory_error_code_t create_embedding(wholememory_embedding_t* wholememory_embedding,
+                                          wholememory_tensor_description_t* embedding_description,
+                                          wholememory_comm_t comm,
+                                          wholememory_memory_type_t memory_type,
+                                          wholememory_memory_location_t memory_location,
+                                          wholememory_embedding_optimizer_t optimizer,
+                                          wholememory_embedding_cache_policy_t cache_policy,
+                                          unsigned int malloc_flags);
+
 }  // namespace wholememory
@@ -20,6 +20,7 @@
 #include "integer_utils.hpp"
 #include "logger.hpp"
 #include "memory_handle.hpp"
+#include "memory_usage.hpp"
 #include "wholememory_ops/functions/embedding_cache_func.h"
 
 namespace wholememory {
@@ -191,6 +192,7 @@ wholememory_error_code_t embedding_cache_base::allocate(
   cache_line_meta_desc.sizes[0]       = total_cache_set_count;
   cache_line_meta_desc.sizes[1] = cache_line_meta_desc.strides[0] = kCacheSetSize;
   cache_line_meta_desc.strides[1]                                 = 1;
+  memory_purpose_guard purpose_guard(WHOLEMEMORY_MP_EMBEDDING_CACHE);
   WHOLEMEMORY_RETURN_ON_FAIL(wholememory_create_tensor(&cache_line_tag_wm_tensor_,
                                                        &cache_line_meta_desc,
                                                        cache_policy_->cache_comm,
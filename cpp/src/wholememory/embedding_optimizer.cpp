@@ -20,7 +20,9 @@
 #include "cuda_macros.hpp"
 #include "logger.hpp"
 #include "wholememory/embedding.hpp"
+#include "wholememory/memory_fill.hpp"
 #include "wholememory_ops/functions/embedding_optimizer_func.h"
+#include "wholememory_ops/functions/host_gather_scatter_func.h"
 
 namespace wholememory {
 
@@ -38,7 +40,9 @@ optimizer_parameter_setter_fn_t embedding_optimizer_impl_base::get_float_setter(
   return std::bind(float_setter_fn, target, std::placeholders::_1);
 }
 
-void embedding_optimizer_impl_base::zero_local_state_tensor(wholememory_tensor_t local_state_tensor)
+void embedding_optimizer_impl_base::fill_local_state_tensor(wholememory_tensor_t local_state_tensor,
+                                                            const void* value,
+                                                            size_t value_size)
 {
   void* local_ptr        = wholememory_tensor_get_data_pointer(local_state_tensor);
   auto* local_state_desc = wholememory_tensor_get_tensor_description(local_state_tensor);
@@ -46,20 +50,26 @@ void embedding_optimizer_impl_base::zero_local_state_tensor(wholememory_tensor_t
   size_t total_elt_count = wholememory_get_memory_element_count_from_tensor(local_state_desc);
   size_t elt_size        = wholememory_dtype_get_element_size(local_state_desc->dtype);
   size_t total_size      = total_elt_count * elt_size;
-  WM_CUDA_CHECK_NO_THROW(cudaMemset(local_ptr, 0, total_size));
-  WM_CUDA_CHECK_NO_THROW(cudaDeviceSynchronize());
+  // states of host memory embedding are filled by host threads, saves the pass through PCIe.
+  if (wholememory_ops::is_host_memory_pointer(local_ptr)) {
+    host_fill_memory(local_ptr, total_size, value, value_size);
+  } else {
+    device_fill_memory(local_ptr, total_size, value, value_size);
+  }
+}
+
+void embedding_optimizer_impl_base::zero_local_state_tensor(wholememory_tensor_t local_state_tensor)
+{
+  const char zero = 0;
+  fill_local_state_tensor(local_state_tensor, &zero, sizeof(zero));
 }
 
 void embedding_optimizer_impl_base::set_float_local_state_tensor(
   wholememory_tensor_t local_state_tensor, float value)
 {
-  void* local_ptr        = wholememory_tensor_get_data_pointer(local_state_tensor);
   auto* local_state_desc = wholememory_tensor_get_tensor_description(local_state_tensor);
-  WHOLEMEMORY_CHECK_NOTHROW(local_state_desc->storage_offset == 0);
-  size_t total_elt_count = wholememory_get_memory_element_count_from_tensor(local_state_desc);
-  wholememory_ops::set_memory_to_float_value(
-    static_cast<float*>(local_ptr), value, total_elt_count, nullptr);
-  WM_CUDA_CHECK_NO_THROW(cudaDeviceSynchronize());
+  WHOLEMEMORY_CHECK_NOTHROW(local_state_desc->dtype == WHOLEMEMORY_DT_FLOAT);
+  fill_local_state_tensor(local_state_tensor, &value, sizeof(value));
 }
 
 wholememory_error_code_t embedding_optimizer_impl_base::set_parameter(const char* parameter_name,
@@ -125,6 +125,10 @@ class embedding_optimizer_impl_base : public wholememory_embedding_optimizer_ {
 
  protected:
   static optimizer_parameter_setter_fn_t get_float_setter(float* target_ptr);
+  // fills local state tensor with repeated value of 1, 2 or 4 bytes, returns after it is filled.
+  static void fill_local_state_tensor(wholememory_tensor_t local_state_tensor,
+                                      const void* value,
+                                      size_t value_size);
   static void zero_local_state_tensor(wholememory_tensor_t local_state_tensor);
   static void set_float_local_state_tensor(wholememory_tensor_t local_state_tensor, float value);
 
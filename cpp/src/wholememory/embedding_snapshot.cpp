@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "embedding_snapshot.hpp"
+
+#include <cstdio>
+
+#include "cuda_macros.hpp"
+#include "embedding.hpp"
+#include "error.hpp"
+#include "logger.hpp"
+
+namespace wholememory {
+
+embedding_snapshot::~embedding_snapshot()
+{
+  if (writer_thread_.joinable()) { writer_thread_.join(); }
+  free_staging_buffers();
+  if (copy_done_event_ != nullptr) { WM_CUDA_CHECK_NO_THROW(cudaEventDestroy(copy_done_event_)); }
+}
+
+void embedding_snapshot::free_staging_buffers() noexcept
+{
+  for (auto& staging_tensor : staging_tensors_) {
+    if (staging_tensor.host_ptr != nullptr) {
+      WM_CUDA_CHECK_NO_THROW(cudaFreeHost(staging_tensor.host_ptr));
+      staging_tensor.host_ptr = nullptr;
+    }
+  }
+}
+
+wholememory_error_code_t embedding_snapshot::start(embedding_base* embedding,
+                                                   const char* file_prefix,
+                                                   cudaStream_t stream) noexcept
+{
+  // mapped local tensor of the state being copied, destroyed on error.
+  wholememory_tensor_t local_tensor = nullptr;
+  auto destroy_local_tensor         = [&local_tensor]() {
+    if (local_tensor != nullptr) {
+      wholememory_destroy_tensor(local_tensor);
+      local_tensor = nullptr;
+    }
+  };
+  try {
+    wholememory_comm_t wm_comm;
+    int world_rank = -1, world_size = -1;
+    WHOLEMEMORY_RETURN_ON_FAIL(wholememory_get_communicator(
+      &wm_comm, wholememory_tensor_get_memory_handle(embedding->user_embedding)));
+    WHOLEMEMORY_RETURN_ON_FAIL(wholememory_communicator_get_rank(&world_rank, wm_comm));
+    WHOLEMEMORY_RETURN_ON_FAIL(wholememory_communicator_get_size(&world_size, wm_comm));
+    WM_CUDA_CHECK(cudaGetDevice(&dev_id_));
+
+    std::vector<std::string> tensor_names     = {"embedding_tensor"};
+    std::vector<wholememory_tensor_t> tensors = {embedding->user_embedding};
+    auto* state_names                         = embedding->get_optimizer_state_names();
+    for (int i = 0; state_names != nullptr && state_names[i] != nullptr; i++) {
+      tensor_names.push_back(state_names[i]);
+      tensors.push_back(embedding->get_optimizer_state(state_names[i]));
+    }
+
+    // cached rows are written back first so staging copies see latest values
+    WHOLEMEMORY_RETURN_ON_FAIL(embedding->writeback_all_caches(stream));
+    for (size_t i = 0; i < tensors.size(); i++) {
+      WHOLEMEMORY_RETURN_ON_FAIL(wholememory_tensor_map_local_tensor(tensors[i], &local_tensor));
+      auto* local_desc = wholememory_tensor_get_tensor_description(local_tensor);
+      WHOLEMEMORY_CHECK(local_desc->dim == 2);
+      size_t const element_size = wholememory_dtype_get_element_size(local_desc->dtype);
+      size_t const row_count    = local_desc->sizes[0];
+      size_t const row_bytes    = local_desc->sizes[1] * element_size;
+      staging_tensor staging;
+      staging.file_name = std::string(file_prefix) + "_" + tensor_names[i] + "_part_" +
+                          std::to_string(world_rank) + "_of_" + std::to_string(world_size);
+      staging.size      = row_count * row_bytes;
+      if (staging.size > 0) {
+        WM_CUDA_CHECK(cudaMallocHost((void**)&staging.host_ptr, staging.size));
+      }
+      staging_tensors_.push_back(staging);
+      if (staging.size > 0) {
+        WM_CUDA_CHECK(cudaMemcpy2DAsync(staging.host_ptr,
+                                        row_bytes,
+                                        wholememory_tensor_get_data_pointer(local_tensor),
+                                        local_desc->strides[0] * element_size,
+                                        row_bytes,
+                                        row_count,
+                                        cudaMemcpyDefault,
+                                        stream));
+      }
+      auto tensor_to_destroy = local_tensor;
+      local_tensor           = nullptr;
+      WHOLEMEMORY_RETURN_ON_FAIL(wholememory_destroy_tensor(tensor_to_destroy));
+    }
+    WM_CUDA_CHECK(cudaEventCreateWithFlags(&copy_done_event_, cudaEventDisableTiming));
+    WM_CUDA_CHECK(cudaEventRecord(copy_done_event_, stream));
+    writer_thread_ = std::thread([this]() { write_files(); });
+  } catch (wholememory::logic_error& wle) {
+    WHOLEMEMORY_ERROR("%s", wle.what());
+    destroy_local_tensor();
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (wholememory::cuda_error& wce) {
+    WHOLEMEMORY_ERROR("%s", wce.what());
+    destroy_local_tensor();
+    return WHOLEMEMORY_CUDA_ERROR;
+  } catch (...) {
+    WHOLEMEMORY_ERROR("File %s, line %d, Unknown error", __FILE__, __LINE__);
+    destroy_local_tensor();
+    return WHOLEMEMORY_UNKNOW_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+void embedding_snapshot::write_files() noexcept
+{
+  try {
+    WM_CUDA_CHECK(cudaSetDevice(dev_id_));
+    WM_CUDA_CHECK(cudaEventSynchronize(copy_done_event_));
+    for (auto& staging_tensor : staging_tensors_) {
+      FILE* fp = fopen(staging_tensor.file_name.c_str(), "wb");
+      if (fp == nullptr) {
+        WHOLEMEMORY_FAIL("open snapshot file %s failed.", staging_tensor.file_name.c_str());
+      }
+      size_t const written =
+        staging_tensor.size > 0 ? fwrite(staging_tensor.host_ptr, 1, staging_tensor.size, fp) : 0;
+      int const close_ret = fclose(fp);
+      if (written != staging_tensor.size || close_ret != 0) {
+        WHOLEMEMORY_FAIL("write snapshot file %s failed.", staging_tensor.file_name.c_str());
+      }
+      // release staging memory as soon as each tensor is on disk
+      if (staging_tensor.host_ptr != nullptr) {
+        WM_CUDA_CHECK(cudaFreeHost(staging_tensor.host_ptr));
+        staging_tensor.host_ptr = nullptr;
+      }
+    }
+  } catch (wholememory::logic_error& wle) {
+    WHOLEMEMORY_ERROR("%s", wle.what());
+    error_code_ = WHOLEMEMORY_LOGIC_ERROR;
+  } catch (wholememory::cuda_error& wce) {
+    WHOLEMEMORY_ERROR("%s", wce.what());
+    error_code_ = WHOLEMEMORY_CUDA_ERROR;
+  } catch (...) {
+    WHOLEMEMORY_ERROR("File %s, line %d, Unknown error", __FILE__, __LINE__);
+    error_code_ = WHOLEMEMORY_UNKNOW_ERROR;
+  }
+  finished_.store(true);
+}
+
+wholememory_error_code_t embedding_snapshot::wait() noexcept
+{
+  if (writer_thread_.joinable()) { writer_thread_.join(); }
+  return error_code_;
+}
+
+}  // namespace wholememory
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime_api.h>
+
+#include <wholememory/embedding.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct wholememory_embedding_snapshot_ {};
+
+#ifdef __cplusplus
+}
+#endif
+
+namespace wholememory {
+
+class embedding_base;
+
+/**
+ * Snapshot of local partition of embedding and its optimizer states. start copies local data into
+ * pinned staging buffers on stream and returns, a background thread waits for the copies and
+ * writes files in the same layout as WholeMemoryEmbedding.save.
+ */
+class embedding_snapshot : public wholememory_embedding_snapshot_ {
+ public:
+  embedding_snapshot() = default;
+  ~embedding_snapshot();
+  embedding_snapshot(const embedding_snapshot&)            = delete;
+  embedding_snapshot& operator=(const embedding_snapshot&) = delete;
+
+  wholememory_error_code_t start(embedding_base* embedding,
+                                 const char* file_prefix,
+                                 cudaStream_t stream) noexcept;
+  [[nodiscard]] bool is_done() const noexcept { return finished_.load(); }
+  wholememory_error_code_t wait() noexcept;
+
+ private:
+  struct staging_tensor {
+    std::string file_name;
+    char* host_ptr = nullptr;
+    size_t size    = 0;
+  };
+  void write_files() noexcept;
+  void free_staging_buffers() noexcept;
+
+  std::vector<staging_tensor> staging_tensors_;
+  cudaEvent_t copy_done_event_ = nullptr;
+  int dev_id_                  = -1;
+  std::thread writer_thread_;
+  std::atomic<bool> finished_          = false;
+  wholememory_error_code_t error_code_ = WHOLEMEMORY_SUCCESS;
+};
+
+}  // namespace wholememory
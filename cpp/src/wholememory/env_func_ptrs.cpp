@@ -15,14 +15,20 @@
  */
 #include <wholememory/env_func_ptrs.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "cuda_macros.hpp"
 #include "error.hpp"
 #include "initialize.hpp"
+#include "memory_usage.hpp"
 
 namespace wholememory {
 
@@ -32,6 +38,7 @@ void default_create_memory_context_func(void** memory_context, void* /*global_co
   wholememory_initialize_tensor_desc(&default_memory_context->desc);
   default_memory_context->ptr             = nullptr;
   default_memory_context->allocation_type = WHOLEMEMORY_MA_NONE;
+  default_memory_context->device_id       = -1;
   *memory_context                         = default_memory_context;
 }
 
@@ -87,104 +94,216 @@ void default_free_func(void* memory_context, void* /*global_context*/)
   default_memory_context->allocation_type = WHOLEMEMORY_MA_NONE;
 }
 
-static wholememory_env_func_t default_env_func = {
-  .temporary_fns =
-    {
-      .create_memory_context_fn  = default_create_memory_context_func,
-      .destroy_memory_context_fn = default_destroy_memory_context_func,
-      .malloc_fn                 = default_malloc_func,
-      .free_fn                   = default_free_func,
-      .global_context            = nullptr,
-    },
-  .output_fns = {
-    .malloc_fn      = default_malloc_func,
-    .free_fn        = default_free_func,
-    .global_context = nullptr,
-  }};
+namespace {
 
-wholememory_env_func_t* get_default_env_func() { return &default_env_func; }
+thread_local cudaStream_t temp_memory_stream = nullptr;
+// nullptr is a valid stream, so whether a guard is active is kept separately.
+thread_local bool temp_memory_stream_set = false;
 
-class ChunkedMemoryPool {
+// 4 size classes for each power of 2, so at most 1/4 of a block is wasted.
+constexpr int kSizeClassPerPowerOfTwo = 4;
+constexpr size_t kMinBlockSize        = 256;
+
+size_t GetSizeClass(size_t size)
+{
+  if (size <= kMinBlockSize) return kMinBlockSize;
+  int power   = 63 - __builtin_clzll(size);
+  size_t step = (1ULL << power) / kSizeClassPerPowerOfTwo;
+  return (size + step - 1) / step * step;
+}
+
+}  // namespace
+
+temp_memory_stream_guard::temp_memory_stream_guard(cudaStream_t stream)
+  : old_stream_(temp_memory_stream), old_stream_set_(temp_memory_stream_set)
+{
+  temp_memory_stream     = stream;
+  temp_memory_stream_set = true;
+}
+
+temp_memory_stream_guard::~temp_memory_stream_guard()
+{
+  temp_memory_stream     = old_stream_;
+  temp_memory_stream_set = old_stream_set_;
+}
+
+cudaStream_t get_temp_memory_stream() { return temp_memory_stream; }
+
+/**
+ * @brief : Caching pool of one kind of memory. Freed blocks are cached by size class, and reused
+ * by later allocations of the same size class. For stream ordered memory, blocks are cached per
+ * stream of temp_memory_stream_guard and only reused on the stream they were allocated on, so a
+ * block is never handed to another stream while kernels of its last user may still be running.
+ * Blocks allocated from system, including cached ones, are accounted as temporary memory usage.
+ */
+class CachingMemoryPool {
  public:
-  ChunkedMemoryPool();
-  ~ChunkedMemoryPool();
+  CachingMemoryPool(bool stream_ordered, wholememory_memory_allocation_type_t allocation_type)
+    : stream_ordered_(stream_ordered),
+      usage_category_{allocation_type, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_TEMPORARY}
+  {
+  }
+  virtual ~CachingMemoryPool() = default;
   void* CachedMalloc(size_t size);
-  void CachedFree(void* ptr, size_t size);
-  void EmptyCache();
+  void CachedFree(void* ptr);
+  void Trim(size_t max_cached_bytes);
+  temp_memory_stats_t GetStats();
+  void ResetPeakStats();
+
+ protected:
   virtual void* MallocFnImpl(size_t size) = 0;
   virtual void FreeFnImpl(void* ptr)      = 0;
 
  private:
-  static constexpr int kBucketCount = 64;
-  std::vector<std::unique_ptr<std::mutex>> mutexes_;
-  std::vector<std::queue<void*>> sized_pool_;
+  // default streams may be per thread, so blocks of them are not shared between threads.
+  using stream_key = std::pair<cudaStream_t, std::thread::id>;
+  struct block_info {
+    size_t size;
+    stream_key stream;
+  };
+  using size_pool = std::map<size_t, std::vector<void*>>;
+  stream_key GetCurrentStreamKey() const;
+  // pops a cached block, and erases its size class and stream if no block is left in them.
+  void* PopFreeBlockLocked(std::map<stream_key, size_pool>::iterator stream_pool,
+                           size_pool::iterator free_blocks);
+  void TrimLocked(size_t max_cached_bytes);
+
+  const bool stream_ordered_;
+  const memory_usage_category usage_category_;
+  std::mutex mu_;
+  // only non empty size classes and streams are kept, so streams no longer used are released
+  // when their blocks are reused or trimmed.
+  std::map<stream_key, size_pool> free_blocks_;
+  std::unordered_map<void*, block_info> allocated_blocks_;
+  temp_memory_stats_t stats_{};
 };
-static size_t GetChunkIndex(size_t size)
+
+CachingMemoryPool::stream_key CachingMemoryPool::GetCurrentStreamKey() const
 {
-  if (size == 0) return 0;
-  int power           = 0;
-  size_t shifted_size = size;
-  while (shifted_size) {
-    shifted_size >>= 1;
-    power++;
-  }
-  if ((size & (size - 1)) == 0) {
-    return power - 1;
-  } else {
-    return power;
+  if (!stream_ordered_) return stream_key(nullptr, std::thread::id());
+  // without the stream of its user, a block may be reused while kernels still access it.
+  WHOLEMEMORY_EXPECTS(temp_memory_stream_set,
+                      "device or pinned temporary memory allocated out of stream guard.");
+  cudaStream_t stream = get_temp_memory_stream();
+  if (stream == nullptr || stream == cudaStreamPerThread) {
+    return stream_key(stream, std::this_thread::get_id());
   }
+  return stream_key(stream, std::thread::id());
 }
-ChunkedMemoryPool::ChunkedMemoryPool()
+
+void* CachingMemoryPool::CachedMalloc(size_t size)
 {
-  sized_pool_.resize(kBucketCount);
-  mutexes_.resize(kBucketCount);
-  for (int i = 0; i < kBucketCount; i++) {
-    mutexes_[i] = std::make_unique<std::mutex>();
+  size_t const block_size = GetSizeClass(size);
+  stream_key const stream = GetCurrentStreamKey();
+  std::unique_lock<std::mutex> mlock(mu_);
+  stats_.malloc_count++;
+  void* ptr        = nullptr;
+  auto stream_pool = free_blocks_.find(stream);
+  auto free_blocks = stream_pool != free_blocks_.end() ? stream_pool->second.find(block_size)
+                                                       : size_pool::iterator();
+  if (stream_pool != free_blocks_.end() && free_blocks != stream_pool->second.end()) {
+    ptr = PopFreeBlockLocked(stream_pool, free_blocks);
+    stats_.cached_bytes -= block_size;
+    stats_.cache_hit_count++;
+  } else {
+    try {
+      ptr = MallocFnImpl(block_size);
+    } catch (wholememory::cuda_error&) {
+      (void)cudaGetLastError();
+      ptr = nullptr;
+    }
+    if (ptr == nullptr && stats_.cached_bytes > 0) {
+      // cached blocks of other sizes or streams may be what is missing, free them and retry.
+      TrimLocked(0);
+      ptr = MallocFnImpl(block_size);
+    }
+    if (ptr == nullptr) return nullptr;
+    record_memory_alloc(usage_category_, block_size);
   }
+  allocated_blocks_.emplace(ptr, block_info{block_size, stream});
+  stats_.allocated_bytes += block_size;
+  stats_.peak_allocated_bytes = std::max(stats_.peak_allocated_bytes, stats_.allocated_bytes);
+  stats_.peak_reserved_bytes =
+    std::max(stats_.peak_reserved_bytes, stats_.allocated_bytes + stats_.cached_bytes);
+  return ptr;
 }
-ChunkedMemoryPool::~ChunkedMemoryPool() {}
-void* ChunkedMemoryPool::CachedMalloc(size_t size)
+
+void CachingMemoryPool::CachedFree(void* ptr)
 {
-  size_t chunked_index = GetChunkIndex(size);
-  std::unique_lock<std::mutex> mlock(*mutexes_[chunked_index]);
-  if (!sized_pool_[chunked_index].empty()) {
-    void* ptr = sized_pool_[chunked_index].front();
-    sized_pool_[chunked_index].pop();
-    return ptr;
-  } else {
-    return MallocFnImpl(1ULL << chunked_index);
-  }
-  return nullptr;
+  std::unique_lock<std::mutex> mlock(mu_);
+  auto it = allocated_blocks_.find(ptr);
+  WHOLEMEMORY_CHECK(it != allocated_blocks_.end());
+  block_info const block = it->second;
+  allocated_blocks_.erase(it);
+  free_blocks_[block.stream][block.size].push_back(ptr);
+  stats_.allocated_bytes -= block.size;
+  stats_.cached_bytes += block.size;
 }
-void ChunkedMemoryPool::CachedFree(void* ptr, size_t size)
+
+void* CachingMemoryPool::PopFreeBlockLocked(std::map<stream_key, size_pool>::iterator stream_pool,
+                                             size_pool::iterator free_blocks)
 {
-  size_t chunked_index = GetChunkIndex(size);
-  std::unique_lock<std::mutex> mlock(*mutexes_[chunked_index]);
-  sized_pool_[chunked_index].push(ptr);
+  void* ptr = free_blocks->second.back();
+  free_blocks->second.pop_back();
+  if (free_blocks->second.empty()) stream_pool->second.erase(free_blocks);
+  if (stream_pool->second.empty()) free_blocks_.erase(stream_pool);
+  return ptr;
 }
-void ChunkedMemoryPool::EmptyCache()
+
+void CachingMemoryPool::TrimLocked(size_t max_cached_bytes)
 {
-  for (int i = 0; i < kBucketCount; i++) {
-    std::unique_lock<std::mutex> mlock(*mutexes_[i]);
-    while (!sized_pool_[i].empty()) {
-      FreeFnImpl(sized_pool_[i].front());
-      sized_pool_[i].pop();
+  // larger blocks are freed first, they are less likely to be reused.
+  while (stats_.cached_bytes > max_cached_bytes) {
+    WHOLEMEMORY_CHECK(!free_blocks_.empty());
+    // size classes are never empty, so the last one of each stream is its largest.
+    auto largest_stream = free_blocks_.begin();
+    for (auto it = free_blocks_.begin(); it != free_blocks_.end(); ++it) {
+      if (it->second.rbegin()->first > largest_stream->second.rbegin()->first) {
+        largest_stream = it;
+      }
     }
+    auto largest_blocks = std::prev(largest_stream->second.end());
+    size_t largest_size = largest_blocks->first;
+    FreeFnImpl(largest_blocks->second.back());
+    PopFreeBlockLocked(largest_stream, largest_blocks);
+    stats_.cached_bytes -= largest_size;
+    record_memory_free(usage_category_, largest_size);
   }
 }
-class DeviceChunkedMemoryPool : public ChunkedMemoryPool {
+
+void CachingMemoryPool::Trim(size_t max_cached_bytes)
+{
+  std::unique_lock<std::mutex> mlock(mu_);
+  TrimLocked(max_cached_bytes);
+}
+
+temp_memory_stats_t CachingMemoryPool::GetStats()
+{
+  std::unique_lock<std::mutex> mlock(mu_);
+  return stats_;
+}
+
+void CachingMemoryPool::ResetPeakStats()
+{
+  std::unique_lock<std::mutex> mlock(mu_);
+  stats_.peak_allocated_bytes = stats_.allocated_bytes;
+  stats_.peak_reserved_bytes  = stats_.allocated_bytes + stats_.cached_bytes;
+}
+
+class DeviceCachingMemoryPool : public CachingMemoryPool {
  public:
-  explicit DeviceChunkedMemoryPool(int device_id);
-  ~DeviceChunkedMemoryPool();
+  explicit DeviceCachingMemoryPool(int device_id)
+    : CachingMemoryPool(true, WHOLEMEMORY_MA_DEVICE), device_id_(device_id)
+  {
+  }
+
+ protected:
   void* MallocFnImpl(size_t size) override;
   void FreeFnImpl(void* ptr) override;
 
- protected:
   int device_id_ = -1;
 };
-DeviceChunkedMemoryPool::DeviceChunkedMemoryPool(int device_id) : device_id_(device_id) {}
-DeviceChunkedMemoryPool::~DeviceChunkedMemoryPool() {}
-void* DeviceChunkedMemoryPool::MallocFnImpl(size_t size)
+void* DeviceCachingMemoryPool::MallocFnImpl(size_t size)
 {
   int old_dev;
   void* ptr;
@@ -194,7 +313,7 @@ void* DeviceChunkedMemoryPool::MallocFnImpl(size_t size)
   WM_CUDA_CHECK(cudaSetDevice(old_dev));
   return ptr;
 }
-void DeviceChunkedMemoryPool::FreeFnImpl(void* ptr)
+void DeviceCachingMemoryPool::FreeFnImpl(void* ptr)
 {
   int old_dev;
   WM_CUDA_CHECK(cudaGetDevice(&old_dev));
@@ -203,100 +322,104 @@ void DeviceChunkedMemoryPool::FreeFnImpl(void* ptr)
   WM_CUDA_CHECK(cudaSetDevice(old_dev));
 }
 
-class PinnedChunkedMemoryPool : public ChunkedMemoryPool {
+class PinnedCachingMemoryPool : public CachingMemoryPool {
  public:
-  PinnedChunkedMemoryPool()  = default;
-  ~PinnedChunkedMemoryPool() = default;
+  PinnedCachingMemoryPool() : CachingMemoryPool(true, WHOLEMEMORY_MA_PINNED) {}
+
+ protected:
   void* MallocFnImpl(size_t size) override;
   void FreeFnImpl(void* ptr) override;
 };
-void* PinnedChunkedMemoryPool::MallocFnImpl(size_t size)
+void* PinnedCachingMemoryPool::MallocFnImpl(size_t size)
 {
   void* ptr;
   WM_CUDA_CHECK(cudaMallocHost(&ptr, size));
   return ptr;
 }
-void PinnedChunkedMemoryPool::FreeFnImpl(void* ptr) { WM_CUDA_CHECK(cudaFreeHost(ptr)); }
+void PinnedCachingMemoryPool::FreeFnImpl(void* ptr) { WM_CUDA_CHECK(cudaFreeHost(ptr)); }
 
-class HostChunkedMemoryPool : public ChunkedMemoryPool {
+class HostCachingMemoryPool : public CachingMemoryPool {
  public:
-  HostChunkedMemoryPool()  = default;
-  ~HostChunkedMemoryPool() = default;
+  HostCachingMemoryPool() : CachingMemoryPool(false, WHOLEMEMORY_MA_HOST) {}
+
+ protected:
   void* MallocFnImpl(size_t size) override;
   void FreeFnImpl(void* ptr) override;
 };
-void* HostChunkedMemoryPool::MallocFnImpl(size_t size) { return malloc(size); }
-void HostChunkedMemoryPool::FreeFnImpl(void* ptr) { free(ptr); }
+void* HostCachingMemoryPool::MallocFnImpl(size_t size) { return malloc(size); }
+void HostCachingMemoryPool::FreeFnImpl(void* ptr) { free(ptr); }
+
 class CachedAllocator {
  public:
-  void* MallocHost(size_t size);
-  void* MallocDevice(size_t size);
-  void* MallocPinned(size_t size);
-  void FreeHost(void* ptr, size_t size);
-  void FreeDevice(void* ptr, size_t size);
-  void FreePinned(void* ptr, size_t size);
-  void DropCaches();
+  void* Malloc(size_t size, wholememory_memory_allocation_type_t type, int dev_id);
+  void Free(void* ptr, wholememory_memory_allocation_type_t type, int dev_id);
+  void Trim(size_t max_cached_bytes);
+  temp_memory_stats_t GetStats(wholememory_memory_allocation_type_t type, int dev_id);
+  void ResetPeakStats();
   static CachedAllocator* GetInst();
 
  private:
   CachedAllocator()
   {
-    device_chunked_mem_pools_.resize(kMaxSupportedDeviceCount);
+    device_caching_mem_pools_.resize(kMaxSupportedDeviceCount);
     for (int i = 0; i < kMaxSupportedDeviceCount; i++) {
-      device_chunked_mem_pools_[i] = std::make_unique<DeviceChunkedMemoryPool>(i);
+      device_caching_mem_pools_[i] = std::make_unique<DeviceCachingMemoryPool>(i);
     }
-    pinned_chunked_mem_pool_ = std::make_unique<PinnedChunkedMemoryPool>();
-    host_chunked_mem_pool_   = std::make_unique<HostChunkedMemoryPool>();
+    pinned_caching_mem_pool_ = std::make_unique<PinnedCachingMemoryPool>();
+    host_caching_mem_pool_   = std::make_unique<HostCachingMemoryPool>();
   }
   ~CachedAllocator() {}
   CachedAllocator(const CachedAllocator& ca)                  = delete;
   const CachedAllocator& operator=(const CachedAllocator& ca) = delete;
 
+  CachingMemoryPool* GetPool(wholememory_memory_allocation_type_t type, int dev_id);
+
   static CachedAllocator ca_inst_;
-  std::vector<std::unique_ptr<DeviceChunkedMemoryPool>> device_chunked_mem_pools_;
-  std::unique_ptr<PinnedChunkedMemoryPool> pinned_chunked_mem_pool_;
-  std::unique_ptr<HostChunkedMemoryPool> host_chunked_mem_pool_;
+  std::vector<std::unique_ptr<DeviceCachingMemoryPool>> device_caching_mem_pools_;
+  std::unique_ptr<PinnedCachingMemoryPool> pinned_caching_mem_pool_;
+  std::unique_ptr<HostCachingMemoryPool> host_caching_mem_pool_;
   static constexpr int kMaxSupportedDeviceCount = 16;
 };
 
 CachedAllocator CachedAllocator::ca_inst_;
 CachedAllocator* CachedAllocator::GetInst() { return &ca_inst_; }
 
-void* CachedAllocator::MallocHost(size_t size)
-{
-  return host_chunked_mem_pool_->CachedMalloc(size);
-}
-void CachedAllocator::FreeHost(void* ptr, size_t size)
+CachingMemoryPool* CachedAllocator::GetPool(wholememory_memory_allocation_type_t type, int dev_id)
 {
-  host_chunked_mem_pool_->CachedFree(ptr, size);
+  if (type == WHOLEMEMORY_MA_HOST) return host_caching_mem_pool_.get();
+  if (type == WHOLEMEMORY_MA_PINNED) return pinned_caching_mem_pool_.get();
+  WHOLEMEMORY_CHECK(type == WHOLEMEMORY_MA_DEVICE);
+  WHOLEMEMORY_CHECK(dev_id >= 0 && dev_id < kMaxSupportedDeviceCount);
+  return device_caching_mem_pools_[dev_id].get();
 }
-void* CachedAllocator::MallocDevice(size_t size)
+void* CachedAllocator::Malloc(size_t size, wholememory_memory_allocation_type_t type, int dev_id)
 {
-  int dev_id;
-  WM_CUDA_CHECK(cudaGetDevice(&dev_id));
-  return device_chunked_mem_pools_[dev_id]->CachedMalloc(size);
+  return GetPool(type, dev_id)->CachedMalloc(size);
 }
-void CachedAllocator::FreeDevice(void* ptr, size_t size)
+void CachedAllocator::Free(void* ptr, wholememory_memory_allocation_type_t type, int dev_id)
 {
-  int dev_id;
-  WM_CUDA_CHECK(cudaGetDevice(&dev_id));
-  device_chunked_mem_pools_[dev_id]->CachedFree(ptr, size);
+  GetPool(type, dev_id)->CachedFree(ptr);
 }
-void* CachedAllocator::MallocPinned(size_t size)
+void CachedAllocator::Trim(size_t max_cached_bytes)
 {
-  return pinned_chunked_mem_pool_->CachedMalloc(size);
+  for (int i = 0; i < kMaxSupportedDeviceCount; i++) {
+    device_caching_mem_pools_[i]->Trim(max_cached_bytes);
+  }
+  pinned_caching_mem_pool_->Trim(max_cached_bytes);
+  host_caching_mem_pool_->Trim(max_cached_bytes);
 }
-void CachedAllocator::FreePinned(void* ptr, size_t size)
+temp_memory_stats_t CachedAllocator::GetStats(wholememory_memory_allocation_type_t type,
+                                              int dev_id)
 {
-  pinned_chunked_mem_pool_->CachedFree(ptr, size);
+  return GetPool(type, dev_id)->GetStats();
 }
-void CachedAllocator::DropCaches()
+void CachedAllocator::ResetPeakStats()
 {
   for (int i = 0; i < kMaxSupportedDeviceCount; i++) {
-    device_chunked_mem_pools_[i]->EmptyCache();
+    device_caching_mem_pools_[i]->ResetPeakStats();
   }
-  pinned_chunked_mem_pool_->EmptyCache();
-  host_chunked_mem_pool_->EmptyCache();
+  pinned_caching_mem_pool_->ResetPeakStats();
+  host_caching_mem_pool_->ResetPeakStats();
 }
 
 void* cached_malloc_func(wholememory_tensor_description_t* tensor_description,
@@ -307,27 +430,27 @@ void* cached_malloc_func(wholememory_tensor_description_t* tensor_description,
   auto* default_memory_context = static_cast<default_memory_context_t*>(memory_context);
   void* ptr                    = nullptr;
   CachedAllocator* cached_inst = CachedAllocator::GetInst();
-  int devid;
-  WM_CUDA_CHECK(cudaGetDevice((&devid)));
+  int devid                    = -1;
   try {
-    if (memory_allocation_type == WHOLEMEMORY_MA_HOST) {
-      ptr = cached_inst->MallocHost(wholememory_get_memory_size_from_tensor(tensor_description));
-      if (ptr == nullptr) { WHOLEMEMORY_FAIL_NOTHROW("cached malloc host returned nullptr.\n"); }
-    } else if (memory_allocation_type == WHOLEMEMORY_MA_PINNED) {
-      ptr = cached_inst->MallocPinned(wholememory_get_memory_size_from_tensor(tensor_description));
-      if (ptr == nullptr) { WHOLEMEMORY_FAIL_NOTHROW("cached malloc pinned returned nullptr.\n"); }
-    } else if (memory_allocation_type == WHOLEMEMORY_MA_DEVICE) {
-      ptr = cached_inst->MallocDevice(wholememory_get_memory_size_from_tensor(tensor_description));
-      if (ptr == nullptr) { WHOLEMEMORY_FAIL_NOTHROW("cached malloc device returned nullptr.\n"); }
-    } else {
+    if (memory_allocation_type != WHOLEMEMORY_MA_HOST &&
+        memory_allocation_type != WHOLEMEMORY_MA_PINNED &&
+        memory_allocation_type != WHOLEMEMORY_MA_DEVICE) {
       WHOLEMEMORY_FAIL_NOTHROW("memory_allocation_type incorrect.\n");
     }
+    // host memory needs no CUDA device.
+    if (memory_allocation_type == WHOLEMEMORY_MA_DEVICE) { WM_CUDA_CHECK(cudaGetDevice(&devid)); }
+    ptr = cached_inst->Malloc(
+      wholememory_get_memory_size_from_tensor(tensor_description), memory_allocation_type, devid);
+    if (ptr == nullptr) { WHOLEMEMORY_FAIL_NOTHROW("cached malloc returned nullptr.\n"); }
   } catch (wholememory::cuda_error& wce) {
     WHOLEMEMORY_FAIL_NOTHROW("cudaMalloc failed, %s.\n", wce.what());
+  } catch (wholememory::logic_error& wle) {
+    WHOLEMEMORY_FAIL_NOTHROW("cached malloc failed, %s.\n", wle.what());
   }
   default_memory_context->desc            = *tensor_description;
   default_memory_context->ptr             = ptr;
   default_memory_context->allocation_type = memory_allocation_type;
+  default_memory_context->device_id       = devid;
   return ptr;
 }
 
@@ -336,21 +459,17 @@ void cached_free_func(void* memory_context, void* /*global_context*/)
   CachedAllocator* cached_inst = CachedAllocator::GetInst();
   auto* default_memory_context = static_cast<default_memory_context_t*>(memory_context);
   auto memory_allocation_type  = default_memory_context->allocation_type;
-  if (memory_allocation_type == WHOLEMEMORY_MA_HOST) {
-    cached_inst->FreeHost(default_memory_context->ptr,
-                          wholememory_get_memory_size_from_tensor(&default_memory_context->desc));
-  } else if (memory_allocation_type == WHOLEMEMORY_MA_PINNED) {
-    cached_inst->FreePinned(default_memory_context->ptr,
-                            wholememory_get_memory_size_from_tensor(&default_memory_context->desc));
-  } else if (memory_allocation_type == WHOLEMEMORY_MA_DEVICE) {
-    cached_inst->FreeDevice(default_memory_context->ptr,
-                            wholememory_get_memory_size_from_tensor(&default_memory_context->desc));
-  } else {
+  if (memory_allocation_type != WHOLEMEMORY_MA_HOST &&
+      memory_allocation_type != WHOLEMEMORY_MA_PINNED &&
+      memory_allocation_type != WHOLEMEMORY_MA_DEVICE) {
     WHOLEMEMORY_FAIL_NOTHROW("memory_allocation_type incorrect.\n");
   }
+  cached_inst->Free(
+    default_memory_context->ptr, memory_allocation_type, default_memory_context->device_id);
   wholememory_initialize_tensor_desc(&default_memory_context->desc);
   default_memory_context->ptr             = nullptr;
   default_memory_context->allocation_type = WHOLEMEMORY_MA_NONE;
+  default_memory_context->device_id       = -1;
 }
 
 static wholememory_env_func_t cached_env_func = {
@@ -370,7 +489,40 @@ static wholememory_env_func_t cached_env_func = {
 
 wholememory_env_func_t* get_cached_env_func() { return &cached_env_func; }
 
-void drop_cached_env_func_cache() { CachedAllocator::GetInst()->DropCaches(); }
+// temporary memory is released when op returns, so it is always allocated from caching pools.
+static wholememory_env_func_t default_env_func = {
+  .temporary_fns =
+    {
+      .create_memory_context_fn  = default_create_memory_context_func,
+      .destroy_memory_context_fn = default_destroy_memory_context_func,
+      .malloc_fn                 = cached_malloc_func,
+      .free_fn                   = cached_free_func,
+      .global_context            = nullptr,
+    },
+  .output_fns = {
+    .malloc_fn      = default_malloc_func,
+    .free_fn        = default_free_func,
+    .global_context = nullptr,
+  }};
+
+wholememory_env_func_t* get_default_env_func() { return &default_env_func; }
+
+void drop_cached_env_func_cache() { CachedAllocator::GetInst()->Trim(0); }
+
+void trim_cached_env_func_cache(size_t max_cached_bytes)
+{
+  CachedAllocator::GetInst()->Trim(max_cached_bytes);
+}
+
+temp_memory_stats_t get_cached_env_func_stats(
+  wholememory_memory_allocation_type_t memory_allocation_type)
+{
+  int devid = -1;
+  if (memory_allocation_type == WHOLEMEMORY_MA_DEVICE) { WM_CUDA_CHECK(cudaGetDevice(&devid)); }
+  return CachedAllocator::GetInst()->GetStats(memory_allocation_type, devid);
+}
+
+void reset_cached_env_func_peak_stats() { CachedAllocator::GetInst()->ResetPeakStats(); }
 
 }  // namespace wholememory
 
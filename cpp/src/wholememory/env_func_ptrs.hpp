@@ -17,18 +17,35 @@
 
 #include <wholememory/env_func_ptrs.h>
 
+#include <cstdint>
+
 namespace wholememory {
 
 struct default_memory_context_t {
   wholememory_tensor_description_t desc;
   wholememory_memory_allocation_type_t allocation_type;
   void* ptr;
+  // device of WHOLEMEMORY_MA_DEVICE memory allocated by cached allocator.
+  int device_id;
+};
+
+/**
+ * @brief : Statistics of one caching pool of cached allocator, sizes are in bytes and rounded up
+ * to size classes.
+ */
+struct temp_memory_stats_t {
+  size_t allocated_bytes      = 0; /* size of blocks in use */
+  size_t cached_bytes         = 0; /* size of freed blocks kept for reuse */
+  size_t peak_allocated_bytes = 0; /* high-water mark of allocated_bytes */
+  size_t peak_reserved_bytes  = 0; /* high-water mark of allocated_bytes + cached_bytes */
+  int64_t malloc_count        = 0; /* number of allocations */
+  int64_t cache_hit_count     = 0; /* number of allocations served by cached blocks */
 };
 
 /**
  * @brief : Default environment functions for memory allocation.
- * Will use cudaMalloc/cudaFree, cudaMallocHost/cudaFreeHost, malloc/free.
- * Useful for function tests, NOT designed for performance tests.
+ * Temporary memory is allocated by cached allocator, see get_cached_env_func.
+ * Output memory will use cudaMalloc/cudaFree, cudaMallocHost/cudaFreeHost, malloc/free.
  *
  * @return : pointers to the functions of current CUDA device
  */
@@ -37,17 +54,62 @@ wholememory_env_func_t* get_default_env_func();
 /**
  * @brief : Environment functions for memory allocation with caches.
  * Will cache allocated memory blocks, and reuse if possible.
- * Minimal block size is 256 bytes, block with size < 1G bytes is aligned to power of 2,
- * block with size >= 1G bytes is aligned to 1G bytes.
- * Useful for performance tests. Need warm up to fill caches.
+ * Minimal block size is 256 bytes, larger blocks are rounded up to 4 size classes per power of 2.
+ * Device and pinned blocks are only reused on the CUDA stream set by temp_memory_stream_guard when
+ * they were allocated, so they can only be allocated in scope of a guard. Host blocks are reused by
+ * any thread.
+ * If allocation fails, all cached blocks are freed and allocation is retried.
  *
  * @return : pointers to the functions of current CUDA device
  */
 wholememory_env_func_t* get_cached_env_func();
 
 /**
- * @brief : drop all caches of inside cached allocator of current CUDA device
+ * @brief : drop all caches of inside cached allocator of all CUDA devices
  */
 void drop_cached_env_func_cache();
 
+/**
+ * @brief : free cached blocks of cached allocator, larger blocks first, until cached size of each
+ * caching pool is not larger than max_cached_bytes.
+ * @param max_cached_bytes : cached bytes to keep in each caching pool
+ */
+void trim_cached_env_func_cache(size_t max_cached_bytes);
+
+/**
+ * @brief : get statistics of caching pool of cached allocator
+ * @param memory_allocation_type : memory type of caching pool, device pool is of current device
+ * @return : statistics of the caching pool
+ */
+temp_memory_stats_t get_cached_env_func_stats(
+  wholememory_memory_allocation_type_t memory_allocation_type);
+
+/**
+ * @brief : reset peak statistics of all caching pools to current values
+ */
+void reset_cached_env_func_peak_stats();
+
+/**
+ * @brief : Set CUDA stream of temporary memory allocated by current thread in the scope of guard.
+ * Ops set it to the stream they run on, so cached blocks are not reused across streams. Device and
+ * pinned memory of cached allocator fails to allocate if no guard is active.
+ */
+class temp_memory_stream_guard {
+ public:
+  explicit temp_memory_stream_guard(cudaStream_t stream);
+  ~temp_memory_stream_guard();
+  temp_memory_stream_guard(const temp_memory_stream_guard&)            = delete;
+  temp_memory_stream_guard& operator=(const temp_memory_stream_guard&) = delete;
+
+ private:
+  cudaStream_t old_stream_;
+  bool old_stream_set_;
+};
+
+/**
+ * @brief : get CUDA stream of temporary memory set by temp_memory_stream_guard of current thread
+ * @return : the stream, nullptr if not set
+ */
+cudaStream_t get_temp_memory_stream();
+
 }  // namespace wholememory
@@ -15,15 +15,32 @@
  */
 #include "file_io.h"
 
+#include <fcntl.h>
+#include <strings.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "communicator.hpp"
+#include "cuda_macros.hpp"
 #include "error.hpp"
+#include "integer_utils.hpp"
 #include "logger.hpp"
+#include "memory_handle.hpp"
+#include "parallel_utils.hpp"
 
 namespace wholememory {
 
@@ -62,18 +79,718 @@ static size_t get_handle_partial_size(size_t handle_size,
   return partial_size;
 }
 
+static size_t get_file_io_buffer_entry_count(size_t entry_size)
+{
+  constexpr size_t kSuggestedBufferSize = 16 * 1024 * 1024;
+  if (kSuggestedBufferSize < entry_size) return 1;
+  return kSuggestedBufferSize / entry_size;
+}
+
+/**
+ * Number of threads used to read input files, configured by WHOLEMEMORY_LOAD_THREAD_COUNT.
+ * Values not greater than 1 keep the single threaded fread loader.
+ */
+static int get_load_thread_count()
+{
+  const char* thread_count_str = std::getenv("WHOLEMEMORY_LOAD_THREAD_COUNT");
+  if (thread_count_str == nullptr || strcmp(thread_count_str, "") == 0) return 1;
+  int thread_count = atoi(thread_count_str);
+  if (thread_count < 1) {
+    WHOLEMEMORY_WARN("WHOLEMEMORY_LOAD_THREAD_COUNT=%s is invalid, using 1.", thread_count_str);
+    return 1;
+  }
+  return std::min(thread_count, std::max(GetProcessorCount(), 1));
+}
+
+/**
+ * A contiguous range of entries in one input file that belongs to current rank.
+ */
+struct file_read_segment {
+  int file_id;
+  size_t file_offset;
+  size_t entry_count;
+  char* local_write_ptr;
+};
+
+static void copy_entries_to_local(char* local_write_ptr,
+                                  const char* buffer,
+                                  size_t entry_count,
+                                  size_t memory_entry_stride,
+                                  size_t entry_size,
+                                  cudaStream_t stream)
+{
+  if (entry_size != memory_entry_stride) {
+    WM_CUDA_CHECK(cudaMemcpy2DAsync(local_write_ptr,
+                                    memory_entry_stride,
+                                    buffer,
+                                    entry_size,
+                                    entry_size,
+                                    entry_count,
+                                    cudaMemcpyDefault,
+                                    stream));
+  } else {
+    WM_CUDA_CHECK(cudaMemcpyAsync(
+      local_write_ptr, buffer, entry_count * entry_size, cudaMemcpyDefault, stream));
+  }
+}
+
+struct host_half {
+  uint16_t bits;
+};
+
+struct host_bf16 {
+  uint16_t bits;
+};
+
+static inline uint32_t float_as_bits(float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static inline float bits_as_float(uint32_t bits)
+{
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// float to IEEE half with round to nearest even, NaN is kept as quiet NaN.
+static inline host_half float_to_half(float value)
+{
+  constexpr uint32_t kF32Infinity  = 255U << 23;
+  constexpr uint32_t kF16Max       = (127U + 16U) << 23;
+  constexpr uint32_t kDenormMagic  = ((127U - 15U) + (23U - 10U) + 1U) << 23;
+  constexpr uint32_t kMinNormalExp = 113U << 23;
+  uint32_t bits                    = float_as_bits(value);
+  uint32_t const sign              = bits & 0x80000000U;
+  uint16_t result                  = 0;
+  bits ^= sign;
+  if (bits >= kF16Max) {
+    result = bits > kF32Infinity ? 0x7E00 : 0x7C00;
+  } else if (bits < kMinNormalExp) {
+    // subnormal half, let float addition do the rounding.
+    result = float_as_bits(bits_as_float(bits) + bits_as_float(kDenormMagic)) - kDenormMagic;
+  } else {
+    uint32_t const mantissa_odd = (bits >> 13) & 1U;
+    bits += ((15U - 127U) << 23) + 0xFFFU + mantissa_odd;
+    result = bits >> 13;
+  }
+  return host_half{static_cast<uint16_t>(result | (sign >> 16))};
+}
+
+static inline float half_to_float(host_half value)
+{
+  constexpr uint32_t kShiftedExp = 0x7C00U << 13;
+  uint32_t bits                  = (value.bits & 0x7FFFU) << 13;
+  uint32_t const exp             = bits & kShiftedExp;
+  bits += (127U - 15U) << 23;
+  if (exp == kShiftedExp) {
+    bits += (128U - 16U) << 23;
+  } else if (exp == 0) {
+    bits += 1U << 23;
+    bits = float_as_bits(bits_as_float(bits) - bits_as_float(113U << 23));
+  }
+  return bits_as_float(bits | (static_cast<uint32_t>(value.bits & 0x8000U) << 16));
+}
+
+// float to bfloat16 with round to nearest even, NaN is kept as quiet NaN.
+static inline host_bf16 float_to_bf16(float value)
+{
+  uint32_t const bits = float_as_bits(value);
+  if ((bits & 0x7FFFFFFFU) > 0x7F800000U) {
+    return host_bf16{static_cast<uint16_t>((bits >> 16) | 0x40U)};
+  }
+  return host_bf16{static_cast<uint16_t>((bits + 0x7FFFU + ((bits >> 16) & 1U)) >> 16)};
+}
+
+static inline float bf16_to_float(host_bf16 value)
+{
+  return bits_as_float(static_cast<uint32_t>(value.bits) << 16);
+}
+
+template <typename T>
+static inline float to_float_value(T value)
+{
+  if constexpr (std::is_same_v<T, host_half>) {
+    return half_to_float(value);
+  } else if constexpr (std::is_same_v<T, host_bf16>) {
+    return bf16_to_float(value);
+  } else {
+    return static_cast<float>(value);
+  }
+}
+
+template <typename DstT, typename SrcT>
+static inline DstT convert_value(SrcT value)
+{
+  if constexpr (std::is_same_v<DstT, host_half>) {
+    return float_to_half(to_float_value(value));
+  } else if constexpr (std::is_same_v<DstT, host_bf16>) {
+    return float_to_bf16(to_float_value(value));
+  } else if constexpr (std::is_same_v<SrcT, host_half> || std::is_same_v<SrcT, host_bf16>) {
+    return static_cast<DstT>(to_float_value(value));
+  } else {
+    return static_cast<DstT>(value);
+  }
+}
+
+template <typename Fn>
+static void dispatch_host_dtype(wholememory_dtype_t dtype, Fn&& fn)
+{
+  switch (dtype) {
+    case WHOLEMEMORY_DT_FLOAT: fn(float{}); break;
+    case WHOLEMEMORY_DT_HALF: fn(host_half{}); break;
+    case WHOLEMEMORY_DT_DOUBLE: fn(double{}); break;
+    case WHOLEMEMORY_DT_BF16: fn(host_bf16{}); break;
+    case WHOLEMEMORY_DT_INT: fn(int32_t{}); break;
+    case WHOLEMEMORY_DT_INT64: fn(int64_t{}); break;
+    case WHOLEMEMORY_DT_INT16: fn(int16_t{}); break;
+    case WHOLEMEMORY_DT_INT8: fn(int8_t{}); break;
+    default: WHOLEMEMORY_FAIL("dtype %d not supported for conversion.", static_cast<int>(dtype));
+  }
+}
+
+static size_t get_memory_write_size(size_t entry_size, const file_entry_conversion* conversion)
+{
+  if (conversion == nullptr) return entry_size;
+  return conversion->column_count * wholememory_dtype_get_element_size(conversion->memory_dtype);
+}
+
+/**
+ * Convert entries read from file into dense entries of memory_dtype, each output entry has
+ * column_count elements. Loops are over plain arrays so the compiler can vectorize them.
+ */
+static void convert_file_entries(char* output,
+                                 const char* input,
+                                 size_t entry_count,
+                                 size_t entry_size,
+                                 const file_entry_conversion& conversion)
+{
+  dispatch_host_dtype(conversion.file_dtype, [&](auto src_tag) {
+    using SrcT = decltype(src_tag);
+    dispatch_host_dtype(conversion.memory_dtype, [&](auto dst_tag) {
+      using DstT       = decltype(dst_tag);
+      auto* output_ptr = reinterpret_cast<DstT*>(output);
+      for (size_t i = 0; i < entry_count; i++) {
+        auto* input_ptr =
+          reinterpret_cast<const SrcT*>(input + i * entry_size) + conversion.column_start;
+        for (size_t j = 0; j < conversion.column_count; j++) {
+          output_ptr[j] = convert_value<DstT>(input_ptr[j]);
+        }
+        output_ptr += conversion.column_count;
+      }
+    });
+  });
+}
+
+static void read_file_segments_single_thread(const std::vector<file_read_segment>& read_segments,
+                                             size_t memory_entry_stride,
+                                             size_t entry_size,
+                                             const char** file_names,
+                                             const std::vector<size_t>& file_sizes,
+                                             int wm_rank,
+                                             const file_entry_conversion* conversion)
+{
+  size_t buffer_entry_count      = get_file_io_buffer_entry_count(entry_size);
+  size_t const memory_write_size = get_memory_write_size(entry_size, conversion);
+  std::vector<char> file_read_buffer(buffer_entry_count * entry_size);
+  std::vector<char> converted_buffer(conversion != nullptr ? buffer_entry_count * memory_write_size
+                                                           : 0);
+  for (auto& segment : read_segments) {
+    const char* file_name = file_names[segment.file_id];
+    FILE* fp              = fopen(file_name, "rb");
+    if (fp == nullptr) { WHOLEMEMORY_FAIL("Open file %s for read failed.", file_name); }
+    if (segment.file_offset != 0 && fseeko(fp, segment.file_offset, SEEK_SET) != 0) {
+      WHOLEMEMORY_ERROR("File %s seek to %ld failed.", file_name, segment.file_offset);
+    }
+    char* local_write_ptr   = segment.local_write_ptr;
+    size_t left_entry_count = segment.entry_count;
+    while (left_entry_count > 0) {
+      size_t read_entry_count = std::min(left_entry_count, buffer_entry_count);
+
+      size_t ret = fread(file_read_buffer.data(), entry_size, read_entry_count, fp);
+      if (ret != read_entry_count) {
+        WHOLEMEMORY_ERROR(
+          "File %s line %d: reading from file %s, read_entry_count=%ld, entry_size=%ld, "
+          "returned %ld, error=%s\n",
+          __FILE__,
+          __LINE__,
+          file_name,
+          read_entry_count,
+          entry_size,
+          ret,
+          strerror(errno));
+      }
+
+      const char* copy_buffer = file_read_buffer.data();
+      if (conversion != nullptr) {
+        convert_file_entries(converted_buffer.data(),
+                             file_read_buffer.data(),
+                             read_entry_count,
+                             entry_size,
+                             *conversion);
+        copy_buffer = converted_buffer.data();
+      }
+      copy_entries_to_local(local_write_ptr,
+                            copy_buffer,
+                            read_entry_count,
+                            memory_entry_stride,
+                            memory_write_size,
+                            0);
+      WM_CUDA_CHECK(cudaStreamSynchronize(0));
+      local_write_ptr += read_entry_count * memory_entry_stride;
+
+      left_entry_count -= read_entry_count;
+    }
+    fclose(fp);
+    WHOLEMEMORY_INFO(
+      "Rank=%d done Reading %ld bytes from file %s size=%ld, starting from offset=%ld.",
+      wm_rank,
+      segment.entry_count * entry_size,
+      file_name,
+      file_sizes[segment.file_id],
+      segment.file_offset);
+  }
+}
+
+static void file_transfer_fully(
+  bool is_write, int fd, char* buffer, size_t size, size_t offset, const char* file_name)
+{
+  size_t done_size = 0;
+  while (done_size < size) {
+    ssize_t ret = is_write ? pwrite(fd, buffer + done_size, size - done_size, offset + done_size)
+                           : pread(fd, buffer + done_size, size - done_size, offset + done_size);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) {
+      WHOLEMEMORY_FAIL("%s file %s at offset=%ld, size=%ld returned %ld, error=%s",
+                       is_write ? "pwrite" : "pread",
+                       file_name,
+                       offset + done_size,
+                       size - done_size,
+                       ret,
+                       ret < 0 ? strerror(errno) : "unexpected end of file");
+    }
+    done_size += ret;
+  }
+}
+
+static void pread_fully(int fd, char* buffer, size_t size, size_t offset, const char* file_name)
+{
+  file_transfer_fully(false, fd, buffer, size, offset, file_name);
+}
+
+static constexpr size_t kDirectIOAlignment = 4096;
+
+/**
+ * Whether to use O_DIRECT for host memory read and write, configured by WHOLEMEMORY_USE_DIRECT_IO.
+ */
+static bool get_use_direct_io()
+{
+  const char* use_direct_io_str = std::getenv("WHOLEMEMORY_USE_DIRECT_IO");
+  if (use_direct_io_str == nullptr) return false;
+  return strcmp(use_direct_io_str, "1") == 0 || strcasecmp(use_direct_io_str, "true") == 0 ||
+         strcasecmp(use_direct_io_str, "on") == 0;
+}
+
+/**
+ * Open file_name with O_DIRECT, return -1 if file system doesn't support it.
+ */
+static int open_direct_io_file(const char* file_name, int flags)
+{
+  int fd = open(file_name, flags | O_DIRECT);
+  if (fd < 0) {
+    WHOLEMEMORY_WARN(
+      "Open file %s with O_DIRECT failed, error=%s, fall back to buffered I/O.",
+      file_name,
+      strerror(errno));
+  }
+  return fd;
+}
+
+/**
+ * Transfer through direct_fd. If O_DIRECT is rejected with EINVAL, e.g. the file system needs
+ * larger alignment than kDirectIOAlignment, the rest is transferred through buffered fd.
+ */
+static void direct_transfer_fully(bool is_write,
+                                  int fd,
+                                  int direct_fd,
+                                  char* buffer,
+                                  size_t size,
+                                  size_t offset,
+                                  const char* file_name)
+{
+  static std::atomic<bool> fallback_warned(false);
+  size_t done_size = 0;
+  while (done_size < size) {
+    ssize_t ret =
+      is_write ? pwrite(direct_fd, buffer + done_size, size - done_size, offset + done_size)
+               : pread(direct_fd, buffer + done_size, size - done_size, offset + done_size);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0 && errno == EINVAL) {
+      if (!fallback_warned.exchange(true)) {
+        WHOLEMEMORY_WARN("%s file %s with O_DIRECT at offset=%ld failed, error=%s, fall back to "
+                         "buffered I/O.",
+                         is_write ? "pwrite" : "pread",
+                         file_name,
+                         offset + done_size,
+                         strerror(errno));
+      }
+      file_transfer_fully(
+        is_write, fd, buffer + done_size, size - done_size, offset + done_size, file_name);
+      return;
+    }
+    if (ret <= 0) {
+      WHOLEMEMORY_FAIL("%s file %s at offset=%ld, size=%ld returned %ld, error=%s",
+                       is_write ? "pwrite" : "pread",
+                       file_name,
+                       offset + done_size,
+                       size - done_size,
+                       ret,
+                       ret < 0 ? strerror(errno) : "unexpected end of file");
+    }
+    done_size += ret;
+  }
+}
+
+/**
+ * Transfer between memory and file without bounce buffer.
+ * If direct_fd is valid and memory address and file offset have same alignment, the aligned middle
+ * part goes through direct_fd, the unaligned head and tail go through buffered fd.
+ */
+static void file_transfer_maybe_direct(bool is_write,
+                                       int fd,
+                                       int direct_fd,
+                                       char* ptr,
+                                       size_t size,
+                                       size_t offset,
+                                       const char* file_name)
+{
+  if (direct_fd < 0 || (reinterpret_cast<uintptr_t>(ptr) - offset) % kDirectIOAlignment != 0) {
+    file_transfer_fully(is_write, fd, ptr, size, offset, file_name);
+    return;
+  }
+  size_t head_size    = std::min(round_up_unsafe(offset, kDirectIOAlignment) - offset, size);
+  size_t aligned_size = (size - head_size) / kDirectIOAlignment * kDirectIOAlignment;
+  size_t tail_size    = size - head_size - aligned_size;
+  file_transfer_fully(is_write, fd, ptr, head_size, offset, file_name);
+  direct_transfer_fully(
+    is_write, fd, direct_fd, ptr + head_size, aligned_size, offset + head_size, file_name);
+  file_transfer_fully(is_write,
+                      fd,
+                      ptr + head_size + aligned_size,
+                      tail_size,
+                      offset + head_size + aligned_size,
+                      file_name);
+}
+
+/**
+ * Read segments directly to host memory, used when entry_size == memory_entry_stride so no
+ * strided copy is needed. Segments are split into blocks and read by thread_count threads.
+ */
+static void read_file_segments_to_host(const std::vector<file_read_segment>& read_segments,
+                                       size_t entry_size,
+                                       const char** file_names,
+                                       int thread_count,
+                                       bool use_direct_io)
+{
+  constexpr size_t kDirectReadBlockSize = 64 * 1024 * 1024;
+  std::vector<std::tuple<int, size_t, size_t, char*>> read_blocks;
+  for (auto& segment : read_segments) {
+    size_t segment_size = segment.entry_count * entry_size;
+    for (size_t start = 0; start < segment_size; start += kDirectReadBlockSize) {
+      read_blocks.emplace_back(segment.file_id,
+                               segment.file_offset + start,
+                               std::min(kDirectReadBlockSize, segment_size - start),
+                               segment.local_write_ptr + start);
+    }
+  }
+  if (read_blocks.empty()) return;
+
+  std::map<int, std::pair<int, int>> file_fds;
+  auto close_files = [&file_fds]() {
+    for (auto& id_fds : file_fds) {
+      close(id_fds.second.first);
+      if (id_fds.second.second >= 0) close(id_fds.second.second);
+    }
+  };
+  for (auto& segment : read_segments) {
+    const char* file_name = file_names[segment.file_id];
+    int fd                = open(file_name, O_RDONLY);
+    if (fd < 0) {
+      close_files();
+      WHOLEMEMORY_FAIL("Open file %s for read failed, error=%s", file_name, strerror(errno));
+    }
+    int direct_fd = use_direct_io ? open_direct_io_file(file_name, O_RDONLY) : -1;
+    file_fds[segment.file_id] = std::make_pair(fd, direct_fd);
+  }
+
+  thread_count = std::max(1, std::min<int>(thread_count, read_blocks.size()));
+  std::atomic<size_t> next_block(0);
+  std::mutex error_mu;
+  std::string error_msg;
+  MultiThreadRun(thread_count, [&](int, int) {
+    try {
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(error_mu);
+          if (!error_msg.empty()) break;
+        }
+        size_t block_idx = next_block.fetch_add(1);
+        if (block_idx >= read_blocks.size()) break;
+        int file_id;
+        size_t file_offset, block_size;
+        char* local_write_ptr;
+        std::tie(file_id, file_offset, block_size, local_write_ptr) = read_blocks[block_idx];
+        auto& fds = file_fds.at(file_id);
+        file_transfer_maybe_direct(false,
+                                   fds.first,
+                                   fds.second,
+                                   local_write_ptr,
+                                   block_size,
+                                   file_offset,
+                                   file_names[file_id]);
+      }
+    } catch (std::exception& e) {
+      std::unique_lock<std::mutex> lock(error_mu);
+      if (error_msg.empty()) error_msg = e.what();
+    }
+  });
+
+  close_files();
+  if (!error_msg.empty()) { WHOLEMEMORY_FAIL("Direct loading failed: %s", error_msg.c_str()); }
+}
+
+/**
+ * Split read segments into buffer sized blocks and read them with thread_count threads.
+ * Each thread owns two pinned buffers, so the pread of next block overlaps with the copy of
+ * current block to local memory.
+ */
+static void read_file_segments_multi_thread(const std::vector<file_read_segment>& read_segments,
+                                            size_t memory_entry_stride,
+                                            size_t entry_size,
+                                            const char** file_names,
+                                            int dev_id,
+                                            int thread_count,
+                                            const file_entry_conversion* conversion)
+{
+  size_t buffer_entry_count      = get_file_io_buffer_entry_count(entry_size);
+  size_t const memory_write_size = get_memory_write_size(entry_size, conversion);
+  std::vector<file_read_segment> read_blocks;
+  for (auto& segment : read_segments) {
+    for (size_t start = 0; start < segment.entry_count; start += buffer_entry_count) {
+      file_read_segment block;
+      block.file_id         = segment.file_id;
+      block.file_offset     = segment.file_offset + start * entry_size;
+      block.entry_count     = std::min(buffer_entry_count, segment.entry_count - start);
+      block.local_write_ptr = segment.local_write_ptr + start * memory_entry_stride;
+      read_blocks.push_back(block);
+    }
+  }
+  if (read_blocks.empty()) return;
+
+  std::map<int, int> file_fds;
+  for (auto& segment : read_segments) {
+    int fd = open(file_names[segment.file_id], O_RDONLY);
+    if (fd < 0) {
+      for (auto& id_fd : file_fds) {
+        close(id_fd.second);
+      }
+      WHOLEMEMORY_FAIL("Open file %s for read failed, error=%s",
+                       file_names[segment.file_id],
+                       strerror(errno));
+    }
+    file_fds[segment.file_id] = fd;
+  }
+
+  thread_count = std::min<int>(thread_count, read_blocks.size());
+  std::atomic<size_t> next_block(0);
+  std::mutex error_mu;
+  std::string error_msg;
+  MultiThreadRun(thread_count, [&](int, int) {
+    char* buffers[2]      = {nullptr, nullptr};
+    cudaEvent_t events[2] = {nullptr, nullptr};
+    cudaStream_t stream   = nullptr;
+    // with conversion, file data is read into read_buffer and converted into pinned buffers.
+    std::vector<char> read_buffer(conversion != nullptr ? buffer_entry_count * entry_size : 0);
+    try {
+      WM_CUDA_CHECK(cudaSetDevice(dev_id));
+      WM_CUDA_CHECK(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+      for (int i = 0; i < 2; i++) {
+        WM_CUDA_CHECK(cudaMallocHost((void**)&buffers[i], buffer_entry_count * memory_write_size));
+        WM_CUDA_CHECK(cudaEventCreateWithFlags(&events[i], cudaEventDisableTiming));
+      }
+      int buffer_idx = 0;
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(error_mu);
+          if (!error_msg.empty()) break;
+        }
+        size_t block_idx = next_block.fetch_add(1);
+        if (block_idx >= read_blocks.size()) break;
+        auto& block = read_blocks[block_idx];
+        // wait until previous copy from this buffer is done.
+        WM_CUDA_CHECK(cudaEventSynchronize(events[buffer_idx]));
+        pread_fully(file_fds.at(block.file_id),
+                    conversion != nullptr ? read_buffer.data() : buffers[buffer_idx],
+                    block.entry_count * entry_size,
+                    block.file_offset,
+                    file_names[block.file_id]);
+        if (conversion != nullptr) {
+          convert_file_entries(
+            buffers[buffer_idx], read_buffer.data(), block.entry_count, entry_size, *conversion);
+        }
+        copy_entries_to_local(block.local_write_ptr,
+                              buffers[buffer_idx],
+                              block.entry_count,
+                              memory_entry_stride,
+                              memory_write_size,
+                              stream);
+        WM_CUDA_CHECK(cudaEventRecord(events[buffer_idx], stream));
+        buffer_idx = 1 - buffer_idx;
+      }
+      WM_CUDA_CHECK(cudaStreamSynchronize(stream));
+    } catch (std::exception& e) {
+      std::unique_lock<std::mutex> lock(error_mu);
+      if (error_msg.empty()) error_msg = e.what();
+    }
+    if (stream != nullptr) WM_CUDA_CHECK_NO_THROW(cudaStreamSynchronize(stream));
+    for (int i = 0; i < 2; i++) {
+      if (events[i] != nullptr) WM_CUDA_CHECK_NO_THROW(cudaEventDestroy(events[i]));
+      if (buffers[i] != nullptr) WM_CUDA_CHECK_NO_THROW(cudaFreeHost(buffers[i]));
+    }
+    if (stream != nullptr) WM_CUDA_CHECK_NO_THROW(cudaStreamDestroy(stream));
+  });
+
+  for (auto& id_fd : file_fds) {
+    close(id_fd.second);
+  }
+  if (!error_msg.empty()) { WHOLEMEMORY_FAIL("Parallel loading failed: %s", error_msg.c_str()); }
+}
+
+/**
+ * CRC-32 (same as zlib crc32) with slicing by 8 tables.
+ */
+struct crc32_tables {
+  uint32_t table[8][256];
+  crc32_tables()
+  {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++)
+        c = (c & 1) ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+      table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+      for (int t = 1; t < 8; t++)
+        table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xFF];
+    }
+  }
+};
+
+static uint32_t crc32_update(uint32_t crc, const void* data, size_t size)
+{
+  static const crc32_tables tables;
+  auto& t         = tables.table;
+  const auto* ptr = static_cast<const uint8_t*>(data);
+  crc             = ~crc;
+  while (size >= 8) {
+    uint32_t one, two;
+    memcpy(&one, ptr, 4);
+    memcpy(&two, ptr + 4, 4);
+    one ^= crc;
+    crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24] ^
+          t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+    ptr += 8;
+    size -= 8;
+  }
+  while (size-- > 0) {
+    crc = (crc >> 8) ^ t[0][(crc ^ *ptr++) & 0xFF];
+  }
+  return ~crc;
+}
+
+static uint32_t crc32_of_file(const char* file_name)
+{
+  int fd = open(file_name, O_RDONLY);
+  if (fd < 0) { WHOLEMEMORY_FAIL("Open file %s failed, error=%s", file_name, strerror(errno)); }
+  constexpr size_t kChecksumBufferSize = 16 * 1024 * 1024;
+  std::vector<char> buffer(kChecksumBufferSize);
+  uint32_t crc  = 0;
+  size_t offset = 0;
+  while (true) {
+    ssize_t ret = pread(fd, buffer.data(), buffer.size(), offset);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0) {
+      close(fd);
+      WHOLEMEMORY_FAIL("pread file %s failed, error=%s", file_name, strerror(errno));
+    }
+    if (ret == 0) break;
+    crc = crc32_update(crc, buffer.data(), ret);
+    offset += ret;
+  }
+  close(fd);
+  return crc;
+}
+
+static bool check_file_entry_conversion(size_t entry_size,
+                                        const file_entry_conversion* conversion)
+{
+  if (conversion == nullptr) return true;
+  bool const file_is_float   = wholememory_dtype_is_floating_number(conversion->file_dtype);
+  bool const memory_is_float = wholememory_dtype_is_floating_number(conversion->memory_dtype);
+  bool const file_is_int     = wholememory_dtype_is_integer_number(conversion->file_dtype);
+  bool const memory_is_int   = wholememory_dtype_is_integer_number(conversion->memory_dtype);
+  if (!(file_is_float && memory_is_float) && !(file_is_int && memory_is_int)) {
+    WHOLEMEMORY_ERROR("Conversion from file dtype %d to memory dtype %d not supported.",
+                      static_cast<int>(conversion->file_dtype),
+                      static_cast<int>(conversion->memory_dtype));
+    return false;
+  }
+  size_t const file_element_size = wholememory_dtype_get_element_size(conversion->file_dtype);
+  if (entry_size % file_element_size != 0 || conversion->column_count == 0 ||
+      conversion->column_start + conversion->column_count > entry_size / file_element_size) {
+    WHOLEMEMORY_ERROR("Invalid conversion, entry_size=%ld, element_size=%ld, columns [%ld, %ld)",
+                      entry_size,
+                      file_element_size,
+                      conversion->column_start,
+                      conversion->column_start + conversion->column_count);
+    return false;
+  }
+  return true;
+}
+
 wholememory_error_code_t load_file_to_handle(wholememory_handle_t wholememory_handle,
                                              size_t memory_offset,
                                              size_t memory_entry_stride,
                                              size_t entry_size,
                                              const char** file_names,
-                                             int file_count) noexcept
+                                             int file_count,
+                                             const file_entry_conversion* conversion) noexcept
 {
-  if (entry_size <= 0 || memory_offset < 0 || memory_offset + entry_size > memory_entry_stride) {
-    WHOLEMEMORY_ERROR("Invalid input, entry_size=%ld, memory_entry_stride=%ld, memory_offset=%ld",
-                      entry_size,
-                      memory_entry_stride,
-                      memory_offset);
+  if (!check_file_entry_conversion(entry_size, conversion)) { return WHOLEMEMORY_INVALID_INPUT; }
+  if (wholememory_handle == nullptr || !is_writable(wholememory_handle)) {
+    WHOLEMEMORY_ERROR("wholememory_handle is read only, map files with write back to load.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  // same dtype and all columns is plain copy, which keeps the faster direct read path.
+  if (conversion != nullptr && conversion->file_dtype == conversion->memory_dtype &&
+      conversion->column_start == 0 &&
+      conversion->column_count * wholememory_dtype_get_element_size(conversion->file_dtype) ==
+        entry_size) {
+    conversion = nullptr;
+  }
+  size_t const memory_write_size = get_memory_write_size(entry_size, conversion);
+  if (entry_size <= 0 || memory_offset < 0 ||
+      memory_offset + memory_write_size > memory_entry_stride) {
+    WHOLEMEMORY_ERROR(
+      "Invalid input, entry_size=%ld, memory_write_size=%ld, memory_entry_stride=%ld, "
+      "memory_offset=%ld",
+      entry_size,
+      memory_write_size,
+      memory_entry_stride,
+      memory_offset);
     return WHOLEMEMORY_INVALID_INPUT;
   }
   size_t wm_data_granularity = wholememory_get_data_granularity(wholememory_handle);
@@ -86,7 +803,8 @@ wholememory_error_code_t load_file_to_handle(wholememory_handle_t wholememory_ha
 
   size_t wm_total_size = wholememory_get_total_size(wholememory_handle);
   size_t expected_file_size =
-    get_handle_partial_size(wm_total_size, memory_offset, memory_entry_stride, entry_size);
+    get_handle_partial_size(wm_total_size, memory_offset, memory_entry_stride, memory_write_size) /
+    memory_write_size * entry_size;
 
   if (file_count < 0 || file_count >= 65536) {
     WHOLEMEMORY_ERROR("input file count=%d", file_count);
@@ -153,17 +871,6 @@ wholememory_error_code_t load_file_to_handle(wholememory_handle_t wholememory_ha
                         (void**)(&local_ptr), &local_size, &local_offset, wholememory_handle) ==
                       WHOLEMEMORY_SUCCESS);
 
-    constexpr int kSuggestedBufferSize = 16 * 1024 * 1024;
-    size_t buffer_size;
-    size_t buffer_entry_count = 1;
-    if (kSuggestedBufferSize < entry_size) {
-      buffer_size = entry_size;
-    } else {
-      buffer_entry_count = kSuggestedBufferSize / entry_size;
-      buffer_size        = buffer_entry_count * entry_size;
-    }
-    std::vector<char> file_read_buffer(buffer_size);
-
     size_t local_entry_memory_start_index = local_offset / memory_entry_stride;
     size_t local_entry_file_start_index =
       local_entry_memory_start_index - memory_offset / memory_entry_stride;
@@ -173,8 +880,8 @@ wholememory_error_code_t load_file_to_handle(wholememory_handle_t wholememory_ha
       local_entry_count -= memory_offset / memory_entry_stride;
       local_write_ptr += (memory_offset / memory_entry_stride) * memory_entry_stride;
     }
-    size_t local_entry_idx = 0;
 
+    std::vector<file_read_segment> read_segments;
     size_t file_entry_offset = 0;
     size_t total_read_bytes  = 0;
     for (int i = 0; i < file_count; i++) {
@@ -183,77 +890,66 @@ wholememory_error_code_t load_file_to_handle(wholememory_handle_t wholememory_ha
       if (file_entry_offset >= local_entry_file_start_index + local_entry_count) break;
       // in reading window
       if (file_entry_offset + file_entry_count > local_entry_file_start_index) {
-        size_t file_read_start_offset = 0;
-        FILE* fp                      = fopen(file_names[i], "rb");
-        if (fp == nullptr) { WHOLEMEMORY_ERROR("Open file %s for read failed.", file_names[i]); }
         // maybe in window end, remove possible tailing data that don't belong to current rank.
         size_t to_read_file_entry_count = std::min(
           file_entry_count, local_entry_file_start_index + local_entry_count - file_entry_offset);
         // if in window begin, remove possible data that belongs to previous rank and skip disk
         // data.
+        size_t skip_entry_count = 0;
         if (file_entry_offset < local_entry_file_start_index) {
-          size_t skip_entry_count = local_entry_file_start_index - file_entry_offset;
-
-          file_read_start_offset = skip_entry_count * entry_size;
-
-          if (fseeko(fp, file_read_start_offset, SEEK_SET) != 0) {
-            WHOLEMEMORY_ERROR(
-              "File %s seek to %ld failed.", file_names[i], skip_entry_count * entry_size);
-          }
+          skip_entry_count = local_entry_file_start_index - file_entry_offset;
           to_read_file_entry_count -= skip_entry_count;
         }
-        // now all data in file_entry_count need to be read.
-        size_t bytes_to_read    = to_read_file_entry_count * entry_size;
-        size_t left_entry_count = to_read_file_entry_count;
-        while (left_entry_count > 0) {
-          size_t read_entry_count = std::min(left_entry_count, buffer_entry_count);
-
-          int ret = fread(file_read_buffer.data(), entry_size, read_entry_count, fp);
-          if (ret != read_entry_count) {
-            WHOLEMEMORY_ERROR(
-              "File %s line %d: reading from file %s, read_entry_count=%ld, entry_size=%ld, "
-              "returned %d, error=%s\n",
-              __FILE__,
-              __LINE__,
-              file_names[i],
-              read_entry_count,
-              entry_size,
-              ret,
-              strerror(errno));
-          }
+        file_read_segment segment;
+        segment.file_id         = i;
+        segment.file_offset     = skip_entry_count * entry_size;
+        segment.entry_count     = to_read_file_entry_count;
+        segment.local_write_ptr = local_write_ptr;
+        read_segments.push_back(segment);
+        local_write_ptr += to_read_file_entry_count * memory_entry_stride;
+        total_read_bytes += to_read_file_entry_count * entry_size;
+      }
+      file_entry_offset += file_entry_count;
+    }
 
-          if (entry_size != memory_entry_stride) {
-            WM_CUDA_CHECK(cudaMemcpy2D(local_write_ptr,
+    int thread_count = get_load_thread_count();
+    // host memory with same entry size and stride can be read into directly.
+    bool direct_read = wholememory_get_memory_location(wholememory_handle) == WHOLEMEMORY_ML_HOST &&
+                       entry_size == memory_entry_stride && conversion == nullptr;
+    auto start_time = std::chrono::steady_clock::now();
+    if (direct_read) {
+      read_file_segments_to_host(
+        read_segments, entry_size, file_names, thread_count, get_use_direct_io());
+    } else if (thread_count > 1) {
+      read_file_segments_multi_thread(read_segments,
+                                      memory_entry_stride,
+                                      entry_size,
+                                      file_names,
+                                      wm_comm->dev_id,
+                                      thread_count,
+                                      conversion);
+    } else {
+      read_file_segments_single_thread(read_segments,
                                        memory_entry_stride,
-                                       file_read_buffer.data(),
-                                       entry_size,
                                        entry_size,
-                                       read_entry_count,
-                                       cudaMemcpyDefault));
-          } else {
-            WM_CUDA_CHECK(cudaMemcpy(local_write_ptr,
-                                     file_read_buffer.data(),
-                                     read_entry_count * entry_size,
-                                     cudaMemcpyDefault));
-          }
-          local_write_ptr += read_entry_count * memory_entry_stride;
-
-          left_entry_count -= read_entry_count;
-        }
-        fclose(fp);
-        WHOLEMEMORY_INFO(
-          "Rank=%d done Reading %ld bytes from file %s size=%ld, starting from offset=%ld.",
-          wm_rank,
-          bytes_to_read,
-          file_names[i],
-          file_sizes[i],
-          file_read_start_offset);
-        total_read_bytes += bytes_to_read;
-      }
-      file_entry_offset += file_entry_count;
+                                       file_names,
+                                       file_sizes,
+                                       wm_rank,
+                                       conversion);
     }
+    double elapsed_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    double bandwidth_gbps =
+      elapsed_seconds > 0 ? static_cast<double>(total_read_bytes) / 1e9 / elapsed_seconds : 0.0;
     WHOLEMEMORY_INFO(
-      "Rank=%d done reading total %ld bytes from needed files.", wm_rank, total_read_bytes);
+      "Rank=%d done reading total %ld bytes from needed files with %d thread(s)%s in %.3f "
+      "seconds, %.2f GB/s.",
+      wm_rank,
+      total_read_bytes,
+      thread_count,
+      direct_read ? " directly to host memory" : "",
+      elapsed_seconds,
+      bandwidth_gbps);
     wm_comm->barrier();
   } catch (wholememory::logic_error& wle) {
     WHOLEMEMORY_ERROR("Logic error: %s", wle.what());
@@ -273,7 +969,8 @@ wholememory_error_code_t store_handle_to_file(wholememory_handle_t wholememory_h
                                               size_t memory_offset,
                                               size_t memory_entry_stride,
                                               size_t entry_size,
-                                              const char* local_file_name) noexcept
+                                              const char* local_file_name,
+                                              uint32_t* checksum) noexcept
 {
   if (entry_size <= 0 || memory_offset < 0 || memory_offset + entry_size > memory_entry_stride) {
     WHOLEMEMORY_ERROR("Invalid input, entry_size=%ld, memory_entry_stride=%ld, memory_offset=%ld",
@@ -303,86 +1000,885 @@ wholememory_error_code_t store_handle_to_file(wholememory_handle_t wholememory_h
 
     wm_comm->barrier();
 
-    WHOLEMEMORY_CHECK(wholememory_get_local_memory(
-                        (void**)(&local_ptr), &local_size, &local_offset, wholememory_handle) ==
+    // writing may fail on any rank, the other ranks still wait in the barrier below.
+    std::exception_ptr write_exception;
+    try {
+      WHOLEMEMORY_CHECK(wholememory_get_local_memory(
+                          (void**)(&local_ptr), &local_size, &local_offset, wholememory_handle) ==
+                        WHOLEMEMORY_SUCCESS);
+
+      size_t local_entry_count = local_size / memory_entry_stride;
+      char* local_write_ptr    = local_ptr + memory_offset % memory_entry_stride;
+      if (wm_rank == 0) {
+        local_entry_count -= memory_offset / memory_entry_stride;
+        local_write_ptr += (memory_offset / memory_entry_stride) * memory_entry_stride;
+      }
+
+      if (wholememory_get_memory_location(wholememory_handle) == WHOLEMEMORY_ML_HOST &&
+          entry_size == memory_entry_stride) {
+        // host memory with same entry size and stride can be written from directly.
+        int fd = open(local_file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+          WHOLEMEMORY_FAIL("Rank=%d, open output file %s failed, error=%s",
+                           wm_rank,
+                           local_file_name,
+                           strerror(errno));
+        }
+        int direct_fd = get_use_direct_io() ? open_direct_io_file(local_file_name, O_WRONLY) : -1;
+        try {
+          file_transfer_maybe_direct(true,
+                                     fd,
+                                     direct_fd,
+                                     local_write_ptr,
+                                     local_entry_count * entry_size,
+                                     0,
+                                     local_file_name);
+          if (checksum != nullptr) {
+            *checksum = crc32_update(0, local_write_ptr, local_entry_count * entry_size);
+          }
+        } catch (...) {
+          close(fd);
+          if (direct_fd >= 0) close(direct_fd);
+          throw;
+        }
+        if (direct_fd >= 0) close(direct_fd);
+        close(fd);
+      } else {
+        size_t buffer_entry_count = get_file_io_buffer_entry_count(entry_size);
+        std::vector<char> file_write_buffer(buffer_entry_count * entry_size);
+        if (checksum != nullptr) *checksum = 0;
+
+        FILE* fp = fopen(local_file_name, "wb");
+        if (fp == nullptr) {
+          WHOLEMEMORY_FAIL("Rank=%d, open output file %s failed.", wm_rank, local_file_name);
+        }
+
+        size_t left_entry_count = local_entry_count;
+        while (left_entry_count > 0) {
+          size_t write_entry_count = std::min(left_entry_count, buffer_entry_count);
+          if (entry_size != memory_entry_stride) {
+            WM_CUDA_CHECK(cudaMemcpy2D(file_write_buffer.data(),
+                                       entry_size,
+                                       local_write_ptr,
+                                       memory_entry_stride,
+                                       entry_size,
+                                       write_entry_count,
+                                       cudaMemcpyDefault));
+          } else {
+            WM_CUDA_CHECK(cudaMemcpy(file_write_buffer.data(),
+                                     local_write_ptr,
+                                     write_entry_count * entry_size,
+                                     cudaMemcpyDefault));
+          }
+          local_write_ptr += write_entry_count * memory_entry_stride;
+          if (checksum != nullptr) {
+            *checksum =
+              crc32_update(*checksum, file_write_buffer.data(), write_entry_count * entry_size);
+          }
+          size_t ret = fwrite(file_write_buffer.data(), entry_size, write_entry_count, fp);
+
+          if (ret != write_entry_count) {
+            int write_errno = errno;
+            fclose(fp);
+            WHOLEMEMORY_FAIL(
+              "Rank=%d, writing to file %s, write_entry_count=%ld, entry_size=%ld, "
+              "returned %ld, error=%s",
+              wm_rank,
+              local_file_name,
+              write_entry_count,
+              entry_size,
+              ret,
+              strerror(write_errno));
+          }
+
+          left_entry_count -= write_entry_count;
+        }
+
+        if (fclose(fp) != 0) {
+          WHOLEMEMORY_FAIL("Rank=%d, closing output file %s failed, error=%s",
+                           wm_rank,
+                           local_file_name,
+                           strerror(errno));
+        }
+      }
+
+      WHOLEMEMORY_INFO("Rank=%d done writing to file %s.", wm_rank, local_file_name);
+    } catch (...) {
+      write_exception = std::current_exception();
+    }
+
+    wm_comm->barrier();
+    if (write_exception) { std::rethrow_exception(write_exception); }
+
+  } catch (wholememory::logic_error& wle) {
+    WHOLEMEMORY_ERROR("Logic error: %s", wle.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (wholememory::cuda_error& wce) {
+    WHOLEMEMORY_ERROR("CUDA error: %s", wce.what());
+    return WHOLEMEMORY_CUDA_ERROR;
+  } catch (...) {
+    WHOLEMEMORY_ERROR("Unknow error caught at file %s, line %d", __FILE__, __LINE__);
+    return WHOLEMEMORY_UNKNOW_ERROR;
+  }
+
+  return WHOLEMEMORY_SUCCESS;
+}
+
+static constexpr int kCheckpointVersion = 1;
+
+static std::string get_checkpoint_meta_file_name(const char* file_prefix)
+{
+  return std::string(file_prefix) + "_meta";
+}
+
+static std::string get_checkpoint_part_file_name(const char* file_prefix,
+                                                 int part_id,
+                                                 int part_count)
+{
+  return std::string(file_prefix) + "_part_" + std::to_string(part_id) + "_of_" +
+         std::to_string(part_count);
+}
+
+static bool get_tensor_file_layout(const wholememory_tensor_description_t* tensor_description,
+                                   size_t* memory_offset,
+                                   size_t* memory_entry_stride,
+                                   size_t* entry_size)
+{
+  if (tensor_description->dim != 1 && tensor_description->dim != 2) return false;
+  size_t element_size  = wholememory_dtype_get_element_size(tensor_description->dtype);
+  *memory_offset       = tensor_description->storage_offset * element_size;
+  *memory_entry_stride = tensor_description->strides[0] * element_size;
+  *entry_size =
+    tensor_description->dim == 1 ? element_size : tensor_description->sizes[1] * element_size;
+  return true;
+}
+
+static wholememory_error_code_t write_checkpoint_meta(
+  const char* file_prefix,
+  const wholememory_tensor_description_t* tensor_description,
+  size_t entry_size,
+  const std::vector<int64_t>& part_infos)
+{
+  int part_count    = part_infos.size() / 3;
+  int64_t row_count = 0;
+  for (int i = 0; i < part_count; i++) {
+    row_count += part_infos[i * 3];
+  }
+  if (row_count != tensor_description->sizes[0]) {
+    WHOLEMEMORY_ERROR("Checkpoint row count %ld doesn't match tensor size %ld.",
+                      row_count,
+                      tensor_description->sizes[0]);
+    return WHOLEMEMORY_INVALID_VALUE;
+  }
+  std::string meta_file_name     = get_checkpoint_meta_file_name(file_prefix);
+  std::string tmp_meta_file_name = meta_file_name + ".tmp";
+  FILE* fp                       = fopen(tmp_meta_file_name.c_str(), "w");
+  if (fp == nullptr) {
+    WHOLEMEMORY_ERROR("Open checkpoint meta file %s failed.", tmp_meta_file_name.c_str());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  fprintf(fp, "WHOLEMEMORY_CHECKPOINT %d\n", kCheckpointVersion);
+  fprintf(fp, "dtype %d\n", static_cast<int>(tensor_description->dtype));
+  fprintf(fp, "dim %d\n", tensor_description->dim);
+  fprintf(fp, "sizes");
+  for (int i = 0; i < tensor_description->dim; i++) {
+    fprintf(fp, " %ld", tensor_description->sizes[i]);
+  }
+  fprintf(fp, "\n");
+  fprintf(fp, "entry_size %ld\n", entry_size);
+  fprintf(fp, "part_count %d\n", part_count);
+  int64_t row_start = 0;
+  for (int i = 0; i < part_count; i++) {
+    fprintf(fp,
+            "part %d %ld %ld %08x\n",
+            i,
+            row_start,
+            part_infos[i * 3],
+            static_cast<uint32_t>(part_infos[i * 3 + 1]));
+    row_start += part_infos[i * 3];
+  }
+  bool write_failed = ferror(fp) != 0;
+  if (fclose(fp) != 0 || write_failed ||
+      rename(tmp_meta_file_name.c_str(), meta_file_name.c_str()) != 0) {
+    WHOLEMEMORY_ERROR("Write checkpoint meta file %s failed.", meta_file_name.c_str());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  WHOLEMEMORY_INFO(
+    "Checkpoint meta file %s written, %d parts.", meta_file_name.c_str(), part_count);
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t store_tensor_to_checkpoint(
+  wholememory_handle_t wholememory_handle,
+  const wholememory_tensor_description_t* tensor_description,
+  const char* file_prefix) noexcept
+{
+  size_t memory_offset, memory_entry_stride, entry_size;
+  if (file_prefix == nullptr || tensor_description == nullptr ||
+      !get_tensor_file_layout(
+        tensor_description, &memory_offset, &memory_entry_stride, &entry_size)) {
+    WHOLEMEMORY_ERROR("Invalid input, only 1D or 2D tensor with file prefix is supported.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  try {
+    wholememory_comm_t wm_comm;
+    WHOLEMEMORY_CHECK(wholememory_get_communicator(&wm_comm, wholememory_handle) ==
                       WHOLEMEMORY_SUCCESS);
+    int wm_rank, wm_size;
+    WHOLEMEMORY_CHECK(wholememory_communicator_get_rank(&wm_rank, wm_comm) == WHOLEMEMORY_SUCCESS);
+    WHOLEMEMORY_CHECK(wholememory_communicator_get_size(&wm_size, wm_comm) == WHOLEMEMORY_SUCCESS);
 
-    constexpr int kSuggestedBufferSize = 16 * 1024 * 1024;
-    size_t buffer_size;
-    size_t buffer_entry_count = 1;
-    if (kSuggestedBufferSize < entry_size) {
-      buffer_size = entry_size;
-    } else {
-      buffer_entry_count = kSuggestedBufferSize / entry_size;
-      buffer_size        = buffer_entry_count * entry_size;
+    std::string part_file_name = get_checkpoint_part_file_name(file_prefix, wm_rank, wm_size);
+    uint32_t checksum          = 0;
+    size_t part_file_size      = 0;
+    // every rank reaches the collectives below and returns the same error on failure.
+    auto local_error_code = store_handle_to_file(wholememory_handle,
+                                                 memory_offset,
+                                                 memory_entry_stride,
+                                                 entry_size,
+                                                 part_file_name.c_str(),
+                                                 &checksum);
+    if (local_error_code == WHOLEMEMORY_SUCCESS) {
+      part_file_size = StatFileSize(part_file_name.c_str());
+      if (part_file_size == static_cast<size_t>(-1)) {
+        WHOLEMEMORY_ERROR("Stat checkpoint part file %s failed.", part_file_name.c_str());
+        local_error_code = WHOLEMEMORY_LOGIC_ERROR;
+      }
+    }
+    // row count, checksum and error code of each part
+    int64_t local_part_info[3] = {
+      static_cast<int64_t>(part_file_size / entry_size), checksum, local_error_code};
+    std::vector<int64_t> part_infos(wm_size * 3);
+    wm_comm->host_allgather(local_part_info, part_infos.data(), 3, WHOLEMEMORY_DT_INT64);
+    for (int i = 0; i < wm_size; i++) {
+      if (part_infos[i * 3 + 2] != WHOLEMEMORY_SUCCESS) {
+        WHOLEMEMORY_ERROR("Storing checkpoint %s failed on rank %d.", file_prefix, i);
+        return static_cast<wholememory_error_code_t>(part_infos[i * 3 + 2]);
+      }
     }
-    std::vector<char> file_write_buffer(buffer_size);
 
-    size_t local_entry_count = local_size / memory_entry_stride;
-    char* local_write_ptr    = local_ptr + memory_offset % memory_entry_stride;
+    int meta_error_code = WHOLEMEMORY_SUCCESS;
     if (wm_rank == 0) {
-      local_entry_count -= memory_offset / memory_entry_stride;
-      local_write_ptr += (memory_offset / memory_entry_stride) * memory_entry_stride;
+      meta_error_code =
+        write_checkpoint_meta(file_prefix, tensor_description, entry_size, part_infos);
+    }
+    // only rank 0 contributes, so the sum is its error code.
+    int total_meta_error_code = WHOLEMEMORY_SUCCESS;
+    wm_comm->host_allreduce(
+      &meta_error_code, &total_meta_error_code, 1, WHOLEMEMORY_DT_INT, ncclSum);
+    if (total_meta_error_code != WHOLEMEMORY_SUCCESS) {
+      return static_cast<wholememory_error_code_t>(total_meta_error_code);
     }
+  } catch (wholememory::logic_error& wle) {
+    WHOLEMEMORY_ERROR("Logic error: %s", wle.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (wholememory::cuda_error& wce) {
+    WHOLEMEMORY_ERROR("CUDA error: %s", wce.what());
+    return WHOLEMEMORY_CUDA_ERROR;
+  } catch (...) {
+    WHOLEMEMORY_ERROR("Unknow error caught at file %s, line %d", __FILE__, __LINE__);
+    return WHOLEMEMORY_UNKNOW_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+struct checkpoint_meta {
+  int version = 0;
+  int dtype   = 0;
+  int dim     = 0;
+  int64_t sizes[2]{0, 0};
+  size_t entry_size = 0;
+  std::vector<int64_t> part_row_starts;
+  std::vector<int64_t> part_row_counts;
+  std::vector<uint32_t> part_checksums;
+};
 
-    FILE* fp = fopen(local_file_name, "wb");
-    if (fp == nullptr) {
-      WHOLEMEMORY_ERROR("Rank=%d, open output file %s failed.\n", wm_rank, local_file_name);
+static bool read_checkpoint_meta(const char* meta_file_name, checkpoint_meta* meta)
+{
+  FILE* fp = fopen(meta_file_name, "r");
+  if (fp == nullptr) {
+    WHOLEMEMORY_ERROR("Open checkpoint meta file %s failed.", meta_file_name);
+    return false;
+  }
+  bool success   = false;
+  int part_count = 0;
+  do {
+    if (fscanf(fp, " WHOLEMEMORY_CHECKPOINT %d", &meta->version) != 1) break;
+    if (meta->version != kCheckpointVersion) {
+      WHOLEMEMORY_ERROR("Checkpoint version %d not supported.", meta->version);
+      break;
+    }
+    if (fscanf(fp, " dtype %d dim %d sizes", &meta->dtype, &meta->dim) != 2) break;
+    if (meta->dim != 1 && meta->dim != 2) break;
+    if (fscanf(fp, " %ld", &meta->sizes[0]) != 1) break;
+    if (meta->dim == 2 && fscanf(fp, " %ld", &meta->sizes[1]) != 1) break;
+    if (fscanf(fp, " entry_size %ld part_count %d", &meta->entry_size, &part_count) != 2) break;
+    if (part_count <= 0 || part_count >= 65536) break;
+    // parts are concatenated in order, so row starts must be the prefix sum of row counts.
+    int i                  = 0;
+    int64_t next_row_start = 0;
+    for (; i < part_count; i++) {
+      int part_id;
+      int64_t row_start, row_count;
+      uint32_t checksum;
+      if (fscanf(fp, " part %d %ld %ld %x", &part_id, &row_start, &row_count, &checksum) != 4 ||
+          part_id != i || row_start != next_row_start || row_count < 0) {
+        break;
+      }
+      next_row_start += row_count;
+      meta->part_row_starts.push_back(row_start);
+      meta->part_row_counts.push_back(row_count);
+      meta->part_checksums.push_back(checksum);
     }
+    success = i == part_count && next_row_start == meta->sizes[0];
+  } while (false);
+  fclose(fp);
+  if (!success) { WHOLEMEMORY_ERROR("Parse checkpoint meta file %s failed.", meta_file_name); }
+  return success;
+}
 
-    size_t left_entry_count = local_entry_count;
-    while (left_entry_count > 0) {
-      size_t write_entry_count = std::min(left_entry_count, buffer_entry_count);
-      if (entry_size != memory_entry_stride) {
-        WM_CUDA_CHECK(cudaMemcpy2D(file_write_buffer.data(),
-                                   entry_size,
-                                   local_write_ptr,
-                                   memory_entry_stride,
-                                   entry_size,
-                                   write_entry_count,
-                                   cudaMemcpyDefault));
-      } else {
-        WM_CUDA_CHECK(cudaMemcpy(file_write_buffer.data(),
-                                 local_write_ptr,
-                                 write_entry_count * entry_size,
-                                 cudaMemcpyDefault));
+wholememory_error_code_t load_tensor_from_checkpoint(
+  wholememory_handle_t wholememory_handle,
+  const wholememory_tensor_description_t* tensor_description,
+  const char* file_prefix,
+  bool verify_checksum) noexcept
+{
+  size_t memory_offset, memory_entry_stride, entry_size;
+  if (file_prefix == nullptr || tensor_description == nullptr ||
+      !get_tensor_file_layout(
+        tensor_description, &memory_offset, &memory_entry_stride, &entry_size)) {
+    WHOLEMEMORY_ERROR("Invalid input, only 1D or 2D tensor with file prefix is supported.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  checkpoint_meta meta;
+  std::vector<std::string> part_file_names;
+  std::vector<const char*> part_file_name_ptrs;
+  int part_count = 0;
+  try {
+    wholememory_comm_t wm_comm;
+    WHOLEMEMORY_CHECK(wholememory_get_communicator(&wm_comm, wholememory_handle) ==
+                      WHOLEMEMORY_SUCCESS);
+    int wm_rank, wm_size;
+    WHOLEMEMORY_CHECK(wholememory_communicator_get_rank(&wm_rank, wm_comm) == WHOLEMEMORY_SUCCESS);
+    WHOLEMEMORY_CHECK(wholememory_communicator_get_size(&wm_size, wm_comm) == WHOLEMEMORY_SUCCESS);
+
+    // every rank validates locally, the result is reduced so that all ranks fail together.
+    int invalid_count          = 0;
+    std::string meta_file_name = get_checkpoint_meta_file_name(file_prefix);
+    if (!read_checkpoint_meta(meta_file_name.c_str(), &meta)) {
+      invalid_count++;
+    } else if (meta.dtype != tensor_description->dtype || meta.dim != tensor_description->dim ||
+               meta.sizes[0] != tensor_description->sizes[0] ||
+               (meta.dim == 2 && meta.sizes[1] != tensor_description->sizes[1]) ||
+               meta.entry_size != entry_size) {
+      WHOLEMEMORY_ERROR(
+        "Checkpoint %s with dtype=%d, dim=%d, sizes=(%ld, %ld), entry_size=%ld doesn't match "
+        "tensor with dtype=%d, dim=%d, sizes=(%ld, %ld), entry_size=%ld",
+        file_prefix,
+        meta.dtype,
+        meta.dim,
+        meta.sizes[0],
+        meta.sizes[1],
+        meta.entry_size,
+        static_cast<int>(tensor_description->dtype),
+        tensor_description->dim,
+        tensor_description->sizes[0],
+        tensor_description->dim == 2 ? tensor_description->sizes[1] : 0,
+        entry_size);
+      invalid_count++;
+    } else {
+      part_count = meta.part_row_counts.size();
+      for (int i = 0; i < part_count; i++) {
+        part_file_names.push_back(get_checkpoint_part_file_name(file_prefix, i, part_count));
+        size_t part_file_size = StatFileSize(part_file_names[i].c_str());
+        if (part_file_size != meta.part_row_counts[i] * entry_size) {
+          WHOLEMEMORY_ERROR(
+            "Checkpoint part file %s size=%ld, but expected %ld rows of %ld bytes.",
+            part_file_names[i].c_str(),
+            part_file_size,
+            meta.part_row_counts[i],
+            entry_size);
+          invalid_count++;
+        }
       }
-      local_write_ptr += write_entry_count * memory_entry_stride;
-      int ret = fwrite(file_write_buffer.data(), entry_size, write_entry_count, fp);
+    }
+    int total_invalid_count = 0;
+    wm_comm->host_allreduce(&invalid_count, &total_invalid_count, 1, WHOLEMEMORY_DT_INT, ncclSum);
+    if (total_invalid_count != 0) {
+      WHOLEMEMORY_ERROR(
+        "Checkpoint %s failed validation on %d ranks.", file_prefix, total_invalid_count);
+      return WHOLEMEMORY_INVALID_VALUE;
+    }
+    for (auto& part_file_name : part_file_names) {
+      part_file_name_ptrs.push_back(part_file_name.c_str());
+    }
 
-      if (ret != write_entry_count) {
+    if (verify_checksum) {
+      // each part is verified by one rank.
+      int mismatch_count = 0;
+      for (int i = wm_rank; i < part_count; i += wm_size) {
+        uint32_t checksum = crc32_of_file(part_file_names[i].c_str());
+        if (checksum != meta.part_checksums[i]) {
+          WHOLEMEMORY_ERROR("Checkpoint part file %s checksum=%08x, but expected %08x.",
+                            part_file_names[i].c_str(),
+                            checksum,
+                            meta.part_checksums[i]);
+          mismatch_count++;
+        }
+      }
+      int total_mismatch_count = 0;
+      wm_comm->host_allreduce(
+        &mismatch_count, &total_mismatch_count, 1, WHOLEMEMORY_DT_INT, ncclSum);
+      if (total_mismatch_count != 0) {
         WHOLEMEMORY_ERROR(
-          "File %s line %d: writing to file %s, write_entry_count=%ld, entry_size=%ld, "
-          "returned %d, error=%s\n",
-          __FILE__,
-          __LINE__,
-          local_file_name,
-          write_entry_count,
-          entry_size,
-          ret,
-          strerror(errno));
+          "Checkpoint %s has %d corrupted parts.", file_prefix, total_mismatch_count);
+        return WHOLEMEMORY_INVALID_VALUE;
       }
+    }
+  } catch (wholememory::logic_error& wle) {
+    WHOLEMEMORY_ERROR("Logic error: %s", wle.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (wholememory::cuda_error& wce) {
+    WHOLEMEMORY_ERROR("CUDA error: %s", wce.what());
+    return WHOLEMEMORY_CUDA_ERROR;
+  } catch (...) {
+    WHOLEMEMORY_ERROR("Unknow error caught at file %s, line %d", __FILE__, __LINE__);
+    return WHOLEMEMORY_UNKNOW_ERROR;
+  }
 
-      left_entry_count -= write_entry_count;
+  // part files are logically concatenated, each rank only reads the rows it owns.
+  return load_file_to_handle(wholememory_handle,
+                             memory_offset,
+                             memory_entry_stride,
+                             entry_size,
+                             part_file_name_ptrs.data(),
+                             part_count);
+}
+
+/**
+ * Compressed CSR file layout, all integers are little endian:
+ *   char magic[8]            : "WMCSRZ01"
+ *   int64_t node_count, edge_count
+ *   int32_t col_ind_element_size, rows_per_block
+ *   int64_t block_count      : ceil(node_count / rows_per_block)
+ *   (block_count + 1) x compressed_csr_block_index
+ *   degree sections of all blocks, degree of each row as unsigned LEB128 varint.
+ *   neighbor sections of all blocks, zigzag LEB128 varint of the delta to the previous neighbor
+ *   in the same block, the first neighbor of each block is delta to 0.
+ * Offsets are absolute file offsets, entry block_count holds the end of both section groups.
+ */
+static constexpr char kCompressedCsrMagic[8] = {'W', 'M', 'C', 'S', 'R', 'Z', '0', '1'};
+
+struct compressed_csr_header {
+  char magic[8];
+  int64_t node_count;
+  int64_t edge_count;
+  int32_t col_ind_element_size;
+  int32_t rows_per_block;
+  int64_t block_count;
+};
+static_assert(sizeof(compressed_csr_header) == 40, "compressed_csr_header should be packed.");
+
+struct compressed_csr_block_index {
+  int64_t edge_offset;
+  int64_t degree_offset;
+  int64_t neighbor_offset;
+};
+
+/**
+ * Consecutive blocks decoded by one thread, is_col_ind selects neighbor or degree sections.
+ */
+struct compressed_csr_task {
+  bool is_col_ind;
+  int64_t block_begin;
+  int64_t block_end;
+};
+
+static inline uint64_t decode_varint(const uint8_t*& ptr, const uint8_t* end)
+{
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (ptr >= end) { WHOLEMEMORY_FAIL("compressed CSR varint overruns its section."); }
+    uint8_t byte = *ptr++;
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) return value;
+  }
+  WHOLEMEMORY_FAIL("compressed CSR varint is longer than 10 bytes.");
+}
+
+static bool read_compressed_csr_index(int fd,
+                                      const char* file_name,
+                                      compressed_csr_header* header,
+                                      std::vector<compressed_csr_block_index>* index)
+{
+  size_t file_size = StatFileSize(file_name);
+  if (file_size == static_cast<size_t>(-1) || file_size < sizeof(compressed_csr_header)) {
+    return false;
+  }
+  pread_fully(fd, reinterpret_cast<char*>(header), sizeof(compressed_csr_header), 0, file_name);
+  if (memcmp(header->magic, kCompressedCsrMagic, sizeof(kCompressedCsrMagic)) != 0 ||
+      header->node_count < 0 || header->edge_count < 0 || header->rows_per_block <= 0 ||
+      (header->col_ind_element_size != 4 && header->col_ind_element_size != 8) ||
+      header->block_count != div_rounding_up_safe<int64_t>(header->node_count,
+                                                           header->rows_per_block)) {
+    return false;
+  }
+  size_t data_offset =
+    sizeof(compressed_csr_header) + (header->block_count + 1) * sizeof(compressed_csr_block_index);
+  if (data_offset > file_size) return false;
+  index->resize(header->block_count + 1);
+  pread_fully(fd,
+              reinterpret_cast<char*>(index->data()),
+              index->size() * sizeof(compressed_csr_block_index),
+              sizeof(compressed_csr_header),
+              file_name);
+  auto& idx = *index;
+  if (idx[0].edge_offset != 0 || idx[0].degree_offset != static_cast<int64_t>(data_offset) ||
+      idx[header->block_count].edge_offset != header->edge_count ||
+      idx[header->block_count].degree_offset != idx[0].neighbor_offset ||
+      idx[header->block_count].neighbor_offset != static_cast<int64_t>(file_size)) {
+    return false;
+  }
+  for (int64_t b = 0; b < header->block_count; b++) {
+    if (idx[b + 1].edge_offset < idx[b].edge_offset ||
+        idx[b + 1].degree_offset < idx[b].degree_offset ||
+        idx[b + 1].neighbor_offset < idx[b].neighbor_offset) {
+      return false;
     }
+  }
+  return true;
+}
 
-    fclose(fp);
+/**
+ * Split blocks [block_begin, block_end) into tasks of about kTaskEntryCount output entries.
+ */
+static void append_compressed_csr_tasks(const std::vector<compressed_csr_block_index>& index,
+                                        int64_t rows_per_block,
+                                        bool is_col_ind,
+                                        int64_t block_begin,
+                                        int64_t block_end,
+                                        std::vector<compressed_csr_task>* tasks)
+{
+  constexpr int64_t kTaskEntryCount = 2 * 1024 * 1024;
+  int64_t task_begin                = block_begin;
+  int64_t task_entry_count          = 0;
+  for (int64_t b = block_begin; b < block_end; b++) {
+    task_entry_count +=
+      is_col_ind ? index[b + 1].edge_offset - index[b].edge_offset : rows_per_block;
+    if (task_entry_count >= kTaskEntryCount || b + 1 == block_end) {
+      tasks->push_back(compressed_csr_task{is_col_ind, task_begin, b + 1});
+      task_begin       = b + 1;
+      task_entry_count = 0;
+    }
+  }
+}
+
+/**
+ * Decode row_ptr of rows [row_start, row_end) which should be inside the task blocks.
+ */
+static void decode_compressed_csr_row_ptr(const uint8_t* data,
+                                          const uint8_t* data_end,
+                                          const std::vector<compressed_csr_block_index>& index,
+                                          const compressed_csr_header& header,
+                                          const compressed_csr_task& task,
+                                          int64_t row_start,
+                                          int64_t row_end,
+                                          int64_t* output)
+{
+  for (int64_t b = task.block_begin; b < task.block_end; b++) {
+    int64_t block_row_end = std::min<int64_t>((b + 1) * header.rows_per_block, header.node_count);
+    int64_t offset        = index[b].edge_offset;
+    for (int64_t row = b * header.rows_per_block; row < block_row_end; row++) {
+      if (row >= row_start && row < row_end) output[row - row_start] = offset;
+      offset += static_cast<int64_t>(decode_varint(data, data_end));
+    }
+    if (offset != index[b + 1].edge_offset) {
+      WHOLEMEMORY_FAIL("compressed CSR block %ld degree sum mismatch with its index.", b);
+    }
+  }
+}
 
-    WHOLEMEMORY_INFO("Rank=%d done writing to file %s.", wm_rank, local_file_name);
+/**
+ * Decode col_ind of edges [edge_start, edge_end) which should be inside the task blocks.
+ */
+template <typename IndexT>
+static void decode_compressed_csr_col_ind(const uint8_t* data,
+                                          const uint8_t* data_end,
+                                          const std::vector<compressed_csr_block_index>& index,
+                                          const compressed_csr_task& task,
+                                          int64_t edge_start,
+                                          int64_t edge_end,
+                                          IndexT* output)
+{
+  for (int64_t b = task.block_begin; b < task.block_end; b++) {
+    int64_t node_id = 0;
+    for (int64_t edge = index[b].edge_offset; edge < index[b + 1].edge_offset; edge++) {
+      if (edge >= edge_end) return;
+      uint64_t zigzag = decode_varint(data, data_end);
+      node_id += static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+      if (edge >= edge_start) output[edge - edge_start] = static_cast<IndexT>(node_id);
+    }
+  }
+}
 
-    wm_comm->barrier();
+// decodes the rows and edges owned by this rank, without any collective.
+static wholememory_error_code_t decode_compressed_csr_to_local_memory(
+  wholememory_handle_t csr_row_ptr_handle,
+  wholememory_handle_t csr_col_ind_handle,
+  wholememory_dtype_t csr_col_ind_dtype,
+  const char* file_name) noexcept
+{
+  int fd = open(file_name, O_RDONLY);
+  if (fd < 0) {
+    WHOLEMEMORY_ERROR("Open compressed CSR file %s failed, error=%s", file_name, strerror(errno));
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  size_t col_ind_element_size = wholememory_dtype_get_element_size(csr_col_ind_dtype);
+  try {
+    compressed_csr_header header;
+    std::vector<compressed_csr_block_index> index;
+    if (!read_compressed_csr_index(fd, file_name, &header, &index)) {
+      close(fd);
+      WHOLEMEMORY_ERROR("File %s is not a valid compressed CSR file.", file_name);
+      return WHOLEMEMORY_INVALID_VALUE;
+    }
+    if (wholememory_get_total_size(csr_row_ptr_handle) !=
+          (header.node_count + 1) * sizeof(int64_t) ||
+        wholememory_get_total_size(csr_col_ind_handle) !=
+          header.edge_count * col_ind_element_size) {
+      close(fd);
+      WHOLEMEMORY_ERROR("Compressed CSR file %s has %ld nodes and %ld edges, handle size mismatch.",
+                        file_name,
+                        header.node_count,
+                        header.edge_count);
+      return WHOLEMEMORY_INVALID_VALUE;
+    }
+
+    wholememory_comm_t wm_comm;
+    WHOLEMEMORY_CHECK(wholememory_get_communicator(&wm_comm, csr_row_ptr_handle) ==
+                      WHOLEMEMORY_SUCCESS);
+    int wm_rank;
+    WHOLEMEMORY_CHECK(wholememory_communicator_get_rank(&wm_rank, wm_comm) == WHOLEMEMORY_SUCCESS);
 
+    char *row_ptr_local, *col_ind_local;
+    size_t row_ptr_local_size, row_ptr_local_offset, col_ind_local_size, col_ind_local_offset;
+    WHOLEMEMORY_CHECK(wholememory_get_local_memory((void**)(&row_ptr_local),
+                                                   &row_ptr_local_size,
+                                                   &row_ptr_local_offset,
+                                                   csr_row_ptr_handle) == WHOLEMEMORY_SUCCESS);
+    WHOLEMEMORY_CHECK(wholememory_get_local_memory((void**)(&col_ind_local),
+                                                   &col_ind_local_size,
+                                                   &col_ind_local_offset,
+                                                   csr_col_ind_handle) == WHOLEMEMORY_SUCCESS);
+    int64_t row_start  = row_ptr_local_offset / sizeof(int64_t);
+    int64_t row_end    = row_start + row_ptr_local_size / sizeof(int64_t);
+    int64_t edge_start = col_ind_local_offset / col_ind_element_size;
+    int64_t edge_end   = edge_start + col_ind_local_size / col_ind_element_size;
+
+    std::vector<compressed_csr_task> tasks;
+    int64_t decode_row_end = std::min(row_end, header.node_count);
+    if (row_start < decode_row_end) {
+      append_compressed_csr_tasks(index,
+                                  header.rows_per_block,
+                                  false,
+                                  row_start / header.rows_per_block,
+                                  div_rounding_up_safe<int64_t>(decode_row_end,
+                                                                header.rows_per_block),
+                                  &tasks);
+    }
+    if (edge_start < edge_end) {
+      // blocks whose edge range [index[b].edge_offset, index[b + 1].edge_offset) overlaps.
+      auto edge_less = [](int64_t edge, const compressed_csr_block_index& block_index) {
+        return edge < block_index.edge_offset;
+      };
+      int64_t block_begin =
+        std::upper_bound(index.begin() + 1, index.end(), edge_start, edge_less) - index.begin() -
+        1;
+      int64_t block_end =
+        std::upper_bound(index.begin(), index.end() - 1, edge_end - 1, edge_less) - index.begin();
+      append_compressed_csr_tasks(
+        index, header.rows_per_block, true, block_begin, block_end, &tasks);
+    }
+
+    bool row_ptr_on_device =
+      wholememory_get_memory_location(csr_row_ptr_handle) == WHOLEMEMORY_ML_DEVICE;
+    bool col_ind_on_device =
+      wholememory_get_memory_location(csr_col_ind_handle) == WHOLEMEMORY_ML_DEVICE;
+    // decoding is CPU bound, so use all cores of this rank if not configured.
+    int thread_count = get_load_thread_count();
+    if (std::getenv("WHOLEMEMORY_LOAD_THREAD_COUNT") == nullptr) {
+      thread_count = std::max(1, GetProcessorCount() / std::max(1, wm_comm->intra_node_rank_num));
+    }
+    thread_count = std::max(1, std::min<int>(thread_count, tasks.size()));
+    size_t total_read_bytes = 0;
+    for (auto& task : tasks) {
+      total_read_bytes += task.is_col_ind ? index[task.block_end].neighbor_offset -
+                                              index[task.block_begin].neighbor_offset
+                                          : index[task.block_end].degree_offset -
+                                              index[task.block_begin].degree_offset;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    std::atomic<size_t> next_task(0);
+    std::mutex error_mu;
+    std::string error_msg;
+    MultiThreadRun(thread_count, [&](int, int) {
+      std::vector<uint8_t> file_buffer;
+      std::vector<char> staging_buffer;
+      try {
+        if (row_ptr_on_device || col_ind_on_device) WM_CUDA_CHECK(cudaSetDevice(wm_comm->dev_id));
+        while (true) {
+          {
+            std::unique_lock<std::mutex> lock(error_mu);
+            if (!error_msg.empty()) break;
+          }
+          size_t task_idx = next_task.fetch_add(1);
+          if (task_idx >= tasks.size()) break;
+          auto& task           = tasks[task_idx];
+          int64_t begin_offset = task.is_col_ind ? index[task.block_begin].neighbor_offset
+                                                 : index[task.block_begin].degree_offset;
+          int64_t end_offset   = task.is_col_ind ? index[task.block_end].neighbor_offset
+                                                 : index[task.block_end].degree_offset;
+          file_buffer.resize(end_offset - begin_offset);
+          pread_fully(fd,
+                      reinterpret_cast<char*>(file_buffer.data()),
+                      file_buffer.size(),
+                      begin_offset,
+                      file_name);
+          const uint8_t* data     = file_buffer.data();
+          const uint8_t* data_end = data + file_buffer.size();
+          int64_t local_start     = task.is_col_ind ? edge_start : row_start;
+          int64_t write_start, write_end;
+          size_t element_size;
+          char* local_base;
+          bool on_device;
+          if (task.is_col_ind) {
+            write_start  = std::max(edge_start, index[task.block_begin].edge_offset);
+            write_end    = std::min(edge_end, index[task.block_end].edge_offset);
+            element_size = col_ind_element_size;
+            local_base   = col_ind_local;
+            on_device    = col_ind_on_device;
+          } else {
+            write_start  = std::max(row_start, task.block_begin * header.rows_per_block);
+            write_end    = std::min(decode_row_end, task.block_end * header.rows_per_block);
+            element_size = sizeof(int64_t);
+            local_base   = row_ptr_local;
+            on_device    = row_ptr_on_device;
+          }
+          if (write_end <= write_start) continue;
+          char* local_write_ptr = local_base + (write_start - local_start) * element_size;
+          size_t write_size     = (write_end - write_start) * element_size;
+          // host memory is decoded into directly, device memory through a staging buffer.
+          char* output = local_write_ptr;
+          if (on_device) {
+            staging_buffer.resize(write_size);
+            output = staging_buffer.data();
+          }
+          if (!task.is_col_ind) {
+            decode_compressed_csr_row_ptr(data,
+                                          data_end,
+                                          index,
+                                          header,
+                                          task,
+                                          write_start,
+                                          write_end,
+                                          reinterpret_cast<int64_t*>(output));
+          } else if (csr_col_ind_dtype == WHOLEMEMORY_DT_INT) {
+            decode_compressed_csr_col_ind(
+              data, data_end, index, task, write_start, write_end, reinterpret_cast<int*>(output));
+          } else {
+            decode_compressed_csr_col_ind(data,
+                                          data_end,
+                                          index,
+                                          task,
+                                          write_start,
+                                          write_end,
+                                          reinterpret_cast<int64_t*>(output));
+          }
+          if (on_device) {
+            WM_CUDA_CHECK(
+              cudaMemcpy(local_write_ptr, output, write_size, cudaMemcpyHostToDevice));
+          }
+        }
+      } catch (std::exception& e) {
+        std::unique_lock<std::mutex> lock(error_mu);
+        if (error_msg.empty()) error_msg = e.what();
+      }
+    });
+    if (!error_msg.empty()) {
+      WHOLEMEMORY_FAIL("Decoding compressed CSR file %s failed: %s", file_name, error_msg.c_str());
+    }
+    // last row_ptr entry is not in any block.
+    if (header.node_count >= row_start && header.node_count < row_end) {
+      char* last_row_ptr = row_ptr_local + (header.node_count - row_start) * sizeof(int64_t);
+      if (row_ptr_on_device) {
+        WM_CUDA_CHECK(cudaMemcpy(
+          last_row_ptr, &header.edge_count, sizeof(int64_t), cudaMemcpyHostToDevice));
+      } else {
+        memcpy(last_row_ptr, &header.edge_count, sizeof(int64_t));
+      }
+    }
+    double elapsed_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    WHOLEMEMORY_INFO(
+      "Rank=%d done decoding %ld compressed bytes from %s with %d thread(s) in %.3f seconds.",
+      wm_rank,
+      total_read_bytes,
+      file_name,
+      thread_count,
+      elapsed_seconds);
+    close(fd);
+    fd = -1;
   } catch (wholememory::logic_error& wle) {
+    if (fd >= 0) close(fd);
     WHOLEMEMORY_ERROR("Logic error: %s", wle.what());
     return WHOLEMEMORY_LOGIC_ERROR;
   } catch (wholememory::cuda_error& wce) {
+    if (fd >= 0) close(fd);
     WHOLEMEMORY_ERROR("CUDA error: %s", wce.what());
     return WHOLEMEMORY_CUDA_ERROR;
   } catch (...) {
+    if (fd >= 0) close(fd);
     WHOLEMEMORY_ERROR("Unknow error caught at file %s, line %d", __FILE__, __LINE__);
     return WHOLEMEMORY_UNKNOW_ERROR;
   }
+  return WHOLEMEMORY_SUCCESS;
+}
 
+wholememory_error_code_t load_compressed_csr_to_handles(
+  wholememory_handle_t csr_row_ptr_handle,
+  wholememory_handle_t csr_col_ind_handle,
+  wholememory_dtype_t csr_col_ind_dtype,
+  const char* file_name) noexcept
+{
+  if (csr_row_ptr_handle == nullptr || csr_col_ind_handle == nullptr || file_name == nullptr ||
+      (csr_col_ind_dtype != WHOLEMEMORY_DT_INT && csr_col_ind_dtype != WHOLEMEMORY_DT_INT64)) {
+    WHOLEMEMORY_ERROR("Invalid input, col_ind dtype should be int or int64.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (!is_writable(csr_row_ptr_handle) || !is_writable(csr_col_ind_handle)) {
+    WHOLEMEMORY_ERROR("CSR handles are read only, map files with write back to load.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  wholememory_comm_t wm_comm;
+  WHOLEMEMORY_RETURN_ON_FAIL(wholememory_get_communicator(&wm_comm, csr_row_ptr_handle));
+  auto error_code = decode_compressed_csr_to_local_memory(
+    csr_row_ptr_handle, csr_col_ind_handle, csr_col_ind_dtype, file_name);
+  // decoding may fail on any rank, all ranks agree on the result so none waits for the others.
+  int failed_count       = error_code != WHOLEMEMORY_SUCCESS ? 1 : 0;
+  int total_failed_count = 0;
+  try {
+    wm_comm->host_allreduce(&failed_count, &total_failed_count, 1, WHOLEMEMORY_DT_INT, ncclSum);
+  } catch (...) {
+    WHOLEMEMORY_ERROR("Loading compressed CSR reduce failed status failed.");
+    total_failed_count = 1;
+    if (error_code == WHOLEMEMORY_SUCCESS) error_code = WHOLEMEMORY_COMMUNICATION_ERROR;
+  }
+  if (total_failed_count != 0) {
+    WHOLEMEMORY_ERROR(
+      "Loading compressed CSR file %s failed on %d ranks.", file_name, total_failed_count);
+    return error_code != WHOLEMEMORY_SUCCESS ? error_code : WHOLEMEMORY_LOGIC_ERROR;
+  }
   return WHOLEMEMORY_SUCCESS;
 }
 
@@ -15,21 +15,53 @@
  */
 #pragma once
 
+#include <wholememory/tensor_description.h>
 #include <wholememory/wholememory.h>
 
 namespace wholememory {
 
-wholememory_error_code_t load_file_to_handle(wholememory_handle_t wholememory_handle,
-                                             size_t memory_offset,
-                                             size_t memory_entry_stride,
-                                             size_t entry_size,
-                                             const char** file_names,
-                                             int file_count) noexcept;
+/**
+ * Conversion applied to each file entry while loading, columns
+ * [column_start, column_start + column_count) of file_dtype are converted to memory_dtype.
+ */
+struct file_entry_conversion {
+  wholememory_dtype_t file_dtype   = WHOLEMEMORY_DT_UNKNOWN;
+  wholememory_dtype_t memory_dtype = WHOLEMEMORY_DT_UNKNOWN;
+  size_t column_start              = 0;
+  size_t column_count              = 0;
+};
+
+wholememory_error_code_t load_file_to_handle(
+  wholememory_handle_t wholememory_handle,
+  size_t memory_offset,
+  size_t memory_entry_stride,
+  size_t entry_size,
+  const char** file_names,
+  int file_count,
+  const file_entry_conversion* conversion = nullptr) noexcept;
 
 wholememory_error_code_t store_handle_to_file(wholememory_handle_t wholememory_handle,
                                               size_t memory_offset,
                                               size_t memory_entry_stride,
                                               size_t entry_size,
-                                              const char* local_file_name) noexcept;
+                                              const char* local_file_name,
+                                              uint32_t* checksum = nullptr) noexcept;
+
+wholememory_error_code_t store_tensor_to_checkpoint(
+  wholememory_handle_t wholememory_handle,
+  const wholememory_tensor_description_t* tensor_description,
+  const char* file_prefix) noexcept;
+
+wholememory_error_code_t load_tensor_from_checkpoint(
+  wholememory_handle_t wholememory_handle,
+  const wholememory_tensor_description_t* tensor_description,
+  const char* file_prefix,
+  bool verify_checksum) noexcept;
+
+wholememory_error_code_t load_compressed_csr_to_handles(
+  wholememory_handle_t csr_row_ptr_handle,
+  wholememory_handle_t csr_col_ind_handle,
+  wholememory_dtype_t csr_col_ind_dtype,
+  const char* file_name) noexcept;
 
 }  // namespace wholememory
@@ -0,0 +1,579 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "wholememory/host_comms.hpp"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <random>
+
+#include "error.hpp"
+#include "logger.hpp"
+#include "wholememory/host_reduce.hpp"
+
+namespace wholememory {
+
+static constexpr char kHostUniqueIdMagic[8] = {'W', 'M', 'H', 'O', 'S', 'T', 'I', 'D'};
+
+struct host_unique_id {
+  char magic[8];
+  uint32_t ip_addr;  // network byte order
+  uint16_t port;     // network byte order
+  uint16_t reserved;
+  uint64_t nonce;
+};
+
+static_assert(sizeof(host_unique_id) <= sizeof(wholememory_unique_id_t),
+              "host_unique_id should fit in wholememory_unique_id_t");
+
+struct host_comm_hello {
+  uint64_t nonce;
+  int32_t rank;
+  int32_t size;
+  uint32_t ip_addr;  // network byte order
+  uint16_t port;     // network byte order
+  uint16_t reserved;
+};
+
+struct host_comm_address {
+  uint32_t ip_addr;  // network byte order
+  uint16_t port;     // network byte order
+  uint16_t reserved;
+};
+
+// listen sockets created by create_unique_id, used by a rank in the same process to collect and
+// publish listen addresses of all ranks.
+static std::mutex root_listen_mu;
+static std::map<uint64_t, int> root_listen_fds;
+
+static int take_root_listen_fd(uint64_t nonce)
+{
+  std::unique_lock<std::mutex> lock(root_listen_mu);
+  auto it = root_listen_fds.find(nonce);
+  if (it == root_listen_fds.end()) return -1;
+  int listen_fd = it->second;
+  root_listen_fds.erase(it);
+  return listen_fd;
+}
+
+static uint32_t get_local_ip_address()
+{
+  const char* ifname = getenv("WHOLEMEMORY_HOST_COMM_IFNAME");
+  uint32_t ip_addr   = htonl(INADDR_LOOPBACK);
+  bool found         = false;
+  ifaddrs* ifaddr    = nullptr;
+  WHOLEMEMORY_CHECK(getifaddrs(&ifaddr) == 0);
+  for (ifaddrs* ifa = ifaddr; ifa != nullptr; ifa = ifa->ifa_next) {
+    if (ifa->ifa_addr == nullptr || ifa->ifa_addr->sa_family != AF_INET) continue;
+    if ((ifa->ifa_flags & IFF_UP) == 0) continue;
+    if (ifname != nullptr ? std::strcmp(ifa->ifa_name, ifname) != 0
+                          : (ifa->ifa_flags & IFF_LOOPBACK) != 0) {
+      continue;
+    }
+    ip_addr = reinterpret_cast<sockaddr_in*>(ifa->ifa_addr)->sin_addr.s_addr;
+    found   = true;
+    break;
+  }
+  freeifaddrs(ifaddr);
+  if (ifname != nullptr && !found) {
+    WHOLEMEMORY_FAIL("WHOLEMEMORY_HOST_COMM_IFNAME=%s has no IPv4 address.", ifname);
+  }
+  return ip_addr;
+}
+
+static int create_listen_fd(uint16_t port, int backlog, uint16_t* listen_port)
+{
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  WHOLEMEMORY_CHECK(listen_fd >= 0);
+  int enable = 1;
+  WHOLEMEMORY_CHECK(setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int)) == 0);
+  sockaddr_in addr{};
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = port;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    int bind_errno = errno;
+    close(listen_fd);
+    WHOLEMEMORY_FAIL("bind port %d failed, Reason=%s", (int)ntohs(port), strerror(bind_errno));
+  }
+  WHOLEMEMORY_CHECK(listen(listen_fd, backlog) == 0);
+  socklen_t addr_len = sizeof(addr);
+  WHOLEMEMORY_CHECK(getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len) == 0);
+  *listen_port = addr.sin_port;
+  return listen_fd;
+}
+
+static int connect_to(uint32_t ip_addr, uint16_t port)
+{
+  sockaddr_in addr{};
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = port;
+  addr.sin_addr.s_addr = ip_addr;
+  while (true) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    WHOLEMEMORY_CHECK(fd >= 0);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+    int connect_errno = errno;
+    close(fd);
+    if (connect_errno != ECONNREFUSED && connect_errno != ETIMEDOUT &&
+        connect_errno != ENETUNREACH && connect_errno != EINTR) {
+      char ip_str[INET_ADDRSTRLEN];
+      inet_ntop(AF_INET, &addr.sin_addr, ip_str, sizeof(ip_str));
+      WHOLEMEMORY_FAIL(
+        "connect to %s:%d failed, Reason=%s", ip_str, (int)ntohs(port), strerror(connect_errno));
+    }
+    // peer may not be listening yet.
+    usleep(10 * 1000);
+  }
+}
+
+static int accept_from(int listen_fd)
+{
+  while (true) {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd >= 0) return fd;
+    if (errno != EINTR && errno != ECONNABORTED) {
+      WHOLEMEMORY_FAIL("accept failed, Reason=%s", strerror(errno));
+    }
+  }
+}
+
+static void blocking_send(int fd, const void* data, size_t size)
+{
+  const char* ptr = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t ret = send(fd, ptr, size, MSG_NOSIGNAL);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) WHOLEMEMORY_FAIL("send failed, Reason=%s", strerror(errno));
+    ptr += ret;
+    size -= ret;
+  }
+}
+
+static void blocking_recv(int fd, void* data, size_t size)
+{
+  char* ptr = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t ret = recv(fd, ptr, size, 0);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret == 0) WHOLEMEMORY_FAIL("recv failed, connection closed by peer.");
+    if (ret < 0) WHOLEMEMORY_FAIL("recv failed, Reason=%s", strerror(errno));
+    ptr += ret;
+    size -= ret;
+  }
+}
+
+static uint64_t generate_nonce()
+{
+  std::random_device rd;
+  uint64_t nonce = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+  nonce ^= static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+  nonce ^= static_cast<uint64_t>(getpid()) << 16;
+  return nonce;
+}
+
+void host_comms::create_unique_id(wholememory_unique_id_t* unique_id)
+{
+  host_unique_id id{};
+  std::memcpy(id.magic, kHostUniqueIdMagic, sizeof(kHostUniqueIdMagic));
+  id.ip_addr    = get_local_ip_address();
+  id.nonce      = generate_nonce();
+  int listen_fd = create_listen_fd(0, SOMAXCONN, &id.port);
+  {
+    std::unique_lock<std::mutex> lock(root_listen_mu);
+    root_listen_fds.emplace(id.nonce, listen_fd);
+  }
+  std::memset(unique_id->internal, 0, sizeof(unique_id->internal));
+  std::memcpy(unique_id->internal, &id, sizeof(host_unique_id));
+}
+
+void host_comms::release_unused_unique_ids()
+{
+  std::unique_lock<std::mutex> lock(root_listen_mu);
+  for (auto& nonce_fd : root_listen_fds) {
+    close(nonce_fd.second);
+  }
+  root_listen_fds.clear();
+}
+
+bool host_comms::is_host_unique_id(const wholememory_unique_id_t& unique_id)
+{
+  return std::memcmp(unique_id.internal, kHostUniqueIdMagic, sizeof(kHostUniqueIdMagic)) == 0;
+}
+
+host_comms::host_comms(const wholememory_unique_id_t& unique_id, int num_ranks, int rank)
+  : num_ranks_(num_ranks), rank_(rank), peer_fds_(num_ranks, -1)
+{
+  WHOLEMEMORY_CHECK(is_host_unique_id(unique_id));
+  WHOLEMEMORY_CHECK(rank >= 0 && rank < num_ranks);
+  host_unique_id id;
+  std::memcpy(&id, unique_id.internal, sizeof(host_unique_id));
+
+  std::vector<host_comm_address> addresses(num_ranks);
+  host_comm_hello hello{};
+  hello.nonce   = id.nonce;
+  hello.rank    = rank;
+  hello.size    = num_ranks;
+  hello.ip_addr = get_local_ip_address();
+  int listen_fd = create_listen_fd(0, SOMAXCONN, &hello.port);
+  // every rank sends its own listen address to the process that created unique id, which still
+  // holds the unique id port, so no rank needs to bind that port again.
+  int rendezvous_fd = take_root_listen_fd(id.nonce);
+  if (rendezvous_fd >= 0) {
+    std::vector<int> rendezvous_peer_fds(num_ranks, -1);
+    addresses[rank].ip_addr = hello.ip_addr;
+    addresses[rank].port    = hello.port;
+    for (int i = 1; i < num_ranks; i++) {
+      int fd = accept_from(rendezvous_fd);
+      host_comm_hello peer_hello;
+      blocking_recv(fd, &peer_hello, sizeof(peer_hello));
+      WHOLEMEMORY_EXPECTS(peer_hello.nonce == id.nonce && peer_hello.size == num_ranks,
+                          "host communicator got connection with different unique id or size.");
+      WHOLEMEMORY_CHECK(peer_hello.rank >= 0 && peer_hello.rank < num_ranks &&
+                        peer_hello.rank != rank);
+      WHOLEMEMORY_CHECK(rendezvous_peer_fds[peer_hello.rank] == -1);
+      rendezvous_peer_fds[peer_hello.rank] = fd;
+      addresses[peer_hello.rank].ip_addr   = peer_hello.ip_addr;
+      addresses[peer_hello.rank].port      = peer_hello.port;
+    }
+    for (int r = 0; r < num_ranks; r++) {
+      if (r == rank) continue;
+      blocking_send(
+        rendezvous_peer_fds[r], addresses.data(), sizeof(host_comm_address) * num_ranks);
+      WHOLEMEMORY_CHECK(close(rendezvous_peer_fds[r]) == 0);
+    }
+    WHOLEMEMORY_CHECK(close(rendezvous_fd) == 0);
+  } else {
+    int fd = connect_to(id.ip_addr, id.port);
+    blocking_send(fd, &hello, sizeof(hello));
+    blocking_recv(fd, addresses.data(), sizeof(host_comm_address) * num_ranks);
+    WHOLEMEMORY_CHECK(close(fd) == 0);
+  }
+  // connect to lower ranks and accept from higher ranks, connect completes before accept.
+  for (int r = 0; r < rank; r++) {
+    peer_fds_[r] = connect_to(addresses[r].ip_addr, addresses[r].port);
+    blocking_send(peer_fds_[r], &hello, sizeof(hello));
+  }
+  for (int i = rank + 1; i < num_ranks; i++) {
+    int fd = accept_from(listen_fd);
+    host_comm_hello peer_hello;
+    blocking_recv(fd, &peer_hello, sizeof(peer_hello));
+    WHOLEMEMORY_EXPECTS(peer_hello.nonce == id.nonce && peer_hello.size == num_ranks,
+                        "host communicator got connection with different unique id or size.");
+    WHOLEMEMORY_CHECK(peer_hello.rank > rank && peer_hello.rank < num_ranks);
+    WHOLEMEMORY_CHECK(peer_fds_[peer_hello.rank] == -1);
+    peer_fds_[peer_hello.rank] = fd;
+  }
+  WHOLEMEMORY_CHECK(close(listen_fd) == 0);
+
+  for (int r = 0; r < num_ranks; r++) {
+    if (r == rank) continue;
+    int enable = 1;
+    WHOLEMEMORY_CHECK(setsockopt(peer_fds_[r], IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(int)) ==
+                      0);
+    int flags = fcntl(peer_fds_[r], F_GETFL, 0);
+    WHOLEMEMORY_CHECK(flags != -1 && fcntl(peer_fds_[r], F_SETFL, flags | O_NONBLOCK) == 0);
+  }
+  WHOLEMEMORY_INFO("Rank=%d connected to %d ranks by host communicator.", rank, num_ranks);
+}
+
+host_comms::~host_comms()
+{
+  for (auto& fd : peer_fds_) {
+    if (fd >= 0) close(fd);
+    fd = -1;
+  }
+}
+
+void host_comms::exchange(std::vector<peer_transfer>& sends,
+                          std::vector<peer_transfer>& recvs) const
+{
+  std::vector<int> send_index(num_ranks_, -1), recv_index(num_ranks_, -1);
+  for (int i = 0; i < static_cast<int>(sends.size()); i++) {
+    if (sends[i].size > 0) send_index[sends[i].peer] = i;
+  }
+  for (int i = 0; i < static_cast<int>(recvs.size()); i++) {
+    if (recvs[i].size > 0) recv_index[recvs[i].peer] = i;
+  }
+  if (send_index[rank_] >= 0 || recv_index[rank_] >= 0) {
+    WHOLEMEMORY_CHECK(send_index[rank_] >= 0 && recv_index[rank_] >= 0);
+    auto& self_send = sends[send_index[rank_]];
+    auto& self_recv = recvs[recv_index[rank_]];
+    WHOLEMEMORY_CHECK(self_send.size == self_recv.size);
+    if (self_send.ptr != self_recv.ptr) std::memmove(self_recv.ptr, self_send.ptr, self_send.size);
+    send_index[rank_] = recv_index[rank_] = -1;
+  }
+
+  std::vector<pollfd> poll_fds;
+  std::vector<int> poll_peers;
+  while (true) {
+    poll_fds.clear();
+    poll_peers.clear();
+    for (int r = 0; r < num_ranks_; r++) {
+      short events = 0;
+      if (send_index[r] >= 0) events |= POLLOUT;
+      if (recv_index[r] >= 0) events |= POLLIN;
+      if (events == 0) continue;
+      poll_fds.push_back(pollfd{peer_fds_[r], events, 0});
+      poll_peers.push_back(r);
+    }
+    if (poll_fds.empty()) break;
+    int ret = poll(poll_fds.data(), poll_fds.size(), -1);
+    if (ret < 0 && errno == EINTR) continue;
+    WHOLEMEMORY_CHECK(ret > 0);
+    for (size_t i = 0; i < poll_fds.size(); i++) {
+      int r           = poll_peers[i];
+      short revents   = poll_fds[i].revents;
+      bool has_errors = (revents & (POLLERR | POLLNVAL)) != 0;
+      if (recv_index[r] >= 0 && (revents & (POLLIN | POLLHUP)) != 0) {
+        auto& transfer = recvs[recv_index[r]];
+        ssize_t bytes  = recv(peer_fds_[r], transfer.ptr, transfer.size, 0);
+        if (bytes == 0) {
+          WHOLEMEMORY_FAIL("host communicator rank=%d connection closed by rank=%d", rank_, r);
+        }
+        if (bytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+          WHOLEMEMORY_FAIL("host communicator rank=%d recv from rank=%d failed, Reason=%s",
+                           rank_,
+                           r,
+                           strerror(errno));
+        }
+        if (bytes > 0) {
+          transfer.ptr += bytes;
+          transfer.size -= bytes;
+          if (transfer.size == 0) recv_index[r] = -1;
+        }
+      }
+      if (send_index[r] >= 0 && ((revents & POLLOUT) != 0 || has_errors)) {
+        auto& transfer = sends[send_index[r]];
+        ssize_t bytes  = send(peer_fds_[r], transfer.ptr, transfer.size, MSG_NOSIGNAL);
+        if (bytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+          WHOLEMEMORY_FAIL("host communicator rank=%d send to rank=%d failed, Reason=%s",
+                           rank_,
+                           r,
+                           strerror(errno));
+        }
+        if (bytes > 0) {
+          transfer.ptr += bytes;
+          transfer.size -= bytes;
+          if (transfer.size == 0) send_index[r] = -1;
+        }
+      }
+    }
+  }
+}
+
+void host_comms::reduce_scatter_blocks(const void* sendbuff,
+                                       void* recvbuff,
+                                       const std::vector<size_t>& displs,
+                                       ncclDataType_t datatype,
+                                       ncclRedOp_t op) const
+{
+  const size_t datatype_size = get_host_datatype_size(datatype);
+  const size_t block_count   = displs[rank_ + 1] - displs[rank_];
+  std::vector<char> rank_blocks(block_count * num_ranks_ * datatype_size);
+  char* send_ptr = const_cast<char*>(static_cast<const char*>(sendbuff));
+  std::vector<peer_transfer> sends(num_ranks_), recvs(num_ranks_);
+  for (int r = 0; r < num_ranks_; r++) {
+    sends[r].peer = r;
+    sends[r].ptr  = send_ptr + displs[r] * datatype_size;
+    sends[r].size = (displs[r + 1] - displs[r]) * datatype_size;
+    recvs[r].peer = r;
+    recvs[r].ptr  = rank_blocks.data() + r * block_count * datatype_size;
+    recvs[r].size = block_count * datatype_size;
+  }
+  exchange(sends, recvs);
+  if (block_count > 0) {
+    host_reduce_ranks(
+      rank_blocks.data(), block_count, recvbuff, block_count, num_ranks_, datatype, op);
+  }
+}
+
+static std::vector<size_t> get_block_displs(size_t count, int num_ranks)
+{
+  std::vector<size_t> displs(num_ranks + 1);
+  for (int r = 0; r <= num_ranks; r++) {
+    displs[r] = count * r / num_ranks;
+  }
+  return displs;
+}
+
+void host_comms::barrier() const
+{
+  char send_data = 0;
+  std::vector<char> recv_data(num_ranks_);
+  host_allgather(&send_data, recv_data.data(), 1, ncclInt8);
+}
+
+void host_comms::host_allreduce(
+  const void* sendbuff, void* recvbuff, size_t count, ncclDataType_t datatype, ncclRedOp_t op) const
+{
+  const size_t datatype_size = get_host_datatype_size(datatype);
+  auto displs                = get_block_displs(count, num_ranks_);
+  char* block_ptr            = static_cast<char*>(recvbuff) + displs[rank_] * datatype_size;
+  reduce_scatter_blocks(sendbuff, block_ptr, displs, datatype, op);
+  std::vector<size_t> recvcounts(num_ranks_);
+  for (int r = 0; r < num_ranks_; r++) {
+    recvcounts[r] = displs[r + 1] - displs[r];
+  }
+  host_allgatherv(block_ptr, recvbuff, recvcounts.data(), displs.data(), datatype);
+}
+
+void host_comms::host_bcast(
+  const void* sendbuff, void* recvbuff, size_t count, ncclDataType_t datatype, int root) const
+{
+  const size_t size = count * get_host_datatype_size(datatype);
+  std::vector<peer_transfer> sends, recvs;
+  if (rank_ == root) {
+    for (int r = 0; r < num_ranks_; r++) {
+      sends.push_back({r, const_cast<char*>(static_cast<const char*>(sendbuff)), size});
+    }
+    recvs.push_back({root, static_cast<char*>(recvbuff), size});
+  } else {
+    recvs.push_back({root, static_cast<char*>(recvbuff), size});
+  }
+  exchange(sends, recvs);
+}
+
+void host_comms::host_bcast(void* buff, size_t count, ncclDataType_t datatype, int root) const
+{
+  host_bcast(buff, buff, count, datatype, root);
+}
+
+void host_comms::host_reduce(const void* sendbuff,
+                             void* recvbuff,
+                             size_t count,
+                             ncclDataType_t datatype,
+                             ncclRedOp_t op,
+                             int root) const
+{
+  const size_t datatype_size = get_host_datatype_size(datatype);
+  auto displs                = get_block_displs(count, num_ranks_);
+  const size_t block_size    = (displs[rank_ + 1] - displs[rank_]) * datatype_size;
+  std::vector<char> reduced_block;
+  char* block_ptr = nullptr;
+  if (rank_ == root) {
+    block_ptr = static_cast<char*>(recvbuff) + displs[rank_] * datatype_size;
+  } else {
+    reduced_block.resize(block_size);
+    block_ptr = reduced_block.data();
+  }
+  reduce_scatter_blocks(sendbuff, block_ptr, displs, datatype, op);
+  std::vector<peer_transfer> sends, recvs;
+  if (rank_ == root) {
+    for (int r = 0; r < num_ranks_; r++) {
+      if (r == root) continue;
+      recvs.push_back({r,
+                       static_cast<char*>(recvbuff) + displs[r] * datatype_size,
+                       (displs[r + 1] - displs[r]) * datatype_size});
+    }
+  } else {
+    sends.push_back({root, block_ptr, block_size});
+  }
+  exchange(sends, recvs);
+}
+
+void host_comms::host_allgather(const void* sendbuff,
+                                void* recvbuff,
+                                size_t sendcount,
+                                ncclDataType_t datatype) const
+{
+  std::vector<size_t> recvcounts(num_ranks_, sendcount), displs(num_ranks_);
+  for (int r = 0; r < num_ranks_; r++) {
+    displs[r] = r * sendcount;
+  }
+  host_allgatherv(sendbuff, recvbuff, recvcounts.data(), displs.data(), datatype);
+}
+
+void host_comms::host_allgatherv(const void* sendbuf,
+                                 void* recvbuf,
+                                 const size_t* recvcounts,
+                                 const size_t* displs,
+                                 ncclDataType_t datatype) const
+{
+  const size_t datatype_size = get_host_datatype_size(datatype);
+  const size_t send_size     = recvcounts[rank_] * datatype_size;
+  std::vector<peer_transfer> sends(num_ranks_), recvs(num_ranks_);
+  for (int r = 0; r < num_ranks_; r++) {
+    sends[r] = {r, const_cast<char*>(static_cast<const char*>(sendbuf)), send_size};
+    recvs[r] = {r, static_cast<char*>(recvbuf) + displs[r] * datatype_size,
+                recvcounts[r] * datatype_size};
+  }
+  exchange(sends, recvs);
+}
+
+void host_comms::host_gather(const void* sendbuff,
+                             void* recvbuff,
+                             size_t sendcount,
+                             ncclDataType_t datatype,
+                             int root) const
+{
+  const size_t size = sendcount * get_host_datatype_size(datatype);
+  std::vector<peer_transfer> sends, recvs;
+  sends.push_back({root, const_cast<char*>(static_cast<const char*>(sendbuff)), size});
+  if (rank_ == root) {
+    for (int r = 0; r < num_ranks_; r++) {
+      recvs.push_back({r, static_cast<char*>(recvbuff) + r * size, size});
+    }
+  }
+  exchange(sends, recvs);
+}
+
+void host_comms::host_alltoall(const void* sendbuff,
+                               void* recvbuff,
+                               size_t sendcount,
+                               ncclDataType_t datatype) const
+{
+  std::vector<size_t> counts(num_ranks_, sendcount), displs(num_ranks_);
+  for (int r = 0; r < num_ranks_; r++) {
+    displs[r] = r * sendcount;
+  }
+  host_alltoallv(
+    sendbuff, recvbuff, counts.data(), displs.data(), counts.data(), displs.data(), datatype);
+}
+
+void host_comms::host_alltoallv(const void* sendbuff,
+                                void* recvbuff,
+                                const size_t* sendcounts,
+                                const size_t* senddispls,
+                                const size_t* recvcounts,
+                                const size_t* recvdispls,
+                                ncclDataType_t datatype) const
+{
+  const size_t datatype_size = get_host_datatype_size(datatype);
+  char* send_ptr             = const_cast<char*>(static_cast<const char*>(sendbuff));
+  char* recv_ptr             = static_cast<char*>(recvbuff);
+  std::vector<peer_transfer> sends(num_ranks_), recvs(num_ranks_);
+  for (int r = 0; r < num_ranks_; r++) {
+    sends[r] = {r, send_ptr + senddispls[r] * datatype_size, sendcounts[r] * datatype_size};
+    recvs[r] = {r, recv_ptr + recvdispls[r] * datatype_size, recvcounts[r] * datatype_size};
+  }
+  exchange(sends, recvs);
+}
+
+}  // namespace wholememory
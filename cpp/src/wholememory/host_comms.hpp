@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <nccl.h>
+
+#include <vector>
+
+#include <wholememory/wholememory.h>
+
+namespace wholememory {
+
+/**
+ * @brief Host only communicator, implements host collectives over TCP sockets without NCCL or
+ * CUDA. Every pair of ranks is connected by one socket, so all collectives are done by sending
+ * to and receiving from peers concurrently.
+ */
+class host_comms {
+ public:
+  host_comms() = delete;
+
+  /**
+   * @brief Constructor, connects to all other ranks.
+   * @param unique_id unique id created by create_unique_id on one of the ranks
+   * @param num_ranks number of ranks in the cluster
+   * @param rank rank of the current worker
+   */
+  host_comms(const wholememory_unique_id_t& unique_id, int num_ranks, int rank);
+
+  ~host_comms();
+
+  /**
+   * @brief Create unique id for host communicator, the creating process should have a rank in
+   * the communicator. The listen port is kept by the creating process, one rank there uses it to
+   * collect listen addresses of all ranks and send them back, unused ports are closed by
+   * release_unused_unique_ids.
+   * @param unique_id returned unique id
+   */
+  static void create_unique_id(wholememory_unique_id_t* unique_id);
+
+  /**
+   * @brief Release ports of unique ids created by this process but not used by any rank here.
+   */
+  static void release_unused_unique_ids();
+
+  /**
+   * @brief Check if unique id is created by create_unique_id of host communicator.
+   * @param unique_id unique id to check
+   * @return true if unique id is for host communicator
+   */
+  static bool is_host_unique_id(const wholememory_unique_id_t& unique_id);
+
+  int get_size() const { return num_ranks_; }
+
+  int get_rank() const { return rank_; }
+
+  void barrier() const;
+
+  void host_allreduce(const void* sendbuff,
+                      void* recvbuff,
+                      size_t count,
+                      ncclDataType_t datatype,
+                      ncclRedOp_t op) const;
+
+  void host_bcast(
+    const void* sendbuff, void* recvbuff, size_t count, ncclDataType_t datatype, int root) const;
+
+  void host_bcast(void* buff, size_t count, ncclDataType_t datatype, int root) const;
+
+  void host_reduce(const void* sendbuff,
+                   void* recvbuff,
+                   size_t count,
+                   ncclDataType_t datatype,
+                   ncclRedOp_t op,
+                   int root) const;
+
+  void host_allgather(const void* sendbuff,
+                      void* recvbuff,
+                      size_t sendcount,
+                      ncclDataType_t datatype) const;
+
+  void host_allgatherv(const void* sendbuf,
+                       void* recvbuf,
+                       const size_t* recvcounts,
+                       const size_t* displs,
+                       ncclDataType_t datatype) const;
+
+  void host_gather(const void* sendbuff,
+                   void* recvbuff,
+                   size_t sendcount,
+                   ncclDataType_t datatype,
+                   int root) const;
+
+  void host_alltoall(const void* sendbuff,
+                     void* recvbuff,
+                     size_t sendcount,
+                     ncclDataType_t datatype) const;
+
+  void host_alltoallv(const void* sendbuff,
+                      void* recvbuff,
+                      const size_t* sendcounts,
+                      const size_t* senddispls,
+                      const size_t* recvcounts,
+                      const size_t* recvdispls,
+                      ncclDataType_t datatype) const;
+
+ private:
+  struct peer_transfer {
+    int peer;
+    char* ptr;
+    size_t size;
+  };
+
+  /**
+   * @brief Send and receive with peers concurrently until all transfers are done.
+   * @param sends buffers to send, at most one for each peer
+   * @param recvs buffers to receive, at most one for each peer
+   */
+  void exchange(std::vector<peer_transfer>& sends, std::vector<peer_transfer>& recvs) const;
+
+  // each rank gets its block of reduced result, block of rank r is [displs[r], displs[r + 1]).
+  void reduce_scatter_blocks(const void* sendbuff,
+                             void* recvbuff,
+                             const std::vector<size_t>& displs,
+                             ncclDataType_t datatype,
+                             ncclRedOp_t op) const;
+
+  int num_ranks_;
+  int rank_;
+  std::vector<int> peer_fds_;
+};
+
+}  // namespace wholememory
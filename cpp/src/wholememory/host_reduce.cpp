@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "wholememory/host_reduce.hpp"
+
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "error.hpp"
+#include "logger.hpp"
+
+namespace wholememory {
+
+size_t get_host_datatype_size(ncclDataType_t datatype)
+{
+  switch (datatype) {
+    case ncclInt8:
+    case ncclUint8: return 1;
+    case ncclFloat16:
+#if defined(__CUDA_BF16_TYPES_EXIST__)
+    case ncclBfloat16:
+#endif
+      return 2;
+    case ncclInt32:
+    case ncclUint32:
+    case ncclFloat32: return 4;
+    case ncclInt64:
+    case ncclUint64:
+    case ncclFloat64: return 8;
+    default: WHOLEMEMORY_FAIL("get_host_datatype_size");
+  }
+  return 0;
+}
+
+template <typename DataTypeT>
+struct host_reduce_type {
+  using type = DataTypeT;
+};
+template <>
+struct host_reduce_type<__half> {
+  using type = float;
+};
+#if defined(__CUDA_BF16_TYPES_EXIST__)
+template <>
+struct host_reduce_type<__nv_bfloat16> {
+  using type = float;
+};
+#endif
+
+template <typename DataTypeT>
+static void host_reduce_ranks_func(
+  const void* buf, size_t rank_stride, void* recvbuff, size_t count, int num_ranks, ncclRedOp_t op)
+{
+  using AccT         = typename host_reduce_type<DataTypeT>::type;
+  const auto* values = static_cast<const DataTypeT*>(buf);
+  std::vector<AccT> acc(count);
+  for (size_t i = 0; i < count; i++) {
+    acc[i] = static_cast<AccT>(values[i]);
+  }
+  for (int r = 1; r < num_ranks; r++) {
+    const DataTypeT* rank_values = values + r * rank_stride;
+    switch (op) {
+      case ncclSum:
+      case ncclAvg:
+        for (size_t i = 0; i < count; i++) {
+          acc[i] += static_cast<AccT>(rank_values[i]);
+        }
+        break;
+      case ncclProd:
+        for (size_t i = 0; i < count; i++) {
+          acc[i] *= static_cast<AccT>(rank_values[i]);
+        }
+        break;
+      case ncclMax:
+        for (size_t i = 0; i < count; i++) {
+          acc[i] = std::max(acc[i], static_cast<AccT>(rank_values[i]));
+        }
+        break;
+      case ncclMin:
+        for (size_t i = 0; i < count; i++) {
+          acc[i] = std::min(acc[i], static_cast<AccT>(rank_values[i]));
+        }
+        break;
+      default: WHOLEMEMORY_FAIL("host communicator reduce op %d not supported.", (int)op);
+    }
+  }
+  auto* output = static_cast<DataTypeT*>(recvbuff);
+  for (size_t i = 0; i < count; i++) {
+    AccT value = op == ncclAvg ? acc[i] / static_cast<AccT>(num_ranks) : acc[i];
+    output[i]  = static_cast<DataTypeT>(value);
+  }
+}
+
+void host_reduce_ranks(const void* buf,
+                       size_t rank_stride,
+                       void* recvbuff,
+                       size_t count,
+                       int num_ranks,
+                       ncclDataType_t datatype,
+                       ncclRedOp_t op)
+{
+  switch (datatype) {
+    case ncclInt8:
+      host_reduce_ranks_func<int8_t>(buf, rank_stride, recvbuff, count, num_ranks, op);
+      break;
+    case ncclUint8:
+      host_reduce_ranks_func<uint8_t>(buf, rank_stride, recvbuff, count, num_ranks, op);
+      break;
+    case ncclInt32:
+      host_reduce_ranks_func<int32_t>(buf, rank_stride, recvbuff, count, num_ranks, op);
+      break;
+    case ncclUint32:
+      host_reduce_ranks_func<uint32_t>(buf, rank_stride, recvbuff, count, num_ranks, op);
+      break;
+    case ncclInt64:
+      host_reduce_ranks_func<int64_t>(buf, rank_stride, recvbuff, count, num_ranks, op);
+      break;
+    case ncclUint64:
+      host_reduce_ranks_func<uint64_t>(buf, rank_stride, recvbuff, count, num_ranks, op);
+      break;
+    case ncclFloat16:
+      host_reduce_ranks_func<__half>(buf, rank_stride, recvbuff, count, num_ranks, op);
+      break;
+    case ncclFloat32:
+      host_reduce_ranks_func<float>(buf, rank_stride, recvbuff, count, num_ranks, op);
+      break;
+    case ncclFloat64:
+      host_reduce_ranks_func<double>(buf, rank_stride, recvbuff, count, num_ranks, op);
+      break;
+#if defined(__CUDA_BF16_TYPES_EXIST__)
+    case ncclBfloat16:
+      host_reduce_ranks_func<__nv_bfloat16>(buf, rank_stride, recvbuff, count, num_ranks, op);
+      break;
+#endif
+    default: WHOLEMEMORY_FAIL("host communicator reduce datatype %d not supported.", datatype);
+  }
+}
+
+}  // namespace wholememory
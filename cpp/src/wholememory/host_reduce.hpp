@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <nccl.h>
+
+namespace wholememory {
+
+/**
+ * @brief Get element size of datatype used by host collectives.
+ * @param datatype NCCL datatype
+ * @return size of one element in bytes
+ */
+size_t get_host_datatype_size(ncclDataType_t datatype);
+
+/**
+ * @brief Reduce count elements of num_ranks ranks on host, ranks are reduced in rank order so all
+ * callers get bitwise identical results. half and bfloat16 are accumulated in float.
+ * @param buf elements of rank 0, elements of rank r start at buf + r * rank_stride elements
+ * @param rank_stride stride between ranks in elements
+ * @param recvbuff output of count elements
+ * @param count element count to reduce
+ * @param num_ranks number of ranks
+ * @param datatype NCCL datatype
+ * @param op reduce op, sum, prod, max, min and avg are supported
+ */
+void host_reduce_ranks(const void* buf,
+                       size_t rank_stride,
+                       void* recvbuff,
+                       size_t count,
+                       int num_ranks,
+                       ncclDataType_t datatype,
+                       ncclRedOp_t op);
+
+}  // namespace wholememory
@@ -22,12 +22,14 @@
 #include "communicator.hpp"
 #include "cuda_macros.hpp"
 #include "error.hpp"
+#include "host_comms.hpp"
 #include "logger.hpp"
 
 namespace wholememory {
 
 static std::mutex mu;
-static bool is_wm_init = false;
+static bool is_wm_init         = false;
+static unsigned int init_flags = 0;
 
 static const std::string RAFT_NAME  = "wholememory";
 static cudaDeviceProp* device_props = nullptr;
@@ -36,9 +38,20 @@ wholememory_error_code_t init(unsigned int flags) noexcept
 {
   try {
     std::unique_lock<std::mutex> lock(mu);
-    (void)flags;
     WHOLEMEMORY_EXPECTS(!is_wm_init, "WholeMemory has already been initialized.");
-    WM_CU_CHECK(cuInit(0));
+    WHOLEMEMORY_EXPECTS(
+      (flags & ~(WHOLEMEMORY_INIT_HUGE_PAGE_2MB | WHOLEMEMORY_INIT_HUGE_PAGE_1GB)) == 0,
+      "Unknown init flags 0x%x",
+      flags);
+    init_flags = flags;
+    CUresult cu_init_result = cuInit(0);
+    if (cu_init_result == CUDA_ERROR_NO_DEVICE) {
+      // CPU only processes can still use host only communicator and host memory.
+      WHOLEMEMORY_WARN("no CUDA device found, only host communicator is supported.");
+      is_wm_init = true;
+      return WHOLEMEMORY_SUCCESS;
+    }
+    WM_CU_CHECK(cu_init_result);
     int dev_count = 0;
     WM_CUDA_CHECK(cudaGetDeviceCount(&dev_count));
     if (dev_count <= 0) {
@@ -74,14 +87,18 @@ wholememory_error_code_t finalize() noexcept
   std::unique_lock<std::mutex> lock(mu);
   is_wm_init = false;
   WHOLEMEMORY_RETURN_ON_FAIL(destroy_all_communicators());
+  host_comms::release_unused_unique_ids();
   delete[] device_props;
   device_props = nullptr;
   return WHOLEMEMORY_SUCCESS;
 }
 
+unsigned int get_init_flags() noexcept { return init_flags; }
+
 cudaDeviceProp* get_device_prop(int dev_id) noexcept
 {
   try {
+    WHOLEMEMORY_CHECK(device_props != nullptr);
     if (dev_id == -1) { WM_CUDA_CHECK(cudaGetDevice(&dev_id)); }
     WHOLEMEMORY_CHECK(dev_id >= 0);
     return device_props + dev_id;
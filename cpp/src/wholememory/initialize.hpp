@@ -25,6 +25,12 @@ wholememory_error_code_t init(unsigned int flags) noexcept;
 
 wholememory_error_code_t finalize() noexcept;
 
+/**
+ * return flags passed to init
+ * @return : bitwise or of wholememory_init_flags_t
+ */
+unsigned int get_init_flags() noexcept;
+
 /**
  * return cudaDeviceProp of dev_id, if dev_id is -1, use current device
  * @param dev_id : device id, -1 for current device
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "wholememory/memory_fill.hpp"
+
+#include <cuda.h>
+#include <cuda_runtime_api.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "cuda_macros.hpp"
+#include "error.hpp"
+#include "parallel_utils.hpp"
+
+namespace wholememory {
+
+namespace {
+
+// smaller fill is not worth waking up more threads.
+constexpr size_t kMinFillSizePerTask = 16 * 1024 * 1024;
+// multiple of all supported value sizes.
+constexpr size_t kFillPatternSize = 4096;
+
+void fill_with_pattern(char* dst, size_t size, const char* pattern)
+{
+  while (size >= kFillPatternSize) {
+    memcpy(dst, pattern, kFillPatternSize);
+    dst += kFillPatternSize;
+    size -= kFillPatternSize;
+  }
+  memcpy(dst, pattern, size);
+}
+
+void check_fill_args(const void* ptr, size_t size, const void* value, size_t value_size)
+{
+  WHOLEMEMORY_CHECK(value != nullptr);
+  WHOLEMEMORY_CHECK(is_fill_value_size_supported(value_size));
+  WHOLEMEMORY_CHECK(reinterpret_cast<uintptr_t>(ptr) % value_size == 0);
+  WHOLEMEMORY_CHECK(size % value_size == 0);
+}
+
+}  // namespace
+
+bool is_fill_value_size_supported(size_t value_size)
+{
+  return value_size == 1 || value_size == 2 || value_size == 4;
+}
+
+void host_fill_memory(
+  void* ptr, size_t size, const void* value, size_t value_size, size_t page_size)
+{
+  check_fill_args(ptr, size, value, value_size);
+  if (size == 0) return;
+  if (page_size == 0) page_size = sysconf(_SC_PAGESIZE);
+  WHOLEMEMORY_CHECK(page_size % value_size == 0);
+  char pattern[kFillPatternSize];
+  for (size_t i = 0; i < kFillPatternSize; i += value_size) {
+    memcpy(pattern + i, value, value_size);
+  }
+  // values of identical bytes, e.g. zero, are filled by memset.
+  bool const is_byte_value = std::all_of(
+    pattern, pattern + value_size, [&pattern](char byte) { return byte == pattern[0]; });
+  char* start = static_cast<char*>(ptr);
+  // bytes before first page boundary, belongs to first task.
+  size_t const head_size =
+    std::min(size, (page_size - reinterpret_cast<uintptr_t>(start) % page_size) % page_size);
+  size_t const page_count = (size - head_size + page_size - 1) / page_size;
+  size_t const task_count = std::max<size_t>(
+    std::min<size_t>({static_cast<size_t>(GetThreadPoolSize()),
+                      size / kMinFillSizePerTask,
+                      page_count}),
+    1);
+  ThreadPoolRun(static_cast<int>(task_count), [&](int task_id, int task_num) {
+    size_t const begin_page = page_count * task_id / task_num;
+    size_t const end_page   = page_count * (task_id + 1) / task_num;
+    size_t const begin      = task_id == 0 ? 0 : head_size + begin_page * page_size;
+    size_t const end        = std::min(size, head_size + end_page * page_size);
+    if (begin >= end) return;
+    if (is_byte_value) {
+      memset(start + begin, pattern[0], end - begin);
+    } else {
+      fill_with_pattern(start + begin, end - begin, pattern);
+    }
+  });
+}
+
+void device_fill_memory(void* ptr, size_t size, const void* value, size_t value_size)
+{
+  check_fill_args(ptr, size, value, value_size);
+  if (size == 0) return;
+  auto dptr          = reinterpret_cast<CUdeviceptr>(ptr);
+  size_t const count = size / value_size;
+  switch (value_size) {
+    case 1: {
+      uint8_t v;
+      memcpy(&v, value, sizeof(v));
+      WM_CU_CHECK(cuMemsetD8(dptr, v, count));
+      break;
+    }
+    case 2: {
+      uint16_t v;
+      memcpy(&v, value, sizeof(v));
+      WM_CU_CHECK(cuMemsetD16(dptr, v, count));
+      break;
+    }
+    default: {
+      uint32_t v;
+      memcpy(&v, value, sizeof(v));
+      WM_CU_CHECK(cuMemsetD32(dptr, v, count));
+      break;
+    }
+  }
+  // memset of device memory may be asynchronous to host.
+  WM_CUDA_CHECK(cudaDeviceSynchronize());
+}
+
+}  // namespace wholememory
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace wholememory {
+
+/**
+ * @brief Check if value size is supported by fill functions.
+ * @param value_size size of value in bytes
+ * @return true if value_size is 1, 2 or 4
+ */
+bool is_fill_value_size_supported(size_t value_size);
+
+/**
+ * @brief Fill host memory with a repeated value by threads of host thread pool. Memory is split
+ * at page boundaries, so each page is first touched by only one thread.
+ * @param ptr host memory pointer, should be aligned to value_size
+ * @param size size in bytes, should be multiple of value_size
+ * @param value pointer to the value
+ * @param value_size size of value in bytes, 1, 2 or 4
+ * @param page_size page size of the memory, 0 for system page size
+ */
+void host_fill_memory(
+  void* ptr, size_t size, const void* value, size_t value_size, size_t page_size = 0);
+
+/**
+ * @brief Fill device memory with a repeated value, returns after memory is filled.
+ * @param ptr device memory pointer, should be aligned to value_size
+ * @param size size in bytes, should be multiple of value_size
+ * @param value pointer to the value
+ * @param value_size size of value in bytes, 1, 2 or 4
+ */
+void device_fill_memory(void* ptr, size_t size, const void* value, size_t value_size);
+
+}  // namespace wholememory
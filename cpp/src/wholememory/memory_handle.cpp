@@ -22,10 +22,16 @@
 #include <sys/mman.h>
 #include <sys/shm.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/un.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "cuda_macros.hpp"
@@ -34,8 +40,11 @@
 #include "logger.hpp"
 #include "wholememory/communicator.hpp"
 #include "wholememory/global_reference.h"
+#include "wholememory/initialize.hpp"
 #include "wholememory/wholememory.h"
 
+#include "memory_fill.hpp"
+#include "memory_usage.hpp"
 #include "system_info.hpp"
 #ifdef WITH_NVSHMEM_SUPPORT
 #include "nvshmem.h"
@@ -48,6 +57,7 @@ enum wm_memory_op : int32_t {
   WM_MEM_OP_CREATE = 0xEEEEE,
   WM_MEM_OP_EXCHANGE_ID,
   WM_MEM_OP_DESTROY,
+  WM_MEM_OP_GROW,
 };
 
 class wholememory_impl {
@@ -63,6 +73,7 @@ class wholememory_impl {
       type_(memory_type),
       location_(memory_location),
       total_size_(total_size),
+      max_total_size_(total_size),
       data_granularity_(data_granularity)
   {
     distrubuted_backend_ = WHOLEMEMORY_DB_NCCL;
@@ -82,9 +93,40 @@ class wholememory_impl {
   }
 
   [[nodiscard]] size_t total_size() const { return total_size_; }
+  [[nodiscard]] size_t max_total_size() const { return max_total_size_; }
   [[nodiscard]] size_t data_granularity() const { return data_granularity_; }
+  // set before create_memory, bitwise or of wholememory_malloc_flags_t.
+  void set_malloc_flags(unsigned int malloc_flags) { malloc_flags_ = malloc_flags; }
+  // set before create_memory, address space and partition plan are for max_total_size.
+  void set_max_total_size(size_t max_total_size) { max_total_size_ = max_total_size; }
+  // set before create_memory, memory usage is accounted to this purpose.
+  void set_purpose(wholememory_memory_purpose_t purpose) { purpose_ = purpose; }
+  [[nodiscard]] wholememory_memory_purpose_t get_purpose() const { return purpose_; }
+  // size of memory allocated by this rank, shared host memory is allocated by the first rank.
+  [[nodiscard]] virtual size_t get_local_allocated_size() const
+  {
+    return alloc_strategy_.local_alloc_size;
+  }
+  // account memory allocated since last call, called after memory is created or grown.
+  void update_memory_usage();
+  // account memory as freed, called before memory is destroyed.
+  void release_memory_usage() noexcept;
+  [[nodiscard]] wholememory_memory_usage_t get_memory_usage() const { return memory_usage_; }
+  // page size of host memory, used to split host memory fill by pages.
+  [[nodiscard]] virtual size_t get_host_page_size() const { return 0; }
+  // false if memory is mapped read only, e.g. files mapped without write back.
+  [[nodiscard]] virtual bool is_writable() const { return true; }
   virtual void create_memory()           = 0;
   virtual void destroy_memory() noexcept = 0;
+  // grows to new_total_size within max_total_size, existing memory stays mapped at same address.
+  // returns false if growing failed on any rank, and then memory is unchanged on all ranks.
+  virtual bool grow_memory(size_t new_total_size)
+  {
+    WHOLEMEMORY_FATAL("Growing memory_type (%d) and memory_location (%d) is not supported.",
+                      (int)type_,
+                      (int)location_);
+    return false;
+  }
   [[nodiscard]] virtual void* get_continuous_mapping_pointer() const noexcept { return nullptr; }
   [[nodiscard]] virtual wholememory_gref_t get_global_reference() const noexcept
   {
@@ -144,6 +186,23 @@ class wholememory_impl {
   // get the rank which is responsible for it.
   void generate_rank_partition_strategy();
 
+  // runs fn on all ranks, returns true only if it succeeded on every rank. Used to keep collective
+  // operations consistent when a local step fails on some ranks.
+  template <typename Fn>
+  bool all_ranks_succeed(Fn&& fn)
+  {
+    int failed = 0;
+    try {
+      fn();
+    } catch (const std::exception& e) {
+      WHOLEMEMORY_ERROR("Rank=%d failed: %s", comm_->world_rank, e.what());
+      failed = 1;
+    }
+    int failed_ranks = 0;
+    comm_->host_allreduce(&failed, &failed_ranks, 1, WHOLEMEMORY_DT_INT, ncclSum);
+    return failed_ranks == 0;
+  }
+
   /*
    *  ++---------------------------------------------------------------------------------------++
    *  ||     Type     ||     CONTINUOUS      ||      CHUNKED        ||       DISTRIBUTED       ||
@@ -165,7 +224,14 @@ class wholememory_impl {
   wholememory_distributed_backend_t distrubuted_backend_;
   // raw user input size, real allocation may be larger than this.
   size_t total_size_;
+  // size the memory can grow to, partition plan is determined by this size.
+  size_t max_total_size_;
   size_t data_granularity_;
+  unsigned int malloc_flags_            = 0;
+  wholememory_memory_purpose_t purpose_ = WHOLEMEMORY_MP_GENERAL;
+  // memory usage of this handle on this rank.
+  wholememory_memory_usage_t memory_usage_{};
+  [[nodiscard]] memory_usage_category get_memory_usage_category() const;
 
   struct alloc_strategy {
     size_t total_alloc_size = 0;
@@ -175,6 +241,13 @@ class wholememory_impl {
     std::vector<size_t> alloc_sizes;
   } alloc_strategy_;
 
+  // each rank allocates pages in [start_offset, end_offset) that start in its partition, so pages
+  // are local to the rank responsible for them, used by growable continuous device memory.
+  void each_rank_partition_page_strategy(alloc_strategy* strategy,
+                                         size_t start_offset,
+                                         size_t end_offset,
+                                         size_t page_size) const;
+
   struct partition_strategy {
     // size of memory this rank is responsible for
     size_t local_mem_size = 0;
@@ -206,22 +279,114 @@ struct wholememory_vma_data {
   const void* start_ptr;
   size_t mem_block_size;
 };
-// mutex to protect wholememory_vma_map
+// mutex to protect wholememory_vma_map, also serializes snapshot publishers.
 static std::mutex wholememory_vma_mu;
 // map to store memory regions that are in wholememory.
 // Key is the tail of a valid memory, the byte of the key is not in wholememory.
 // The reason to use tail is that we can check if a pointer is in wholememory by upper_bound.
 static std::map<uint64_t, wholememory_vma_data> wholememory_vma_map;
 
+// wholememory_get_handle is called by many threads, so it searches an immutable sorted snapshot
+// of wholememory_vma_map without lock. Snapshot is rebuilt and published each time the map
+// changes. Readers announce global epoch in their slot when they start, a replaced snapshot is
+// freed after all readers in progress started in an epoch after it was replaced.
+struct wholememory_vma_snapshot {
+  std::vector<uint64_t> tail_ptrs;
+  std::vector<wholememory_vma_data> vma_data;
+};
+struct alignas(64) wholememory_vma_reader_slot {
+  // epoch the reader started in, 0 if not reading.
+  std::atomic<uint64_t> epoch{0};
+  std::atomic<bool> in_use{false};
+};
+static constexpr int WHOLEMEMORY_VMA_READER_SLOT_COUNT = 512;
+static wholememory_vma_reader_slot wholememory_vma_reader_slots[WHOLEMEMORY_VMA_READER_SLOT_COUNT];
+static std::atomic<const wholememory_vma_snapshot*> wholememory_vma_current_snapshot{nullptr};
+static std::atomic<uint64_t> wholememory_vma_epoch{1};
+// replaced snapshots and epoch they were replaced in, protected by wholememory_vma_mu.
+static std::vector<std::pair<const wholememory_vma_snapshot*, uint64_t>> wholememory_vma_retired;
+
+// returns reader slot of current thread, nullptr if all slots are taken.
+static wholememory_vma_reader_slot* get_wholememory_vma_reader_slot()
+{
+  struct slot_holder {
+    slot_holder()
+    {
+      for (auto& reader_slot : wholememory_vma_reader_slots) {
+        bool expected = false;
+        if (reader_slot.in_use.compare_exchange_strong(expected, true)) {
+          slot = &reader_slot;
+          break;
+        }
+      }
+    }
+    ~slot_holder()
+    {
+      if (slot != nullptr) slot->in_use.store(false, std::memory_order_release);
+    }
+    wholememory_vma_reader_slot* slot = nullptr;
+  };
+  thread_local slot_holder holder;
+  return holder.slot;
+}
+
+static wholememory_handle_t find_handle_in_vma_snapshot(const wholememory_vma_snapshot* snapshot,
+                                                       uint64_t int_ptr)
+{
+  if (snapshot == nullptr) return nullptr;
+  auto it = std::upper_bound(snapshot->tail_ptrs.begin(), snapshot->tail_ptrs.end(), int_ptr);
+  if (it == snapshot->tail_ptrs.end()) return nullptr;
+  const auto& vma_data = snapshot->vma_data[it - snapshot->tail_ptrs.begin()];
+  if (int_ptr < reinterpret_cast<uint64_t>(vma_data.start_ptr)) return nullptr;
+  return vma_data.wholememory_handle;
+}
+
 wholememory_handle_t wholememory_get_handle(const void* ptr)
 {
-  std::unique_lock<std::mutex> vma_lock(wholememory_vma_mu);
-  uint64_t int_ptr = reinterpret_cast<uint64_t>(ptr);
-  auto it          = wholememory_vma_map.upper_bound(int_ptr);
-  if (it == wholememory_vma_map.end()) return nullptr;
-  wholememory_handle_t wm_h = it->second.wholememory_handle;
-  if (wm_h->impl->contains_pointer(ptr)) { return wm_h; }
-  return nullptr;
+  uint64_t int_ptr                         = reinterpret_cast<uint64_t>(ptr);
+  wholememory_vma_reader_slot* reader_slot = get_wholememory_vma_reader_slot();
+  if (reader_slot == nullptr) {
+    // more reader threads than slots, snapshot is not replaced while holding the lock.
+    std::unique_lock<std::mutex> vma_lock(wholememory_vma_mu);
+    return find_handle_in_vma_snapshot(wholememory_vma_current_snapshot.load(), int_ptr);
+  }
+  // seq_cst store and load, so a publisher that does not see this epoch has already published
+  // the snapshot this reader loads.
+  reader_slot->epoch.store(wholememory_vma_epoch.load());
+  auto* snapshot = wholememory_vma_current_snapshot.load();
+  auto* wm_h     = find_handle_in_vma_snapshot(snapshot, int_ptr);
+  reader_slot->epoch.store(0, std::memory_order_release);
+  return wm_h;
+}
+
+static void publish_wholememory_vma_snapshot_locked()
+{
+  auto* snapshot = new wholememory_vma_snapshot;
+  snapshot->tail_ptrs.reserve(wholememory_vma_map.size());
+  snapshot->vma_data.reserve(wholememory_vma_map.size());
+  for (const auto& tail_and_data : wholememory_vma_map) {
+    snapshot->tail_ptrs.push_back(tail_and_data.first);
+    snapshot->vma_data.push_back(tail_and_data.second);
+  }
+  const auto* old_snapshot = wholememory_vma_current_snapshot.exchange(snapshot);
+  // readers started in new epoch or later can only see new snapshot.
+  uint64_t const new_epoch = wholememory_vma_epoch.fetch_add(1) + 1;
+  if (old_snapshot != nullptr) wholememory_vma_retired.emplace_back(old_snapshot, new_epoch);
+  uint64_t min_reader_epoch = std::numeric_limits<uint64_t>::max();
+  for (const auto& reader_slot : wholememory_vma_reader_slots) {
+    uint64_t reader_epoch = reader_slot.epoch.load();
+    if (reader_epoch != 0) min_reader_epoch = std::min(min_reader_epoch, reader_epoch);
+  }
+  auto reclaimable_end = std::partition(
+    wholememory_vma_retired.begin(),
+    wholememory_vma_retired.end(),
+    [min_reader_epoch](const std::pair<const wholememory_vma_snapshot*, uint64_t>& retired) {
+      return retired.second > min_reader_epoch;
+    });
+  for (auto it = reclaimable_end; it != wholememory_vma_retired.end(); ++it) {
+    delete it->first;
+  }
+  wholememory_vma_retired.erase(reclaimable_end, wholememory_vma_retired.end());
 }
 
 static void register_wholememory_vma_range_locked(const void* ptr,
@@ -254,6 +419,7 @@ static void register_wholememory_vma_range_locked(const void* ptr,
     ++it2;
     WHOLEMEMORY_CHECK(reinterpret_cast<uint64_t>(it2->second.start_ptr) >= int_tail_ptr);
   }
+  publish_wholememory_vma_snapshot_locked();
 }
 
 static void unregister_wholememory_vma_range_locked(const void* ptr,
@@ -272,6 +438,7 @@ static void unregister_wholememory_vma_range_locked(const void* ptr,
     WHOLEMEMORY_CHECK(it->second.start_ptr == ptr);
     WHOLEMEMORY_CHECK(it->second.mem_block_size == mem_block_size);
     wholememory_vma_map.erase(int_tail_ptr);
+    publish_wholememory_vma_snapshot_locked();
   } catch (const wholememory::logic_error& le) {
     WHOLEMEMORY_FAIL_NOTHROW("%s", le.what());
   }
@@ -341,6 +508,11 @@ class distributed_wholememory_impl : public wholememory_impl {
 
     if (on_device) {
       WM_CUDA_CHECK(cudaMalloc(&dev_ptr, alloc_size));
+    } else if (is_host_only_communicator(comm_)) {
+      // no CUDA device may be available, use pageable host memory.
+      dev_ptr =
+        mmap(nullptr, alloc_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      WHOLEMEMORY_CHECK(dev_ptr != MAP_FAILED);
     } else {
       WM_CUDA_CHECK(cudaMallocHost(&dev_ptr, alloc_size));
     }
@@ -355,12 +527,16 @@ class distributed_wholememory_impl : public wholememory_impl {
       bool on_device = location_ == WHOLEMEMORY_ML_DEVICE;
       if (on_device) {
         WM_CUDA_CHECK(cudaFree(ptr));
+      } else if (is_host_only_communicator(comm_)) {
+        WHOLEMEMORY_CHECK(munmap(ptr, alloc_strategy_.local_alloc_size) == 0);
       } else {
         WM_CUDA_CHECK(cudaFreeHost(ptr));
       }
       no_ipc_handle_.local_alloc_mem_ptr = nullptr;
     } catch (const wholememory::cuda_error& wce) {
       WHOLEMEMORY_FAIL_NOTHROW("%s", wce.what());
+    } catch (const wholememory::logic_error& wle) {
+      WHOLEMEMORY_FAIL_NOTHROW("%s", wle.what());
     } catch (const raft::exception& re) {
       WHOLEMEMORY_FAIL_NOTHROW("%s", re.what());
     }
@@ -400,10 +576,32 @@ class global_mapped_host_wholememory_impl : public wholememory_impl {
     unregister_host_memory();
     unmap_and_destroy_shared_host_memory();
   }
+  bool grow_memory(size_t new_total_size) override
+  {
+    if (!grow_shared_host_memory(new_total_size)) return false;
+    unregister_host_memory();
+    total_size_ = new_total_size;
+    generate_rank_partition_strategy();
+    local_partition_memory_pointer_ = static_cast<char*>(get_continuous_mapping_pointer()) +
+                                      rank_partition_strategy_.local_mem_offset;
+    register_host_memory();
+    communicator_barrier(comm_);
+    return true;
+  }
   [[nodiscard]] void* get_continuous_mapping_pointer() const noexcept override
   {
     return shared_host_handle_.shared_host_memory_ptr;
   }
+  [[nodiscard]] size_t get_host_page_size() const override { return shared_host_handle_.page_size; }
+  [[nodiscard]] size_t get_local_allocated_size() const override
+  {
+    if (comm_->world_rank != 0) return 0;
+    size_t allocated_size = 0;
+    for (const auto& segment : shared_host_handle_.segments) {
+      allocated_size += segment.size;
+    }
+    return allocated_size;
+  }
   [[nodiscard]] wholememory_gref_t get_global_reference() const noexcept override
   {
     wholememory_gref_t gref{};
@@ -444,122 +642,450 @@ class global_mapped_host_wholememory_impl : public wholememory_impl {
     unregister_wholememory_vma_range_locked(
       shared_host_handle_.shared_host_memory_ptr, total_size_, handle_);
   }
-  static std::string get_host_memory_full_path(wholememory_comm_t wm_comm, int tensor_id)
+  // segment 0 is created with the WholeMemory, and one more segment is created on each growing.
+  static std::string get_host_memory_full_path(wholememory_comm_t wm_comm,
+                                               int tensor_id,
+                                               size_t segment_id)
   {
     std::string host_memory_full_path = get_shm_prefix(wm_comm);
     host_memory_full_path.append("_").append("wm_host_").append(std::to_string(tensor_id));
+    if (segment_id > 0) host_memory_full_path.append("_").append(std::to_string(segment_id));
     return host_memory_full_path;
   }
 #define USE_SYSTEMV_SHM
 #define SYSTEMV_SHM_PROJ_ID (0xE601EEEE)
-  void create_and_map_shared_host_memory()
+// page size flags of SHM_HUGETLB may be missing in glibc headers, values are from linux/shm.h
+#ifndef SHM_HUGE_SHIFT
+#define SHM_HUGE_SHIFT 26
+#endif
+#ifndef SHM_HUGE_2MB
+#define SHM_HUGE_2MB (21 << SHM_HUGE_SHIFT)
+#endif
+#ifndef SHM_HUGE_1GB
+#define SHM_HUGE_1GB (30 << SHM_HUGE_SHIFT)
+#endif
+  // huge pages enabled by init flags are tried first, larger page first. Huge pages of SystemV
+  // shared memory are reserved by shmget, so if pool is not enough, shmget fails and smaller
+  // pages are tried instead of failing on page fault later. Huge pages larger than alignment of
+  // the mapping address are skipped, 0 alignment means the segment may be mapped anywhere.
+  static int create_systemv_shm(key_t shm_key,
+                                size_t size,
+                                size_t address_alignment,
+                                size_t* page_size)
+  {
+    struct huge_page_type {
+      unsigned int init_flag;
+      int shm_flag;
+      size_t page_size;
+      const char* name;
+    };
+    const huge_page_type huge_page_types[] = {
+      {WHOLEMEMORY_INIT_HUGE_PAGE_1GB, SHM_HUGETLB | SHM_HUGE_1GB, 1024UL * 1024UL * 1024UL, "1GB"},
+      {WHOLEMEMORY_INIT_HUGE_PAGE_2MB, SHM_HUGETLB | SHM_HUGE_2MB, 2UL * 1024UL * 1024UL, "2MB"}};
+    unsigned int init_flags = get_init_flags();
+    for (const auto& huge_page : huge_page_types) {
+      if ((init_flags & huge_page.init_flag) == 0) continue;
+      if (address_alignment % huge_page.page_size != 0) continue;
+      size_t huge_page_size = round_up_unsafe(size, huge_page.page_size);
+      int shm_id =
+        shmget(shm_key, huge_page_size, 0644 | IPC_CREAT | IPC_EXCL | huge_page.shm_flag);
+      if (shm_id != -1) {
+        WHOLEMEMORY_INFO("Created host shared memory of %ld bytes with %s huge pages.",
+                         huge_page_size,
+                         huge_page.name);
+        *page_size = huge_page.page_size;
+        return shm_id;
+      }
+      WHOLEMEMORY_WARN(
+        "Create host shared memory of %ld bytes with %s huge pages failed, Reason=%s.",
+        huge_page_size,
+        huge_page.name,
+        strerror(errno));
+    }
+    *page_size = sysconf(_SC_PAGESIZE);
+    return shmget(shm_key, size, 0644 | IPC_CREAT | IPC_EXCL);
+  }
+  enum class host_numa_policy { none, local, interleave };
+  /**
+   * NUMA placement of host memory partitions, configured by WHOLEMEMORY_HOST_NUMA_POLICY, which is
+   * none (first touch), local (partition of each rank prefers NUMA node local to the rank's GPU, or
+   * to the rank's CPU for host only communicator) or interleave (across all NUMA nodes).
+   */
+  static host_numa_policy get_host_numa_policy()
+  {
+    const char* policy_str = std::getenv("WHOLEMEMORY_HOST_NUMA_POLICY");
+    if (policy_str == nullptr || strcmp(policy_str, "none") == 0) return host_numa_policy::none;
+    if (strcmp(policy_str, "local") == 0) return host_numa_policy::local;
+    if (strcmp(policy_str, "interleave") == 0) return host_numa_policy::interleave;
+    WHOLEMEMORY_WARN(
+      "Unknown WHOLEMEMORY_HOST_NUMA_POLICY=%s, should be none, local or interleave.", policy_str);
+    return host_numa_policy::none;
+  }
+
+  // mapped shared memory segment, which holds [offset, offset + size) of the WholeMemory.
+  struct shared_host_segment {
+    void* ptr        = nullptr;
+    size_t offset    = 0;
+    size_t size      = 0;
+    size_t page_size = 0;
+  };
+
+  // should be called before local partition in segment is touched. Pages at partition boundaries
+  // are shared with neighbor ranks, and may follow policy of either rank.
+  void set_local_partition_numa_policy(const shared_host_segment& segment)
+  {
+    host_numa_policy policy = get_host_numa_policy();
+    if (policy == host_numa_policy::none) return;
+    size_t page_size = segment.page_size;
+    size_t local_end = rank_partition_strategy_.local_mem_offset +
+                       rank_partition_strategy_.local_mem_size;
+    size_t mem_start = std::max(rank_partition_strategy_.local_mem_offset, segment.offset);
+    size_t mem_end   = std::min(local_end, segment.offset + segment.size);
+    if (mem_start >= mem_end) return;
+    int numa_node = -1;
+    if (policy == host_numa_policy::local) {
+      if (!is_host_only_communicator(comm_)) numa_node = GetDeviceNumaNode(comm_->dev_id);
+      if (numa_node < 0) numa_node = GetCurrentNumaNode();
+    }
+    size_t start = mem_start / page_size * page_size;
+    size_t end   = round_up_unsafe(mem_end, page_size);
+    if (!SetMemoryNumaPolicy(
+          static_cast<char*>(segment.ptr) + (start - segment.offset), end - start, numa_node)) {
+      WHOLEMEMORY_WARN("Rank=%d set NUMA policy of host memory to node %d failed, Reason=%s.",
+                       comm_->world_rank,
+                       numa_node,
+                       strerror(errno));
+    }
+  }
+  // zero fills the part of local partition in [fill_start, fill_end) unless disabled by flags.
+  void zero_fill_local_partition(size_t fill_start, size_t fill_end)
+  {
+    if ((malloc_flags_ & WHOLEMEMORY_MF_NO_ZERO_INIT) != 0) return;
+    size_t local_end = rank_partition_strategy_.local_mem_offset +
+                       rank_partition_strategy_.local_mem_size;
+    size_t start     = std::max(fill_start, rank_partition_strategy_.local_mem_offset);
+    size_t end       = std::min(fill_end, local_end);
+    if (start >= end) return;
+    const char zero = 0;
+    host_fill_memory(static_cast<char*>(shared_host_handle_.shared_host_memory_ptr) + start,
+                     end - start,
+                     &zero,
+                     sizeof(zero),
+                     shared_host_handle_.page_size);
+  }
+  // reserves address space for growing, aligned to the largest page size segments may use.
+  void reserve_shared_host_address_space()
+  {
+    size_t alignment        = sysconf(_SC_PAGESIZE);
+    unsigned int init_flags = get_init_flags();
+    if ((init_flags & WHOLEMEMORY_INIT_HUGE_PAGE_1GB) != 0) {
+      alignment = 1024UL * 1024UL * 1024UL;
+    } else if ((init_flags & WHOLEMEMORY_INIT_HUGE_PAGE_2MB) != 0) {
+      alignment = 2UL * 1024UL * 1024UL;
+    }
+    size_t reserved_size = round_up_unsafe(max_total_size_, alignment);
+    void* reserved_ptr   = mmap(nullptr,
+                              reserved_size + alignment,
+                              PROT_NONE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                              -1,
+                              0);
+    WHOLEMEMORY_CHECK(reserved_ptr != MAP_FAILED);
+    auto* reserved_start = static_cast<char*>(reserved_ptr);
+    size_t head_size =
+      (alignment - reinterpret_cast<uintptr_t>(reserved_start) % alignment) % alignment;
+    char* aligned_start = reserved_start + head_size;
+    if (head_size > 0) { WHOLEMEMORY_CHECK(munmap(reserved_start, head_size) == 0); }
+    if (alignment > head_size) {
+      WHOLEMEMORY_CHECK(munmap(aligned_start + reserved_size, alignment - head_size) == 0);
+    }
+    shared_host_handle_.reserved_ptr  = aligned_start;
+    shared_host_handle_.reserved_size = reserved_size;
+  }
+  [[nodiscard]] size_t get_mapped_size() const
+  {
+    if (shared_host_handle_.segments.empty()) return 0;
+    const auto& last_segment = shared_host_handle_.segments.back();
+    return last_segment.offset + last_segment.size;
+  }
+  // creates segment by rank 0 and maps it in all ranks, at offset of reserved address space if
+  // the memory is growable. Returns false on all ranks if it failed on any rank, and then nothing
+  // is left created or mapped.
+  bool create_and_map_shared_host_segment(size_t segment_id,
+                                          size_t offset,
+                                          size_t size,
+                                          shared_host_segment* segment)
   {
     WHOLEMEMORY_CHECK(is_intranode_communicator(comm_));
+    void* map_addr = nullptr;
+    if (shared_host_handle_.reserved_ptr != nullptr) {
+      WHOLEMEMORY_CHECK(offset + size <= shared_host_handle_.reserved_size);
+      map_addr = static_cast<char*>(shared_host_handle_.reserved_ptr) + offset;
+    }
+    segment->ptr    = nullptr;
+    segment->offset = offset;
 #ifdef USE_SYSTEMV_SHM
     std::string shm_full_path = "/tmp/";
-    shm_full_path.append(get_host_memory_full_path(comm_, handle_->handle_id));
-    FILE* shm_fp = fopen(shm_full_path.c_str(), "w");
-    WHOLEMEMORY_CHECK(shm_fp != nullptr);
-    WHOLEMEMORY_CHECK(fclose(shm_fp) == 0);
-    auto shm_key = ftok(shm_full_path.c_str(), SYSTEMV_SHM_PROJ_ID);
-    WHOLEMEMORY_CHECK(shm_key != (key_t)-1);
+    shm_full_path.append(get_host_memory_full_path(comm_, handle_->handle_id, segment_id));
     int shm_id = -1;
 #else
-    auto shm_full_path = get_host_memory_full_path(comm_, handle_->handle_id);
+    auto shm_full_path = get_host_memory_full_path(comm_, handle_->handle_id, segment_id);
     int shm_fd         = -1;
 #endif
+    // rank 0 broadcasts if creating succeeded and page size, others attach only after success.
+    int64_t create_info[2] = {0, 0};
     if (comm_->world_rank == 0) {
+      try {
 #ifdef USE_SYSTEMV_SHM
-      shm_id = shmget(shm_key, alloc_strategy_.local_alloc_size, 0644 | IPC_CREAT | IPC_EXCL);
-      if (shm_id == -1) {
-        WHOLEMEMORY_FATAL(
-          "Create host shared memory from IPC key %d failed, Reason=%s", shm_key, strerror(errno));
-      }
+        FILE* shm_fp = fopen(shm_full_path.c_str(), "w");
+        WHOLEMEMORY_CHECK(shm_fp != nullptr);
+        WHOLEMEMORY_CHECK(fclose(shm_fp) == 0);
+        auto shm_key = ftok(shm_full_path.c_str(), SYSTEMV_SHM_PROJ_ID);
+        WHOLEMEMORY_CHECK(shm_key != (key_t)-1);
+        size_t page_size = 0;
+        shm_id           = create_systemv_shm(shm_key, size, offset, &page_size);
+        if (shm_id == -1) {
+          WHOLEMEMORY_FAIL("Create host shared memory from IPC key %d failed, Reason=%s",
+                           shm_key,
+                           strerror(errno));
+        }
+        create_info[1] = page_size;
 #else
-      shm_fd = shm_open(shm_full_path.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
-      if (shm_fd < 0) {
-        WHOLEMEMORY_FATAL("Create host shared memory from file %s failed, Reason=%s.",
-                          shm_full_path.c_str(),
-                          strerror(errno));
-      }
-      WHOLEMEMORY_CHECK(ftruncate(shm_fd, alloc_strategy_.local_alloc_size) == 0);
+        shm_fd = shm_open(shm_full_path.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+        if (shm_fd < 0) {
+          WHOLEMEMORY_FAIL("Create host shared memory from file %s failed, Reason=%s.",
+                           shm_full_path.c_str(),
+                           strerror(errno));
+        }
+        if (ftruncate(shm_fd, size) != 0) {
+          WHOLEMEMORY_FAIL("Resize host shared memory file %s to %ld bytes failed, Reason=%s.",
+                           shm_full_path.c_str(),
+                           size,
+                           strerror(errno));
+        }
+        create_info[1] = sysconf(_SC_PAGESIZE);
 #endif
-      communicator_barrier(comm_);
-    } else {
-      communicator_barrier(comm_);
+        create_info[0] = 1;
+      } catch (const std::exception& e) {
+        WHOLEMEMORY_ERROR("Rank=0 failed: %s", e.what());
+#ifndef USE_SYSTEMV_SHM
+        if (shm_fd >= 0) close(shm_fd);
+#endif
+        destroy_shared_host_segment_storage(segment_id);
+      }
+    }
+    comm_->host_bcast(create_info, 2, WHOLEMEMORY_DT_INT64, 0);
+    if (create_info[0] == 0) return false;
+    segment->page_size = create_info[1];
+    segment->size      = round_up_unsafe(size, segment->page_size);
+
+    bool success = all_ranks_succeed([&]() {
 #ifdef USE_SYSTEMV_SHM
-      shm_id = shmget(shm_key, alloc_strategy_.local_alloc_size, 0644);
-      if (shm_id == -1) {
-        WHOLEMEMORY_FATAL(
-          "Get host shared memory from IPC key %d failed, Reason=%s", shm_key, strerror(errno));
+      if (comm_->world_rank != 0) {
+        auto shm_key = ftok(shm_full_path.c_str(), SYSTEMV_SHM_PROJ_ID);
+        WHOLEMEMORY_CHECK(shm_key != (key_t)-1);
+        shm_id = shmget(shm_key, size, 0644);
+        if (shm_id == -1) {
+          WHOLEMEMORY_FAIL(
+            "Get host shared memory from IPC key %d failed, Reason=%s", shm_key, strerror(errno));
+        }
+      }
+      void* ptr = shmat(shm_id, map_addr, map_addr == nullptr ? 0 : SHM_REMAP);
+      if (ptr == (void*)-1) {
+        WHOLEMEMORY_FAIL("Attach host shared memory failed, Reason=%s", strerror(errno));
       }
+      segment->ptr = ptr;
 #else
-      shm_fd = shm_open(shm_full_path.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
-      if (shm_fd < 0) {
-        WHOLEMEMORY_FATAL("Rank=%d open host shared memory from file %s failed.",
-                          comm_->world_rank,
-                          shm_full_path.c_str());
+      if (comm_->world_rank != 0) {
+        shm_fd = shm_open(shm_full_path.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+        if (shm_fd < 0) {
+          WHOLEMEMORY_FAIL("Rank=%d open host shared memory from file %s failed.",
+                           comm_->world_rank,
+                           shm_full_path.c_str());
+        }
+      }
+      void* ptr = mmap(map_addr,
+                       segment->size,
+                       PROT_READ | PROT_WRITE,
+                       map_addr == nullptr ? MAP_SHARED : MAP_SHARED | MAP_FIXED,
+                       shm_fd,
+                       0);
+      int close_result = close(shm_fd);
+      shm_fd           = -1;
+      if (ptr == MAP_FAILED) {
+        WHOLEMEMORY_FAIL("Map host shared memory failed, Reason=%s", strerror(errno));
       }
+      segment->ptr = ptr;
+      WHOLEMEMORY_CHECK(close_result == 0);
+#endif
+      WHOLEMEMORY_CHECK(map_addr == nullptr || segment->ptr == map_addr);
+    });
+#ifndef USE_SYSTEMV_SHM
+    if (shm_fd >= 0) close(shm_fd);
 #endif
+    if (!success) {
+      if (segment->ptr != nullptr) unmap_shared_host_segment(*segment);
+      segment->ptr = nullptr;
+      communicator_barrier(comm_);
+      if (comm_->world_rank == 0) destroy_shared_host_segment_storage(segment_id);
+      WHOLEMEMORY_ERROR("Creating host shared memory segment %ld of %ld bytes failed.",
+                        segment_id,
+                        size);
     }
-    communicator_barrier(comm_);
-    void* mmap_ptr = nullptr;
+    return success;
+  }
+  // unmaps segment, address range of growable memory is reserved again for later growing.
+  void unmap_shared_host_segment(const shared_host_segment& segment)
+  {
 #ifdef USE_SYSTEMV_SHM
-    mmap_ptr = shmat(shm_id, nullptr, 0);
-    WHOLEMEMORY_CHECK(mmap_ptr != (void*)-1);
+    WHOLEMEMORY_CHECK(shmdt(segment.ptr) == 0);
+    if (shared_host_handle_.reserved_ptr == nullptr) return;
 #else
-    mmap_ptr = mmap(
-      nullptr, alloc_strategy_.total_alloc_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
-    WHOLEMEMORY_CHECK(mmap_ptr != (void*)-1);
+    if (shared_host_handle_.reserved_ptr == nullptr) {
+      WHOLEMEMORY_CHECK(munmap(segment.ptr, segment.size) == 0);
+      return;
+    }
 #endif
-    memset(static_cast<char*>(mmap_ptr) + rank_partition_strategy_.local_mem_offset,
-           0,
-           rank_partition_strategy_.local_mem_size);
-    WM_CUDA_CHECK_NO_THROW(
-      cudaHostRegister(mmap_ptr, alloc_strategy_.total_alloc_size, cudaHostRegisterDefault));
-#ifndef USE_SYSTEMV_SHM
-    WHOLEMEMORY_CHECK(close(shm_fd) == 0);
+    void* reserved_ptr = mmap(segment.ptr,
+                              segment.size,
+                              PROT_NONE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED,
+                              -1,
+                              0);
+    WHOLEMEMORY_CHECK(reserved_ptr == segment.ptr);
+  }
+  // called by rank 0 only, after all ranks unmapped the segment. Missing storage is ignored, as
+  // creating may have failed halfway.
+  void destroy_shared_host_segment_storage(size_t segment_id) noexcept
+  {
+#ifdef USE_SYSTEMV_SHM
+    std::string shm_full_path = "/tmp/";
+    shm_full_path.append(get_host_memory_full_path(comm_, handle_->handle_id, segment_id));
+    auto shm_key = ftok(shm_full_path.c_str(), SYSTEMV_SHM_PROJ_ID);
+    if (shm_key != (key_t)-1) {
+      int shm_id = shmget(shm_key, 0, 0644);
+      if (shm_id != -1 && shmctl(shm_id, IPC_RMID, nullptr) != 0) {
+        WHOLEMEMORY_ERROR(
+          "Remove host shared memory of IPC key %d failed, Reason=%s", shm_key, strerror(errno));
+      }
+    }
+    unlink(shm_full_path.c_str());
+#else
+    auto shm_full_path = get_host_memory_full_path(comm_, handle_->handle_id, segment_id);
+    if (shm_unlink(shm_full_path.c_str()) != 0 && errno != ENOENT) {
+      WHOLEMEMORY_ERROR("Remove host shared memory file %s failed, Reason=%s",
+                        shm_full_path.c_str(),
+                        strerror(errno));
+    }
 #endif
+  }
+  // host only communicator may have no CUDA device, memory is not registered.
+  void register_shared_host_segment(const shared_host_segment& segment)
+  {
+    if (is_host_only_communicator(comm_)) return;
     void* dev_ptr = nullptr;
-    WM_CUDA_CHECK_NO_THROW(cudaHostGetDevicePointer(&dev_ptr, mmap_ptr, 0));
-    WHOLEMEMORY_CHECK(dev_ptr == mmap_ptr);
-    shared_host_handle_.shared_host_memory_ptr = dev_ptr;
-    local_partition_memory_pointer_ =
-      static_cast<char*>(dev_ptr) + rank_partition_strategy_.local_mem_offset;
+    WM_CUDA_CHECK(cudaHostRegister(segment.ptr, segment.size, cudaHostRegisterDefault));
+    WM_CUDA_CHECK(cudaHostGetDevicePointer(&dev_ptr, segment.ptr, 0));
+    WHOLEMEMORY_CHECK(dev_ptr == segment.ptr);
+  }
+  void create_and_map_shared_host_memory()
+  {
+    if (max_total_size_ > total_size_) reserve_shared_host_address_space();
+    shared_host_segment segment;
+    if (!create_and_map_shared_host_segment(0, 0, alloc_strategy_.total_alloc_size, &segment)) {
+      if (shared_host_handle_.reserved_ptr != nullptr) {
+        munmap(shared_host_handle_.reserved_ptr, shared_host_handle_.reserved_size);
+        shared_host_handle_.reserved_ptr = nullptr;
+      }
+      WHOLEMEMORY_FAIL("Creating host shared memory of %ld bytes failed.",
+                       alloc_strategy_.total_alloc_size);
+    }
+    shared_host_handle_.segments.push_back(segment);
+    shared_host_handle_.shared_host_memory_ptr = segment.ptr;
+    shared_host_handle_.page_size              = segment.page_size;
+    set_local_partition_numa_policy(segment);
+    zero_fill_local_partition(0, total_size_);
+    register_shared_host_segment(segment);
+    local_partition_memory_pointer_ = static_cast<char*>(get_continuous_mapping_pointer()) +
+                                      rank_partition_strategy_.local_mem_offset;
+  }
+  // maps and initializes memory up to new_total_size, but doesn't change size of the handle. If it
+  // fails on any rank, memory mapped for growing is released on all ranks and false is returned.
+  bool grow_shared_host_memory(size_t new_total_size)
+  {
+    size_t old_total_size = total_size_;
+    auto old_partition    = rank_partition_strategy_;
+    size_t mapped_size    = get_mapped_size();
+    // new size may still fit in the last page of mapped memory.
+    bool map_new_segment = new_total_size > mapped_size;
+    if (map_new_segment) {
+      shared_host_segment segment;
+      if (!create_and_map_shared_host_segment(shared_host_handle_.segments.size(),
+                                              mapped_size,
+                                              new_total_size - mapped_size,
+                                              &segment)) {
+        WHOLEMEMORY_ERROR("Growing host memory to %ld failed, size is kept %ld.",
+                          new_total_size,
+                          old_total_size);
+        return false;
+      }
+      shared_host_handle_.segments.push_back(segment);
+    }
+    bool segment_registered = false;
+    bool success            = all_ranks_succeed([&]() {
+      // local partition of new size is initialized, partition of the handle is restored below.
+      total_size_ = new_total_size;
+      generate_rank_partition_strategy();
+      if (map_new_segment) set_local_partition_numa_policy(shared_host_handle_.segments.back());
+      zero_fill_local_partition(old_total_size, new_total_size);
+      if (map_new_segment) {
+        register_shared_host_segment(shared_host_handle_.segments.back());
+        segment_registered = true;
+      }
+    });
+    total_size_              = old_total_size;
+    rank_partition_strategy_ = old_partition;
+    if (!success) {
+      if (map_new_segment) {
+        unmap_and_destroy_shared_host_segment(shared_host_handle_.segments.size() - 1,
+                                              shared_host_handle_.segments.back(),
+                                              segment_registered);
+        shared_host_handle_.segments.pop_back();
+      }
+      WHOLEMEMORY_ERROR("Growing host memory to %ld failed, size is kept %ld.",
+                        new_total_size,
+                        old_total_size);
+      return false;
+    }
+    return true;
   }
 
+  void unmap_and_destroy_shared_host_segment(size_t segment_id,
+                                             const shared_host_segment& segment,
+                                             bool registered = true)
+  {
+    if (registered && !is_host_only_communicator(comm_)) {
+      WM_CUDA_CHECK(cudaHostUnregister(segment.ptr));
+    }
+    unmap_shared_host_segment(segment);
+    communicator_barrier(comm_);
+    if (comm_->world_rank == 0) destroy_shared_host_segment_storage(segment_id);
+    communicator_barrier(comm_);
+  }
   void unmap_and_destroy_shared_host_memory() noexcept
   {
     try {
-      void* ptr = shared_host_handle_.shared_host_memory_ptr;
-      if (ptr == nullptr) return;
-      WM_CUDA_CHECK(cudaHostUnregister(ptr));
-#ifdef USE_SYSTEMV_SHM
-      std::string shm_full_path = "/tmp/";
-      shm_full_path.append(get_host_memory_full_path(comm_, handle_->handle_id));
-      auto shm_key = ftok(shm_full_path.c_str(), SYSTEMV_SHM_PROJ_ID);
-      WHOLEMEMORY_CHECK(shm_key != (key_t)-1);
-      int shm_id = shmget(shm_key, alloc_strategy_.local_alloc_size, 0644);
-      if (shm_id == -1) {
-        WHOLEMEMORY_FATAL("Get host shared memory from IPC key %d for delete failed, Reason=%s",
-                          shm_key,
-                          strerror(errno));
+      if (shared_host_handle_.shared_host_memory_ptr == nullptr) return;
+      for (size_t i = shared_host_handle_.segments.size(); i > 0; i--) {
+        unmap_and_destroy_shared_host_segment(i - 1, shared_host_handle_.segments[i - 1]);
       }
-      WHOLEMEMORY_CHECK(shmdt(ptr) == 0);
-#else
-      auto shm_full_path = get_host_memory_full_path(comm_, handle_->handle_id);
-      WHOLEMEMORY_CHECK(munmap(ptr, alloc_strategy_.total_alloc_size) == 0);
-#endif
-      communicator_barrier(comm_);
-#ifdef USE_SYSTEMV_SHM
-      if (comm_->world_rank == 0) {
-        WHOLEMEMORY_CHECK(shmctl(shm_id, IPC_RMID, nullptr) == 0);
-        WHOLEMEMORY_CHECK(unlink(shm_full_path.c_str()) == 0);
+      shared_host_handle_.segments.clear();
+      // segments are unmapped back into reserved address space, which is released as a whole.
+      if (shared_host_handle_.reserved_ptr != nullptr) {
+        WHOLEMEMORY_CHECK(
+          munmap(shared_host_handle_.reserved_ptr, shared_host_handle_.reserved_size) == 0);
       }
-#else
-      if (comm_->world_rank == 0) { WHOLEMEMORY_CHECK(shm_unlink(shm_full_path.c_str()) == 0); }
-#endif
-      communicator_barrier(comm_);
+      shared_host_handle_.reserved_ptr           = nullptr;
       shared_host_handle_.shared_host_memory_ptr = nullptr;
     } catch (const wholememory::logic_error& wle) {
       WHOLEMEMORY_FAIL_NOTHROW("%s", wle.what());
@@ -572,9 +1098,207 @@ class global_mapped_host_wholememory_impl : public wholememory_impl {
 
   struct shared_host_handle {
     void* shared_host_memory_ptr = nullptr;
+    // page size of the first segment.
+    size_t page_size = 0;
+    // address space reserved for growable memory, nullptr if not growable.
+    void* reserved_ptr   = nullptr;
+    size_t reserved_size = 0;
+    std::vector<shared_host_segment> segments;
   } shared_host_handle_;
 };
 
+// Implementation for wholememory mapped from files.
+// Each rank maps all files with MAP_SHARED, so ranks on the same node share the same page cache.
+// Files are mapped read only unless WHOLEMEMORY_MF_FILE_WRITE_BACK is set.
+// Nothing is allocated or initialized on creation, pages are loaded from files on first access.
+// for CONTINUOUS type with FILE location
+class file_mapped_wholememory_impl : public wholememory_impl {
+ public:
+  file_mapped_wholememory_impl(wholememory_handle_t wholememory_handle,
+                               size_t total_size,
+                               wholememory_comm_t comm,
+                               wholememory_memory_type_t memory_type,
+                               wholememory_memory_location_t memory_location,
+                               size_t data_granularity,
+                               const std::vector<std::string>& file_names)
+    : wholememory_impl(
+        wholememory_handle, total_size, comm, memory_type, memory_location, data_granularity),
+      file_names_(file_names)
+  {
+    WHOLEMEMORY_CHECK(type_ == WHOLEMEMORY_MT_CONTINUOUS);
+    WHOLEMEMORY_CHECK(location_ == WHOLEMEMORY_ML_FILE);
+  }
+  void create_memory() override
+  {
+    generate_rank_partition_strategy();
+    map_files();
+    register_file_memory();
+  }
+  void destroy_memory() noexcept override
+  {
+    unregister_file_memory();
+    unmap_files();
+  }
+  [[nodiscard]] void* get_continuous_mapping_pointer() const noexcept override
+  {
+    return file_mapped_handle_.mapped_memory_ptr;
+  }
+  [[nodiscard]] wholememory_gref_t get_global_reference() const noexcept override
+  {
+    wholememory_gref_t gref{};
+    gref.pointer = get_continuous_mapping_pointer();
+    gref.stride  = 0;
+    return gref;
+  }
+  [[nodiscard]] bool is_writable() const override { return file_mapped_handle_.writable; }
+  bool contains_pointer(const void* ptr) const override
+  {
+    uint64_t int_ptr       = reinterpret_cast<uint64_t>(ptr);
+    uint64_t int_start_ptr = reinterpret_cast<uint64_t>(file_mapped_handle_.mapped_memory_ptr);
+    return int_ptr >= int_start_ptr && int_ptr < int_start_ptr + total_size_;
+  }
+  bool get_rank_memory(void** rank_memory_ptr,
+                       size_t* rank_memory_size,
+                       size_t* rank_memory_offset,
+                       int rank) const noexcept override
+  {
+    size_t mem_size, mem_start;
+    get_rank_partition_info(&mem_size, &mem_start, rank);
+    if (rank_memory_ptr != nullptr)
+      *rank_memory_ptr = (char*)get_continuous_mapping_pointer() + mem_start;
+    if (rank_memory_size != nullptr) *rank_memory_size = mem_size;
+    if (rank_memory_offset != nullptr) *rank_memory_offset = mem_start;
+    return true;
+  }
+
+ protected:
+  void register_file_memory()
+  {
+    std::unique_lock<std::mutex> vma_lock(wholememory_vma_mu);
+    register_wholememory_vma_range_locked(
+      file_mapped_handle_.mapped_memory_ptr, total_size_, handle_);
+  }
+  void unregister_file_memory() noexcept
+  {
+    std::unique_lock<std::mutex> vma_lock(wholememory_vma_mu);
+    unregister_wholememory_vma_range_locked(
+      file_mapped_handle_.mapped_memory_ptr, total_size_, handle_);
+  }
+  void map_files()
+  {
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    // reserve continuous virtual address range, then map files into it one by one.
+    alloc_strategy_.total_alloc_size = round_up_unsafe(total_size_, page_size);
+    alloc_strategy_.local_alloc_size = 0;
+    alloc_strategy_.alignment        = page_size;
+    void* reserved_ptr               = mmap(nullptr,
+                                alloc_strategy_.total_alloc_size,
+                                PROT_NONE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                                -1,
+                                0);
+    WHOLEMEMORY_CHECK(reserved_ptr != MAP_FAILED);
+    file_mapped_handle_.mapped_memory_ptr = reserved_ptr;
+    file_mapped_handle_.registered        = false;
+
+    // files already mapped are covered by the reserved range, unmapping it releases all.
+    try {
+      // source files are not modified unless write back is explicitly requested.
+      bool writable                = (malloc_flags_ & WHOLEMEMORY_MF_FILE_WRITE_BACK) != 0;
+      file_mapped_handle_.writable = writable;
+      int prot                     = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+      size_t map_offset            = 0;
+      for (size_t i = 0; i < file_names_.size(); i++) {
+        const char* file_name = file_names_[i].c_str();
+        int fd                = open(file_name, writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+          WHOLEMEMORY_FAIL(
+            "Open file %s for mapping failed, Reason=%s", file_name, strerror(errno));
+        }
+        struct stat file_stat {};
+        if (fstat(fd, &file_stat) != 0) {
+          close(fd);
+          WHOLEMEMORY_FAIL("Stat file %s failed, Reason=%s", file_name, strerror(errno));
+        }
+        size_t file_size = file_stat.st_size;
+        if (i + 1 != file_names_.size() && file_size % page_size != 0) {
+          close(fd);
+          WHOLEMEMORY_FAIL("File %s size=%ld is not multiple of page size %ld.",
+                           file_name,
+                           file_size,
+                           page_size);
+        }
+        if (file_size > 0) {
+          void* mapped_ptr = mmap(static_cast<char*>(reserved_ptr) + map_offset,
+                                  file_size,
+                                  prot,
+                                  MAP_SHARED | MAP_FIXED,
+                                  fd,
+                                  0);
+          if (mapped_ptr == MAP_FAILED) {
+            close(fd);
+            WHOLEMEMORY_FAIL("Map file %s failed, Reason=%s", file_name, strerror(errno));
+          }
+        }
+        WHOLEMEMORY_CHECK(close(fd) == 0);
+        map_offset += file_size;
+      }
+      WHOLEMEMORY_CHECK(map_offset == total_size_);
+
+      // If GPU can access pageable memory, pages are loaded on access from GPU too. Otherwise
+      // memory need to be registered, which loads all pages on creation.
+      if (!is_host_only_communicator(comm_) && !DevAttrPagebleMemoryAccess()) {
+        WHOLEMEMORY_INFO(
+          "Device can't access pageable memory, registering %ld bytes mapped from files.",
+          total_size_);
+        unsigned int flags = writable ? cudaHostRegisterDefault : cudaHostRegisterReadOnly;
+        WM_CUDA_CHECK(cudaHostRegister(reserved_ptr, total_size_, flags));
+        file_mapped_handle_.registered = true;
+        void* dev_ptr                  = nullptr;
+        WM_CUDA_CHECK(cudaHostGetDevicePointer(&dev_ptr, reserved_ptr, 0));
+        WHOLEMEMORY_CHECK(dev_ptr == reserved_ptr);
+      }
+    } catch (...) {
+      if (file_mapped_handle_.registered) {
+        WM_CUDA_CHECK_NO_THROW(cudaHostUnregister(reserved_ptr));
+      }
+      munmap(reserved_ptr, alloc_strategy_.total_alloc_size);
+      file_mapped_handle_.mapped_memory_ptr = nullptr;
+      file_mapped_handle_.registered        = false;
+      throw;
+    }
+    local_partition_memory_pointer_ =
+      static_cast<char*>(reserved_ptr) + rank_partition_strategy_.local_mem_offset;
+  }
+
+  void unmap_files() noexcept
+  {
+    try {
+      void* ptr = file_mapped_handle_.mapped_memory_ptr;
+      if (ptr == nullptr) return;
+      if (file_mapped_handle_.registered) { WM_CUDA_CHECK(cudaHostUnregister(ptr)); }
+      if (file_mapped_handle_.writable) {
+        WHOLEMEMORY_CHECK(msync(ptr, total_size_, MS_SYNC) == 0);
+      }
+      WHOLEMEMORY_CHECK(munmap(ptr, alloc_strategy_.total_alloc_size) == 0);
+      file_mapped_handle_.mapped_memory_ptr = nullptr;
+    } catch (const wholememory::logic_error& wle) {
+      WHOLEMEMORY_FAIL_NOTHROW("%s", wle.what());
+    } catch (const wholememory::cuda_error& wce) {
+      WHOLEMEMORY_FAIL_NOTHROW("%s", wce.what());
+    } catch (const raft::exception& re) {
+      WHOLEMEMORY_FAIL_NOTHROW("%s", re.what());
+    }
+  }
+
+  std::vector<std::string> file_names_;
+  struct file_mapped_handle {
+    void* mapped_memory_ptr = nullptr;
+    bool writable           = false;
+    bool registered         = false;
+  } file_mapped_handle_;
+};
+
 // Implementation for continuous device wholememory that need global map.
 // Each rank allocate multiple pages and share pages with other ranks.
 // for CONTINUOUS type with DEVICE location
@@ -594,8 +1318,9 @@ class continuous_device_wholememory_impl : public wholememory_impl {
   void create_memory() override
   {
     WHOLEMEMORY_CHECK(location_ == WHOLEMEMORY_ML_DEVICE);
-    each_rank_multiple_page_strategy();
+    // page allocation of growable memory follows partition.
     generate_rank_partition_strategy();
+    each_rank_multiple_page_strategy();
     create_and_map_driver_device_memory();
     register_continuous_device_memory();
   }
@@ -604,6 +1329,50 @@ class continuous_device_wholememory_impl : public wholememory_impl {
     unregister_continuous_device_memory();
     unmap_and_destroy_driver_device_memory();
   }
+  bool grow_memory(size_t new_total_size) override
+  {
+    size_t mapped_size = alloc_strategy_.total_alloc_size;
+    for (const auto& extent : grown_extents_) {
+      mapped_size += extent.strategy.total_alloc_size;
+    }
+    size_t new_mapped_size = round_up_unsafe(new_total_size, alloc_strategy_.alignment);
+    if (new_mapped_size > mapped_size) {
+      grown_extent extent;
+      each_rank_partition_page_strategy(
+        &extent.strategy, mapped_size, new_mapped_size, alloc_strategy_.alignment);
+      // handle is only changed after pages are allocated on all ranks.
+      bool success = all_ranks_succeed([&]() {
+        if (extent.strategy.local_alloc_size > 0) {
+          extent.local_cu_handle = create_cu_mem(extent.strategy.local_alloc_size, comm_->dev_id);
+        }
+      });
+      if (!success) {
+        if (extent.local_cu_handle != 0) { WM_CU_CHECK(cuMemRelease(extent.local_cu_handle)); }
+        WHOLEMEMORY_ERROR("Growing device memory to %ld failed, size is kept %ld.",
+                          new_total_size,
+                          total_size_);
+        return false;
+      }
+      map_driver_device_extent(extent.strategy, extent.local_cu_handle, &extent.all_cu_handles);
+      grown_extents_.push_back(std::move(extent));
+    }
+    communicator_barrier(comm_);
+    unregister_continuous_device_memory();
+    total_size_ = new_total_size;
+    generate_rank_partition_strategy();
+    local_partition_memory_pointer_ = static_cast<char*>(cu_alloc_handle_.mapped_whole_memory) +
+                                      rank_partition_strategy_.local_mem_offset;
+    register_continuous_device_memory();
+    return true;
+  }
+  [[nodiscard]] size_t get_local_allocated_size() const override
+  {
+    size_t allocated_size = alloc_strategy_.local_alloc_size;
+    for (const auto& extent : grown_extents_) {
+      allocated_size += extent.strategy.local_alloc_size;
+    }
+    return allocated_size;
+  }
   [[nodiscard]] void* get_continuous_mapping_pointer() const noexcept override
   {
     return cu_alloc_handle_.mapped_whole_memory;
@@ -854,7 +1623,8 @@ class continuous_device_wholememory_impl : public wholememory_impl {
 
   void exchange_driver_device_memory_handles(
     std::vector<ipc_sharable_cu_handle>* recv_ipc_sharable_cu_handles,
-    std::vector<ipc_sharable_cu_handle>* send_ipc_sharable_cu_handles)
+    std::vector<ipc_sharable_cu_handle>* send_ipc_sharable_cu_handles,
+    const alloc_strategy& strategy)
   {
     for (int r = 0; r < comm_->world_size; r++) {
       if ((*send_ipc_sharable_cu_handles)[r].fd >= 0) {
@@ -866,7 +1636,7 @@ class continuous_device_wholememory_impl : public wholememory_impl {
     communicator_barrier(comm_);
     recv_ipc_sharable_cu_handles->resize(comm_->world_size);
     for (int r = 0; r < comm_->world_size; r++) {
-      if (alloc_strategy_.alloc_sizes[r] > 0) {
+      if (strategy.alloc_sizes[r] > 0) {
         (*recv_ipc_sharable_cu_handles)[r] = ipc_recv_sharable_handle(cu_alloc_handle_.recv_fds[r]);
       }
     }
@@ -884,22 +1654,24 @@ class continuous_device_wholememory_impl : public wholememory_impl {
       &h, (void*)(uintptr_t)sharable_cu_handle.fd, CU_MEM_HANDLE_TYPE_POSIX_FILE_DESCRIPTOR));
     return h;
   }
+  // maps memory of all ranks in strategy, which covers total_alloc_size bytes from first offset.
   void map_driver_device_memory_handles(
-    std::vector<ipc_sharable_cu_handle>* recv_ipc_sharable_cu_handles)
+    std::vector<ipc_sharable_cu_handle>* recv_ipc_sharable_cu_handles,
+    const alloc_strategy& strategy,
+    std::vector<CUmemGenericAllocationHandle>* all_cu_handles)
   {
-    cu_alloc_handle_.all_cu_handles.resize(comm_->world_size);
+    all_cu_handles->resize(comm_->world_size);
     for (int i = 0; i < comm_->world_size; i++) {
-      size_t mem_size = alloc_strategy_.alloc_sizes[i];
+      size_t mem_size = strategy.alloc_sizes[i];
       if (mem_size > 0) {
         WHOLEMEMORY_CHECK((*recv_ipc_sharable_cu_handles)[i].fd >= 0);
-        cu_alloc_handle_.all_cu_handles[i] =
-          import_cu_mem_handle((*recv_ipc_sharable_cu_handles)[i]);
+        (*all_cu_handles)[i] = import_cu_mem_handle((*recv_ipc_sharable_cu_handles)[i]);
 
         WM_CU_CHECK(cuMemMap(reinterpret_cast<CUdeviceptr>(cu_alloc_handle_.mapped_whole_memory) +
-                               alloc_strategy_.alloc_offsets[i],
+                               strategy.alloc_offsets[i],
                              mem_size,
                              0,
-                             cu_alloc_handle_.all_cu_handles[i],
+                             (*all_cu_handles)[i],
                              0));
         WHOLEMEMORY_CHECK(close((*recv_ipc_sharable_cu_handles)[i].fd) == 0);
       } else {
@@ -911,36 +1683,74 @@ class continuous_device_wholememory_impl : public wholememory_impl {
     madesc.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
     madesc.location.id   = comm_->dev_id;
     madesc.flags         = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
-    WM_CU_CHECK(cuMemSetAccess(reinterpret_cast<CUdeviceptr>(cu_alloc_handle_.mapped_whole_memory),
-                               alloc_strategy_.total_alloc_size,
+    WM_CU_CHECK(cuMemSetAccess(reinterpret_cast<CUdeviceptr>(cu_alloc_handle_.mapped_whole_memory) +
+                                 strategy.alloc_offsets[0],
+                               strategy.total_alloc_size,
                                &madesc,
                                1));
   }
-  void create_and_map_driver_device_memory()
+  void create_and_map_driver_device_extent(
+    const alloc_strategy& strategy,
+    CUmemGenericAllocationHandle* local_cu_handle,
+    std::vector<CUmemGenericAllocationHandle>* all_cu_handles)
   {
-    WM_CU_CHECK(
-      cuMemAddressReserve(reinterpret_cast<CUdeviceptr*>(&cu_alloc_handle_.mapped_whole_memory),
-                          alloc_strategy_.total_alloc_size,
-                          alloc_strategy_.alignment,
-                          0,
-                          0));
-    cu_alloc_handle_.all_cu_handles.resize(comm_->world_size, 0);
+    *local_cu_handle = 0;
+    if (strategy.local_alloc_size > 0) {
+      *local_cu_handle = create_cu_mem(strategy.local_alloc_size, comm_->dev_id);
+    }
+    map_driver_device_extent(strategy, *local_cu_handle, all_cu_handles);
+  }
+  // maps pages of all ranks in strategy, local_cu_handle is pages allocated by current rank.
+  void map_driver_device_extent(const alloc_strategy& strategy,
+                                CUmemGenericAllocationHandle local_cu_handle,
+                                std::vector<CUmemGenericAllocationHandle>* all_cu_handles)
+  {
+    all_cu_handles->resize(comm_->world_size, 0);
     std::vector<ipc_sharable_cu_handle> send_ipc_sharable_cu_handles(comm_->world_size);
     std::vector<ipc_sharable_cu_handle> recv_ipc_sharable_cu_handles;
-    cu_alloc_handle_.local_cu_handle = 0;
-    if (alloc_strategy_.local_alloc_size > 0) {
-      cu_alloc_handle_.local_cu_handle =
-        create_cu_mem(alloc_strategy_.local_alloc_size, comm_->dev_id);
-    }
-    cu_alloc_handle_.local_ipc_handle = create_sharable_handle(cu_alloc_handle_.local_cu_handle);
+    cu_alloc_handle_.local_ipc_handle = create_sharable_handle(local_cu_handle);
     for (int i = 0; i < comm_->world_size; i++) {
       send_ipc_sharable_cu_handles[i] = cu_alloc_handle_.local_ipc_handle;
     }
     open_unix_domain_sockets();
-    exchange_driver_device_memory_handles(&recv_ipc_sharable_cu_handles,
-                                          &send_ipc_sharable_cu_handles);
+    exchange_driver_device_memory_handles(
+      &recv_ipc_sharable_cu_handles, &send_ipc_sharable_cu_handles, strategy);
     close_unix_domain_sockets();
-    map_driver_device_memory_handles(&recv_ipc_sharable_cu_handles);
+    map_driver_device_memory_handles(&recv_ipc_sharable_cu_handles, strategy, all_cu_handles);
+  }
+  void unmap_and_release_driver_device_extent(
+    const alloc_strategy& strategy,
+    CUmemGenericAllocationHandle local_cu_handle,
+    const std::vector<CUmemGenericAllocationHandle>& all_cu_handles)
+  {
+    communicator_barrier(comm_);
+    for (int i = 0; i < comm_->world_size; i++) {
+      size_t mem_size = strategy.alloc_sizes[i];
+      if (mem_size > 0) {
+        WM_CU_CHECK(cuMemUnmap(reinterpret_cast<CUdeviceptr>(cu_alloc_handle_.mapped_whole_memory) +
+                                 strategy.alloc_offsets[i],
+                               mem_size));
+        WM_CU_CHECK(cuMemRelease(all_cu_handles[i]));
+      }
+    }
+    communicator_barrier(comm_);
+    if (strategy.local_alloc_size > 0) { WM_CU_CHECK(cuMemRelease(local_cu_handle)); }
+  }
+  // address space is reserved for max_total_size_ so that memory can grow in place.
+  [[nodiscard]] size_t get_reserved_size() const
+  {
+    return round_up_unsafe(max_total_size_, alloc_strategy_.alignment);
+  }
+  void create_and_map_driver_device_memory()
+  {
+    WM_CU_CHECK(
+      cuMemAddressReserve(reinterpret_cast<CUdeviceptr*>(&cu_alloc_handle_.mapped_whole_memory),
+                          get_reserved_size(),
+                          alloc_strategy_.alignment,
+                          0,
+                          0));
+    create_and_map_driver_device_extent(
+      alloc_strategy_, &cu_alloc_handle_.local_cu_handle, &cu_alloc_handle_.all_cu_handles);
     communicator_barrier(comm_);
     local_partition_memory_pointer_ = static_cast<char*>(cu_alloc_handle_.mapped_whole_memory) +
                                       rank_partition_strategy_.local_mem_offset;
@@ -948,24 +1758,16 @@ class continuous_device_wholememory_impl : public wholememory_impl {
   void unmap_and_destroy_driver_device_memory() noexcept
   {
     try {
-      communicator_barrier(comm_);
-      for (int i = 0; i < comm_->world_size; i++) {
-        size_t mem_size = alloc_strategy_.alloc_sizes[i];
-        if (mem_size > 0) {
-          WM_CU_CHECK(
-            cuMemUnmap(reinterpret_cast<CUdeviceptr>(cu_alloc_handle_.mapped_whole_memory) +
-                         alloc_strategy_.alloc_offsets[i],
-                       mem_size));
-          WM_CU_CHECK(cuMemRelease(cu_alloc_handle_.all_cu_handles[i]));
-        }
-      }
-      communicator_barrier(comm_);
-      if (alloc_strategy_.local_alloc_size > 0) {
-        WM_CU_CHECK(cuMemRelease(cu_alloc_handle_.local_cu_handle));
+      for (auto it = grown_extents_.rbegin(); it != grown_extents_.rend(); ++it) {
+        unmap_and_release_driver_device_extent(
+          it->strategy, it->local_cu_handle, it->all_cu_handles);
       }
+      grown_extents_.clear();
+      unmap_and_release_driver_device_extent(
+        alloc_strategy_, cu_alloc_handle_.local_cu_handle, cu_alloc_handle_.all_cu_handles);
       WM_CU_CHECK(
         cuMemAddressFree(reinterpret_cast<CUdeviceptr>(cu_alloc_handle_.mapped_whole_memory),
-                         alloc_strategy_.total_alloc_size));
+                         get_reserved_size()));
 
       communicator_barrier(comm_);
     } catch (const wholememory::cu_error& wce) {
@@ -975,6 +1777,14 @@ class continuous_device_wholememory_impl : public wholememory_impl {
     }
   }
 
+  // memory mapped after the initial allocation, one for each growing.
+  struct grown_extent {
+    alloc_strategy strategy;
+    CUmemGenericAllocationHandle local_cu_handle = 0;
+    std::vector<CUmemGenericAllocationHandle> all_cu_handles;
+  };
+  std::vector<grown_extent> grown_extents_;
+
   struct cu_alloc_handle {
     CUmemGenericAllocationHandle local_cu_handle = 0;
     std::vector<CUmemGenericAllocationHandle> all_cu_handles;
@@ -1495,8 +2305,10 @@ class continuous_mnnvl_wholememory_impl : public continuous_device_wholememory_i
 
 void wholememory_impl::generate_rank_partition_strategy()
 {
-  size_t data_slot_count      = total_size_ / data_granularity_;
-  size_t data_slot_per_rank   = determine_entry_partition_plan(data_slot_count, comm_->world_size);
+  // partition plan of growable memory is for max_total_size_, so it is not changed after growing.
+  size_t data_slot_count = total_size_ / data_granularity_;
+  size_t data_slot_per_rank =
+    determine_entry_partition_plan(max_total_size_ / data_granularity_, comm_->world_size);
   size_t rank_data_slot_start = std::min(comm_->world_rank * data_slot_per_rank, data_slot_count);
   size_t rank_data_slot_end =
     std::min((comm_->world_rank + 1) * data_slot_per_rank, data_slot_count);
@@ -1551,7 +2363,12 @@ void wholememory_impl::each_rank_same_chunk_strategy()
 void wholememory_impl::each_rank_multiple_page_strategy()
 {
   size_t page_size = comm_->alloc_granularity;
-  if (total_size_ >= HUGE_PAGE_THRESHOLD) page_size = HUGE_PAGE_SIZE;
+  if (max_total_size_ >= HUGE_PAGE_THRESHOLD) page_size = HUGE_PAGE_SIZE;
+  if (max_total_size_ > total_size_) {
+    each_rank_partition_page_strategy(
+      &alloc_strategy_, 0, round_up_unsafe(total_size_, page_size), page_size);
+    return;
+  }
   alloc_strategy_.alignment        = page_size;
   alloc_strategy_.total_alloc_size = round_up_unsafe(total_size_, page_size);
   size_t total_alloc_page_count    = alloc_strategy_.total_alloc_size / page_size;
@@ -1570,6 +2387,68 @@ void wholememory_impl::each_rank_multiple_page_strategy()
   }
 }
 
+void wholememory_impl::each_rank_partition_page_strategy(alloc_strategy* strategy,
+                                                         size_t start_offset,
+                                                         size_t end_offset,
+                                                         size_t page_size) const
+{
+  size_t stride = rank_partition_strategy_.partition_mem_stride;
+  // page is allocated by the rank whose partition contains start of the page.
+  auto rank_alloc_start = [&](int rank) {
+    if (rank == 0) return start_offset;
+    if (rank == comm_->world_size) return end_offset;
+    return std::clamp(round_up_unsafe(rank * stride, page_size), start_offset, end_offset);
+  };
+  strategy->alignment        = page_size;
+  strategy->total_alloc_size = end_offset - start_offset;
+  strategy->alloc_offsets.resize(comm_->world_size, 0);
+  strategy->alloc_sizes.resize(comm_->world_size, 0);
+  for (int i = 0; i < comm_->world_size; i++) {
+    strategy->alloc_offsets[i] = rank_alloc_start(i);
+    strategy->alloc_sizes[i]   = rank_alloc_start(i + 1) - rank_alloc_start(i);
+  }
+  strategy->local_alloc_size = strategy->alloc_sizes[comm_->world_rank];
+}
+
+memory_usage_category wholememory_impl::get_memory_usage_category() const
+{
+  memory_usage_category category{WHOLEMEMORY_MA_DEVICE, type_, purpose_};
+  if (location_ != WHOLEMEMORY_ML_DEVICE) {
+    // host memory of host only communicator is not registered to CUDA.
+    bool pinned = location_ == WHOLEMEMORY_ML_HOST && !is_host_only_communicator(comm_);
+    category.allocation_type = pinned ? WHOLEMEMORY_MA_PINNED : WHOLEMEMORY_MA_HOST;
+  }
+  return category;
+}
+
+void wholememory_impl::update_memory_usage()
+{
+  size_t const allocated_size = get_local_allocated_size();
+  if (memory_usage_.live_count == 0) {
+    record_memory_alloc(get_memory_usage_category(), allocated_size);
+    memory_usage_.live_count = 1;
+  } else if (allocated_size > memory_usage_.live_bytes) {
+    record_memory_grow(get_memory_usage_category(), allocated_size - memory_usage_.live_bytes);
+  } else {
+    return;
+  }
+  memory_usage_.live_bytes = allocated_size;
+  memory_usage_.peak_bytes = std::max(memory_usage_.peak_bytes, allocated_size);
+  memory_usage_.alloc_count++;
+}
+
+void wholememory_impl::release_memory_usage() noexcept
+{
+  try {
+    if (memory_usage_.live_count == 0) return;
+    record_memory_free(get_memory_usage_category(), memory_usage_.live_bytes);
+    memory_usage_.live_bytes = 0;
+    memory_usage_.live_count = 0;
+  } catch (const wholememory::logic_error& wle) {
+    WHOLEMEMORY_FAIL_NOTHROW("%s", wle.what());
+  }
+}
+
 int negotiate_handle_id_with_comm_locked(wholememory_comm_t wm_comm)
 {
   WM_COMM_CHECK_ALL_SAME(wm_comm, WM_MEM_OP_EXCHANGE_ID);
@@ -1601,34 +2480,71 @@ struct wholememory_create_param {
   wholememory_create_param(size_t ts,
                            wholememory_memory_type_t mt,
                            wholememory_memory_location_t ml,
-                           size_t mg)
+                           size_t mg,
+                           unsigned int mf,
+                           size_t mts)
   {
     total_size      = ts;
     memory_type     = mt;
     memory_location = ml;
     min_granularity = mg;
+    malloc_flags    = mf;
+    max_total_size  = mts;
   }
   bool operator==(const wholememory_create_param& rhs) const
   {
     return total_size == rhs.total_size && memory_type == rhs.memory_type &&
-           memory_location == rhs.memory_location && min_granularity == rhs.min_granularity;
+           memory_location == rhs.memory_location && min_granularity == rhs.min_granularity &&
+           malloc_flags == rhs.malloc_flags && max_total_size == rhs.max_total_size;
   }
   bool operator!=(const wholememory_create_param& rhs) const { return !(*this == rhs); }
   size_t total_size;
   wholememory_memory_type_t memory_type;
   wholememory_memory_location_t memory_location;
   size_t min_granularity;
+  unsigned int malloc_flags;
+  size_t max_total_size;
 };
 
-wholememory_error_code_t create_wholememory(wholememory_handle_t* wholememory_handle_ptr,
-                                            size_t total_size,
-                                            wholememory_comm_t comm,
-                                            wholememory_memory_type_t memory_type,
-                                            wholememory_memory_location_t memory_location,
-                                            size_t data_granularity) noexcept
+// max_total_size of growable device memory is at most this times total_size.
+static constexpr size_t MAX_DEVICE_GROW_RATIO = 2;
+
+static wholememory_error_code_t create_wholememory_impl(
+  wholememory_handle_t* wholememory_handle_ptr,
+  size_t total_size,
+  wholememory_comm_t comm,
+  wholememory_memory_type_t memory_type,
+  wholememory_memory_location_t memory_location,
+  size_t data_granularity,
+  unsigned int malloc_flags,
+  size_t max_total_size,
+  const std::vector<std::string>& file_names) noexcept
 {
   try {
     if (total_size % data_granularity != 0) return WHOLEMEMORY_INVALID_VALUE;
+    if (max_total_size < total_size || max_total_size % data_granularity != 0) {
+      return WHOLEMEMORY_INVALID_VALUE;
+    }
+    if (max_total_size > total_size &&
+        (memory_type != WHOLEMEMORY_MT_CONTINUOUS || memory_location == WHOLEMEMORY_ML_FILE ||
+         !is_intranode_communicator(comm))) {
+      WHOLEMEMORY_ERROR("Only intra-node CONTINUOUS host or device WholeMemory can grow.");
+      return WHOLEMEMORY_NOT_SUPPORTED;
+    }
+    // device pages follow the partition plan of max_total_size, so ranks holding data carry
+    // max_total_size / total_size times the balanced load until the memory grows.
+    if (memory_location == WHOLEMEMORY_ML_DEVICE &&
+        max_total_size > MAX_DEVICE_GROW_RATIO * total_size) {
+      WHOLEMEMORY_ERROR("Device WholeMemory can grow to at most %ld times of %ld, got %ld.",
+                        MAX_DEVICE_GROW_RATIO,
+                        total_size,
+                        max_total_size);
+      return WHOLEMEMORY_NOT_SUPPORTED;
+    }
+    if ((memory_location == WHOLEMEMORY_ML_FILE) == file_names.empty()) {
+      WHOLEMEMORY_ERROR("WHOLEMEMORY_ML_FILE should and should only be created from files.");
+      return WHOLEMEMORY_INVALID_INPUT;
+    }
 
     *wholememory_handle_ptr = nullptr;
     std::unique_lock<std::mutex> mlock(comm->mu);
@@ -1636,10 +2552,20 @@ wholememory_error_code_t create_wholememory(wholememory_handle_t* wholememory_ha
 
     whole_memory_handle->handle_id = negotiate_handle_id_with_comm_locked(comm);
     WM_COMM_CHECK_ALL_SAME(comm, WM_MEM_OP_CREATE);
-    wholememory_create_param wcp(total_size, memory_type, memory_location, data_granularity);
+    wholememory_create_param wcp(
+      total_size, memory_type, memory_location, data_granularity, malloc_flags, max_total_size);
     WM_COMM_CHECK_ALL_SAME(comm, wcp);
 
-    if (memory_type == WHOLEMEMORY_MT_DISTRIBUTED) {
+    if (memory_location == WHOLEMEMORY_ML_FILE) {
+      WHOLEMEMORY_CHECK_NOTHROW(memory_type == WHOLEMEMORY_MT_CONTINUOUS);
+      whole_memory_handle->impl = new file_mapped_wholememory_impl(whole_memory_handle,
+                                                                   total_size,
+                                                                   comm,
+                                                                   memory_type,
+                                                                   memory_location,
+                                                                   data_granularity,
+                                                                   file_names);
+    } else if (memory_type == WHOLEMEMORY_MT_DISTRIBUTED) {
 #ifdef WITH_NVSHMEM_SUPPORT
       if (comm->bind_to_nvshmem) {
         whole_memory_handle->impl = new nvshmem_device_wholememory_impl(
@@ -1681,7 +2607,11 @@ wholememory_error_code_t create_wholememory(wholememory_handle_t* wholememory_ha
                         (int)memory_type,
                         (int)memory_location);
     }
+    whole_memory_handle->impl->set_malloc_flags(malloc_flags);
+    whole_memory_handle->impl->set_max_total_size(max_total_size);
+    whole_memory_handle->impl->set_purpose(get_current_memory_purpose());
     whole_memory_handle->impl->create_memory();
+    whole_memory_handle->impl->update_memory_usage();
 
     comm->wholememory_map.insert(
       std::pair<int, wholememory_handle_t>(whole_memory_handle->handle_id, whole_memory_handle));
@@ -1701,6 +2631,116 @@ wholememory_error_code_t create_wholememory(wholememory_handle_t* wholememory_ha
   }
 }
 
+wholememory_error_code_t create_wholememory(wholememory_handle_t* wholememory_handle_ptr,
+                                            size_t total_size,
+                                            wholememory_comm_t comm,
+                                            wholememory_memory_type_t memory_type,
+                                            wholememory_memory_location_t memory_location,
+                                            size_t data_granularity,
+                                            unsigned int malloc_flags,
+                                            size_t max_total_size) noexcept
+{
+  if ((malloc_flags & ~static_cast<unsigned int>(WHOLEMEMORY_MF_NO_ZERO_INIT)) != 0) {
+    WHOLEMEMORY_ERROR("unknown malloc flags 0x%x", malloc_flags);
+    return WHOLEMEMORY_INVALID_VALUE;
+  }
+  // 0 means not growable.
+  if (max_total_size == 0) max_total_size = total_size;
+  return create_wholememory_impl(wholememory_handle_ptr,
+                                 total_size,
+                                 comm,
+                                 memory_type,
+                                 memory_location,
+                                 data_granularity,
+                                 malloc_flags,
+                                 max_total_size,
+                                 std::vector<std::string>());
+}
+
+wholememory_error_code_t create_file_mapped_wholememory(
+  wholememory_handle_t* wholememory_handle_ptr,
+  wholememory_comm_t comm,
+  wholememory_memory_type_t memory_type,
+  size_t data_granularity,
+  const char** file_names,
+  int file_count,
+  unsigned int malloc_flags) noexcept
+{
+  if (file_count <= 0 || file_count >= 65536 || file_names == nullptr) {
+    WHOLEMEMORY_ERROR("input file count=%d", file_count);
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if ((malloc_flags & ~static_cast<unsigned int>(WHOLEMEMORY_MF_FILE_WRITE_BACK)) != 0) {
+    WHOLEMEMORY_ERROR("unknown or unsupported malloc flags 0x%x for file mapping", malloc_flags);
+    return WHOLEMEMORY_INVALID_VALUE;
+  }
+  std::vector<std::string> file_name_vec;
+  size_t total_size = 0;
+  for (int i = 0; i < file_count; i++) {
+    if (file_names[i] == nullptr) {
+      WHOLEMEMORY_ERROR("input file %d of %d is nullptr.", i, file_count);
+      return WHOLEMEMORY_INVALID_INPUT;
+    }
+    struct stat file_stat {};
+    if (stat(file_names[i], &file_stat) < 0) {
+      WHOLEMEMORY_ERROR("input_file[%d] of %d (%s) stat failed, Reason=%s",
+                        i,
+                        file_count,
+                        file_names[i],
+                        strerror(errno));
+      return WHOLEMEMORY_INVALID_INPUT;
+    }
+    total_size += file_stat.st_size;
+    file_name_vec.emplace_back(file_names[i]);
+  }
+  if (total_size == 0) {
+    WHOLEMEMORY_ERROR("all %d input files are empty.", file_count);
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  return create_wholememory_impl(wholememory_handle_ptr,
+                                 total_size,
+                                 comm,
+                                 memory_type,
+                                 WHOLEMEMORY_ML_FILE,
+                                 data_granularity,
+                                 malloc_flags,
+                                 total_size,
+                                 file_name_vec);
+}
+
+wholememory_error_code_t grow_wholememory(wholememory_handle_t wholememory_handle,
+                                          size_t new_total_size) noexcept
+{
+  try {
+    if (wholememory_handle == nullptr || wholememory_handle->impl == nullptr) {
+      return WHOLEMEMORY_INVALID_INPUT;
+    }
+    auto* impl = wholememory_handle->impl;
+    if (new_total_size % impl->data_granularity() != 0 || new_total_size > impl->max_total_size()) {
+      return WHOLEMEMORY_INVALID_VALUE;
+    }
+    if (new_total_size <= impl->total_size()) return WHOLEMEMORY_SUCCESS;
+    auto* comm = impl->get_comm();
+    std::unique_lock<std::mutex> mlock(comm->mu);
+    WM_COMM_CHECK_ALL_SAME(comm, WM_MEM_OP_GROW);
+    WM_COMM_CHECK_ALL_SAME(comm, wholememory_handle->handle_id);
+    WM_COMM_CHECK_ALL_SAME(comm, new_total_size);
+    if (!impl->grow_memory(new_total_size)) return WHOLEMEMORY_OUT_OF_MEMORY;
+    impl->update_memory_usage();
+    return WHOLEMEMORY_SUCCESS;
+  } catch (const wholememory::cuda_error& wce) {
+    WHOLEMEMORY_FAIL_NOTHROW("%s", wce.what());
+  } catch (const wholememory::cu_error& wce) {
+    WHOLEMEMORY_FAIL_NOTHROW("%s", wce.what());
+  } catch (const wholememory::logic_error& wle) {
+    WHOLEMEMORY_FAIL_NOTHROW("%s", wle.what());
+  } catch (const raft::exception& re) {
+    WHOLEMEMORY_FAIL_NOTHROW("%s", re.what());
+  } catch (...) {
+    WHOLEMEMORY_FAIL_NOTHROW("Unknown exception.");
+  }
+}
+
 wholememory_error_code_t destroy_wholememory_with_comm_locked(
   wholememory_handle_t wholememory_handle) noexcept
 {
@@ -1772,6 +2812,31 @@ size_t get_total_size(wholememory_handle_t wholememory_handle) noexcept
   return wholememory_handle->impl->total_size();
 }
 
+size_t get_max_total_size(wholememory_handle_t wholememory_handle) noexcept
+{
+  return wholememory_handle->impl->max_total_size();
+}
+
+bool is_writable(wholememory_handle_t wholememory_handle) noexcept
+{
+  return wholememory_handle->impl->is_writable();
+}
+
+wholememory_memory_purpose_t get_memory_purpose(wholememory_handle_t wholememory_handle) noexcept
+{
+  return wholememory_handle->impl->get_purpose();
+}
+
+wholememory_error_code_t get_handle_memory_usage(wholememory_memory_usage_t* usage,
+                                                 wholememory_handle_t wholememory_handle) noexcept
+{
+  if (usage == nullptr || wholememory_handle == nullptr || wholememory_handle->impl == nullptr) {
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  *usage = wholememory_handle->impl->get_memory_usage();
+  return WHOLEMEMORY_SUCCESS;
+}
+
 size_t get_data_granularity(wholememory_handle_t wholememory_handle) noexcept
 {
   return wholememory_handle->impl->data_granularity();
@@ -1829,6 +2894,91 @@ wholememory_error_code_t get_global_reference_from_handle(
   return (wholememory_gref->pointer == nullptr) ? WHOLEMEMORY_INVALID_INPUT : WHOLEMEMORY_SUCCESS;
 }
 
+wholememory_error_code_t get_host_numa_nodes_from_handle(
+  int* numa_nodes,
+  size_t offset,
+  size_t stride,
+  size_t count,
+  wholememory_handle_t wholememory_handle) noexcept
+{
+  if (wholememory_handle == nullptr || wholememory_handle->impl == nullptr ||
+      (numa_nodes == nullptr && count > 0)) {
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (get_memory_location(wholememory_handle) == WHOLEMEMORY_ML_DEVICE) {
+    return WHOLEMEMORY_NOT_SUPPORTED;
+  }
+  if (count == 0) return WHOLEMEMORY_SUCCESS;
+  // memory without continuous mapping can only be queried in local partition.
+  auto* mapped_ptr = static_cast<char*>(wholememory_handle->impl->get_continuous_mapping_pointer());
+  size_t mapped_offset = 0;
+  size_t mapped_size   = get_total_size(wholememory_handle);
+  if (mapped_ptr == nullptr) {
+    wholememory_handle->impl->get_local_memory(
+      reinterpret_cast<void**>(&mapped_ptr), &mapped_size, &mapped_offset);
+  }
+  size_t last_offset = offset + stride * (count - 1);
+  if (mapped_ptr == nullptr || offset < mapped_offset || last_offset < offset ||
+      last_offset >= mapped_offset + mapped_size) {
+    return WHOLEMEMORY_INVALID_VALUE;
+  }
+  std::vector<const void*> pages(count);
+  for (size_t i = 0; i < count; i++) {
+    pages[i] = mapped_ptr + (offset - mapped_offset) + i * stride;
+  }
+  if (!GetMemoryNumaNodes(pages.data(), numa_nodes, count)) {
+    WHOLEMEMORY_ERROR("Get NUMA nodes of host memory failed, Reason=%s.", strerror(errno));
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t fill_local_memory_from_handle(
+  const void* value, size_t value_size, wholememory_handle_t wholememory_handle) noexcept
+{
+  if (wholememory_handle == nullptr || wholememory_handle->impl == nullptr || value == nullptr) {
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (!is_fill_value_size_supported(value_size)) {
+    WHOLEMEMORY_ERROR("fill value size should be 1, 2 or 4, but got %ld", value_size);
+    return WHOLEMEMORY_INVALID_VALUE;
+  }
+  if (!wholememory_handle->impl->is_writable()) {
+    WHOLEMEMORY_ERROR("wholememory_handle is read only, map files with write back to fill.");
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  void* local_ptr     = nullptr;
+  size_t local_size   = 0;
+  size_t local_offset = 0;
+  wholememory_handle->impl->get_local_memory(&local_ptr, &local_size, &local_offset);
+  if (local_size % value_size != 0 || local_offset % value_size != 0) {
+    WHOLEMEMORY_ERROR("local memory size %ld and offset %ld should be multiple of value size %ld",
+                      local_size,
+                      local_offset,
+                      value_size);
+    return WHOLEMEMORY_INVALID_VALUE;
+  }
+  if (local_size == 0) return WHOLEMEMORY_SUCCESS;
+  try {
+    if (get_memory_location(wholememory_handle) == WHOLEMEMORY_ML_DEVICE) {
+      device_fill_memory(local_ptr, local_size, value, value_size);
+    } else {
+      host_fill_memory(local_ptr,
+                       local_size,
+                       value,
+                       value_size,
+                       wholememory_handle->impl->get_host_page_size());
+    }
+  } catch (const wholememory::cuda_error& wce) {
+    WHOLEMEMORY_ERROR("%s", wce.what());
+    return WHOLEMEMORY_CUDA_ERROR;
+  } catch (const wholememory::logic_error& wle) {
+    WHOLEMEMORY_ERROR("%s", wle.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
 #ifdef WITH_NVSHMEM_SUPPORT
 
 wholememory_error_code_t get_nvshmem_reference_frome_handle(
@@ -1887,6 +3037,7 @@ wholememory_error_code_t get_partition_plan_from_handle(
 wholememory_handle_::~wholememory_handle_()
 {
   if (impl != nullptr) {
+    impl->release_memory_usage();
     impl->destroy_memory();
     delete impl;
     impl = nullptr;
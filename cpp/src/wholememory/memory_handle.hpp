@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <wholememory/memory_usage.h>
 #include <wholememory/wholememory.h>
 
 #include <cuda_runtime_api.h>
@@ -40,7 +41,21 @@ wholememory_error_code_t create_wholememory(wholememory_handle_t* wholememory_ha
                                             wholememory_comm_t comm,
                                             wholememory_memory_type_t memory_type,
                                             wholememory_memory_location_t memory_location,
-                                            size_t data_granularity) noexcept;
+                                            size_t data_granularity,
+                                            unsigned int malloc_flags = 0,
+                                            size_t max_total_size     = 0) noexcept;
+
+wholememory_error_code_t create_file_mapped_wholememory(
+  wholememory_handle_t* wholememory_handle_ptr,
+  wholememory_comm_t comm,
+  wholememory_memory_type_t memory_type,
+  size_t data_granularity,
+  const char** file_names,
+  int file_count,
+  unsigned int malloc_flags) noexcept;
+
+wholememory_error_code_t grow_wholememory(wholememory_handle_t wholememory_handle,
+                                          size_t new_total_size) noexcept;
 
 wholememory_error_code_t destroy_wholememory_with_comm_locked(
   wholememory_handle_t wholememory_handle) noexcept;
@@ -56,6 +71,16 @@ wholememory_memory_location_t get_memory_location(wholememory_handle_t wholememo
 
 size_t get_total_size(wholememory_handle_t wholememory_handle) noexcept;
 
+size_t get_max_total_size(wholememory_handle_t wholememory_handle) noexcept;
+
+// false for files mapped without WHOLEMEMORY_MF_FILE_WRITE_BACK.
+bool is_writable(wholememory_handle_t wholememory_handle) noexcept;
+
+wholememory_memory_purpose_t get_memory_purpose(wholememory_handle_t wholememory_handle) noexcept;
+
+wholememory_error_code_t get_handle_memory_usage(wholememory_memory_usage_t* usage,
+                                                 wholememory_handle_t wholememory_handle) noexcept;
+
 size_t get_data_granularity(wholememory_handle_t wholememory_handle) noexcept;
 
 wholememory_error_code_t get_local_memory_from_handle(
@@ -77,6 +102,16 @@ wholememory_error_code_t get_global_pointer_from_handle(
 wholememory_error_code_t get_global_reference_from_handle(
   wholememory_gref_t* wholememory_gref, wholememory_handle_t wholememory_handle) noexcept;
 
+wholememory_error_code_t get_host_numa_nodes_from_handle(
+  int* numa_nodes,
+  size_t offset,
+  size_t stride,
+  size_t count,
+  wholememory_handle_t wholememory_handle) noexcept;
+
+wholememory_error_code_t fill_local_memory_from_handle(
+  const void* value, size_t value_size, wholememory_handle_t wholememory_handle) noexcept;
+
 wholememory_error_code_t determine_partition_plan(size_t* size_per_rank,
                                                   size_t total_size,
                                                   size_t data_granularity,
@@ -90,6 +125,9 @@ wholememory_error_code_t get_partition_plan_from_handle(
 wholememory_distributed_backend_t get_distributed_backend_t(
   wholememory_handle_t wholememory_handle) noexcept;
 
+// find WholeMemory handle that ptr points into, nullptr if not in any WholeMemory, lock free.
+wholememory_handle_t wholememory_get_handle(const void* ptr);
+
 #ifdef WITH_NVSHMEM_SUPPORT
 
 wholememory_error_code_t get_nvshmem_reference_frome_handle(
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "wholememory/memory_usage.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+#include "communicator.hpp"
+#include "error.hpp"
+#include "logger.hpp"
+
+namespace wholememory {
+
+namespace {
+
+constexpr int kAllocationTypeCount = WHOLEMEMORY_MA_PINNED + 1;
+constexpr int kMemoryTypeCount     = WHOLEMEMORY_MT_DISTRIBUTED + 1;
+constexpr int kPurposeCount        = WHOLEMEMORY_MP_TEMPORARY + 1;
+
+std::mutex memory_usage_mu;
+// Usage of each category, index 0 of each dimension is the sum over that dimension, so peak of
+// any query is tracked at the time of each allocation, not summed from peaks of categories.
+wholememory_memory_usage_t memory_usage_table[kAllocationTypeCount][kMemoryTypeCount]
+                                             [kPurposeCount];
+
+thread_local wholememory_memory_purpose_t memory_purpose = WHOLEMEMORY_MP_GENERAL;
+
+// calls fn on usage of category and of each query matching it, each usage is visited once.
+template <typename UsageFn>
+void for_each_matching_usage(const memory_usage_category& category, UsageFn fn)
+{
+  WHOLEMEMORY_CHECK(is_valid_memory_usage_category(category));
+  int const allocation_type = category.allocation_type;
+  int const memory_type     = category.memory_type;
+  int const purpose         = category.purpose;
+  for (int mask = 0; mask < 8; mask++) {
+    if ((mask & 1) != 0 && allocation_type == WHOLEMEMORY_MA_NONE) continue;
+    if ((mask & 2) != 0 && memory_type == WHOLEMEMORY_MT_NONE) continue;
+    if ((mask & 4) != 0 && purpose == WHOLEMEMORY_MP_NONE) continue;
+    fn(&memory_usage_table[(mask & 1) != 0 ? 0 : allocation_type]
+                          [(mask & 2) != 0 ? 0 : memory_type][(mask & 4) != 0 ? 0 : purpose]);
+  }
+}
+
+}  // namespace
+
+bool is_valid_memory_usage_category(const memory_usage_category& category)
+{
+  return category.allocation_type >= 0 && category.allocation_type < kAllocationTypeCount &&
+         category.memory_type >= 0 && category.memory_type < kMemoryTypeCount &&
+         category.purpose >= 0 && category.purpose < kPurposeCount;
+}
+
+void record_memory_alloc(const memory_usage_category& category, size_t size)
+{
+  std::unique_lock<std::mutex> mlock(memory_usage_mu);
+  for_each_matching_usage(category, [size](wholememory_memory_usage_t* usage) {
+    usage->live_bytes += size;
+    usage->peak_bytes = std::max(usage->peak_bytes, usage->live_bytes);
+    usage->live_count++;
+    usage->alloc_count++;
+  });
+}
+
+void record_memory_grow(const memory_usage_category& category, size_t grown_size)
+{
+  std::unique_lock<std::mutex> mlock(memory_usage_mu);
+  for_each_matching_usage(category, [grown_size](wholememory_memory_usage_t* usage) {
+    usage->live_bytes += grown_size;
+    usage->peak_bytes = std::max(usage->peak_bytes, usage->live_bytes);
+    usage->alloc_count++;
+  });
+}
+
+void record_memory_free(const memory_usage_category& category, size_t size)
+{
+  std::unique_lock<std::mutex> mlock(memory_usage_mu);
+  for_each_matching_usage(category, [size](wholememory_memory_usage_t* usage) {
+    WHOLEMEMORY_CHECK(usage->live_bytes >= size && usage->live_count > 0);
+    usage->live_bytes -= size;
+    usage->live_count--;
+  });
+}
+
+wholememory_memory_usage_t get_memory_usage(const memory_usage_category& category)
+{
+  WHOLEMEMORY_CHECK(is_valid_memory_usage_category(category));
+  std::unique_lock<std::mutex> mlock(memory_usage_mu);
+  return memory_usage_table[category.allocation_type][category.memory_type][category.purpose];
+}
+
+wholememory_error_code_t get_rank_memory_usage(wholememory_memory_usage_t* rank_usages,
+                                               wholememory_comm_t comm,
+                                               const memory_usage_category& category) noexcept
+{
+  try {
+    if (rank_usages == nullptr || comm == nullptr) return WHOLEMEMORY_INVALID_INPUT;
+    if (!is_valid_memory_usage_category(category)) return WHOLEMEMORY_INVALID_VALUE;
+    std::unique_lock<std::mutex> mlock(comm->mu);
+    WM_COMM_CHECK_ALL_SAME(comm, static_cast<int>(category.allocation_type));
+    WM_COMM_CHECK_ALL_SAME(comm, static_cast<int>(category.memory_type));
+    WM_COMM_CHECK_ALL_SAME(comm, static_cast<int>(category.purpose));
+    wholememory_memory_usage_t local_usage = get_memory_usage(category);
+    comm->host_allgather(
+      &local_usage, rank_usages, sizeof(wholememory_memory_usage_t), WHOLEMEMORY_DT_INT8);
+    return WHOLEMEMORY_SUCCESS;
+  } catch (const wholememory::logic_error& wle) {
+    WHOLEMEMORY_FAIL_NOTHROW("%s", wle.what());
+  } catch (const wholememory::cuda_error& wce) {
+    WHOLEMEMORY_FAIL_NOTHROW("%s", wce.what());
+  } catch (const raft::exception& re) {
+    WHOLEMEMORY_FAIL_NOTHROW("%s", re.what());
+  } catch (...) {
+    WHOLEMEMORY_FAIL_NOTHROW("Unknown exception.");
+  }
+}
+
+void reset_memory_usage_peak()
+{
+  std::unique_lock<std::mutex> mlock(memory_usage_mu);
+  for (auto& type_usages : memory_usage_table) {
+    for (auto& purpose_usages : type_usages) {
+      for (auto& usage : purpose_usages) {
+        usage.peak_bytes = usage.live_bytes;
+      }
+    }
+  }
+}
+
+memory_purpose_guard::memory_purpose_guard(wholememory_memory_purpose_t purpose)
+  : old_purpose_(memory_purpose)
+{
+  memory_purpose = purpose;
+}
+
+memory_purpose_guard::~memory_purpose_guard() { memory_purpose = old_purpose_; }
+
+wholememory_memory_purpose_t get_current_memory_purpose() { return memory_purpose; }
+
+}  // namespace wholememory
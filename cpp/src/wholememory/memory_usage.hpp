@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <wholememory/memory_usage.h>
+
+#include <cstddef>
+
+namespace wholememory {
+
+/**
+ * @brief : Category of memory usage. In queries, WHOLEMEMORY_MA_NONE, WHOLEMEMORY_MT_NONE and
+ * WHOLEMEMORY_MP_NONE match all values of that field.
+ */
+struct memory_usage_category {
+  wholememory_memory_allocation_type_t allocation_type;
+  wholememory_memory_type_t memory_type;
+  wholememory_memory_purpose_t purpose;
+};
+
+/**
+ * @brief : check if all fields of category are valid enum values
+ * @param category : category to check
+ * @return : true if valid
+ */
+bool is_valid_memory_usage_category(const memory_usage_category& category);
+
+/**
+ * @brief : record a new allocation of current rank
+ * @param category : category of the allocation, fields should not be NONE except memory_type of
+ * memory not allocated as WholeMemory
+ * @param size : size in bytes
+ */
+void record_memory_alloc(const memory_usage_category& category, size_t size);
+
+/**
+ * @brief : record that an existing allocation grew, counted as an allocation but not a live one
+ * @param category : category of the allocation
+ * @param grown_size : size in bytes the allocation grew by
+ */
+void record_memory_grow(const memory_usage_category& category, size_t grown_size);
+
+/**
+ * @brief : record a free of current rank
+ * @param category : category of the allocation
+ * @param size : total size in bytes of the freed allocation
+ */
+void record_memory_free(const memory_usage_category& category, size_t size);
+
+/**
+ * @brief : get memory usage of current rank
+ * @param category : category to query, NONE fields match all values
+ * @return : memory usage of the category
+ */
+wholememory_memory_usage_t get_memory_usage(const memory_usage_category& category);
+
+/**
+ * @brief : get memory usage of all ranks by host allgather, all ranks should call together
+ * @param rank_usages : returned memory usage of each rank, world_size elements
+ * @param comm : WholeMemory Communicator
+ * @param category : category to query, NONE fields match all values
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t get_rank_memory_usage(wholememory_memory_usage_t* rank_usages,
+                                               wholememory_comm_t comm,
+                                               const memory_usage_category& category) noexcept;
+
+/**
+ * @brief : reset peak bytes of all categories to live bytes
+ */
+void reset_memory_usage_peak();
+
+/**
+ * @brief : Set purpose of WholeMemory created by current thread in the scope of guard.
+ * Embedding, cache and optimizer code set it before creating their tensors.
+ */
+class memory_purpose_guard {
+ public:
+  explicit memory_purpose_guard(wholememory_memory_purpose_t purpose);
+  ~memory_purpose_guard();
+  memory_purpose_guard(const memory_purpose_guard&)            = delete;
+  memory_purpose_guard& operator=(const memory_purpose_guard&) = delete;
+
+ private:
+  wholememory_memory_purpose_t old_purpose_;
+};
+
+/**
+ * @brief : get purpose of WholeMemory created by current thread
+ * @return : the purpose set by memory_purpose_guard, WHOLEMEMORY_MP_GENERAL if not set
+ */
+wholememory_memory_purpose_t get_current_memory_purpose();
+
+}  // namespace wholememory
@@ -406,6 +406,57 @@ void nccl_comms::host_alltoall(const void* sendbuff,
   }
 }
 
+void nccl_comms::host_alltoallv(const void* sendbuff,
+                                void* recvbuff,
+                                const size_t* sendcounts,
+                                const size_t* senddispls,
+                                const size_t* recvcounts,
+                                const size_t* recvdispls,
+                                ncclDataType_t datatype) const
+{
+  const size_t datatype_size = get_nccl_datatype_size(datatype);
+  const size_t max_elt_count = HOST_BUFFER_SIZE_PER_RANK / datatype_size;
+  // every rank should run the same number of rounds, even if it has nothing to send or receive.
+  uint64_t round_count = 0;
+  for (int i = 0; i < num_ranks_; i++) {
+    uint64_t send_round = (sendcounts[i] + max_elt_count - 1) / max_elt_count;
+    uint64_t recv_round = (recvcounts[i] + max_elt_count - 1) / max_elt_count;
+    round_count         = std::max(round_count, std::max(send_round, recv_round));
+  }
+  host_allreduce(&round_count, &round_count, 1, ncclUint64, ncclMax);
+  std::vector<size_t> round_sendcounts(num_ranks_), round_recvcounts(num_ranks_);
+  std::vector<size_t> round_displs(num_ranks_);
+  for (int i = 0; i < num_ranks_; i++) {
+    round_displs[i] = i * max_elt_count;
+  }
+  for (uint64_t round = 0; round < round_count; round++) {
+    size_t offset = round * max_elt_count;
+    for (int i = 0; i < num_ranks_; i++) {
+      round_sendcounts[i] =
+        sendcounts[i] > offset ? std::min(sendcounts[i] - offset, max_elt_count) : 0;
+      round_recvcounts[i] =
+        recvcounts[i] > offset ? std::min(recvcounts[i] - offset, max_elt_count) : 0;
+      std::memcpy(host_send_buffer_ + round_displs[i] * datatype_size,
+                  static_cast<const char*>(sendbuff) + (senddispls[i] + offset) * datatype_size,
+                  round_sendcounts[i] * datatype_size);
+    }
+    alltoallv(host_send_buffer_,
+              host_recv_buffer_,
+              round_sendcounts.data(),
+              round_displs.data(),
+              round_recvcounts.data(),
+              round_displs.data(),
+              datatype,
+              rmm_stream_);
+    WM_CUDA_CHECK(cudaStreamSynchronize(rmm_stream_));
+    for (int i = 0; i < num_ranks_; i++) {
+      std::memcpy(static_cast<char*>(recvbuff) + (recvdispls[i] + offset) * datatype_size,
+                  host_recv_buffer_ + round_displs[i] * datatype_size,
+                  round_recvcounts[i] * datatype_size);
+    }
+  }
+}
+
 void nccl_comms::alltoallv(const void* sendbuff,
                            void* recvbuff,
                            const size_t* sendcounts,
@@ -157,6 +157,14 @@ class nccl_comms {
                      size_t sendcount,
                      ncclDataType_t datatype) const;
 
+  void host_alltoallv(const void* sendbuff,
+                      void* recvbuff,
+                      const size_t* sendcounts,
+                      const size_t* senddispls,
+                      const size_t* recvcounts,
+                      const size_t* recvdispls,
+                      ncclDataType_t datatype) const;
+
   void alltoallv(const void* sendbuff,
                  void* recvbuff,
                  const size_t* sendcounts,
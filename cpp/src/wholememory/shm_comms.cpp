@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "wholememory/shm_comms.hpp"
+
+#include <sys/shm.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "error.hpp"
+#include "logger.hpp"
+#include "wholememory/host_reduce.hpp"
+
+namespace wholememory {
+
+static constexpr int kSpinCountBeforeYield = 128;
+
+// clock is checked once every kYieldCountPerClockCheck yields.
+static constexpr int kYieldCountPerClockCheck   = 1024;
+static constexpr int kDefaultWaitTimeoutSeconds = 600;
+
+// peer process may have exited, so waiting fails after WHOLEMEMORY_SHM_HOST_COLL_TIMEOUT seconds.
+static int get_wait_timeout_seconds()
+{
+  static const int timeout_seconds = []() {
+    const char* timeout_str = std::getenv("WHOLEMEMORY_SHM_HOST_COLL_TIMEOUT");
+    if (timeout_str == nullptr) return kDefaultWaitTimeoutSeconds;
+    int timeout = std::atoi(timeout_str);
+    if (timeout <= 0) {
+      WHOLEMEMORY_WARN("Invalid WHOLEMEMORY_SHM_HOST_COLL_TIMEOUT=%s, using %d seconds.",
+                       timeout_str,
+                       kDefaultWaitTimeoutSeconds);
+      return kDefaultWaitTimeoutSeconds;
+    }
+    return timeout;
+  }();
+  return timeout_seconds;
+}
+
+static inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+static inline void wait_step(const std::atomic<uint64_t>& flag, uint64_t step, int rank)
+{
+  int spin_count      = 0;
+  int64_t yield_count = 0;
+  std::chrono::steady_clock::time_point deadline;
+  while (flag.load(std::memory_order_acquire) < step) {
+    if (spin_count < kSpinCountBeforeYield) {
+      spin_count++;
+      cpu_relax();
+      continue;
+    }
+    std::this_thread::yield();
+    if (yield_count++ % kYieldCountPerClockCheck != 0) continue;
+    auto now = std::chrono::steady_clock::now();
+    if (yield_count == 1) {
+      deadline = now + std::chrono::seconds(get_wait_timeout_seconds());
+    } else if (now >= deadline) {
+      WHOLEMEMORY_FAIL("Wait for rank %d to reach step %lu of host collectives timed out, got %lu.",
+                       rank,
+                       step,
+                       flag.load(std::memory_order_acquire));
+    }
+  }
+}
+
+shm_comms::shm_comms(void* shm_ptr, int num_ranks, int rank)
+  : shm_ptr_(shm_ptr), num_ranks_(num_ranks), rank_(rank)
+{
+  controls_ = static_cast<rank_control*>(shm_ptr);
+  slots_    = static_cast<char*>(shm_ptr) + num_ranks_ * sizeof(rank_control);
+}
+
+shm_comms::~shm_comms()
+{
+  if (shm_ptr_ != nullptr && shmdt(shm_ptr_) != 0) {
+    WHOLEMEMORY_ERROR("Detach shared memory of host collectives failed, Reason=%s",
+                      strerror(errno));
+  }
+  shm_ptr_ = nullptr;
+}
+
+size_t shm_comms::get_segment_size(int num_ranks)
+{
+  return num_ranks * (sizeof(rank_control) + 2 * SLOT_SIZE);
+}
+
+char* shm_comms::get_slot(int rank, uint64_t step) const
+{
+  return slots_ + (rank * 2 + step % 2) * SLOT_SIZE;
+}
+
+char* shm_comms::begin_step() const
+{
+  step_++;
+  // slot of this step was last used in step_ - 2, all ranks reached step_ - 1 have read it.
+  for (int r = 0; r < num_ranks_; r++) {
+    if (r != rank_) wait_step(controls_[r].step, step_ - 1, r);
+  }
+  return get_slot(rank_, step_);
+}
+
+void shm_comms::post_step() const
+{
+  controls_[rank_].step.store(step_, std::memory_order_release);
+}
+
+const char* shm_comms::wait_slot(int rank, uint64_t step) const
+{
+  wait_step(controls_[rank].step, step, rank);
+  return get_slot(rank, step);
+}
+
+void shm_comms::barrier() const
+{
+  begin_step();
+  post_step();
+  for (int r = 0; r < num_ranks_; r++) {
+    wait_step(controls_[r].step, step_, r);
+  }
+}
+
+void shm_comms::reduce_step(char* recvbuff,
+                            size_t count,
+                            size_t datatype_size,
+                            ncclDataType_t datatype,
+                            ncclRedOp_t op,
+                            bool copy_out) const
+{
+  const uint64_t data_step = step_;
+  const size_t block_start = count * rank_ / num_ranks_;
+  const size_t block_end   = count * (rank_ + 1) / num_ranks_;
+  // begin_step waits for all ranks to publish data_step, so all inputs are ready.
+  char* result_slot = begin_step();
+  if (block_end > block_start) {
+    host_reduce_ranks(get_slot(0, data_step) + block_start * datatype_size,
+                      2 * SLOT_SIZE / datatype_size,
+                      result_slot + block_start * datatype_size,
+                      block_end - block_start,
+                      num_ranks_,
+                      datatype,
+                      op);
+  }
+  post_step();
+  if (!copy_out) return;
+  for (int i = 0; i < num_ranks_; i++) {
+    int r             = (rank_ + i) % num_ranks_;
+    size_t rank_start = count * r / num_ranks_;
+    size_t rank_end   = count * (r + 1) / num_ranks_;
+    if (rank_end == rank_start) continue;
+    const char* result = wait_slot(r, step_);
+    std::memcpy(recvbuff + rank_start * datatype_size,
+                result + rank_start * datatype_size,
+                (rank_end - rank_start) * datatype_size);
+  }
+}
+
+void shm_comms::host_allreduce(
+  const void* sendbuff, void* recvbuff, size_t count, ncclDataType_t datatype, ncclRedOp_t op) const
+{
+  const size_t datatype_size = get_host_datatype_size(datatype);
+  const size_t max_elt_count = SLOT_SIZE / datatype_size;
+  for (size_t offset = 0; offset < count; offset += max_elt_count) {
+    size_t elt_count = std::min(count - offset, max_elt_count);
+    char* slot       = begin_step();
+    std::memcpy(slot,
+                static_cast<const char*>(sendbuff) + offset * datatype_size,
+                elt_count * datatype_size);
+    post_step();
+    reduce_step(static_cast<char*>(recvbuff) + offset * datatype_size,
+                elt_count,
+                datatype_size,
+                datatype,
+                op,
+                true);
+  }
+}
+
+void shm_comms::host_bcast(
+  const void* sendbuff, void* recvbuff, size_t count, ncclDataType_t datatype, int root) const
+{
+  const size_t size = count * get_host_datatype_size(datatype);
+  for (size_t offset = 0; offset < size; offset += SLOT_SIZE) {
+    size_t chunk_size = std::min(size - offset, SLOT_SIZE);
+    char* slot        = begin_step();
+    if (rank_ == root) {
+      std::memcpy(slot, static_cast<const char*>(sendbuff) + offset, chunk_size);
+    }
+    post_step();
+    if (rank_ != root) {
+      std::memcpy(static_cast<char*>(recvbuff) + offset, wait_slot(root, step_), chunk_size);
+    }
+  }
+  if (rank_ == root && sendbuff != recvbuff && size > 0) std::memmove(recvbuff, sendbuff, size);
+}
+
+void shm_comms::host_bcast(void* buff, size_t count, ncclDataType_t datatype, int root) const
+{
+  host_bcast(buff, buff, count, datatype, root);
+}
+
+void shm_comms::host_reduce(const void* sendbuff,
+                            void* recvbuff,
+                            size_t count,
+                            ncclDataType_t datatype,
+                            ncclRedOp_t op,
+                            int root) const
+{
+  const size_t datatype_size = get_host_datatype_size(datatype);
+  const size_t max_elt_count = SLOT_SIZE / datatype_size;
+  for (size_t offset = 0; offset < count; offset += max_elt_count) {
+    size_t elt_count = std::min(count - offset, max_elt_count);
+    char* slot       = begin_step();
+    std::memcpy(slot,
+                static_cast<const char*>(sendbuff) + offset * datatype_size,
+                elt_count * datatype_size);
+    post_step();
+    reduce_step(static_cast<char*>(recvbuff) + offset * datatype_size,
+                elt_count,
+                datatype_size,
+                datatype,
+                op,
+                rank_ == root);
+  }
+}
+
+void shm_comms::host_allgather(const void* sendbuff,
+                               void* recvbuff,
+                               size_t sendcount,
+                               ncclDataType_t datatype) const
+{
+  const size_t size = sendcount * get_host_datatype_size(datatype);
+  for (size_t offset = 0; offset < size; offset += SLOT_SIZE) {
+    size_t chunk_size = std::min(size - offset, SLOT_SIZE);
+    char* slot        = begin_step();
+    std::memcpy(slot, static_cast<const char*>(sendbuff) + offset, chunk_size);
+    post_step();
+    // read peers in ring order starting from the next rank to spread the memory traffic.
+    for (int i = 1; i <= num_ranks_; i++) {
+      int r = (rank_ + i) % num_ranks_;
+      std::memcpy(
+        static_cast<char*>(recvbuff) + r * size + offset, wait_slot(r, step_), chunk_size);
+    }
+  }
+}
+
+void shm_comms::host_allgatherv(const void* sendbuf,
+                                void* recvbuf,
+                                const size_t* recvcounts,
+                                const size_t* displs,
+                                ncclDataType_t datatype) const
+{
+  const size_t datatype_size = get_host_datatype_size(datatype);
+  size_t max_size            = 0;
+  for (int r = 0; r < num_ranks_; r++) {
+    max_size = std::max(max_size, recvcounts[r] * datatype_size);
+  }
+  for (size_t offset = 0; offset < max_size; offset += SLOT_SIZE) {
+    char* slot       = begin_step();
+    size_t send_size = recvcounts[rank_] * datatype_size;
+    if (send_size > offset) {
+      std::memcpy(slot,
+                  static_cast<const char*>(sendbuf) + offset,
+                  std::min(send_size - offset, SLOT_SIZE));
+    }
+    post_step();
+    for (int i = 1; i <= num_ranks_; i++) {
+      int r            = (rank_ + i) % num_ranks_;
+      size_t rank_size = recvcounts[r] * datatype_size;
+      if (rank_size <= offset) continue;
+      std::memcpy(static_cast<char*>(recvbuf) + displs[r] * datatype_size + offset,
+                  wait_slot(r, step_),
+                  std::min(rank_size - offset, SLOT_SIZE));
+    }
+  }
+}
+
+void shm_comms::host_gather(
+  const void* sendbuff, void* recvbuff, size_t sendcount, ncclDataType_t datatype, int root) const
+{
+  const size_t size = sendcount * get_host_datatype_size(datatype);
+  for (size_t offset = 0; offset < size; offset += SLOT_SIZE) {
+    size_t chunk_size = std::min(size - offset, SLOT_SIZE);
+    char* slot        = begin_step();
+    std::memcpy(slot, static_cast<const char*>(sendbuff) + offset, chunk_size);
+    post_step();
+    if (rank_ != root) continue;
+    for (int i = 1; i <= num_ranks_; i++) {
+      int r = (rank_ + i) % num_ranks_;
+      std::memcpy(
+        static_cast<char*>(recvbuff) + r * size + offset, wait_slot(r, step_), chunk_size);
+    }
+  }
+}
+
+size_t shm_comms::get_alltoall_part_size() const
+{
+  // keep each part cache line aligned to avoid false sharing between peers.
+  size_t part_size = SLOT_SIZE / num_ranks_ / 64 * 64;
+  WHOLEMEMORY_EXPECTS(part_size > 0, "too many ranks %d for shared memory alltoall.", num_ranks_);
+  return part_size;
+}
+
+void shm_comms::alltoallv_steps(const void* sendbuff,
+                                void* recvbuff,
+                                const size_t* sendcounts,
+                                const size_t* senddispls,
+                                const size_t* recvcounts,
+                                const size_t* recvdispls,
+                                ncclDataType_t datatype,
+                                uint64_t round_count) const
+{
+  const size_t datatype_size = get_host_datatype_size(datatype);
+  const size_t part_size     = get_alltoall_part_size();
+  const size_t part_elt      = part_size / datatype_size;
+  for (uint64_t round = 0; round < round_count; round++) {
+    size_t offset = round * part_elt;
+    char* slot    = begin_step();
+    for (int r = 0; r < num_ranks_; r++) {
+      if (sendcounts[r] <= offset) continue;
+      std::memcpy(slot + r * part_size,
+                  static_cast<const char*>(sendbuff) + (senddispls[r] + offset) * datatype_size,
+                  std::min(sendcounts[r] - offset, part_elt) * datatype_size);
+    }
+    post_step();
+    for (int i = 1; i <= num_ranks_; i++) {
+      int r = (rank_ + i) % num_ranks_;
+      if (recvcounts[r] <= offset) continue;
+      std::memcpy(static_cast<char*>(recvbuff) + (recvdispls[r] + offset) * datatype_size,
+                  wait_slot(r, step_) + rank_ * part_size,
+                  std::min(recvcounts[r] - offset, part_elt) * datatype_size);
+    }
+  }
+}
+
+void shm_comms::host_alltoall(const void* sendbuff,
+                              void* recvbuff,
+                              size_t sendcount,
+                              ncclDataType_t datatype) const
+{
+  const size_t part_elt = get_alltoall_part_size() / get_host_datatype_size(datatype);
+  std::vector<size_t> counts(num_ranks_, sendcount), displs(num_ranks_);
+  for (int r = 0; r < num_ranks_; r++) {
+    displs[r] = r * sendcount;
+  }
+  alltoallv_steps(sendbuff,
+                  recvbuff,
+                  counts.data(),
+                  displs.data(),
+                  counts.data(),
+                  displs.data(),
+                  datatype,
+                  (sendcount + part_elt - 1) / part_elt);
+}
+
+void shm_comms::host_alltoallv(const void* sendbuff,
+                               void* recvbuff,
+                               const size_t* sendcounts,
+                               const size_t* senddispls,
+                               const size_t* recvcounts,
+                               const size_t* recvdispls,
+                               ncclDataType_t datatype) const
+{
+  const size_t part_elt = get_alltoall_part_size() / get_host_datatype_size(datatype);
+  // every rank should run the same number of rounds, even if it has nothing to send or receive.
+  uint64_t round_count = 0;
+  for (int r = 0; r < num_ranks_; r++) {
+    uint64_t send_round = (sendcounts[r] + part_elt - 1) / part_elt;
+    uint64_t recv_round = (recvcounts[r] + part_elt - 1) / part_elt;
+    round_count         = std::max(round_count, std::max(send_round, recv_round));
+  }
+  host_allreduce(&round_count, &round_count, 1, ncclUint64, ncclMax);
+  alltoallv_steps(sendbuff,
+                  recvbuff,
+                  sendcounts,
+                  senddispls,
+                  recvcounts,
+                  recvdispls,
+                  datatype,
+                  round_count);
+}
+
+}  // namespace wholememory
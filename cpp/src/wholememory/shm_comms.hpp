@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <nccl.h>
+
+namespace wholememory {
+
+/**
+ * @brief Intra-node host collectives over one shared memory segment mapped by all ranks.
+ * Each rank owns a control cache line and two data slots in the segment. A collective is a
+ * sequence of steps, in each step every rank fills its slot of the step, publishes the step
+ * number in its control line, then reads peer slots after their step numbers are published.
+ * Slots are double buffered, so no lock or extra barrier is needed between steps.
+ */
+class shm_comms {
+ public:
+  shm_comms() = delete;
+
+  /**
+   * @brief Constructor, segment should be zero initialized and mapped by all ranks.
+   * @param shm_ptr pointer to shared memory segment of get_segment_size(num_ranks) bytes
+   * @param num_ranks number of ranks, all ranks should be on the same node
+   * @param rank rank of the current worker
+   */
+  shm_comms(void* shm_ptr, int num_ranks, int rank);
+
+  // detaches the shared memory segment.
+  ~shm_comms();
+
+  /**
+   * @brief Get size of shared memory segment needed by num_ranks ranks.
+   * @param num_ranks number of ranks
+   * @return segment size in bytes
+   */
+  static size_t get_segment_size(int num_ranks);
+
+  int get_size() const { return num_ranks_; }
+
+  int get_rank() const { return rank_; }
+
+  void barrier() const;
+
+  void host_allreduce(const void* sendbuff,
+                      void* recvbuff,
+                      size_t count,
+                      ncclDataType_t datatype,
+                      ncclRedOp_t op) const;
+
+  void host_bcast(
+    const void* sendbuff, void* recvbuff, size_t count, ncclDataType_t datatype, int root) const;
+
+  void host_bcast(void* buff, size_t count, ncclDataType_t datatype, int root) const;
+
+  void host_reduce(const void* sendbuff,
+                   void* recvbuff,
+                   size_t count,
+                   ncclDataType_t datatype,
+                   ncclRedOp_t op,
+                   int root) const;
+
+  void host_allgather(const void* sendbuff,
+                      void* recvbuff,
+                      size_t sendcount,
+                      ncclDataType_t datatype) const;
+
+  void host_allgatherv(const void* sendbuf,
+                       void* recvbuf,
+                       const size_t* recvcounts,
+                       const size_t* displs,
+                       ncclDataType_t datatype) const;
+
+  void host_gather(const void* sendbuff,
+                   void* recvbuff,
+                   size_t sendcount,
+                   ncclDataType_t datatype,
+                   int root) const;
+
+  void host_alltoall(const void* sendbuff,
+                     void* recvbuff,
+                     size_t sendcount,
+                     ncclDataType_t datatype) const;
+
+  void host_alltoallv(const void* sendbuff,
+                      void* recvbuff,
+                      const size_t* sendcounts,
+                      const size_t* senddispls,
+                      const size_t* recvcounts,
+                      const size_t* recvdispls,
+                      ncclDataType_t datatype) const;
+
+  static constexpr size_t SLOT_SIZE = 256 * 1024;
+
+ private:
+  struct rank_control {
+    std::atomic<uint64_t> step;
+  } __attribute__((aligned(64)));
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "shm_comms needs lock free atomic in shared memory.");
+
+  // starts next step, returns slot of this rank after all peers finished reading it.
+  char* begin_step() const;
+
+  // publishes slot of this rank for current step.
+  void post_step() const;
+
+  // waits until rank published step, and returns slot of rank for that step.
+  const char* wait_slot(int rank, uint64_t step) const;
+
+  char* get_slot(int rank, uint64_t step) const;
+
+  // reduce elements of current step slots, the result of block of each rank is published in slot
+  // of next step, and copied to recvbuff by ranks with copy_out set.
+  void reduce_step(char* recvbuff,
+                   size_t count,
+                   size_t datatype_size,
+                   ncclDataType_t datatype,
+                   ncclRedOp_t op,
+                   bool copy_out) const;
+
+  // alltoallv in round_count steps, round_count should be the same on all ranks.
+  void alltoallv_steps(const void* sendbuff,
+                       void* recvbuff,
+                       const size_t* sendcounts,
+                       const size_t* senddispls,
+                       const size_t* recvcounts,
+                       const size_t* recvdispls,
+                       ncclDataType_t datatype,
+                       uint64_t round_count) const;
+
+  // per peer part of slot used by alltoallv, in bytes.
+  size_t get_alltoall_part_size() const;
+
+  void* shm_ptr_;
+  rank_control* controls_;
+  char* slots_;
+  int num_ranks_;
+  int rank_;
+  mutable uint64_t step_ = 0;
+};
+
+}  // namespace wholememory
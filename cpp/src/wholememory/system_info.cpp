@@ -15,6 +15,14 @@
  */
 #include "system_info.hpp"
 
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <fstream>
+#include <sstream>
 #include <string>
 
 #include "cuda_macros.hpp"
@@ -101,3 +109,78 @@ bool SupportEGM()
 }
 
 bool SupportMNNVLForEGM() { return SupportMNNVL() && SupportEGM(); }
+
+std::vector<int> GetOnlineNumaNodes()
+{
+  // node list is like "0-1,4"
+  std::vector<int> numa_nodes;
+  std::ifstream node_file("/sys/devices/system/node/online");
+  std::string node_list;
+  if (node_file && std::getline(node_file, node_list)) {
+    std::stringstream ss(node_list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+      int first = -1, last = -1;
+      int count = sscanf(item.c_str(), "%d-%d", &first, &last);
+      if (count < 1 || first < 0) continue;
+      if (count == 1) last = first;
+      for (int node = first; node <= last; node++) {
+        numa_nodes.push_back(node);
+      }
+    }
+  }
+  if (numa_nodes.empty()) numa_nodes.push_back(0);
+  return numa_nodes;
+}
+
+int GetCurrentNumaNode()
+{
+  unsigned int cpu = 0, node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return 0;
+  return static_cast<int>(node);
+}
+
+int GetDeviceNumaNode(int dev_id)
+{
+  char bus_id[32];
+  if (cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), dev_id) != cudaSuccess) return -1;
+  std::string bus_id_str(bus_id);
+  std::transform(bus_id_str.begin(), bus_id_str.end(), bus_id_str.begin(), [](unsigned char c) {
+    return std::tolower(c);
+  });
+  std::ifstream numa_node_file("/sys/bus/pci/devices/" + bus_id_str + "/numa_node");
+  int numa_node = -1;
+  if (!(numa_node_file >> numa_node)) return -1;
+  return numa_node;
+}
+
+// same as MPOL_PREFERRED and MPOL_INTERLEAVE in numaif.h, which may not be installed.
+static constexpr int kMemPolicyPreferred  = 1;
+static constexpr int kMemPolicyInterleave = 3;
+static constexpr int kMaxNumaNodes        = 1024;
+
+bool SetMemoryNumaPolicy(void* ptr, size_t size, int numa_node)
+{
+  constexpr int kBitsPerMask = sizeof(unsigned long) * 8;
+  unsigned long node_mask[kMaxNumaNodes / kBitsPerMask] = {0};
+  std::vector<int> numa_nodes;
+  if (numa_node >= 0) {
+    numa_nodes.push_back(numa_node);
+  } else {
+    numa_nodes = GetOnlineNumaNodes();
+  }
+  for (int node : numa_nodes) {
+    if (node >= kMaxNumaNodes) return false;
+    node_mask[node / kBitsPerMask] |= 1UL << (node % kBitsPerMask);
+  }
+  int mode = numa_node >= 0 ? kMemPolicyPreferred : kMemPolicyInterleave;
+  // kernel uses maxnode - 1 bits of node_mask.
+  return syscall(SYS_mbind, ptr, size, mode, node_mask, kMaxNumaNodes + 1, 0) == 0;
+}
+
+bool GetMemoryNumaNodes(const void* const* pages, int* numa_nodes, size_t count)
+{
+  if (count == 0) return true;
+  // move_pages with nullptr nodes only queries page status.
+  return syscall(SYS_move_pages, 0, count, pages, nullptr, numa_nodes, 0) == 0;
+}
@@ -15,6 +15,9 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <vector>
+
 bool DevAttrPagebleMemoryAccess();
 
 bool DeviceCanAccessPeer(int peer_device);
@@ -30,3 +33,40 @@ bool SupportMNNVL();
 bool SupportEGM();
 
 bool SupportMNNVLForEGM();
+
+/**
+ * Get online NUMA nodes of the machine.
+ * @return : online NUMA node ids, {0} if NUMA information is not available
+ */
+std::vector<int> GetOnlineNumaNodes();
+
+/**
+ * Get NUMA node of the CPU current thread is running on.
+ * @return : NUMA node id, 0 if not available
+ */
+int GetCurrentNumaNode();
+
+/**
+ * Get NUMA node close to CUDA device.
+ * @param dev_id : CUDA device id
+ * @return : NUMA node id, -1 if not available
+ */
+int GetDeviceNumaNode(int dev_id);
+
+/**
+ * Set NUMA policy of memory range, should be called before pages are touched.
+ * @param ptr : start of memory range, should be aligned to page size
+ * @param size : size of memory range
+ * @param numa_node : preferred NUMA node, -1 to interleave across all online NUMA nodes
+ * @return : true on success
+ */
+bool SetMemoryNumaPolicy(void* ptr, size_t size, int numa_node);
+
+/**
+ * Get NUMA node of pages.
+ * @param pages : addresses in pages to query
+ * @param numa_nodes : returned NUMA node of each page, negative errno if page is not populated
+ * @param count : number of pages
+ * @return : true on success
+ */
+bool GetMemoryNumaNodes(const void* const* pages, int* numa_nodes, size_t count);
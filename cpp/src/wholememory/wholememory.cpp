@@ -19,6 +19,7 @@
 #include "file_io.h"
 #include "initialize.hpp"
 #include "memory_handle.hpp"
+#include "memory_usage.hpp"
 #include "parallel_utils.hpp"
 
 #ifdef __cplusplus
@@ -34,6 +35,12 @@ wholememory_error_code_t wholememory_create_unique_id(wholememory_unique_id_t* u
   return wholememory::create_unique_id(unique_id);
 }
 
+wholememory_error_code_t wholememory_create_unique_id_with_backend(
+  wholememory_unique_id_t* unique_id, wholememory_comm_backend_t comm_backend)
+{
+  return wholememory::create_unique_id(unique_id, comm_backend);
+}
+
 wholememory_error_code_t wholememory_create_communicator(wholememory_comm_t* comm,
                                                          wholememory_unique_id_t unique_id,
                                                          int rank,
@@ -85,6 +92,11 @@ wholememory_distributed_backend_t wholememory_communicator_get_distributed_backe
   return wholememory::communicator_get_distributed_backend(comm);
 }
 
+wholememory_comm_backend_t wholememory_communicator_get_backend(wholememory_comm_t comm)
+{
+  return wholememory::communicator_get_backend(comm);
+}
+
 wholememory_error_code_t wholememory_communicator_barrier(wholememory_comm_t comm)
 {
   wholememory::communicator_barrier(comm);
@@ -102,6 +114,61 @@ wholememory_error_code_t wholememory_malloc(wholememory_handle_t* wholememory_ha
     wholememory_handle_ptr, total_size, comm, memory_type, memory_location, data_granularity);
 }
 
+wholememory_error_code_t wholememory_malloc_with_flags(
+  wholememory_handle_t* wholememory_handle_ptr,
+  size_t total_size,
+  wholememory_comm_t comm,
+  wholememory_memory_type_t memory_type,
+  wholememory_memory_location_t memory_location,
+  size_t data_granularity,
+  unsigned int flags)
+{
+  return wholememory::create_wholememory(wholememory_handle_ptr,
+                                         total_size,
+                                         comm,
+                                         memory_type,
+                                         memory_location,
+                                         data_granularity,
+                                         flags);
+}
+
+wholememory_error_code_t wholememory_malloc_growable(wholememory_handle_t* wholememory_handle_ptr,
+                                                     size_t total_size,
+                                                     size_t max_total_size,
+                                                     wholememory_comm_t comm,
+                                                     wholememory_memory_type_t memory_type,
+                                                     wholememory_memory_location_t memory_location,
+                                                     size_t data_granularity,
+                                                     unsigned int flags)
+{
+  return wholememory::create_wholememory(wholememory_handle_ptr,
+                                         total_size,
+                                         comm,
+                                         memory_type,
+                                         memory_location,
+                                         data_granularity,
+                                         flags,
+                                         max_total_size);
+}
+
+wholememory_error_code_t wholememory_grow(wholememory_handle_t wholememory_handle,
+                                          size_t new_total_size)
+{
+  return wholememory::grow_wholememory(wholememory_handle, new_total_size);
+}
+
+wholememory_error_code_t wholememory_malloc_from_file(wholememory_handle_t* wholememory_handle_ptr,
+                                                      wholememory_comm_t comm,
+                                                      wholememory_memory_type_t memory_type,
+                                                      size_t data_granularity,
+                                                      const char** file_names,
+                                                      int file_count,
+                                                      unsigned int flags)
+{
+  return wholememory::create_file_mapped_wholememory(
+    wholememory_handle_ptr, comm, memory_type, data_granularity, file_names, file_count, flags);
+}
+
 wholememory_error_code_t wholememory_free(wholememory_handle_t wholememory_handle)
 {
   return wholememory::destroy_wholememory(wholememory_handle);
@@ -135,6 +202,11 @@ size_t wholememory_get_total_size(wholememory_handle_t wholememory_handle)
   return wholememory::get_total_size(wholememory_handle);
 }
 
+size_t wholememory_get_max_total_size(wholememory_handle_t wholememory_handle)
+{
+  return wholememory::get_max_total_size(wholememory_handle);
+}
+
 size_t wholememory_get_data_granularity(wholememory_handle_t wholememory_handle)
 {
   return wholememory::get_data_granularity(wholememory_handle);
@@ -171,6 +243,23 @@ wholememory_error_code_t wholememory_get_global_reference(wholememory_gref_t* wh
   return wholememory::get_global_reference_from_handle(wholememory_gref, wholememory_handle);
 }
 
+wholememory_error_code_t wholememory_get_host_numa_nodes(int* numa_nodes,
+                                                         size_t offset,
+                                                         size_t stride,
+                                                         size_t count,
+                                                         wholememory_handle_t wholememory_handle)
+{
+  return wholememory::get_host_numa_nodes_from_handle(
+    numa_nodes, offset, stride, count, wholememory_handle);
+}
+
+wholememory_error_code_t wholememory_fill_local_memory(const void* value,
+                                                       size_t value_size,
+                                                       wholememory_handle_t wholememory_handle)
+{
+  return wholememory::fill_local_memory_from_handle(value, value_size, wholememory_handle);
+}
+
 #ifdef WITH_NVSHMEM_SUPPORT
 
 wholememory_error_code_t wholememory_get_nvshmem_reference(
@@ -206,6 +295,47 @@ wholememory_error_code_t wholememory_get_partition_plan(size_t* size_per_rank,
   return wholememory::get_partition_plan_from_handle(size_per_rank, wholememory_handle);
 }
 
+wholememory_error_code_t wholememory_get_memory_usage(
+  wholememory_memory_usage_t* usage,
+  wholememory_memory_allocation_type_t allocation_type,
+  wholememory_memory_type_t memory_type,
+  wholememory_memory_purpose_t purpose)
+{
+  wholememory::memory_usage_category category{allocation_type, memory_type, purpose};
+  if (usage == nullptr) return WHOLEMEMORY_INVALID_INPUT;
+  if (!wholememory::is_valid_memory_usage_category(category)) return WHOLEMEMORY_INVALID_VALUE;
+  *usage = wholememory::get_memory_usage(category);
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t wholememory_get_rank_memory_usage(
+  wholememory_memory_usage_t* rank_usages,
+  wholememory_comm_t comm,
+  wholememory_memory_allocation_type_t allocation_type,
+  wholememory_memory_type_t memory_type,
+  wholememory_memory_purpose_t purpose)
+{
+  return wholememory::get_rank_memory_usage(
+    rank_usages, comm, wholememory::memory_usage_category{allocation_type, memory_type, purpose});
+}
+
+wholememory_error_code_t wholememory_get_handle_memory_usage(
+  wholememory_memory_usage_t* usage, wholememory_handle_t wholememory_handle)
+{
+  return wholememory::get_handle_memory_usage(usage, wholememory_handle);
+}
+
+wholememory_memory_purpose_t wholememory_get_memory_purpose(wholememory_handle_t wholememory_handle)
+{
+  return wholememory::get_memory_purpose(wholememory_handle);
+}
+
+wholememory_error_code_t wholememory_reset_memory_usage_peak()
+{
+  wholememory::reset_memory_usage_peak();
+  return WHOLEMEMORY_SUCCESS;
+}
+
 int fork_get_device_count()
 {
   try {
@@ -227,6 +357,32 @@ wholememory_error_code_t wholememory_load_from_file(wholememory_handle_t wholeme
     wholememory_handle, memory_offset, memory_entry_size, file_entry_size, file_names, file_count);
 }
 
+wholememory_error_code_t wholememory_load_from_file_with_conversion(
+  wholememory_handle_t wholememory_handle,
+  size_t memory_offset,
+  size_t memory_entry_size,
+  wholememory_dtype_t memory_dtype,
+  size_t file_entry_size,
+  wholememory_dtype_t file_dtype,
+  size_t file_column_start,
+  size_t column_count,
+  const char** file_names,
+  int file_count)
+{
+  wholememory::file_entry_conversion conversion;
+  conversion.file_dtype   = file_dtype;
+  conversion.memory_dtype = memory_dtype;
+  conversion.column_start = file_column_start;
+  conversion.column_count = column_count;
+  return wholememory::load_file_to_handle(wholememory_handle,
+                                          memory_offset,
+                                          memory_entry_size,
+                                          file_entry_size,
+                                          file_names,
+                                          file_count,
+                                          &conversion);
+}
+
 wholememory_error_code_t wholememory_store_to_file(wholememory_handle_t wholememory_handle,
                                                    size_t memory_offset,
                                                    size_t memory_entry_stride,
@@ -18,6 +18,7 @@
 #include <atomic>
 #include <cstdlib>
 
+#include "file_io.h"
 #include "logger.hpp"
 
 #ifdef WM_TENSOR_COUNT_DEBUG
@@ -54,6 +55,18 @@ wholememory_error_code_t wholememory_create_tensor(
   wholememory_comm_t comm,
   wholememory_memory_type_t memory_type,
   wholememory_memory_location_t memory_location)
+{
+  return wholememory_create_tensor_with_flags(
+    p_wholememory_tensor, tensor_description, comm, memory_type, memory_location, 0);
+}
+
+wholememory_error_code_t wholememory_create_tensor_with_flags(
+  wholememory_tensor_t* p_wholememory_tensor,
+  wholememory_tensor_description_t* tensor_description,
+  wholememory_comm_t comm,
+  wholememory_memory_type_t memory_type,
+  wholememory_memory_location_t memory_location,
+  unsigned int flags)
 {
   if (p_wholememory_tensor == nullptr) {
     WHOLEMEMORY_ERROR("p_wholememory_tensor is nullptr");
@@ -93,12 +106,13 @@ wholememory_error_code_t wholememory_create_tensor(
   wholememory_tensor->is_wholememory     = true;
   wholememory_tensor->root_tensor        = wholememory_tensor;
   *p_wholememory_tensor                  = wholememory_tensor;
-  auto ret_code = wholememory_malloc(&wholememory_tensor->wholememory_handle,
-                                     malloc_size,
-                                     comm,
-                                     memory_type,
-                                     memory_location,
-                                     granularity);
+  auto ret_code = wholememory_malloc_with_flags(&wholememory_tensor->wholememory_handle,
+                                                malloc_size,
+                                                comm,
+                                                memory_type,
+                                                memory_location,
+                                                granularity,
+                                                flags);
   inc_tensor_count();
   if (ret_code != WHOLEMEMORY_SUCCESS) { free(wholememory_tensor); }
   return ret_code;
@@ -388,6 +402,52 @@ wholememory_tensor_t wholememory_tensor_get_root(wholememory_tensor_t wholememor
   return wholememory_tensor->root_tensor;
 }
 
+wholememory_error_code_t wholememory_tensor_store_to_checkpoint(
+  wholememory_tensor_t wholememory_tensor, const char* file_prefix)
+{
+  if (wholememory_tensor == nullptr || file_prefix == nullptr) { return WHOLEMEMORY_INVALID_INPUT; }
+  if (!wholememory_tensor->is_wholememory) { return WHOLEMEMORY_INVALID_VALUE; }
+  return wholememory::store_tensor_to_checkpoint(
+    wholememory_tensor->wholememory_handle, &wholememory_tensor->tensor_description, file_prefix);
+}
+
+wholememory_error_code_t wholememory_tensor_load_from_checkpoint(
+  wholememory_tensor_t wholememory_tensor, const char* file_prefix, int verify_checksum)
+{
+  if (wholememory_tensor == nullptr || file_prefix == nullptr) { return WHOLEMEMORY_INVALID_INPUT; }
+  if (!wholememory_tensor->is_wholememory) { return WHOLEMEMORY_INVALID_VALUE; }
+  return wholememory::load_tensor_from_checkpoint(wholememory_tensor->wholememory_handle,
+                                                  &wholememory_tensor->tensor_description,
+                                                  file_prefix,
+                                                  verify_checksum != 0);
+}
+
+static bool is_contiguous_1d_wholememory_tensor(wholememory_tensor_t wholememory_tensor)
+{
+  if (wholememory_tensor == nullptr || !wholememory_tensor->is_wholememory) return false;
+  auto& tensor_description = wholememory_tensor->tensor_description;
+  return tensor_description.dim == 1 && tensor_description.storage_offset == 0 &&
+         tensor_description.strides[0] == 1;
+}
+
+wholememory_error_code_t wholememory_load_compressed_csr_from_file(
+  wholememory_tensor_t csr_row_ptr_tensor,
+  wholememory_tensor_t csr_col_ind_tensor,
+  const char* file_name)
+{
+  if (!is_contiguous_1d_wholememory_tensor(csr_row_ptr_tensor) ||
+      !is_contiguous_1d_wholememory_tensor(csr_col_ind_tensor) || file_name == nullptr) {
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  if (csr_row_ptr_tensor->tensor_description.dtype != WHOLEMEMORY_DT_INT64) {
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  return wholememory::load_compressed_csr_to_handles(csr_row_ptr_tensor->wholememory_handle,
+                                                     csr_col_ind_tensor->wholememory_handle,
+                                                     csr_col_ind_tensor->tensor_description.dtype,
+                                                     file_name);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,7 @@
 #include "logger.hpp"
 #include "wholememory/embedding_cache.hpp"
 #include "wholememory/env_func_ptrs.h"
+#include "wholememory/env_func_ptrs.hpp"
 #include "wholememory/integer_utils.hpp"
 #include "wholememory_ops/functions/embedding_cache_func.cuh"
 #include "wholememory_ops/register.hpp"
@@ -336,6 +337,7 @@ wholememory_error_code_t update_cache_direct_same_comm(
   wholememory_env_func_t* p_env_fns,
   cudaStream_t stream)
 {
+  wholememory::temp_memory_stream_guard stream_guard(stream);
   wm_thrust_allocator thrust_allocator(p_env_fns);
   int world_size = 1;
   int world_rank = 0;
@@ -531,6 +533,7 @@ wholememory_error_code_t update_cache_different_comm(
   wholememory_env_func_t* p_env_fns,
   cudaStream_t stream)
 {
+  wholememory::temp_memory_stream_guard stream_guard(stream);
   wm_thrust_allocator thrust_allocator(p_env_fns);
   int cache_world_size = 1;
   int cache_world_rank = 0;
@@ -686,6 +689,7 @@ wholememory_error_code_t writeback_cache_direct_same_comm(
   bool drop_all,
   cudaStream_t stream)
 {
+  wholememory::temp_memory_stream_guard stream_guard(stream);
   int world_size = 1;
   int world_rank = 0;
   wholememory_handle_t wholememory_handle =
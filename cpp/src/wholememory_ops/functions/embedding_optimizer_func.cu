@@ -26,23 +26,6 @@
 
 namespace wholememory_ops {
 
-__global__ void set_float_kernel(float* data_ptr, float value, size_t elt_count)
-{
-  int64_t idx = blockIdx.x;
-  idx *= blockDim.x;
-  idx += threadIdx.x;
-  if (idx >= elt_count) return;
-  data_ptr[idx] = value;
-}
-
-void set_memory_to_float_value(float* data_ptr, float value, size_t elt_count, cudaStream_t stream)
-{
-  const int thread_count = 128;
-  int block_count        = wholememory::div_rounding_up_safe<int64_t>(elt_count, thread_count);
-  set_float_kernel<<<block_count, thread_count, 0, stream>>>(data_ptr, value, elt_count);
-  WM_CUDA_CHECK_NO_THROW(cudaGetLastError());
-}
-
 template <int PerElementCount = 0>
 static void check_optimizer_inputs(wholememory_tensor_t indices,
                                    wholememory_tensor_t grads,
@@ -986,4 +969,130 @@ wholememory_error_code_t rms_prop_optimizer_step(wholememory_tensor_t indices,
   return WHOLEMEMORY_SUCCESS;
 }
 
+template <typename IndiceT>
+__global__ void mark_dirty_rows_kernel(const IndiceT* indices_ptr,
+                                       int64_t indice_count,
+                                       int64_t local_entry_offset,
+                                       uint32_t* dirty_bitmap)
+{
+  int64_t idx = blockIdx.x;
+  idx *= blockDim.x;
+  idx += threadIdx.x;
+  if (idx >= indice_count) return;
+  int64_t local_rank_indice = indices_ptr[idx] - local_entry_offset;
+  atomicOr(dirty_bitmap + local_rank_indice / 32, 1U << (local_rank_indice % 32));
+}
+
+template <typename IndiceT>
+void mark_dirty_rows_temp_func(const void* indices_ptr,
+                               int64_t indice_count,
+                               int64_t local_entry_offset,
+                               uint32_t* dirty_bitmap,
+                               cudaStream_t stream)
+{
+  if (indice_count == 0) return;
+  const int thread_count = 128;
+  int block_count = wholememory::div_rounding_up_safe<int64_t>(indice_count, thread_count);
+  mark_dirty_rows_kernel<IndiceT><<<block_count, thread_count, 0, stream>>>(
+    static_cast<const IndiceT*>(indices_ptr), indice_count, local_entry_offset, dirty_bitmap);
+  WM_CUDA_CHECK(cudaGetLastError());
+  WM_CUDA_DEBUG_SYNC_STREAM(stream);
+}
+
+REGISTER_DISPATCH_ONE_TYPE(MarkDirtyRowsTempFunc, mark_dirty_rows_temp_func, SINT3264)
+
+wholememory_error_code_t mark_dirty_rows(wholememory_tensor_t indices,
+                                         int64_t local_entry_offset,
+                                         uint32_t* dirty_bitmap,
+                                         cudaStream_t stream)
+{
+  try {
+    WHOLEMEMORY_CHECK_NOTHROW(indices != nullptr && dirty_bitmap != nullptr);
+    auto* indice_desc = wholememory_tensor_get_tensor_description(indices);
+    WHOLEMEMORY_CHECK_NOTHROW(indice_desc->dim == 1);
+    WHOLEMEMORY_CHECK_NOTHROW(indice_desc->storage_offset == 0);
+    DISPATCH_ONE_TYPE(indice_desc->dtype,
+                      MarkDirtyRowsTempFunc,
+                      wholememory_tensor_get_data_pointer(indices),
+                      indice_desc->sizes[0],
+                      local_entry_offset,
+                      dirty_bitmap,
+                      stream);
+  } catch (wholememory::logic_error& wle) {
+    WHOLEMEMORY_ERROR("%s", wle.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (wholememory::cuda_error& wce) {
+    WHOLEMEMORY_ERROR("%s", wce.what());
+    return WHOLEMEMORY_CUDA_ERROR;
+  } catch (...) {
+    WHOLEMEMORY_ERROR("File %s, line %d, Unknown error", __FILE__, __LINE__);
+    return WHOLEMEMORY_UNKNOW_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+__global__ void take_dirty_rows_kernel(uint32_t* dirty_bitmap,
+                                       uint32_t* taken_bitmap,
+                                       int64_t word_count)
+{
+  int64_t idx = blockIdx.x;
+  idx *= blockDim.x;
+  idx += threadIdx.x;
+  if (idx >= word_count) return;
+  taken_bitmap[idx] = atomicExch(dirty_bitmap + idx, 0U);
+}
+
+__global__ void restore_dirty_rows_kernel(uint32_t* dirty_bitmap,
+                                          const uint32_t* taken_bitmap,
+                                          int64_t word_count)
+{
+  int64_t idx = blockIdx.x;
+  idx *= blockDim.x;
+  idx += threadIdx.x;
+  if (idx >= word_count) return;
+  if (taken_bitmap[idx] != 0) atomicOr(dirty_bitmap + idx, taken_bitmap[idx]);
+}
+
+wholememory_error_code_t take_dirty_rows(uint32_t* dirty_bitmap,
+                                         uint32_t* taken_bitmap,
+                                         int64_t word_count,
+                                         cudaStream_t stream)
+{
+  WHOLEMEMORY_CHECK_NOTHROW(dirty_bitmap != nullptr && taken_bitmap != nullptr);
+  if (word_count == 0) return WHOLEMEMORY_SUCCESS;
+  try {
+    const int thread_count = 128;
+    int block_count = wholememory::div_rounding_up_safe<int64_t>(word_count, thread_count);
+    take_dirty_rows_kernel<<<block_count, thread_count, 0, stream>>>(
+      dirty_bitmap, taken_bitmap, word_count);
+    WM_CUDA_CHECK(cudaGetLastError());
+    WM_CUDA_DEBUG_SYNC_STREAM(stream);
+  } catch (wholememory::cuda_error& wce) {
+    WHOLEMEMORY_ERROR("%s", wce.what());
+    return WHOLEMEMORY_CUDA_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t restore_dirty_rows(uint32_t* dirty_bitmap,
+                                            const uint32_t* taken_bitmap,
+                                            int64_t word_count,
+                                            cudaStream_t stream)
+{
+  WHOLEMEMORY_CHECK_NOTHROW(dirty_bitmap != nullptr && taken_bitmap != nullptr);
+  if (word_count == 0) return WHOLEMEMORY_SUCCESS;
+  try {
+    const int thread_count = 128;
+    int block_count = wholememory::div_rounding_up_safe<int64_t>(word_count, thread_count);
+    restore_dirty_rows_kernel<<<block_count, thread_count, 0, stream>>>(
+      dirty_bitmap, taken_bitmap, word_count);
+    WM_CUDA_CHECK(cudaGetLastError());
+    WM_CUDA_DEBUG_SYNC_STREAM(stream);
+  } catch (wholememory::cuda_error& wce) {
+    WHOLEMEMORY_ERROR("%s", wce.what());
+    return WHOLEMEMORY_CUDA_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
 }  // namespace wholememory_ops
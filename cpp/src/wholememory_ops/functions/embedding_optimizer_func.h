@@ -22,8 +22,6 @@
 
 namespace wholememory_ops {
 
-void set_memory_to_float_value(float* data_ptr, float value, size_t elt_count, cudaStream_t stream);
-
 wholememory_error_code_t sgd_optimizer_step(wholememory_tensor_t indices,
                                             wholememory_tensor_t grads,
                                             wholememory_tensor_t local_embedding,
@@ -85,4 +83,26 @@ wholememory_error_code_t rms_prop_optimizer_step(wholememory_tensor_t indices,
                                                  float lr,
                                                  cudaStream_t stream);
 
+wholememory_error_code_t mark_dirty_rows(wholememory_tensor_t indices,
+                                         int64_t local_entry_offset,
+                                         uint32_t* dirty_bitmap,
+                                         cudaStream_t stream);
+
+/**
+ * Atomically move dirty bits into taken_bitmap and clear them, rows updated afterwards are marked
+ * dirty again.
+ */
+wholememory_error_code_t take_dirty_rows(uint32_t* dirty_bitmap,
+                                         uint32_t* taken_bitmap,
+                                         int64_t word_count,
+                                         cudaStream_t stream);
+
+/**
+ * Mark rows in taken_bitmap dirty again, used when saving taken rows failed.
+ */
+wholememory_error_code_t restore_dirty_rows(uint32_t* dirty_bitmap,
+                                            const uint32_t* taken_bitmap,
+                                            int64_t word_count,
+                                            cudaStream_t stream);
+
 }  // namespace wholememory_ops
@@ -25,6 +25,7 @@
 
 #include "cuda_macros.hpp"
 #include "logger.hpp"
+#include "wholememory/env_func_ptrs.hpp"
 #include "wholememory_ops/register.hpp"
 
 namespace wholememory_ops {
@@ -186,6 +187,7 @@ int64_t dedup_indice_and_gradients(const void* indices,
                                    wholememory_env_func_t* p_env_fn,
                                    cudaStream_t stream)
 {
+  wholememory::temp_memory_stream_guard stream_guard(stream);
   WHOLEMEMORY_CHECK_NOTHROW(indice_desc.dtype == WHOLEMEMORY_DT_INT ||
                             indice_desc.dtype == WHOLEMEMORY_DT_INT64);
   WHOLEMEMORY_CHECK_NOTHROW(indice_desc.size == grads_desc.sizes[0]);
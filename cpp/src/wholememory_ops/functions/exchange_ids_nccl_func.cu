@@ -22,6 +22,7 @@
 #include "error.hpp"
 #include "logger.hpp"
 #include "wholememory/communicator.hpp"
+#include "wholememory/env_func_ptrs.hpp"
 #include "wholememory_ops/register.hpp"
 
 namespace wholememory_ops {
@@ -126,6 +127,7 @@ wholememory_error_code_t exchange_ids_func(const void* indices_before_sort,
                                            wm_thrust_allocator* p_thrust_allocator,
                                            cudaStream_t stream)
 {
+  wholememory::temp_memory_stream_guard stream_guard(stream);
   try {
     DISPATCH_ONE_TYPE(indices_desc.dtype,
                       ExchangeIDsNCCL,
@@ -165,6 +167,7 @@ wholememory_error_code_t bucket_and_exchange_ids_func(
   wholememory_env_func_t* p_env_fns,
   cudaStream_t stream)
 {
+  wholememory::temp_memory_stream_guard stream_guard(stream);
   int world_size;
   WHOLEMEMORY_RETURN_ON_FAIL(wholememory_communicator_get_size(&world_size, wm_comm));
 
@@ -0,0 +1,561 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "host_gather_scatter_func.h"
+
+#include <cuda_runtime_api.h>
+#include <strings.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "error.hpp"
+#include "logger.hpp"
+#include "parallel_utils.hpp"
+#include "wholememory/communicator.hpp"
+#include "wholememory_ops/register.hpp"
+
+namespace wholememory_ops {
+
+namespace {
+
+// rows ahead of current row to prefetch, and at most how many bytes of each row to prefetch.
+constexpr int64_t kHostPrefetchRowDistance = 8;
+constexpr int64_t kHostPrefetchMaxBytes    = 512;
+constexpr int64_t kHostCacheLineSize       = 64;
+// don't split work smaller than this into more tasks.
+constexpr int64_t kHostMinBytesPerTask = 64 * 1024;
+
+template <typename DataTypeT>
+class host_type_caster {
+ public:
+  using LoadTypeT = DataTypeT;
+  static inline LoadTypeT convert_load_data(DataTypeT data) { return data; }
+  template <typename StoreTypeT>
+  static inline DataTypeT convert_store_data(StoreTypeT data)
+  {
+    return static_cast<DataTypeT>(data);
+  }
+};
+template <>
+class host_type_caster<__half> {
+ public:
+  using LoadTypeT = float;
+  static inline LoadTypeT convert_load_data(__half data) { return static_cast<float>(data); }
+  template <typename StoreTypeT>
+  static inline __half convert_store_data(StoreTypeT data)
+  {
+    return static_cast<__half>(static_cast<float>(data));
+  }
+};
+template <>
+class host_type_caster<__nv_bfloat16> {
+ public:
+  using LoadTypeT = float;
+  static inline LoadTypeT convert_load_data(__nv_bfloat16 data)
+  {
+    return static_cast<float>(data);
+  }
+  template <typename StoreTypeT>
+  static inline __nv_bfloat16 convert_store_data(StoreTypeT data)
+  {
+    return static_cast<__nv_bfloat16>(static_cast<float>(data));
+  }
+};
+
+template <typename FromT, typename ToT>
+inline void host_copy_row(const FromT* from, ToT* to, int64_t count)
+{
+  if constexpr (std::is_same_v<FromT, ToT>) {
+    std::memcpy(to, from, count * sizeof(FromT));
+  } else {
+    // simple loop without aliasing so that compiler can vectorize it.
+    for (int64_t i = 0; i < count; i++) {
+      to[i] = host_type_caster<ToT>::convert_store_data(
+        host_type_caster<FromT>::convert_load_data(from[i]));
+    }
+  }
+}
+
+inline void host_prefetch_row(const void* ptr, int64_t row_bytes, bool for_write)
+{
+  const char* row_ptr  = static_cast<const char*>(ptr);
+  int64_t prefetch_len = std::min(row_bytes, kHostPrefetchMaxBytes);
+  for (int64_t offset = 0; offset < prefetch_len; offset += kHostCacheLineSize) {
+    if (for_write) {
+      __builtin_prefetch(row_ptr + offset, 1, 1);
+    } else {
+      __builtin_prefetch(row_ptr + offset, 0, 1);
+    }
+  }
+}
+
+int determine_host_task_count(int64_t row_count, int64_t row_bytes, int max_thread_count)
+{
+  int64_t total_bytes = row_count * row_bytes;
+  int64_t task_count  = total_bytes / kHostMinBytesPerTask;
+  task_count = std::min<int64_t>(task_count, std::min(max_thread_count, GetThreadPoolSize()));
+  task_count = std::min<int64_t>(task_count, row_count);
+  return static_cast<int>(std::max<int64_t>(task_count, 1));
+}
+
+/**
+ * Copy rows from[from_indices[i]] to to[to_indices[i]], nullptr indices means identity.
+ * Rows pointed by indices are randomly accessed and prefetched.
+ */
+template <typename FromT, typename IndexT, typename ToT>
+void host_copy_rows(const FromT* from,
+                    int64_t from_stride,
+                    const IndexT* from_indices,
+                    ToT* to,
+                    int64_t to_stride,
+                    const IndexT* to_indices,
+                    int64_t row_count,
+                    int64_t embedding_dim,
+                    int max_thread_count)
+{
+  const bool random_from = from_indices != nullptr;
+  const int64_t row_bytes =
+    embedding_dim * static_cast<int64_t>(random_from ? sizeof(FromT) : sizeof(ToT));
+  int task_count = determine_host_task_count(row_count, row_bytes, max_thread_count);
+  ThreadPoolRun(task_count, [&](int task_id, int task_num) {
+    int64_t start = row_count * task_id / task_num;
+    int64_t end   = row_count * (task_id + 1) / task_num;
+    for (int64_t i = start; i < end; i++) {
+      if (i + kHostPrefetchRowDistance < end) {
+        int64_t next = i + kHostPrefetchRowDistance;
+        if (random_from) {
+          host_prefetch_row(from + static_cast<int64_t>(from_indices[next]) * from_stride,
+                            row_bytes,
+                            false);
+        } else {
+          host_prefetch_row(
+            to + static_cast<int64_t>(to_indices[next]) * to_stride, row_bytes, true);
+        }
+      }
+      int64_t from_row = random_from ? static_cast<int64_t>(from_indices[i]) : i;
+      int64_t to_row   = random_from ? i : static_cast<int64_t>(to_indices[i]);
+      host_copy_row(from + from_row * from_stride, to + to_row * to_stride, embedding_dim);
+    }
+  });
+}
+
+template <typename EmbeddingT, typename IndexT, typename OutputT>
+void host_gather_temp_func(const void* embedding,
+                           wholememory_matrix_description_t embedding_desc,
+                           const void* indices,
+                           int64_t indice_count,
+                           void* output,
+                           wholememory_matrix_description_t output_desc,
+                           int max_thread_count)
+{
+  host_copy_rows<EmbeddingT, IndexT, OutputT>(
+    static_cast<const EmbeddingT*>(embedding) + embedding_desc.storage_offset,
+    embedding_desc.stride,
+    static_cast<const IndexT*>(indices),
+    static_cast<OutputT*>(output) + output_desc.storage_offset,
+    output_desc.stride,
+    nullptr,
+    indice_count,
+    embedding_desc.sizes[1],
+    max_thread_count);
+}
+
+template <typename InputT, typename IndexT, typename EmbeddingT>
+void host_scatter_temp_func(const void* input,
+                            wholememory_matrix_description_t input_desc,
+                            const void* indices,
+                            int64_t indice_count,
+                            void* embedding,
+                            wholememory_matrix_description_t embedding_desc,
+                            int max_thread_count)
+{
+  host_copy_rows<InputT, IndexT, EmbeddingT>(
+    static_cast<const InputT*>(input) + input_desc.storage_offset,
+    input_desc.stride,
+    nullptr,
+    static_cast<EmbeddingT*>(embedding) + embedding_desc.storage_offset,
+    embedding_desc.stride,
+    static_cast<const IndexT*>(indices),
+    indice_count,
+    embedding_desc.sizes[1],
+    max_thread_count);
+}
+
+REGISTER_DISPATCH_THREE_TYPES(
+  HostGatherFuncFloating, host_gather_temp_func, ALLFLOAT, SINT3264, ALLFLOAT)
+REGISTER_DISPATCH_THREE_TYPES(
+  HostGatherFuncInteger, host_gather_temp_func, ALLSINT, SINT3264, ALLSINT)
+REGISTER_DISPATCH_THREE_TYPES(
+  HostScatterFuncFloating, host_scatter_temp_func, ALLFLOAT, SINT3264, ALLFLOAT)
+REGISTER_DISPATCH_THREE_TYPES(
+  HostScatterFuncInteger, host_scatter_temp_func, ALLSINT, SINT3264, ALLSINT)
+
+template <typename IndexT>
+void host_bucket_ids_temp_func(const void* indices,
+                               int64_t indice_count,
+                               int64_t embedding_entry_count_per_rank,
+                               int world_size,
+                               int64_t* rank_id_count,
+                               int64_t* bucketed_ids,
+                               int64_t* bucketed_raw_indices,
+                               bool* has_invalid_id,
+                               int64_t* invalid_id)
+{
+  const auto* indices_ptr = static_cast<const IndexT*>(indices);
+  std::vector<int64_t> rank_offsets(world_size, 0);
+  for (int64_t i = 0; i < indice_count; i++) {
+    int64_t id = indices_ptr[i];
+    // out of range ids are reported to caller, which still joins the id count exchange.
+    if (id < 0 || id / embedding_entry_count_per_rank >= world_size) {
+      *has_invalid_id = true;
+      *invalid_id     = id;
+      return;
+    }
+    rank_offsets[id / embedding_entry_count_per_rank]++;
+  }
+  int64_t offset = 0;
+  for (int r = 0; r < world_size; r++) {
+    rank_id_count[r] = rank_offsets[r];
+    rank_offsets[r]  = offset;
+    offset += rank_id_count[r];
+  }
+  for (int64_t i = 0; i < indice_count; i++) {
+    int64_t id                = indices_ptr[i];
+    int64_t pos               = rank_offsets[id / embedding_entry_count_per_rank]++;
+    bucketed_ids[pos]         = id;
+    bucketed_raw_indices[pos] = i;
+  }
+}
+
+REGISTER_DISPATCH_ONE_TYPE(HostBucketIds, host_bucket_ids_temp_func, SINT3264)
+
+bool check_host_number_type(wholememory_dtype_t embedding_dtype, wholememory_dtype_t data_dtype)
+{
+  bool embedding_is_float = wholememory_dtype_is_floating_number(embedding_dtype);
+  WHOLEMEMORY_CHECK(embedding_is_float || wholememory_dtype_is_integer_number(embedding_dtype));
+  bool data_is_float = wholememory_dtype_is_floating_number(data_dtype);
+  WHOLEMEMORY_CHECK(data_is_float || wholememory_dtype_is_integer_number(data_dtype));
+  WHOLEMEMORY_EXPECTS(
+    embedding_is_float == data_is_float,
+    "embedding and data should be same number type, e.g. floating number or integer number.");
+  return embedding_is_float;
+}
+
+}  // namespace
+
+bool is_host_memory_pointer(const void* ptr)
+{
+  if (ptr == nullptr) return false;
+  cudaPointerAttributes attributes;
+  cudaError_t const status = cudaPointerGetAttributes(&attributes, ptr);
+  if (status != cudaSuccess) {
+    (void)cudaGetLastError();
+    // without usable CUDA device no pointer is device memory, otherwise pointer is invalid.
+    return status == cudaErrorNoDevice || status == cudaErrorInsufficientDriver;
+  }
+  return attributes.type == cudaMemoryTypeHost || attributes.type == cudaMemoryTypeUnregistered;
+}
+
+bool is_host_gather_scatter_check_enabled()
+{
+  const char* check_str = std::getenv("WHOLEMEMORY_CHECK_HOST_GATHER_SCATTER");
+  if (check_str == nullptr) return false;
+  return strcmp(check_str, "1") == 0 || strcasecmp(check_str, "true") == 0 ||
+         strcasecmp(check_str, "on") == 0;
+}
+
+wholememory_error_code_t should_use_host_gather_scatter(wholememory_tensor_t wholememory_tensor,
+                                                        const void* indices,
+                                                        const void* data,
+                                                        bool* use_host)
+{
+  *use_host = false;
+  if (!wholememory_tensor_has_handle(wholememory_tensor)) return WHOLEMEMORY_SUCCESS;
+  auto* wholememory_handle = wholememory_tensor_get_memory_handle(wholememory_tensor);
+  auto memory_location     = wholememory_get_memory_location(wholememory_handle);
+  if (memory_location != WHOLEMEMORY_ML_HOST && memory_location != WHOLEMEMORY_ML_FILE) {
+    return WHOLEMEMORY_SUCCESS;
+  }
+  wholememory_comm_t wm_comm;
+  WHOLEMEMORY_RETURN_ON_FAIL(wholememory_get_communicator(&wm_comm, wholememory_handle));
+  // host only communicator has no device memory at all.
+  if (wholememory::is_host_only_communicator(wm_comm)) {
+    *use_host = true;
+    return WHOLEMEMORY_SUCCESS;
+  }
+  // nullptr, e.g. of empty indices, goes the host path like host buffers of the same tensor.
+  bool const has_pointer = indices != nullptr || data != nullptr;
+  bool const local_host  = (indices == nullptr || is_host_memory_pointer(indices)) &&
+                          (data == nullptr || is_host_memory_pointer(data));
+  // distributed path exchanges data with all ranks, so all ranks must take the same path. Callers
+  // pass buffers of same location on all ranks, the collective check is only done on request.
+  if (wholememory_get_memory_type(wholememory_handle) != WHOLEMEMORY_MT_DISTRIBUTED ||
+      !is_host_gather_scatter_check_enabled()) {
+    *use_host = local_host;
+    return WHOLEMEMORY_SUCCESS;
+  }
+  // ranks with nullptr abstain from the vote and follow the other ranks.
+  int local_votes[2] = {has_pointer && local_host ? 1 : 0, has_pointer && !local_host ? 1 : 0};
+  int total_votes[2] = {0, 0};
+  try {
+    wm_comm->host_allreduce(local_votes, total_votes, 2, WHOLEMEMORY_DT_INT, ncclSum);
+  } catch (wholememory::logic_error& wle) {
+    WHOLEMEMORY_ERROR("%s", wle.what());
+    return WHOLEMEMORY_COMMUNICATION_ERROR;
+  }
+  if (total_votes[0] > 0 && total_votes[1] > 0) {
+    WHOLEMEMORY_ERROR(
+      "%d ranks passed host memory and %d ranks passed device memory to distributed host "
+      "WholeMemory, all ranks should pass indices and data of same location.",
+      total_votes[0],
+      total_votes[1]);
+    return WHOLEMEMORY_INVALID_INPUT;
+  }
+  *use_host = total_votes[1] == 0;
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t host_bucket_and_exchange_ids_func(
+  const void* indices,
+  wholememory_array_description_t indices_desc,
+  std::vector<int64_t>* host_recv_rank_id_count,
+  std::vector<int64_t>* host_rank_id_count,
+  std::vector<int64_t>* recv_indices,
+  std::vector<int64_t>* bucketed_raw_indices,
+  size_t embedding_entry_count_per_rank,
+  wholememory_comm_t wm_comm)
+{
+  try {
+    int world_size = wm_comm->world_size;
+    host_rank_id_count->assign(world_size, 0);
+    host_recv_rank_id_count->assign(world_size, 0);
+    std::vector<int64_t> bucketed_ids(indices_desc.size);
+    bucketed_raw_indices->resize(indices_desc.size);
+    bool local_invalid = false;
+    if (indices_desc.dtype != WHOLEMEMORY_DT_INT && indices_desc.dtype != WHOLEMEMORY_DT_INT64) {
+      WHOLEMEMORY_ERROR("indices should be int or int64.");
+      local_invalid = true;
+    } else {
+      const void* indices_ptr =
+        static_cast<const char*>(indices) +
+        indices_desc.storage_offset * wholememory_dtype_get_element_size(indices_desc.dtype);
+      bool has_invalid_id = false;
+      int64_t invalid_id  = 0;
+      DISPATCH_ONE_TYPE(indices_desc.dtype,
+                        HostBucketIds,
+                        indices_ptr,
+                        indices_desc.size,
+                        static_cast<int64_t>(embedding_entry_count_per_rank),
+                        world_size,
+                        host_rank_id_count->data(),
+                        bucketed_ids.data(),
+                        bucketed_raw_indices->data(),
+                        &has_invalid_id,
+                        &invalid_id);
+      if (has_invalid_id) {
+        WHOLEMEMORY_ERROR("index %ld out of range.", invalid_id);
+        local_invalid = true;
+      }
+    }
+    // invalid input is sent as negative counts, so all ranks fail together after the exchange.
+    if (local_invalid) host_rank_id_count->assign(world_size, -1);
+    wm_comm->host_alltoall(
+      host_rank_id_count->data(), host_recv_rank_id_count->data(), 1, WHOLEMEMORY_DT_INT64);
+    if (local_invalid || std::any_of(host_recv_rank_id_count->begin(),
+                                     host_recv_rank_id_count->end(),
+                                     [](int64_t count) { return count < 0; })) {
+      return WHOLEMEMORY_INVALID_INPUT;
+    }
+    std::vector<size_t> send_counts(world_size), send_displs(world_size);
+    std::vector<size_t> recv_counts(world_size), recv_displs(world_size);
+    size_t send_offset = 0, recv_offset = 0;
+    for (int r = 0; r < world_size; r++) {
+      send_counts[r] = host_rank_id_count->at(r);
+      recv_counts[r] = host_recv_rank_id_count->at(r);
+      send_displs[r] = send_offset;
+      recv_displs[r] = recv_offset;
+      send_offset += send_counts[r];
+      recv_offset += recv_counts[r];
+    }
+    recv_indices->resize(recv_offset);
+    wm_comm->host_alltoallv(bucketed_ids.data(),
+                            recv_indices->data(),
+                            send_counts.data(),
+                            send_displs.data(),
+                            recv_counts.data(),
+                            recv_displs.data(),
+                            WHOLEMEMORY_DT_INT64);
+  } catch (const wholememory::logic_error& le) {
+    WHOLEMEMORY_ERROR("host bucket and exchange ids LOGIC Error %s\n", le.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (const wholememory::cuda_error& ce) {
+    WHOLEMEMORY_ERROR("host bucket and exchange ids CUDA Error %s\n", ce.what());
+    return WHOLEMEMORY_CUDA_ERROR;
+  } catch (const raft::exception& re) {
+    WHOLEMEMORY_ERROR("host bucket and exchange ids RAFT Error %s\n", re.what());
+    return WHOLEMEMORY_COMMUNICATION_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_UNKNOW_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t host_exchange_rows_func(const void* send_rows,
+                                                 const int64_t* host_send_row_count,
+                                                 void* recv_rows,
+                                                 const int64_t* host_recv_row_count,
+                                                 size_t row_size,
+                                                 wholememory_comm_t wm_comm)
+{
+  try {
+    int world_size = wm_comm->world_size;
+    std::vector<size_t> send_counts(world_size), send_displs(world_size);
+    std::vector<size_t> recv_counts(world_size), recv_displs(world_size);
+    size_t send_offset = 0, recv_offset = 0;
+    for (int r = 0; r < world_size; r++) {
+      send_counts[r] = host_send_row_count[r] * row_size;
+      recv_counts[r] = host_recv_row_count[r] * row_size;
+      send_displs[r] = send_offset;
+      recv_displs[r] = recv_offset;
+      send_offset += send_counts[r];
+      recv_offset += recv_counts[r];
+    }
+    wm_comm->host_alltoallv(send_rows,
+                            recv_rows,
+                            send_counts.data(),
+                            send_displs.data(),
+                            recv_counts.data(),
+                            recv_displs.data(),
+                            WHOLEMEMORY_DT_INT8);
+  } catch (const wholememory::logic_error& le) {
+    WHOLEMEMORY_ERROR("host exchange rows LOGIC Error %s\n", le.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (const wholememory::cuda_error& ce) {
+    WHOLEMEMORY_ERROR("host exchange rows CUDA Error %s\n", ce.what());
+    return WHOLEMEMORY_CUDA_ERROR;
+  } catch (const raft::exception& re) {
+    WHOLEMEMORY_ERROR("host exchange rows RAFT Error %s\n", re.what());
+    return WHOLEMEMORY_COMMUNICATION_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_UNKNOW_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t host_gather_func(const void* embedding,
+                                          wholememory_matrix_description_t embedding_desc,
+                                          const void* indices,
+                                          wholememory_array_description_t indices_desc,
+                                          void* output,
+                                          wholememory_matrix_description_t output_desc,
+                                          int max_thread_count)
+{
+  try {
+    bool is_float = check_host_number_type(embedding_desc.dtype, output_desc.dtype);
+    WHOLEMEMORY_CHECK(indices_desc.dtype == WHOLEMEMORY_DT_INT ||
+                      indices_desc.dtype == WHOLEMEMORY_DT_INT64);
+    if (indices_desc.size == 0) { return WHOLEMEMORY_SUCCESS; }
+    const void* indices_ptr =
+      static_cast<const char*>(indices) +
+      indices_desc.storage_offset * wholememory_dtype_get_element_size(indices_desc.dtype);
+    if (is_float) {
+      DISPATCH_THREE_TYPES(embedding_desc.dtype,
+                           indices_desc.dtype,
+                           output_desc.dtype,
+                           HostGatherFuncFloating,
+                           embedding,
+                           embedding_desc,
+                           indices_ptr,
+                           indices_desc.size,
+                           output,
+                           output_desc,
+                           max_thread_count);
+    } else {
+      DISPATCH_THREE_TYPES(embedding_desc.dtype,
+                           indices_desc.dtype,
+                           output_desc.dtype,
+                           HostGatherFuncInteger,
+                           embedding,
+                           embedding_desc,
+                           indices_ptr,
+                           indices_desc.size,
+                           output,
+                           output_desc,
+                           max_thread_count);
+    }
+  } catch (const wholememory::logic_error& le) {
+    WHOLEMEMORY_ERROR("host gather LOGIC Error %s\n", le.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+wholememory_error_code_t host_scatter_func(const void* input,
+                                           wholememory_matrix_description_t input_desc,
+                                           const void* indices,
+                                           wholememory_array_description_t indices_desc,
+                                           void* embedding,
+                                           wholememory_matrix_description_t embedding_desc,
+                                           int max_thread_count)
+{
+  try {
+    bool is_float = check_host_number_type(embedding_desc.dtype, input_desc.dtype);
+    WHOLEMEMORY_CHECK(indices_desc.dtype == WHOLEMEMORY_DT_INT ||
+                      indices_desc.dtype == WHOLEMEMORY_DT_INT64);
+    if (indices_desc.size == 0) { return WHOLEMEMORY_SUCCESS; }
+    const void* indices_ptr =
+      static_cast<const char*>(indices) +
+      indices_desc.storage_offset * wholememory_dtype_get_element_size(indices_desc.dtype);
+    if (is_float) {
+      DISPATCH_THREE_TYPES(input_desc.dtype,
+                           indices_desc.dtype,
+                           embedding_desc.dtype,
+                           HostScatterFuncFloating,
+                           input,
+                           input_desc,
+                           indices_ptr,
+                           indices_desc.size,
+                           embedding,
+                           embedding_desc,
+                           max_thread_count);
+    } else {
+      DISPATCH_THREE_TYPES(input_desc.dtype,
+                           indices_desc.dtype,
+                           embedding_desc.dtype,
+                           HostScatterFuncInteger,
+                           input,
+                           input_desc,
+                           indices_ptr,
+                           indices_desc.size,
+                           embedding,
+                           embedding_desc,
+                           max_thread_count);
+    }
+  } catch (const wholememory::logic_error& le) {
+    WHOLEMEMORY_ERROR("host scatter LOGIC Error %s\n", le.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (...) {
+    return WHOLEMEMORY_LOGIC_ERROR;
+  }
+  return WHOLEMEMORY_SUCCESS;
+}
+
+}  // namespace wholememory_ops
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <vector>
+
+#include <wholememory/tensor_description.h>
+#include <wholememory/wholememory.h>
+#include <wholememory/wholememory_tensor.h>
+
+namespace wholememory_ops {
+
+/**
+ * Check if pointer can be accessed by CPU, e.g. pageable or pinned host memory.
+ * @param ptr : pointer to check
+ * @return : true if ptr is host memory, false for device memory and pointers CUDA rejects
+ */
+bool is_host_memory_pointer(const void* ptr);
+
+/**
+ * Whether distributed host gather and scatter check that all ranks take same path, configured by
+ * WHOLEMEMORY_CHECK_HOST_GATHER_SCATTER. The check costs one host allreduce per call.
+ * @return : true if the check is enabled
+ */
+bool is_host_gather_scatter_check_enabled();
+
+/**
+ * Check if gather or scatter of wholememory_tensor should run on CPU.
+ * That is when wholememory_tensor is in host or file memory, and indices and data are host memory.
+ * Each rank decides from its own pointers, so for WHOLEMEMORY_MT_DISTRIBUTED all ranks should pass
+ * indices and data of same location. nullptr, e.g. of an empty batch, goes the host path, so ranks
+ * using device buffers should pass non null pointers for empty batches. With
+ * WHOLEMEMORY_CHECK_HOST_GATHER_SCATTER set, ranks of distributed memory vote on the path instead,
+ * nullptr can go either path, and ranks passing host memory mixed with ranks passing device memory
+ * is invalid input. The vote is collective, so all ranks should call this together then.
+ * @param wholememory_tensor : WholeMemory Tensor
+ * @param indices : pointer to indices
+ * @param data : pointer to output of gather or input of scatter
+ * @param use_host : returns true if should run on CPU
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t should_use_host_gather_scatter(wholememory_tensor_t wholememory_tensor,
+                                                        const void* indices,
+                                                        const void* data,
+                                                        bool* use_host);
+
+/**
+ * Gather rows of host embedding into host output using host thread pool.
+ * @param embedding : host pointer of embedding, row 0 of embedding_desc starts here
+ * @param embedding_desc : matrix description of embedding
+ * @param indices : host pointer of indices
+ * @param indices_desc : array description of indices
+ * @param output : host pointer of output
+ * @param output_desc : matrix description of output
+ * @param max_thread_count : maximum thread count to use
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t host_gather_func(const void* embedding,
+                                          wholememory_matrix_description_t embedding_desc,
+                                          const void* indices,
+                                          wholememory_array_description_t indices_desc,
+                                          void* output,
+                                          wholememory_matrix_description_t output_desc,
+                                          int max_thread_count);
+
+/**
+ * Scatter rows of host input into host embedding using host thread pool.
+ * @param input : host pointer of input
+ * @param input_desc : matrix description of input
+ * @param indices : host pointer of indices
+ * @param indices_desc : array description of indices
+ * @param embedding : host pointer of embedding, row 0 of embedding_desc starts here
+ * @param embedding_desc : matrix description of embedding
+ * @param max_thread_count : maximum thread count to use
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t host_scatter_func(const void* input,
+                                           wholememory_matrix_description_t input_desc,
+                                           const void* indices,
+                                           wholememory_array_description_t indices_desc,
+                                           void* embedding,
+                                           wholememory_matrix_description_t embedding_desc,
+                                           int max_thread_count);
+
+/**
+ * Bucket host indices by owner rank and exchange them with all ranks through host collectives.
+ * @param indices : host pointer of indices
+ * @param indices_desc : array description of indices
+ * @param host_recv_rank_id_count : output, id count received from each rank
+ * @param host_rank_id_count : output, id count sent to each rank
+ * @param recv_indices : output, ids received from all ranks, in rank order
+ * @param bucketed_raw_indices : output, position in indices of each sent id, in rank order
+ * @param embedding_entry_count_per_rank : entry count of each rank's partition
+ * @param wm_comm : WholeMemory Communicator
+ * @return : wholememory_error_code_t, WHOLEMEMORY_INVALID_INPUT on all ranks if indices of any rank
+ * are out of range
+ */
+wholememory_error_code_t host_bucket_and_exchange_ids_func(
+  const void* indices,
+  wholememory_array_description_t indices_desc,
+  std::vector<int64_t>* host_recv_rank_id_count,
+  std::vector<int64_t>* host_rank_id_count,
+  std::vector<int64_t>* recv_indices,
+  std::vector<int64_t>* bucketed_raw_indices,
+  size_t embedding_entry_count_per_rank,
+  wholememory_comm_t wm_comm);
+
+/**
+ * Exchange packed host rows with all ranks through host collectives.
+ * @param send_rows : host pointer of rows to send, in rank order
+ * @param host_send_row_count : row count sent to each rank
+ * @param recv_rows : host pointer of rows to receive, in rank order
+ * @param host_recv_row_count : row count received from each rank
+ * @param row_size : size of each row in bytes
+ * @param wm_comm : WholeMemory Communicator
+ * @return : wholememory_error_code_t
+ */
+wholememory_error_code_t host_exchange_rows_func(const void* send_rows,
+                                                 const int64_t* host_send_row_count,
+                                                 void* recv_rows,
+                                                 const int64_t* host_recv_row_count,
+                                                 size_t row_size,
+                                                 wholememory_comm_t wm_comm);
+
+}  // namespace wholememory_ops
@@ -15,10 +15,12 @@
  */
 #include <wholememory/wholememory_op.h>
 
+#include <wholememory_ops/functions/host_gather_scatter_func.h>
 #include <wholememory_ops/gather_op_impl.h>
 
 #include "error.hpp"
 #include "logger.hpp"
+#include "wholememory/env_func_ptrs.hpp"
 
 wholememory_error_code_t wholememory_gather(wholememory_tensor_t wholememory_tensor,
                                             wholememory_tensor_t indices_tensor,
@@ -26,6 +28,7 @@ wholememory_error_code_t wholememory_gather(wholememory_tensor_t wholememory_ten
                                             wholememory_env_func_t* p_env_fns,
                                             void* stream)
 {
+  wholememory::temp_memory_stream_guard stream_guard(static_cast<cudaStream_t>(stream));
   bool const has_handle                 = wholememory_tensor_has_handle(wholememory_tensor);
   wholememory_memory_type_t memory_type = WHOLEMEMORY_MT_NONE;
   if (has_handle) {
@@ -77,6 +80,19 @@ wholememory_error_code_t wholememory_gather(wholememory_tensor_t wholememory_ten
     WHOLEMEMORY_ERROR("Convert output tensor to matrix failed.");
     return WHOLEMEMORY_INVALID_INPUT;
   }
+  bool use_host = false;
+  WHOLEMEMORY_RETURN_ON_FAIL(wholememory_ops::should_use_host_gather_scatter(
+    wholememory_tensor, indices, output, &use_host));
+  if (use_host) {
+    return wholememory_ops::wholememory_gather_host(
+      wholememory_tensor_get_memory_handle(wholememory_tensor),
+      matrix_description,
+      indices,
+      indices_desc,
+      output,
+      output_desc,
+      static_cast<cudaStream_t>(stream));
+  }
   if (has_handle && memory_type == WHOLEMEMORY_MT_DISTRIBUTED) {
     return wholememory_ops::wholememory_gather_distributed(
       wholememory_tensor_get_memory_handle(wholememory_tensor),
@@ -49,6 +49,14 @@ wholememory_error_code_t wholememory_gather_distributed(
   wholememory_env_func_t* p_env_fns,
   cudaStream_t stream);
 
+wholememory_error_code_t wholememory_gather_host(wholememory_handle_t wholememory_handle,
+                                                 wholememory_matrix_description_t wholememory_desc,
+                                                 void* indices,
+                                                 wholememory_array_description_t indice_desc,
+                                                 void* output,
+                                                 wholememory_matrix_description_t output_desc,
+                                                 cudaStream_t stream);
+
 #ifdef WITH_NVSHMEM_SUPPORT
 
 wholememory_error_code_t wholememory_gather_nvshmem(
@@ -15,10 +15,13 @@
  */
 #include <wholememory/wholememory_op.h>
 
+#include <wholememory_ops/functions/host_gather_scatter_func.h>
 #include <wholememory_ops/scatter_op_impl.h>
 
 #include "error.hpp"
 #include "logger.hpp"
+#include "wholememory/env_func_ptrs.hpp"
+#include "wholememory/memory_handle.hpp"
 
 wholememory_error_code_t wholememory_scatter(wholememory_tensor_t input_tensor,
                                              wholememory_tensor_t indices_tensor,
@@ -26,11 +29,16 @@ wholememory_error_code_t wholememory_scatter(wholememory_tensor_t input_tensor,
                                              wholememory_env_func_t* p_env_fns,
                                              void* stream)
 {
+  wholememory::temp_memory_stream_guard stream_guard(static_cast<cudaStream_t>(stream));
   bool const has_handle                 = wholememory_tensor_has_handle(wholememory_tensor);
   wholememory_memory_type_t memory_type = WHOLEMEMORY_MT_NONE;
   if (has_handle) {
     memory_type =
       wholememory_get_memory_type(wholememory_tensor_get_memory_handle(wholememory_tensor));
+    if (!wholememory::is_writable(wholememory_tensor_get_memory_handle(wholememory_tensor))) {
+      WHOLEMEMORY_ERROR("wholememory_tensor is read only, map files with write back to scatter.");
+      return WHOLEMEMORY_INVALID_INPUT;
+    }
   }
   wholememory_matrix_description_t matrix_description;
   auto tensor_description = *wholememory_tensor_get_tensor_description(wholememory_tensor);
@@ -77,6 +85,19 @@ wholememory_error_code_t wholememory_scatter(wholememory_tensor_t input_tensor,
     WHOLEMEMORY_ERROR("Convert input tensor to matrix failed.");
     return WHOLEMEMORY_INVALID_INPUT;
   }
+  bool use_host = false;
+  WHOLEMEMORY_RETURN_ON_FAIL(wholememory_ops::should_use_host_gather_scatter(
+    wholememory_tensor, indices, input, &use_host));
+  if (use_host) {
+    return wholememory_ops::wholememory_scatter_host(
+      input,
+      input_desc,
+      indices,
+      indices_desc,
+      wholememory_tensor_get_memory_handle(wholememory_tensor),
+      matrix_description,
+      static_cast<cudaStream_t>(stream));
+  }
   if (has_handle && memory_type == WHOLEMEMORY_MT_DISTRIBUTED) {
     return wholememory_ops::wholememory_scatter_distributed(
       input,
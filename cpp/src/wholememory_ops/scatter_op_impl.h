@@ -49,6 +49,14 @@ wholememory_error_code_t wholememory_scatter_distributed(
   wholememory_env_func_t* p_env_fns,
   cudaStream_t stream);
 
+wholememory_error_code_t wholememory_scatter_host(void* input,
+                                                  wholememory_matrix_description_t input_desc,
+                                                  void* indices,
+                                                  wholememory_array_description_t indices_desc,
+                                                  wholememory_handle_t wholememory_handle,
+                                                  wholememory_matrix_description_t wholememory_desc,
+                                                  cudaStream_t stream);
+
 #ifdef WITH_NVSHMEM_SUPPORT
 wholememory_error_code_t wholememory_scatter_nvshmem(
   void* input,
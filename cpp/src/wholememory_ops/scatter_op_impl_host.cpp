@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cuda_runtime_api.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <wholememory/env_func_ptrs.h>
+#include <wholememory/wholememory.h>
+
+#include "cuda_macros.hpp"
+#include "logger.hpp"
+#include "parallel_utils.hpp"
+#include "wholememory/communicator.hpp"
+#include "wholememory_ops/functions/host_gather_scatter_func.h"
+#include "wholememory_ops/scatter_op_impl.h"
+
+namespace wholememory_ops {
+
+wholememory_error_code_t wholememory_scatter_host(void* input,
+                                                  wholememory_matrix_description_t input_desc,
+                                                  void* indices,
+                                                  wholememory_array_description_t indices_desc,
+                                                  wholememory_handle_t wholememory_handle,
+                                                  wholememory_matrix_description_t wholememory_desc,
+                                                  cudaStream_t stream)
+{
+  try {
+    if (wholememory_desc.storage_offset < 0 ||
+        wholememory_desc.storage_offset + wholememory_desc.sizes[1] > wholememory_desc.stride) {
+      WHOLEMEMORY_ERROR("invalid input offset=%ld, size[1]=%ld, stride=%ld\n",
+                        wholememory_desc.storage_offset,
+                        wholememory_desc.sizes[1],
+                        wholememory_desc.stride);
+      return WHOLEMEMORY_INVALID_INPUT;
+    }
+    wholememory_comm_t wm_comm;
+    WHOLEMEMORY_RETURN_ON_FAIL(wholememory_get_communicator(&wm_comm, wholememory_handle));
+    // input and indices may be produced by previous work in stream, e.g. copy to pinned memory.
+    // host only communicator may run without CUDA device, so no stream to wait.
+    if (!wholememory::is_host_only_communicator(wm_comm)) {
+      WM_CUDA_CHECK(cudaStreamSynchronize(stream));
+    }
+    int max_thread_count =
+      std::max(1, GetProcessorCount() / std::max(1, wm_comm->intra_node_rank_num));
+
+    if (wholememory_get_memory_type(wholememory_handle) != WHOLEMEMORY_MT_DISTRIBUTED) {
+      void* global_ptr = nullptr;
+      WHOLEMEMORY_RETURN_ON_FAIL(wholememory_get_global_pointer(&global_ptr, wholememory_handle));
+      return host_scatter_func(input,
+                               input_desc,
+                               indices,
+                               indices_desc,
+                               global_ptr,
+                               wholememory_desc,
+                               max_thread_count);
+    }
+
+    size_t embedding_size_per_rank;
+    WHOLEMEMORY_RETURN_ON_FAIL(
+      wholememory_get_partition_plan(&embedding_size_per_rank, wholememory_handle));
+
+    size_t element_size         = wholememory_dtype_get_element_size(wholememory_desc.dtype);
+    size_t embedding_entry_size = element_size * wholememory_desc.stride;
+
+    WHOLEMEMORY_EXPECTS_NOTHROW(
+      embedding_size_per_rank % embedding_entry_size == 0,
+      "embedding_size_per_rank=%ld is not multiple of embedding_entry_size=%ldx%ld",
+      embedding_size_per_rank,
+      element_size,
+      wholememory_desc.stride);
+
+    size_t embedding_entry_count_per_rank = embedding_size_per_rank / embedding_entry_size;
+
+    std::vector<int64_t> host_recv_rank_id_count, host_rank_id_count;
+    std::vector<int64_t> recv_indices, bucketed_raw_indices;
+    WHOLEMEMORY_RETURN_ON_FAIL(host_bucket_and_exchange_ids_func(indices,
+                                                                 indices_desc,
+                                                                 &host_recv_rank_id_count,
+                                                                 &host_rank_id_count,
+                                                                 &recv_indices,
+                                                                 &bucketed_raw_indices,
+                                                                 embedding_entry_count_per_rank,
+                                                                 wm_comm));
+
+    // Local Reorder
+    int64_t total_recv_count = static_cast<int64_t>(recv_indices.size());
+    size_t embedding_size =
+      wholememory_desc.sizes[1] * wholememory_dtype_get_element_size(input_desc.dtype);
+    auto local_reorder_desc =
+      wholememory_create_matrix_desc(input_desc.sizes, input_desc.sizes[1], 0, input_desc.dtype);
+    std::vector<char> local_reorder_buffer(indices_desc.size * embedding_size);
+    auto raw_indice_desc =
+      wholememory_create_array_desc(indices_desc.size, 0, WHOLEMEMORY_DT_INT64);
+    WHOLEMEMORY_RETURN_ON_FAIL(host_gather_func(input,
+                                                input_desc,
+                                                bucketed_raw_indices.data(),
+                                                raw_indice_desc,
+                                                local_reorder_buffer.data(),
+                                                local_reorder_desc,
+                                                max_thread_count));
+    // AllToAllV for embeddings
+    std::vector<char> embedding_recv_buffer(total_recv_count * embedding_size);
+    WHOLEMEMORY_RETURN_ON_FAIL(host_exchange_rows_func(local_reorder_buffer.data(),
+                                                       host_rank_id_count.data(),
+                                                       embedding_recv_buffer.data(),
+                                                       host_recv_rank_id_count.data(),
+                                                       embedding_size,
+                                                       wm_comm));
+    // Local scatter
+    size_t local_mem_offset, local_mem_size;
+    void* local_fake_ptr = nullptr;
+    WHOLEMEMORY_RETURN_ON_FAIL(wholememory_get_local_memory(
+      &local_fake_ptr, &local_mem_size, &local_mem_offset, wholememory_handle));
+    local_fake_ptr = static_cast<char*>(local_fake_ptr) - local_mem_offset;
+    int64_t recv_embedding_sizes[2] = {total_recv_count, input_desc.sizes[1]};
+    wholememory_matrix_description_t recv_embedding_desc = wholememory_create_matrix_desc(
+      recv_embedding_sizes, input_desc.sizes[1], 0, input_desc.dtype);
+    auto recv_indices_desc =
+      wholememory_create_array_desc(total_recv_count, 0, WHOLEMEMORY_DT_INT64);
+    WHOLEMEMORY_RETURN_ON_FAIL(host_scatter_func(embedding_recv_buffer.data(),
+                                                 recv_embedding_desc,
+                                                 recv_indices.data(),
+                                                 recv_indices_desc,
+                                                 local_fake_ptr,
+                                                 wholememory_desc,
+                                                 max_thread_count));
+  } catch (wholememory::cuda_error& wce) {
+    WHOLEMEMORY_ERROR("CUDA logic Error %s\n", wce.what());
+    return WHOLEMEMORY_CUDA_ERROR;
+  } catch (wholememory::logic_error& wle) {
+    WHOLEMEMORY_ERROR("LOGIC Error %s\n", wle.what());
+    return WHOLEMEMORY_LOGIC_ERROR;
+  } catch (...) {
+    WHOLEMEMORY_ERROR("Unknown Error\n");
+    return WHOLEMEMORY_UNKNOW_ERROR;
+  }
+
+  return WHOLEMEMORY_SUCCESS;
+}
+
+}  // namespace wholememory_ops
@@ -21,6 +21,7 @@
 #include "output_memory_handle.hpp"
 #include "register.hpp"
 #include "temp_memory_handle.hpp"
+#include "wholememory/env_func_ptrs.hpp"
 
 template <typename DataTypeT>
 __global__ void EnvTestTempFUnc(const DataTypeT* input_ptr,
@@ -78,6 +79,7 @@ wholememory_error_code_t wholememory_env_test_op(wholememory_tensor_t input_tens
   WHOLEMEMORY_CHECK_NOTHROW(output_desc->sizes[0] == output_variable_entry_count);
   WHOLEMEMORY_CHECK_NOTHROW(output_desc->sizes[1] == emb_dim);
   WHOLEMEMORY_CHECK_NOTHROW(input_desc->dtype == output_desc->dtype);
+  wholememory::temp_memory_stream_guard stream_guard(static_cast<cudaStream_t>(stream));
 
   wholememory_ops::output_memory_handle out_device_handle(p_env_fns,
                                                           output_variable_device_tensor_handle);
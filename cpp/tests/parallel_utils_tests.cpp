@@ -18,7 +18,9 @@
 #include <cuda_runtime_api.h>
 #include <sys/mman.h>
 
+#include <algorithm>
 #include <atomic>
+#include <vector>
 
 #include "parallel_utils.hpp"
 
@@ -93,6 +95,46 @@ TEST(ParallelUtilsTest, GroupPipeBroadcast)
   ClosePipes(&pipes);
 }
 
+TEST(ParallelUtilsTest, SideBandCommunicator)
+{
+  // not power of 2, and payload larger than broadcast chunk.
+  const int nproc      = 7;
+  const size_t count   = 300 * 1024 + 3;
+  const int start_port = 24987;
+  for (int root = 0; root < 2; root++) {
+    MultiProcessRun(nproc, [root, count, start_port](int rank, int world_size) {
+      SideBandCommunicator* side_band_communicator =
+        StartSidebandCommunicator(rank, world_size, "127.0.0.1", start_port + root);
+      std::vector<int> bcast_data(count, rank);
+      SideBandBroadcast(side_band_communicator, bcast_data.data(), count * sizeof(int), root);
+      EXPECT_EQ(bcast_data.front(), root);
+      EXPECT_EQ(bcast_data.back(), root);
+
+      std::vector<int> gather_input(count, rank * 10);
+      std::vector<int> gather_output(count * world_size, -1);
+      SideBandAllGather(
+        side_band_communicator, gather_input.data(), gather_output.data(), count * sizeof(int));
+      for (int r = 0; r < world_size; r++) {
+        EXPECT_EQ(gather_output[r * count], r * 10);
+        EXPECT_EQ(gather_output[(r + 1) * count - 1], r * 10);
+      }
+
+      std::vector<int> all2all_input(count * world_size), all2all_output(count * world_size, -1);
+      for (int r = 0; r < world_size; r++) {
+        std::fill_n(all2all_input.begin() + r * count, count, rank * world_size + r);
+      }
+      SideBandAllToAll(
+        side_band_communicator, all2all_input.data(), all2all_output.data(), count * sizeof(int));
+      for (int r = 0; r < world_size; r++) {
+        EXPECT_EQ(all2all_output[r * count], r * world_size + rank);
+        EXPECT_EQ(all2all_output[(r + 1) * count - 1], r * world_size + rank);
+      }
+      ShutDownSidebandCommunicator(side_band_communicator);
+      WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+    });
+  }
+}
+
 TEST(ParallelUtilsTest, ForkGetDeviceCount)
 {
   int dev_count_fork = ForkGetDeviceCount();
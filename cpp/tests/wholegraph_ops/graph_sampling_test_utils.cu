@@ -27,6 +27,9 @@
 #include <raft/random/rng_state.hpp>
 #include <wholememory_ops/register.hpp>
 
+#include "wholegraph_ops/sample_with_replacement_comm.cuh"
+#include "wholegraph_ops/temporal_sample_comm.cuh"
+
 namespace wholegraph_ops {
 namespace testing {
 
@@ -762,6 +765,487 @@ void wholegraph_csr_weighted_sample_without_replacement_cpu(
                        random_seed);
 }
 
+template <typename IdType, typename ColIdType, typename WeightType>
+void host_sample_with_replacement(void* host_csr_row_ptr,
+                                  wholememory_array_description_t csr_row_ptr_desc,
+                                  void* host_csr_col_ptr,
+                                  wholememory_array_description_t csr_col_ptr_desc,
+                                  void* host_csr_weight_ptr,
+                                  wholememory_array_description_t csr_weight_ptr_desc,
+                                  void* host_center_nodes,
+                                  wholememory_array_description_t center_node_desc,
+                                  int max_sample_count,
+                                  const int* host_center_fanout,
+                                  void* host_ref_output_sample_offset,
+                                  wholememory_array_description_t output_sample_offset_desc,
+                                  void* host_ref_output_dest_nodes,
+                                  void* host_ref_output_center_nodes_local_id,
+                                  void* host_ref_output_global_edge_id,
+                                  unsigned long long random_seed)
+{
+  int64_t* csr_row_ptr          = static_cast<int64_t*>(host_csr_row_ptr);
+  ColIdType* csr_col_ptr        = static_cast<ColIdType*>(host_csr_col_ptr);
+  WeightType* csr_weight_ptr    = static_cast<WeightType*>(host_csr_weight_ptr);
+  IdType* center_nodes_ptr      = static_cast<IdType*>(host_center_nodes);
+  int* output_sample_offset_ptr = static_cast<int*>(host_ref_output_sample_offset);
+
+  ColIdType* output_dest_nodes_ptr      = static_cast<ColIdType*>(host_ref_output_dest_nodes);
+  int* output_center_nodes_local_id_ptr = static_cast<int*>(host_ref_output_center_nodes_local_id);
+  int64_t* output_global_edge_id_ptr    = static_cast<int64_t*>(host_ref_output_global_edge_id);
+
+  raft::random::RngState _rngstate(random_seed, 0, raft::random::GeneratorType::GenPC);
+  raft::random::detail::DeviceState<raft::random::detail::PCGenerator> rngstate(_rngstate);
+  raft::random::detail::UniformDistParams<int32_t> params;
+  params.start = 0;
+  params.end   = 1;
+
+  for (int64_t i = 0; i < center_node_desc.size; i++) {
+    int output_id     = output_sample_offset_ptr[i];
+    int sample_count  = output_sample_offset_ptr[i + 1] - output_id;
+    int64_t start     = csr_row_ptr[center_nodes_ptr[i]];
+    int N             = csr_row_ptr[center_nodes_ptr[i] + 1] - start;
+    int fanout        = host_center_fanout != nullptr ? host_center_fanout[i] : max_sample_count;
+    bool const random = fanout > 0;
+    // alias table by Vose's method, weights summed in the same order as the device build.
+    std::vector<double> prob(N);
+    std::vector<int> alias(N);
+    if (random && csr_weight_ptr != nullptr) {
+      auto positive = [](WeightType weight) { return weight > 0 ? (double)weight : 0.0; };
+      double weight_sum = 0;
+      for (int t = 0; t < kWithReplacementBlockDim; t++) {
+        double partial_sum = 0;
+        for (int j = t; j < N; j += kWithReplacementBlockDim) {
+          partial_sum += positive(csr_weight_ptr[start + j]);
+        }
+        weight_sum += partial_sum;
+      }
+      std::vector<int> small, large;
+      int max_prob_idx = 0;
+      for (int j = 0; j < N; j++) {
+        prob[j]  = weight_sum > 0 ? positive(csr_weight_ptr[start + j]) * N / weight_sum : 1.0;
+        alias[j] = j;
+        if (prob[j] > prob[max_prob_idx]) max_prob_idx = j;
+        if (prob[j] < 1) {
+          small.push_back(j);
+        } else {
+          large.push_back(j);
+        }
+      }
+      int last_large = max_prob_idx;
+      while (!small.empty() && !large.empty()) {
+        int small_idx = small.back();
+        small.pop_back();
+        int large_idx = large.back();
+        large.pop_back();
+        alias[small_idx] = large_idx;
+        last_large       = large_idx;
+        prob[large_idx]  = (prob[large_idx] + prob[small_idx]) - 1.0;
+        if (prob[large_idx] < 1) {
+          small.push_back(large_idx);
+        } else {
+          large.push_back(large_idx);
+        }
+      }
+      for (int idx : small) {
+        if (prob[idx] > 0) {
+          prob[idx] = 1;
+        } else {
+          alias[idx] = last_large;
+        }
+      }
+      for (int idx : large) {
+        prob[idx] = 1;
+      }
+    }
+    for (int j = 0; j < kWithReplacementBlockDim; j++) {
+      int local_gidx = i * kWithReplacementBlockDim + j;
+      raft::random::detail::PCGenerator rng(rngstate, (uint64_t)local_gidx);
+      for (int sample_id = j; sample_id < sample_count; sample_id += kWithReplacementBlockDim) {
+        int neighbor_id = sample_id;
+        if (random) {
+          int32_t random_num;
+          raft::random::detail::custom_next(rng, &random_num, params, 0, 0);
+          neighbor_id = random_num % N;
+          if (csr_weight_ptr != nullptr) {
+            raft::random::detail::custom_next(rng, &random_num, params, 0, 0);
+            uint64_t random_high = static_cast<uint32_t>(random_num) & 0x7FFFFFFU;
+            raft::random::detail::custom_next(rng, &random_num, params, 0, 0);
+            uint64_t random_low = static_cast<uint32_t>(random_num) & 0x3FFFFFFU;
+            double u = static_cast<double>((random_high << 26) | random_low) / 9007199254740992.0;
+            if (!(u < prob[neighbor_id])) neighbor_id = alias[neighbor_id];
+          }
+        }
+        output_dest_nodes_ptr[output_id + sample_id]            = csr_col_ptr[start + neighbor_id];
+        output_center_nodes_local_id_ptr[output_id + sample_id] = (int)i;
+        output_global_edge_id_ptr[output_id + sample_id]        = start + neighbor_id;
+      }
+    }
+  }
+}
+
+REGISTER_DISPATCH_THREE_TYPES(HOSTSAMPLEWITHREPLACEMENT,
+                              host_sample_with_replacement,
+                              SINT3264,
+                              SINT3264,
+                              FLOAT_DOUBLE)
+
+void wholegraph_csr_sample_with_replacement_cpu(
+  void* host_csr_row_ptr,
+  wholememory_array_description_t csr_row_ptr_desc,
+  void* host_csr_col_ptr,
+  wholememory_array_description_t csr_col_ptr_desc,
+  void* host_csr_weight_ptr,
+  wholememory_array_description_t csr_weight_ptr_desc,
+  void* host_center_nodes,
+  wholememory_array_description_t center_node_desc,
+  int max_sample_count,
+  const int* host_center_fanout,
+  void** host_ref_output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void** host_ref_output_dest_nodes,
+  void** host_ref_output_center_nodes_local_id,
+  void** host_ref_output_global_edge_id,
+  int* output_sample_dest_nodes_count,
+  unsigned long long random_seed)
+{
+  EXPECT_EQ(csr_row_ptr_desc.dtype, WHOLEMEMORY_DT_INT64);
+  EXPECT_EQ(output_sample_offset_desc.dtype, WHOLEMEMORY_DT_INT);
+  EXPECT_EQ(output_sample_offset_desc.size, center_node_desc.size + 1);
+  *host_ref_output_sample_offset =
+    (void*)malloc(wholememory_get_memory_size_from_array(&output_sample_offset_desc));
+  int* output_sample_offset_ptr = static_cast<int*>(*host_ref_output_sample_offset);
+  auto* csr_row_ptr             = static_cast<int64_t*>(host_csr_row_ptr);
+  output_sample_offset_ptr[0]   = 0;
+  for (int64_t i = 0; i < center_node_desc.size; i++) {
+    int64_t center_node_id = center_node_desc.dtype == WHOLEMEMORY_DT_INT64
+                               ? static_cast<int64_t*>(host_center_nodes)[i]
+                               : static_cast<int*>(host_center_nodes)[i];
+    int neighbor_count = csr_row_ptr[center_node_id + 1] - csr_row_ptr[center_node_id];
+    int fanout = host_center_fanout != nullptr ? host_center_fanout[i] : max_sample_count;
+    // fanout <= 0 means sample all, and neighbors are sampled with replacement.
+    int sample_count = neighbor_count == 0 ? 0 : (fanout > 0 ? fanout : neighbor_count);
+    output_sample_offset_ptr[i + 1] = output_sample_offset_ptr[i] + sample_count;
+  }
+  *output_sample_dest_nodes_count = output_sample_offset_ptr[center_node_desc.size];
+
+  *host_ref_output_dest_nodes            = malloc((*output_sample_dest_nodes_count) *
+                                       wholememory_dtype_get_element_size(csr_col_ptr_desc.dtype));
+  *host_ref_output_center_nodes_local_id = malloc((*output_sample_dest_nodes_count) * sizeof(int));
+  *host_ref_output_global_edge_id = malloc((*output_sample_dest_nodes_count) * sizeof(int64_t));
+
+  DISPATCH_THREE_TYPES(center_node_desc.dtype,
+                       csr_col_ptr_desc.dtype,
+                       host_csr_weight_ptr != nullptr ? csr_weight_ptr_desc.dtype
+                                                      : WHOLEMEMORY_DT_FLOAT,
+                       HOSTSAMPLEWITHREPLACEMENT,
+                       host_csr_row_ptr,
+                       csr_row_ptr_desc,
+                       host_csr_col_ptr,
+                       csr_col_ptr_desc,
+                       host_csr_weight_ptr,
+                       csr_weight_ptr_desc,
+                       host_center_nodes,
+                       center_node_desc,
+                       max_sample_count,
+                       host_center_fanout,
+                       *host_ref_output_sample_offset,
+                       output_sample_offset_desc,
+                       *host_ref_output_dest_nodes,
+                       *host_ref_output_center_nodes_local_id,
+                       *host_ref_output_global_edge_id,
+                       random_seed);
+}
+
+template <typename IdType, typename ColIdType, typename TimeType>
+void host_temporal_sample(void* host_csr_row_ptr,
+                          wholememory_array_description_t csr_row_ptr_desc,
+                          void* host_csr_col_ptr,
+                          wholememory_array_description_t csr_col_ptr_desc,
+                          void* host_edge_timestamp_ptr,
+                          wholememory_array_description_t edge_timestamp_desc,
+                          void* host_center_nodes,
+                          wholememory_array_description_t center_node_desc,
+                          void* host_center_timestamps,
+                          int max_sample_count,
+                          bool sample_latest,
+                          void* host_ref_output_sample_offset,
+                          wholememory_array_description_t output_sample_offset_desc,
+                          void* host_ref_output_dest_nodes,
+                          void* host_ref_output_center_nodes_local_id,
+                          void* host_ref_output_global_edge_id,
+                          unsigned long long random_seed)
+{
+  int64_t* csr_row_ptr          = static_cast<int64_t*>(host_csr_row_ptr);
+  ColIdType* csr_col_ptr        = static_cast<ColIdType*>(host_csr_col_ptr);
+  TimeType* edge_timestamp_ptr  = static_cast<TimeType*>(host_edge_timestamp_ptr);
+  IdType* center_nodes_ptr      = static_cast<IdType*>(host_center_nodes);
+  TimeType* center_time_ptr     = static_cast<TimeType*>(host_center_timestamps);
+  int* output_sample_offset_ptr = static_cast<int*>(host_ref_output_sample_offset);
+
+  ColIdType* output_dest_nodes_ptr      = static_cast<ColIdType*>(host_ref_output_dest_nodes);
+  int* output_center_nodes_local_id_ptr = static_cast<int*>(host_ref_output_center_nodes_local_id);
+  int64_t* output_global_edge_id_ptr    = static_cast<int64_t*>(host_ref_output_global_edge_id);
+
+  raft::random::RngState _rngstate(random_seed, 0, raft::random::GeneratorType::GenPC);
+  raft::random::detail::DeviceState<raft::random::detail::PCGenerator> rngstate(_rngstate);
+  raft::random::detail::UniformDistParams<int32_t> params;
+  params.start = 0;
+  params.end   = 1;
+
+  output_sample_offset_ptr[0] = 0;
+  for (int64_t i = 0; i < center_node_desc.size; i++) {
+    int64_t start = csr_row_ptr[center_nodes_ptr[i]];
+    int64_t end   = csr_row_ptr[center_nodes_ptr[i] + 1];
+    int N         = 0;
+    while (start + N < end && edge_timestamp_ptr[start + N] <= center_time_ptr[i]) {
+      N++;
+    }
+    int output_id    = output_sample_offset_ptr[i];
+    int sample_count = max_sample_count > 0 && N > max_sample_count ? max_sample_count : N;
+
+    output_sample_offset_ptr[i + 1] = output_id + sample_count;
+    std::vector<int> neighbor_ids(sample_count);
+    for (int j = 0; j < sample_count; j++) {
+      neighbor_ids[j] = sample_latest ? N - sample_count + j : j;
+    }
+    if (!sample_latest && sample_count < N) {
+      // sequential reservoir sampling, neighbor idx is handled by thread idx - sample_count of
+      // kTemporalSampleBlockDim threads, and each thread has its own random subsequence.
+      std::vector<raft::random::detail::PCGenerator> rngs;
+      for (int j = 0; j < kTemporalSampleBlockDim; j++) {
+        rngs.emplace_back(rngstate, (uint64_t)(i * kTemporalSampleBlockDim + j));
+      }
+      for (int idx = sample_count; idx < N; idx++) {
+        int32_t random_num;
+        raft::random::detail::custom_next(
+          rngs[(idx - sample_count) % kTemporalSampleBlockDim], &random_num, params, 0, 0);
+        int slot = random_num % (idx + 1);
+        if (slot < sample_count) neighbor_ids[slot] = idx;
+      }
+    }
+    for (int j = 0; j < sample_count; j++) {
+      output_dest_nodes_ptr[output_id + j]            = csr_col_ptr[start + neighbor_ids[j]];
+      output_center_nodes_local_id_ptr[output_id + j] = (int)i;
+      output_global_edge_id_ptr[output_id + j]        = start + neighbor_ids[j];
+    }
+  }
+}
+
+REGISTER_DISPATCH_THREE_TYPES(HOSTTEMPORALSAMPLE,
+                              host_temporal_sample,
+                              SINT3264,
+                              SINT3264,
+                              SINT3264)
+
+void wholegraph_csr_temporal_sample_cpu(void* host_csr_row_ptr,
+                                        wholememory_array_description_t csr_row_ptr_desc,
+                                        void* host_csr_col_ptr,
+                                        wholememory_array_description_t csr_col_ptr_desc,
+                                        void* host_edge_timestamp_ptr,
+                                        wholememory_array_description_t edge_timestamp_desc,
+                                        void* host_center_nodes,
+                                        wholememory_array_description_t center_node_desc,
+                                        void* host_center_timestamps,
+                                        int max_sample_count,
+                                        bool sample_latest,
+                                        void** host_ref_output_sample_offset,
+                                        wholememory_array_description_t output_sample_offset_desc,
+                                        void** host_ref_output_dest_nodes,
+                                        void** host_ref_output_center_nodes_local_id,
+                                        void** host_ref_output_global_edge_id,
+                                        int* output_sample_dest_nodes_count,
+                                        unsigned long long random_seed)
+{
+  EXPECT_EQ(csr_row_ptr_desc.dtype, WHOLEMEMORY_DT_INT64);
+  EXPECT_EQ(output_sample_offset_desc.dtype, WHOLEMEMORY_DT_INT);
+  EXPECT_EQ(output_sample_offset_desc.size, center_node_desc.size + 1);
+  *host_ref_output_sample_offset =
+    (void*)malloc(wholememory_get_memory_size_from_array(&output_sample_offset_desc));
+  // valid neighbors are at most all neighbors of center nodes.
+  auto* csr_row_ptr = static_cast<int64_t*>(host_csr_row_ptr);
+  int64_t max_count = 0;
+  for (int64_t i = 0; i < center_node_desc.size; i++) {
+    int64_t center_node_id = center_node_desc.dtype == WHOLEMEMORY_DT_INT64
+                               ? static_cast<int64_t*>(host_center_nodes)[i]
+                               : static_cast<int*>(host_center_nodes)[i];
+    max_count += csr_row_ptr[center_node_id + 1] - csr_row_ptr[center_node_id];
+  }
+  *host_ref_output_dest_nodes =
+    malloc(max_count * wholememory_dtype_get_element_size(csr_col_ptr_desc.dtype));
+  *host_ref_output_center_nodes_local_id = malloc(max_count * sizeof(int));
+  *host_ref_output_global_edge_id        = malloc(max_count * sizeof(int64_t));
+
+  DISPATCH_THREE_TYPES(center_node_desc.dtype,
+                       csr_col_ptr_desc.dtype,
+                       edge_timestamp_desc.dtype,
+                       HOSTTEMPORALSAMPLE,
+                       host_csr_row_ptr,
+                       csr_row_ptr_desc,
+                       host_csr_col_ptr,
+                       csr_col_ptr_desc,
+                       host_edge_timestamp_ptr,
+                       edge_timestamp_desc,
+                       host_center_nodes,
+                       center_node_desc,
+                       host_center_timestamps,
+                       max_sample_count,
+                       sample_latest,
+                       *host_ref_output_sample_offset,
+                       output_sample_offset_desc,
+                       *host_ref_output_dest_nodes,
+                       *host_ref_output_center_nodes_local_id,
+                       *host_ref_output_global_edge_id,
+                       random_seed);
+  *output_sample_dest_nodes_count =
+    static_cast<int*>(*host_ref_output_sample_offset)[center_node_desc.size];
+}
+
+template <typename IdType, typename ColIdType, typename WeightType>
+void host_random_walk(void* host_csr_row_ptr,
+                      wholememory_array_description_t csr_row_ptr_desc,
+                      void* host_csr_col_ptr,
+                      wholememory_array_description_t csr_col_ptr_desc,
+                      void* host_csr_weight_ptr,
+                      wholememory_array_description_t csr_weight_ptr_desc,
+                      void* host_start_nodes,
+                      wholememory_array_description_t start_node_desc,
+                      int walk_length,
+                      float p,
+                      float q,
+                      float restart_probability,
+                      void* host_ref_output_walks,
+                      int* host_ref_output_restart_count,
+                      unsigned long long random_seed)
+{
+  int64_t* csr_row_ptr       = static_cast<int64_t*>(host_csr_row_ptr);
+  ColIdType* csr_col_ptr     = static_cast<ColIdType*>(host_csr_col_ptr);
+  WeightType* csr_weight_ptr = static_cast<WeightType*>(host_csr_weight_ptr);
+  IdType* start_nodes_ptr    = static_cast<IdType*>(host_start_nodes);
+  ColIdType* walks_ptr       = static_cast<ColIdType*>(host_ref_output_walks);
+
+  raft::random::RngState _rngstate(random_seed, 0, raft::random::GeneratorType::GenPC);
+  raft::random::detail::DeviceState<raft::random::detail::PCGenerator> rngstate(_rngstate);
+  raft::random::detail::UniformDistParams<int32_t> params;
+  params.start = 0;
+  params.end   = 1;
+
+  const WeightType inv_p    = static_cast<WeightType>(1) / static_cast<WeightType>(p);
+  const WeightType inv_q    = static_cast<WeightType>(1) / static_cast<WeightType>(q);
+  const WeightType max_bias = std::max(std::max(inv_p, inv_q), static_cast<WeightType>(1));
+  const WeightType restart  = static_cast<WeightType>(restart_probability);
+  const bool biased         = p != 1.0f || q != 1.0f;
+
+  for (int64_t i = 0; i < start_node_desc.size; i++) {
+    raft::random::detail::PCGenerator rng(rngstate, (uint64_t)i);
+    auto next_int = [&]() {
+      int32_t random_num;
+      raft::random::detail::custom_next(rng, &random_num, params, 0, 0);
+      return random_num;
+    };
+    auto next_uniform = [&]() {
+      return static_cast<WeightType>((next_int() >> 7) & 0xFFFFFF) *
+             static_cast<WeightType>(1.0 / 16777216);
+    };
+    ColIdType* walk   = walks_ptr + i * (walk_length + 1);
+    int64_t start     = start_nodes_ptr[i];
+    int64_t prev      = -1;
+    int64_t cur       = start;
+    int restart_count = 0;
+    walk[0]           = start;
+    for (int step = 1; step <= walk_length; step++) {
+      if (restart > 0 && prev >= 0 && next_uniform() < restart) {
+        restart_count++;
+        prev       = -1;
+        cur        = start;
+        walk[step] = start;
+        continue;
+      }
+      int64_t edge_start = csr_row_ptr[cur];
+      int N              = csr_row_ptr[cur + 1] - edge_start;
+      if (N == 0) {
+        std::fill(walk + step, walk + walk_length + 1, static_cast<ColIdType>(-1));
+        break;
+      }
+      WeightType weight_sum = 0;
+      for (int j = 0; csr_weight_ptr != nullptr && j < N; j++) {
+        if (csr_weight_ptr[edge_start + j] > 0) weight_sum += csr_weight_ptr[edge_start + j];
+      }
+      int64_t next;
+      while (true) {
+        int neighbor_id = 0;
+        if (csr_weight_ptr != nullptr && weight_sum > 0) {
+          WeightType target = next_uniform() * weight_sum;
+          WeightType acc    = 0;
+          for (int j = 0; j < N; j++) {
+            if (!(csr_weight_ptr[edge_start + j] > 0)) continue;
+            acc += csr_weight_ptr[edge_start + j];
+            neighbor_id = j;
+            if (target < acc) break;
+          }
+        } else {
+          neighbor_id = next_int() % N;
+        }
+        next = csr_col_ptr[edge_start + neighbor_id];
+        if (!biased || prev < 0) break;
+        WeightType bias = 1;
+        if (next == prev) {
+          bias = inv_p;
+        } else if (std::find(csr_col_ptr + csr_row_ptr[prev],
+                             csr_col_ptr + csr_row_ptr[prev + 1],
+                             static_cast<ColIdType>(next)) == csr_col_ptr + csr_row_ptr[prev + 1]) {
+          bias = inv_q;
+        }
+        if (next_uniform() * max_bias < bias) break;
+      }
+      prev       = cur;
+      cur        = next;
+      walk[step] = next;
+    }
+    host_ref_output_restart_count[i] = restart_count;
+  }
+}
+
+REGISTER_DISPATCH_THREE_TYPES(HOSTRANDOMWALK, host_random_walk, SINT3264, SINT3264, FLOAT_DOUBLE)
+
+void wholegraph_csr_random_walk_cpu(void* host_csr_row_ptr,
+                                    wholememory_array_description_t csr_row_ptr_desc,
+                                    void* host_csr_col_ptr,
+                                    wholememory_array_description_t csr_col_ptr_desc,
+                                    void* host_csr_weight_ptr,
+                                    wholememory_array_description_t csr_weight_ptr_desc,
+                                    void* host_start_nodes,
+                                    wholememory_array_description_t start_node_desc,
+                                    int walk_length,
+                                    float p,
+                                    float q,
+                                    float restart_probability,
+                                    void* host_ref_output_walks,
+                                    int* host_ref_output_restart_count,
+                                    unsigned long long random_seed)
+{
+  EXPECT_EQ(csr_row_ptr_desc.dtype, WHOLEMEMORY_DT_INT64);
+  DISPATCH_THREE_TYPES(start_node_desc.dtype,
+                       csr_col_ptr_desc.dtype,
+                       host_csr_weight_ptr != nullptr ? csr_weight_ptr_desc.dtype
+                                                      : WHOLEMEMORY_DT_FLOAT,
+                       HOSTRANDOMWALK,
+                       host_csr_row_ptr,
+                       csr_row_ptr_desc,
+                       host_csr_col_ptr,
+                       csr_col_ptr_desc,
+                       host_csr_weight_ptr,
+                       csr_weight_ptr_desc,
+                       host_start_nodes,
+                       start_node_desc,
+                       walk_length,
+                       p,
+                       q,
+                       restart_probability,
+                       host_ref_output_walks,
+                       host_ref_output_restart_count,
+                       random_seed);
+}
+
 template <typename DataType>
 void host_get_segment_sort(void* host_output_sample_offset,
                            wholememory_array_description_t output_sample_offset_desc,
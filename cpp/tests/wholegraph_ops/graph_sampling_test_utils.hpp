@@ -67,6 +67,64 @@ void wholegraph_csr_weighted_sample_without_replacement_cpu(
   int* output_sample_dest_nodes_count,
   unsigned long long random_seed);
 
+// host_csr_weight_ptr is nullptr for unweighted sampling, host_center_fanout can be nullptr.
+void wholegraph_csr_sample_with_replacement_cpu(
+  void* host_csr_row_ptr,
+  wholememory_array_description_t csr_row_ptr_desc,
+  void* host_csr_col_ptr,
+  wholememory_array_description_t csr_col_ptr_desc,
+  void* host_csr_weight_ptr,
+  wholememory_array_description_t csr_weight_ptr_desc,
+  void* host_center_nodes,
+  wholememory_array_description_t center_node_desc,
+  int max_sample_count,
+  const int* host_center_fanout,
+  void** host_ref_output_sample_offset,
+  wholememory_array_description_t output_sample_offset_desc,
+  void** host_ref_output_dest_nodes,
+  void** host_ref_output_center_nodes_local_id,
+  void** host_ref_output_global_edge_id,
+  int* output_sample_dest_nodes_count,
+  unsigned long long random_seed);
+
+// center timestamps have the same dtype as edge timestamps, neighbors are sorted by timestamp.
+void wholegraph_csr_temporal_sample_cpu(void* host_csr_row_ptr,
+                                        wholememory_array_description_t csr_row_ptr_desc,
+                                        void* host_csr_col_ptr,
+                                        wholememory_array_description_t csr_col_ptr_desc,
+                                        void* host_edge_timestamp_ptr,
+                                        wholememory_array_description_t edge_timestamp_desc,
+                                        void* host_center_nodes,
+                                        wholememory_array_description_t center_node_desc,
+                                        void* host_center_timestamps,
+                                        int max_sample_count,
+                                        bool sample_latest,
+                                        void** host_ref_output_sample_offset,
+                                        wholememory_array_description_t output_sample_offset_desc,
+                                        void** host_ref_output_dest_nodes,
+                                        void** host_ref_output_center_nodes_local_id,
+                                        void** host_ref_output_global_edge_id,
+                                        int* output_sample_dest_nodes_count,
+                                        unsigned long long random_seed);
+
+// host_csr_weight_ptr is nullptr for unweighted walk, host_ref_output_walks has
+// (walk_length + 1) nodes for each start node.
+void wholegraph_csr_random_walk_cpu(void* host_csr_row_ptr,
+                                    wholememory_array_description_t csr_row_ptr_desc,
+                                    void* host_csr_col_ptr,
+                                    wholememory_array_description_t csr_col_ptr_desc,
+                                    void* host_csr_weight_ptr,
+                                    wholememory_array_description_t csr_weight_ptr_desc,
+                                    void* host_start_nodes,
+                                    wholememory_array_description_t start_node_desc,
+                                    int walk_length,
+                                    float p,
+                                    float q,
+                                    float restart_probability,
+                                    void* host_ref_output_walks,
+                                    int* host_ref_output_restart_count,
+                                    unsigned long long random_seed);
+
 void gen_csr_graph(
   int64_t graph_node_count,
   int64_t graph_edge_count,
@@ -0,0 +1,484 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+
+#include <wholememory/tensor_description.h>
+#include <wholememory/wholegraph_op.h>
+#include <wholememory/wholememory.h>
+
+#include "parallel_utils.hpp"
+#include "wholememory/communicator.hpp"
+#include "wholememory/env_func_ptrs.hpp"
+#include "wholememory/initialize.hpp"
+
+#include "../wholememory/wholememory_test_utils.hpp"
+#include "graph_sampling_test_utils.hpp"
+
+typedef struct WholeGraphCSRRandomWalkTestParam {
+  wholememory_array_description_t get_csr_row_ptr_desc() const
+  {
+    return wholememory_create_array_desc(graph_node_count + 1, 0, csr_row_ptr_dtype);
+  }
+
+  wholememory_array_description_t get_csr_col_ptr_desc() const
+  {
+    return wholememory_create_array_desc(graph_edge_count, 0, csr_col_ptr_dtype);
+  }
+
+  wholememory_array_description_t get_csr_weight_ptr_desc() const
+  {
+    return wholememory_create_array_desc(graph_edge_count, 0, csr_weight_ptr_dtype);
+  }
+
+  wholememory_array_description_t get_start_node_desc() const
+  {
+    return wholememory_create_array_desc(start_node_count, 0, start_node_dtype);
+  }
+
+  wholememory_array_description_t get_restart_count_desc() const
+  {
+    return wholememory_create_array_desc(start_node_count, 0, WHOLEMEMORY_DT_INT);
+  }
+
+  wholememory_matrix_description_t get_output_walks_desc() const
+  {
+    int64_t sizes[2] = {start_node_count, walk_length + 1};
+    return wholememory_create_matrix_desc(sizes, walk_length + 1, 0, csr_col_ptr_dtype);
+  }
+
+  int64_t get_graph_node_count() const { return graph_node_count; }
+  int64_t get_graph_edge_count() const { return graph_edge_count; }
+  int get_walk_length() const { return walk_length; }
+
+  WholeGraphCSRRandomWalkTestParam& set_memory_type(wholememory_memory_type_t new_memory_type)
+  {
+    memory_type = new_memory_type;
+    return *this;
+  };
+  WholeGraphCSRRandomWalkTestParam& set_memory_location(
+    wholememory_memory_location_t new_memory_location)
+  {
+    memory_location = new_memory_location;
+    return *this;
+  };
+  WholeGraphCSRRandomWalkTestParam& set_walk_length(int new_walk_length)
+  {
+    walk_length = new_walk_length;
+    return *this;
+  }
+  WholeGraphCSRRandomWalkTestParam& set_start_node_count(int new_start_node_count)
+  {
+    start_node_count = new_start_node_count;
+    return *this;
+  }
+  WholeGraphCSRRandomWalkTestParam& set_start_node_type(wholememory_dtype_t new_start_node_dtype)
+  {
+    start_node_dtype = new_start_node_dtype;
+    return *this;
+  }
+  WholeGraphCSRRandomWalkTestParam& set_weighted(bool new_weighted)
+  {
+    weighted = new_weighted;
+    return *this;
+  }
+  WholeGraphCSRRandomWalkTestParam& set_p_q(float new_p, float new_q)
+  {
+    p = new_p;
+    q = new_q;
+    return *this;
+  }
+  WholeGraphCSRRandomWalkTestParam& set_restart_probability(float new_restart_probability)
+  {
+    restart_probability = new_restart_probability;
+    return *this;
+  }
+  WholeGraphCSRRandomWalkTestParam& set_use_restart_count(bool new_use_restart_count)
+  {
+    use_restart_count = new_use_restart_count;
+    return *this;
+  }
+  WholeGraphCSRRandomWalkTestParam& set_use_host_start_nodes(bool new_use_host_start_nodes)
+  {
+    use_host_start_nodes = new_use_host_start_nodes;
+    return *this;
+  }
+
+  wholememory_memory_type_t memory_type         = WHOLEMEMORY_MT_CHUNKED;
+  wholememory_memory_location_t memory_location = WHOLEMEMORY_ML_DEVICE;
+  bool weighted                                 = false;
+  bool use_restart_count                        = false;
+  bool use_host_start_nodes                     = false;
+  float p                                       = 1.0f;
+  float q                                       = 1.0f;
+  float restart_probability                     = 0.0f;
+  int walk_length                               = 8;
+  int64_t start_node_count                      = 512;
+  int64_t graph_node_count                      = 9703LL;
+  int64_t graph_edge_count                      = 104323L;
+  wholememory_dtype_t csr_row_ptr_dtype         = WHOLEMEMORY_DT_INT64;
+  wholememory_dtype_t csr_col_ptr_dtype         = WHOLEMEMORY_DT_INT;
+  wholememory_dtype_t csr_weight_ptr_dtype      = WHOLEMEMORY_DT_FLOAT;
+  wholememory_dtype_t start_node_dtype          = WHOLEMEMORY_DT_INT;
+} WholeGraphCSRRandomWalkTestParam;
+
+class WholeGraphCSRRandomWalkParameterTests
+  : public ::testing::TestWithParam<WholeGraphCSRRandomWalkTestParam> {};
+
+TEST_P(WholeGraphCSRRandomWalkParameterTests, RandomWalkTest)
+{
+  auto params   = GetParam();
+  int dev_count = ForkGetDeviceCount();
+  EXPECT_GE(dev_count, 1);
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, dev_count);
+  auto graph_node_count          = params.get_graph_node_count();
+  auto graph_edge_count          = params.get_graph_edge_count();
+  auto graph_csr_row_ptr_desc    = params.get_csr_row_ptr_desc();
+  auto graph_csr_col_ptr_desc    = params.get_csr_col_ptr_desc();
+  auto graph_csr_weight_ptr_desc = params.get_csr_weight_ptr_desc();
+
+  void* host_csr_row_ptr =
+    (void*)malloc(wholememory_get_memory_size_from_array(&graph_csr_row_ptr_desc));
+  void* host_csr_col_ptr =
+    (void*)malloc(wholememory_get_memory_size_from_array(&graph_csr_col_ptr_desc));
+  void* host_csr_weight_ptr =
+    (void*)malloc(wholememory_get_memory_size_from_array(&graph_csr_weight_ptr_desc));
+  wholegraph_ops::testing::gen_csr_graph(graph_node_count,
+                                         graph_edge_count,
+                                         host_csr_row_ptr,
+                                         graph_csr_row_ptr_desc,
+                                         host_csr_col_ptr,
+                                         graph_csr_col_ptr_desc,
+                                         host_csr_weight_ptr,
+                                         graph_csr_weight_ptr_desc);
+
+  MultiProcessRun(
+    dev_count,
+    [&params, &pipes, host_csr_row_ptr, host_csr_col_ptr, host_csr_weight_ptr](int world_rank,
+                                                                               int world_size) {
+      thread_local std::random_device rd;
+      thread_local std::mt19937 gen(rd());
+      thread_local std::uniform_int_distribution<unsigned long long> distrib;
+      unsigned long long random_seed = distrib(gen);
+
+      EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
+
+      EXPECT_EQ(cudaSetDevice(world_rank), cudaSuccess);
+
+      wholememory_comm_t wm_comm = create_communicator_by_pipes(pipes, world_rank, world_size);
+
+      if (wholememory_communicator_support_type_location(
+            wm_comm, params.memory_type, params.memory_location) != WHOLEMEMORY_SUCCESS) {
+        EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+        EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+        WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+        if (world_rank == 0) GTEST_SKIP_("Skip due to not supported.");
+        return;
+      }
+
+      auto csr_row_ptr_desc    = params.get_csr_row_ptr_desc();
+      auto csr_col_ptr_desc    = params.get_csr_col_ptr_desc();
+      auto csr_weight_ptr_desc = params.get_csr_weight_ptr_desc();
+      auto start_node_desc     = params.get_start_node_desc();
+      auto restart_count_desc  = params.get_restart_count_desc();
+      auto output_walks_desc   = params.get_output_walks_desc();
+      int walk_length          = params.get_walk_length();
+      int64_t graph_node_count = params.get_graph_node_count();
+      int64_t start_node_count = start_node_desc.size;
+
+      auto output_walks_array_desc = wholememory_create_array_desc(
+        start_node_count * (walk_length + 1), 0, csr_col_ptr_desc.dtype);
+      size_t start_node_size    = wholememory_get_memory_size_from_array(&start_node_desc);
+      size_t restart_count_size = wholememory_get_memory_size_from_array(&restart_count_desc);
+      size_t output_walks_size  = wholememory_get_memory_size_from_array(&output_walks_array_desc);
+
+      cudaStream_t stream;
+      EXPECT_EQ(cudaStreamCreate(&stream), cudaSuccess);
+
+      void *host_start_nodes, *host_output_walks, *host_output_restart_count;
+      void *dev_start_nodes, *dev_output_walks, *dev_output_restart_count;
+
+      wholememory_handle_t csr_row_ptr_memory_handle;
+      wholememory_handle_t csr_col_ptr_memory_handle;
+      wholememory_handle_t csr_weight_ptr_memory_handle;
+
+      EXPECT_EQ(wholememory_malloc(&csr_row_ptr_memory_handle,
+                                   wholememory_get_memory_size_from_array(&csr_row_ptr_desc),
+                                   wm_comm,
+                                   params.memory_type,
+                                   params.memory_location,
+                                   wholememory_dtype_get_element_size(csr_row_ptr_desc.dtype)),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_malloc(&csr_col_ptr_memory_handle,
+                                   wholememory_get_memory_size_from_array(&csr_col_ptr_desc),
+                                   wm_comm,
+                                   params.memory_type,
+                                   params.memory_location,
+                                   wholememory_dtype_get_element_size(csr_col_ptr_desc.dtype)),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_malloc(&csr_weight_ptr_memory_handle,
+                                   wholememory_get_memory_size_from_array(&csr_weight_ptr_desc),
+                                   wm_comm,
+                                   params.memory_type,
+                                   params.memory_location,
+                                   wholememory_dtype_get_element_size(csr_weight_ptr_desc.dtype)),
+                WHOLEMEMORY_SUCCESS);
+
+      wholegraph_ops::testing::copy_host_array_to_wholememory(
+        host_csr_row_ptr, csr_row_ptr_memory_handle, csr_row_ptr_desc, stream);
+      wholegraph_ops::testing::copy_host_array_to_wholememory(
+        host_csr_col_ptr, csr_col_ptr_memory_handle, csr_col_ptr_desc, stream);
+      wholegraph_ops::testing::copy_host_array_to_wholememory(
+        host_csr_weight_ptr, csr_weight_ptr_memory_handle, csr_weight_ptr_desc, stream);
+
+      EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+      wholememory_communicator_barrier(wm_comm);
+
+      EXPECT_EQ(cudaSetDevice(world_rank), cudaSuccess);
+      EXPECT_EQ(cudaMallocHost(&host_start_nodes, start_node_size), cudaSuccess);
+      EXPECT_EQ(cudaMallocHost(&host_output_walks, output_walks_size), cudaSuccess);
+      EXPECT_EQ(cudaMallocHost(&host_output_restart_count, restart_count_size), cudaSuccess);
+
+      EXPECT_EQ(cudaMalloc(&dev_start_nodes, start_node_size), cudaSuccess);
+      EXPECT_EQ(cudaMalloc(&dev_output_walks, output_walks_size), cudaSuccess);
+      EXPECT_EQ(cudaMalloc(&dev_output_restart_count, restart_count_size), cudaSuccess);
+
+      wholegraph_ops::testing::host_random_init_array(
+        host_start_nodes, start_node_desc, 0, graph_node_count - 1);
+      EXPECT_EQ(cudaMemcpyAsync(dev_start_nodes,
+                                host_start_nodes,
+                                start_node_size,
+                                cudaMemcpyHostToDevice,
+                                stream),
+                cudaSuccess);
+
+      wholememory_tensor_t wm_csr_row_ptr_tensor, wm_csr_col_ptr_tensor, wm_csr_weight_ptr_tensor;
+      wholememory_tensor_description_t wm_csr_row_ptr_tensor_desc, wm_csr_col_ptr_tensor_desc,
+        wm_csr_weight_ptr_tensor_desc;
+      wholememory_copy_array_desc_to_tensor(&wm_csr_row_ptr_tensor_desc, &csr_row_ptr_desc);
+      wholememory_copy_array_desc_to_tensor(&wm_csr_col_ptr_tensor_desc, &csr_col_ptr_desc);
+      wholememory_copy_array_desc_to_tensor(&wm_csr_weight_ptr_tensor_desc, &csr_weight_ptr_desc);
+      EXPECT_EQ(wholememory_make_tensor_from_handle(
+                  &wm_csr_row_ptr_tensor, csr_row_ptr_memory_handle, &wm_csr_row_ptr_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_make_tensor_from_handle(
+                  &wm_csr_col_ptr_tensor, csr_col_ptr_memory_handle, &wm_csr_col_ptr_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(
+        wholememory_make_tensor_from_handle(
+          &wm_csr_weight_ptr_tensor, csr_weight_ptr_memory_handle, &wm_csr_weight_ptr_tensor_desc),
+        WHOLEMEMORY_SUCCESS);
+
+      wholememory_tensor_t start_nodes_tensor, output_walks_tensor,
+        output_restart_count_tensor = nullptr;
+      wholememory_tensor_description_t start_nodes_tensor_desc, output_walks_tensor_desc,
+        output_restart_count_tensor_desc;
+      wholememory_copy_array_desc_to_tensor(&start_nodes_tensor_desc, &start_node_desc);
+      wholememory_copy_matrix_desc_to_tensor(&output_walks_tensor_desc, &output_walks_desc);
+      wholememory_copy_array_desc_to_tensor(&output_restart_count_tensor_desc, &restart_count_desc);
+      EXPECT_EQ(wholememory_make_tensor_from_pointer(
+                  &start_nodes_tensor,
+                  params.use_host_start_nodes ? host_start_nodes : dev_start_nodes,
+                  &start_nodes_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_make_tensor_from_pointer(
+                  &output_walks_tensor,
+                  params.use_host_start_nodes ? host_output_walks : dev_output_walks,
+                  &output_walks_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+      if (params.use_restart_count) {
+        EXPECT_EQ(wholememory_make_tensor_from_pointer(&output_restart_count_tensor,
+                                                       params.use_host_start_nodes
+                                                         ? host_output_restart_count
+                                                         : dev_output_restart_count,
+                                                       &output_restart_count_tensor_desc),
+                  WHOLEMEMORY_SUCCESS);
+      }
+
+      wholememory_env_func_t* default_env_func = wholememory::get_default_env_func();
+
+      EXPECT_EQ(wholegraph_csr_random_walk(wm_csr_row_ptr_tensor,
+                                           wm_csr_col_ptr_tensor,
+                                           params.weighted ? wm_csr_weight_ptr_tensor : nullptr,
+                                           start_nodes_tensor,
+                                           walk_length,
+                                           params.p,
+                                           params.q,
+                                           params.restart_probability,
+                                           output_walks_tensor,
+                                           output_restart_count_tensor,
+                                           random_seed,
+                                           default_env_func,
+                                           stream),
+                WHOLEMEMORY_SUCCESS);
+
+      EXPECT_EQ(cudaGetLastError(), cudaSuccess);
+      EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+      wholememory_communicator_barrier(wm_comm);
+
+      if (!params.use_host_start_nodes) {
+        EXPECT_EQ(cudaMemcpyAsync(host_output_walks,
+                                  dev_output_walks,
+                                  output_walks_size,
+                                  cudaMemcpyDeviceToHost,
+                                  stream),
+                  cudaSuccess);
+        EXPECT_EQ(cudaMemcpyAsync(host_output_restart_count,
+                                  dev_output_restart_count,
+                                  restart_count_size,
+                                  cudaMemcpyDeviceToHost,
+                                  stream),
+                  cudaSuccess);
+      }
+
+      EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+      wholememory_communicator_barrier(wm_comm);
+
+      void* host_ref_output_walks         = malloc(output_walks_size);
+      void* host_ref_output_restart_count = malloc(restart_count_size);
+      // walks are deterministic for same seed, device and host walks should be the same.
+      wholegraph_ops::testing::wholegraph_csr_random_walk_cpu(
+        host_csr_row_ptr,
+        csr_row_ptr_desc,
+        host_csr_col_ptr,
+        csr_col_ptr_desc,
+        params.weighted ? host_csr_weight_ptr : nullptr,
+        csr_weight_ptr_desc,
+        host_start_nodes,
+        start_node_desc,
+        walk_length,
+        params.p,
+        params.q,
+        params.restart_probability,
+        host_ref_output_walks,
+        static_cast<int*>(host_ref_output_restart_count),
+        random_seed);
+
+      wholegraph_ops::testing::host_check_two_array_same(host_output_walks,
+                                                         output_walks_array_desc,
+                                                         host_ref_output_walks,
+                                                         output_walks_array_desc);
+      if (params.use_restart_count) {
+        wholegraph_ops::testing::host_check_two_array_same(host_output_restart_count,
+                                                           restart_count_desc,
+                                                           host_ref_output_restart_count,
+                                                           restart_count_desc);
+      }
+
+      // every step should follow an edge, restart from start node, or pad dead end with -1.
+      auto* csr_row_ptr = static_cast<int64_t*>(host_csr_row_ptr);
+      auto* csr_col_ptr = static_cast<int*>(host_csr_col_ptr);
+      auto* walks       = static_cast<int*>(host_output_walks);
+      for (int64_t i = 0; i < start_node_count; i++) {
+        int* walk          = walks + i * (walk_length + 1);
+        int64_t start_node = start_node_desc.dtype == WHOLEMEMORY_DT_INT64
+                               ? static_cast<int64_t*>(host_start_nodes)[i]
+                               : static_cast<int*>(host_start_nodes)[i];
+        EXPECT_EQ(walk[0], start_node);
+        for (int step = 1; step <= walk_length; step++) {
+          int prev = walk[step - 1];
+          int node = walk[step];
+          if (prev == -1) {
+            EXPECT_EQ(node, -1);
+            continue;
+          }
+          int* neighbor_begin = csr_col_ptr + csr_row_ptr[prev];
+          int* neighbor_end   = csr_col_ptr + csr_row_ptr[prev + 1];
+          if (node == -1) {
+            EXPECT_EQ(neighbor_begin, neighbor_end);
+            continue;
+          }
+          bool is_restart = params.restart_probability > 0.0f && node == start_node;
+          EXPECT_TRUE(is_restart || std::find(neighbor_begin, neighbor_end, node) != neighbor_end);
+        }
+      }
+
+      free(host_ref_output_walks);
+      free(host_ref_output_restart_count);
+
+      EXPECT_EQ(cudaFreeHost(host_start_nodes), cudaSuccess);
+      EXPECT_EQ(cudaFreeHost(host_output_walks), cudaSuccess);
+      EXPECT_EQ(cudaFreeHost(host_output_restart_count), cudaSuccess);
+      EXPECT_EQ(cudaFree(dev_start_nodes), cudaSuccess);
+      EXPECT_EQ(cudaFree(dev_output_walks), cudaSuccess);
+      EXPECT_EQ(cudaFree(dev_output_restart_count), cudaSuccess);
+
+      EXPECT_EQ(wholememory_free(csr_row_ptr_memory_handle), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_free(csr_col_ptr_memory_handle), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_free(csr_weight_ptr_memory_handle), WHOLEMEMORY_SUCCESS);
+
+      EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+      WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+    },
+    true);
+
+  if (host_csr_row_ptr != nullptr) free(host_csr_row_ptr);
+  if (host_csr_col_ptr != nullptr) free(host_csr_col_ptr);
+  if (host_csr_weight_ptr != nullptr) free(host_csr_weight_ptr);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+  WholeGraphCSRRandomWalkOpTests,
+  WholeGraphCSRRandomWalkParameterTests,
+  ::testing::Values(
+    WholeGraphCSRRandomWalkTestParam().set_memory_type(WHOLEMEMORY_MT_CONTINUOUS),
+    WholeGraphCSRRandomWalkTestParam().set_memory_type(WHOLEMEMORY_MT_CHUNKED),
+    WholeGraphCSRRandomWalkTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
+      .set_walk_length(0),
+    WholeGraphCSRRandomWalkTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
+      .set_walk_length(32)
+      .set_start_node_type(WHOLEMEMORY_DT_INT64),
+    WholeGraphCSRRandomWalkTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
+      .set_p_q(0.5f, 2.0f),
+    WholeGraphCSRRandomWalkTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_p_q(4.0f, 0.25f)
+      .set_restart_probability(0.2f)
+      .set_use_restart_count(true),
+    WholeGraphCSRRandomWalkTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_weighted(true),
+    WholeGraphCSRRandomWalkTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
+      .set_weighted(true)
+      .set_p_q(2.0f, 0.5f)
+      .set_restart_probability(0.1f)
+      .set_use_restart_count(true),
+    WholeGraphCSRRandomWalkTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_restart_probability(0.3f)
+      .set_use_restart_count(true),
+    WholeGraphCSRRandomWalkTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_p_q(0.5f, 2.0f)
+      .set_use_host_start_nodes(true),
+    WholeGraphCSRRandomWalkTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_weighted(true)
+      .set_p_q(2.0f, 0.5f)
+      .set_restart_probability(0.2f)
+      .set_use_restart_count(true)
+      .set_start_node_type(WHOLEMEMORY_DT_INT64)
+      .set_use_host_start_nodes(true)));
@@ -0,0 +1,762 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+#include <wholememory/tensor_description.h>
+#include <wholememory/wholegraph_op.h>
+#include <wholememory/wholememory.h>
+
+#include "parallel_utils.hpp"
+#include "wholememory/communicator.hpp"
+#include "wholememory/env_func_ptrs.hpp"
+#include "wholememory/initialize.hpp"
+
+#include "../wholememory/wholememory_test_utils.hpp"
+#include "graph_sampling_test_utils.hpp"
+
+typedef struct WholeGraphCSRSampleWithReplacementTestParam {
+  wholememory_array_description_t get_csr_row_ptr_desc() const
+  {
+    return wholememory_create_array_desc(graph_node_count + 1, 0, csr_row_ptr_dtype);
+  }
+
+  wholememory_array_description_t get_csr_col_ptr_desc() const
+  {
+    return wholememory_create_array_desc(graph_edge_count, 0, csr_col_ptr_dtype);
+  }
+
+  wholememory_array_description_t get_csr_weight_ptr_desc() const
+  {
+    return wholememory_create_array_desc(graph_edge_count, 0, csr_weight_ptr_dtype);
+  }
+
+  wholememory_array_description_t get_center_node_desc() const
+  {
+    return wholememory_create_array_desc(center_node_count, 0, center_node_dtype);
+  }
+
+  wholememory_array_description_t get_center_fanout_desc() const
+  {
+    return wholememory_create_array_desc(center_node_count, 0, WHOLEMEMORY_DT_INT);
+  }
+
+  wholememory_array_description_t get_output_sample_offset_desc() const
+  {
+    return wholememory_create_array_desc(center_node_count + 1, 0, output_sample_offset_dtype);
+  }
+
+  int64_t get_graph_node_count() const { return graph_node_count; }
+  int64_t get_graph_edge_count() const { return graph_edge_count; }
+  int64_t get_max_sample_count() const { return max_sample_count; }
+
+  WholeGraphCSRSampleWithReplacementTestParam& set_memory_type(
+    wholememory_memory_type_t new_memory_type)
+  {
+    memory_type = new_memory_type;
+    return *this;
+  };
+  WholeGraphCSRSampleWithReplacementTestParam& set_memory_location(
+    wholememory_memory_location_t new_memory_location)
+  {
+    memory_location = new_memory_location;
+    return *this;
+  };
+  WholeGraphCSRSampleWithReplacementTestParam& set_max_sample_count(int new_sample_count)
+  {
+    max_sample_count = new_sample_count;
+    return *this;
+  }
+  WholeGraphCSRSampleWithReplacementTestParam& set_center_node_count(int new_center_node_count)
+  {
+    center_node_count = new_center_node_count;
+    return *this;
+  }
+  WholeGraphCSRSampleWithReplacementTestParam& set_graph_node_count(int new_graph_node_count)
+  {
+    graph_node_count = new_graph_node_count;
+    return *this;
+  }
+  WholeGraphCSRSampleWithReplacementTestParam& set_graph_edge_count(int new_graph_edge_count)
+  {
+    graph_edge_count = new_graph_edge_count;
+    return *this;
+  }
+  WholeGraphCSRSampleWithReplacementTestParam& set_center_node_type(
+    wholememory_dtype_t new_center_node_dtype)
+  {
+    center_node_dtype = new_center_node_dtype;
+    return *this;
+  }
+  WholeGraphCSRSampleWithReplacementTestParam& set_weighted(bool new_weighted)
+  {
+    weighted = new_weighted;
+    return *this;
+  }
+  WholeGraphCSRSampleWithReplacementTestParam& set_zero_odd_weights(bool new_zero_odd_weights)
+  {
+    zero_odd_weights = new_zero_odd_weights;
+    return *this;
+  }
+  WholeGraphCSRSampleWithReplacementTestParam& set_use_center_fanout(bool new_use_center_fanout)
+  {
+    use_center_fanout = new_use_center_fanout;
+    return *this;
+  }
+  WholeGraphCSRSampleWithReplacementTestParam& set_use_host_center_nodes(
+    bool new_use_host_center_nodes)
+  {
+    use_host_center_nodes = new_use_host_center_nodes;
+    return *this;
+  }
+
+  wholememory_memory_type_t memory_type          = WHOLEMEMORY_MT_CHUNKED;
+  wholememory_memory_location_t memory_location  = WHOLEMEMORY_ML_DEVICE;
+  bool weighted                                  = false;
+  bool zero_odd_weights                          = false;
+  bool use_center_fanout                         = false;
+  bool use_host_center_nodes                     = false;
+  int64_t max_sample_count                       = 10;
+  int64_t center_node_count                      = 512;
+  int64_t graph_node_count                       = 9703LL;
+  int64_t graph_edge_count                       = 104323L;
+  wholememory_dtype_t csr_row_ptr_dtype          = WHOLEMEMORY_DT_INT64;
+  wholememory_dtype_t csr_col_ptr_dtype          = WHOLEMEMORY_DT_INT;
+  wholememory_dtype_t csr_weight_ptr_dtype       = WHOLEMEMORY_DT_FLOAT;
+  wholememory_dtype_t center_node_dtype          = WHOLEMEMORY_DT_INT;
+  wholememory_dtype_t output_sample_offset_dtype = WHOLEMEMORY_DT_INT;
+} WholeGraphCSRSampleWithReplacementTestParam;
+
+class WholeGraphCSRSampleWithReplacementParameterTests
+  : public ::testing::TestWithParam<WholeGraphCSRSampleWithReplacementTestParam> {};
+
+TEST_P(WholeGraphCSRSampleWithReplacementParameterTests, SampleWithReplacementTest)
+{
+  auto params   = GetParam();
+  int dev_count = ForkGetDeviceCount();
+  EXPECT_GE(dev_count, 1);
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, dev_count);
+  auto graph_node_count          = params.get_graph_node_count();
+  auto graph_edge_count          = params.get_graph_edge_count();
+  auto graph_csr_row_ptr_desc    = params.get_csr_row_ptr_desc();
+  auto graph_csr_col_ptr_desc    = params.get_csr_col_ptr_desc();
+  auto graph_csr_weight_ptr_desc = params.get_csr_weight_ptr_desc();
+
+  void* host_csr_row_ptr =
+    (void*)malloc(wholememory_get_memory_size_from_array(&graph_csr_row_ptr_desc));
+  void* host_csr_col_ptr =
+    (void*)malloc(wholememory_get_memory_size_from_array(&graph_csr_col_ptr_desc));
+  void* host_csr_weight_ptr =
+    (void*)malloc(wholememory_get_memory_size_from_array(&graph_csr_weight_ptr_desc));
+  wholegraph_ops::testing::gen_csr_graph(graph_node_count,
+                                         graph_edge_count,
+                                         host_csr_row_ptr,
+                                         graph_csr_row_ptr_desc,
+                                         host_csr_col_ptr,
+                                         graph_csr_col_ptr_desc,
+                                         host_csr_weight_ptr,
+                                         graph_csr_weight_ptr_desc);
+  if (params.zero_odd_weights) {
+    for (int64_t i = 1; i < graph_edge_count; i += 2) {
+      static_cast<float*>(host_csr_weight_ptr)[i] = 0.0f;
+    }
+  }
+
+  MultiProcessRun(
+    dev_count,
+    [&params, &pipes, host_csr_row_ptr, host_csr_col_ptr, host_csr_weight_ptr](int world_rank,
+                                                                               int world_size) {
+      thread_local std::random_device rd;
+      thread_local std::mt19937 gen(rd());
+      thread_local std::uniform_int_distribution<unsigned long long> distrib;
+      unsigned long long random_seed = distrib(gen);
+
+      EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
+
+      EXPECT_EQ(cudaSetDevice(world_rank), cudaSuccess);
+
+      wholememory_comm_t wm_comm = create_communicator_by_pipes(pipes, world_rank, world_size);
+
+      if (wholememory_communicator_support_type_location(
+            wm_comm, params.memory_type, params.memory_location) != WHOLEMEMORY_SUCCESS) {
+        EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+        EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+        WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+        if (world_rank == 0) GTEST_SKIP_("Skip due to not supported.");
+        return;
+      }
+
+      auto csr_row_ptr_desc          = params.get_csr_row_ptr_desc();
+      auto csr_col_ptr_desc          = params.get_csr_col_ptr_desc();
+      auto csr_weight_ptr_desc       = params.get_csr_weight_ptr_desc();
+      auto center_node_desc          = params.get_center_node_desc();
+      auto center_fanout_desc        = params.get_center_fanout_desc();
+      auto output_sample_offset_desc = params.get_output_sample_offset_desc();
+      auto max_sample_count          = params.get_max_sample_count();
+      int64_t graph_node_count       = params.get_graph_node_count();
+
+      size_t center_node_size   = wholememory_get_memory_size_from_array(&center_node_desc);
+      size_t center_fanout_size = wholememory_get_memory_size_from_array(&center_fanout_desc);
+      size_t output_sample_offset_size =
+        wholememory_get_memory_size_from_array(&output_sample_offset_desc);
+
+      cudaStream_t stream;
+      EXPECT_EQ(cudaStreamCreate(&stream), cudaSuccess);
+
+      void *host_ref_output_sample_offset, *host_ref_output_dest_nodes,
+        *host_ref_output_center_nodes_local_id, *host_ref_output_global_edge_id;
+
+      void *host_center_nodes, *host_center_fanout, *host_output_sample_offset,
+        *host_output_dest_nodes, *host_output_center_nodes_local_id, *host_output_global_edge_id;
+      void *dev_center_nodes, *dev_center_fanout, *dev_output_sample_offset;
+
+      wholememory_handle_t csr_row_ptr_memory_handle;
+      wholememory_handle_t csr_col_ptr_memory_handle;
+      wholememory_handle_t csr_weight_ptr_memory_handle;
+
+      EXPECT_EQ(wholememory_malloc(&csr_row_ptr_memory_handle,
+                                   wholememory_get_memory_size_from_array(&csr_row_ptr_desc),
+                                   wm_comm,
+                                   params.memory_type,
+                                   params.memory_location,
+                                   wholememory_dtype_get_element_size(csr_row_ptr_desc.dtype)),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_malloc(&csr_col_ptr_memory_handle,
+                                   wholememory_get_memory_size_from_array(&csr_col_ptr_desc),
+                                   wm_comm,
+                                   params.memory_type,
+                                   params.memory_location,
+                                   wholememory_dtype_get_element_size(csr_col_ptr_desc.dtype)),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_malloc(&csr_weight_ptr_memory_handle,
+                                   wholememory_get_memory_size_from_array(&csr_weight_ptr_desc),
+                                   wm_comm,
+                                   params.memory_type,
+                                   params.memory_location,
+                                   wholememory_dtype_get_element_size(csr_weight_ptr_desc.dtype)),
+                WHOLEMEMORY_SUCCESS);
+
+      wholegraph_ops::testing::copy_host_array_to_wholememory(
+        host_csr_row_ptr, csr_row_ptr_memory_handle, csr_row_ptr_desc, stream);
+      wholegraph_ops::testing::copy_host_array_to_wholememory(
+        host_csr_col_ptr, csr_col_ptr_memory_handle, csr_col_ptr_desc, stream);
+      wholegraph_ops::testing::copy_host_array_to_wholememory(
+        host_csr_weight_ptr, csr_weight_ptr_memory_handle, csr_weight_ptr_desc, stream);
+
+      EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+      wholememory_communicator_barrier(wm_comm);
+
+      EXPECT_EQ(cudaSetDevice(world_rank), cudaSuccess);
+      EXPECT_EQ(cudaMallocHost(&host_center_nodes, center_node_size), cudaSuccess);
+      EXPECT_EQ(cudaMallocHost(&host_center_fanout, center_fanout_size), cudaSuccess);
+      EXPECT_EQ(cudaMallocHost(&host_output_sample_offset, output_sample_offset_size), cudaSuccess);
+
+      EXPECT_EQ(cudaMalloc(&dev_center_nodes, center_node_size), cudaSuccess);
+      EXPECT_EQ(cudaMalloc(&dev_center_fanout, center_fanout_size), cudaSuccess);
+      EXPECT_EQ(cudaMalloc(&dev_output_sample_offset, output_sample_offset_size), cudaSuccess);
+
+      wholegraph_ops::testing::host_random_init_array(
+        host_center_nodes, center_node_desc, 0, graph_node_count - 1);
+      // fanout <= 0 of some center nodes means sample all neighbors of them.
+      wholegraph_ops::testing::host_random_init_array(
+        host_center_fanout, center_fanout_desc, -1, 2 * max_sample_count);
+      EXPECT_EQ(cudaMemcpyAsync(dev_center_nodes,
+                                host_center_nodes,
+                                center_node_size,
+                                cudaMemcpyHostToDevice,
+                                stream),
+                cudaSuccess);
+      EXPECT_EQ(cudaMemcpyAsync(dev_center_fanout,
+                                host_center_fanout,
+                                center_fanout_size,
+                                cudaMemcpyHostToDevice,
+                                stream),
+                cudaSuccess);
+
+      wholememory_tensor_t wm_csr_row_ptr_tensor, wm_csr_col_ptr_tensor, wm_csr_weight_ptr_tensor;
+      wholememory_tensor_description_t wm_csr_row_ptr_tensor_desc, wm_csr_col_ptr_tensor_desc,
+        wm_csr_weight_ptr_tensor_desc;
+      wholememory_copy_array_desc_to_tensor(&wm_csr_row_ptr_tensor_desc, &csr_row_ptr_desc);
+      wholememory_copy_array_desc_to_tensor(&wm_csr_col_ptr_tensor_desc, &csr_col_ptr_desc);
+      wholememory_copy_array_desc_to_tensor(&wm_csr_weight_ptr_tensor_desc, &csr_weight_ptr_desc);
+      EXPECT_EQ(wholememory_make_tensor_from_handle(
+                  &wm_csr_row_ptr_tensor, csr_row_ptr_memory_handle, &wm_csr_row_ptr_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_make_tensor_from_handle(
+                  &wm_csr_col_ptr_tensor, csr_col_ptr_memory_handle, &wm_csr_col_ptr_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(
+        wholememory_make_tensor_from_handle(
+          &wm_csr_weight_ptr_tensor, csr_weight_ptr_memory_handle, &wm_csr_weight_ptr_tensor_desc),
+        WHOLEMEMORY_SUCCESS);
+
+      wholememory_tensor_t center_nodes_tensor, center_fanout_tensor = nullptr,
+                                                output_sample_offset_tensor;
+      wholememory_tensor_description_t center_nodes_tensor_desc, center_fanout_tensor_desc,
+        output_sample_offset_tensor_desc;
+      wholememory_copy_array_desc_to_tensor(&center_nodes_tensor_desc, &center_node_desc);
+      wholememory_copy_array_desc_to_tensor(&center_fanout_tensor_desc, &center_fanout_desc);
+      wholememory_copy_array_desc_to_tensor(&output_sample_offset_tensor_desc,
+                                            &output_sample_offset_desc);
+      EXPECT_EQ(wholememory_make_tensor_from_pointer(
+                  &center_nodes_tensor,
+                  params.use_host_center_nodes ? host_center_nodes : dev_center_nodes,
+                  &center_nodes_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+      if (params.use_center_fanout) {
+        EXPECT_EQ(wholememory_make_tensor_from_pointer(
+                    &center_fanout_tensor,
+                    params.use_host_center_nodes ? host_center_fanout : dev_center_fanout,
+                    &center_fanout_tensor_desc),
+                  WHOLEMEMORY_SUCCESS);
+      }
+      EXPECT_EQ(wholememory_make_tensor_from_pointer(&output_sample_offset_tensor,
+                                                     params.use_host_center_nodes
+                                                       ? host_output_sample_offset
+                                                       : dev_output_sample_offset,
+                                                     &output_sample_offset_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+
+      wholememory_env_func_t* default_env_func = wholememory::get_default_env_func();
+      wholememory::default_memory_context_t output_dest_mem_ctx, output_center_localid_mem_ctx,
+        output_edge_gid_mem_ctx;
+
+      if (params.weighted) {
+        EXPECT_EQ(wholegraph_csr_weighted_sample_with_replacement(wm_csr_row_ptr_tensor,
+                                                                  wm_csr_col_ptr_tensor,
+                                                                  wm_csr_weight_ptr_tensor,
+                                                                  center_nodes_tensor,
+                                                                  max_sample_count,
+                                                                  center_fanout_tensor,
+                                                                  output_sample_offset_tensor,
+                                                                  &output_dest_mem_ctx,
+                                                                  &output_center_localid_mem_ctx,
+                                                                  &output_edge_gid_mem_ctx,
+                                                                  random_seed,
+                                                                  default_env_func,
+                                                                  stream),
+                  WHOLEMEMORY_SUCCESS);
+      } else {
+        EXPECT_EQ(wholegraph_csr_unweighted_sample_with_replacement(wm_csr_row_ptr_tensor,
+                                                                    wm_csr_col_ptr_tensor,
+                                                                    center_nodes_tensor,
+                                                                    max_sample_count,
+                                                                    center_fanout_tensor,
+                                                                    output_sample_offset_tensor,
+                                                                    &output_dest_mem_ctx,
+                                                                    &output_center_localid_mem_ctx,
+                                                                    &output_edge_gid_mem_ctx,
+                                                                    random_seed,
+                                                                    default_env_func,
+                                                                    stream),
+                  WHOLEMEMORY_SUCCESS);
+      }
+
+      EXPECT_EQ(cudaGetLastError(), cudaSuccess);
+      EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+      wholememory_communicator_barrier(wm_comm);
+
+      EXPECT_EQ(output_dest_mem_ctx.desc.dim, 1);
+      EXPECT_EQ(output_center_localid_mem_ctx.desc.dim, 1);
+      EXPECT_EQ(output_edge_gid_mem_ctx.desc.dim, 1);
+
+      EXPECT_EQ(output_dest_mem_ctx.desc.dtype, csr_col_ptr_desc.dtype);
+      EXPECT_EQ(output_center_localid_mem_ctx.desc.dtype, WHOLEMEMORY_DT_INT);
+      EXPECT_EQ(output_edge_gid_mem_ctx.desc.dtype, WHOLEMEMORY_DT_INT64);
+      if (params.use_host_center_nodes && params.memory_type == WHOLEMEMORY_MT_CONTINUOUS &&
+          params.memory_location == WHOLEMEMORY_ML_HOST) {
+        // host graph and host center nodes are sampled on host.
+        EXPECT_EQ(output_dest_mem_ctx.allocation_type, WHOLEMEMORY_MA_HOST);
+      }
+
+      EXPECT_EQ(output_dest_mem_ctx.desc.sizes[0], output_center_localid_mem_ctx.desc.sizes[0]);
+      EXPECT_EQ(output_dest_mem_ctx.desc.sizes[0], output_edge_gid_mem_ctx.desc.sizes[0]);
+
+      int64_t total_sample_count = output_dest_mem_ctx.desc.sizes[0];
+
+      host_output_dest_nodes =
+        malloc(total_sample_count * wholememory_dtype_get_element_size(csr_col_ptr_desc.dtype));
+      host_output_center_nodes_local_id = malloc(total_sample_count * sizeof(int));
+      host_output_global_edge_id        = malloc(total_sample_count * sizeof(int64_t));
+
+      // host sampling outputs are host memory, so copy with cudaMemcpyDefault.
+      if (!params.use_host_center_nodes) {
+        EXPECT_EQ(cudaMemcpyAsync(host_output_sample_offset,
+                                  dev_output_sample_offset,
+                                  output_sample_offset_size,
+                                  cudaMemcpyDeviceToHost,
+                                  stream),
+                  cudaSuccess);
+      }
+      EXPECT_EQ(cudaMemcpyAsync(
+                  host_output_dest_nodes,
+                  output_dest_mem_ctx.ptr,
+                  total_sample_count * wholememory_dtype_get_element_size(csr_col_ptr_desc.dtype),
+                  cudaMemcpyDefault,
+                  stream),
+                cudaSuccess);
+      EXPECT_EQ(cudaMemcpyAsync(host_output_center_nodes_local_id,
+                                output_center_localid_mem_ctx.ptr,
+                                total_sample_count * sizeof(int),
+                                cudaMemcpyDefault,
+                                stream),
+                cudaSuccess);
+      EXPECT_EQ(cudaMemcpyAsync(host_output_global_edge_id,
+                                output_edge_gid_mem_ctx.ptr,
+                                total_sample_count * sizeof(int64_t),
+                                cudaMemcpyDefault,
+                                stream),
+                cudaSuccess);
+
+      EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+      wholememory_communicator_barrier(wm_comm);
+
+      int host_total_sample_count;
+      // with replacement sampling is deterministic for same seed, so no need to sort outputs.
+      wholegraph_ops::testing::wholegraph_csr_sample_with_replacement_cpu(
+        host_csr_row_ptr,
+        csr_row_ptr_desc,
+        host_csr_col_ptr,
+        csr_col_ptr_desc,
+        params.weighted ? host_csr_weight_ptr : nullptr,
+        csr_weight_ptr_desc,
+        host_center_nodes,
+        center_node_desc,
+        max_sample_count,
+        params.use_center_fanout ? static_cast<const int*>(host_center_fanout) : nullptr,
+        &host_ref_output_sample_offset,
+        output_sample_offset_desc,
+        &host_ref_output_dest_nodes,
+        &host_ref_output_center_nodes_local_id,
+        &host_ref_output_global_edge_id,
+        &host_total_sample_count,
+        random_seed);
+
+      EXPECT_EQ(total_sample_count, host_total_sample_count);
+      wholegraph_ops::testing::host_check_two_array_same(host_output_sample_offset,
+                                                         output_sample_offset_desc,
+                                                         host_ref_output_sample_offset,
+                                                         output_sample_offset_desc);
+      wholegraph_ops::testing::host_check_two_array_same(
+        host_output_dest_nodes,
+        wholememory_create_array_desc(host_total_sample_count, 0, csr_col_ptr_desc.dtype),
+        host_ref_output_dest_nodes,
+        wholememory_create_array_desc(host_total_sample_count, 0, csr_col_ptr_desc.dtype));
+
+      wholegraph_ops::testing::host_check_two_array_same(
+        host_output_center_nodes_local_id,
+        wholememory_create_array_desc(host_total_sample_count, 0, WHOLEMEMORY_DT_INT),
+        host_ref_output_center_nodes_local_id,
+        wholememory_create_array_desc(host_total_sample_count, 0, WHOLEMEMORY_DT_INT));
+
+      wholegraph_ops::testing::host_check_two_array_same(
+        host_output_global_edge_id,
+        wholememory_create_array_desc(host_total_sample_count, 0, WHOLEMEMORY_DT_INT64),
+        host_ref_output_global_edge_id,
+        wholememory_create_array_desc(host_total_sample_count, 0, WHOLEMEMORY_DT_INT64));
+
+      if (params.weighted && params.zero_odd_weights) {
+        // zero weight edges are sampled only if all edges of center node have zero weight.
+        auto* csr_row_ptr    = static_cast<int64_t*>(host_csr_row_ptr);
+        auto* edge_gid       = static_cast<int64_t*>(host_output_global_edge_id);
+        auto* center_localid = static_cast<int*>(host_output_center_nodes_local_id);
+        for (int64_t i = 0; i < total_sample_count; i++) {
+          if (edge_gid[i] % 2 == 0) continue;
+          int64_t center_node_id = center_node_desc.dtype == WHOLEMEMORY_DT_INT64
+                                     ? static_cast<int64_t*>(host_center_nodes)[center_localid[i]]
+                                     : static_cast<int*>(host_center_nodes)[center_localid[i]];
+          EXPECT_EQ(csr_row_ptr[center_node_id + 1] - csr_row_ptr[center_node_id], 1);
+        }
+      }
+
+      (default_env_func->output_fns).free_fn(&output_dest_mem_ctx, nullptr);
+      (default_env_func->output_fns).free_fn(&output_center_localid_mem_ctx, nullptr);
+      (default_env_func->output_fns).free_fn(&output_edge_gid_mem_ctx, nullptr);
+
+      if (host_ref_output_sample_offset != nullptr) free(host_ref_output_sample_offset);
+      if (host_ref_output_dest_nodes != nullptr) free(host_ref_output_dest_nodes);
+      if (host_ref_output_center_nodes_local_id != nullptr)
+        free(host_ref_output_center_nodes_local_id);
+      if (host_ref_output_global_edge_id != nullptr) free(host_ref_output_global_edge_id);
+      free(host_output_dest_nodes);
+      free(host_output_center_nodes_local_id);
+      free(host_output_global_edge_id);
+
+      EXPECT_EQ(cudaFreeHost(host_center_nodes), cudaSuccess);
+      EXPECT_EQ(cudaFreeHost(host_center_fanout), cudaSuccess);
+      EXPECT_EQ(cudaFreeHost(host_output_sample_offset), cudaSuccess);
+      EXPECT_EQ(cudaFree(dev_center_nodes), cudaSuccess);
+      EXPECT_EQ(cudaFree(dev_center_fanout), cudaSuccess);
+      EXPECT_EQ(cudaFree(dev_output_sample_offset), cudaSuccess);
+
+      EXPECT_EQ(wholememory_free(csr_row_ptr_memory_handle), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_free(csr_col_ptr_memory_handle), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_free(csr_weight_ptr_memory_handle), WHOLEMEMORY_SUCCESS);
+
+      EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+      WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+    },
+    true);
+
+  if (host_csr_row_ptr != nullptr) free(host_csr_row_ptr);
+  if (host_csr_col_ptr != nullptr) free(host_csr_col_ptr);
+  if (host_csr_weight_ptr != nullptr) free(host_csr_weight_ptr);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+  WholeGraphCSRSampleWithReplacementOpTests,
+  WholeGraphCSRSampleWithReplacementParameterTests,
+  ::testing::Values(
+    WholeGraphCSRSampleWithReplacementTestParam().set_memory_type(WHOLEMEMORY_MT_CONTINUOUS),
+    WholeGraphCSRSampleWithReplacementTestParam().set_memory_type(WHOLEMEMORY_MT_CHUNKED),
+    WholeGraphCSRSampleWithReplacementTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
+      .set_max_sample_count(-1),
+    WholeGraphCSRSampleWithReplacementTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
+      .set_max_sample_count(200)
+      .set_center_node_type(WHOLEMEMORY_DT_INT64),
+    WholeGraphCSRSampleWithReplacementTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_use_center_fanout(true),
+    WholeGraphCSRSampleWithReplacementTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_use_center_fanout(true)
+      .set_use_host_center_nodes(true),
+    WholeGraphCSRSampleWithReplacementTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_weighted(true),
+    WholeGraphCSRSampleWithReplacementTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
+      .set_weighted(true)
+      .set_max_sample_count(-1),
+    WholeGraphCSRSampleWithReplacementTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
+      .set_weighted(true)
+      .set_zero_odd_weights(true)
+      .set_use_center_fanout(true),
+    WholeGraphCSRSampleWithReplacementTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_weighted(true)
+      .set_zero_odd_weights(true)
+      .set_use_host_center_nodes(true),
+    WholeGraphCSRSampleWithReplacementTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_weighted(true)
+      .set_use_center_fanout(true)
+      .set_center_node_type(WHOLEMEMORY_DT_INT64)
+      .set_use_host_center_nodes(true)));
+
+TEST(WholeGraphCSRSampleWithReplacementOpTests, WeightedSampleFrequencyTest)
+{
+  // node 0 has few edges, node 1 has more edges than one block of building threads, node 2 has
+  // skewed weights spanning many orders of magnitude.
+  const std::vector<float> node0_weights = {1.0f, 0.0f, 2.0f, 4.0f, 0.0f, 9.0f};
+  const int64_t node0_degree             = node0_weights.size();
+  const int64_t node1_degree             = 3000;
+  const std::vector<float> node2_heavy_weights = {1.0f, 1e-1f, 1e-2f, 1e-3f};
+  const int64_t node2_tiny_count               = 4096;
+  const float node2_tiny_weight                = 1e-12f;
+  const int64_t node2_degree     = node2_heavy_weights.size() + node2_tiny_count;
+  const int64_t max_sample_count = 200000;
+  std::vector<int64_t> host_csr_row_ptr = {
+    0, node0_degree, node0_degree + node1_degree, node0_degree + node1_degree + node2_degree};
+  int64_t graph_edge_count = host_csr_row_ptr.back();
+  std::vector<int> host_csr_col_ptr(graph_edge_count);
+  std::vector<float> host_csr_weight_ptr(graph_edge_count);
+  for (int64_t i = 0; i < graph_edge_count; i++) {
+    host_csr_col_ptr[i] = static_cast<int>(i % 2);
+    if (i < host_csr_row_ptr[1]) {
+      host_csr_weight_ptr[i] = node0_weights[i];
+    } else if (i < host_csr_row_ptr[2]) {
+      host_csr_weight_ptr[i] = static_cast<float>((i - host_csr_row_ptr[1]) % 3);
+    } else {
+      int64_t j              = i - host_csr_row_ptr[2];
+      host_csr_weight_ptr[i] = j < static_cast<int64_t>(node2_heavy_weights.size())
+                                 ? node2_heavy_weights[j]
+                                 : node2_tiny_weight;
+    }
+  }
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, 1);
+
+  MultiProcessRun(
+    1,
+    [&](int world_rank, int world_size) {
+      EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(cudaSetDevice(world_rank), cudaSuccess);
+      wholememory_comm_t wm_comm = create_communicator_by_pipes(pipes, world_rank, world_size);
+
+      cudaStream_t stream;
+      EXPECT_EQ(cudaStreamCreate(&stream), cudaSuccess);
+
+      auto csr_row_ptr_desc = wholememory_create_array_desc(4, 0, WHOLEMEMORY_DT_INT64);
+      auto csr_col_ptr_desc =
+        wholememory_create_array_desc(graph_edge_count, 0, WHOLEMEMORY_DT_INT);
+      auto csr_weight_ptr_desc =
+        wholememory_create_array_desc(graph_edge_count, 0, WHOLEMEMORY_DT_FLOAT);
+      std::vector<std::pair<void*, wholememory_array_description_t>> graph_arrays = {
+        {host_csr_row_ptr.data(), csr_row_ptr_desc},
+        {host_csr_col_ptr.data(), csr_col_ptr_desc},
+        {host_csr_weight_ptr.data(), csr_weight_ptr_desc}};
+      std::vector<wholememory_handle_t> handles(graph_arrays.size());
+      std::vector<wholememory_tensor_t> tensors(graph_arrays.size());
+      for (size_t i = 0; i < graph_arrays.size(); i++) {
+        auto& array_desc = graph_arrays[i].second;
+        EXPECT_EQ(wholememory_malloc(&handles[i],
+                                     wholememory_get_memory_size_from_array(&array_desc),
+                                     wm_comm,
+                                     WHOLEMEMORY_MT_CONTINUOUS,
+                                     WHOLEMEMORY_ML_DEVICE,
+                                     wholememory_dtype_get_element_size(array_desc.dtype)),
+                  WHOLEMEMORY_SUCCESS);
+        wholegraph_ops::testing::copy_host_array_to_wholememory(
+          graph_arrays[i].first, handles[i], array_desc, stream);
+        wholememory_tensor_description_t tensor_desc;
+        wholememory_copy_array_desc_to_tensor(&tensor_desc, &array_desc);
+        EXPECT_EQ(wholememory_make_tensor_from_handle(&tensors[i], handles[i], &tensor_desc),
+                  WHOLEMEMORY_SUCCESS);
+      }
+
+      int host_center_nodes[3] = {0, 1, 2};
+      void *dev_center_nodes, *dev_output_sample_offset;
+      EXPECT_EQ(cudaMalloc(&dev_center_nodes, sizeof(host_center_nodes)), cudaSuccess);
+      EXPECT_EQ(cudaMalloc(&dev_output_sample_offset, 4 * sizeof(int)), cudaSuccess);
+      EXPECT_EQ(cudaMemcpyAsync(dev_center_nodes,
+                                host_center_nodes,
+                                sizeof(host_center_nodes),
+                                cudaMemcpyHostToDevice,
+                                stream),
+                cudaSuccess);
+      wholememory_tensor_t center_nodes_tensor, output_sample_offset_tensor;
+      wholememory_tensor_description_t center_nodes_tensor_desc, output_sample_offset_tensor_desc;
+      auto center_node_desc          = wholememory_create_array_desc(3, 0, WHOLEMEMORY_DT_INT);
+      auto output_sample_offset_desc = wholememory_create_array_desc(4, 0, WHOLEMEMORY_DT_INT);
+      wholememory_copy_array_desc_to_tensor(&center_nodes_tensor_desc, &center_node_desc);
+      wholememory_copy_array_desc_to_tensor(&output_sample_offset_tensor_desc,
+                                            &output_sample_offset_desc);
+      EXPECT_EQ(wholememory_make_tensor_from_pointer(
+                  &center_nodes_tensor, dev_center_nodes, &center_nodes_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_make_tensor_from_pointer(&output_sample_offset_tensor,
+                                                     dev_output_sample_offset,
+                                                     &output_sample_offset_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+
+      wholememory_env_func_t* default_env_func = wholememory::get_default_env_func();
+      wholememory::default_memory_context_t output_dest_mem_ctx, output_center_localid_mem_ctx,
+        output_edge_gid_mem_ctx;
+      EXPECT_EQ(wholegraph_csr_weighted_sample_with_replacement(tensors[0],
+                                                                tensors[1],
+                                                                tensors[2],
+                                                                center_nodes_tensor,
+                                                                max_sample_count,
+                                                                nullptr,
+                                                                output_sample_offset_tensor,
+                                                                &output_dest_mem_ctx,
+                                                                &output_center_localid_mem_ctx,
+                                                                &output_edge_gid_mem_ctx,
+                                                                2023ULL,
+                                                                default_env_func,
+                                                                stream),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+
+      int64_t total_sample_count = output_edge_gid_mem_ctx.desc.sizes[0];
+      EXPECT_EQ(total_sample_count, 3 * max_sample_count);
+      std::vector<int64_t> host_edge_gid(total_sample_count);
+      std::vector<int> host_center_localid(total_sample_count);
+      EXPECT_EQ(cudaMemcpy(host_edge_gid.data(),
+                           output_edge_gid_mem_ctx.ptr,
+                           total_sample_count * sizeof(int64_t),
+                           cudaMemcpyDeviceToHost),
+                cudaSuccess);
+      EXPECT_EQ(cudaMemcpy(host_center_localid.data(),
+                           output_center_localid_mem_ctx.ptr,
+                           total_sample_count * sizeof(int),
+                           cudaMemcpyDeviceToHost),
+                cudaSuccess);
+
+      // frequencies are checked against weights only, independent of the sampling method.
+      std::vector<int64_t> edge_hits(graph_edge_count, 0);
+      for (int64_t i = 0; i < total_sample_count; i++) {
+        int64_t gid = host_edge_gid[i];
+        bool in_range = gid >= host_csr_row_ptr[host_center_localid[i]] &&
+                        gid < host_csr_row_ptr[host_center_localid[i] + 1];
+        EXPECT_TRUE(in_range);
+        if (in_range) edge_hits[gid]++;
+      }
+      auto expect_frequency = [max_sample_count](int64_t hits, double p) {
+        double freq = static_cast<double>(hits) / max_sample_count;
+        double tol  = 5.0 * std::sqrt(p * (1.0 - p) / max_sample_count) + 1e-4;
+        EXPECT_NEAR(freq, p, tol);
+      };
+      float node0_weight_sum = 0.0f;
+      for (auto w : node0_weights)
+        node0_weight_sum += w;
+      for (int64_t i = 0; i < node0_degree; i++) {
+        if (node0_weights[i] == 0.0f) {
+          EXPECT_EQ(edge_hits[i], 0);
+        } else {
+          expect_frequency(edge_hits[i], node0_weights[i] / node0_weight_sum);
+        }
+      }
+      int64_t weight_class_hits[3] = {0, 0, 0};
+      for (int64_t i = host_csr_row_ptr[1]; i < host_csr_row_ptr[2]; i++) {
+        weight_class_hits[static_cast<int>(host_csr_weight_ptr[i])] += edge_hits[i];
+      }
+      EXPECT_EQ(weight_class_hits[0], 0);
+      expect_frequency(weight_class_hits[1], 1.0 / 3.0);
+      expect_frequency(weight_class_hits[2], 2.0 / 3.0);
+      // exact weights, tiny ones are about 1e-12 of the largest and should almost never be drawn.
+      double node2_weight_sum = node2_tiny_count * static_cast<double>(node2_tiny_weight);
+      for (auto w : node2_heavy_weights)
+        node2_weight_sum += w;
+      for (size_t j = 0; j < node2_heavy_weights.size(); j++) {
+        expect_frequency(edge_hits[host_csr_row_ptr[2] + j],
+                         node2_heavy_weights[j] / node2_weight_sum);
+      }
+      int64_t tiny_hits = 0;
+      for (int64_t i = host_csr_row_ptr[2] + static_cast<int64_t>(node2_heavy_weights.size());
+           i < graph_edge_count;
+           i++) {
+        tiny_hits += edge_hits[i];
+      }
+      EXPECT_LE(tiny_hits, 2);
+
+      (default_env_func->output_fns).free_fn(&output_dest_mem_ctx, nullptr);
+      (default_env_func->output_fns).free_fn(&output_center_localid_mem_ctx, nullptr);
+      (default_env_func->output_fns).free_fn(&output_edge_gid_mem_ctx, nullptr);
+      EXPECT_EQ(cudaFree(dev_center_nodes), cudaSuccess);
+      EXPECT_EQ(cudaFree(dev_output_sample_offset), cudaSuccess);
+      for (auto handle : handles) {
+        EXPECT_EQ(wholememory_free(handle), WHOLEMEMORY_SUCCESS);
+      }
+      EXPECT_EQ(cudaStreamDestroy(stream), cudaSuccess);
+
+      EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+      WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+    },
+    true);
+}
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <wholememory/tensor_description.h>
+#include <wholememory/wholegraph_op.h>
+#include <wholememory/wholememory.h>
+
+#include "parallel_utils.hpp"
+#include "wholememory/communicator.hpp"
+#include "wholememory/env_func_ptrs.hpp"
+#include "wholememory/initialize.hpp"
+
+#include "../wholememory/wholememory_test_utils.hpp"
+#include "graph_sampling_test_utils.hpp"
+
+typedef struct WholeGraphCSRUnweightedMultilayerSampleTestParam {
+  wholememory_array_description_t get_csr_row_ptr_desc() const
+  {
+    return wholememory_create_array_desc(graph_node_count + 1, 0, WHOLEMEMORY_DT_INT64);
+  }
+  wholememory_array_description_t get_csr_col_ptr_desc() const
+  {
+    return wholememory_create_array_desc(graph_edge_count, 0, WHOLEMEMORY_DT_INT);
+  }
+  wholememory_array_description_t get_center_node_desc() const
+  {
+    return wholememory_create_array_desc(center_node_count, 0, WHOLEMEMORY_DT_INT);
+  }
+  WholeGraphCSRUnweightedMultilayerSampleTestParam& set_memory_type(
+    wholememory_memory_type_t new_memory_type)
+  {
+    memory_type = new_memory_type;
+    return *this;
+  }
+  WholeGraphCSRUnweightedMultilayerSampleTestParam& set_memory_location(
+    wholememory_memory_location_t new_memory_location)
+  {
+    memory_location = new_memory_location;
+    return *this;
+  }
+  WholeGraphCSRUnweightedMultilayerSampleTestParam& set_max_sample_counts(
+    std::vector<int> new_max_sample_counts)
+  {
+    max_sample_counts = new_max_sample_counts;
+    return *this;
+  }
+  wholememory_memory_type_t memory_type         = WHOLEMEMORY_MT_CONTINUOUS;
+  wholememory_memory_location_t memory_location = WHOLEMEMORY_ML_DEVICE;
+  std::vector<int> max_sample_counts            = {15, 10};
+  int64_t center_node_count                     = 512;
+  int64_t graph_node_count                      = 9703LL;
+  int64_t graph_edge_count                      = 104323L;
+} WholeGraphCSRUnweightedMultilayerSampleTestParam;
+
+class WholeGraphCSRUnweightedMultilayerSampleParameterTests
+  : public ::testing::TestWithParam<WholeGraphCSRUnweightedMultilayerSampleTestParam> {};
+
+static std::vector<int> copy_int_output_to_host(const wholememory::default_memory_context_t& ctx)
+{
+  std::vector<int> host_output(wholememory_get_memory_element_count_from_tensor(
+    const_cast<wholememory_tensor_description_t*>(&ctx.desc)));
+  if (!host_output.empty()) {
+    EXPECT_EQ(cudaMemcpy(
+                host_output.data(), ctx.ptr, host_output.size() * sizeof(int), cudaMemcpyDefault),
+              cudaSuccess);
+  }
+  return host_output;
+}
+
+TEST_P(WholeGraphCSRUnweightedMultilayerSampleParameterTests, MultilayerSampleTest)
+{
+  auto params   = GetParam();
+  int dev_count = ForkGetDeviceCount();
+  EXPECT_GE(dev_count, 1);
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, dev_count);
+  auto graph_csr_row_ptr_desc = params.get_csr_row_ptr_desc();
+  auto graph_csr_col_ptr_desc = params.get_csr_col_ptr_desc();
+
+  void* host_csr_row_ptr =
+    (void*)malloc(wholememory_get_memory_size_from_array(&graph_csr_row_ptr_desc));
+  void* host_csr_col_ptr =
+    (void*)malloc(wholememory_get_memory_size_from_array(&graph_csr_col_ptr_desc));
+
+  wholegraph_ops::testing::gen_csr_graph(params.graph_node_count,
+                                         params.graph_edge_count,
+                                         host_csr_row_ptr,
+                                         graph_csr_row_ptr_desc,
+                                         host_csr_col_ptr,
+                                         graph_csr_col_ptr_desc);
+
+  MultiProcessRun(
+    dev_count,
+    [&params, &pipes, host_csr_row_ptr, host_csr_col_ptr](int world_rank, int world_size) {
+      thread_local std::random_device rd;
+      thread_local std::mt19937 gen(rd());
+      thread_local std::uniform_int_distribution<unsigned long long> distrib;
+      unsigned long long random_seed = distrib(gen);
+
+      EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(cudaSetDevice(world_rank), cudaSuccess);
+      wholememory_comm_t wm_comm = create_communicator_by_pipes(pipes, world_rank, world_size);
+
+      if (wholememory_communicator_support_type_location(
+            wm_comm, params.memory_type, params.memory_location) != WHOLEMEMORY_SUCCESS) {
+        EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+        EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+        WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+        if (world_rank == 0) GTEST_SKIP_("Skip due to not supported.");
+        return;
+      }
+
+      auto csr_row_ptr_desc = params.get_csr_row_ptr_desc();
+      auto csr_col_ptr_desc = params.get_csr_col_ptr_desc();
+      auto center_node_desc = params.get_center_node_desc();
+      int hop_count         = static_cast<int>(params.max_sample_counts.size());
+      // host graph and host center nodes run on host.
+      bool const use_host = params.memory_location == WHOLEMEMORY_ML_HOST &&
+                            params.memory_type == WHOLEMEMORY_MT_CONTINUOUS;
+
+      cudaStream_t stream;
+      EXPECT_EQ(cudaStreamCreate(&stream), cudaSuccess);
+
+      wholememory_handle_t csr_row_ptr_memory_handle;
+      wholememory_handle_t csr_col_ptr_memory_handle;
+      EXPECT_EQ(wholememory_malloc(&csr_row_ptr_memory_handle,
+                                   wholememory_get_memory_size_from_array(&csr_row_ptr_desc),
+                                   wm_comm,
+                                   params.memory_type,
+                                   params.memory_location,
+                                   wholememory_dtype_get_element_size(csr_row_ptr_desc.dtype)),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_malloc(&csr_col_ptr_memory_handle,
+                                   wholememory_get_memory_size_from_array(&csr_col_ptr_desc),
+                                   wm_comm,
+                                   params.memory_type,
+                                   params.memory_location,
+                                   wholememory_dtype_get_element_size(csr_col_ptr_desc.dtype)),
+                WHOLEMEMORY_SUCCESS);
+      wholegraph_ops::testing::copy_host_array_to_wholememory(
+        host_csr_row_ptr, csr_row_ptr_memory_handle, csr_row_ptr_desc, stream);
+      wholegraph_ops::testing::copy_host_array_to_wholememory(
+        host_csr_col_ptr, csr_col_ptr_memory_handle, csr_col_ptr_desc, stream);
+
+      std::vector<int> host_center_nodes(center_node_desc.size);
+      wholegraph_ops::testing::host_random_init_array(
+        host_center_nodes.data(), center_node_desc, 0, params.graph_node_count - 1);
+      void* center_nodes = host_center_nodes.data();
+      if (!use_host) {
+        EXPECT_EQ(cudaMalloc(&center_nodes, host_center_nodes.size() * sizeof(int)), cudaSuccess);
+        EXPECT_EQ(cudaMemcpy(center_nodes,
+                             host_center_nodes.data(),
+                             host_center_nodes.size() * sizeof(int),
+                             cudaMemcpyHostToDevice),
+                  cudaSuccess);
+      }
+
+      wholememory_tensor_t wm_csr_row_ptr_tensor, wm_csr_col_ptr_tensor, center_nodes_tensor;
+      wholememory_tensor_description_t wm_csr_row_ptr_tensor_desc, wm_csr_col_ptr_tensor_desc,
+        center_nodes_tensor_desc;
+      wholememory_copy_array_desc_to_tensor(&wm_csr_row_ptr_tensor_desc, &csr_row_ptr_desc);
+      wholememory_copy_array_desc_to_tensor(&wm_csr_col_ptr_tensor_desc, &csr_col_ptr_desc);
+      wholememory_copy_array_desc_to_tensor(&center_nodes_tensor_desc, &center_node_desc);
+      EXPECT_EQ(wholememory_make_tensor_from_handle(
+                  &wm_csr_row_ptr_tensor, csr_row_ptr_memory_handle, &wm_csr_row_ptr_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_make_tensor_from_handle(
+                  &wm_csr_col_ptr_tensor, csr_col_ptr_memory_handle, &wm_csr_col_ptr_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_make_tensor_from_pointer(
+                  &center_nodes_tensor, center_nodes, &center_nodes_tensor_desc),
+                WHOLEMEMORY_SUCCESS);
+
+      wholememory_env_func_t* default_env_func = wholememory::get_default_env_func();
+      std::vector<wholememory::default_memory_context_t> target_nodes_ctx(hop_count),
+        csr_row_ptr_ctx(hop_count), edge_indice_ctx(hop_count);
+      std::vector<void*> target_nodes_ctx_ptr(hop_count), csr_row_ptr_ctx_ptr(hop_count),
+        edge_indice_ctx_ptr(hop_count);
+      for (int hop = 0; hop < hop_count; hop++) {
+        target_nodes_ctx_ptr[hop] = &target_nodes_ctx[hop];
+        csr_row_ptr_ctx_ptr[hop]  = &csr_row_ptr_ctx[hop];
+        edge_indice_ctx_ptr[hop]  = &edge_indice_ctx[hop];
+      }
+
+      EXPECT_EQ(wholegraph_csr_unweighted_multilayer_sample_without_replacement(
+                  wm_csr_row_ptr_tensor,
+                  wm_csr_col_ptr_tensor,
+                  center_nodes_tensor,
+                  params.max_sample_counts.data(),
+                  hop_count,
+                  target_nodes_ctx_ptr.data(),
+                  csr_row_ptr_ctx_ptr.data(),
+                  edge_indice_ctx_ptr.data(),
+                  random_seed,
+                  default_env_func,
+                  stream),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+
+      // each hop should be same as single hop sampling with seed of the hop.
+      std::vector<int> hop_center_nodes = host_center_nodes;
+      for (int hop = 0; hop < hop_count; hop++) {
+        auto expected_allocation_type = use_host ? WHOLEMEMORY_MA_HOST : WHOLEMEMORY_MA_DEVICE;
+        EXPECT_EQ(target_nodes_ctx[hop].allocation_type, expected_allocation_type);
+        EXPECT_EQ(edge_indice_ctx[hop].allocation_type, expected_allocation_type);
+        EXPECT_EQ(edge_indice_ctx[hop].desc.dim, 2);
+        EXPECT_EQ(edge_indice_ctx[hop].desc.sizes[0], 2);
+
+        auto hop_center_node_desc =
+          wholememory_create_array_desc(hop_center_nodes.size(), 0, WHOLEMEMORY_DT_INT);
+        auto sample_offset_desc =
+          wholememory_create_array_desc(hop_center_nodes.size() + 1, 0, WHOLEMEMORY_DT_INT);
+        void *ref_sample_offset, *ref_dest_nodes, *ref_center_local_id, *ref_edge_gid;
+        int ref_sample_count;
+        wholegraph_ops::testing::wholegraph_csr_unweighted_sample_without_replacement_cpu(
+          host_csr_row_ptr,
+          csr_row_ptr_desc,
+          host_csr_col_ptr,
+          csr_col_ptr_desc,
+          hop_center_nodes.data(),
+          hop_center_node_desc,
+          params.max_sample_counts[hop],
+          &ref_sample_offset,
+          sample_offset_desc,
+          &ref_dest_nodes,
+          &ref_center_local_id,
+          &ref_edge_gid,
+          &ref_sample_count,
+          random_seed + hop);
+
+        auto target_nodes = copy_int_output_to_host(target_nodes_ctx[hop]);
+        auto csr_row_ptr  = copy_int_output_to_host(csr_row_ptr_ctx[hop]);
+        auto edge_indice  = copy_int_output_to_host(edge_indice_ctx[hop]);
+        EXPECT_EQ(edge_indice_ctx[hop].desc.sizes[1], ref_sample_count);
+        wholegraph_ops::testing::host_check_two_array_same(
+          csr_row_ptr.data(), sample_offset_desc, ref_sample_offset, sample_offset_desc);
+        auto sample_desc = wholememory_create_array_desc(ref_sample_count, 0, WHOLEMEMORY_DT_INT);
+        wholegraph_ops::testing::host_check_two_array_same(
+          edge_indice.data() + ref_sample_count, sample_desc, ref_center_local_id, sample_desc);
+
+        // target nodes are center nodes followed by unique sampled nodes.
+        EXPECT_GE(target_nodes.size(), hop_center_nodes.size());
+        EXPECT_TRUE(
+          std::equal(hop_center_nodes.begin(), hop_center_nodes.end(), target_nodes.begin()));
+        std::set<int> unique_nodes(target_nodes.begin(), target_nodes.end());
+        std::set<int> center_node_set(hop_center_nodes.begin(), hop_center_nodes.end());
+        EXPECT_EQ(unique_nodes.size() - center_node_set.size(),
+                  target_nodes.size() - hop_center_nodes.size());
+        for (int i = 0; i < ref_sample_count; i++) {
+          int unique_id = edge_indice[i];
+          EXPECT_TRUE(unique_id >= 0 && unique_id < static_cast<int>(target_nodes.size()));
+          if (unique_id < 0 || unique_id >= static_cast<int>(target_nodes.size())) break;
+          EXPECT_EQ(target_nodes[unique_id], static_cast<int*>(ref_dest_nodes)[i]);
+        }
+        hop_center_nodes = target_nodes;
+
+        free(ref_sample_offset);
+        free(ref_dest_nodes);
+        free(ref_center_local_id);
+        free(ref_edge_gid);
+        (default_env_func->output_fns).free_fn(&target_nodes_ctx[hop], nullptr);
+        (default_env_func->output_fns).free_fn(&csr_row_ptr_ctx[hop], nullptr);
+        (default_env_func->output_fns).free_fn(&edge_indice_ctx[hop], nullptr);
+      }
+
+      EXPECT_EQ(wholememory_destroy_tensor(wm_csr_row_ptr_tensor), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_destroy_tensor(wm_csr_col_ptr_tensor), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_destroy_tensor(center_nodes_tensor), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_free(csr_row_ptr_memory_handle), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_free(csr_col_ptr_memory_handle), WHOLEMEMORY_SUCCESS);
+      if (!use_host) { EXPECT_EQ(cudaFree(center_nodes), cudaSuccess); }
+      EXPECT_EQ(cudaStreamDestroy(stream), cudaSuccess);
+      EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+      WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+    },
+    true);
+
+  free(host_csr_row_ptr);
+  free(host_csr_col_ptr);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+  WholeGraphCSRUnweightedMultilayerSampleOpTests,
+  WholeGraphCSRUnweightedMultilayerSampleParameterTests,
+  ::testing::Values(
+    WholeGraphCSRUnweightedMultilayerSampleTestParam(),
+    WholeGraphCSRUnweightedMultilayerSampleTestParam().set_memory_type(WHOLEMEMORY_MT_CHUNKED),
+    WholeGraphCSRUnweightedMultilayerSampleTestParam().set_memory_location(WHOLEMEMORY_ML_HOST),
+    WholeGraphCSRUnweightedMultilayerSampleTestParam()
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_max_sample_counts({40, 25, -1}),
+    WholeGraphCSRUnweightedMultilayerSampleTestParam().set_max_sample_counts({-1, 100})));
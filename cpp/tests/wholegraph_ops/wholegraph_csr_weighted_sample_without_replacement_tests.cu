@@ -102,9 +102,16 @@ typedef struct WholeGraphCSRWeightedSampleWithoutReplacementTestParam {
     center_node_dtype = new_center_node_dtype;
     return *this;
   }
+  WholeGraphCSRWeightedSampleWithoutReplacementTestParam& set_use_host_center_nodes(
+    bool new_use_host_center_nodes)
+  {
+    use_host_center_nodes = new_use_host_center_nodes;
+    return *this;
+  }
 
   wholememory_memory_type_t memory_type                 = WHOLEMEMORY_MT_CHUNKED;
   wholememory_memory_location_t memory_location         = WHOLEMEMORY_ML_DEVICE;
+  bool use_host_center_nodes                            = false;
   int64_t max_sample_count                              = 10;
   int64_t center_node_count                             = 512;
   int64_t graph_node_count                              = 9703LL;
@@ -273,10 +280,14 @@ TEST_P(WholeGraphCSRWeightedSampleWithoutReplacementParameterTests, WeightedSamp
       wholememory_copy_array_desc_to_tensor(&output_sample_offset_tensor_desc,
                                             &output_sample_offset_desc);
       EXPECT_EQ(wholememory_make_tensor_from_pointer(
-                  &center_nodes_tensor, dev_center_nodes, &center_nodes_tensor_desc),
+                  &center_nodes_tensor,
+                  params.use_host_center_nodes ? host_center_nodes : dev_center_nodes,
+                  &center_nodes_tensor_desc),
                 WHOLEMEMORY_SUCCESS);
       EXPECT_EQ(wholememory_make_tensor_from_pointer(&output_sample_offset_tensor,
-                                                     dev_output_sample_offset,
+                                                     params.use_host_center_nodes
+                                                       ? host_output_sample_offset
+                                                       : dev_output_sample_offset,
                                                      &output_sample_offset_tensor_desc),
                 WHOLEMEMORY_SUCCESS);
 
@@ -309,6 +320,11 @@ TEST_P(WholeGraphCSRWeightedSampleWithoutReplacementParameterTests, WeightedSamp
       EXPECT_EQ(output_dest_mem_ctx.desc.dtype, csr_col_ptr_desc.dtype);
       EXPECT_EQ(output_center_localid_mem_ctx.desc.dtype, WHOLEMEMORY_DT_INT);
       EXPECT_EQ(output_edge_gid_mem_ctx.desc.dtype, WHOLEMEMORY_DT_INT64);
+      if (params.use_host_center_nodes && params.memory_type == WHOLEMEMORY_MT_CONTINUOUS &&
+          params.memory_location == WHOLEMEMORY_ML_HOST) {
+        // host graph and host center nodes are sampled on host.
+        EXPECT_EQ(output_dest_mem_ctx.allocation_type, WHOLEMEMORY_MA_HOST);
+      }
 
       EXPECT_EQ(output_dest_mem_ctx.desc.sizes[0], output_center_localid_mem_ctx.desc.sizes[0]);
       EXPECT_EQ(output_dest_mem_ctx.desc.sizes[0], output_edge_gid_mem_ctx.desc.sizes[0]);
@@ -320,29 +336,32 @@ TEST_P(WholeGraphCSRWeightedSampleWithoutReplacementParameterTests, WeightedSamp
       host_output_center_nodes_local_id = malloc(total_sample_count * sizeof(int));
       host_output_global_edge_id        = malloc(total_sample_count * sizeof(int64_t));
 
-      EXPECT_EQ(cudaMemcpyAsync(host_output_sample_offset,
-                                dev_output_sample_offset,
-                                output_sample_offset_size,
-                                cudaMemcpyDeviceToHost,
-                                stream),
-                cudaSuccess);
+      // host sampling outputs are host memory, so copy with cudaMemcpyDefault.
+      if (!params.use_host_center_nodes) {
+        EXPECT_EQ(cudaMemcpyAsync(host_output_sample_offset,
+                                  dev_output_sample_offset,
+                                  output_sample_offset_size,
+                                  cudaMemcpyDeviceToHost,
+                                  stream),
+                  cudaSuccess);
+      }
       EXPECT_EQ(cudaMemcpyAsync(
                   host_output_dest_nodes,
                   output_dest_mem_ctx.ptr,
                   total_sample_count * wholememory_dtype_get_element_size(csr_col_ptr_desc.dtype),
-                  cudaMemcpyDeviceToHost,
+                  cudaMemcpyDefault,
                   stream),
                 cudaSuccess);
       EXPECT_EQ(cudaMemcpyAsync(host_output_center_nodes_local_id,
                                 output_center_localid_mem_ctx.ptr,
                                 total_sample_count * sizeof(int),
-                                cudaMemcpyDeviceToHost,
+                                cudaMemcpyDefault,
                                 stream),
                 cudaSuccess);
       EXPECT_EQ(cudaMemcpyAsync(host_output_global_edge_id,
                                 output_edge_gid_mem_ctx.ptr,
                                 total_sample_count * sizeof(int64_t),
-                                cudaMemcpyDeviceToHost,
+                                cudaMemcpyDefault,
                                 stream),
                 cudaSuccess);
 
@@ -463,4 +482,21 @@ INSTANTIATE_TEST_SUITE_P(WholeGraphCSRWeightedSampleWithoutReplacementOpTests,
                                              .set_graph_edge_couont(68940300),
                                            WholeGraphCSRWeightedSampleWithoutReplacementTestParam()
                                              .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
-                                             .set_center_node_type(WHOLEMEMORY_DT_INT64)));
+                                             .set_center_node_type(WHOLEMEMORY_DT_INT64),
+                                           WholeGraphCSRWeightedSampleWithoutReplacementTestParam()
+                                             .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+                                             .set_memory_location(WHOLEMEMORY_ML_HOST)
+                                             .set_use_host_center_nodes(true),
+                                           WholeGraphCSRWeightedSampleWithoutReplacementTestParam()
+                                             .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+                                             .set_memory_location(WHOLEMEMORY_ML_HOST)
+                                             .set_max_sample_count(300)
+                                             .set_center_node_count(256)
+                                             .set_graph_node_count(2320)
+                                             .set_graph_edge_couont(1000000)
+                                             .set_use_host_center_nodes(true),
+                                           WholeGraphCSRWeightedSampleWithoutReplacementTestParam()
+                                             .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+                                             .set_memory_location(WHOLEMEMORY_ML_HOST)
+                                             .set_center_node_type(WHOLEMEMORY_DT_INT64)
+                                             .set_use_host_center_nodes(true)));
@@ -17,6 +17,7 @@
 
 #include "parallel_utils.hpp"
 #include "wholememory/communicator.hpp"
+#include "wholememory/shm_comms.hpp"
 
 #include "wholememory_test_utils.hpp"
 
@@ -88,3 +89,160 @@ TEST(WholeMemoryCommTest, MultipleCreateDestroyCommunicator)
     WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
   });
 }
+
+TEST(WholeMemoryCommTest, HostOnlyCommunicatorFunctions)
+{
+  // host only communicator needs no CUDA device.
+  int nproc = 4;
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, nproc);
+  MultiProcessRun(nproc, [&pipes](int rank, int world_size) {
+    wholememory_comm_t wm_comm =
+      create_communicator_by_pipes(pipes, rank, world_size, WHOLEMEMORY_CB_HOST);
+    EXPECT_EQ(wholememory::communicator_get_backend(wm_comm), WHOLEMEMORY_CB_HOST);
+    EXPECT_EQ(wholememory::is_host_only_communicator(wm_comm), true);
+    EXPECT_EQ(wholememory::is_intranode_communicator(wm_comm), true);
+    int comm_rank = -1;
+    EXPECT_EQ(wholememory::communicator_get_rank(&comm_rank, wm_comm), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(comm_rank, rank);
+    EXPECT_EQ(wholememory::communicator_support_type_location(
+                wm_comm, WHOLEMEMORY_MT_CHUNKED, WHOLEMEMORY_ML_HOST),
+              WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory::communicator_support_type_location(
+                wm_comm, WHOLEMEMORY_MT_DISTRIBUTED, WHOLEMEMORY_ML_DEVICE),
+              WHOLEMEMORY_NOT_SUPPORTED);
+    wholememory::communicator_barrier(wm_comm);
+
+    std::vector<int64_t> values(1001), sum(1001);
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = rank * 1000 + i;
+    }
+    wm_comm->host_allreduce(
+      values.data(), sum.data(), values.size(), WHOLEMEMORY_DT_INT64, ncclSum);
+    for (size_t i = 0; i < sum.size(); i++) {
+      int64_t expected_sum = world_size * (world_size - 1) / 2 * 1000 + world_size * i;
+      EXPECT_EQ(sum[i], expected_sum);
+    }
+
+    // rank r sends r + 1 elements of value r * world_size + dst to each dst
+    std::vector<size_t> send_counts(world_size), send_displs(world_size);
+    std::vector<size_t> recv_counts(world_size), recv_displs(world_size);
+    for (int r = 0; r < world_size; r++) {
+      send_counts[r] = rank + 1;
+      send_displs[r] = r * (rank + 1);
+      recv_counts[r] = r + 1;
+      recv_displs[r] = r * (r + 1) / 2;
+    }
+    std::vector<int> send_data(world_size * (rank + 1));
+    std::vector<int> recv_data(world_size * (world_size + 1) / 2, -1);
+    for (int r = 0; r < world_size; r++) {
+      for (int i = 0; i < rank + 1; i++) {
+        send_data[send_displs[r] + i] = rank * world_size + r;
+      }
+    }
+    wm_comm->host_alltoallv(send_data.data(),
+                            recv_data.data(),
+                            send_counts.data(),
+                            send_displs.data(),
+                            recv_counts.data(),
+                            recv_displs.data(),
+                            WHOLEMEMORY_DT_INT);
+    for (int r = 0; r < world_size; r++) {
+      for (int i = 0; i < r + 1; i++) {
+        EXPECT_EQ(recv_data[recv_displs[r] + i], r * world_size + rank);
+      }
+    }
+    EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+
+    WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+  });
+}
+
+TEST(WholeMemoryCommTest, SharedMemoryHostCollectives)
+{
+  int nproc = 4;
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, nproc);
+  MultiProcessRun(nproc, [&pipes](int rank, int world_size) {
+    wholememory_comm_t wm_comm =
+      create_communicator_by_pipes(pipes, rank, world_size, WHOLEMEMORY_CB_HOST);
+    EXPECT_NE(wm_comm->shm_comm, nullptr);
+
+    // larger than one shared memory slot, so chunks are pipelined through both slots.
+    size_t count = 3 * wholememory::shm_comms::SLOT_SIZE / sizeof(float) + 17;
+    std::vector<float> values(count), sum(count);
+    for (size_t i = 0; i < count; i++) {
+      values[i] = static_cast<float>(rank + i % 11);
+    }
+    wm_comm->host_allreduce(values.data(), sum.data(), count, WHOLEMEMORY_DT_FLOAT, ncclSum);
+    for (size_t i = 0; i < count; i++) {
+      float expected_sum = static_cast<float>(world_size * (world_size - 1) / 2) +
+                           static_cast<float>(world_size * (i % 11));
+      EXPECT_EQ(sum[i], expected_sum);
+    }
+
+    std::vector<int64_t> bcast_data(count, rank);
+    wm_comm->host_bcast(bcast_data.data(), count, WHOLEMEMORY_DT_INT64, world_size - 1);
+    for (size_t i = 0; i < count; i++) {
+      EXPECT_EQ(bcast_data[i], world_size - 1);
+    }
+
+    // rank r contributes r * count / 2 elements of value r
+    std::vector<size_t> recv_counts(world_size), displs(world_size);
+    size_t total_count = 0;
+    for (int r = 0; r < world_size; r++) {
+      recv_counts[r] = r * count / 2;
+      displs[r]      = total_count;
+      total_count += recv_counts[r];
+    }
+    std::vector<int> send_data(recv_counts[rank], rank), recv_data(total_count, -1);
+    wm_comm->host_allgatherv(
+      send_data.data(), recv_data.data(), recv_counts.data(), displs.data(), WHOLEMEMORY_DT_INT);
+    for (int r = 0; r < world_size; r++) {
+      for (size_t i = 0; i < recv_counts[r]; i++) {
+        EXPECT_EQ(recv_data[displs[r] + i], r);
+      }
+    }
+
+    // falls back to socket collectives if shared memory host collectives are disabled.
+    setenv("WHOLEMEMORY_DISABLE_SHM_HOST_COLL", "1", 1);
+    wholememory_comm_t socket_comm =
+      create_communicator_by_pipes(pipes, rank, world_size, WHOLEMEMORY_CB_HOST);
+    unsetenv("WHOLEMEMORY_DISABLE_SHM_HOST_COLL");
+    EXPECT_EQ(socket_comm->shm_comm, nullptr);
+    std::vector<float> socket_sum(count);
+    socket_comm->host_allreduce(
+      values.data(), socket_sum.data(), count, WHOLEMEMORY_DT_FLOAT, ncclSum);
+    EXPECT_EQ(socket_sum, sum);
+    EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+
+    WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+  });
+  ClosePipes(&pipes);
+}
+
+TEST(WholeMemoryCommTest, SharedMemoryHostCollectivesTimeout)
+{
+  int nproc = 2;
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, nproc);
+  MultiProcessRun(nproc, [&pipes](int rank, int world_size) {
+    setenv("WHOLEMEMORY_SHM_HOST_COLL_TIMEOUT", "1", 1);
+    wholememory_comm_t wm_comm =
+      create_communicator_by_pipes(pipes, rank, world_size, WHOLEMEMORY_CB_HOST);
+    EXPECT_NE(wm_comm->shm_comm, nullptr);
+
+    // rank 0 has posted its step before timing out, so the late barrier of rank 1 still matches.
+    if (rank == 0) {
+      EXPECT_THROW(wm_comm->shm_comm->barrier(), wholememory::logic_error);
+    } else {
+      sleep(3);
+      wm_comm->shm_comm->barrier();
+    }
+    EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+    unsetenv("WHOLEMEMORY_SHM_HOST_COLL_TIMEOUT");
+
+    WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+  });
+  ClosePipes(&pipes);
+}
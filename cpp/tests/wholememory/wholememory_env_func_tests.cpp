@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <cuda_runtime_api.h>
+
+#include <initializer_list>
+
+#include "wholememory/env_func_ptrs.hpp"
+#include "wholememory_ops/temp_memory_handle.hpp"
+
+TEST(WholeMemoryEnvFuncTest, CachedHostMemory)
+{
+  // host memory needs no CUDA device.
+  wholememory::drop_cached_env_func_cache();
+  wholememory::reset_cached_env_func_peak_stats();
+  auto stats = wholememory::get_cached_env_func_stats(WHOLEMEMORY_MA_HOST);
+  EXPECT_EQ(stats.cached_bytes, 0);
+  int64_t malloc_count    = stats.malloc_count;
+  int64_t cache_hit_count = stats.cache_hit_count;
+
+  void* first_ptr = nullptr;
+  {
+    wholememory_ops::temp_memory_handle tmh(wholememory::get_default_env_func());
+    first_ptr = tmh.host_malloc(1000, WHOLEMEMORY_DT_INT8);
+    EXPECT_NE(first_ptr, nullptr);
+    stats = wholememory::get_cached_env_func_stats(WHOLEMEMORY_MA_HOST);
+    // rounded up to size class of 1024 bytes.
+    EXPECT_EQ(stats.allocated_bytes, 1024);
+    EXPECT_EQ(stats.malloc_count, malloc_count + 1);
+  }
+  stats = wholememory::get_cached_env_func_stats(WHOLEMEMORY_MA_HOST);
+  EXPECT_EQ(stats.allocated_bytes, 0);
+  EXPECT_EQ(stats.cached_bytes, 1024);
+
+  {
+    // same size class reuses cached block, other size class allocates new block.
+    wholememory_ops::temp_memory_handle tmh1(wholememory::get_default_env_func());
+    wholememory_ops::temp_memory_handle tmh2(wholememory::get_cached_env_func());
+    EXPECT_EQ(tmh1.host_malloc(256, WHOLEMEMORY_DT_FLOAT), first_ptr);
+    void* ptr2 = tmh2.host_malloc(1025, WHOLEMEMORY_DT_INT8);
+    EXPECT_NE(ptr2, first_ptr);
+    stats = wholememory::get_cached_env_func_stats(WHOLEMEMORY_MA_HOST);
+    EXPECT_EQ(stats.allocated_bytes, 1024 + 1280);
+    EXPECT_EQ(stats.cached_bytes, 0);
+    EXPECT_EQ(stats.cache_hit_count, cache_hit_count + 1);
+  }
+  stats = wholememory::get_cached_env_func_stats(WHOLEMEMORY_MA_HOST);
+  EXPECT_EQ(stats.cached_bytes, 1024 + 1280);
+  EXPECT_EQ(stats.peak_allocated_bytes, 1024 + 1280);
+  EXPECT_EQ(stats.peak_reserved_bytes, 1024 + 1280);
+
+  // larger blocks are trimmed first.
+  wholememory::trim_cached_env_func_cache(1024);
+  stats = wholememory::get_cached_env_func_stats(WHOLEMEMORY_MA_HOST);
+  EXPECT_EQ(stats.cached_bytes, 1024);
+  wholememory::reset_cached_env_func_peak_stats();
+  stats = wholememory::get_cached_env_func_stats(WHOLEMEMORY_MA_HOST);
+  EXPECT_EQ(stats.peak_allocated_bytes, 0);
+  EXPECT_EQ(stats.peak_reserved_bytes, 1024);
+  wholememory::drop_cached_env_func_cache();
+  stats = wholememory::get_cached_env_func_stats(WHOLEMEMORY_MA_HOST);
+  EXPECT_EQ(stats.cached_bytes, 0);
+}
+
+TEST(WholeMemoryEnvFuncTest, CachedDeviceMemoryPerStream)
+{
+  int dev_count = 0;
+  if (cudaGetDeviceCount(&dev_count) != cudaSuccess || dev_count == 0) {
+    GTEST_SKIP_("Skip due to no CUDA device.");
+  }
+  EXPECT_EQ(cudaSetDevice(0), cudaSuccess);
+  wholememory::drop_cached_env_func_cache();
+  cudaStream_t stream1, stream2;
+  EXPECT_EQ(cudaStreamCreate(&stream1), cudaSuccess);
+  EXPECT_EQ(cudaStreamCreate(&stream2), cudaSuccess);
+  for (auto type : {WHOLEMEMORY_MA_DEVICE, WHOLEMEMORY_MA_PINNED}) {
+    void* stream1_ptr = nullptr;
+    {
+      wholememory::temp_memory_stream_guard stream_guard(stream1);
+      wholememory_ops::temp_memory_handle tmh(wholememory::get_default_env_func());
+      stream1_ptr = type == WHOLEMEMORY_MA_DEVICE ? tmh.device_malloc(4096, WHOLEMEMORY_DT_INT)
+                                                  : tmh.pinned_malloc(4096, WHOLEMEMORY_DT_INT);
+    }
+    {
+      // block freed on stream1 is not reused by stream2.
+      wholememory::temp_memory_stream_guard stream_guard(stream2);
+      wholememory_ops::temp_memory_handle tmh(wholememory::get_default_env_func());
+      void* ptr = type == WHOLEMEMORY_MA_DEVICE ? tmh.device_malloc(4096, WHOLEMEMORY_DT_INT)
+                                                : tmh.pinned_malloc(4096, WHOLEMEMORY_DT_INT);
+      EXPECT_NE(ptr, stream1_ptr);
+    }
+    {
+      wholememory::temp_memory_stream_guard stream_guard(stream1);
+      wholememory_ops::temp_memory_handle tmh(wholememory::get_default_env_func());
+      void* ptr = type == WHOLEMEMORY_MA_DEVICE ? tmh.device_malloc(4096, WHOLEMEMORY_DT_INT)
+                                                : tmh.pinned_malloc(4096, WHOLEMEMORY_DT_INT);
+      EXPECT_EQ(ptr, stream1_ptr);
+    }
+    auto stats = wholememory::get_cached_env_func_stats(type);
+    EXPECT_EQ(stats.cached_bytes, 2 * 4096 * sizeof(int));
+  }
+  wholememory::drop_cached_env_func_cache();
+  EXPECT_EQ(cudaStreamDestroy(stream1), cudaSuccess);
+  EXPECT_EQ(cudaStreamDestroy(stream2), cudaSuccess);
+}
+
+TEST(WholeMemoryEnvFuncTest, CachedDeviceMemoryNeedsStreamGuard)
+{
+  int dev_count = 0;
+  if (cudaGetDeviceCount(&dev_count) != cudaSuccess || dev_count == 0) {
+    GTEST_SKIP_("Skip due to no CUDA device.");
+  }
+  EXPECT_EQ(cudaSetDevice(0), cudaSuccess);
+  {
+    // default stream is a valid stream of guard.
+    wholememory::temp_memory_stream_guard stream_guard(nullptr);
+    wholememory_ops::temp_memory_handle tmh(wholememory::get_default_env_func());
+    EXPECT_NE(tmh.device_malloc(16, WHOLEMEMORY_DT_INT), nullptr);
+  }
+  // blocks allocated out of guard can't tell which stream they may be reused on.
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  EXPECT_DEATH(
+    {
+      wholememory_ops::temp_memory_handle tmh(wholememory::get_default_env_func());
+      tmh.device_malloc(16, WHOLEMEMORY_DT_INT);
+    },
+    "stream guard");
+  wholememory::drop_cached_env_func_cache();
+}
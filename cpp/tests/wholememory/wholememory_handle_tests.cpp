@@ -15,10 +15,20 @@
  */
 #include <gtest/gtest.h>
 
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <thread>
+
 #include "parallel_utils.hpp"
 #include "wholememory/communicator.hpp"
 #include "wholememory/initialize.hpp"
 #include "wholememory/memory_handle.hpp"
+#include "wholememory/system_info.hpp"
 
 #include "wholememory_test_utils.hpp"
 
@@ -204,3 +214,624 @@ INSTANTIATE_TEST_SUITE_P(
                     std::make_tuple(WHOLEMEMORY_MT_DISTRIBUTED, WHOLEMEMORY_ML_HOST),
                     std::make_tuple(WHOLEMEMORY_MT_DISTRIBUTED, WHOLEMEMORY_ML_DEVICE)));
 #endif
+
+TEST(WholeMemoryHandleTests, FileMappedCreateDestroyTest)
+{
+  int dev_count = ForkGetDeviceCount();
+  EXPECT_GE(dev_count, 1);
+  WHOLEMEMORY_CHECK(dev_count >= 1);
+  int nproc = dev_count;
+
+  // first file size should be multiple of page size, last file can be any size.
+  size_t page_size = sysconf(_SC_PAGESIZE);
+  std::vector<size_t> file_entry_counts{page_size * 64 / sizeof(int64_t), 12345};
+  std::vector<std::string> file_names;
+  int64_t value = 0;
+  for (size_t i = 0; i < file_entry_counts.size(); i++) {
+    std::string file_name = "wholememory_file_mapped_test_part_" + std::to_string(i);
+    std::vector<int64_t> data(file_entry_counts[i]);
+    for (auto& v : data)
+      v = value++;
+    FILE* fp = fopen(file_name.c_str(), "wb");
+    WHOLEMEMORY_CHECK(fp != nullptr);
+    WHOLEMEMORY_CHECK(fwrite(data.data(), sizeof(int64_t), data.size(), fp) == data.size());
+    WHOLEMEMORY_CHECK(fclose(fp) == 0);
+    file_names.push_back(file_name);
+  }
+  size_t total_entry_count = value;
+
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, dev_count);
+  MultiProcessRun(
+    nproc,
+    [&pipes, &file_names, total_entry_count](int rank, int world_size) {
+      EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
+
+      EXPECT_EQ(cudaSetDevice(rank), cudaSuccess);
+
+      wholememory_comm_t wm_comm = create_communicator_by_pipes(pipes, rank, world_size);
+
+      EXPECT_EQ(wholememory_communicator_support_type_location(
+                  wm_comm, WHOLEMEMORY_MT_CONTINUOUS, WHOLEMEMORY_ML_FILE),
+                WHOLEMEMORY_SUCCESS);
+
+      std::vector<const char*> file_name_ptrs;
+      for (auto& file_name : file_names)
+        file_name_ptrs.push_back(file_name.c_str());
+
+      wholememory_handle_t handle;
+      EXPECT_EQ(wholememory::create_file_mapped_wholememory(&handle,
+                                                            wm_comm,
+                                                            WHOLEMEMORY_MT_CONTINUOUS,
+                                                            sizeof(int64_t),
+                                                            file_name_ptrs.data(),
+                                                            file_name_ptrs.size(),
+                                                            0),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory::get_memory_location(handle), WHOLEMEMORY_ML_FILE);
+      EXPECT_EQ(wholememory::get_total_size(handle), total_entry_count * sizeof(int64_t));
+
+      int64_t* local_ptr;
+      size_t local_size, local_offset;
+      EXPECT_EQ(wholememory::get_local_memory_from_handle(
+                  (void**)&local_ptr, &local_size, &local_offset, handle),
+                WHOLEMEMORY_SUCCESS);
+      for (size_t i = 0; i < local_size / sizeof(int64_t); i++) {
+        EXPECT_EQ(local_ptr[i], static_cast<int64_t>(local_offset / sizeof(int64_t) + i));
+      }
+
+      wholememory_gref_t gref;
+      EXPECT_EQ(wholememory::get_global_reference_from_handle(&gref, handle), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(static_cast<int64_t*>(gref.pointer) + local_offset / sizeof(int64_t), local_ptr);
+
+      EXPECT_EQ(wholememory::destroy_wholememory(handle), WHOLEMEMORY_SUCCESS);
+
+      // with write back, each rank negates its partition and changes go to files.
+      EXPECT_EQ(wholememory::create_file_mapped_wholememory(&handle,
+                                                            wm_comm,
+                                                            WHOLEMEMORY_MT_CONTINUOUS,
+                                                            sizeof(int64_t),
+                                                            file_name_ptrs.data(),
+                                                            file_name_ptrs.size(),
+                                                            WHOLEMEMORY_MF_FILE_WRITE_BACK),
+                WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory::get_local_memory_from_handle(
+                  (void**)&local_ptr, &local_size, &local_offset, handle),
+                WHOLEMEMORY_SUCCESS);
+      for (size_t i = 0; i < local_size / sizeof(int64_t); i++) {
+        local_ptr[i] = -local_ptr[i];
+      }
+      EXPECT_EQ(wholememory::destroy_wholememory(handle), WHOLEMEMORY_SUCCESS);
+
+      EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+
+      EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+
+      WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+    },
+    true);
+  ClosePipes(&pipes);
+  value = 0;
+  for (size_t i = 0; i < file_entry_counts.size(); i++) {
+    std::vector<int64_t> data(file_entry_counts[i]);
+    FILE* fp = fopen(file_names[i].c_str(), "rb");
+    WHOLEMEMORY_CHECK(fp != nullptr);
+    WHOLEMEMORY_CHECK(fread(data.data(), sizeof(int64_t), data.size(), fp) == data.size());
+    WHOLEMEMORY_CHECK(fclose(fp) == 0);
+    for (auto v : data) {
+      EXPECT_EQ(v, -(value++));
+    }
+  }
+  for (auto& file_name : file_names) {
+    EXPECT_EQ(unlink(file_name.c_str()), 0);
+  }
+}
+
+TEST(WholeMemoryHandleTests, HugePageHostCreateDestroyTest)
+{
+  int nproc = 4;
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, nproc);
+  MultiProcessRun(nproc, [&pipes](int rank, int world_size) {
+    EXPECT_EQ(wholememory_init(0x100), WHOLEMEMORY_LOGIC_ERROR);
+    // falls back to normal pages if huge page pool is not enough, so always succeeds.
+    EXPECT_EQ(wholememory_init(WHOLEMEMORY_INIT_HUGE_PAGE_2MB | WHOLEMEMORY_INIT_HUGE_PAGE_1GB),
+              WHOLEMEMORY_SUCCESS);
+
+    wholememory_comm_t wm_comm =
+      create_communicator_by_pipes(pipes, rank, world_size, WHOLEMEMORY_CB_HOST);
+
+    // not multiple of huge page size.
+    size_t total_size = 3 * 1024 * 1024 + 4096;
+    wholememory_handle_t handle;
+    EXPECT_EQ(wholememory::create_wholememory(&handle,
+                                              total_size,
+                                              wm_comm,
+                                              WHOLEMEMORY_MT_CONTINUOUS,
+                                              WHOLEMEMORY_ML_HOST,
+                                              sizeof(int64_t)),
+              WHOLEMEMORY_SUCCESS);
+
+    int64_t* local_ptr;
+    size_t local_size, local_offset;
+    EXPECT_EQ(wholememory::get_local_memory_from_handle(
+                (void**)&local_ptr, &local_size, &local_offset, handle),
+              WHOLEMEMORY_SUCCESS);
+    for (size_t i = 0; i < local_size / sizeof(int64_t); i++) {
+      local_ptr[i] = static_cast<int64_t>(local_offset / sizeof(int64_t) + i);
+    }
+    wholememory::communicator_barrier(wm_comm);
+    wholememory_gref_t gref;
+    EXPECT_EQ(wholememory::get_global_reference_from_handle(&gref, handle), WHOLEMEMORY_SUCCESS);
+    auto* global_ptr = static_cast<int64_t*>(gref.pointer);
+    for (size_t i = 0; i < total_size / sizeof(int64_t); i++) {
+      EXPECT_EQ(global_ptr[i], static_cast<int64_t>(i));
+    }
+    wholememory::communicator_barrier(wm_comm);
+
+    EXPECT_EQ(wholememory::destroy_wholememory(handle), WHOLEMEMORY_SUCCESS);
+
+    EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+
+    EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+
+    WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+  });
+  ClosePipes(&pipes);
+}
+
+// same as MPOL_F_NODE and MPOL_F_ADDR in numaif.h, which may not be installed.
+static constexpr int kMemPolicyFlagNode = 1;
+static constexpr int kMemPolicyFlagAddr = 2;
+
+static int get_page_numa_node(const void* ptr)
+{
+  int numa_node = -1;
+  if (syscall(SYS_get_mempolicy,
+              &numa_node,
+              nullptr,
+              0,
+              ptr,
+              kMemPolicyFlagNode | kMemPolicyFlagAddr) != 0) {
+    return -1;
+  }
+  return numa_node;
+}
+
+TEST(WholeMemoryHandleTests, HostNumaPolicyTest)
+{
+  bool multi_numa_node = GetOnlineNumaNodes().size() > 1;
+  int nproc            = 2;
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, nproc);
+  for (const char* policy : {"none", "local", "interleave"}) {
+    MultiProcessRun(nproc, [&pipes, policy, multi_numa_node](int rank, int world_size) {
+      // pin to current CPU, so local NUMA node doesn't change after allocation.
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      CPU_SET(sched_getcpu(), &cpu_set);
+      EXPECT_EQ(sched_setaffinity(0, sizeof(cpu_set), &cpu_set), 0);
+      EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
+      setenv("WHOLEMEMORY_HOST_NUMA_POLICY", policy, 1);
+
+      wholememory_comm_t wm_comm =
+        create_communicator_by_pipes(pipes, rank, world_size, WHOLEMEMORY_CB_HOST);
+
+      size_t total_size = 8 * 1024 * 1024 + 4096;
+      wholememory_handle_t handle;
+      EXPECT_EQ(wholememory::create_wholememory(&handle,
+                                                total_size,
+                                                wm_comm,
+                                                WHOLEMEMORY_MT_CONTINUOUS,
+                                                WHOLEMEMORY_ML_HOST,
+                                                sizeof(int64_t)),
+                WHOLEMEMORY_SUCCESS);
+
+      void* local_ptr;
+      size_t local_size, local_offset;
+      EXPECT_EQ(
+        wholememory::get_local_memory_from_handle(&local_ptr, &local_size, &local_offset, handle),
+        WHOLEMEMORY_SUCCESS);
+      // local partition is touched on creation, so all pages have NUMA node. Pages at partition
+      // boundaries may follow policy of neighbor ranks, only pages inside are checked.
+      size_t page_size  = sysconf(_SC_PAGESIZE);
+      size_t page_start = (local_offset + page_size - 1) / page_size * page_size;
+      size_t page_end   = (local_offset + local_size) / page_size * page_size;
+      size_t count      = page_end > page_start ? (page_end - page_start) / page_size : 0;
+      EXPECT_GT(count, 0);
+      std::vector<int> numa_nodes(count, -1);
+      EXPECT_EQ(wholememory_get_host_numa_nodes(
+                  numa_nodes.data(), page_start, page_size, count, handle),
+                WHOLEMEMORY_SUCCESS);
+      std::set<int> used_numa_nodes;
+      int local_numa_node = GetCurrentNumaNode();
+      for (size_t i = 0; i < count; i++) {
+        const char* page_ptr =
+          static_cast<const char*>(local_ptr) + (page_start - local_offset) + i * page_size;
+        EXPECT_GE(numa_nodes[i], 0);
+        EXPECT_EQ(numa_nodes[i], get_page_numa_node(page_ptr));
+        if (strcmp(policy, "local") == 0) { EXPECT_EQ(numa_nodes[i], local_numa_node); }
+        used_numa_nodes.insert(numa_nodes[i]);
+      }
+      if (strcmp(policy, "interleave") == 0 && multi_numa_node) {
+        EXPECT_GT(used_numa_nodes.size(), 1);
+      }
+      EXPECT_EQ(wholememory_get_host_numa_nodes(numa_nodes.data(), total_size, 1, 1, handle),
+                WHOLEMEMORY_INVALID_VALUE);
+
+      EXPECT_EQ(wholememory::destroy_wholememory(handle), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+      unsetenv("WHOLEMEMORY_HOST_NUMA_POLICY");
+
+      WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+    });
+  }
+  ClosePipes(&pipes);
+  if (!multi_numa_node) { GTEST_SKIP_("Skip interleave placement check due to single NUMA node."); }
+}
+
+TEST(WholeMemoryHandleTests, FillLocalMemoryTest)
+{
+  int nproc = 2;
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, nproc);
+  MultiProcessRun(nproc, [&pipes](int rank, int world_size) {
+    EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
+
+    wholememory_comm_t wm_comm =
+      create_communicator_by_pipes(pipes, rank, world_size, WHOLEMEMORY_CB_HOST);
+
+    size_t total_size = 48 * 1024 * 1024 + 4096;
+    wholememory_handle_t handle;
+    EXPECT_EQ(wholememory_malloc_with_flags(&handle,
+                                            total_size,
+                                            wm_comm,
+                                            WHOLEMEMORY_MT_CONTINUOUS,
+                                            WHOLEMEMORY_ML_HOST,
+                                            sizeof(float),
+                                            0x100),
+              WHOLEMEMORY_INVALID_VALUE);
+
+    // zero filled on creation.
+    EXPECT_EQ(wholememory_malloc_with_flags(&handle,
+                                            total_size,
+                                            wm_comm,
+                                            WHOLEMEMORY_MT_CONTINUOUS,
+                                            WHOLEMEMORY_ML_HOST,
+                                            sizeof(float),
+                                            0),
+              WHOLEMEMORY_SUCCESS);
+    void* local_ptr;
+    size_t local_size, local_offset;
+    EXPECT_EQ(
+      wholememory::get_local_memory_from_handle(&local_ptr, &local_size, &local_offset, handle),
+      WHOLEMEMORY_SUCCESS);
+    auto* local_bytes = static_cast<const char*>(local_ptr);
+    EXPECT_EQ(static_cast<size_t>(std::count(local_bytes, local_bytes + local_size, 0)),
+              local_size);
+    EXPECT_EQ(wholememory::destroy_wholememory(handle), WHOLEMEMORY_SUCCESS);
+
+    EXPECT_EQ(wholememory_malloc_with_flags(&handle,
+                                            total_size,
+                                            wm_comm,
+                                            WHOLEMEMORY_MT_CONTINUOUS,
+                                            WHOLEMEMORY_ML_HOST,
+                                            sizeof(float),
+                                            WHOLEMEMORY_MF_NO_ZERO_INIT),
+              WHOLEMEMORY_SUCCESS);
+    int64_t value64 = 1;
+    EXPECT_EQ(wholememory_fill_local_memory(&value64, sizeof(value64), handle),
+              WHOLEMEMORY_INVALID_VALUE);
+    float value = 0.5F + static_cast<float>(rank);
+    EXPECT_EQ(wholememory_fill_local_memory(&value, sizeof(value), handle), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_communicator_barrier(wm_comm), WHOLEMEMORY_SUCCESS);
+    for (int r = 0; r < world_size; r++) {
+      void* rank_ptr;
+      size_t rank_size, rank_offset;
+      EXPECT_EQ(
+        wholememory::get_rank_memory_from_handle(&rank_ptr, &rank_size, &rank_offset, r, handle),
+        WHOLEMEMORY_SUCCESS);
+      auto* rank_floats = static_cast<const float*>(rank_ptr);
+      float expected    = 0.5F + static_cast<float>(r);
+      EXPECT_EQ(static_cast<size_t>(
+                  std::count(rank_floats, rank_floats + rank_size / sizeof(float), expected)),
+                rank_size / sizeof(float));
+    }
+    EXPECT_EQ(wholememory_communicator_barrier(wm_comm), WHOLEMEMORY_SUCCESS);
+
+    int16_t value16 = 0x1234;
+    EXPECT_EQ(wholememory_fill_local_memory(&value16, sizeof(value16), handle),
+              WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory::get_local_memory_from_handle(&local_ptr, &local_size, nullptr, handle),
+              WHOLEMEMORY_SUCCESS);
+    auto* local_int16 = static_cast<const int16_t*>(local_ptr);
+    EXPECT_EQ(static_cast<size_t>(
+                std::count(local_int16, local_int16 + local_size / sizeof(int16_t), value16)),
+              local_size / sizeof(int16_t));
+
+    EXPECT_EQ(wholememory::destroy_wholememory(handle), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+
+    WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+  });
+  ClosePipes(&pipes);
+}
+
+TEST(WholeMemoryHandleTests, ConcurrentGetHandleTest)
+{
+  int nproc = 1;
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, nproc);
+  MultiProcessRun(nproc, [&pipes](int rank, int world_size) {
+    EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
+
+    wholememory_comm_t wm_comm =
+      create_communicator_by_pipes(pipes, rank, world_size, WHOLEMEMORY_CB_HOST);
+
+    size_t total_size = 4 * 1024 * 1024;
+    wholememory_handle_t handle;
+    EXPECT_EQ(wholememory_malloc(
+                &handle, total_size, wm_comm, WHOLEMEMORY_MT_CONTINUOUS, WHOLEMEMORY_ML_HOST, 4),
+              WHOLEMEMORY_SUCCESS);
+    void* global_ptr;
+    EXPECT_EQ(wholememory_get_global_pointer(&global_ptr, handle), WHOLEMEMORY_SUCCESS);
+    auto* global_bytes = static_cast<char*>(global_ptr);
+    char outside_byte;
+
+    // lookups of a stable handle race with creation and destruction of other handles.
+    std::atomic<bool> stop{false};
+    std::atomic<int64_t> mismatch_count{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+      readers.emplace_back([&, t] {
+        size_t offset = t;
+        while (!stop.load()) {
+          offset = (offset * 2654435761ULL + 1) % total_size;
+          if (wholememory::wholememory_get_handle(global_bytes + offset) != handle ||
+              wholememory::wholememory_get_handle(&outside_byte) != nullptr) {
+            mismatch_count.fetch_add(1);
+          }
+        }
+      });
+    }
+    for (int i = 0; i < 50; i++) {
+      wholememory_handle_t other_handle;
+      EXPECT_EQ(wholememory_malloc(&other_handle,
+                                   total_size,
+                                   wm_comm,
+                                   WHOLEMEMORY_MT_CONTINUOUS,
+                                   WHOLEMEMORY_ML_HOST,
+                                   4),
+                WHOLEMEMORY_SUCCESS);
+      void* other_ptr;
+      EXPECT_EQ(wholememory_get_global_pointer(&other_ptr, other_handle), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory::wholememory_get_handle(static_cast<char*>(other_ptr) + i),
+                other_handle);
+      EXPECT_EQ(wholememory::destroy_wholememory(other_handle), WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(wholememory::wholememory_get_handle(other_ptr), nullptr);
+    }
+    stop.store(true);
+    for (auto& reader : readers) {
+      reader.join();
+    }
+    EXPECT_EQ(mismatch_count.load(), 0);
+    EXPECT_EQ(wholememory::wholememory_get_handle(global_bytes + total_size), nullptr);
+
+    EXPECT_EQ(wholememory::destroy_wholememory(handle), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+
+    WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+  });
+  ClosePipes(&pipes);
+}
+
+TEST(WholeMemoryHandleTests, GrowableHostMemoryTest)
+{
+  int nproc = 2;
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, nproc);
+  MultiProcessRun(nproc, [&pipes](int rank, int world_size) {
+    EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
+
+    wholememory_comm_t wm_comm =
+      create_communicator_by_pipes(pipes, rank, world_size, WHOLEMEMORY_CB_HOST);
+
+    size_t max_entry_count = 1024 * 1024;
+    size_t entry_count     = 1000;
+    wholememory_handle_t handle;
+    EXPECT_EQ(wholememory_malloc_growable(&handle,
+                                          entry_count * sizeof(int64_t),
+                                          max_entry_count * sizeof(int64_t),
+                                          wm_comm,
+                                          WHOLEMEMORY_MT_CHUNKED,
+                                          WHOLEMEMORY_ML_HOST,
+                                          sizeof(int64_t),
+                                          0),
+              WHOLEMEMORY_NOT_SUPPORTED);
+    EXPECT_EQ(wholememory_malloc_growable(&handle,
+                                          entry_count * sizeof(int64_t),
+                                          max_entry_count * sizeof(int64_t),
+                                          wm_comm,
+                                          WHOLEMEMORY_MT_CONTINUOUS,
+                                          WHOLEMEMORY_ML_HOST,
+                                          sizeof(int64_t),
+                                          0),
+              WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_get_total_size(handle), entry_count * sizeof(int64_t));
+    EXPECT_EQ(wholememory_get_max_total_size(handle), max_entry_count * sizeof(int64_t));
+
+    // partition plan is for max size, so all entries are in rank 0 now.
+    size_t size_per_rank;
+    EXPECT_EQ(wholememory_get_partition_plan(&size_per_rank, handle), WHOLEMEMORY_SUCCESS);
+    size_t entry_per_rank = max_entry_count / world_size;
+    EXPECT_EQ(size_per_rank, entry_per_rank * sizeof(int64_t));
+    void* local_ptr;
+    size_t local_size, local_offset;
+    EXPECT_EQ(
+      wholememory::get_local_memory_from_handle(&local_ptr, &local_size, &local_offset, handle),
+      WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(local_size, rank == 0 ? entry_count * sizeof(int64_t) : 0);
+    auto* local_entries = static_cast<int64_t*>(local_ptr);
+    for (size_t i = 0; i < local_size / sizeof(int64_t); i++) {
+      EXPECT_EQ(local_entries[i], 0);
+      local_entries[i] = i;
+    }
+    void* global_ptr;
+    EXPECT_EQ(wholememory_get_global_pointer(&global_ptr, handle), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_communicator_barrier(wm_comm), WHOLEMEMORY_SUCCESS);
+
+    EXPECT_EQ(wholememory_grow(handle, (max_entry_count + 1) * sizeof(int64_t)),
+              WHOLEMEMORY_INVALID_VALUE);
+    EXPECT_EQ(wholememory_grow(handle, entry_count * sizeof(int64_t) + 1),
+              WHOLEMEMORY_INVALID_VALUE);
+    // not larger than current size, nothing changes.
+    EXPECT_EQ(wholememory_grow(handle, sizeof(int64_t)), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_get_total_size(handle), entry_count * sizeof(int64_t));
+
+    // grow in two steps, into partition of last rank.
+    size_t mid_entry_count = entry_per_rank / 2 + 3;
+    size_t new_entry_count = entry_per_rank * (world_size - 1) + 5;
+    EXPECT_EQ(wholememory_grow(handle, mid_entry_count * sizeof(int64_t)), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_grow(handle, new_entry_count * sizeof(int64_t)), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_get_total_size(handle), new_entry_count * sizeof(int64_t));
+
+    void* new_global_ptr;
+    EXPECT_EQ(wholememory_get_global_pointer(&new_global_ptr, handle), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(new_global_ptr, global_ptr);
+    EXPECT_EQ(wholememory_get_partition_plan(&size_per_rank, handle), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(size_per_rank, entry_per_rank * sizeof(int64_t));
+    auto* global_entries = static_cast<int64_t*>(global_ptr);
+    for (size_t i = 0; i < new_entry_count; i++) {
+      EXPECT_EQ(global_entries[i], i < entry_count ? static_cast<int64_t>(i) : 0);
+    }
+    EXPECT_EQ(wholememory::wholememory_get_handle(global_entries + new_entry_count - 1), handle);
+    EXPECT_EQ(wholememory::wholememory_get_handle(global_entries + new_entry_count), nullptr);
+
+    EXPECT_EQ(
+      wholememory::get_local_memory_from_handle(&local_ptr, &local_size, &local_offset, handle),
+      WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(local_offset, rank * entry_per_rank * sizeof(int64_t));
+    EXPECT_EQ(local_size, (rank == world_size - 1 ? 5 : entry_per_rank) * sizeof(int64_t));
+    EXPECT_EQ(local_ptr, static_cast<char*>(global_ptr) + local_offset);
+    int64_t value = rank + 1;
+    EXPECT_EQ(wholememory_fill_local_memory(&value, sizeof(value), handle), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_communicator_barrier(wm_comm), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(global_entries[new_entry_count - 1], world_size);
+
+    EXPECT_EQ(wholememory::destroy_wholememory(handle), WHOLEMEMORY_SUCCESS);
+
+    EXPECT_EQ(wholememory_malloc(&handle,
+                                 entry_count * sizeof(int64_t),
+                                 wm_comm,
+                                 WHOLEMEMORY_MT_CONTINUOUS,
+                                 WHOLEMEMORY_ML_HOST,
+                                 sizeof(int64_t)),
+              WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_get_max_total_size(handle), entry_count * sizeof(int64_t));
+    EXPECT_EQ(wholememory_grow(handle, 2 * entry_count * sizeof(int64_t)),
+              WHOLEMEMORY_INVALID_VALUE);
+    EXPECT_EQ(wholememory::destroy_wholememory(handle), WHOLEMEMORY_SUCCESS);
+
+    EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+
+    WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+  });
+  ClosePipes(&pipes);
+}
+
+TEST(WholeMemoryHandleTests, GrowableDeviceMemoryTest)
+{
+  int dev_count = ForkGetDeviceCount();
+  EXPECT_GE(dev_count, 1);
+  WHOLEMEMORY_CHECK(dev_count >= 1);
+  int nproc = dev_count;
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, nproc);
+  MultiProcessRun(nproc, [&pipes](int rank, int world_size) {
+    EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(cudaSetDevice(rank), cudaSuccess);
+
+    wholememory_comm_t wm_comm = create_communicator_by_pipes(pipes, rank, world_size);
+
+    size_t max_entry_count = 16 * 1024 * 1024;
+    wholememory_handle_t handle;
+    // pages follow partition of max size, growing too much leaves all data in first GPUs.
+    EXPECT_EQ(wholememory_malloc_growable(&handle,
+                                          1000 * sizeof(int),
+                                          max_entry_count * sizeof(int),
+                                          wm_comm,
+                                          WHOLEMEMORY_MT_CONTINUOUS,
+                                          WHOLEMEMORY_ML_DEVICE,
+                                          sizeof(int),
+                                          0),
+              WHOLEMEMORY_NOT_SUPPORTED);
+    size_t entry_count = max_entry_count / 2 - 1000;
+    EXPECT_EQ(wholememory_malloc_growable(&handle,
+                                          entry_count * sizeof(int),
+                                          max_entry_count * sizeof(int),
+                                          wm_comm,
+                                          WHOLEMEMORY_MT_CONTINUOUS,
+                                          WHOLEMEMORY_ML_DEVICE,
+                                          sizeof(int),
+                                          0),
+              WHOLEMEMORY_NOT_SUPPORTED);
+    entry_count = max_entry_count / 2 + 1000;
+    EXPECT_EQ(wholememory_malloc_growable(&handle,
+                                          entry_count * sizeof(int),
+                                          max_entry_count * sizeof(int),
+                                          wm_comm,
+                                          WHOLEMEMORY_MT_CONTINUOUS,
+                                          WHOLEMEMORY_ML_DEVICE,
+                                          sizeof(int),
+                                          0),
+              WHOLEMEMORY_SUCCESS);
+    void* global_ptr;
+    EXPECT_EQ(wholememory_get_global_pointer(&global_ptr, handle), WHOLEMEMORY_SUCCESS);
+    std::vector<int> host_data(max_entry_count);
+    for (size_t i = 0; i < max_entry_count; i++) {
+      host_data[i] = static_cast<int>(i);
+    }
+    if (rank == 0) {
+      EXPECT_EQ(
+        cudaMemcpy(global_ptr, host_data.data(), entry_count * sizeof(int), cudaMemcpyDefault),
+        cudaSuccess);
+    }
+    EXPECT_EQ(wholememory_communicator_barrier(wm_comm), WHOLEMEMORY_SUCCESS);
+
+    EXPECT_EQ(wholememory_grow(handle, max_entry_count * sizeof(int)), WHOLEMEMORY_SUCCESS);
+    void* new_global_ptr;
+    EXPECT_EQ(wholememory_get_global_pointer(&new_global_ptr, handle), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(new_global_ptr, global_ptr);
+    size_t size_per_rank, local_size, local_offset;
+    EXPECT_EQ(wholememory_get_partition_plan(&size_per_rank, handle), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(
+      wholememory::get_local_memory_from_handle(nullptr, &local_size, &local_offset, handle),
+      WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(local_offset, rank * size_per_rank);
+    EXPECT_EQ(local_size, std::min(size_per_rank, max_entry_count * sizeof(int) - local_offset));
+    if (rank == world_size - 1) {
+      EXPECT_EQ(cudaMemcpy(static_cast<int*>(global_ptr) + entry_count,
+                           host_data.data() + entry_count,
+                           (max_entry_count - entry_count) * sizeof(int),
+                           cudaMemcpyDefault),
+                cudaSuccess);
+    }
+    EXPECT_EQ(wholememory_communicator_barrier(wm_comm), WHOLEMEMORY_SUCCESS);
+    std::vector<int> read_data(max_entry_count);
+    EXPECT_EQ(
+      cudaMemcpy(read_data.data(), global_ptr, max_entry_count * sizeof(int), cudaMemcpyDefault),
+      cudaSuccess);
+    EXPECT_EQ(read_data, host_data);
+
+    EXPECT_EQ(wholememory::destroy_wholememory(handle), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+
+    WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+  });
+  ClosePipes(&pipes);
+}
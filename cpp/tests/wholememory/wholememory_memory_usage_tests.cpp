@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019-2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "wholememory/communicator.hpp"
+#include "wholememory/env_func_ptrs.hpp"
+#include "wholememory/memory_usage.hpp"
+#include "wholememory_ops/temp_memory_handle.hpp"
+
+#include "wholememory_test_utils.hpp"
+
+static wholememory_memory_usage_t get_usage(wholememory_memory_allocation_type_t allocation_type,
+                                            wholememory_memory_type_t memory_type,
+                                            wholememory_memory_purpose_t purpose)
+{
+  wholememory_memory_usage_t usage{};
+  EXPECT_EQ(wholememory_get_memory_usage(&usage, allocation_type, memory_type, purpose),
+            WHOLEMEMORY_SUCCESS);
+  return usage;
+}
+
+TEST(WholeMemoryMemoryUsageTest, HandleMemoryUsage)
+{
+  // host only communicator needs no CUDA device.
+  int nproc = 2;
+  std::vector<std::array<int, 2>> pipes;
+  CreatePipes(&pipes, nproc);
+  MultiProcessRun(nproc, [&pipes](int rank, int world_size) {
+    EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
+    wholememory_comm_t wm_comm =
+      create_communicator_by_pipes(pipes, rank, world_size, WHOLEMEMORY_CB_HOST);
+
+    auto total_usage = get_usage(WHOLEMEMORY_MA_NONE, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_NONE);
+    auto general_usage =
+      get_usage(WHOLEMEMORY_MA_HOST, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_GENERAL);
+    auto cache_usage =
+      get_usage(WHOLEMEMORY_MA_NONE, WHOLEMEMORY_MT_DISTRIBUTED, WHOLEMEMORY_MP_EMBEDDING_CACHE);
+
+    // shared host memory is accounted to the first rank.
+    size_t const continuous_size = 4UL * 1024UL * 1024UL;
+    wholememory_handle_t continuous_handle;
+    EXPECT_EQ(wholememory_malloc_growable(&continuous_handle,
+                                          continuous_size,
+                                          4 * continuous_size,
+                                          wm_comm,
+                                          WHOLEMEMORY_MT_CONTINUOUS,
+                                          WHOLEMEMORY_ML_HOST,
+                                          sizeof(int64_t),
+                                          0),
+              WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_get_memory_purpose(continuous_handle), WHOLEMEMORY_MP_GENERAL);
+    wholememory_memory_usage_t handle_usage{};
+    EXPECT_EQ(wholememory_get_handle_memory_usage(&handle_usage, continuous_handle),
+              WHOLEMEMORY_SUCCESS);
+    size_t const continuous_local_size = rank == 0 ? continuous_size : 0;
+    EXPECT_EQ(handle_usage.live_bytes, continuous_local_size);
+    EXPECT_EQ(handle_usage.live_count, 1);
+    EXPECT_EQ(handle_usage.alloc_count, 1);
+
+    // each rank allocates its own partition of distributed memory.
+    size_t const distributed_size = 1024UL * 1024UL;
+    wholememory_handle_t distributed_handle;
+    {
+      wholememory::memory_purpose_guard purpose_guard(WHOLEMEMORY_MP_EMBEDDING_CACHE);
+      EXPECT_EQ(wholememory_malloc(&distributed_handle,
+                                   distributed_size,
+                                   wm_comm,
+                                   WHOLEMEMORY_MT_DISTRIBUTED,
+                                   WHOLEMEMORY_ML_HOST,
+                                   sizeof(int64_t)),
+                WHOLEMEMORY_SUCCESS);
+    }
+    EXPECT_EQ(wholememory::get_current_memory_purpose(), WHOLEMEMORY_MP_GENERAL);
+    EXPECT_EQ(wholememory_get_memory_purpose(distributed_handle), WHOLEMEMORY_MP_EMBEDDING_CACHE);
+    size_t const distributed_local_size = distributed_size / world_size;
+
+    auto usage = get_usage(WHOLEMEMORY_MA_HOST, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_GENERAL);
+    EXPECT_EQ(usage.live_bytes, general_usage.live_bytes + continuous_local_size);
+    EXPECT_EQ(usage.live_count, general_usage.live_count + 1);
+    usage =
+      get_usage(WHOLEMEMORY_MA_NONE, WHOLEMEMORY_MT_DISTRIBUTED, WHOLEMEMORY_MP_EMBEDDING_CACHE);
+    EXPECT_EQ(usage.live_bytes, cache_usage.live_bytes + distributed_local_size);
+    EXPECT_EQ(usage.live_count, cache_usage.live_count + 1);
+    EXPECT_EQ(usage.alloc_count, cache_usage.alloc_count + 1);
+    // host only communicator doesn't register host memory.
+    usage = get_usage(WHOLEMEMORY_MA_PINNED, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_NONE);
+    EXPECT_EQ(usage.live_bytes, 0);
+
+    // growing counts as an allocation, but not as a live one.
+    EXPECT_EQ(wholememory_grow(continuous_handle, 2 * continuous_size), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_get_handle_memory_usage(&handle_usage, continuous_handle),
+              WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(handle_usage.live_bytes, 2 * continuous_local_size);
+    EXPECT_EQ(handle_usage.peak_bytes, 2 * continuous_local_size);
+    EXPECT_EQ(handle_usage.alloc_count, rank == 0 ? 2 : 1);
+    usage = get_usage(WHOLEMEMORY_MA_NONE, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_NONE);
+    size_t const total_local_size = 2 * continuous_local_size + distributed_local_size;
+    EXPECT_EQ(usage.live_bytes, total_usage.live_bytes + total_local_size);
+    EXPECT_EQ(usage.live_count, total_usage.live_count + 2);
+
+    std::vector<wholememory_memory_usage_t> rank_usages(world_size);
+    EXPECT_EQ(wholememory_get_rank_memory_usage(rank_usages.data(),
+                                                wm_comm,
+                                                WHOLEMEMORY_MA_NONE,
+                                                WHOLEMEMORY_MT_NONE,
+                                                WHOLEMEMORY_MP_NONE),
+              WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(rank_usages[rank].live_bytes, usage.live_bytes);
+    EXPECT_EQ(rank_usages[rank].live_count, usage.live_count);
+    EXPECT_EQ(rank_usages[rank].alloc_count, usage.alloc_count);
+
+    EXPECT_EQ(wholememory_free(continuous_handle), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_free(distributed_handle), WHOLEMEMORY_SUCCESS);
+    usage = get_usage(WHOLEMEMORY_MA_NONE, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_NONE);
+    EXPECT_EQ(usage.live_bytes, total_usage.live_bytes);
+    EXPECT_EQ(usage.live_count, total_usage.live_count);
+    EXPECT_GE(usage.peak_bytes, total_usage.live_bytes + total_local_size);
+    EXPECT_EQ(wholememory_reset_memory_usage_peak(), WHOLEMEMORY_SUCCESS);
+    usage = get_usage(WHOLEMEMORY_MA_NONE, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_NONE);
+    EXPECT_EQ(usage.peak_bytes, usage.live_bytes);
+
+    EXPECT_EQ(wholememory_get_memory_usage(
+                nullptr, WHOLEMEMORY_MA_NONE, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_NONE),
+              WHOLEMEMORY_INVALID_INPUT);
+    EXPECT_EQ(wholememory_get_memory_usage(&usage,
+                                           WHOLEMEMORY_MA_NONE,
+                                           WHOLEMEMORY_MT_NONE,
+                                           static_cast<wholememory_memory_purpose_t>(100)),
+              WHOLEMEMORY_INVALID_VALUE);
+
+    EXPECT_EQ(wholememory::destroy_all_communicators(), WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_finalize(), WHOLEMEMORY_SUCCESS);
+    WHOLEMEMORY_CHECK(::testing::Test::HasFailure() == false);
+  });
+  ClosePipes(&pipes);
+}
+
+TEST(WholeMemoryMemoryUsageTest, TemporaryMemoryUsage)
+{
+  // cached blocks are still held by cached allocator, so they are accounted until dropped.
+  wholememory::drop_cached_env_func_cache();
+  auto base_usage = get_usage(WHOLEMEMORY_MA_HOST, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_TEMPORARY);
+  {
+    wholememory_ops::temp_memory_handle tmh(wholememory::get_cached_env_func());
+    EXPECT_NE(tmh.host_malloc(1000, WHOLEMEMORY_DT_INT8), nullptr);
+    auto usage = get_usage(WHOLEMEMORY_MA_HOST, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_TEMPORARY);
+    EXPECT_EQ(usage.live_bytes, base_usage.live_bytes + 1024);
+    EXPECT_EQ(usage.live_count, base_usage.live_count + 1);
+  }
+  auto usage = get_usage(WHOLEMEMORY_MA_HOST, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_TEMPORARY);
+  EXPECT_EQ(usage.live_bytes, base_usage.live_bytes + 1024);
+  {
+    // reusing cached block is not a new allocation.
+    wholememory_ops::temp_memory_handle tmh(wholememory::get_cached_env_func());
+    EXPECT_NE(tmh.host_malloc(1024, WHOLEMEMORY_DT_INT8), nullptr);
+    usage = get_usage(WHOLEMEMORY_MA_HOST, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_TEMPORARY);
+    EXPECT_EQ(usage.alloc_count, base_usage.alloc_count + 1);
+  }
+  wholememory::drop_cached_env_func_cache();
+  usage = get_usage(WHOLEMEMORY_MA_HOST, WHOLEMEMORY_MT_NONE, WHOLEMEMORY_MP_TEMPORARY);
+  EXPECT_EQ(usage.live_bytes, base_usage.live_bytes);
+  EXPECT_EQ(usage.live_count, base_usage.live_count);
+  EXPECT_EQ(usage.peak_bytes, std::max(base_usage.peak_bytes, base_usage.live_bytes + 1024));
+}
@@ -21,13 +21,16 @@
 #include "parallel_utils.hpp"
 #include "wholememory/communicator.hpp"
 
-wholememory_comm_t create_communicator_by_pipes(const std::vector<std::array<int, 2>>& pipes,
-                                                int rank,
-                                                int world_size)
+wholememory_comm_t create_communicator_by_pipes(
+  const std::vector<std::array<int, 2>>& pipes,
+  int rank,
+  int world_size,
+  wholememory_comm_backend_t comm_backend = WHOLEMEMORY_CB_NCCL)
 {
   wholememory_unique_id_t unique_id;
   if (rank == 0) {
-    WHOLEMEMORY_CHECK_NOTHROW(wholememory::create_unique_id(&unique_id) == WHOLEMEMORY_SUCCESS);
+    WHOLEMEMORY_CHECK_NOTHROW(wholememory::create_unique_id(&unique_id, comm_backend) ==
+                              WHOLEMEMORY_SUCCESS);
   }
 
   PipeBroadcast(rank, world_size, 0, pipes, &unique_id);
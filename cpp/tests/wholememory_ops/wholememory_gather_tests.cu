@@ -103,6 +103,21 @@ typedef struct WholeMemoryGatherTestParam {
     output_type = new_output_type;
     return *this;
   }
+  WholeMemoryGatherTestParam& set_host_buffer(bool new_host_buffer)
+  {
+    host_buffer = new_host_buffer;
+    return *this;
+  }
+  WholeMemoryGatherTestParam& set_mixed_buffer(bool new_mixed_buffer)
+  {
+    mixed_buffer = new_mixed_buffer;
+    return *this;
+  }
+  WholeMemoryGatherTestParam& set_bad_index(bool new_bad_index)
+  {
+    bad_index = new_bad_index;
+    return *this;
+  }
   WholeMemoryGatherTestParam& set_distributed_backend(
     wholememory_distributed_backend_t new_distributed_backend)
   {
@@ -123,6 +138,12 @@ typedef struct WholeMemoryGatherTestParam {
   int64_t indices_storage_offset                        = 0;
   int64_t output_storage_offset                         = 0;
   wholememory_distributed_backend_t distributed_backend = WHOLEMEMORY_DB_NCCL;
+  // pass host indices and output to gather, which runs on CPU for host memory.
+  bool host_buffer = false;
+  // only rank 0 passes host indices and output, rejected for distributed memory.
+  bool mixed_buffer = false;
+  // rank 0 passes an out of range index, rejected on all ranks.
+  bool bad_index = false;
 } WholeMemoryGatherTestParam;
 
 class WholeMemoryGatherParameterTests
@@ -140,6 +161,8 @@ TEST_P(WholeMemoryGatherParameterTests, GatherTest)
       EXPECT_EQ(wholememory_init(0), WHOLEMEMORY_SUCCESS);
 
       EXPECT_EQ(cudaSetDevice(world_rank), cudaSuccess);
+      // mixed buffers are only detected by the opt-in collective check.
+      if (params.mixed_buffer) setenv("WHOLEMEMORY_CHECK_HOST_GATHER_SCATTER", "1", 1);
 
       wholememory_comm_t wm_comm = create_communicator_by_pipes(pipes, world_rank, world_size);
 
@@ -199,6 +222,14 @@ TEST_P(WholeMemoryGatherParameterTests, GatherTest)
                 cudaSuccess);
 
       EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+      // only host indices are changed, device indices are still valid for the reference.
+      if (params.bad_index && world_rank == 0 && indices_desc.size > 0) {
+        if (indices_desc.dtype == WHOLEMEMORY_DT_INT64) {
+          static_cast<int64_t*>(host_indices)[indices_desc.storage_offset] = -1;
+        } else {
+          static_cast<int*>(host_indices)[indices_desc.storage_offset] = -1;
+        }
+      }
       wholememory_communicator_barrier(wm_comm);
 
       wholememory_tensor_t embedding_tensor;
@@ -208,22 +239,26 @@ TEST_P(WholeMemoryGatherParameterTests, GatherTest)
                   &embedding_tensor, embedding_handle, &embedding_tensor_desc),
                 WHOLEMEMORY_SUCCESS);
 
+      bool const use_host_buffer = params.host_buffer || (params.mixed_buffer && world_rank == 0);
+      bool const expect_reject   = (params.mixed_buffer && world_size > 1) || params.bad_index;
       wholememory_tensor_t indices_tensor, output_tensor;
       wholememory_tensor_description_t indices_tensor_desc, output_tensor_desc;
       wholememory_copy_array_desc_to_tensor(&indices_tensor_desc, &indices_desc);
       wholememory_copy_matrix_desc_to_tensor(&output_tensor_desc, &output_desc);
+      void* indices_ptr = use_host_buffer ? host_indices : dev_indices;
+      void* output_ptr  = use_host_buffer ? host_gather_buffer : dev_gather_buffer;
       EXPECT_EQ(
-        wholememory_make_tensor_from_pointer(&indices_tensor, dev_indices, &indices_tensor_desc),
+        wholememory_make_tensor_from_pointer(&indices_tensor, indices_ptr, &indices_tensor_desc),
+        WHOLEMEMORY_SUCCESS);
+      EXPECT_EQ(
+        wholememory_make_tensor_from_pointer(&output_tensor, output_ptr, &output_tensor_desc),
         WHOLEMEMORY_SUCCESS);
-      EXPECT_EQ(wholememory_make_tensor_from_pointer(
-                  &output_tensor, dev_gather_buffer, &output_tensor_desc),
-                WHOLEMEMORY_SUCCESS);
       EXPECT_EQ(wholememory_gather(embedding_tensor,
                                    indices_tensor,
                                    output_tensor,
                                    wholememory::get_default_env_func(),
                                    stream),
-                WHOLEMEMORY_SUCCESS);
+                expect_reject ? WHOLEMEMORY_INVALID_INPUT : WHOLEMEMORY_SUCCESS);
 
       EXPECT_EQ(cudaGetLastError(), cudaSuccess);
       EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
@@ -237,12 +272,14 @@ TEST_P(WholeMemoryGatherParameterTests, GatherTest)
                                                               indices_desc,
                                                               wholememory::get_default_env_func(),
                                                               stream);
-      EXPECT_EQ(cudaMemcpyAsync(host_gather_buffer,
-                                dev_gather_buffer,
-                                wholememory_get_memory_size_from_matrix(&output_desc),
-                                cudaMemcpyDeviceToHost,
-                                stream),
-                cudaSuccess);
+      if (!use_host_buffer) {
+        EXPECT_EQ(cudaMemcpyAsync(host_gather_buffer,
+                                  dev_gather_buffer,
+                                  wholememory_get_memory_size_from_matrix(&output_desc),
+                                  cudaMemcpyDeviceToHost,
+                                  stream),
+                  cudaSuccess);
+      }
       EXPECT_EQ(cudaMemcpyAsync(host_reference_buffer,
                                 dev_reference_buffer,
                                 wholememory_get_memory_size_from_matrix(&output_desc),
@@ -252,8 +289,10 @@ TEST_P(WholeMemoryGatherParameterTests, GatherTest)
       EXPECT_EQ(cudaGetLastError(), cudaSuccess);
       EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
 
-      wholememory_ops::testing::host_check_embedding_same(
-        host_gather_buffer, output_desc, host_reference_buffer, output_desc);
+      if (!expect_reject) {
+        wholememory_ops::testing::host_check_embedding_same(
+          host_gather_buffer, output_desc, host_reference_buffer, output_desc);
+      }
 
       EXPECT_EQ(cudaFreeHost(host_indices), cudaSuccess);
       EXPECT_EQ(cudaFree(dev_indices), cudaSuccess);
@@ -301,6 +340,48 @@ INSTANTIATE_TEST_SUITE_P(
     WholeMemoryGatherTestParam()
       .set_memory_type(WHOLEMEMORY_MT_DISTRIBUTED)
       .set_memory_location(WHOLEMEMORY_ML_HOST),
+    WholeMemoryGatherTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_host_buffer(true),
+    WholeMemoryGatherTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_host_buffer(true),
+    WholeMemoryGatherTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_DISTRIBUTED)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_host_buffer(true),
+    WholeMemoryGatherTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_embedding_type(WHOLEMEMORY_DT_HALF)
+      .set_indices_type(WHOLEMEMORY_DT_INT64)
+      .set_embedding_dim(11)
+      .set_embedding_stride(12)
+      .set_output_stride(13)
+      .set_host_buffer(true),
+    WholeMemoryGatherTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_DISTRIBUTED)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_output_type(WHOLEMEMORY_DT_HALF)
+      .set_embedding_dim(127)
+      .set_indices_count(100005)
+      .set_host_buffer(true),
+    WholeMemoryGatherTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_DISTRIBUTED)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_mixed_buffer(true),
+    WholeMemoryGatherTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_DISTRIBUTED)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_host_buffer(true)
+      .set_bad_index(true),
+    WholeMemoryGatherTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_DISTRIBUTED)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_indices_count(0)
+      .set_host_buffer(true),
     WholeMemoryGatherTestParam()
       .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
       .set_embedding_dim(11)
@@ -101,6 +101,11 @@ typedef struct WholeMemoryScatterTestParam {
     input_type = new_input_type;
     return *this;
   }
+  WholeMemoryScatterTestParam& set_host_buffer(bool new_host_buffer)
+  {
+    host_buffer = new_host_buffer;
+    return *this;
+  }
   WholeMemoryScatterTestParam& set_distributed_backend(
     wholememory_distributed_backend_t new_distributed_backend)
   {
@@ -121,6 +126,8 @@ typedef struct WholeMemoryScatterTestParam {
   int64_t indices_storage_offset                        = 0;
   int64_t input_storage_offset                          = 0;
   wholememory_distributed_backend_t distributed_backend = WHOLEMEMORY_DB_NCCL;
+  // pass host indices, input and output to scatter and gather, which run on CPU for host memory.
+  bool host_buffer = false;
 } WholeMemoryScatterTestParam;
 
 class WholeMemoryScatterParameterTests
@@ -200,6 +207,14 @@ TEST_P(WholeMemoryScatterParameterTests, ScatterTest)
                                                             indices_desc,
                                                             wholememory::get_default_env_func(),
                                                             stream);
+    if (params.host_buffer) {
+      EXPECT_EQ(cudaMemcpyAsync(host_input_buffer,
+                                dev_input_buffer,
+                                wholememory_get_memory_size_from_matrix(&input_desc),
+                                cudaMemcpyDeviceToHost,
+                                stream),
+                cudaSuccess);
+    }
 
     EXPECT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
     wholememory_communicator_barrier(wm_comm);
@@ -215,12 +230,15 @@ TEST_P(WholeMemoryScatterParameterTests, ScatterTest)
     wholememory_tensor_description_t indices_tensor_desc, input_tensor_desc;
     wholememory_copy_array_desc_to_tensor(&indices_tensor_desc, &indices_desc);
     wholememory_copy_matrix_desc_to_tensor(&input_tensor_desc, &input_desc);
-    EXPECT_EQ(
-      wholememory_make_tensor_from_pointer(&indices_tensor, dev_indices, &indices_tensor_desc),
-      WHOLEMEMORY_SUCCESS);
-    EXPECT_EQ(
-      wholememory_make_tensor_from_pointer(&input_tensor, dev_input_buffer, &input_tensor_desc),
-      WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_make_tensor_from_pointer(&indices_tensor,
+                                                   params.host_buffer ? host_indices : dev_indices,
+                                                   &indices_tensor_desc),
+              WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_make_tensor_from_pointer(
+                &input_tensor,
+                params.host_buffer ? host_input_buffer : dev_input_buffer,
+                &input_tensor_desc),
+              WHOLEMEMORY_SUCCESS);
 
     EXPECT_EQ(wholememory_scatter(input_tensor,
                                   indices_tensor,
@@ -236,9 +254,11 @@ TEST_P(WholeMemoryScatterParameterTests, ScatterTest)
     wholememory_communicator_barrier(wm_comm);
 
     wholememory_tensor_t gathered_tensor;
-    EXPECT_EQ(
-      wholememory_make_tensor_from_pointer(&gathered_tensor, dev_gather_buffer, &input_tensor_desc),
-      WHOLEMEMORY_SUCCESS);
+    EXPECT_EQ(wholememory_make_tensor_from_pointer(
+                &gathered_tensor,
+                params.host_buffer ? host_gather_buffer : dev_gather_buffer,
+                &input_tensor_desc),
+              WHOLEMEMORY_SUCCESS);
     EXPECT_EQ(wholememory_gather(embedding_tensor,
                                  indices_tensor,
                                  gathered_tensor,
@@ -246,12 +266,14 @@ TEST_P(WholeMemoryScatterParameterTests, ScatterTest)
                                  stream),
               WHOLEMEMORY_SUCCESS);
 
-    EXPECT_EQ(cudaMemcpyAsync(host_gather_buffer,
-                              dev_gather_buffer,
-                              wholememory_get_memory_size_from_matrix(&input_desc),
-                              cudaMemcpyDeviceToHost,
-                              stream),
-              cudaSuccess);
+    if (!params.host_buffer) {
+      EXPECT_EQ(cudaMemcpyAsync(host_gather_buffer,
+                                dev_gather_buffer,
+                                wholememory_get_memory_size_from_matrix(&input_desc),
+                                cudaMemcpyDeviceToHost,
+                                stream),
+                cudaSuccess);
+    }
     EXPECT_EQ(cudaMemcpyAsync(host_input_buffer,
                               dev_input_buffer,
                               wholememory_get_memory_size_from_matrix(&input_desc),
@@ -304,6 +326,27 @@ INSTANTIATE_TEST_SUITE_P(
     WholeMemoryScatterTestParam()
       .set_memory_type(WHOLEMEMORY_MT_DISTRIBUTED)
       .set_memory_location(WHOLEMEMORY_ML_HOST),
+    WholeMemoryScatterTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CONTINUOUS)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_host_buffer(true),
+    WholeMemoryScatterTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_CHUNKED)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_host_buffer(true),
+    WholeMemoryScatterTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_DISTRIBUTED)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_host_buffer(true),
+    WholeMemoryScatterTestParam()
+      .set_memory_type(WHOLEMEMORY_MT_DISTRIBUTED)
+      .set_memory_location(WHOLEMEMORY_ML_HOST)
+      .set_embedding_type(WHOLEMEMORY_DT_HALF)
+      .set_indices_type(WHOLEMEMORY_DT_INT64)
+      .set_embedding_dim(11)
+      .set_embedding_stride(12)
+      .set_input_stride(13)
+      .set_host_buffer(true),
     WholeMemoryScatterTestParam().set_memory_type(WHOLEMEMORY_MT_CONTINUOUS).set_embedding_dim(128),
     WholeMemoryScatterTestParam().set_memory_type(WHOLEMEMORY_MT_CHUNKED).set_embedding_dim(128),
     WholeMemoryScatterTestParam()
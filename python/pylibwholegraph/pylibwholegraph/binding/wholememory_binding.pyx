@@ -66,11 +66,25 @@ cdef extern from "wholememory/wholememory.h":
         WHOLEMEMORY_ML_NONE                 "WHOLEMEMORY_ML_NONE"
         WHOLEMEMORY_ML_DEVICE               "WHOLEMEMORY_ML_DEVICE"
         WHOLEMEMORY_ML_HOST                 "WHOLEMEMORY_ML_HOST"
+        WHOLEMEMORY_ML_FILE                 "WHOLEMEMORY_ML_FILE"
+
+    ctypedef enum wholememory_malloc_flags_t:
+        WHOLEMEMORY_MF_NO_ZERO_INIT         "WHOLEMEMORY_MF_NO_ZERO_INIT"
+        WHOLEMEMORY_MF_FILE_WRITE_BACK      "WHOLEMEMORY_MF_FILE_WRITE_BACK"
 
     ctypedef enum wholememory_distributed_backend_t:
         WHOLEMEMORY_DB_NONE                 "WHOLEMEMORY_DB_NONE"
         WHOLEMEMORY_DB_NCCL                 "WHOLEMEMORY_DB_NCCL"
         WHOLEMEMORY_DB_NVSHMEM              "WHOLEMEMORY_DB_NVSHMEM"
+
+    ctypedef enum wholememory_comm_backend_t:
+        WHOLEMEMORY_CB_NONE                 "WHOLEMEMORY_CB_NONE"
+        WHOLEMEMORY_CB_NCCL                 "WHOLEMEMORY_CB_NCCL"
+        WHOLEMEMORY_CB_HOST                 "WHOLEMEMORY_CB_HOST"
+
+    ctypedef enum wholememory_init_flags_t:
+        WHOLEMEMORY_INIT_HUGE_PAGE_2MB      "WHOLEMEMORY_INIT_HUGE_PAGE_2MB"
+        WHOLEMEMORY_INIT_HUGE_PAGE_1GB      "WHOLEMEMORY_INIT_HUGE_PAGE_1GB"
     cdef wholememory_error_code_t wholememory_init(unsigned int flags)
 
     cdef wholememory_error_code_t wholememory_finalize()
@@ -85,6 +99,10 @@ cdef extern from "wholememory/wholememory.h":
 
     cdef wholememory_error_code_t wholememory_create_unique_id(wholememory_unique_id_t * unique_id)
 
+    cdef wholememory_error_code_t wholememory_create_unique_id_with_backend(
+            wholememory_unique_id_t * unique_id,
+            wholememory_comm_backend_t comm_backend)
+
     cdef wholememory_error_code_t wholememory_create_communicator(wholememory_comm_t * comm,
                                                                   wholememory_unique_id_t unique_id,
                                                                   int rank,
@@ -115,6 +133,14 @@ cdef extern from "wholememory/wholememory.h":
                                                      wholememory_memory_location_t memory_location,
                                                      size_t data_granularity)
 
+    cdef wholememory_error_code_t wholememory_malloc_from_file(wholememory_handle_t * wholememory_handle_ptr,
+                                                               wholememory_comm_t comm,
+                                                               wholememory_memory_type_t memory_type,
+                                                               size_t data_granularity,
+                                                               const char** file_names,
+                                                               int file_count,
+                                                               unsigned int flags)
+
     cdef wholememory_error_code_t wholememory_free(wholememory_handle_t wholememory_handle)
 
     cdef wholememory_error_code_t wholememory_get_communicator(wholememory_comm_t * comm,
@@ -152,6 +178,12 @@ cdef extern from "wholememory/wholememory.h":
     cdef wholememory_error_code_t wholememory_get_partition_plan(size_t * size_per_rank,
                                                                  wholememory_handle_t wholememory_handle)
 
+    cdef wholememory_error_code_t wholememory_get_host_numa_nodes(int * numa_nodes,
+                                                                  size_t offset,
+                                                                  size_t stride,
+                                                                  size_t count,
+                                                                  wholememory_handle_t wholememory_handle)
+
     cdef int fork_get_device_count()
 
     cdef wholememory_error_code_t wholememory_load_from_file(wholememory_handle_t wholememory_handle,
@@ -175,6 +207,8 @@ cdef extern from "wholememory/wholememory.h":
     cdef wholememory_distributed_backend_t wholememory_communicator_get_distributed_backend(
                                                                             wholememory_comm_t comm)
 
+    cdef wholememory_comm_backend_t wholememory_communicator_get_backend(wholememory_comm_t comm)
+
 
 cpdef enum WholeMemoryErrorCode:
     Success = WHOLEMEMORY_SUCCESS
@@ -198,12 +232,22 @@ cpdef enum WholeMemoryMemoryLocation:
     MlNone = WHOLEMEMORY_ML_NONE
     MlDevice = WHOLEMEMORY_ML_DEVICE
     MlHost = WHOLEMEMORY_ML_HOST
+    MlFile = WHOLEMEMORY_ML_FILE
 
 cpdef enum WholeMemoryDistributedBackend:
     DbNone = WHOLEMEMORY_DB_NONE
     DbNCCL = WHOLEMEMORY_DB_NCCL
     DbNVSHMEM = WHOLEMEMORY_DB_NVSHMEM
 
+cpdef enum WholeMemoryCommBackend:
+    CbNone = WHOLEMEMORY_CB_NONE
+    CbNCCL = WHOLEMEMORY_CB_NCCL
+    CbHost = WHOLEMEMORY_CB_HOST
+
+cpdef enum WholeMemoryInitFlags:
+    IfHugePage2MB = WHOLEMEMORY_INIT_HUGE_PAGE_2MB
+    IfHugePage1GB = WHOLEMEMORY_INIT_HUGE_PAGE_1GB
+
 cdef check_wholememory_error_code(wholememory_error_code_t err):
     cdef WholeMemoryErrorCode err_code = int(err)
     if err_code == Success:
@@ -254,6 +298,20 @@ cdef extern from "wholememory/tensor_description.h":
             wholememory_tensor_description_t * p_tensor_description)
 
 
+cdef extern from "wholememory/wholememory.h":
+    cdef wholememory_error_code_t wholememory_load_from_file_with_conversion(
+            wholememory_handle_t wholememory_handle,
+            size_t memory_offset,
+            size_t memory_entry_size,
+            wholememory_dtype_t memory_dtype,
+            size_t file_entry_size,
+            wholememory_dtype_t file_dtype,
+            size_t file_column_start,
+            size_t column_count,
+            const char** file_names,
+            int file_count)
+
+
 cdef extern from "wholememory/env_func_ptrs.h":
     ctypedef enum wholememory_memory_allocation_type_t:
         WHOLEMEMORY_MA_NONE                 "WHOLEMEMORY_MA_NONE"
@@ -297,6 +355,76 @@ cpdef enum WholeMemoryMemoryAllocType:
     MatHost = WHOLEMEMORY_MA_HOST
     MatPinned = WHOLEMEMORY_MA_PINNED
 
+
+cdef extern from "wholememory/memory_usage.h":
+    ctypedef enum wholememory_memory_purpose_t:
+        WHOLEMEMORY_MP_NONE                 "WHOLEMEMORY_MP_NONE"
+        WHOLEMEMORY_MP_GENERAL              "WHOLEMEMORY_MP_GENERAL"
+        WHOLEMEMORY_MP_EMBEDDING            "WHOLEMEMORY_MP_EMBEDDING"
+        WHOLEMEMORY_MP_EMBEDDING_CACHE      "WHOLEMEMORY_MP_EMBEDDING_CACHE"
+        WHOLEMEMORY_MP_OPTIMIZER_STATE      "WHOLEMEMORY_MP_OPTIMIZER_STATE"
+        WHOLEMEMORY_MP_TEMPORARY            "WHOLEMEMORY_MP_TEMPORARY"
+
+    cdef struct wholememory_memory_usage_t:
+        size_t live_bytes
+        size_t peak_bytes
+        int64_t live_count
+        int64_t alloc_count
+
+    cdef wholememory_error_code_t wholememory_get_memory_usage(
+            wholememory_memory_usage_t * usage,
+            wholememory_memory_allocation_type_t allocation_type,
+            wholememory_memory_type_t memory_type,
+            wholememory_memory_purpose_t purpose)
+
+    cdef wholememory_error_code_t wholememory_get_rank_memory_usage(
+            wholememory_memory_usage_t * rank_usages,
+            wholememory_comm_t comm,
+            wholememory_memory_allocation_type_t allocation_type,
+            wholememory_memory_type_t memory_type,
+            wholememory_memory_purpose_t purpose)
+
+    cdef wholememory_error_code_t wholememory_get_handle_memory_usage(
+            wholememory_memory_usage_t * usage,
+            wholememory_handle_t wholememory_handle)
+
+    cdef wholememory_memory_purpose_t wholememory_get_memory_purpose(
+            wholememory_handle_t wholememory_handle)
+
+    cdef wholememory_error_code_t wholememory_reset_memory_usage_peak()
+
+
+cpdef enum WholeMemoryMemoryPurpose:
+    MpNone = WHOLEMEMORY_MP_NONE
+    MpGeneral = WHOLEMEMORY_MP_GENERAL
+    MpEmbedding = WHOLEMEMORY_MP_EMBEDDING
+    MpEmbeddingCache = WHOLEMEMORY_MP_EMBEDDING_CACHE
+    MpOptimizerState = WHOLEMEMORY_MP_OPTIMIZER_STATE
+    MpTemporary = WHOLEMEMORY_MP_TEMPORARY
+
+
+cdef memory_usage_to_dict(const wholememory_memory_usage_t * usage):
+    return {'live_bytes': usage.live_bytes,
+            'peak_bytes': usage.peak_bytes,
+            'live_count': usage.live_count,
+            'alloc_count': usage.alloc_count}
+
+
+def get_memory_usage(WholeMemoryMemoryAllocType alloc_type = MatNone,
+                     WholeMemoryMemoryType memory_type = MtNone,
+                     WholeMemoryMemoryPurpose purpose = MpNone):
+    """Memory usage of current rank, None type matches all values of that field."""
+    cdef wholememory_memory_usage_t usage
+    check_wholememory_error_code(wholememory_get_memory_usage(&usage,
+                                                              <wholememory_memory_allocation_type_t> <int> alloc_type,
+                                                              <wholememory_memory_type_t> <int> memory_type,
+                                                              <wholememory_memory_purpose_t> <int> purpose))
+    return memory_usage_to_dict(&usage)
+
+
+def reset_memory_usage_peak():
+    check_wholememory_error_code(wholememory_reset_memory_usage_peak())
+
 cdef class PyMemoryAllocType:
     cdef wholememory_memory_allocation_type_t alloc_type
 
@@ -537,6 +665,18 @@ cdef extern from "wholememory/wholememory_tensor.h":
                                                                    int64_t *ends,
                                                                    wholememory_tensor_t *sub_wholememory_tensor)
 
+    cdef wholememory_error_code_t wholememory_tensor_store_to_checkpoint(wholememory_tensor_t wholememory_tensor,
+                                                                         const char *checkpoint_prefix)
+
+    cdef wholememory_error_code_t wholememory_tensor_load_from_checkpoint(wholememory_tensor_t wholememory_tensor,
+                                                                          const char *checkpoint_prefix,
+                                                                          int verify_checksum)
+
+    cdef wholememory_error_code_t wholememory_load_compressed_csr_from_file(
+            wholememory_tensor_t csr_row_ptr_tensor,
+            wholememory_tensor_t csr_col_ind_tensor,
+            const char *file_name)
+
     int64_t get_wholememory_tensor_count()
 
 
@@ -565,9 +705,13 @@ cdef extern from "wholememory/embedding.h":
     cdef struct wholememory_embedding_:
         pass
 
+    cdef struct wholememory_embedding_snapshot_:
+        pass
+
     ctypedef wholememory_embedding_cache_policy_ * wholememory_embedding_cache_policy_t
     ctypedef wholememory_embedding_optimizer_ * wholememory_embedding_optimizer_t
     ctypedef wholememory_embedding_ * wholememory_embedding_t
+    ctypedef wholememory_embedding_snapshot_ * wholememory_embedding_snapshot_t
 
     ctypedef enum wholememory_access_type_t:
         WHOLEMEMORY_AT_NONE                 "WHOLEMEMORY_AT_NONE"
@@ -643,6 +787,27 @@ cdef extern from "wholememory/embedding.h":
     cdef wholememory_error_code_t wholememory_embedding_drop_all_cache(
             wholememory_embedding_t wholememory_embedding, int64_t stream_int)
 
+    cdef wholememory_error_code_t wholememory_embedding_save_delta(
+            wholememory_embedding_t wholememory_embedding, const char * file_prefix, int64_t stream_int)
+
+    cdef wholememory_error_code_t wholememory_embedding_reset_dirty_rows(
+            wholememory_embedding_t wholememory_embedding, int64_t stream_int)
+
+    cdef wholememory_error_code_t wholememory_embedding_start_snapshot(
+            wholememory_embedding_snapshot_t * snapshot,
+            wholememory_embedding_t wholememory_embedding,
+            const char * file_prefix,
+            int64_t stream_int)
+
+    cdef wholememory_error_code_t wholememory_embedding_snapshot_is_done(
+            int * is_done, wholememory_embedding_snapshot_t snapshot)
+
+    cdef wholememory_error_code_t wholememory_embedding_snapshot_wait(
+            wholememory_embedding_snapshot_t snapshot)
+
+    cdef wholememory_error_code_t wholememory_destroy_embedding_snapshot(
+            wholememory_embedding_snapshot_t snapshot)
+
 
 cpdef enum WholeMemoryAccessType:
     AtNone = WHOLEMEMORY_AT_NONE
@@ -754,6 +919,33 @@ def create_cache_policy(PyWholeMemoryComm comm,
 def create_non_cache_policy():
     return WholeMemoryCachePolicy()
 
+cdef class PyWholeMemoryEmbeddingSnapshot:
+    cdef wholememory_embedding_snapshot_t snapshot
+
+    def __cinit__(self):
+        self.snapshot = NULL
+
+    def __dealloc__(self):
+        if self.snapshot != NULL:
+            wholememory_destroy_embedding_snapshot(self.snapshot)
+            self.snapshot = NULL
+
+    def is_done(self):
+        cdef int is_done = 1
+        if self.snapshot != NULL:
+            check_wholememory_error_code(wholememory_embedding_snapshot_is_done(&is_done, self.snapshot))
+        return is_done != 0
+
+    def wait(self):
+        if self.snapshot == NULL:
+            return
+        try:
+            check_wholememory_error_code(wholememory_embedding_snapshot_wait(self.snapshot))
+        finally:
+            wholememory_destroy_embedding_snapshot(self.snapshot)
+            self.snapshot = NULL
+
+
 cdef class PyWholeMemoryEmbedding:
     cdef wholememory_embedding_t wm_embedding
     cdef wholememory_memory_type_t memory_type
@@ -792,6 +984,27 @@ cdef class PyWholeMemoryEmbedding:
                        int64_t stream):
         check_wholememory_error_code(wholememory_embedding_drop_all_cache(self.wm_embedding, stream))
 
+    def save_delta(self,
+                   file_prefix,
+                   int64_t stream):
+        check_wholememory_error_code(
+            wholememory_embedding_save_delta(self.wm_embedding, PyUnicode_AsUTF8(file_prefix), stream))
+
+    def reset_dirty_rows(self,
+                         int64_t stream):
+        check_wholememory_error_code(wholememory_embedding_reset_dirty_rows(self.wm_embedding, stream))
+
+    def start_snapshot(self,
+                       file_prefix,
+                       int64_t stream):
+        snapshot = PyWholeMemoryEmbeddingSnapshot()
+        check_wholememory_error_code(
+            wholememory_embedding_start_snapshot(&snapshot.snapshot,
+                                                 self.wm_embedding,
+                                                 PyUnicode_AsUTF8(file_prefix),
+                                                 stream))
+        return snapshot
+
     def get_embedding_tensor(self):
         cdef wholememory_tensor_t wm_tensor
         wm_tensor = wholememory_embedding_get_embedding_tensor(self.wm_embedding)
@@ -987,9 +1200,10 @@ def init(unsigned int flags):
 def finalize():
     check_wholememory_error_code(wholememory_finalize())
 
-def create_unique_id():
+def create_unique_id(WholeMemoryCommBackend comm_backend = CbNCCL):
     py_uid = PyWholeMemoryUniqueID()
-    check_wholememory_error_code(wholememory_create_unique_id(&py_uid.wholememory_unique_id))
+    check_wholememory_error_code(
+        wholememory_create_unique_id_with_backend(&py_uid.wholememory_unique_id, comm_backend))
     return py_uid
 
 cpdef enum WholeMemoryViewType:
@@ -1240,6 +1454,31 @@ cdef class PyWholeMemoryComm:
     def set_distributed_backend(self,WholeMemoryDistributedBackend distributed_backend):
         check_wholememory_error_code(wholememory_communicator_set_distributed_backend(self.comm_id,int(distributed_backend)))
 
+    def get_comm_backend(self):
+        return WholeMemoryCommBackend(wholememory_communicator_get_backend(self.comm_id))
+
+    def get_rank_memory_usage(self,
+                              WholeMemoryMemoryAllocType alloc_type = MatNone,
+                              WholeMemoryMemoryType memory_type = MtNone,
+                              WholeMemoryMemoryPurpose purpose = MpNone):
+        """Memory usage of each rank, all ranks should call together."""
+        cdef int world_size = self.get_size()
+        cdef wholememory_memory_usage_t * rank_usages = \
+            <wholememory_memory_usage_t *> stdlib.malloc(world_size * sizeof(wholememory_memory_usage_t))
+        try:
+            check_wholememory_error_code(
+                wholememory_get_rank_memory_usage(rank_usages,
+                                                  self.comm_id,
+                                                  <wholememory_memory_allocation_type_t> <int> alloc_type,
+                                                  <wholememory_memory_type_t> <int> memory_type,
+                                                  <wholememory_memory_purpose_t> <int> purpose))
+            usages = []
+            for r in range(world_size):
+                usages.append(memory_usage_to_dict(&rank_usages[r]))
+            return usages
+        finally:
+            stdlib.free(rank_usages)
+
 cdef class PyWholeMemoryHandle:
     cdef wholememory_handle_t wholememory_handle
 
@@ -1260,11 +1499,27 @@ cdef class PyWholeMemoryHandle:
     def get_memory_location(self):
         return WholeMemoryMemoryLocation(wholememory_get_memory_location(self.wholememory_handle))
 
+    def get_memory_purpose(self):
+        return WholeMemoryMemoryPurpose(wholememory_get_memory_purpose(self.wholememory_handle))
+
+    def get_memory_usage(self):
+        cdef wholememory_memory_usage_t usage
+        check_wholememory_error_code(wholememory_get_handle_memory_usage(&usage, self.wholememory_handle))
+        return memory_usage_to_dict(&usage)
+
     def get_partition_plan(self):
         cdef size_t size_per_rank
         check_wholememory_error_code(wholememory_get_partition_plan(&size_per_rank, self.wholememory_handle))
         return size_per_rank
 
+    def get_host_numa_nodes(self, size_t offset, size_t stride, size_t count):
+        cdef int[::1] numa_nodes_view
+        numa_nodes = np.zeros(max(count, 1), dtype=np.int32)
+        numa_nodes_view = numa_nodes
+        check_wholememory_error_code(wholememory_get_host_numa_nodes(
+            &numa_nodes_view[0], offset, stride, count, self.wholememory_handle))
+        return numa_nodes[:count]
+
     def get_global_flatten_tensor(self,
                                   object import_dlpack_fn,
                                   WholeMemoryDataType data_type,
@@ -1538,7 +1793,7 @@ cdef class PyWholeMemoryTensor:
             chunked_tensors.append(self.get_tensor_in_window(chunked_flatten_tensors[i], element_offsets[i])[0])
         return chunked_tensors
 
-    def from_filelist(self, filelist):
+    def from_filelist(self, filelist, file_dtype=None, file_dim=None, file_column_start=0):
         handle = self.get_wholememory_handle()
         strides = self.stride()
         shape = self.shape
@@ -1555,7 +1810,24 @@ cdef class PyWholeMemoryTensor:
             file_entry_size = elt_size * shape[1]
         else:
             raise ValueError('tensor dim should be 1 or 2')
-        handle.from_filelist(memory_offset, memory_entry_size, file_entry_size, filelist)
+        if file_dtype is None and file_dim is None and file_column_start == 0:
+            handle.from_filelist(memory_offset, memory_entry_size, file_entry_size, filelist)
+            return
+        column_count = 1 if self.dim() == 1 else shape[1]
+        if file_dtype is None:
+            file_dtype = self.dtype
+        if file_dim is None:
+            file_dim = column_count
+        file_entry_size = file_dim * wholememory_dtype_get_element_size(<wholememory_dtype_t> <int> file_dtype)
+        load_wholememory_handle_from_filelist_with_conversion(handle.get_c_handle(),
+                                                              memory_offset,
+                                                              memory_entry_size,
+                                                              self.dtype,
+                                                              file_entry_size,
+                                                              file_dtype,
+                                                              file_column_start,
+                                                              column_count,
+                                                              filelist)
 
     def to_file(self, filename):
         handle = self.get_wholememory_handle()
@@ -1576,6 +1848,17 @@ cdef class PyWholeMemoryTensor:
             raise ValueError('tensor dim should be 1 or 2')
         handle.to_file(memory_offset, memory_entry_size, file_entry_size, filename)
 
+    def to_checkpoint(self, checkpoint_prefix):
+        check_wholememory_error_code(
+            wholememory_tensor_store_to_checkpoint(self.wholememory_tensor,
+                                                   PyUnicode_AsUTF8(checkpoint_prefix)))
+
+    def from_checkpoint(self, checkpoint_prefix, verify_checksum=False):
+        check_wholememory_error_code(
+            wholememory_tensor_load_from_checkpoint(self.wholememory_tensor,
+                                                    PyUnicode_AsUTF8(checkpoint_prefix),
+                                                    1 if verify_checksum else 0))
+
 ###############################################################################
 
 
@@ -1613,6 +1896,34 @@ def malloc(cython.size_t total_size,
                                                     data_granularity))
     return handle
 
+def malloc_from_file(PyWholeMemoryComm py_comm,
+                     WholeMemoryMemoryType memory_type,
+                     cython.size_t data_granularity,
+                     file_list,
+                     bool write_back = False):
+    # files are mapped read only unless write_back is True
+    cdef const char ** filenames
+    cdef int num_files = len(file_list)
+    cdef int i
+    handle = PyWholeMemoryHandle()
+
+    filenames = <const char**> stdlib.malloc(num_files * sizeof(char *))
+
+    try:
+        for i in range(num_files):
+            filenames[i] = PyUnicode_AsUTF8(file_list[i])
+
+        check_wholememory_error_code(wholememory_malloc_from_file(&handle.wholememory_handle,
+                                                                  py_comm.comm_id,
+                                                                  int(memory_type),
+                                                                  data_granularity,
+                                                                  filenames,
+                                                                  num_files,
+                                                                  WHOLEMEMORY_MF_FILE_WRITE_BACK if write_back else 0))
+    finally:
+        stdlib.free(filenames)
+    return handle
+
 def free(PyWholeMemoryHandle handle):
     check_wholememory_error_code(wholememory_free(handle.wholememory_handle))
 
@@ -1702,6 +2013,14 @@ def make_handle_as_wholememory(PyWholeMemoryTensorDescription tensor_description
 def destroy_wholememory_tensor(PyWholeMemoryTensor wholememory_tensor):
     check_wholememory_error_code(wholememory_destroy_tensor(wholememory_tensor.wholememory_tensor))
 
+def load_compressed_csr_from_file(PyWholeMemoryTensor csr_row_ptr_tensor,
+                                  PyWholeMemoryTensor csr_col_ind_tensor,
+                                  file_name):
+    check_wholememory_error_code(
+        wholememory_load_compressed_csr_from_file(csr_row_ptr_tensor.wholememory_tensor,
+                                                  csr_col_ind_tensor.wholememory_tensor,
+                                                  PyUnicode_AsUTF8(file_name)))
+
 def fork_get_gpu_count():
     return fork_get_device_count()
 
@@ -1730,6 +2049,39 @@ cpdef load_wholememory_handle_from_filelist(int64_t wholememory_handle_int_ptr,
     finally:
         stdlib.free(filenames)
 
+cpdef load_wholememory_handle_from_filelist_with_conversion(int64_t wholememory_handle_int_ptr,
+                                                            int64_t memory_offset,
+                                                            int64_t memory_entry_size,
+                                                            WholeMemoryDataType memory_dtype,
+                                                            int64_t file_entry_size,
+                                                            WholeMemoryDataType file_dtype,
+                                                            int64_t file_column_start,
+                                                            int64_t column_count,
+                                                            file_list):
+    cdef const char ** filenames
+    cdef int num_files = len(file_list)
+    cdef int i
+
+    filenames = <const char**> stdlib.malloc(num_files * sizeof(char *))
+
+    try:
+        for i in range(num_files):
+            filenames[i] = PyUnicode_AsUTF8(file_list[i])
+
+        check_wholememory_error_code(wholememory_load_from_file_with_conversion(
+            <wholememory_handle_t> <int64_t> wholememory_handle_int_ptr,
+            memory_offset,
+            memory_entry_size,
+            <wholememory_dtype_t> <int> memory_dtype,
+            file_entry_size,
+            <wholememory_dtype_t> <int> file_dtype,
+            file_column_start,
+            column_count,
+            filenames,
+            num_files))
+    finally:
+        stdlib.free(filenames)
+
 cpdef store_wholememory_handle_to_file(int64_t wholememory_handle_int_ptr,
                                        int64_t memory_offset,
                                        int64_t memory_entry_size,
@@ -1805,6 +2157,10 @@ cpdef void wholememory_env_test_cython_op(WrappedLocalTensor input,
     return
 
 cdef extern from "wholememory/wholegraph_op.h":
+    ctypedef enum wholegraph_temporal_sample_mode_t:
+        WHOLEGRAPH_TSM_UNIFORM              "WHOLEGRAPH_TSM_UNIFORM"
+        WHOLEGRAPH_TSM_LATEST               "WHOLEGRAPH_TSM_LATEST"
+
     cdef wholememory_error_code_t wholegraph_csr_unweighted_sample_without_replacement(
             wholememory_tensor_t wm_csr_row_ptr_tensor,
             wholememory_tensor_t wm_csr_col_ptr_tensor,
@@ -1818,6 +2174,19 @@ cdef extern from "wholememory/wholegraph_op.h":
             wholememory_env_func_t * p_env_fns,
             void * stream)
 
+    cdef wholememory_error_code_t wholegraph_csr_unweighted_multilayer_sample_without_replacement(
+            wholememory_tensor_t wm_csr_row_ptr_tensor,
+            wholememory_tensor_t wm_csr_col_ptr_tensor,
+            wholememory_tensor_t center_nodes_tensor,
+            const int * max_sample_counts,
+            int hop_count,
+            void ** output_target_nodes_memory_contexts,
+            void ** output_csr_row_ptr_memory_contexts,
+            void ** output_edge_indice_memory_contexts,
+            unsigned long long random_seed,
+            wholememory_env_func_t * p_env_fns,
+            void * stream)
+
     cdef wholememory_error_code_t wholegraph_csr_weighted_sample_without_replacement(
             wholememory_tensor_t wm_csr_row_ptr_tensor,
             wholememory_tensor_t wm_csr_col_ptr_tensor,
@@ -1832,6 +2201,66 @@ cdef extern from "wholememory/wholegraph_op.h":
             wholememory_env_func_t * p_env_fns,
             void * stream)
 
+    cdef wholememory_error_code_t wholegraph_csr_unweighted_sample_with_replacement(
+            wholememory_tensor_t wm_csr_row_ptr_tensor,
+            wholememory_tensor_t wm_csr_col_ptr_tensor,
+            wholememory_tensor_t center_nodes_tensor,
+            int max_sample_count,
+            wholememory_tensor_t center_fanout_tensor,
+            wholememory_tensor_t output_sample_offset_tensor,
+            void * output_dest_memory_context,
+            void * output_center_localid_memory_context,
+            void * output_edge_gid_memory_context,
+            unsigned long long random_seed,
+            wholememory_env_func_t * p_env_fns,
+            void * stream)
+
+    cdef wholememory_error_code_t wholegraph_csr_weighted_sample_with_replacement(
+            wholememory_tensor_t wm_csr_row_ptr_tensor,
+            wholememory_tensor_t wm_csr_col_ptr_tensor,
+            wholememory_tensor_t wm_csr_weight_ptr_tensor,
+            wholememory_tensor_t center_nodes_tensor,
+            int max_sample_count,
+            wholememory_tensor_t center_fanout_tensor,
+            wholememory_tensor_t output_sample_offset_tensor,
+            void * output_dest_memory_context,
+            void * output_center_localid_memory_context,
+            void * output_edge_gid_memory_context,
+            unsigned long long random_seed,
+            wholememory_env_func_t * p_env_fns,
+            void * stream)
+
+    cdef wholememory_error_code_t wholegraph_csr_temporal_sample(
+            wholememory_tensor_t wm_csr_row_ptr_tensor,
+            wholememory_tensor_t wm_csr_col_ptr_tensor,
+            wholememory_tensor_t wm_edge_timestamp_tensor,
+            wholememory_tensor_t center_nodes_tensor,
+            wholememory_tensor_t center_timestamps_tensor,
+            int max_sample_count,
+            wholegraph_temporal_sample_mode_t sample_mode,
+            wholememory_tensor_t output_sample_offset_tensor,
+            void * output_dest_memory_context,
+            void * output_center_localid_memory_context,
+            void * output_edge_gid_memory_context,
+            unsigned long long random_seed,
+            wholememory_env_func_t * p_env_fns,
+            void * stream)
+
+    cdef wholememory_error_code_t wholegraph_csr_random_walk(
+            wholememory_tensor_t wm_csr_row_ptr_tensor,
+            wholememory_tensor_t wm_csr_col_ptr_tensor,
+            wholememory_tensor_t wm_csr_weight_ptr_tensor,
+            wholememory_tensor_t start_nodes_tensor,
+            int walk_length,
+            float p,
+            float q,
+            float restart_probability,
+            wholememory_tensor_t output_walks_tensor,
+            wholememory_tensor_t output_restart_count_tensor,
+            unsigned long long random_seed,
+            wholememory_env_func_t * p_env_fns,
+            void * stream)
+
     cdef wholememory_error_code_t generate_random_positive_int_cpu(
             int64_t random_seed,
             int64_t subsequence,
@@ -1868,6 +2297,47 @@ cpdef void csr_unweighted_sample_without_replacement(
         <wholememory_env_func_t *> p_env_fns_int,
         <void *> stream_int))
 
+cpdef void csr_unweighted_multilayer_sample_without_replacement(
+        PyWholeMemoryTensor wm_csr_row_ptr_tensor,
+        PyWholeMemoryTensor wm_csr_col_ptr_tensor,
+        WrappedLocalTensor center_nodes_tensor,
+        max_sample_counts,
+        output_target_nodes_memory_handles,
+        output_csr_row_ptr_memory_handles,
+        output_edge_indice_memory_handles,
+        unsigned long long random_seed,
+        int64_t p_env_fns_int,
+        int64_t stream_int
+):
+    cdef int hop_count = len(max_sample_counts)
+    cdef int i
+    assert len(output_target_nodes_memory_handles) == hop_count
+    assert len(output_csr_row_ptr_memory_handles) == hop_count
+    assert len(output_edge_indice_memory_handles) == hop_count
+    cdef int * c_max_sample_counts = <int *> stdlib.malloc(hop_count * sizeof(int))
+    cdef void ** c_memory_contexts = <void **> stdlib.malloc(3 * hop_count * sizeof(void *))
+    try:
+        for i in range(hop_count):
+            c_max_sample_counts[i] = max_sample_counts[i]
+            c_memory_contexts[i] = <void *> <int64_t> output_target_nodes_memory_handles[i]
+            c_memory_contexts[hop_count + i] = <void *> <int64_t> output_csr_row_ptr_memory_handles[i]
+            c_memory_contexts[2 * hop_count + i] = <void *> <int64_t> output_edge_indice_memory_handles[i]
+        check_wholememory_error_code(wholegraph_csr_unweighted_multilayer_sample_without_replacement(
+            <wholememory_tensor_t> <int64_t> wm_csr_row_ptr_tensor.get_c_handle(),
+            <wholememory_tensor_t> <int64_t> wm_csr_col_ptr_tensor.get_c_handle(),
+            <wholememory_tensor_t> <int64_t> center_nodes_tensor.get_c_handle(),
+            c_max_sample_counts,
+            hop_count,
+            c_memory_contexts,
+            c_memory_contexts + hop_count,
+            c_memory_contexts + 2 * hop_count,
+            random_seed,
+            <wholememory_env_func_t *> p_env_fns_int,
+            <void *> stream_int))
+    finally:
+        stdlib.free(c_max_sample_counts)
+        stdlib.free(c_memory_contexts)
+
 cpdef void csr_weighted_sample_without_replacement(
         PyWholeMemoryTensor wm_csr_row_ptr_tensor,
         PyWholeMemoryTensor wm_csr_col_ptr_tensor,
@@ -1896,6 +2366,133 @@ cpdef void csr_weighted_sample_without_replacement(
         <wholememory_env_func_t *> p_env_fns_int,
         <void *> stream_int))
 
+cpdef void csr_unweighted_sample_with_replacement(
+        PyWholeMemoryTensor wm_csr_row_ptr_tensor,
+        PyWholeMemoryTensor wm_csr_col_ptr_tensor,
+        WrappedLocalTensor center_nodes_tensor,
+        int max_sample_count,
+        WrappedLocalTensor center_fanout_tensor,
+        WrappedLocalTensor output_sample_offset_tensor,
+        int64_t output_dest_memory_handle,
+        int64_t output_center_localid_memory_handle,
+        int64_t output_edge_gid_memory_handle,
+        unsigned long long random_seed,
+        int64_t p_env_fns_int,
+        int64_t stream_int
+):
+    check_wholememory_error_code(wholegraph_csr_unweighted_sample_with_replacement(
+        <wholememory_tensor_t> <int64_t> wm_csr_row_ptr_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> wm_csr_col_ptr_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> center_nodes_tensor.get_c_handle(),
+        max_sample_count,
+        <wholememory_tensor_t> <int64_t> center_fanout_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> output_sample_offset_tensor.get_c_handle(),
+        <void *> output_dest_memory_handle,
+        <void *> output_center_localid_memory_handle,
+        <void *> output_edge_gid_memory_handle,
+        random_seed,
+        <wholememory_env_func_t *> p_env_fns_int,
+        <void *> stream_int))
+
+cpdef void csr_weighted_sample_with_replacement(
+        PyWholeMemoryTensor wm_csr_row_ptr_tensor,
+        PyWholeMemoryTensor wm_csr_col_ptr_tensor,
+        PyWholeMemoryTensor wm_csr_weight_ptr_tensor,
+        WrappedLocalTensor center_nodes_tensor,
+        int max_sample_count,
+        WrappedLocalTensor center_fanout_tensor,
+        WrappedLocalTensor output_sample_offset_tensor,
+        int64_t output_dest_memory_handle,
+        int64_t output_center_localid_memory_handle,
+        int64_t output_edge_gid_memory_handle,
+        unsigned long long random_seed,
+        int64_t p_env_fns_int,
+        int64_t stream_int
+):
+    check_wholememory_error_code(wholegraph_csr_weighted_sample_with_replacement(
+        <wholememory_tensor_t> <int64_t> wm_csr_row_ptr_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> wm_csr_col_ptr_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> wm_csr_weight_ptr_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> center_nodes_tensor.get_c_handle(),
+        max_sample_count,
+        <wholememory_tensor_t> <int64_t> center_fanout_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> output_sample_offset_tensor.get_c_handle(),
+        <void *> output_dest_memory_handle,
+        <void *> output_center_localid_memory_handle,
+        <void *> output_edge_gid_memory_handle,
+        random_seed,
+        <wholememory_env_func_t *> p_env_fns_int,
+        <void *> stream_int))
+
+cpdef void csr_temporal_sample(
+        PyWholeMemoryTensor wm_csr_row_ptr_tensor,
+        PyWholeMemoryTensor wm_csr_col_ptr_tensor,
+        PyWholeMemoryTensor wm_edge_timestamp_tensor,
+        WrappedLocalTensor center_nodes_tensor,
+        WrappedLocalTensor center_timestamps_tensor,
+        int max_sample_count,
+        bool sample_latest,
+        WrappedLocalTensor output_sample_offset_tensor,
+        int64_t output_dest_memory_handle,
+        int64_t output_center_localid_memory_handle,
+        int64_t output_edge_gid_memory_handle,
+        unsigned long long random_seed,
+        int64_t p_env_fns_int,
+        int64_t stream_int
+):
+    cdef wholegraph_temporal_sample_mode_t sample_mode = WHOLEGRAPH_TSM_UNIFORM
+    if sample_latest:
+        sample_mode = WHOLEGRAPH_TSM_LATEST
+    check_wholememory_error_code(wholegraph_csr_temporal_sample(
+        <wholememory_tensor_t> <int64_t> wm_csr_row_ptr_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> wm_csr_col_ptr_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> wm_edge_timestamp_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> center_nodes_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> center_timestamps_tensor.get_c_handle(),
+        max_sample_count,
+        sample_mode,
+        <wholememory_tensor_t> <int64_t> output_sample_offset_tensor.get_c_handle(),
+        <void *> output_dest_memory_handle,
+        <void *> output_center_localid_memory_handle,
+        <void *> output_edge_gid_memory_handle,
+        random_seed,
+        <wholememory_env_func_t *> p_env_fns_int,
+        <void *> stream_int))
+
+cpdef void csr_random_walk(
+        PyWholeMemoryTensor wm_csr_row_ptr_tensor,
+        PyWholeMemoryTensor wm_csr_col_ptr_tensor,
+        PyWholeMemoryTensor wm_csr_weight_ptr_tensor,
+        WrappedLocalTensor start_nodes_tensor,
+        int walk_length,
+        float p,
+        float q,
+        float restart_probability,
+        WrappedLocalTensor output_walks_tensor,
+        WrappedLocalTensor output_restart_count_tensor,
+        unsigned long long random_seed,
+        int64_t p_env_fns_int,
+        int64_t stream_int
+):
+    # wm_csr_weight_ptr_tensor is None for unweighted walk.
+    cdef int64_t csr_weight_ptr_handle = 0
+    if wm_csr_weight_ptr_tensor is not None:
+        csr_weight_ptr_handle = wm_csr_weight_ptr_tensor.get_c_handle()
+    check_wholememory_error_code(wholegraph_csr_random_walk(
+        <wholememory_tensor_t> <int64_t> wm_csr_row_ptr_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> wm_csr_col_ptr_tensor.get_c_handle(),
+        <wholememory_tensor_t> csr_weight_ptr_handle,
+        <wholememory_tensor_t> <int64_t> start_nodes_tensor.get_c_handle(),
+        walk_length,
+        p,
+        q,
+        restart_probability,
+        <wholememory_tensor_t> <int64_t> output_walks_tensor.get_c_handle(),
+        <wholememory_tensor_t> <int64_t> output_restart_count_tensor.get_c_handle(),
+        random_seed,
+        <wholememory_env_func_t *> p_env_fns_int,
+        <void *> stream_int))
+
 cpdef void host_generate_random_positive_int(
         int64_t random_seed,
         int64_t subsequence,
@@ -0,0 +1,65 @@
+# Copyright (c) 2019-2023, NVIDIA CORPORATION.
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import pylibwholegraph.binding.wholememory_binding as wmb
+import pylibwholegraph.torch as wgth
+from pylibwholegraph.utils.multiprocess import multiprocess_run
+import torch
+import torch.distributed as dist
+
+
+# Run with:
+# python3 -m pytest ../tests/pylibwholegraph/test_wholememory_host_comm.py -s
+
+
+def check_host_comm(wm_comm, world_rank: int, world_size: int):
+    assert wm_comm.get_comm_backend() == wmb.WholeMemoryCommBackend.CbHost
+    assert wm_comm.get_rank() == world_rank
+    assert wm_comm.get_size() == world_size
+    wm_comm.barrier()
+    assert len(wm_comm.get_rank_memory_usage()) == world_size
+
+
+def routine_func(world_rank: int, world_size: int):
+    os.environ["MASTER_ADDR"] = "localhost"
+    os.environ.setdefault("MASTER_PORT", "12335")
+    # host communicator needs no GPU, so unique id is broadcast by gloo.
+    dist.init_process_group(
+        backend="gloo", init_method="env://", rank=world_rank, world_size=world_size
+    )
+    wmb.init(0)
+
+    wm_comm = wgth.create_group_communicator(comm_backend="host")
+    assert wm_comm.comm_backend == "host"
+    check_host_comm(wm_comm.wmb_comm, world_rank, world_size)
+    wgth.destroy_communicator(wm_comm)
+
+    # unique id may be created by any rank, the creator publishes addresses of all ranks.
+    for creator_rank in [world_size - 1, 0, 1, world_size - 1]:
+        if world_rank == creator_rank:
+            wm_uid = wmb.create_unique_id(wmb.WholeMemoryCommBackend.CbHost)
+        else:
+            wm_uid = wmb.PyWholeMemoryUniqueID()
+        uid_th = torch.utils.dlpack.from_dlpack(wm_uid.__dlpack__())
+        dist.broadcast(uid_th, creator_rank)
+        wm_comm = wmb.create_communicator(wm_uid, world_rank, world_size)
+        check_host_comm(wm_comm, world_rank, world_size)
+        wmb.destroy_communicator(wm_comm)
+
+    wmb.finalize()
+    dist.destroy_process_group()
+
+
+def test_host_communicator():
+    multiprocess_run(3, routine_func)
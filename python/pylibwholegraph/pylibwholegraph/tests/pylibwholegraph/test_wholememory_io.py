@@ -13,13 +13,16 @@
 
 import pytest
 import pylibwholegraph.binding.wholememory_binding as wmb
+import pylibwholegraph.torch as wgth
 from pylibwholegraph.utils.multiprocess import multiprocess_run
 from pylibwholegraph.torch.initialize import init_torch_env_and_create_wm_comm
 from pylibwholegraph.torch.dlpack_utils import torch_import_from_dlpack
+from pylibwholegraph.torch.utils import torch_dtype_to_wholememory_dtype
 import torch
 import numpy as np
 import os
 import random
+import zlib
 from functools import partial
 
 
@@ -55,7 +58,9 @@ def load_routine_func(
     embedding_dim,
     embedding_stride,
     storage_offset,
+    load_thread_count,
 ):
+    os.environ["WHOLEMEMORY_LOAD_THREAD_COUNT"] = str(load_thread_count)
     wm_comm, _ = init_torch_env_and_create_wm_comm(
         world_rank, world_size, world_rank, world_size
     )
@@ -122,12 +127,14 @@ def load_routine_func(
 @pytest.mark.parametrize("embedding_dim", [16, 31, 33])
 @pytest.mark.parametrize("embedding_stride", [16, 32, 64])
 @pytest.mark.parametrize("storage_offset", [0, 3])
+@pytest.mark.parametrize("load_thread_count", [1, 4])
 def test_wholememory_load(
     file_part_count,
     embedding_entry_count,
     embedding_dim,
     embedding_stride,
     storage_offset,
+    load_thread_count,
 ):
     if embedding_stride < storage_offset + embedding_dim:
         pytest.skip(
@@ -165,6 +172,7 @@ def test_wholememory_load(
         embedding_dim=embedding_dim,
         embedding_stride=embedding_stride,
         storage_offset=storage_offset,
+        load_thread_count=load_thread_count,
     )
 
     global gpu_count
@@ -176,6 +184,181 @@ def test_wholememory_load(
         os.remove(filename)
 
 
+def file_mapped_routine_func(
+    world_rank: int,
+    world_size: int,
+    file_list,
+    reference_data,
+):
+    (wm_comm, _) = init_torch_env_and_create_wm_comm(
+        world_rank, world_size, world_rank, world_size
+    )
+    embedding_dim = reference_data.shape[1]
+    wm_tensor = wgth.create_wholememory_tensor_from_filelist(
+        wm_comm, "continuous", "file", file_list, torch.float32, embedding_dim
+    )
+    assert wm_tensor.shape[0] == reference_data.shape[0]
+    assert wm_tensor.shape[1] == embedding_dim
+    torch.manual_seed(world_rank)
+    indice = torch.randint(0, reference_data.shape[0], (10000,), device="cuda")
+    gathered = wm_tensor.gather(indice)
+    assert torch.equal(gathered.cpu(), torch.from_numpy(reference_data)[indice.cpu()])
+    # files are mapped read only without write back, scatter should be rejected.
+    with pytest.raises(ValueError):
+        wm_tensor.scatter(torch.zeros_like(gathered), indice)
+    with pytest.raises(ValueError):
+        wm_tensor.scatter(torch.zeros_like(gathered).cpu(), indice.cpu())
+    with pytest.raises(ValueError):
+        wm_tensor.from_filelist(file_list)
+    wgth.destroy_wholememory_tensor(wm_tensor)
+    wmb.finalize()
+
+
+@pytest.mark.parametrize("embedding_dim", [16, 31])
+def test_wholememory_file_mapped_gather(embedding_dim):
+    global gpu_count
+    page_size = os.sysconf("SC_PAGE_SIZE")
+    # all files except the last one should be multiple of page size
+    first_file_rows = page_size * 8 // np.gcd(page_size, embedding_dim * 4)
+    reference_data = np.random.rand(first_file_rows + 1234, embedding_dim).astype(
+        np.float32
+    )
+    file_list = ["pytest_file_mapped_temp_file_%d" % (i,) for i in range(2)]
+    reference_data[:first_file_rows].tofile(file_list[0])
+    reference_data[first_file_rows:].tofile(file_list[1])
+    multiprocess_run(
+        gpu_count,
+        partial(
+            file_mapped_routine_func,
+            file_list=file_list,
+            reference_data=reference_data,
+        ),
+    )
+    # files are mapped read only and should not be changed.
+    mapped_data = np.concatenate(
+        [np.fromfile(f, dtype=np.float32) for f in file_list]
+    ).reshape(-1, embedding_dim)
+    assert np.array_equal(mapped_data, reference_data)
+    for filename in file_list:
+        os.remove(filename)
+
+
+def load_conversion_routine_func(
+    world_rank: int,
+    world_size: int,
+    cpu_embedding_tensor_base,
+    file_name_prefix,
+    file_part_count,
+    embedding_entry_count,
+    file_dim,
+    column_start,
+    column_count,
+    memory_dtype,
+):
+    wm_comm, _ = init_torch_env_and_create_wm_comm(
+        world_rank, world_size, world_rank, world_size
+    )
+    wm_comm = wm_comm.wmb_comm
+    file_list = [
+        "%s_part_%d_of_%d" % (file_name_prefix, i, file_part_count)
+        for i in range(file_part_count)
+    ]
+
+    per_rank_entry = wmb.determine_partition_plan(embedding_entry_count, world_size)
+    rank_start_entry = min(per_rank_entry * world_rank, embedding_entry_count)
+    rank_end_entry = min(per_rank_entry * (world_rank + 1), embedding_entry_count)
+    reference_local_tensor = (
+        cpu_embedding_tensor_base[
+            rank_start_entry:rank_end_entry, column_start:column_start + column_count
+        ]
+        .to(memory_dtype)
+        .cuda()
+    )
+
+    for mt in [
+        wmb.WholeMemoryMemoryType.MtContinuous,
+        wmb.WholeMemoryMemoryType.MtChunked,
+        wmb.WholeMemoryMemoryType.MtDistributed,
+    ]:
+        for ml in [
+            wmb.WholeMemoryMemoryLocation.MlHost,
+            wmb.WholeMemoryMemoryLocation.MlDevice,
+        ]:
+            if not wm_comm.support_type_location(mt, ml):
+                continue
+            wholememory_tensor = wmb.create_wholememory_matrix(
+                torch_dtype_to_wholememory_dtype(memory_dtype),
+                embedding_entry_count,
+                column_count,
+                -1,
+                wm_comm,
+                mt,
+                ml,
+            )
+            wholememory_tensor.from_filelist(
+                file_list, wmb.WholeMemoryDataType.DtFloat, file_dim, column_start
+            )
+            local_tensor, local_offset = wholememory_tensor.get_local_tensor(
+                torch_import_from_dlpack,
+                wmb.WholeMemoryMemoryLocation.MlDevice,
+                world_rank,
+            )
+            assert local_tensor.dtype == memory_dtype
+            assert torch.equal(local_tensor, reference_local_tensor)
+            wmb.destroy_wholememory_tensor(wholememory_tensor)
+
+    wmb.finalize()
+
+
+@pytest.mark.parametrize("file_part_count", [3])
+@pytest.mark.parametrize("embedding_entry_count", [1024 * 1024 + 131])
+@pytest.mark.parametrize("file_dim", [32])
+@pytest.mark.parametrize("column_start,column_count", [(0, 32), (5, 17)])
+@pytest.mark.parametrize(
+    "memory_dtype", [torch.float32, torch.float16, torch.bfloat16]
+)
+def test_wholememory_load_with_conversion(
+    file_part_count,
+    embedding_entry_count,
+    file_dim,
+    column_start,
+    column_count,
+    memory_dtype,
+):
+    cpu_embedding_tensor_base = torch.randn(
+        (embedding_entry_count, file_dim), dtype=torch.float32, device="cpu"
+    )
+    counts = [embedding_entry_count // file_part_count] * file_part_count
+    counts[-1] += embedding_entry_count - sum(counts)
+    splited_tensors = torch.split(cpu_embedding_tensor_base, counts, dim=0)
+    file_name_prefix = "pytest_load_conversion_temp_file"
+    for i in range(file_part_count):
+        splited_tensors[i].numpy().tofile(
+            "%s_part_%d_of_%d" % (file_name_prefix, i, file_part_count)
+        )
+
+    cpu_embedding_tensor_base = cpu_embedding_tensor_base.share_memory_()
+
+    global gpu_count
+    multiprocess_run(
+        gpu_count,
+        partial(
+            load_conversion_routine_func,
+            cpu_embedding_tensor_base=cpu_embedding_tensor_base,
+            file_name_prefix=file_name_prefix,
+            file_part_count=file_part_count,
+            embedding_entry_count=embedding_entry_count,
+            file_dim=file_dim,
+            column_start=column_start,
+            column_count=column_count,
+            memory_dtype=memory_dtype,
+        ),
+    )
+
+    for i in range(file_part_count):
+        os.remove("%s_part_%d_of_%d" % (file_name_prefix, i, file_part_count))
+
+
 def store_routine_func(
     world_rank: int,
     world_size: int,
@@ -276,3 +459,540 @@ def test_wholememory_store(
         embedding_entry_offset += file_entry_count
         os.remove(filename)
     assert embedding_entry_offset == embedding_entry_count
+
+
+@pytest.mark.parametrize("embedding_entry_count", [1024 * 1024 * 4 + 131])
+@pytest.mark.parametrize("embedding_dim", [16, 31])
+def test_wholememory_direct_io(monkeypatch, embedding_entry_count, embedding_dim):
+    # host memory with same entry size and stride is read and written with O_DIRECT, file systems
+    # rejecting it fall back to buffered I/O.
+    monkeypatch.setenv("WHOLEMEMORY_USE_DIRECT_IO", "1")
+    test_wholememory_store(embedding_entry_count, embedding_dim, embedding_dim, 0)
+    test_wholememory_load(3, embedding_entry_count, embedding_dim, embedding_dim, 0, 4)
+
+
+def checkpoint_routine_func(
+    world_rank: int,
+    world_size: int,
+    checkpoint_prefix,
+    embedding_entry_count,
+    embedding_dim,
+    is_store,
+    verify_checksum,
+):
+    (wm_comm, _) = init_torch_env_and_create_wm_comm(
+        world_rank, world_size, world_rank, world_size
+    )
+    wm_comm = wm_comm.wmb_comm
+    data_type = wmb.WholeMemoryDataType.DtInt
+    mt = wmb.WholeMemoryMemoryType.MtContinuous
+    ml = wmb.WholeMemoryMemoryLocation.MlHost
+
+    wholememory_tensor = wmb.create_wholememory_matrix(
+        data_type,
+        embedding_entry_count,
+        embedding_dim,
+        embedding_dim,
+        wm_comm,
+        mt,
+        ml,
+    )
+    local_tensor, local_offset = wholememory_tensor.get_local_tensor(
+        torch_import_from_dlpack, wmb.WholeMemoryMemoryLocation.MlHost, world_rank
+    )
+    reference_tensor = torch.IntTensor(
+        range(
+            embedding_dim * local_offset,
+            embedding_dim * (local_offset + local_tensor.shape[0]),
+        )
+    ).reshape((-1, embedding_dim))
+    if is_store:
+        local_tensor.copy_(reference_tensor)
+        wholememory_tensor.to_checkpoint(checkpoint_prefix)
+    else:
+        wholememory_tensor.from_checkpoint(checkpoint_prefix, verify_checksum)
+        assert torch.equal(local_tensor, reference_tensor)
+
+    wmb.finalize()
+
+
+@pytest.mark.parametrize("embedding_entry_count", [1024 * 1024 + 131])
+@pytest.mark.parametrize("embedding_dim", [16, 33])
+@pytest.mark.parametrize("verify_checksum", [False, True])
+def test_wholememory_checkpoint(embedding_entry_count, embedding_dim, verify_checksum):
+    checkpoint_prefix = "pytest_checkpoint_temp_file"
+    global gpu_count
+    store_world_size = gpu_count
+    load_world_size = 1 if gpu_count > 1 else gpu_count
+    multiprocess_run(
+        store_world_size,
+        partial(
+            checkpoint_routine_func,
+            checkpoint_prefix=checkpoint_prefix,
+            embedding_entry_count=embedding_entry_count,
+            embedding_dim=embedding_dim,
+            is_store=True,
+            verify_checksum=verify_checksum,
+        ),
+    )
+
+    meta_file_name = "%s_meta" % (checkpoint_prefix,)
+    assert os.path.isfile(meta_file_name)
+    with open(meta_file_name, "r") as f:
+        meta_lines = f.read().splitlines()
+    part_lines = [line.split() for line in meta_lines if line.startswith("part ")]
+    assert len(part_lines) == store_world_size
+    total_rows = 0
+    for i, part_line in enumerate(part_lines):
+        filename = "%s_part_%d_of_%d" % (checkpoint_prefix, i, store_world_size)
+        assert int(part_line[1]) == i
+        assert int(part_line[2]) == total_rows
+        total_rows += int(part_line[3])
+        with open(filename, "rb") as f:
+            assert zlib.crc32(f.read()) == int(part_line[4], 16)
+    assert total_rows == embedding_entry_count
+
+    multiprocess_run(
+        load_world_size,
+        partial(
+            checkpoint_routine_func,
+            checkpoint_prefix=checkpoint_prefix,
+            embedding_entry_count=embedding_entry_count,
+            embedding_dim=embedding_dim,
+            is_store=False,
+            verify_checksum=verify_checksum,
+        ),
+    )
+
+    os.remove(meta_file_name)
+    for i in range(store_world_size):
+        os.remove("%s_part_%d_of_%d" % (checkpoint_prefix, i, store_world_size))
+
+
+def checkpoint_store_failure_routine_func(
+    world_rank: int,
+    world_size: int,
+    checkpoint_prefix,
+    embedding_entry_count,
+    embedding_dim,
+):
+    (wm_comm, _) = init_torch_env_and_create_wm_comm(
+        world_rank, world_size, world_rank, world_size
+    )
+    wm_comm = wm_comm.wmb_comm
+    wholememory_tensor = wmb.create_wholememory_matrix(
+        wmb.WholeMemoryDataType.DtInt,
+        embedding_entry_count,
+        embedding_dim,
+        embedding_dim,
+        wm_comm,
+        wmb.WholeMemoryMemoryType.MtContinuous,
+        wmb.WholeMemoryMemoryLocation.MlHost,
+    )
+    # failure on a single rank should be reported by all ranks instead of hanging.
+    with pytest.raises(RuntimeError):
+        wholememory_tensor.to_checkpoint(checkpoint_prefix)
+    wm_comm.barrier()
+
+    wmb.finalize()
+
+
+@pytest.mark.parametrize("failed_file", ["part", "meta"])
+def test_wholememory_checkpoint_store_failure(failed_file):
+    checkpoint_prefix = "pytest_checkpoint_failure_temp_file"
+    global gpu_count
+    if failed_file == "part":
+        # only the last rank fails to open its part file.
+        blocked_file_name = "%s_part_%d_of_%d" % (
+            checkpoint_prefix,
+            gpu_count - 1,
+            gpu_count,
+        )
+    else:
+        # only rank 0 writes the meta file.
+        blocked_file_name = "%s_meta.tmp" % (checkpoint_prefix,)
+    os.mkdir(blocked_file_name)
+    try:
+        multiprocess_run(
+            gpu_count,
+            partial(
+                checkpoint_store_failure_routine_func,
+                checkpoint_prefix=checkpoint_prefix,
+                embedding_entry_count=1024 * 1024 + 131,
+                embedding_dim=16,
+            ),
+        )
+        assert not os.path.exists("%s_meta" % (checkpoint_prefix,))
+    finally:
+        os.rmdir(blocked_file_name)
+        for i in range(gpu_count):
+            part_file_name = "%s_part_%d_of_%d" % (checkpoint_prefix, i, gpu_count)
+            if os.path.isfile(part_file_name):
+                os.remove(part_file_name)
+
+
+def write_embedding_delta_file(filename, total_row_count, row_ids, tensor_rows):
+    with open(filename, "wb") as f:
+        f.write(b"WMDELTA1")
+        np.array([total_row_count, len(row_ids)], dtype=np.int64).tofile(f)
+        np.array([len(tensor_rows)], dtype=np.int32).tofile(f)
+        for name, rows in tensor_rows:
+            np.array([len(name)], dtype=np.int32).tofile(f)
+            f.write(name.encode())
+            np.array([rows.shape[1] * 4], dtype=np.int64).tofile(f)
+        np.array(row_ids, dtype=np.int64).tofile(f)
+        for _, rows in tensor_rows:
+            rows.astype(np.float32).tofile(f)
+
+
+@pytest.mark.parametrize("delta_part_count", [1, 3])
+def test_embedding_checkpoint_compaction(delta_part_count):
+    from pylibwholegraph.torch.embedding import compact_embedding_checkpoint
+
+    base_prefix = "pytest_compaction_base"
+    delta_prefixes = ["pytest_compaction_delta0", "pytest_compaction_delta1"]
+    output_prefix = "pytest_compaction_output"
+    total_row_count, embedding_dim, base_part_count = 1000, 7, 2
+    tensor_dims = {"embedding_tensor": embedding_dim, "m": embedding_dim, "v": 1}
+    rng = np.random.default_rng(0)
+    reference = {}
+    for name, dim in tensor_dims.items():
+        data = rng.random((total_row_count, dim), dtype=np.float32)
+        reference[name] = data.copy()
+        part_rows = np.array_split(data, base_part_count)
+        for part_id in range(base_part_count):
+            part_rows[part_id].tofile(
+                "%s_%s_part_%d_of_%d" % (base_prefix, name, part_id, base_part_count)
+            )
+    for delta_prefix in delta_prefixes:
+        updated_rows = np.sort(rng.choice(total_row_count, 100, replace=False))
+        delta_rows = {
+            name: rng.random((len(updated_rows), dim), dtype=np.float32)
+            for name, dim in tensor_dims.items()
+        }
+        for name in tensor_dims:
+            reference[name][updated_rows] = delta_rows[name]
+        row_splits = np.array_split(np.arange(len(updated_rows)), delta_part_count)
+        for part_id, split in enumerate(row_splits):
+            write_embedding_delta_file(
+                "%s_delta_part_%d_of_%d" % (delta_prefix, part_id, delta_part_count),
+                total_row_count,
+                updated_rows[split],
+                [(name, delta_rows[name][split]) for name in tensor_dims],
+            )
+
+    compact_embedding_checkpoint(base_prefix, delta_prefixes, output_prefix)
+
+    for name, dim in tensor_dims.items():
+        output_files = [
+            "%s_%s_part_%d_of_%d" % (output_prefix, name, part_id, base_part_count)
+            for part_id in range(base_part_count)
+        ]
+        merged = np.concatenate(
+            [np.fromfile(f, dtype=np.float32).reshape(-1, dim) for f in output_files]
+        )
+        assert np.array_equal(merged, reference[name])
+        for part_id in range(base_part_count):
+            os.remove(output_files[part_id])
+            os.remove("%s_%s_part_%d_of_%d" % (base_prefix, name, part_id, base_part_count))
+    for delta_prefix in delta_prefixes:
+        for part_id in range(delta_part_count):
+            os.remove("%s_delta_part_%d_of_%d" % (delta_prefix, part_id, delta_part_count))
+
+
+def embedding_delta_routine_func(
+    world_rank: int,
+    world_size: int,
+    file_name_prefix,
+    embedding_entry_count,
+    embedding_dim,
+):
+    from pylibwholegraph.torch.embedding import compact_embedding_checkpoint
+    from pylibwholegraph.torch.utils import get_part_file_list
+
+    (wm_comm, _) = init_torch_env_and_create_wm_comm(
+        world_rank, world_size, world_rank, world_size
+    )
+    wm_optimizer = wgth.create_wholememory_optimizer("adam", {})
+    wm_embedding = wgth.create_embedding(
+        wm_comm,
+        "continuous",
+        "cuda",
+        torch.float32,
+        [embedding_entry_count, embedding_dim],
+        optimizer=wm_optimizer,
+    )
+    base_prefix = file_name_prefix + "_base"
+    delta_prefix = file_name_prefix + "_delta0"
+    reference_prefix = file_name_prefix + "_reference"
+    output_prefix = file_name_prefix + "_output"
+    snapshot_prefix = file_name_prefix + "_snapshot"
+    local_tensor, local_offset = wm_embedding.get_embedding_tensor().get_local_tensor()
+    local_tensor.copy_(
+        torch.arange(
+            local_offset * embedding_dim,
+            (local_offset + local_tensor.shape[0]) * embedding_dim,
+            dtype=torch.float32,
+        ).reshape((-1, embedding_dim))
+    )
+    wm_embedding.save(base_prefix)
+
+    # update a few rows by optimizer, only these rows should be in delta files.
+    torch.manual_seed(world_rank)
+    indice = torch.randint(0, embedding_entry_count, (1000,), device="cuda")
+    grads = torch.rand((indice.shape[0], embedding_dim), device="cuda")
+    wm_embedding.add_gradients(indice, grads)
+    wm_embedding.need_apply = True
+    wm_optimizer.step(0.1)
+    # snapshot doesn't mark rows clean, updated rows should still be in delta files.
+    snapshot = wm_embedding.save_async(snapshot_prefix)
+    snapshot.wait()
+    # save failed on one rank fails on all ranks and keeps rows dirty for next save.
+    blocked_file_name = "%s_delta_part_%d_of_%d" % (
+        delta_prefix,
+        world_size - 1,
+        world_size,
+    )
+    if world_rank == world_size - 1:
+        os.mkdir(blocked_file_name)
+    wm_comm.barrier()
+    with pytest.raises(RuntimeError):
+        wm_embedding.save_delta(delta_prefix)
+    if world_rank == world_size - 1:
+        os.rmdir(blocked_file_name)
+    wm_comm.barrier()
+    wm_embedding.save_delta(delta_prefix)
+    wm_embedding.save(reference_prefix)
+    wm_comm.barrier()
+
+    tensor_names = ["embedding_tensor"] + list(wm_embedding.get_optimizer_state_names())
+    if world_rank == 0:
+        compact_embedding_checkpoint(base_prefix, [delta_prefix], output_prefix)
+        for name in tensor_names:
+            output_data, reference_data, base_data, snapshot_data = [
+                np.concatenate(
+                    [
+                        np.fromfile(f, dtype=np.uint8)
+                        for f in get_part_file_list(prefix + "_" + name, world_size)
+                    ]
+                )
+                for prefix in [
+                    output_prefix,
+                    reference_prefix,
+                    base_prefix,
+                    snapshot_prefix,
+                ]
+            ]
+            assert np.array_equal(output_data, reference_data)
+            assert np.array_equal(snapshot_data, reference_data)
+            if name == "embedding_tensor":
+                assert not np.array_equal(base_data, reference_data)
+        for prefix in [base_prefix, reference_prefix, output_prefix, snapshot_prefix]:
+            for name in tensor_names:
+                for f in get_part_file_list(prefix + "_" + name, world_size):
+                    os.remove(f)
+        for f in get_part_file_list(delta_prefix + "_delta", world_size):
+            os.remove(f)
+    wm_comm.barrier()
+
+    wgth.destroy_embedding(wm_embedding)
+    wgth.destroy_wholememory_optimizer(wm_optimizer)
+    wmb.finalize()
+
+
+@pytest.mark.parametrize("embedding_entry_count", [1024 * 128 + 17])
+@pytest.mark.parametrize("embedding_dim", [16, 31])
+def test_embedding_save_delta_and_compaction(embedding_entry_count, embedding_dim):
+    global gpu_count
+    multiprocess_run(
+        gpu_count,
+        partial(
+            embedding_delta_routine_func,
+            file_name_prefix="pytest_delta_temp_file",
+            embedding_entry_count=embedding_entry_count,
+            embedding_dim=embedding_dim,
+        ),
+    )
+
+
+def optimizer_state_init_routine_func(
+    world_rank: int,
+    world_size: int,
+    embedding_entry_count,
+    embedding_dim,
+    memory_location,
+):
+    (wm_comm, _) = init_torch_env_and_create_wm_comm(
+        world_rank, world_size, world_rank, world_size
+    )
+    wm_optimizer = wgth.create_wholememory_optimizer("adam", {})
+    wm_embedding = wgth.create_embedding(
+        wm_comm,
+        "continuous",
+        memory_location,
+        torch.float32,
+        [embedding_entry_count, embedding_dim],
+        optimizer=wm_optimizer,
+    )
+    # states are allocated without zero fill, so init must fill every local row once.
+    expected_values = {"m": 0.0, "v": 0.0, "beta12t": 1.0}
+    for state_name in wm_embedding.get_optimizer_state_names():
+        local_state, _ = wm_embedding.get_optimizer_state(state_name).get_local_tensor()
+        assert torch.all(local_state == expected_values[state_name])
+
+    wgth.destroy_embedding(wm_embedding)
+    wgth.destroy_wholememory_optimizer(wm_optimizer)
+    wmb.finalize()
+
+
+@pytest.mark.parametrize("embedding_entry_count", [1024 * 128 + 17])
+@pytest.mark.parametrize("embedding_dim", [16, 31])
+@pytest.mark.parametrize("memory_location", ["cpu", "cuda"])
+def test_embedding_optimizer_state_init(
+    embedding_entry_count, embedding_dim, memory_location
+):
+    global gpu_count
+    multiprocess_run(
+        gpu_count,
+        partial(
+            optimizer_state_init_routine_func,
+            embedding_entry_count=embedding_entry_count,
+            embedding_dim=embedding_dim,
+            memory_location=memory_location,
+        ),
+    )
+
+
+def embedding_snapshot_routine_func(
+    world_rank: int,
+    world_size: int,
+    file_name_prefix,
+    embedding_entry_count,
+    embedding_dim,
+    memory_location,
+):
+    (wm_comm, _) = init_torch_env_and_create_wm_comm(
+        world_rank, world_size, world_rank, world_size
+    )
+    wm_embedding = wgth.create_embedding(
+        wm_comm,
+        "continuous",
+        memory_location,
+        torch.float32,
+        [embedding_entry_count, embedding_dim],
+    )
+    local_tensor, local_offset = wm_embedding.get_embedding_tensor().get_local_tensor()
+    reference_tensor = torch.arange(
+        local_offset * embedding_dim,
+        (local_offset + local_tensor.shape[0]) * embedding_dim,
+        dtype=torch.float32,
+    ).reshape((-1, embedding_dim))
+    local_tensor.copy_(reference_tensor.cuda())
+    snapshot = wm_embedding.save_async(file_name_prefix)
+    # updates enqueued after snapshot started should not show up in files
+    local_tensor.fill_(-1.0)
+    snapshot.wait()
+    assert snapshot.is_done()
+
+    filename = "%s_embedding_tensor_part_%d_of_%d" % (
+        file_name_prefix,
+        world_rank,
+        world_size,
+    )
+    saved_tensor = torch.from_numpy(np.fromfile(filename, dtype=np.float32)).reshape(
+        (-1, embedding_dim)
+    )
+    assert torch.equal(saved_tensor, reference_tensor)
+    os.remove(filename)
+
+    wgth.destroy_embedding(wm_embedding)
+    wmb.finalize()
+
+
+@pytest.mark.parametrize("embedding_entry_count", [1024 * 1024 + 131])
+@pytest.mark.parametrize("embedding_dim", [16, 31])
+@pytest.mark.parametrize("memory_location", ["cpu", "cuda"])
+def test_embedding_async_snapshot(embedding_entry_count, embedding_dim, memory_location):
+    global gpu_count
+    multiprocess_run(
+        gpu_count,
+        partial(
+            embedding_snapshot_routine_func,
+            file_name_prefix="pytest_snapshot_temp_file",
+            embedding_entry_count=embedding_entry_count,
+            embedding_dim=embedding_dim,
+            memory_location=memory_location,
+        ),
+    )
+
+
+def compressed_csr_routine_func(
+    world_rank: int,
+    world_size: int,
+    file_name,
+    csr_row_ptr,
+    csr_col_ind,
+    memory_type,
+    memory_location,
+):
+    os.environ["WHOLEMEMORY_LOAD_THREAD_COUNT"] = "4"
+    wm_comm, _ = init_torch_env_and_create_wm_comm(
+        world_rank, world_size, world_rank, world_size
+    )
+    wm_row_ptr, wm_col_ind = wgth.load_compressed_csr(
+        wm_comm, memory_type, memory_location, file_name
+    )
+    assert wm_col_ind.dtype == csr_col_ind.dtype
+    for wm_tensor, reference_tensor in [
+        (wm_row_ptr, csr_row_ptr),
+        (wm_col_ind, csr_col_ind),
+    ]:
+        local_tensor, local_offset = wm_tensor.get_local_tensor(host_view=False)
+        reference_local_tensor = reference_tensor[
+            local_offset:local_offset + local_tensor.shape[0]
+        ].cuda()
+        assert torch.equal(local_tensor, reference_local_tensor)
+    wgth.destroy_wholememory_tensor(wm_row_ptr)
+    wgth.destroy_wholememory_tensor(wm_col_ind)
+    wmb.finalize()
+
+
+@pytest.mark.parametrize("node_count", [1024 * 1024 + 131])
+@pytest.mark.parametrize("col_ind_dtype", [torch.int32, torch.int64])
+@pytest.mark.parametrize("rows_per_block", [64, 1024])
+@pytest.mark.parametrize("memory_type", ["continuous", "chunked", "distributed"])
+@pytest.mark.parametrize("memory_location", ["cpu", "cuda"])
+def test_compressed_csr_load(
+    node_count, col_ind_dtype, rows_per_block, memory_type, memory_location
+):
+    degrees = torch.randint(0, 20, (node_count,), dtype=torch.int64)
+    degrees[torch.rand(node_count) < 0.1] = 0
+    csr_row_ptr = torch.zeros((node_count + 1,), dtype=torch.int64)
+    csr_row_ptr[1:] = torch.cumsum(degrees, dim=0)
+    edge_count = csr_row_ptr[-1].item()
+    # neighbors close to the row id like real graphs, sorted in each row.
+    src_nodes = torch.repeat_interleave(torch.arange(node_count), degrees)
+    neighbors = (src_nodes + torch.randint(-5000, 5000, (edge_count,))).clamp(
+        0, node_count - 1
+    )
+    sort_keys = src_nodes * node_count + neighbors
+    csr_col_ind = neighbors[torch.argsort(sort_keys)].to(col_ind_dtype)
+
+    file_name = "pytest_compressed_csr_temp_file"
+    wgth.save_compressed_csr(file_name, csr_row_ptr, csr_col_ind, rows_per_block)
+    raw_size = csr_row_ptr.numel() * 8 + csr_col_ind.numel() * csr_col_ind.element_size()
+    assert os.path.getsize(file_name) < raw_size
+
+    global gpu_count
+    multiprocess_run(
+        gpu_count,
+        partial(
+            compressed_csr_routine_func,
+            file_name=file_name,
+            csr_row_ptr=csr_row_ptr.share_memory_(),
+            csr_col_ind=csr_col_ind.share_memory_(),
+            memory_type=memory_type,
+            memory_location=memory_location,
+        ),
+    )
+    os.remove(file_name)
@@ -0,0 +1,113 @@
+# Copyright (c) 2019-2023, NVIDIA CORPORATION.
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import pylibwholegraph.binding.wholememory_binding as wmb
+from pylibwholegraph.utils.multiprocess import multiprocess_run
+from pylibwholegraph.torch.initialize import init_torch_env_and_create_wm_comm
+
+
+# Run with:
+# python3 -m pytest ../tests/pylibwholegraph/test_wholememory_memory_usage.py -s
+
+
+def memory_usage_test_case(wm_comm, dt, element_size, mt, ml, size):
+    world_rank = wm_comm.get_rank()
+    world_size = wm_comm.get_size()
+    print("Rank=%d testing memory usage mt=%s, ml=%s" % (world_rank, mt, ml))
+    # host memory of NCCL communicator is registered to CUDA.
+    if ml == wmb.WholeMemoryMemoryLocation.MlDevice:
+        alloc_type = wmb.WholeMemoryMemoryAllocType.MatDevice
+        other_alloc_type = wmb.WholeMemoryMemoryAllocType.MatPinned
+    else:
+        alloc_type = wmb.WholeMemoryMemoryAllocType.MatPinned
+        other_alloc_type = wmb.WholeMemoryMemoryAllocType.MatDevice
+    general = wmb.WholeMemoryMemoryPurpose.MpGeneral
+    embedding = wmb.WholeMemoryMemoryPurpose.MpEmbedding
+
+    usage_before = wmb.get_memory_usage(alloc_type, mt, general)
+    other_type_before = wmb.get_memory_usage(other_alloc_type, mt, general)
+    other_purpose_before = wmb.get_memory_usage(alloc_type, mt, embedding)
+    rank_usages_before = wm_comm.get_rank_memory_usage(alloc_type, mt, general)
+
+    wm_array = wmb.create_wholememory_array(dt, size, wm_comm, mt, ml)
+    handle = wm_array.get_wholememory_handle()
+    assert handle.get_memory_purpose() == general
+    handle_usage = handle.get_memory_usage()
+    assert handle_usage["live_count"] == 1
+    assert handle_usage["alloc_count"] == 1
+    assert handle_usage["peak_bytes"] == handle_usage["live_bytes"]
+
+    usage = wmb.get_memory_usage(alloc_type, mt, general)
+    allocated_bytes = usage["live_bytes"] - usage_before["live_bytes"]
+    assert allocated_bytes == handle_usage["live_bytes"]
+    assert usage["live_count"] - usage_before["live_count"] == 1
+    assert usage["alloc_count"] - usage_before["alloc_count"] == 1
+    assert usage["peak_bytes"] >= usage["live_bytes"]
+    assert wmb.get_memory_usage(other_alloc_type, mt, general) == other_type_before
+    assert wmb.get_memory_usage(alloc_type, mt, embedding) == other_purpose_before
+    total_usage = wmb.get_memory_usage()
+    assert total_usage["live_bytes"] >= usage["live_bytes"]
+    assert total_usage["live_count"] >= usage["live_count"]
+
+    rank_usages = wm_comm.get_rank_memory_usage(alloc_type, mt, general)
+    assert len(rank_usages) == world_size
+    assert rank_usages[world_rank] == usage
+    # every byte of the array is allocated by some rank.
+    total_allocated_bytes = sum(
+        after["live_bytes"] - before["live_bytes"]
+        for before, after in zip(rank_usages_before, rank_usages)
+    )
+    assert total_allocated_bytes >= size * element_size
+
+    wmb.destroy_wholememory_tensor(wm_array)
+
+    usage_after = wmb.get_memory_usage(alloc_type, mt, general)
+    assert usage_after["live_bytes"] == usage_before["live_bytes"]
+    assert usage_after["live_count"] == usage_before["live_count"]
+    assert usage_after["alloc_count"] == usage["alloc_count"]
+    assert usage_after["peak_bytes"] == usage["peak_bytes"]
+
+    wmb.reset_memory_usage_peak()
+    usage_reset = wmb.get_memory_usage(alloc_type, mt, general)
+    assert usage_reset["peak_bytes"] == usage_reset["live_bytes"]
+
+
+def routine_func(world_rank: int, world_size: int):
+    wm_comm, _ = init_torch_env_and_create_wm_comm(
+        world_rank, world_size, world_rank, world_size
+    )
+    wm_comm = wm_comm.wmb_comm
+
+    single_array_size = 16 * 1024 * 1024 * world_size
+    dt = wmb.WholeMemoryDataType.DtFloat
+
+    print("")
+
+    for mt in [
+        wmb.WholeMemoryMemoryType.MtContinuous,
+        wmb.WholeMemoryMemoryType.MtChunked,
+        wmb.WholeMemoryMemoryType.MtDistributed,
+    ]:
+        for ml in [
+            wmb.WholeMemoryMemoryLocation.MlHost,
+            wmb.WholeMemoryMemoryLocation.MlDevice,
+        ]:
+            if wm_comm.support_type_location(mt, ml):
+                memory_usage_test_case(wm_comm, dt, 4, mt, ml, single_array_size)
+    wmb.finalize()
+
+
+def test_wholememory_memory_usage():
+    gpu_count = wmb.fork_get_gpu_count()
+    assert gpu_count > 0
+    multiprocess_run(gpu_count, routine_func)
@@ -0,0 +1,30 @@
+# Copyright (c) 2019-2023, NVIDIA CORPORATION.
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import pytest
+import torch
+import pylibwholegraph.torch.wholegraph_ops as wg_ops
+
+
+@pytest.mark.parametrize("device", ["cpu", "cuda"])
+def test_random_walk_visit_counts(device):
+    if device == "cuda" and not torch.cuda.is_available():
+        pytest.skip("CUDA is not available.")
+    # second walk reached a dead end at node 4.
+    walks = torch.tensor(
+        [[0, 1, 0, 2], [3, 4, -1, -1], [0, 0, 1, 1]], dtype=torch.int32, device=device
+    )
+    visit_counts = wg_ops.random_walk_visit_counts(walks, 6)
+    assert visit_counts.device == walks.device
+    assert visit_counts.dtype == torch.int64
+    assert visit_counts.cpu().tolist() == [4, 3, 1, 1, 1, 0]
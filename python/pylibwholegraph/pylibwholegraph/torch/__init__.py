@@ -49,7 +49,7 @@ from .tensor import (
     create_wholememory_tensor_from_filelist,
     destroy_wholememory_tensor,
 )
-from .graph_structure import GraphStructure
+from .graph_structure import GraphStructure, save_compressed_csr, load_compressed_csr
 
 from .utils import get_part_file_name, get_part_file_list
 
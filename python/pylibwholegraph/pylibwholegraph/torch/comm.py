@@ -18,6 +18,8 @@ import pylibwholegraph.binding.wholememory_binding as wmb
 from .utils import (
     str_to_wmb_wholememory_distributed_backend_type,
     wholememory_distributed_backend_type_to_str,
+    str_to_wmb_wholememory_comm_backend_type,
+    wholememory_comm_backend_type_to_str,
     str_to_wmb_wholememory_memory_type,
     str_to_wmb_wholememory_location
 )
@@ -100,15 +102,22 @@ class WholeMemoryCommunicator(object):
     def distributed_backend(self, value):
         self.wmb_comm.set_distributed_backend(str_to_wmb_wholememory_distributed_backend_type(value))
 
+    @property
+    def comm_backend(self):
+        """Backend of this communicator, nccl or host"""
+        return wholememory_comm_backend_type_to_str(self.wmb_comm.get_comm_backend())
+
 
-def create_group_communicator(group_size: int = -1, comm_stride: int = 1):
+def create_group_communicator(group_size: int = -1, comm_stride: int = 1, comm_backend: str = "nccl"):
     """Create WholeMemory Communicator.
     For example: 24 ranks with group_size = 4 and comm_stride = 2 will create following groups:
     [0, 2, 4, 6], [1, 3, 5, 7], [8, 10, 12, 14], [9, 11, 13, 15], [16, 18, 20, 22], [17, 19, 21, 23]
     :param group_size: Size of each group, -1 means to use all ranks in just one single group.
     :param comm_stride: Stride of each rank in each group
+    :param comm_backend: nccl or host, host backend only supports host memory and needs no GPU
     :return: WholeMemoryCommunicator
     """
+    wm_comm_backend = str_to_wmb_wholememory_comm_backend_type(comm_backend)
     world_size = dist.get_world_size()
     if group_size == -1:
         group_size = world_size
@@ -125,13 +134,17 @@ def create_group_communicator(group_size: int = -1, comm_stride: int = 1):
         for inner_group in range(comm_stride):
             group_root_rank = strided_group * strided_group_size + inner_group
             if world_rank == group_root_rank:
-                tmp_wm_uid = wmb.create_unique_id()
+                tmp_wm_uid = wmb.create_unique_id(wm_comm_backend)
             else:
                 tmp_wm_uid = wmb.PyWholeMemoryUniqueID()
             uid_th = torch.utils.dlpack.from_dlpack(tmp_wm_uid.__dlpack__())
-            uid_th_cuda = uid_th.cuda()
-            dist.broadcast(uid_th_cuda, group_root_rank)
-            uid_th.copy_(uid_th_cuda.cpu())
+            if comm_backend == "host":
+                # processes may have no GPU, torch.distributed should have CPU backend like gloo.
+                dist.broadcast(uid_th, group_root_rank)
+            else:
+                uid_th_cuda = uid_th.cuda()
+                dist.broadcast(uid_th_cuda, group_root_rank)
+                uid_th.copy_(uid_th_cuda.cpu())
             if strided_group_idx == strided_group and inner_group_idx == inner_group:
                 wm_uid_th = torch.utils.dlpack.from_dlpack(wm_uid.__dlpack__())
                 wm_uid_th.copy_(uid_th)
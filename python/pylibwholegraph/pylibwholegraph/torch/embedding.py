@@ -13,7 +13,12 @@
 
 import pylibwholegraph.binding.wholememory_binding as wmb
 import torch
+import numpy as np
+import glob
+import os
+import shutil
 from .utils import torch_dtype_to_wholememory_dtype, get_file_size
+from .utils import get_part_file_list
 from .utils import str_to_wmb_wholememory_location, str_to_wmb_wholememory_memory_type
 from .utils import (
     str_to_wmb_wholememory_optimizer_type,
@@ -267,7 +272,7 @@ class WholeMemoryEmbedding(object):
         super().__init__()
         self.wmb_embedding = wmb_embedding
         self.embedding_tensor = None
-        self.optimizer_states = None
+        self.optimizer_states = {}
 
         self.wmb_optimizer = wmb_optimizer
         self.wmb_cache_policy = wmb_cache_policy
@@ -352,10 +357,10 @@ class WholeMemoryEmbedding(object):
         self.need_apply = []
 
     def writeback_all_cache(self):
-        self.wmb_embedding.writeback_all_cache(get_stream(False))
+        self.wmb_embedding.writeback_all_cache(get_stream())
 
     def drop_all_cache(self):
-        self.wmb_embedding.drop_all_cache(get_stream(False))
+        self.wmb_embedding.drop_all_cache(get_stream())
 
     def get_embedding_tensor(self):
         if self.embedding_tensor is None:
@@ -379,6 +384,30 @@ class WholeMemoryEmbedding(object):
         for state_name in self.get_optimizer_state_names():
             state = self.get_optimizer_state(state_name)
             state.to_file_prefix(file_prefix + "_" + state_name)
+        if self.wmb_optimizer is not None:
+            self.wmb_embedding.reset_dirty_rows(get_stream())
+
+    def save_delta(self, file_prefix: str):
+        """
+        Save only rows of embedding and optimizer states updated since last save or save_delta.
+        Delta files can be merged into full checkpoint by compact_embedding_checkpoint.
+        Only rows updated by apply_gradients are tracked, and only for embedding with optimizer.
+        :param file_prefix: file name prefix of delta files
+        :return: None
+        """
+        self.wmb_embedding.save_delta(file_prefix, get_stream())
+
+    def save_async(self, file_prefix: str):
+        """
+        Start saving embedding and optimizer states in background, files have same layout as save.
+        Local data is copied to host staging memory on current stream before return, so training
+        can continue while files are written. All ranks should call this together.
+        Snapshot doesn't change dirty rows, so next save_delta still has rows updated before it.
+        :param file_prefix: file name prefix
+        :return: snapshot handle, is_done() polls and wait() blocks until this rank's files are
+            written and raises on failure.
+        """
+        return self.wmb_embedding.start_snapshot(file_prefix, get_stream())
 
     def load(
         self,
@@ -523,6 +552,106 @@ def destroy_embedding(wm_embedding: WholeMemoryEmbedding):
     wm_embedding.wmb_embedding = None
 
 
+def _get_part_count(prefix: str):
+    part_files = glob.glob(glob.escape(prefix) + "_part_*_of_*")
+    if len(part_files) == 0:
+        raise ValueError("no part files found for prefix %s" % (prefix,))
+    part_count = int(part_files[0].rsplit("_of_", 1)[1])
+    if len(part_files) != part_count:
+        raise ValueError(
+            "prefix %s has %d part files, but part count is %d"
+            % (prefix, len(part_files), part_count)
+        )
+    return part_count
+
+
+def _read_embedding_delta(filename: str):
+    with open(filename, "rb") as f:
+        if f.read(8) != b"WMDELTA1":
+            raise ValueError("%s is not WholeMemory embedding delta file" % (filename,))
+        total_row_count, row_count = np.fromfile(f, dtype=np.int64, count=2).tolist()
+        tensor_count = int(np.fromfile(f, dtype=np.int32, count=1)[0])
+        tensor_row_bytes = []
+        for _ in range(tensor_count):
+            name_length = int(np.fromfile(f, dtype=np.int32, count=1)[0])
+            name = f.read(name_length).decode()
+            row_bytes = int(np.fromfile(f, dtype=np.int64, count=1)[0])
+            tensor_row_bytes.append((name, row_bytes))
+        row_ids = np.fromfile(f, dtype=np.int64, count=row_count)
+        tensor_rows = {}
+        for name, row_bytes in tensor_row_bytes:
+            tensor_rows[name] = np.fromfile(
+                f, dtype=np.uint8, count=row_count * row_bytes
+            ).reshape(row_count, row_bytes)
+    return total_row_count, row_ids, tensor_rows
+
+
+def compact_embedding_checkpoint(
+    base_prefix: str,
+    delta_prefixes: Union[List[str], str],
+    output_prefix: Union[str, None] = None,
+):
+    """
+    Merge delta files written by WholeMemoryEmbedding.save_delta into full checkpoint written by
+    WholeMemoryEmbedding.save, deltas are applied in order so later deltas override earlier ones.
+    The result has same layout as base checkpoint and can be loaded by WholeMemoryEmbedding.load.
+    This runs offline on a single process and only touches updated rows of output files.
+    :param base_prefix: file prefix passed to WholeMemoryEmbedding.save
+    :param delta_prefixes: file prefixes passed to WholeMemoryEmbedding.save_delta, oldest first
+    :param output_prefix: file prefix of merged checkpoint, None to update base checkpoint in place
+    :return: None
+    """
+    if isinstance(delta_prefixes, str):
+        delta_prefixes = [delta_prefixes]
+    if output_prefix is None:
+        output_prefix = base_prefix
+    output_tensors = {}
+    for delta_prefix in delta_prefixes:
+        delta_part_count = _get_part_count(delta_prefix + "_delta")
+        for delta_file in get_part_file_list(delta_prefix + "_delta", delta_part_count):
+            total_row_count, row_ids, tensor_rows = _read_embedding_delta(delta_file)
+            for name, rows in tensor_rows.items():
+                if name not in output_tensors:
+                    base_name = base_prefix + "_" + name
+                    part_count = _get_part_count(base_name)
+                    base_files = get_part_file_list(base_name, part_count)
+                    output_files = get_part_file_list(output_prefix + "_" + name, part_count)
+                    row_bytes = rows.shape[1]
+                    part_row_counts = []
+                    for base_file, output_file in zip(base_files, output_files):
+                        if output_file != base_file:
+                            shutil.copyfile(base_file, output_file)
+                        file_size = os.path.getsize(output_file)
+                        if file_size % row_bytes != 0:
+                            raise ValueError(
+                                "size of %s is %d, not multiple of row size %d"
+                                % (output_file, file_size, row_bytes)
+                            )
+                        part_row_counts.append(file_size // row_bytes)
+                    part_starts = np.cumsum([0] + part_row_counts)
+                    if part_starts[-1] != total_row_count:
+                        raise ValueError(
+                            "%s has %d rows, but delta has %d rows"
+                            % (base_name, part_starts[-1], total_row_count)
+                        )
+                    part_maps = [
+                        np.memmap(f, dtype=np.uint8, mode="r+", shape=(c, row_bytes))
+                        if c > 0
+                        else None
+                        for f, c in zip(output_files, part_row_counts)
+                    ]
+                    output_tensors[name] = (part_starts, part_maps)
+                part_starts, part_maps = output_tensors[name]
+                part_ids = np.searchsorted(part_starts, row_ids, side="right") - 1
+                for part_id in np.unique(part_ids):
+                    mask = part_ids == part_id
+                    part_maps[part_id][row_ids[mask] - part_starts[part_id]] = rows[mask]
+    for _, part_maps in output_tensors.values():
+        for part_map in part_maps:
+            if part_map is not None:
+                part_map.flush()
+
+
 class WholeMemoryEmbeddingModule(torch.nn.Module):
     """
     torch.nn.Module wrapper of WholeMemoryEmbedding
@@ -11,9 +11,13 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import pylibwholegraph.binding.wholememory_binding as wmb
 import torch
+import numpy as np
+import struct
 from typing import Union, List
-from .tensor import WholeMemoryTensor
+from .comm import WholeMemoryCommunicator
+from .tensor import WholeMemoryTensor, create_wholememory_tensor
 from . import graph_ops
 from . import wholegraph_ops
 
@@ -137,6 +141,88 @@ class GraphStructure(object):
             need_edge_output,
         )
 
+    def temporal_sample_one_hop(
+        self,
+        timestamp_name: str,
+        center_nodes_tensor: torch.Tensor,
+        center_timestamps_tensor: torch.Tensor,
+        max_sample_count: int,
+        *,
+        sample_latest: bool = False,
+        random_seed: Union[int, None] = None,
+        need_center_local_output: bool = False,
+        need_edge_output: bool = False
+    ):
+        """
+        Temporal Sample on CSR graph structure with edge timestamp attribute, only edges not later than
+        query time of center node are sampled. Neighbors of each node should be sorted by timestamp.
+        :param timestamp_name: edge attribute name for timestamp
+        :param center_nodes_tensor: center node ids
+        :param center_timestamps_tensor: query time of each center node
+        :param max_sample_count: max sample count for each center node
+        :param sample_latest: If True, take the latest edges, else sample uniformly without replacement
+        :param random_seed: random seed for the sampler
+        :param need_center_local_output: If True, output a tensor same length as sampled nodes but each element is the
+            center node index in center_nodes_tensor.
+        :param need_edge_output: If True, output the edge index of each sampled node
+        :return: csr_row_ptr, sampled_nodes[, center_node_local_id, edge_index]
+        """
+        assert timestamp_name in self.edge_attributes
+        timestamp_tensor = self.edge_attributes[timestamp_name]
+        return wholegraph_ops.temporal_sample(
+            self.csr_row_ptr.wmb_tensor,
+            self.csr_col_ind.wmb_tensor,
+            timestamp_tensor.wmb_tensor,
+            center_nodes_tensor,
+            center_timestamps_tensor,
+            max_sample_count,
+            sample_latest,
+            random_seed,
+            need_center_local_output,
+            need_edge_output,
+        )
+
+    def random_walk(
+        self,
+        start_nodes_tensor: torch.Tensor,
+        walk_length: int,
+        *,
+        weight_name: Union[str, None] = None,
+        p: float = 1.0,
+        q: float = 1.0,
+        restart_probability: float = 0.0,
+        random_seed: Union[int, None] = None,
+        need_restart_count: bool = False
+    ):
+        """
+        Random walk on CSR graph structure, node2vec walk if p or q is not 1.0
+        :param start_nodes_tensor: start node ids
+        :param walk_length: step count of each walk
+        :param weight_name: edge attribute name for weight, if None, use unweighted walk
+        :param p: node2vec return parameter
+        :param q: node2vec in-out parameter
+        :param restart_probability: probability to jump back to start node at each step
+        :param random_seed: random seed for the walk
+        :param need_restart_count: If True, output restart count of each walk
+        :return: walks[, restart_count], walks has walk_length + 1 nodes for each start node
+        """
+        weight_tensor = None
+        if weight_name is not None:
+            assert weight_name in self.edge_attributes
+            weight_tensor = self.edge_attributes[weight_name].wmb_tensor
+        return wholegraph_ops.random_walk(
+            self.csr_row_ptr.wmb_tensor,
+            self.csr_col_ind.wmb_tensor,
+            start_nodes_tensor,
+            walk_length,
+            weight_tensor,
+            p,
+            q,
+            restart_probability,
+            random_seed,
+            need_restart_count,
+        )
+
     def multilayer_sample_without_replacement(
         self,
         node_ids: torch.Tensor,
@@ -151,6 +237,23 @@ class GraphStructure(object):
         :return: target_gids, edge_indice, csr_row_ptr, csr_col_ind
         """
         hops = len(max_neighbors)
+        if weight_name is None and node_ids.dtype == self.csr_col_ind.dtype:
+            (
+                hop_target_gids,
+                hop_csr_row_ptr,
+                hop_edge_indice,
+            ) = wholegraph_ops.unweighted_multilayer_sample_without_replacement(
+                self.csr_row_ptr.wmb_tensor,
+                self.csr_col_ind.wmb_tensor,
+                node_ids,
+                max_neighbors,
+            )
+            # hop h of fused sampler is layer hops - h - 1
+            target_gids = hop_target_gids[::-1] + [node_ids]
+            csr_row_ptr = hop_csr_row_ptr[::-1]
+            edge_indice = hop_edge_indice[::-1]
+            csr_col_ind = [layer_edge_indice[0] for layer_edge_indice in edge_indice]
+            return target_gids, edge_indice, csr_row_ptr, csr_col_ind
         edge_indice = [None] * hops
         csr_row_ptr = [None] * hops
         csr_col_ind = [None] * hops
@@ -194,3 +297,168 @@ class GraphStructure(object):
             )
             target_gids[i] = unique_gids
         return target_gids, edge_indice, csr_row_ptr, csr_col_ind
+
+
+# header of compressed CSR file: magic, node_count, edge_count, col_ind_element_size,
+# rows_per_block, block_count, followed by (block_count + 1) x (edge_offset, degree_offset,
+# neighbor_offset) int64 block index, see load_compressed_csr_to_handles in file_io.cpp.
+_compressed_csr_magic = b"WMCSRZ01"
+_compressed_csr_header_format = "<8sqqiiq"
+
+
+def _varint_encode(values: np.ndarray):
+    """
+    LEB128 encode uint64 values
+    :param values: uint64 values to encode
+    :return: encoded bytes as uint8 array, and encoded byte count of each value
+    """
+    lengths = np.ones(values.shape[0], dtype=np.int64)
+    shifted = values >> np.uint64(7)
+    while True:
+        nonzero = shifted != 0
+        if not nonzero.any():
+            break
+        lengths += nonzero
+        shifted >>= np.uint64(7)
+    ends = np.cumsum(lengths)
+    starts = ends - lengths
+    output = np.empty(int(ends[-1]) if ends.shape[0] > 0 else 0, dtype=np.uint8)
+    remaining = values.copy()
+    max_length = int(lengths.max()) if lengths.shape[0] > 0 else 0
+    for k in range(max_length):
+        selected = lengths > k
+        encoded = (remaining[selected] & np.uint64(0x7F)).astype(np.uint8)
+        encoded[lengths[selected] > k + 1] |= np.uint8(0x80)
+        output[starts[selected] + k] = encoded
+        remaining >>= np.uint64(7)
+    return output, lengths
+
+
+def _exclusive_byte_offsets(lengths: np.ndarray, positions: np.ndarray):
+    cumsum_lengths = np.zeros(lengths.shape[0] + 1, dtype=np.int64)
+    np.cumsum(lengths, out=cumsum_lengths[1:])
+    return cumsum_lengths[positions]
+
+
+def save_compressed_csr(
+    file_name: str,
+    csr_row_ptr: Union[torch.Tensor, np.ndarray],
+    csr_col_ind: Union[torch.Tensor, np.ndarray],
+    rows_per_block: int = 1024,
+):
+    """
+    Save CSR graph to compressed CSR file, which can be loaded by load_compressed_csr.
+    Rows are grouped into blocks of rows_per_block, degree of each row is stored as varint and
+    neighbors are stored as zigzag varint of delta to previous neighbor in the block, so sorted
+    neighbor ids of each row compress well.
+    :param file_name: compressed CSR file name
+    :param csr_row_ptr: CSR row pointer on CPU
+    :param csr_col_ind: CSR column index on CPU, int32 or int64
+    :param rows_per_block: number of rows in each block, which is the unit of parallel decoding
+    :return: None
+    """
+    if isinstance(csr_row_ptr, torch.Tensor):
+        csr_row_ptr = csr_row_ptr.cpu().numpy()
+    if isinstance(csr_col_ind, torch.Tensor):
+        csr_col_ind = csr_col_ind.cpu().numpy()
+    assert csr_row_ptr.ndim == 1 and csr_col_ind.ndim == 1
+    assert csr_col_ind.dtype == np.int32 or csr_col_ind.dtype == np.int64
+    assert rows_per_block > 0
+    row_ptr = csr_row_ptr.astype(np.int64, copy=False)
+    node_count = row_ptr.shape[0] - 1
+    edge_count = csr_col_ind.shape[0]
+    assert node_count >= 0 and row_ptr[0] == 0 and row_ptr[-1] == edge_count
+    block_count = (node_count + rows_per_block - 1) // rows_per_block
+    block_rows = np.minimum(
+        np.arange(block_count + 1, dtype=np.int64) * rows_per_block, node_count
+    )
+    index = np.zeros((block_count + 1, 3), dtype=np.int64)
+    index[:, 0] = row_ptr[block_rows]
+    header = struct.pack(
+        _compressed_csr_header_format,
+        _compressed_csr_magic,
+        node_count,
+        edge_count,
+        csr_col_ind.dtype.itemsize,
+        rows_per_block,
+        block_count,
+    )
+    chunk_block_count = max(1, (1024 * 1024) // rows_per_block)
+    with open(file_name, "wb") as f:
+        f.write(header)
+        # index is written again after all offsets are known.
+        f.write(index.tobytes())
+        offset = len(header) + index.nbytes
+        for block_start in range(0, block_count, chunk_block_count):
+            block_end = min(block_start + chunk_block_count, block_count)
+            row_start, row_end = block_rows[block_start], block_rows[block_end]
+            degrees = np.diff(row_ptr[row_start:row_end + 1]).astype(np.uint64)
+            encoded, lengths = _varint_encode(degrees)
+            index[block_start:block_end, 1] = offset + _exclusive_byte_offsets(
+                lengths, block_rows[block_start:block_end] - row_start
+            )
+            f.write(encoded.tobytes())
+            offset += encoded.shape[0]
+        index[block_count, 1] = offset
+        index[0, 2] = offset
+        for block_start in range(0, block_count, chunk_block_count):
+            block_end = min(block_start + chunk_block_count, block_count)
+            edge_start, edge_end = index[block_start, 0], index[block_end, 0]
+            values = csr_col_ind[edge_start:edge_end].astype(np.int64)
+            deltas = values.copy()
+            deltas[1:] -= values[:-1]
+            block_first_edges = index[block_start:block_end, 0] - edge_start
+            block_first_edges = block_first_edges[block_first_edges < values.shape[0]]
+            deltas[block_first_edges] = values[block_first_edges]
+            zigzag = ((deltas << 1) ^ (deltas >> 63)).view(np.uint64)
+            encoded, lengths = _varint_encode(zigzag)
+            index[block_start:block_end, 2] = offset + _exclusive_byte_offsets(
+                lengths, index[block_start:block_end, 0] - edge_start
+            )
+            f.write(encoded.tobytes())
+            offset += encoded.shape[0]
+        index[block_count, 2] = offset
+        f.seek(len(header))
+        f.write(index.tobytes())
+
+
+def load_compressed_csr(
+    comm: WholeMemoryCommunicator,
+    memory_type: str,
+    memory_location: str,
+    file_name: str,
+    col_ind_dtype: Union[torch.dtype, None] = None,
+):
+    """
+    Create CSR WholeMemory Tensors from compressed CSR file saved by save_compressed_csr.
+    Each rank reads and decodes only the blocks covering its own part of the tensors, using
+    WHOLEMEMORY_LOAD_THREAD_COUNT threads, or all cores of the rank if not set.
+    :param comm: WholeMemoryCommunicator
+    :param memory_type: WholeMemory type, should be continuous, chunked or distributed
+    :param memory_location: WholeMemory location, should be cpu or cuda
+    :param file_name: compressed CSR file name
+    :param col_ind_dtype: data type of csr_col_ind, None for same as saved
+    :return: csr_row_ptr and csr_col_ind WholeMemoryTensor
+    """
+    header_size = struct.calcsize(_compressed_csr_header_format)
+    with open(file_name, "rb") as f:
+        header = f.read(header_size)
+    if len(header) != header_size:
+        raise ValueError("File %s is not a compressed CSR file." % (file_name,))
+    magic, node_count, edge_count, col_ind_element_size, _, _ = struct.unpack(
+        _compressed_csr_header_format, header
+    )
+    if magic != _compressed_csr_magic:
+        raise ValueError("File %s is not a compressed CSR file." % (file_name,))
+    if col_ind_dtype is None:
+        col_ind_dtype = torch.int32 if col_ind_element_size == 4 else torch.int64
+    csr_row_ptr = create_wholememory_tensor(
+        comm, memory_type, memory_location, [node_count + 1], torch.int64, None
+    )
+    csr_col_ind = create_wholememory_tensor(
+        comm, memory_type, memory_location, [edge_count], col_ind_dtype, None
+    )
+    wmb.load_compressed_csr_from_file(
+        csr_row_ptr.wmb_tensor, csr_col_ind.wmb_tensor, file_name
+    )
+    return csr_row_ptr, csr_col_ind
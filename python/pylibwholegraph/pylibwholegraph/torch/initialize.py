@@ -16,19 +16,25 @@ import torch
 import torch.utils.dlpack
 import pylibwholegraph.binding.wholememory_binding as wmb
 from .comm import set_world_info, get_global_communicator, get_local_node_communicator
+from .utils import str_to_wmb_init_flags
 
 
-def init(world_rank: int, world_size: int, local_rank: int, local_size: int):
-    wmb.init(0)
+def init(
+    world_rank: int, world_size: int, local_rank: int, local_size: int, huge_page: str = "none"
+):
+    wmb.init(str_to_wmb_init_flags(huge_page))
     set_world_info(world_rank, world_size, local_rank, local_size)
 
 
-def init_torch_env(world_rank: int, world_size: int, local_rank: int, local_size: int):
+def init_torch_env(
+    world_rank: int, world_size: int, local_rank: int, local_size: int, huge_page: str = "none"
+):
     r"""Init WholeGraph environment for PyTorch.
     :param world_rank: world rank of current process
     :param world_size: world size of all processes
     :param local_rank: local rank of current process
     :param local_size: local size
+    :param huge_page: huge pages for host WholeMemory, "none", "2mb" or "1gb"
     :return: None
     """
     os.environ["RANK"] = str(world_rank)
@@ -44,7 +50,7 @@ def init_torch_env(world_rank: int, world_size: int, local_rank: int, local_size
             print("[WARNING] MASTER_PORT not set, resetting to 12335")
         os.environ["MASTER_PORT"] = "12335"
 
-    wmb.init(0)
+    wmb.init(str_to_wmb_init_flags(huge_page))
     torch.set_num_threads(1)
     torch.cuda.set_device(local_rank)
     torch.distributed.init_process_group(backend="nccl", init_method="env://")
@@ -52,16 +58,18 @@ def init_torch_env(world_rank: int, world_size: int, local_rank: int, local_size
 
 
 def init_torch_env_and_create_wm_comm(
-    world_rank: int, world_size: int, local_rank: int, local_size: int , distributed_backend_type="nccl"
+    world_rank: int, world_size: int, local_rank: int, local_size: int , distributed_backend_type="nccl",
+    huge_page: str = "none"
 ):
     r"""Init WholeGraph environment for PyTorch and create single communicator for all ranks.
     :param world_rank: world rank of current process
     :param world_size: world size of all processes
     :param local_rank: local rank of current process
     :param local_size: local size
+    :param huge_page: huge pages for host WholeMemory, "none", "2mb" or "1gb"
     :return: global and local node Communicator
     """
-    init_torch_env(world_rank, world_size, local_rank, local_size)
+    init_torch_env(world_rank, world_size, local_rank, local_size, huge_page)
     global_comm = get_global_communicator(distributed_backend_type)
     local_comm = get_local_node_communicator()
 
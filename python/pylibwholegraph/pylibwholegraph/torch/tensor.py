@@ -33,8 +33,14 @@ WholeMemoryMemoryLocation = wmb.WholeMemoryMemoryLocation
 class WholeMemoryTensor(object):
     r"""WholeMemory Tensor"""
 
-    def __init__(self, wmb_tensor: wmb.PyWholeMemoryTensor):
+    def __init__(
+        self,
+        wmb_tensor: wmb.PyWholeMemoryTensor,
+        wmb_handle: Union[wmb.PyWholeMemoryHandle, None] = None,
+    ):
         self.wmb_tensor = wmb_tensor
+        # handle owned by this tensor, only for tensor mapped from files.
+        self.wmb_handle = wmb_handle
 
     @property
     def dtype(self):
@@ -67,7 +73,7 @@ class WholeMemoryTensor(object):
         embedding_count = indice.shape[0]
         current_cuda_device = "cuda:%d" % (torch.cuda.current_device(),)
         output_dtype = (
-            force_dtype if force_dtype is not None else self.embedding_tensor.dtype
+            force_dtype if force_dtype is not None else self.dtype
         )
         output_tensor = torch.empty(
             [embedding_count, embedding_dim],
@@ -152,20 +158,39 @@ class WholeMemoryTensor(object):
                 torch.cuda.current_device(),
             )
 
-    def from_filelist(self, filelist: Union[List[str], str]):
+    def from_filelist(
+        self,
+        filelist: Union[List[str], str],
+        *,
+        file_dtype: Union[torch.dtype, None] = None,
+        file_dim: Union[int, None] = None,
+        file_column_start: int = 0,
+    ):
         """
         Load WholeMemory Tensor from file lists
+        Files may have different dtype or more columns than the tensor, columns
+        [file_column_start, file_column_start + tensor columns) are converted while loading.
+        Each rank reads with WHOLEMEMORY_LOAD_THREAD_COUNT threads, 1 if not set.
         :param filelist: file list to load from
+        :param file_dtype: data type in files, None for same as tensor
+        :param file_dim: number of columns per entry in files, None for same as tensor
+        :param file_column_start: first column in files to load
         :return: None
         """
         if isinstance(filelist, str):
             filelist = [filelist]
-        self.wmb_tensor.from_filelist(filelist)
+        wm_file_dtype = None
+        if file_dtype is not None:
+            wm_file_dtype = torch_dtype_to_wholememory_dtype(file_dtype)
+        self.wmb_tensor.from_filelist(
+            filelist, wm_file_dtype, file_dim, file_column_start
+        )
 
     def from_file_prefix(self, file_prefix: str, part_count: Union[int, None] = None):
         """
         Load WholeMemory  tensor from files with same prefix, files has format
             "%s_part_%d_of_%d" % (prefix, part_id, part_count)
+        Each rank reads with WHOLEMEMORY_LOAD_THREAD_COUNT threads, 1 if not set.
         :param file_prefix: file name prefix
         :param part_count: part count of file
         :return: None
@@ -195,6 +220,26 @@ class WholeMemoryTensor(object):
         )
         self.local_to_file(filename)
 
+    def save_checkpoint(self, file_prefix: str):
+        """
+        Store WholeMemory Tensor as a self-describing checkpoint, all ranks should call this together.
+        Writes "%s_part_%d_of_%d" % (prefix, rank, world_size) part files and a "%s_meta" file
+        recording dtype, shape, per part row ranges and CRC32 checksums.
+        :param file_prefix: checkpoint file name prefix
+        :return: None
+        """
+        self.wmb_tensor.to_checkpoint(file_prefix)
+
+    def load_checkpoint(self, file_prefix: str, verify_checksum: bool = False):
+        """
+        Load WholeMemory Tensor from checkpoint written by save_checkpoint, all ranks should call this together.
+        The checkpoint may be saved with different world size, rows are resharded automatically.
+        :param file_prefix: checkpoint file name prefix
+        :param verify_checksum: whether to verify CRC32 checksums of part files before loading
+        :return: None
+        """
+        self.wmb_tensor.from_checkpoint(file_prefix, verify_checksum)
+
 
 def create_wholememory_tensor(
     comm: WholeMemoryCommunicator,
@@ -251,7 +296,9 @@ def create_wholememory_tensor_from_filelist(
     Create WholeMemory Tensor from list of binary files.
     :param comm: WholeMemoryCommunicator
     :param memory_type: WholeMemory type, should be continuous, chunked or distributed
-    :param memory_location: WholeMemory location, should be cpu or cuda
+    :param memory_location: WholeMemory location, should be cpu, cuda or file. For file, files are
+        mapped read only instead of loaded, only continuous type is supported, and sizes of all
+        files except the last one should be multiple of system page size.
     :param filelist: list of binary files
     :param dtype: data type of the tensor
     :param last_dim_size: 0 for create 1-D array, positive value for create matrix column size
@@ -282,6 +329,22 @@ def create_wholememory_tensor_from_filelist(
     else:
         sizes = [total_entry_count, last_dim_size]
         strides = [last_dim_strides, 1]
+    if memory_location == "file":
+        if last_dim_strides != max(last_dim_size, 1):
+            raise ValueError("Tensor mapped from files should not have padded last dim.")
+        td = wmb.PyWholeMemoryTensorDescription()
+        td.set_shape(sizes)
+        td.set_stride(strides)
+        td.set_dtype(torch_dtype_to_wholememory_dtype(dtype))
+        wmb_handle = wmb.malloc_from_file(
+            comm.wmb_comm,
+            str_to_wmb_wholememory_memory_type(memory_type),
+            file_entry_size,
+            filelist,
+        )
+        return WholeMemoryTensor(
+            wmb.make_handle_as_wholememory(td, wmb_handle), wmb_handle
+        )
     wm_tensor = create_wholememory_tensor(
         comm, memory_type, memory_location, sizes, dtype, strides
     )
@@ -296,4 +359,7 @@ def destroy_wholememory_tensor(wm_tensor: WholeMemoryTensor):
     :return: None
     """
     wmb.destroy_wholememory_tensor(wm_tensor.wmb_tensor)
+    if wm_tensor.wmb_handle is not None:
+        wmb.free(wm_tensor.wmb_handle)
+        wm_tensor.wmb_handle = None
     wm_tensor.wmb_tensor = None
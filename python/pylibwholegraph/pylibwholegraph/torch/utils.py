@@ -104,9 +104,11 @@ def str_to_wmb_wholememory_location(str_wmb_location: str):
         return wmb.WholeMemoryMemoryLocation.MlDevice
     elif str_wmb_location == "cpu":
         return wmb.WholeMemoryMemoryLocation.MlHost
+    elif str_wmb_location == "file":
+        return wmb.WholeMemoryMemoryLocation.MlFile
     else:
         raise ValueError(
-            "WholeMemory location %s not supported, should be (cuda, cpu)"
+            "WholeMemory location %s not supported, should be (cuda, cpu, file)"
             % (str_wmb_location,)
         )
 
@@ -162,6 +164,40 @@ def wholememory_distributed_backend_type_to_str(distributed_backend: wmb.WholeMe
         )
 
 
+def str_to_wmb_wholememory_comm_backend_type(str_wmb_comm_backend: str):
+    if str_wmb_comm_backend == "nccl":
+        return wmb.WholeMemoryCommBackend.CbNCCL
+    elif str_wmb_comm_backend == "host":
+        return wmb.WholeMemoryCommBackend.CbHost
+    else:
+        raise ValueError(
+            "WholeMemory comm_backend %s not supported, should be (nccl, host)"
+            % (str_wmb_comm_backend,)
+        )
+
+
+def wholememory_comm_backend_type_to_str(comm_backend: wmb.WholeMemoryCommBackend):
+    if comm_backend == wmb.WholeMemoryCommBackend.CbNCCL:
+        return "nccl"
+    elif comm_backend == wmb.WholeMemoryCommBackend.CbHost:
+        return "host"
+    else:
+        raise ValueError("WholeMemory comm_backend not supported, should be (CbNCCL, CbHost)")
+
+
+def str_to_wmb_init_flags(huge_page: str):
+    if huge_page == "none":
+        return 0
+    elif huge_page == "2mb":
+        return wmb.WholeMemoryInitFlags.IfHugePage2MB
+    elif huge_page == "1gb":
+        return wmb.WholeMemoryInitFlags.IfHugePage1GB
+    else:
+        raise ValueError(
+            "WholeMemory huge_page %s not supported, should be (none, 2mb, 1gb)" % (huge_page,)
+        )
+
+
 def get_part_file_name(prefix: str, part_id: int, part_count: int):
     return "%s_part_%d_of_%d" % (prefix, part_id, part_count)
 
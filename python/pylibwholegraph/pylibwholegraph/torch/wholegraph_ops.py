@@ -19,7 +19,8 @@ from .wholegraph_env import (
     get_wholegraph_env_fns,
     wrap_torch_tensor,
 )
-from typing import Union
+from .utils import wholememory_dtype_to_torch_dtype
+from typing import Union, List
 import random
 
 
@@ -41,7 +42,9 @@ def unweighted_sample_without_replacement(
     if random_seed is None:
         random_seed = random.getrandbits(64)
     output_sample_offset_tensor = torch.empty(
-        center_nodes_tensor.shape[0] + 1, device="cuda", dtype=torch.int
+        center_nodes_tensor.shape[0] + 1,
+        device=center_nodes_tensor.device,
+        dtype=torch.int,
     )
     output_dest_context = TorchMemoryContext()
     output_dest_c_context = output_dest_context.get_c_context()
@@ -112,7 +115,9 @@ def weighted_sample_without_replacement(
     if random_seed is None:
         random_seed = random.getrandbits(64)
     output_sample_offset_tensor = torch.empty(
-        center_nodes_tensor.shape[0] + 1, device="cuda", dtype=torch.int
+        center_nodes_tensor.shape[0] + 1,
+        device=center_nodes_tensor.device,
+        dtype=torch.int,
     )
     output_dest_context = TorchMemoryContext()
     output_dest_c_context = output_dest_context.get_c_context()
@@ -163,6 +168,374 @@ def weighted_sample_without_replacement(
         return output_sample_offset_tensor, output_dest_context.get_tensor()
 
 
+def unweighted_multilayer_sample_without_replacement(
+    wm_csr_row_ptr_tensor: wmb.PyWholeMemoryTensor,
+    wm_csr_col_ptr_tensor: wmb.PyWholeMemoryTensor,
+    center_nodes_tensor: torch.Tensor,
+    max_sample_counts: List[int],
+    random_seed: Union[int, None] = None,
+):
+    """
+    Fused multi-hop unweighted neighborhood sample in CSR WholeGraph, hop i uses random_seed + i
+    :return: target_nodes, csr_row_ptr, edge_indice of each hop, edge_indice[0] is csr_col_ind
+    """
+    assert wm_csr_row_ptr_tensor.dim() == 1
+    assert wm_csr_col_ptr_tensor.dim() == 1
+    assert center_nodes_tensor.dim() == 1
+    if random_seed is None:
+        random_seed = random.getrandbits(64)
+    hop_count = len(max_sample_counts)
+    target_nodes_contexts = [TorchMemoryContext() for _ in range(hop_count)]
+    csr_row_ptr_contexts = [TorchMemoryContext() for _ in range(hop_count)]
+    edge_indice_contexts = [TorchMemoryContext() for _ in range(hop_count)]
+    wmb.csr_unweighted_multilayer_sample_without_replacement(
+        wm_csr_row_ptr_tensor,
+        wm_csr_col_ptr_tensor,
+        wrap_torch_tensor(center_nodes_tensor),
+        max_sample_counts,
+        [context.get_c_context() for context in target_nodes_contexts],
+        [context.get_c_context() for context in csr_row_ptr_contexts],
+        [context.get_c_context() for context in edge_indice_contexts],
+        random_seed,
+        get_wholegraph_env_fns(),
+        get_stream(),
+    )
+    return (
+        [context.get_tensor() for context in target_nodes_contexts],
+        [context.get_tensor() for context in csr_row_ptr_contexts],
+        [context.get_tensor() for context in edge_indice_contexts],
+    )
+
+
+def unweighted_sample_with_replacement(
+    wm_csr_row_ptr_tensor: wmb.PyWholeMemoryTensor,
+    wm_csr_col_ptr_tensor: wmb.PyWholeMemoryTensor,
+    center_nodes_tensor: torch.Tensor,
+    max_sample_count: int,
+    center_fanout_tensor: Union[torch.Tensor, None] = None,
+    random_seed: Union[int, None] = None,
+    need_center_local_output: bool = False,
+    need_edge_output: bool = False,
+):
+    """
+    Unweighted neighborhood sample with replacement in CSR WholeGraph
+    :param center_fanout_tensor: optional int tensor of fanout of each center node, on same device
+        as center_nodes_tensor, max_sample_count is used for all center nodes if None.
+        fanout <= 0 means sample all neighbors. Without replacement samplers take
+        max_sample_count only.
+    """
+    assert wm_csr_row_ptr_tensor.dim() == 1
+    assert wm_csr_col_ptr_tensor.dim() == 1
+    assert center_nodes_tensor.dim() == 1
+    if center_fanout_tensor is not None:
+        assert center_fanout_tensor.dim() == 1
+        assert center_fanout_tensor.shape[0] == center_nodes_tensor.shape[0]
+        assert center_fanout_tensor.dtype == torch.int
+    if random_seed is None:
+        random_seed = random.getrandbits(64)
+    output_sample_offset_tensor = torch.empty(
+        center_nodes_tensor.shape[0] + 1,
+        device=center_nodes_tensor.device,
+        dtype=torch.int,
+    )
+    output_dest_context = TorchMemoryContext()
+    output_dest_c_context = output_dest_context.get_c_context()
+    output_center_localid_context = None
+    output_center_localid_c_context = 0
+    output_edge_gid_context = None
+    output_edge_gid_c_context = 0
+    if need_center_local_output:
+        output_center_localid_context = TorchMemoryContext()
+        output_center_localid_c_context = output_center_localid_context.get_c_context()
+    if need_edge_output:
+        output_edge_gid_context = TorchMemoryContext()
+        output_edge_gid_c_context = output_edge_gid_context.get_c_context()
+    wmb.csr_unweighted_sample_with_replacement(
+        wm_csr_row_ptr_tensor,
+        wm_csr_col_ptr_tensor,
+        wrap_torch_tensor(center_nodes_tensor),
+        max_sample_count,
+        wrap_torch_tensor(center_fanout_tensor),
+        wrap_torch_tensor(output_sample_offset_tensor),
+        output_dest_c_context,
+        output_center_localid_c_context,
+        output_edge_gid_c_context,
+        random_seed,
+        get_wholegraph_env_fns(),
+        get_stream(),
+    )
+    if need_edge_output and need_center_local_output:
+        return (
+            output_sample_offset_tensor,
+            output_dest_context.get_tensor(),
+            output_center_localid_context.get_tensor(),
+            output_edge_gid_context.get_tensor(),
+        )
+    elif need_center_local_output:
+        return (
+            output_sample_offset_tensor,
+            output_dest_context.get_tensor(),
+            output_center_localid_context.get_tensor(),
+        )
+    elif need_edge_output:
+        return (
+            output_sample_offset_tensor,
+            output_dest_context.get_tensor(),
+            output_edge_gid_context.get_tensor(),
+        )
+    else:
+        return output_sample_offset_tensor, output_dest_context.get_tensor()
+
+
+def weighted_sample_with_replacement(
+    wm_csr_row_ptr_tensor: wmb.PyWholeMemoryTensor,
+    wm_csr_col_ptr_tensor: wmb.PyWholeMemoryTensor,
+    wm_csr_weight_ptr_tensor: wmb.PyWholeMemoryTensor,
+    center_nodes_tensor: torch.Tensor,
+    max_sample_count: int,
+    center_fanout_tensor: Union[torch.Tensor, None] = None,
+    random_seed: Union[int, None] = None,
+    need_center_local_output: bool = False,
+    need_edge_output: bool = False,
+):
+    """
+    Weighted neighborhood sample with replacement in CSR WholeGraph, by prefix sum of edge weights
+    :param center_fanout_tensor: optional int tensor of fanout of each center node, on same device
+        as center_nodes_tensor, max_sample_count is used for all center nodes if None.
+        fanout <= 0 means sample all neighbors. Without replacement samplers take
+        max_sample_count only.
+    """
+    assert wm_csr_row_ptr_tensor.dim() == 1
+    assert wm_csr_col_ptr_tensor.dim() == 1
+    assert wm_csr_weight_ptr_tensor.dim() == 1
+    assert wm_csr_weight_ptr_tensor.shape[0] == wm_csr_col_ptr_tensor.shape[0]
+    assert center_nodes_tensor.dim() == 1
+    if center_fanout_tensor is not None:
+        assert center_fanout_tensor.dim() == 1
+        assert center_fanout_tensor.shape[0] == center_nodes_tensor.shape[0]
+        assert center_fanout_tensor.dtype == torch.int
+    if random_seed is None:
+        random_seed = random.getrandbits(64)
+    output_sample_offset_tensor = torch.empty(
+        center_nodes_tensor.shape[0] + 1,
+        device=center_nodes_tensor.device,
+        dtype=torch.int,
+    )
+    output_dest_context = TorchMemoryContext()
+    output_dest_c_context = output_dest_context.get_c_context()
+    output_center_localid_context = None
+    output_center_localid_c_context = 0
+    output_edge_gid_context = None
+    output_edge_gid_c_context = 0
+    if need_center_local_output:
+        output_center_localid_context = TorchMemoryContext()
+        output_center_localid_c_context = output_center_localid_context.get_c_context()
+    if need_edge_output:
+        output_edge_gid_context = TorchMemoryContext()
+        output_edge_gid_c_context = output_edge_gid_context.get_c_context()
+    wmb.csr_weighted_sample_with_replacement(
+        wm_csr_row_ptr_tensor,
+        wm_csr_col_ptr_tensor,
+        wm_csr_weight_ptr_tensor,
+        wrap_torch_tensor(center_nodes_tensor),
+        max_sample_count,
+        wrap_torch_tensor(center_fanout_tensor),
+        wrap_torch_tensor(output_sample_offset_tensor),
+        output_dest_c_context,
+        output_center_localid_c_context,
+        output_edge_gid_c_context,
+        random_seed,
+        get_wholegraph_env_fns(),
+        get_stream(),
+    )
+    if need_edge_output and need_center_local_output:
+        return (
+            output_sample_offset_tensor,
+            output_dest_context.get_tensor(),
+            output_center_localid_context.get_tensor(),
+            output_edge_gid_context.get_tensor(),
+        )
+    elif need_center_local_output:
+        return (
+            output_sample_offset_tensor,
+            output_dest_context.get_tensor(),
+            output_center_localid_context.get_tensor(),
+        )
+    elif need_edge_output:
+        return (
+            output_sample_offset_tensor,
+            output_dest_context.get_tensor(),
+            output_edge_gid_context.get_tensor(),
+        )
+    else:
+        return output_sample_offset_tensor, output_dest_context.get_tensor()
+
+
+def temporal_sample(
+    wm_csr_row_ptr_tensor: wmb.PyWholeMemoryTensor,
+    wm_csr_col_ptr_tensor: wmb.PyWholeMemoryTensor,
+    wm_edge_timestamp_tensor: wmb.PyWholeMemoryTensor,
+    center_nodes_tensor: torch.Tensor,
+    center_timestamps_tensor: torch.Tensor,
+    max_sample_count: int,
+    sample_latest: bool = False,
+    random_seed: Union[int, None] = None,
+    need_center_local_output: bool = False,
+    need_edge_output: bool = False,
+):
+    """
+    Temporal neighborhood sample in CSR WholeGraph, only edges not later than query time are sampled
+    :param wm_csr_row_ptr_tensor: CSR row_ptr of graph, neighbors of each node should be sorted by
+        edge timestamp in ascending order.
+    :param wm_edge_timestamp_tensor: int or int64 timestamp of each edge.
+    :param center_timestamps_tensor: query time of each center node, same dtype as edge timestamps,
+        on same device as center_nodes_tensor.
+    :param max_sample_count: max sample count, <= 0 means sample all valid neighbors.
+    :param sample_latest: take the latest valid neighbors if True, else sample valid neighbors
+        uniformly without replacement.
+    """
+    assert wm_csr_row_ptr_tensor.dim() == 1
+    assert wm_csr_col_ptr_tensor.dim() == 1
+    assert wm_edge_timestamp_tensor.dim() == 1
+    assert wm_edge_timestamp_tensor.shape[0] == wm_csr_col_ptr_tensor.shape[0]
+    assert center_nodes_tensor.dim() == 1
+    assert center_timestamps_tensor.dim() == 1
+    assert center_timestamps_tensor.shape[0] == center_nodes_tensor.shape[0]
+    if random_seed is None:
+        random_seed = random.getrandbits(64)
+    output_sample_offset_tensor = torch.empty(
+        center_nodes_tensor.shape[0] + 1,
+        device=center_nodes_tensor.device,
+        dtype=torch.int,
+    )
+    output_dest_context = TorchMemoryContext()
+    output_dest_c_context = output_dest_context.get_c_context()
+    output_center_localid_context = None
+    output_center_localid_c_context = 0
+    output_edge_gid_context = None
+    output_edge_gid_c_context = 0
+    if need_center_local_output:
+        output_center_localid_context = TorchMemoryContext()
+        output_center_localid_c_context = output_center_localid_context.get_c_context()
+    if need_edge_output:
+        output_edge_gid_context = TorchMemoryContext()
+        output_edge_gid_c_context = output_edge_gid_context.get_c_context()
+    wmb.csr_temporal_sample(
+        wm_csr_row_ptr_tensor,
+        wm_csr_col_ptr_tensor,
+        wm_edge_timestamp_tensor,
+        wrap_torch_tensor(center_nodes_tensor),
+        wrap_torch_tensor(center_timestamps_tensor),
+        max_sample_count,
+        sample_latest,
+        wrap_torch_tensor(output_sample_offset_tensor),
+        output_dest_c_context,
+        output_center_localid_c_context,
+        output_edge_gid_c_context,
+        random_seed,
+        get_wholegraph_env_fns(),
+        get_stream(),
+    )
+    if need_edge_output and need_center_local_output:
+        return (
+            output_sample_offset_tensor,
+            output_dest_context.get_tensor(),
+            output_center_localid_context.get_tensor(),
+            output_edge_gid_context.get_tensor(),
+        )
+    elif need_center_local_output:
+        return (
+            output_sample_offset_tensor,
+            output_dest_context.get_tensor(),
+            output_center_localid_context.get_tensor(),
+        )
+    elif need_edge_output:
+        return (
+            output_sample_offset_tensor,
+            output_dest_context.get_tensor(),
+            output_edge_gid_context.get_tensor(),
+        )
+    else:
+        return output_sample_offset_tensor, output_dest_context.get_tensor()
+
+
+def random_walk(
+    wm_csr_row_ptr_tensor: wmb.PyWholeMemoryTensor,
+    wm_csr_col_ptr_tensor: wmb.PyWholeMemoryTensor,
+    start_nodes_tensor: torch.Tensor,
+    walk_length: int,
+    wm_csr_weight_ptr_tensor: Union[wmb.PyWholeMemoryTensor, None] = None,
+    p: float = 1.0,
+    q: float = 1.0,
+    restart_probability: float = 0.0,
+    random_seed: Union[int, None] = None,
+    need_restart_count: bool = False,
+):
+    """
+    Random walk or node2vec walk in CSR WholeGraph
+    :param wm_csr_weight_ptr_tensor: edge weights, None for unweighted walk.
+    :param p: node2vec return parameter, p == q == 1.0 means first order random walk.
+    :param q: node2vec in-out parameter.
+    :param restart_probability: probability to jump back to start node at each step.
+    :param need_restart_count: If True, also output restart count of each walk.
+    :return: walks of shape [start_node_count, walk_length + 1], nodes after a dead end are -1,
+        [restart_count]
+    Each rejection trial of a biased walk scans neighbors of previous node, so a step costs
+    O(degree of previous node) per trial. Use random_walk_visit_counts for visit counts.
+    """
+    assert wm_csr_row_ptr_tensor.dim() == 1
+    assert wm_csr_col_ptr_tensor.dim() == 1
+    assert start_nodes_tensor.dim() == 1
+    assert walk_length >= 0
+    if wm_csr_weight_ptr_tensor is not None:
+        assert wm_csr_weight_ptr_tensor.dim() == 1
+        assert wm_csr_weight_ptr_tensor.shape[0] == wm_csr_col_ptr_tensor.shape[0]
+    if random_seed is None:
+        random_seed = random.getrandbits(64)
+    output_walks_tensor = torch.empty(
+        (start_nodes_tensor.shape[0], walk_length + 1),
+        device=start_nodes_tensor.device,
+        dtype=wholememory_dtype_to_torch_dtype(wm_csr_col_ptr_tensor.dtype),
+    )
+    output_restart_count_tensor = None
+    if need_restart_count:
+        output_restart_count_tensor = torch.empty(
+            start_nodes_tensor.shape[0],
+            device=start_nodes_tensor.device,
+            dtype=torch.int,
+        )
+    wmb.csr_random_walk(
+        wm_csr_row_ptr_tensor,
+        wm_csr_col_ptr_tensor,
+        wm_csr_weight_ptr_tensor,
+        wrap_torch_tensor(start_nodes_tensor),
+        walk_length,
+        p,
+        q,
+        restart_probability,
+        wrap_torch_tensor(output_walks_tensor),
+        wrap_torch_tensor(output_restart_count_tensor),
+        random_seed,
+        get_wholegraph_env_fns(),
+        get_stream(),
+    )
+    if need_restart_count:
+        return output_walks_tensor, output_restart_count_tensor
+    return output_walks_tensor
+
+
+def random_walk_visit_counts(walks: torch.Tensor, node_count: int):
+    """
+    Count visits of each node in walks returned by random_walk, start nodes and restarts included.
+    :param walks: walks of shape [start_node_count, walk_length + 1], -1 entries are skipped.
+    :param node_count: node count of the graph.
+    :return: int64 tensor of node_count visit counts, on same device as walks.
+    """
+    assert walks.dim() == 2
+    visited_nodes = walks[walks >= 0].to(torch.int64)
+    return torch.bincount(visited_nodes, minlength=node_count)
+
+
 def generate_random_positive_int_cpu(
     random_seed, sub_sequence, output_random_value_count
 ):